@@ -31,6 +31,8 @@
 
 // PROJECT
 #include "SpectralInstrumentCompatibility.h"
+#include "CameraPacketDelayController.h"
+#include "CameraFrameMetadataTable.h"
 
 // LIMA 
 #include "lima/Exceptions.h"
@@ -145,6 +147,15 @@ private:
     // Manage the latency wait before the next image
     bool imageLatency(const InternalTimer & in_start_timer);
 
+    // Adapt the delay between two image packets for the next image
+    void adjustPacketDelay(const CameraPacketDelayMeasures & in_measures);
+
+    // Give the image parts copied by the decoding threads to the row bands notifier
+    bool forwardDecodedParts(bool in_row_bands);
+
+    // get the current time in seconds since the epoch (same clock than the reception times)
+    static double getRealTimeSec();
+
 private :
     // allow to force a stop of the thread
     volatile bool m_force_stop;
@@ -152,6 +163,15 @@ private :
     // running state in detail
     volatile RunningState m_running_state;
 
+    // metadata record of the frame being acquired
+    CameraFrameMetadata * m_metadata;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // the socket backlog and the treatment lag are sampled once every N image parts
+    static const int32_t g_parts_sample_interval;
+
     //------------------------------------------------------------------
     // singleton management
     //------------------------------------------------------------------
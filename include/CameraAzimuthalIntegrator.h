@@ -0,0 +1,255 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraAzimuthalIntegrator.h
+ * \brief  header file of the azimuthal integration stage (radial profiles of scattering frames).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAAZIMUTHALINTEGRATOR_H
+#define SPECTRALINSTRUMENTCAMERAAZIMUTHALINTEGRATOR_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+#include "CameraWriterThread.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraIntegrationGeometry
+    * \brief This structure contains the geometry of the experiment
+    *        and the binning of the radial profiles
+    *******************************************************************/
+    typedef struct CameraIntegrationGeometry
+    {
+        typedef enum Unit
+        {
+            Radius  , // distance to the beam center in frame pixels
+            TwoTheta, // scattering angle in degrees
+            Q       , // scattering vector modulus in inverse nanometers
+
+        } Unit;
+
+        double      m_center_x           ; // beam center column in frame pixels (0 is the left edge of the first pixel)
+        double      m_center_y           ; // beam center row in frame pixels (0 is the top edge of the first row)
+        double      m_pixel_size_um      ; // size of a frame pixel (binning included)
+        double      m_distance_mm        ; // sample to detector distance
+        double      m_wavelength_angstrom; // wavelength of the beam (Q unit only)
+        Unit        m_unit               ; // unit of the radial positions
+        std::size_t m_bins_nb            ; // number of bins of the profiles
+        double      m_min                ; // start of the first bin (automatic range if m_min >= m_max)
+        double      m_max                ; // end of the last bin
+        std::size_t m_subdivision        ; // pixels split in subdivision x subdivision parts between the bins
+
+    } CameraIntegrationGeometry;
+
+   /*******************************************************************
+    * \struct CameraRadialProfile
+    * \brief This structure contains the radial profile of a frame
+    *******************************************************************/
+    typedef struct CameraRadialProfile
+    {
+        std::size_t        m_frame_nb ; // frame number in the acquisition
+        std::vector<float> m_positions; // center of each bin in the unit of the geometry
+        std::vector<float> m_intensity; // weighted mean of the pixels of each bin
+        std::vector<float> m_variance ; // weighted variance of the pixels of each bin (azimuthal spread)
+        std::vector<float> m_weights  ; // number of pixels of each bin (split pixels count for their part)
+
+    } CameraRadialProfile;
+
+/*
+ *  \class CameraAzimuthalIntegrator
+ *  \brief This class reduces each frame to a radial profile and its variance, as soon as the
+ *         frame is assembled. The bin of each pixel (or of each part of a split pixel) is computed
+ *         from the geometry at the preparation of the acquisition and kept as a sparse matrix in
+ *         the compressed sparse row format: a row by bin, with the pixel indexes and the weights.
+ *         The profile of a frame is the product of this matrix and the frame. The rows are split
+ *         in chunks of similar sizes treated by the acquisition thread and a small pool of
+ *         threads, with SSE2 products accumulated in double precision.
+ *         The last profiles are kept in a ring buffer.
+ */
+class CameraAzimuthalIntegrator : public CameraSingleton<CameraAzimuthalIntegrator>, public CameraFrameStage, public CameraFrameWriter
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraAzimuthalIntegrator", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraAzimuthalIntegrator>;
+
+public:
+    // set the geometry (the matrix is built at the next acquisition)
+    bool setGeometry(const CameraIntegrationGeometry & in_geometry);
+
+    // get the geometry
+    CameraIntegrationGeometry getGeometry() const;
+
+    // set the number of threads which help the acquisition thread (0 for none)
+    bool setThreadsNb(std::size_t in_threads_nb);
+
+    // get the number of threads which help the acquisition thread
+    std::size_t getThreadsNb() const;
+
+    // get the number of non null elements of the matrix
+    std::size_t getMatrixSize() const;
+
+    // get the profile of a frame of the current acquisition
+    bool getProfile(std::size_t in_frame_nb, CameraRadialProfile & out_profile) const;
+
+    // get the profile of the last integrated frame
+    bool getLastProfile(CameraRadialProfile & out_profile) const;
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // integrate a complete frame (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // integrate the next chunk of the current frame, waits a short delay if there is none (called by the threads)
+    virtual void writeNext();
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraAzimuthalIntegrator();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraAzimuthalIntegrator();
+
+    // creates an autolock mutex for the chunks access
+    lima::AutoMutex chunksLock() const;
+
+    // compute the radial position of a point in the unit of the geometry
+    static double computePosition(const CameraIntegrationGeometry & in_geometry, double in_x, double in_y);
+
+    // build the sparse matrix of a frame size (the caller must hold the stage lock)
+    bool buildMatrix(std::size_t in_width, std::size_t in_height);
+
+    // integrate the bins of a chunk into the current profile
+    void integrateChunk(std::size_t in_chunk_index);
+
+    // sum the weighted values of a row of the matrix
+    static double sumValues(const uint16_t * in_data, const uint32_t * in_columns, const float * in_weights, std::size_t in_elements_nb);
+
+    // sum the weighted squared deviations of a row of the matrix
+    static double sumSquaredDeviations(const uint16_t * in_data       ,
+                                       const uint32_t * in_columns    ,
+                                       const float    * in_weights    ,
+                                       std::size_t      in_elements_nb,
+                                       float            in_mean       );
+
+    // fill a profile with a slot of the ring buffer (the caller must hold the stage lock)
+    void fillProfile(std::size_t in_slot, CameraRadialProfile & out_profile) const;
+
+    // stop and release the threads
+    void releaseThreads();
+
+private:
+    // threads which integrate the chunks with the acquisition thread
+    std::vector<CameraWriterThread *> m_threads;
+
+    // geometry of the experiment
+    CameraIntegrationGeometry m_geometry;
+
+    //------------------------------------------------------------------
+    // sparse matrix
+    //------------------------------------------------------------------
+    bool                     m_matrix_valid ; // true if the matrix matches the geometry and the frame size
+    std::size_t              m_matrix_width ; // frame width of the matrix
+    std::size_t              m_matrix_height; // frame height of the matrix
+    std::vector<uint32_t>    m_row_offsets  ; // index of the first element of each bin (bins number + 1 values)
+    std::vector<uint32_t>    m_columns      ; // pixel index of each element
+    std::vector<float>       m_weights      ; // part of the pixel in the bin for each element
+    std::vector<double>      m_bin_weights  ; // sum of the weights of each bin
+    std::vector<float>       m_positions    ; // center of each bin
+    std::vector<std::size_t> m_chunk_bins   ; // first bin of each chunk (chunks number + 1 values)
+
+    //------------------------------------------------------------------
+    // profiles of the acquisition (ring buffer)
+    //------------------------------------------------------------------
+    std::vector< std::vector<float> > m_ring_intensity; // intensity of each slot
+    std::vector< std::vector<float> > m_ring_variance ; // variance of each slot
+    std::vector<std::size_t>          m_ring_frame_nbs; // frame number of each slot
+    bool                              m_last_valid    ; // true if a frame was integrated in the acquisition
+    std::size_t                       m_last_frame_nb ; // frame number of the last integrated frame
+
+    //------------------------------------------------------------------
+    // frame being integrated by chunks
+    //------------------------------------------------------------------
+    const uint16_t * m_frame_data     ; // frame pixels (NULL if no frame is integrated)
+    float          * m_frame_intensity; // intensity of the profile being computed
+    float          * m_frame_variance ; // variance of the profile being computed
+    std::size_t      m_next_chunk     ; // next chunk to integrate
+    std::size_t      m_done_chunks_nb ; // number of integrated chunks
+
+    // condition variable used to protect the chunks
+    mutable lima::Cond m_chunks_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // maximum number of bins
+    static const std::size_t g_max_bins_nb;
+
+    // maximum pixel subdivision
+    static const std::size_t g_max_subdivision;
+
+    // number of chunks of the matrix rows
+    static const std::size_t g_chunks_nb;
+
+    // number of kept profiles
+    static const std::size_t g_ring_size;
+
+    // default number of threads
+    static const std::size_t g_default_threads_nb;
+
+    // maximum number of threads
+    static const std::size_t g_max_threads_nb;
+
+    // delay of a thread waiting for a chunk
+    static const double g_wait_delay_sec;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAAZIMUTHALINTEGRATOR_H
@@ -0,0 +1,198 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraBackgroundSubtraction.h
+ * \brief  header file of the rolling background subtraction stage (live mode).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERABACKGROUNDSUBTRACTION_H
+#define SPECTRALINSTRUMENTCAMERABACKGROUNDSUBTRACTION_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+
+// LIMA
+#include "lima/Debug.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraBackgroundModel
+    * \brief This structure contains a copy of the background model
+    *******************************************************************/
+    typedef struct CameraBackgroundModel
+    {
+        std::size_t        m_cell_size; // size of a square cell in frame pixels
+        std::size_t        m_width    ; // number of cells by row
+        std::size_t        m_height   ; // number of cells by column
+        std::size_t        m_frames_nb; // number of frames averaged in the model
+        std::vector<float> m_values   ; // background of each cell in ADU (row major)
+
+    } CameraBackgroundModel;
+
+/*
+ *  \class CameraBackgroundSubtraction
+ *  \brief This class subtracts a slowly drifting background from the frames, for the live and
+ *         alignment uses where a static dark frame is not enough. The background is an
+ *         exponential moving average of the mean of each cell of a decimated grid, interpolated
+ *         bilinearly between the cells centers. A constant offset is added to the subtracted
+ *         frames, so the noise below the background is not clipped.
+ *         Each frame is read and written once: with SSE2, the pass sums the raw pixels of the
+ *         cells for the model update and subtracts the current model, eight pixels at once.
+ *         The model is updated at the end of the frame, so a frame is corrected with the
+ *         background of the previous frames (the first frame initializes the model).
+ *         The Lima frame is modified, so the display and the writers get the subtracted frame.
+ */
+class CameraBackgroundSubtraction : public CameraSingleton<CameraBackgroundSubtraction>, public CameraFrameStage
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraBackgroundSubtraction", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraBackgroundSubtraction>;
+
+public:
+    // set the size of the cells of the grid (the model is reset)
+    bool setCellSize(std::size_t in_cell_size);
+
+    // get the size of the cells of the grid
+    std::size_t getCellSize() const;
+
+    // set the time constant of the moving average in frames
+    bool setTimeConstant(double in_frames_nb);
+
+    // get the time constant of the moving average in frames
+    double getTimeConstant() const;
+
+    // set the offset added to the subtracted frames
+    bool setOffset(double in_offset);
+
+    // get the offset added to the subtracted frames
+    double getOffset() const;
+
+    // forget the model (the next frame initializes it)
+    void reset();
+
+    // get a copy of the model
+    void getModel(CameraBackgroundModel & out_model) const;
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // subtract the background from a complete frame and update the model (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraBackgroundSubtraction();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraBackgroundSubtraction();
+
+    // build the grid of a frame size (the caller must hold the stage lock)
+    void buildGrid(std::size_t in_width, std::size_t in_height);
+
+    // compute the interpolation cell and weight of each pixel along an axis
+    static void computeWeights(std::size_t             in_size      ,
+                               std::size_t             in_cell_size ,
+                               std::vector<uint32_t> & out_cells    ,
+                               std::vector<float>    & out_weights  );
+
+    // interpolate the model along the rows of the frame (the caller must hold the stage lock)
+    void expandModel();
+
+    // initialize the model with the means of the cells of a frame (the caller must hold the stage lock)
+    void initModel(const uint16_t * in_data);
+
+    // subtract the model from a frame and sum its raw pixels into the cells (the caller must hold the stage lock)
+    void subtractAndSumCells(uint16_t * in_out_data);
+
+    // update the model with the sums of the cells (the caller must hold the stage lock)
+    void updateModel();
+
+private:
+    // size of the cells of the grid
+    std::size_t m_cell_size;
+
+    // time constant of the moving average in frames
+    double m_time_constant;
+
+    // offset added to the subtracted frames
+    double m_offset;
+
+    //------------------------------------------------------------------
+    // grid of the current frame size
+    //------------------------------------------------------------------
+    std::size_t           m_width         ; // frame width in pixels
+    std::size_t           m_height        ; // frame height in pixels
+    std::size_t           m_grid_width    ; // number of cells by row
+    std::size_t           m_grid_height   ; // number of cells by column
+    std::size_t           m_grid_cell     ; // cell size of the grid
+    std::vector<float>    m_model         ; // background of each cell
+    std::size_t           m_frames_nb     ; // number of frames averaged in the model (0 if not initialized)
+    std::vector<uint64_t> m_cell_sums     ; // sums of the raw pixels of each cell for the current frame
+    std::vector<float>    m_cell_pixels   ; // number of frame pixels of each cell
+    std::vector<float>    m_expanded      ; // model interpolated along the rows at each frame column (a row by cell row)
+    std::vector<uint32_t> m_column_cells  ; // left cell of the horizontal interpolation of each column
+    std::vector<float>    m_column_weights; // weight of the right cell of the horizontal interpolation of each column
+    std::vector<uint32_t> m_row_cells     ; // top cell of the vertical interpolation of each row
+    std::vector<float>    m_row_weights   ; // weight of the bottom cell of the vertical interpolation of each row
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // default size of the cells
+    static const std::size_t g_default_cell_size;
+
+    // maximum size of the cells
+    static const std::size_t g_max_cell_size;
+
+    // default time constant in frames
+    static const double g_default_time_constant;
+
+    // default offset added to the subtracted frames
+    static const double g_default_offset;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERABACKGROUNDSUBTRACTION_H
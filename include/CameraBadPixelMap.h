@@ -0,0 +1,198 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraBadPixelMap.h
+ * \brief  header file of the bad pixel map stage (hot and saturated pixels correction and counting).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERABADPIXELMAP_H
+#define SPECTRALINSTRUMENTCAMERABADPIXELMAP_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <set>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+
+// LIMA
+#include "lima/Debug.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+/*
+ *  \class CameraBadPixelMap
+ *  \brief This class manages a map of the bad pixels of the CCD.
+ *         The map is learned from dark frames (hot pixels) or from frames with saturated pixels.
+ *         During the frame finalization, the bad pixels are replaced by an interpolation of
+ *         their good neighbours (on the rows of the oriented frame) and the saturated pixels
+ *         of the frame are counted.
+ */
+class CameraBadPixelMap : public CameraSingleton<CameraBadPixelMap>, public CameraFrameStage
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraBadPixelMap", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraBadPixelMap>;
+
+public:
+    // learning modes
+    typedef enum LearningMode
+    {
+        None      , // no learning, the map is only applied
+        Dark      , // hot pixels learning with dark frames
+        Saturation, // saturated pixels learning
+
+    } LearningMode;
+
+    // remove all the bad pixels of the map
+    void clearMap();
+
+    // add a bad pixel (CCD coordinates) into the map
+    void addBadPixel(std::size_t in_ccd_x, std::size_t in_ccd_y);
+
+    // get the number of bad pixels of the map
+    std::size_t getBadPixelsNb() const;
+
+    // load the map from a text file (one "x y" CCD coordinates couple per line)
+    bool loadMap(const std::string & in_file_name);
+
+    // save the map into a text file (one "x y" CCD coordinates couple per line)
+    bool saveMap(const std::string & in_file_name) const;
+
+    // start a learning during the next acquisition frames
+    void startLearning(LearningMode in_mode, std::size_t in_frames_nb, double in_threshold);
+
+    // get the current learning mode (None when no learning is running)
+    LearningMode getLearningMode() const;
+
+    // set the level from which a pixel is considered as saturated
+    void setSaturationLevel(uint16_t in_saturation_level);
+
+    // get the level from which a pixel is considered as saturated
+    uint16_t getSaturationLevel() const;
+
+    // get the number of saturated pixels of a frame of the current acquisition
+    bool getSaturatedPixelsNb(std::size_t in_frame_nb, uint32_t & out_saturated_pixels_nb) const;
+
+    // get the number of saturated pixels of the latest treated frame
+    uint32_t getLastSaturatedPixelsNb() const;
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // treat a complete frame (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // a bad pixel of the frame and the two good pixels used to interpolate its value
+    typedef struct BadPixelCorrection
+    {
+        uint32_t m_index      ; // bad pixel index in the frame
+        uint32_t m_left_index ; // nearest good pixel on the left in the same row
+        uint32_t m_right_index; // nearest good pixel on the right in the same row
+
+    } BadPixelCorrection;
+
+    // constructor
+    CameraBadPixelMap();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraBadPixelMap();
+
+    // build the corrections list of the current frame format
+    void buildCorrections();
+
+    // count the pixels of a frame which reached the saturation level
+    uint32_t countSaturatedPixels(const uint16_t * in_data, std::size_t in_pixels_nb) const;
+
+    // accumulate a frame into the learning data
+    void learnFrame(const CameraFrame & in_frame);
+
+    // compute the learned bad pixels and add them into the map
+    void terminateLearning();
+
+    // add all the CCD pixels covered by a frame pixel into the map
+    void addFramePixel(std::size_t in_frame_index);
+
+private:
+    // bad pixels of the CCD (y, x) in CCD coordinates, independent of the roi and binning
+    std::set< std::pair<uint32_t, uint32_t> > m_ccd_bad_pixels;
+
+    // bad pixels of the frame with their interpolation neighbours
+    std::vector<BadPixelCorrection> m_corrections;
+
+    // format of the current acquisition frames
+    CameraFrameFormat m_format;
+
+    // orientation transform of the current acquisition frames
+    CameraFrameTransform m_transform;
+
+    // level from which a pixel is considered as saturated
+    uint16_t m_saturation_level;
+
+    // number of saturated pixels for each frame (used as a ring buffer in continuous acquisition)
+    std::vector<uint32_t> m_saturated_pixels_nb;
+
+    // number of saturated pixels of the latest treated frame
+    volatile uint32_t m_last_saturated_pixels_nb;
+
+    // learning data
+    LearningMode          m_learning_mode         ; // current learning mode
+    std::size_t           m_learning_frames_nb    ; // number of frames to accumulate
+    std::size_t           m_learning_frames_done  ; // number of frames already accumulated
+    double                m_learning_threshold    ; // sigma factor (dark) or occurrences ratio (saturation)
+    std::vector<double>   m_learning_sum          ; // pixels sum (dark)
+    std::vector<uint32_t> m_learning_occurrences  ; // saturated occurrences of each pixel (saturation)
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // size of the saturated pixels ring buffer used in continuous acquisition
+    static const std::size_t g_saturated_ring_size;
+
+    // default saturation level (16 bits full scale)
+    static const uint16_t g_default_saturation_level;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERABADPIXELMAP_H
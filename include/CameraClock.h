@@ -0,0 +1,141 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraClock.h
+ * \brief  header file of the plugin clock (real time or fast-forwarded virtual time).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERACLOCK_H
+#define SPECTRALINSTRUMENTCAMERACLOCK_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+/*
+ *  \class CameraClock
+ *  \brief This class gives the time to the timing layer of the plugin (timers, waits, packet
+ *         timeouts and frame timestamps). By default it follows the system clocks.
+ *         With a time scale greater than 1, the time runs faster than the system time: the waits
+ *         are shortened and the timestamps are stretched by the same ratio, so long exposures and
+ *         long sequences can be run in seconds against a fake server using the same scale.
+ *         The ordering of the events and the timeouts are kept in the virtual time.
+ *         The virtual time is continuous when the scale is changed.
+ */
+class CameraClock : public CameraSingleton<CameraClock>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraClock", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraClock>;
+
+public:
+    // set the time scale (1 for the real time, N to run N times faster)
+    bool setTimeScale(double in_time_scale);
+
+    // get the time scale
+    double getTimeScale() const;
+
+    // check if the clock runs in virtual time
+    bool isVirtual() const;
+
+    // get the monotonic time in seconds
+    double getMonotonicTimeSec() const;
+
+    // get the current time in seconds since the epoch
+    double getRealTimeSec() const;
+
+    // convert a system time since the epoch (kernel timestamps) into the clock time
+    double convertRealTimeSec(double in_system_time_sec) const;
+
+    // convert a delay of the clock into a system delay (condition and socket timeouts)
+    double toSystemDelaySec(double in_delay_sec) const;
+
+    // wait a delay of the clock
+    void sleepMsec(double in_delay_msec) const;
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraClock();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraClock();
+
+    // creates an autolock mutex for the clock data access
+    lima::AutoMutex clockLock() const;
+
+    // compute the clock monotonic time of a system monotonic time (the caller must hold the lock)
+    double computeMonotonicTimeSec(double in_system_monotonic_sec) const;
+
+    // get the system monotonic time in seconds
+    static double getSystemMonotonicTimeSec();
+
+    // get the system time in seconds since the epoch
+    static double getSystemRealTimeSec();
+
+private:
+    // virtual seconds per system second
+    double m_time_scale;
+
+    // system monotonic time of the latest scale change
+    double m_origin_system_sec;
+
+    // clock monotonic time of the latest scale change
+    double m_origin_clock_sec;
+
+    // condition variable used to protect the clock data
+    mutable lima::Cond m_clock_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // maximum time scale
+    static const double g_max_time_scale;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERACLOCK_H
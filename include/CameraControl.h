@@ -49,6 +49,7 @@
 #include <iomanip>
 #include <algorithm>
 #include <netinet/in.h>
+#include <netinet/tcp.h>
 
 // PROJECT
 #include "SpectralInstrumentCompatibility.h"
@@ -57,6 +58,7 @@
 #include "ProtectedList.h"
 #include "NetPacketsGroups.h"
 #include "CameraControlInit.h"
+#include "CameraParameterTable.h"
 
 // LIMA 
 #include "lima/Debug.h"
@@ -71,6 +73,43 @@ namespace lima
  */
 namespace SpectralInstrument 
 {
+   /*******************************************************************
+    * \struct CameraRoundTripStatistics
+    * \brief This structure contains the round trip times of a series
+    *        of commands (send of the command until its answer)
+    *******************************************************************/
+    typedef struct CameraRoundTripStatistics
+    {
+        std::size_t m_commands_nb; // number of commands
+        double      m_min_sec    ; // minimum round trip time
+        double      m_mean_sec   ; // mean round trip time
+        double      m_median_sec ; // median round trip time
+        double      m_p99_sec    ; // 99th percentile of the round trip times
+        double      m_max_sec    ; // maximum round trip time
+
+    } CameraRoundTripStatistics;
+
+   /*******************************************************************
+    * \struct CameraHardwareSettings
+    * \brief This structure contains the settings sent to the camera
+    *        by commands (used to apply a preset as one batch)
+    *******************************************************************/
+    typedef struct CameraHardwareSettings
+    {
+        std::size_t m_serial_origin     ; // CCD Format Serial Origin
+        std::size_t m_serial_length     ; // CCD Format Serial Length
+        std::size_t m_serial_binning    ; // CCD Format Serial Binning
+        std::size_t m_parallel_origin   ; // CCD Format Parallel Origin
+        std::size_t m_parallel_length   ; // CCD Format Parallel Length
+        std::size_t m_parallel_binning  ; // CCD Format Parallel Binning
+        uint32_t    m_exposure_time_msec; // exposure time in milli-seconds
+        uint32_t    m_readout_speed     ; // readout speed (DSI sample time)
+        uint8_t     m_cooling_value     ; // cooling value
+        uint16_t    m_pixels_per_packet ; // pixels per image packet
+        uint16_t    m_packet_delay_usec ; // packet sending loop delay in microseconds
+
+    } CameraHardwareSettings;
+
 /*
  *  \class CameraControl
  *  \brief This class is used to communicate with the detector software
@@ -203,6 +242,9 @@ class CameraControl : public CameraSingleton<CameraControl>
         // configure the wait timeout in seconds for the acquire command execution
         void computeTimeoutForAcquireCommand();
 
+        // configure the wait timeout of all the groups (to call after a change of the clock scale)
+        void updateWaitPacketTimeout();
+
        /**************************************************************************************************
         * COMMANDS MANAGEMENT
         **************************************************************************************************/
@@ -215,6 +257,24 @@ class CameraControl : public CameraSingleton<CameraControl>
         // Update the settings by sending a command to the hardware
         bool updateSettings();
 
+        // Fill the camera parameters cache by sending a command to the hardware
+        bool updateParameterTable();
+
+        // get the value of a camera parameter from the cache
+        bool getParameter(const std::string & in_group, const std::string & in_name, std::string & out_value) const;
+
+        // get a copy of all the cached camera parameters
+        bool getParameterTable(std::vector<CameraParameter> & out_parameters) const;
+
+        // change a batch of camera parameters by sending commands to the hardware
+        bool setParameters(const std::vector<CameraParameterChange> & in_changes);
+
+        // get the settings sent to the camera by commands
+        void getHardwareSettings(CameraHardwareSettings & out_settings) const;
+
+        // change the settings which differ from the current ones by sending a batch of commands to the hardware
+        bool setHardwareSettings(const CameraHardwareSettings & in_settings, std::size_t & out_commands_nb);
+
         // change the exposure time by sending a command to the hardware
         bool setExposureTimeMsec(uint32_t in_exposure_time_msec);
 
@@ -267,6 +327,30 @@ class CameraControl : public CameraSingleton<CameraControl>
 
         ushort getReadoutSpeedFromCamera() const;
 
+        // check if the reception times are given by the kernel (SO_TIMESTAMPNS)
+        bool hasKernelTimestamps() const;
+
+        // get the number of bytes waiting in the socket receive queue (SIOCINQ)
+        std::size_t getReceiveQueueBytes() const;
+
+        // get the size of the socket receive buffer (SO_RCVBUF)
+        std::size_t getReceiveBufferSize() const;
+
+        // get the number of received packets waiting for a consumer
+        std::size_t getPendingPacketsNb() const;
+
+        // get the TCP state of the socket (TCP_INFO)
+        bool getTcpInfo(struct tcp_info & out_info) const;
+
+        // set the low latency mode of the socket (busy polling, quick acknowledges, spinning reception)
+        bool setLowLatencyMode(bool in_enabled, int in_busy_poll_usec, int in_spin_window_usec);
+
+        // get the low latency mode of the socket
+        void getLowLatencyMode(bool & out_enabled, int & out_busy_poll_usec, int & out_spin_window_usec) const;
+
+        // measure the round trip times of a series of GetStatus commands
+        bool measureCommandRoundTrip(std::size_t in_nb_commands, CameraRoundTripStatistics & out_statistics);
+
        /***************************************************************************************************
         * SINGLETON MANAGEMENT
         ***************************************************************************************************/
@@ -282,6 +366,12 @@ class CameraControl : public CameraSingleton<CameraControl>
         // Receive a tcp/ip packet
         bool receive(uint8_t * out_buffer, const int in_buffer_lenght, int32_t & out_error);
 
+        // Receive the available tcp/ip data with one system call
+        bool receiveChunk(uint8_t * out_buffer, const int in_max_lenght, int & out_lenght, int32_t & out_error);
+
+        // Append a read of the socket to the data kept in the reception buffer
+        bool appendChunk(int32_t & out_error);
+
         // Receive a SI Image SGL II sub packet (a part of the complete packet)
         bool receiveSubPacket(NetGenericHeader * out_packet, std::vector<uint8_t> & in_out_net_buffer, int32_t & out_error);
 
@@ -302,7 +392,6 @@ class CameraControl : public CameraSingleton<CameraControl>
         // Receive an image part sub packet with a specific lenght
         bool receiveImageSubPacket(const NetGenericHeader & in_packet             ,
                                    const NetImageHeader   & in_image_header_packet,
-                                   NetImage               * out_packet            ,
                                    std::vector<uint8_t>   & in_out_net_buffer     ,
                                    int32_t                & out_error             );
 
@@ -320,6 +409,9 @@ class CameraControl : public CameraSingleton<CameraControl>
         // Send a command to the detector and does not wait an acknowledge (only special commands)
         bool sendCommandWithoutAck(NetCommandHeader * in_out_command, int32_t & out_error);
 
+        // Send a batch of commands, then wait for their command done packets
+        bool sendCommandBatch(const std::vector<NetCommandHeader *> & in_commands, std::vector<bool> & out_accepted);
+
         // Change the format parameters by sending a command to the hardware
         bool setFormatParameters(std::size_t in_serial_origin   ,
                                  std::size_t in_serial_length   , 
@@ -338,18 +430,14 @@ class CameraControl : public CameraSingleton<CameraControl>
         // execute a not blocking connect
         bool notBlockingConnect(struct sockaddr_in & in_out_sa, int sock, int timeout);
 
+        // get the monotonic time in nanoseconds
+        static uint64_t getMonotonicTimeNsec();
+
         // search and find a line which has the given key
         static bool findLineWithKey(const std::string & in_lines ,
                                     const std::string & in_key   ,
                                     std::string       & out_line );
 
-        // Search and find a line which has the two given keys
-        static bool findLineWithTwoKey(const std::string & in_lines     ,
-                                       const std::string & in_first_key ,
-                                       const std::string & in_second_key,
-                                       const std::string & in_delimiter ,
-                                       std::string       & out_line     );
-
         // Cut a substring with a position and delimiter
         static bool getSubString(const std::string & in_string     ,
                                  std::size_t         in_pos        ,
@@ -368,10 +456,54 @@ class CameraControl : public CameraSingleton<CameraControl>
         // creates an autolock mutex for sendCommand access
         lima::AutoMutex sendCommandLock() const;
 
+        // creates an autolock mutex for the camera parameters cache access
+        lima::AutoMutex parametersLock() const;
+
+        // creates an autolock mutex to send only one commands batch at a time
+        lima::AutoMutex commandBatchLock() const;
+
+        // update the cached value of an accepted parameter change
+        void updateParameterValue(const CameraParameterChange & in_change);
+
     private:
         // socket for commands and answers
         int m_sock;
 
+        // true if the kernel gives the reception time of the received data (SO_TIMESTAMPNS)
+        bool m_kernel_timestamps;
+
+        // reception time in seconds (epoch) of the latest data read by the receive method
+        double m_receive_time;
+
+        // true if the low latency mode of the socket is active
+        bool m_low_latency;
+
+        // busy polling delay of the socket in low latency mode (SO_BUSY_POLL)
+        int m_busy_poll_usec;
+
+        // duration of the spinning reception after the send of a command in low latency mode
+        int m_spin_window_usec;
+
+        // end of the spinning reception window (monotonic time in nanoseconds)
+        uint64_t m_spin_deadline_nsec;
+
+        // reception buffer filled by large reads of the socket
+        std::vector<uint8_t> m_receive_chunk;
+
+        // range of the received data not yet used in the reception buffer
+        std::size_t m_chunk_begin;
+        std::size_t m_chunk_end  ;
+
+        // end offset in the reception buffer and reception time of each read of the buffer
+        std::vector<std::size_t> m_chunk_read_ends ;
+        std::vector<double>      m_chunk_read_times;
+
+        // first read of the reception buffer which still contains data not yet used
+        std::size_t m_chunk_read_index;
+
+        // number of received data not yet used (read by the other threads with an atomic access)
+        mutable volatile std::size_t m_chunk_buffered_nb;
+
         // address of remote server
         struct sockaddr_in m_server_name; 
         
@@ -442,6 +574,25 @@ class CameraControl : public CameraSingleton<CameraControl>
         float m_ccd_temperature;
 
         ushort m_readout_speed_value;
+
+        // cache of the camera parameters table (GetCameraParameters)
+        CameraParameterTable m_parameters;
+
+        // condition variable used to protect the camera parameters cache
+        mutable lima::Cond m_parameters_cond;
+
+        // condition variable used to send only one commands batch at a time
+        mutable lima::Cond m_command_batch_cond;
+
+        // image packets settings sent to the camera
+        uint16_t m_pixels_per_packet;
+        uint16_t m_packet_delay_usec;
+
+        //------------------------------------------------------------------
+        // constants
+        //------------------------------------------------------------------
+        // size of the reception buffer
+        static const std::size_t g_receive_chunk_size;
 };
 
 } // namespace SpectralInstrument
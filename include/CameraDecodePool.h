@@ -0,0 +1,237 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraDecodePool.h
+ * \brief  header file of the image parts decoding threads pool.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERADECODEPOOL_H
+#define SPECTRALINSTRUMENTCAMERADECODEPOOL_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+#include <deque>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraWriterThread.h"
+#include "CameraFrameTransform.h"
+#include "NetPackets.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+#include "lima/SizeUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraDecodedPart
+    * \brief This structure contains the position of a decoded image
+    *        part in the source image
+    *******************************************************************/
+    typedef struct CameraDecodedPart
+    {
+        std::size_t m_offset   ; // offset of the first pixel of the part in the source image
+        std::size_t m_pixels_nb; // number of pixels of the part
+
+    } CameraDecodedPart;
+
+   /*******************************************************************
+    * \struct CameraDecodeScaling
+    * \brief This structure contains the decoding throughput measured
+    *        for a number of threads
+    *******************************************************************/
+    typedef struct CameraDecodeScaling
+    {
+        std::size_t m_threads_nb    ; // number of decoding threads
+        double      m_duration_sec  ; // decoding duration of the synthetic frame
+        double      m_pixels_per_sec; // decoded pixels per second
+        double      m_speedup       ; // throughput compared to one thread
+
+    } CameraDecodeScaling;
+
+   /*******************************************************************
+    * \struct CameraDecodeJob
+    * \brief This structure contains an image part given to the pool
+    *******************************************************************/
+    typedef struct CameraDecodeJob
+    {
+        NetImage m_image ; // image part (pixels in the network byte order until the decoding)
+        bool     m_done  ; // true when the part was decoded and copied
+        bool     m_result; // true if the copies were a success
+
+    } CameraDecodeJob;
+
+/*
+ *  \class CameraDecodePool
+ *  \brief This class converts the pixels of the received image parts from the network byte
+ *         order and copies them into the frame with a small pool of threads, so the acquisition
+ *         thread only checks the headers. The parts are given to the threads by batches.
+ *         The completed parts are given back in the reception order, so the completion of the
+ *         rows does not depend on the threads scheduling.
+ *         No thread is used by default: the acquisition thread decodes the parts itself.
+ */
+class CameraDecodePool : public CameraSingleton<CameraDecodePool>, public CameraFrameWriter
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraDecodePool", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraDecodePool>;
+
+public:
+    // set the number of decoding threads (0 to decode in the acquisition thread)
+    bool setThreadsNb(std::size_t in_threads_nb);
+
+    // get the number of decoding threads
+    std::size_t getThreadsNb() const;
+
+    // set the number of image parts of a batch
+    bool setBatchSize(std::size_t in_batch_size);
+
+    // get the number of image parts of a batch
+    std::size_t getBatchSize() const;
+
+    // start the decoding of a frame (called by the acquisition thread)
+    void startFrame(void                       * in_data     ,
+                    const lima::FrameDim       & in_frame_dim,
+                    const CameraFrameTransform & in_transform,
+                    std::size_t                  in_frame_nb ,
+                    bool                         in_mosaic   );
+
+    // give an image part to the pool, its pixels are moved (called by the acquisition thread)
+    void submit(NetImage & in_out_image);
+
+    // get the parts completed in the reception order since the previous call (called by the acquisition thread)
+    bool takeCompleted(std::vector<CameraDecodedPart> & out_parts);
+
+    // wait the decoding of all the parts of the frame (called by the acquisition thread)
+    bool waitFrame();
+
+    // end the decoding of a frame, the parts not yet decoded are dropped (called by the acquisition thread)
+    void endFrame();
+
+    // measure the decoding throughput of a synthetic frame from 1 to N threads
+    bool measureScaling(std::size_t                        in_max_threads_nb ,
+                        std::size_t                        in_width          ,
+                        std::size_t                        in_height         ,
+                        std::size_t                        in_pixels_per_part,
+                        std::vector<CameraDecodeScaling> & out_results       );
+
+    // decode the next batch, waits a short delay if there is no batch (called by the decoding threads)
+    virtual void writeNext();
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraDecodePool();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraDecodePool();
+
+    // creates an autolock mutex for the pool data access
+    lima::AutoMutex poolLock() const;
+
+    // give the parts not yet dispatched to the threads (the caller must hold the lock)
+    void dispatch();
+
+    // stop and release the decoding threads
+    void releaseThreads();
+
+private:
+    // decoding threads
+    std::vector<CameraWriterThread *> m_threads;
+
+    // number of image parts of a batch
+    std::size_t m_batch_size;
+
+    // unused jobs (kept between the frames)
+    std::vector<CameraDecodeJob *> m_free_jobs;
+
+    //------------------------------------------------------------------
+    // frame being decoded
+    //------------------------------------------------------------------
+    // frame pixels (NULL if no frame is decoded)
+    void * m_frame_data;
+
+    // frame data
+    lima::FrameDim m_frame_dim;
+
+    // orientation applied during the copy
+    CameraFrameTransform m_transform;
+
+    // frame number in the acquisition
+    std::size_t m_frame_nb;
+
+    // true if the parts are also copied into the mosaic
+    bool m_mosaic;
+
+    // jobs of the frame in the reception order
+    std::vector<CameraDecodeJob *> m_jobs;
+
+    // index of the first job not yet dispatched
+    std::size_t m_dispatched_nb;
+
+    // index of the first job not yet given by takeCompleted
+    std::size_t m_completed_nb;
+
+    // batches waiting for a thread
+    std::deque< std::vector<CameraDecodeJob *> > m_batches;
+
+    // number of dispatched jobs not yet decoded
+    std::size_t m_in_flight_nb;
+
+    // condition variable used to protect the pool data and to wake up the threads
+    mutable lima::Cond m_pool_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // default number of image parts of a batch
+    static const std::size_t g_default_batch_size;
+
+    // maximum number of decoding threads
+    static const std::size_t g_max_threads_nb;
+
+    // delay of the waits for a batch or for the decoding end
+    static const double g_wait_delay_sec;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERADECODEPOOL_H
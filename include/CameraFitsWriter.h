@@ -0,0 +1,307 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFitsWriter.h
+ * \brief  header file of the FITS writer stage.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAFITSWRITER_H
+#define SPECTRALINSTRUMENTCAMERAFITSWRITER_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+#include "CameraWriterThread.h"
+#include "ProtectedList.h"
+
+// LIMA
+#include "lima/Debug.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraFitsCounters
+    * \brief This structure contains the counters of the FITS writer
+    *******************************************************************/
+    typedef struct CameraFitsCounters
+    {
+        uint64_t m_queued_frames_nb ; // number of frames queued for the writing
+        uint64_t m_written_frames_nb; // number of frames written
+        uint64_t m_dropped_frames_nb; // number of frames not written because the queue was full
+        uint64_t m_errors_nb        ; // number of frames not written because of a file error
+        uint64_t m_written_bytes_nb ; // number of bytes written (headers included)
+
+    } CameraFitsCounters;
+
+   /*******************************************************************
+    * \struct CameraFitsSettings
+    * \brief This structure contains the camera settings of an
+    *        acquisition, used to fill the FITS headers
+    *******************************************************************/
+    typedef struct CameraFitsSettings
+    {
+        std::string m_path_prefix     ; // directory and prefix of the files
+        std::size_t m_acquisition_nb  ; // index of the acquisition used in the files names
+        bool        m_multi_extension ; // true for one file by acquisition with one extension by frame
+        std::size_t m_width           ; // frame width in pixels
+        std::size_t m_height          ; // frame height in pixels
+        double      m_exposure_sec    ; // exposure time in seconds
+        std::size_t m_serial_binning  ; // CCD Format Serial Binning
+        std::size_t m_parallel_binning; // CCD Format Parallel Binning
+        std::size_t m_serial_origin   ; // CCD Format Serial Origin
+        std::size_t m_parallel_origin ; // CCD Format Parallel Origin
+        double      m_ccd_temperature ; // CCD temperature in Celsius degrees
+        int         m_readout_speed   ; // readout speed (DSI sample time) setting
+        std::string m_model           ; // camera model
+        std::string m_serial_number   ; // camera serial number
+
+    } CameraFitsSettings;
+
+   /*******************************************************************
+    * \struct CameraFitsJob
+    * \brief This structure contains a job of the writer thread
+    *******************************************************************/
+    typedef struct CameraFitsJob
+    {
+        typedef enum Type
+        {
+            Open , // start of an acquisition
+            Frame, // frame to write
+            Close, // end of an acquisition
+
+        } Type;
+
+        Type                  m_type    ; // kind of job
+        CameraFitsSettings    m_settings; // settings of the acquisition (Open job)
+        std::vector<uint16_t> m_data    ; // frame pixels (Frame job)
+        std::size_t           m_width   ; // frame width in pixels (Frame job)
+        std::size_t           m_height  ; // frame height in pixels (Frame job)
+        std::size_t           m_frame_nb; // frame number in the acquisition (Frame job)
+        CameraFrameMetadata   m_metadata; // frame metadata (Frame job)
+
+    } CameraFitsJob;
+
+/*
+ *  \class CameraFitsWriter
+ *  \brief This class writes the complete frames into FITS files (16 bits signed integers
+ *         with BZERO = 32768) with the camera settings in the headers.
+ *         The frames can be written in one file by frame, or in one file by acquisition with
+ *         one IMAGE extension by frame. The acquisition thread only copies the frame into a
+ *         preallocated buffer, the conversion to big endian and the large writes are done by
+ *         a background thread. When no buffer is free, the frame is not written and counted.
+ */
+class CameraFitsWriter : public CameraSingleton<CameraFitsWriter>, public CameraFrameStage, public CameraFrameWriter
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraFitsWriter", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraFitsWriter>;
+
+public:
+    // files organization
+    typedef enum Mode
+    {
+        OneFilePerFrame, // one simple FITS file by frame
+        MultiExtension , // one file by acquisition with one IMAGE extension by frame
+
+    } Mode;
+
+    // set the files organization
+    void setMode(Mode in_mode);
+
+    // get the files organization
+    Mode getMode() const;
+
+    // set the directory and prefix of the files
+    void setPathPrefix(const std::string & in_path_prefix);
+
+    // get the directory and prefix of the files
+    std::string getPathPrefix() const;
+
+    // set the number of frame buffers of the queue
+    bool setBuffersNb(std::size_t in_buffers_nb);
+
+    // get the number of frame buffers of the queue
+    std::size_t getBuffersNb() const;
+
+    // get the counters
+    CameraFitsCounters getCounters() const;
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // treat a complete frame (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // close the files of the current acquisition (called by the acquisition thread)
+    void endAcq();
+
+    // write the next queued job (called by the writer thread)
+    virtual void writeNext();
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraFitsWriter();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraFitsWriter();
+
+    // write a job
+    void writeJob(CameraFitsJob * in_job);
+
+    // give a frame buffer back to the free list or release a job
+    void releaseJob(CameraFitsJob * in_job);
+
+    // add a card to a header
+    static void addCard(std::string & in_out_header, const std::string & in_key, const std::string & in_value, const std::string & in_comment);
+
+    // add a logical card to a header
+    static void addLogicalCard(std::string & in_out_header, const std::string & in_key, bool in_value, const std::string & in_comment);
+
+    // add an integer card to a header
+    static void addIntegerCard(std::string & in_out_header, const std::string & in_key, long long in_value, const std::string & in_comment);
+
+    // add a floating point card to a header
+    static void addDoubleCard(std::string & in_out_header, const std::string & in_key, double in_value, const std::string & in_comment);
+
+    // add a string card to a header
+    static void addStringCard(std::string & in_out_header, const std::string & in_key, const std::string & in_value, const std::string & in_comment);
+
+    // add the END card and pad the header to a complete block
+    static void endHeader(std::string & in_out_header);
+
+    // add the camera settings cards to a header
+    static void addSettingsCards(std::string & in_out_header, const CameraFitsSettings & in_settings);
+
+    // add the frame cards to a header
+    static void addFrameCards(std::string & in_out_header, const CameraFitsJob & in_job);
+
+    // open a file
+    bool openFile(const std::string & in_file_name);
+
+    // write a block of data into the file
+    bool writeBytes(const void * in_data, std::size_t in_size);
+
+    // write the pixels of a frame into the file (conversion to big endian signed integers)
+    bool writePixels(const CameraFitsJob & in_job);
+
+    // pad the data of the current HDU to a complete block
+    bool padData(std::size_t in_data_size);
+
+    // flush the write buffer into the file
+    bool flush();
+
+    // close the file
+    void closeFile();
+
+private:
+    // files organization
+    Mode m_mode;
+
+    // directory and prefix of the files
+    std::string m_path_prefix;
+
+    // number of frame buffers of the queue
+    std::size_t m_buffers_nb;
+
+    // number of frame buffers created
+    std::size_t m_created_buffers_nb;
+
+    // index of the next acquisition
+    std::size_t m_acquisition_nb;
+
+    // true if the current acquisition is written
+    bool m_acquisition_opened;
+
+    // counters
+    CameraFitsCounters m_counters;
+
+    // queued jobs
+    ProtectedList<CameraFitsJob> m_pending_jobs;
+
+    // free frame buffers
+    ProtectedList<CameraFitsJob> m_free_jobs;
+
+    //------------------------------------------------------------------
+    // writer thread data
+    //------------------------------------------------------------------
+    // settings of the acquisition being written
+    CameraFitsSettings m_settings;
+
+    // true if the settings of the acquisition being written are valid
+    bool m_settings_valid;
+
+    // file descriptor of the current file (-1 if none)
+    int m_file;
+
+    // write buffer (aligned on the memory pages)
+    uint8_t * m_write_buffer;
+
+    // number of bytes in the write buffer
+    std::size_t m_write_buffer_used;
+
+    // writer thread
+    CameraWriterThread * m_thread;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // size of a FITS block
+    static const std::size_t g_block_size;
+
+    // size of a FITS card
+    static const std::size_t g_card_size;
+
+    // size of the write buffer
+    static const std::size_t g_write_buffer_size;
+
+    // default number of frame buffers
+    static const std::size_t g_default_buffers_nb;
+
+    // delay in seconds to wait for a job before checking the end of the thread
+    static const double g_wait_job_delay_sec;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAFITSWRITER_H
@@ -0,0 +1,171 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameChangeDetector.h
+ * \brief  header file of the frame change detection stage (marks or drops the redundant frames).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAFRAMECHANGEDETECTOR_H
+#define SPECTRALINSTRUMENTCAMERAFRAMECHANGEDETECTOR_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+
+// LIMA
+#include "lima/Debug.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraFrameChangeCounters
+    * \brief This structure contains the counters of the frame change detection
+    *******************************************************************/
+    typedef struct CameraFrameChangeCounters
+    {
+        uint64_t m_compared_frames_nb ; // number of frames compared to the reference
+        uint64_t m_changed_frames_nb  ; // number of frames which became the new reference
+        uint64_t m_unchanged_frames_nb; // number of frames marked or dropped
+        uint64_t m_full_checks_nb     ; // number of frames which needed a full comparison
+        double   m_last_difference    ; // mean absolute difference by pixel of the latest compared frame
+
+    } CameraFrameChangeCounters;
+
+/*
+ *  \class CameraFrameChangeDetector
+ *  \brief This class compares each frame to a reference frame (the latest changed frame)
+ *         and marks or drops the frames which did not change enough.
+ *         The metric is the mean absolute difference by pixel, first computed on a
+ *         subsampled grid of rows, then on the full frame when the subsampled value
+ *         does not already show a change.
+ */
+class CameraFrameChangeDetector : public CameraSingleton<CameraFrameChangeDetector>, public CameraFrameStage
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraFrameChangeDetector", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraFrameChangeDetector>;
+
+public:
+    // treatment of the unchanged frames
+    typedef enum Mode
+    {
+        Mark, // the frame is given to Lima and flagged as unchanged
+        Drop, // the frame is not given to Lima
+
+    } Mode;
+
+    // set the treatment of the unchanged frames
+    void setMode(Mode in_mode);
+
+    // get the treatment of the unchanged frames
+    Mode getMode() const;
+
+    // set the mean absolute difference by pixel under which a frame is unchanged
+    void setThreshold(double in_threshold);
+
+    // get the mean absolute difference by pixel under which a frame is unchanged
+    double getThreshold() const;
+
+    // forget the reference frame (the next frame will be kept)
+    void resetReference();
+
+    // get the counters since the start of the acquisition
+    CameraFrameChangeCounters getCounters() const;
+
+    // check if a frame of the current acquisition was flagged as changed
+    bool isFrameChanged(std::size_t in_frame_nb, bool & out_changed) const;
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // treat a complete frame (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraFrameChangeDetector();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraFrameChangeDetector();
+
+    // compute the sum of absolute differences of two rows
+    static uint64_t computeRowDifference(const uint16_t * in_first, const uint16_t * in_second, std::size_t in_pixels_nb);
+
+    // compute the mean absolute difference by pixel on one row every in_row_step rows
+    double computeDifference(const CameraFrame & in_frame, std::size_t in_row_step) const;
+
+private:
+    // treatment of the unchanged frames
+    Mode m_mode;
+
+    // mean absolute difference by pixel under which a frame is unchanged
+    double m_threshold;
+
+    // reference frame (latest changed frame)
+    std::vector<uint16_t> m_reference;
+
+    // true if the reference frame is valid
+    bool m_reference_valid;
+
+    // counters
+    CameraFrameChangeCounters m_counters;
+
+    // changed flag of each frame (used as a ring buffer in continuous acquisition)
+    std::vector<uint8_t> m_changed_flags;
+
+    // number of frames of the acquisition (0 for a continuous acquisition)
+    std::size_t m_nb_frames;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // one row every g_grid_row_step rows is used for the subsampled comparison
+    static const std::size_t g_grid_row_step;
+
+    // size of the flags ring buffer used in continuous acquisition
+    static const std::size_t g_flags_ring_size;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAFRAMECHANGEDETECTOR_H
@@ -0,0 +1,148 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameMetadataTable.h
+ * \brief  header file of the per-frame metadata table.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAFRAMEMETADATATABLE_H
+#define SPECTRALINSTRUMENTCAMERAFRAMEMETADATATABLE_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+
+// LIMA
+#include "lima/Debug.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraFrameMetadata
+    * \brief This structure contains the metadata of a frame, filled
+    *        by the acquisition thread during the frame acquisition.
+    *        The times are in seconds since the epoch (0 if unknown).
+    *******************************************************************/
+    typedef struct CameraFrameMetadata
+    {
+        uint64_t m_frame_nb            ; // frame number in the acquisition
+        uint32_t m_acquisition_nb      ; // index of the acquisition since the plugin start
+        uint32_t m_image_identifier    ; // image identifier given by the camera
+        uint32_t m_exposure_time_msec  ; // exposure time used
+        uint32_t m_readout_speed       ; // readout speed (DSI sample time) setting
+        uint32_t m_serial_origin       ; // CCD Format Serial Origin
+        uint32_t m_parallel_origin     ; // CCD Format Parallel Origin
+        uint32_t m_serial_length       ; // CCD Format Serial Length
+        uint32_t m_parallel_length     ; // CCD Format Parallel Length
+        uint32_t m_serial_binning      ; // CCD Format Serial Binning
+        uint32_t m_parallel_binning    ; // CCD Format Parallel Binning
+        uint32_t m_parts_nb            ; // number of received image parts
+        float    m_ccd_temperature     ; // CCD temperature in Celsius degrees (last status before the acquisition)
+        uint64_t m_bytes_nb            ; // number of received pixels bytes
+        double   m_acquire_time        ; // send of the acquire command
+        double   m_readout_time        ; // first acquisition status with the exposure done
+        double   m_acquisition_end_time; // reception of the acquire command done
+        double   m_retrieve_time       ; // send of the retrieve image command
+        double   m_first_part_time     ; // reception of the first image part header
+        double   m_last_part_time      ; // reception of the last image part data
+        double   m_processed_time      ; // end of the processing stages, before the frame is given to Lima
+
+    } CameraFrameMetadata;
+
+/*
+ *  \class CameraFrameMetadataTable
+ *  \brief This class keeps the metadata of the latest frames in a ring of records indexed
+ *         by the frame number. The acquisition thread fills the record of a frame in place
+ *         and publishes it at the end of the frame treatment. Each record has a sequence
+ *         counter (odd during the filling), so the readers copy a record without locking
+ *         and detect a record which was changed during the copy.
+ *         The processing stages receive a pointer to the record of the current frame.
+ */
+class CameraFrameMetadataTable : public CameraSingleton<CameraFrameMetadataTable>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraFrameMetadataTable", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraFrameMetadataTable>;
+
+public:
+    // start a new acquisition (the records of the previous acquisitions become invalid)
+    void prepareAcq();
+
+    // get the record of a frame and mark it as being filled (called by the acquisition thread)
+    CameraFrameMetadata * startFrame(std::size_t in_frame_nb);
+
+    // publish the record of a frame (called by the acquisition thread)
+    void publishFrame(CameraFrameMetadata * in_record);
+
+    // get a copy of the metadata of a frame of the current acquisition
+    bool getFrameMetadata(std::size_t in_frame_nb, CameraFrameMetadata & out_metadata) const;
+
+    // get the number of frames kept in the table
+    static std::size_t getRingSize();
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraFrameMetadataTable();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraFrameMetadataTable();
+
+private:
+    // records of the latest frames (allocated once, never reallocated)
+    std::vector<CameraFrameMetadata> m_records;
+
+    // sequence counter of each record (odd during the filling)
+    std::vector<uint32_t> m_sequences;
+
+    // index of the current acquisition
+    uint32_t m_acquisition_nb;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // number of records of the ring
+    static const std::size_t g_ring_size;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAFRAMEMETADATATABLE_H
@@ -0,0 +1,203 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameProcessing.h
+ * \brief  header file of the frame processing pipeline (stages applied during frame finalization).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAFRAMEPROCESSING_H
+#define SPECTRALINSTRUMENTCAMERAFRAMEPROCESSING_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameTransform.h"
+#include "CameraFrameMetadataTable.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraFrameFormat
+    * \brief This structure describes the frames of the next acquisition
+    *******************************************************************/
+    typedef struct CameraFrameFormat
+    {
+        std::size_t m_width           ; // frame width in pixels (binning and orientation applied)
+        std::size_t m_height          ; // frame height in pixels (binning and orientation applied)
+        std::size_t m_serial_origin   ; // CCD Format Serial Origin
+        std::size_t m_parallel_origin ; // CCD Format Parallel Origin
+        std::size_t m_serial_binning  ; // CCD Format Serial Binning
+        std::size_t m_parallel_binning; // CCD Format Parallel Binning
+        std::size_t m_width_max       ; // detector maximum width (CCD pixels)
+        std::size_t m_height_max      ; // detector maximum height (CCD pixels)
+        std::size_t m_pixel_depth     ; // pixel depth in bits
+        std::size_t m_nb_frames       ; // number of frames to acquire (0 for a continuous acquisition)
+
+        CameraFrameTransform::Orientation m_orientation; // orientation of the frame compared to the CCD readout
+
+    } CameraFrameFormat;
+
+   /*******************************************************************
+    * \struct CameraFrame
+    * \brief This structure gives access to a complete frame during its finalization
+    *******************************************************************/
+    typedef struct CameraFrame
+    {
+        uint16_t    * m_data    ; // frame pixels (Lima buffer)
+        std::size_t   m_width   ; // frame width in pixels
+        std::size_t   m_height  ; // frame height in pixels
+        std::size_t   m_frame_nb; // frame number in the acquisition
+        bool          m_drop    ; // set by a stage when the frame should not be given to Lima
+
+        const CameraFrameMetadata * m_metadata; // metadata record of the frame (filled until the reception end)
+
+    } CameraFrame;
+
+/*
+ *  \class CameraFrameStage
+ *  \brief This class is the base class of the processing stages applied to a frame
+ *         when its last image part was received, before it is given to Lima.
+ */
+class CameraFrameStage
+{
+public:
+    // constructor
+    explicit CameraFrameStage(const std::string & in_name);
+
+    // destructor (needs to be virtual)
+    virtual ~CameraFrameStage();
+
+    // get the stage name
+    const std::string & getName() const;
+
+    // enable or disable the stage
+    void setEnabled(bool in_enabled);
+
+    // check if the stage is enabled
+    bool isEnabled() const;
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // treat a complete frame (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame) = 0;
+
+protected:
+    // creates an autolock mutex for the stage data access
+    lima::AutoMutex stageLock() const;
+
+private:
+    // stage name used during logging
+    std::string m_name;
+
+    // true if the stage should be applied
+    volatile bool m_enabled;
+
+    // condition variable used to protect the stage data
+    mutable lima::Cond m_stage_cond;
+};
+
+/*
+ *  \class CameraFrameProcessing
+ *  \brief This class manages the ordered list of the processing stages.
+ *         The stages are owned by their own singletons, this class only keeps their order.
+ */
+class CameraFrameProcessing : public CameraSingleton<CameraFrameProcessing>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraFrameProcessing", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraFrameProcessing>;
+
+public:
+    // add a stage at the end of the pipeline
+    void addStage(CameraFrameStage * in_stage);
+
+    // remove a stage from the pipeline
+    void removeStage(CameraFrameStage * in_stage);
+
+    // prepare all the stages for a new acquisition
+    bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // apply all the enabled stages to a complete frame
+    bool process(CameraFrame & in_out_frame);
+
+    // get the format of the current acquisition
+    const CameraFrameFormat & getFormat() const;
+
+    // set the orientation applied during the frame assembly
+    void setOrientation(CameraFrameTransform::Orientation in_orientation);
+
+    // get the orientation transform applied during the frame assembly
+    const CameraFrameTransform & getTransform() const;
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraFrameProcessing();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraFrameProcessing();
+
+    // creates an autolock mutex for the stages list access
+    lima::AutoMutex stagesLock() const;
+
+private:
+    // ordered stages
+    std::vector<CameraFrameStage *> m_stages;
+
+    // format of the current acquisition
+    CameraFrameFormat m_format;
+
+    // orientation transform applied by the image parts copy
+    CameraFrameTransform m_transform;
+
+    // condition variable used to protect the stages list
+    mutable lima::Cond m_stages_cond;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAFRAMEPROCESSING_H
@@ -0,0 +1,346 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameStacker.h
+ * \brief  header file of the frame stacking stage with drift registration.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAFRAMESTACKER_H
+#define SPECTRALINSTRUMENTCAMERAFRAMESTACKER_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <complex>
+#include <deque>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+#include "CameraWriterThread.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraStackCounters
+    * \brief This structure contains the counters of the stacking
+    *******************************************************************/
+    typedef struct CameraStackCounters
+    {
+        uint64_t m_queued_frames_nb ; // number of frames queued for the stacking
+        uint64_t m_stacked_frames_nb; // number of frames registered and accumulated
+        uint64_t m_dropped_frames_nb; // number of frames not stacked because the queue was full
+
+    } CameraStackCounters;
+
+   /*******************************************************************
+    * \struct CameraStackShift
+    * \brief This structure contains the measured drift of a frame
+    *        against the reference frame
+    *******************************************************************/
+    typedef struct CameraStackShift
+    {
+        std::size_t m_frame_nb; // frame number in the acquisition
+        double      m_shift_x ; // horizontal shift in pixels (the frame content moved to the right)
+        double      m_shift_y ; // vertical shift in pixels (the frame content moved to the bottom)
+        double      m_peak    ; // normalized cross-correlation peak (1 for a perfect match)
+
+    } CameraStackShift;
+
+   /*******************************************************************
+    * \struct CameraStackImage
+    * \brief This structure contains a copy of the stack. The mean of a
+    *        pixel is its sum divided by its coverage.
+    *******************************************************************/
+    typedef struct CameraStackImage
+    {
+        std::size_t           m_width    ; // stack width in pixels
+        std::size_t           m_height   ; // stack height in pixels
+        std::size_t           m_frames_nb; // number of accumulated frames
+        std::vector<uint32_t> m_sum      ; // sum of the registered values of each pixel
+        std::vector<uint32_t> m_coverage ; // number of frames which covered each pixel after the shift
+
+    } CameraStackImage;
+
+   /*******************************************************************
+    * \struct CameraStackJob
+    * \brief This structure contains a frame queued for the stacking
+    *******************************************************************/
+    typedef struct CameraStackJob
+    {
+        std::vector<uint16_t> m_data          ; // frame pixels
+        std::size_t           m_frame_nb      ; // frame number in the acquisition
+        std::size_t           m_acquisition_nb; // index of the acquisition of the frame
+        bool                  m_reference     ; // true for the reference frame of the acquisition
+
+    } CameraStackJob;
+
+   /*******************************************************************
+    * \struct CameraStackScratch
+    * \brief This structure contains the work buffers of a stacking
+    *        thread (kept between the frames)
+    *******************************************************************/
+    typedef struct CameraStackScratch
+    {
+        std::vector< std::complex<float> > m_spectrum      ; // spectrum of the downsampled frame
+        std::vector< std::complex<float> > m_line          ; // column copy of the 2D transforms
+        std::vector< std::complex<float> > m_frame_spectrum; // spectrum of the complete frame (Fourier interpolation)
+        std::vector<float>                 m_shifted       ; // shifted frame (Fourier interpolation)
+
+    } CameraStackScratch;
+
+/*
+ *  \class CameraFrameStacker
+ *  \brief This class accumulates the frames of an acquisition into a 32 bits stack after the
+ *         correction of their drift. The first stacked frame is the reference. The shift of each
+ *         frame is measured by cross-correlation (radix-2 FFT) of a downsampled copy against the
+ *         reference, with a sub-pixel refinement of the peak. The frame is then shifted
+ *         with a bilinear or a Fourier interpolation and added to the stack.
+ *         The frames are copied into a queue by the acquisition thread and stacked by a small
+ *         pool of threads: the registrations run in parallel, only the accumulation is serialized.
+ *         A frame is dropped when the queue is full, so the reception never waits.
+ */
+class CameraFrameStacker : public CameraSingleton<CameraFrameStacker>, public CameraFrameStage, public CameraFrameWriter
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraFrameStacker", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraFrameStacker>;
+
+public:
+    // interpolation of the shifted frames
+    typedef enum Interpolation
+    {
+        Bilinear, // weighted sum of the four neighbour pixels
+        Fourier , // phase ramp on the spectrum of the complete frame (slower, no smoothing)
+
+    } Interpolation;
+
+    // set the downsampling factor of the registration
+    bool setDownsampling(std::size_t in_factor);
+
+    // get the downsampling factor of the registration
+    std::size_t getDownsampling() const;
+
+    // set the interpolation of the shifted frames
+    void setInterpolation(Interpolation in_interpolation);
+
+    // get the interpolation of the shifted frames
+    Interpolation getInterpolation() const;
+
+    // set the number of stacking threads (not during an acquisition)
+    bool setThreadsNb(std::size_t in_threads_nb);
+
+    // get the number of stacking threads
+    std::size_t getThreadsNb() const;
+
+    // get the counters
+    CameraStackCounters getCounters() const;
+
+    // get the measured shifts of the latest stacked frames
+    void getShifts(std::vector<CameraStackShift> & out_shifts) const;
+
+    // get a copy of the stack
+    void getStack(CameraStackImage & out_stack) const;
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // queue a complete frame for the stacking (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // stack the next queued frame, waits a short delay if the queue is empty (called by the threads)
+    virtual void writeNext();
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraFrameStacker();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraFrameStacker();
+
+    // creates an autolock mutex for the queues access
+    lima::AutoMutex queuesLock() const;
+
+    // creates an autolock mutex for the stack access
+    lima::AutoMutex stackLock() const;
+
+    // register and accumulate a frame
+    void stackJob(const CameraStackJob & in_job, CameraStackScratch & in_out_scratch);
+
+    // compute the windowed spectrum of the downsampled frame
+    void computeSpectrum(const CameraStackJob & in_job, CameraStackScratch & in_out_scratch) const;
+
+    // measure the shift of a spectrum against the reference spectrum
+    void measureShift(CameraStackScratch & in_out_scratch, CameraStackShift & out_shift) const;
+
+    // compute the sub-pixel offset of a correlation peak in a direction
+    static double computePeakOffset(double in_previous, double in_peak, double in_next);
+
+    // shift a frame with a Fourier interpolation
+    void shiftFourier(const CameraStackJob & in_job, double in_shift_x, double in_shift_y, CameraStackScratch & in_out_scratch) const;
+
+    // add a frame shifted with a bilinear interpolation to the stack (the caller must hold the stack lock)
+    void accumulateBilinear(const uint16_t * in_data, double in_shift_x, double in_shift_y);
+
+    // add a frame shifted with a Fourier interpolation to the stack (the caller must hold the stack lock)
+    void accumulateShifted(const float * in_shifted, double in_shift_x, double in_shift_y);
+
+    // compute the range of the destination pixels which have all their source pixels in the frame
+    static void computeValidRange(double           in_shift ,
+                                  std::size_t      in_size  ,
+                                  std::ptrdiff_t & out_begin,
+                                  std::ptrdiff_t & out_end  );
+
+    // in place radix-2 FFT of a line
+    static void transform(std::complex<float> * in_out_data, std::size_t in_size, const std::complex<float> * in_twiddles);
+
+    // in place 2D FFT (rows then columns)
+    static void transform2D(std::complex<float> *                in_out_data,
+                            std::size_t                          in_width   ,
+                            std::size_t                          in_height  ,
+                            bool                                 in_inverse ,
+                            std::vector< std::complex<float> > & in_out_line);
+
+    // compute the roots of unity of a FFT
+    static void computeTwiddles(std::size_t in_size, bool in_inverse, std::vector< std::complex<float> > & out_twiddles);
+
+    // compute the smallest power of two greater or equal to a size
+    static std::size_t computePowerOfTwo(std::size_t in_size);
+
+    // stop and release the threads
+    void releaseThreads();
+
+private:
+    // stacking threads
+    std::vector<CameraWriterThread *> m_threads;
+
+    // downsampling factor of the registration
+    std::size_t m_downsampling;
+
+    // interpolation of the shifted frames
+    Interpolation m_interpolation;
+
+    // number of frame buffers created
+    std::size_t m_created_buffers_nb;
+
+    // index of the current acquisition
+    std::size_t m_acquisition_nb;
+
+    // true if the frames of the current acquisition are stacked
+    bool m_acquisition_opened;
+
+    // true until the reference frame of the acquisition is queued
+    bool m_reference_needed;
+
+    // counters
+    CameraStackCounters m_counters;
+
+    // ring of the measured shifts, indexed by frame number
+    std::vector<CameraStackShift> m_shifts;
+
+    // frame number + 1 of each shift of the ring (0 if the record is empty)
+    std::vector<std::size_t> m_shift_frame_nbs;
+
+    //------------------------------------------------------------------
+    // queues (protected by the queues lock)
+    //------------------------------------------------------------------
+    // queued frames
+    std::deque<CameraStackJob *> m_pending_jobs;
+
+    // free frame buffers
+    std::vector<CameraStackJob *> m_free_jobs;
+
+    // free work buffers (one by thread)
+    std::vector<CameraStackScratch *> m_free_scratches;
+
+    // condition variable used to protect the queues and to wake up the threads
+    mutable lima::Cond m_queues_cond;
+
+    //------------------------------------------------------------------
+    // stack data (protected by the stack lock)
+    //------------------------------------------------------------------
+    std::size_t                        m_stack_acquisition_nb; // index of the stacked acquisition
+    std::size_t                        m_width               ; // frame width in pixels
+    std::size_t                        m_height              ; // frame height in pixels
+    std::size_t                        m_spectrum_width      ; // width of the downsampled spectra (power of two)
+    std::size_t                        m_spectrum_height     ; // height of the downsampled spectra (power of two)
+    std::size_t                        m_stack_downsampling  ; // downsampling factor of the acquisition
+    Interpolation                      m_stack_interpolation ; // interpolation of the acquisition
+    std::vector<uint32_t>              m_stack               ; // sum of the registered values of each pixel
+    std::vector<uint32_t>              m_coverage            ; // number of frames which covered each pixel
+    std::size_t                        m_stacked_frames_nb   ; // number of accumulated frames
+    std::vector< std::complex<float> > m_reference_spectrum  ; // conjugated spectrum of the reference frame
+    bool                               m_reference_ready     ; // true when the reference spectrum is computed
+    std::size_t                        m_busy_threads_nb     ; // number of threads working on a frame of the acquisition
+
+    // condition variable used to protect the stack data
+    mutable lima::Cond m_stack_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // number of frame buffers of the queue
+    static const std::size_t g_buffers_nb;
+
+    // default number of stacking threads
+    static const std::size_t g_default_threads_nb;
+
+    // maximum number of stacking threads
+    static const std::size_t g_max_threads_nb;
+
+    // maximum downsampling factor
+    static const std::size_t g_max_downsampling;
+
+    // default downsampling factor
+    static const std::size_t g_default_downsampling;
+
+    // delay of the waits for a frame or for the reference
+    static const double g_wait_delay_sec;
+
+    // number of records of the shifts ring
+    static const std::size_t g_ring_size;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAFRAMESTACKER_H
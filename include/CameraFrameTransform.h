@@ -0,0 +1,195 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameTransform.h
+ * \brief  header file of the frame orientation transform (flips, rotations and transpositions).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAFRAMETRANSFORM_H
+#define SPECTRALINSTRUMENTCAMERAFRAMETRANSFORM_H
+
+// SYSTEM
+#include <cstdlib>
+#include <cstddef>
+#include <stdint.h>
+#include <string>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+/*
+ *  \class CameraFrameTransform
+ *  \brief This class writes the image parts sent by the camera directly at their oriented
+ *         location in the Lima frame. The rotations and transpositions are done by tiles
+ *         small enough to stay in the L1 cache, with a SSE2 8x8 transposition kernel.
+ *         The source image is the image sent by the camera (row major, serial length columns).
+ */
+class CameraFrameTransform
+{
+public:
+    // orientation values (the rotations are clockwise)
+    typedef enum Orientation
+    {
+        Normal        , // no transform
+        FlipX         , // horizontal mirror (columns are reversed)
+        FlipY         , // vertical mirror (rows are reversed)
+        Rotate180     , // 180 degrees rotation
+        Transpose     , // rows become columns
+        Rotate90      , // 90 degrees clockwise rotation
+        Rotate270     , // 270 degrees clockwise rotation (90 degrees counterclockwise)
+        AntiTranspose , // transpose along the anti-diagonal
+
+    } Orientation;
+
+    // constructor
+    explicit CameraFrameTransform(Orientation in_orientation = Normal);
+
+    // set the orientation
+    void setOrientation(Orientation in_orientation);
+
+    // get the orientation
+    Orientation getOrientation() const;
+
+    // check if the orientation swaps the width and the height
+    bool swapsAxes() const;
+
+    // get the inverse transform
+    CameraFrameTransform inverse() const;
+
+    // compute the destination frame size of a source image
+    void getDestinationSize(std::size_t   in_source_width ,
+                            std::size_t   in_source_height,
+                            std::size_t & out_width       ,
+                            std::size_t & out_height      ) const;
+
+    // compute the destination coordinates of a source pixel
+    void getDestinationCoordinates(std::size_t   in_source_x     ,
+                                   std::size_t   in_source_y     ,
+                                   std::size_t   in_source_width ,
+                                   std::size_t   in_source_height,
+                                   std::size_t & out_x           ,
+                                   std::size_t & out_y           ) const;
+
+    // compute the destination index of a source pixel
+    std::size_t getDestinationIndex(std::size_t in_source_x     ,
+                                    std::size_t in_source_y     ,
+                                    std::size_t in_source_width ,
+                                    std::size_t in_source_height) const;
+
+    // compute the source coordinates of a destination pixel
+    void getSourceCoordinates(std::size_t   in_index        ,
+                              std::size_t   in_source_width ,
+                              std::size_t   in_source_height,
+                              std::size_t & out_x           ,
+                              std::size_t & out_y           ) const;
+
+    // compute the destination rectangle of a source rectangle
+    void transformRect(std::size_t   in_x            ,
+                       std::size_t   in_y            ,
+                       std::size_t   in_width        ,
+                       std::size_t   in_height       ,
+                       std::size_t   in_source_width ,
+                       std::size_t   in_source_height,
+                       std::size_t & out_x           ,
+                       std::size_t & out_y           ,
+                       std::size_t & out_width       ,
+                       std::size_t & out_height      ) const;
+
+    // copy a part of the source image (linear range of pixels) at its oriented location
+    void copyPart(const uint16_t * in_source       ,
+                  std::size_t      in_offset       ,
+                  std::size_t      in_pixels_nb    ,
+                  std::size_t      in_source_width ,
+                  std::size_t      in_source_height,
+                  uint16_t       * out_destination ) const;
+
+    // copy a part of the source image at its oriented location in a larger destination image
+    void copyPart(const uint16_t * in_source            ,
+                  std::size_t      in_offset            ,
+                  std::size_t      in_pixels_nb         ,
+                  std::size_t      in_source_width      ,
+                  std::size_t      in_source_height     ,
+                  uint16_t       * out_destination      ,
+                  std::size_t      in_destination_stride) const;
+
+    // convert an orientation to a string
+    static std::string toString(Orientation in_orientation);
+
+    // convert a string to an orientation
+    static bool fromString(const std::string & in_text, Orientation & out_orientation);
+
+private:
+    // compute the destination index of the source origin and the destination steps of the source axes
+    void computeSteps(std::size_t      in_source_width      ,
+                      std::size_t      in_source_height     ,
+                      std::size_t      in_destination_stride,
+                      std::ptrdiff_t & out_base             ,
+                      std::ptrdiff_t & out_step_x           ,
+                      std::ptrdiff_t & out_step_y           ) const;
+
+    // copy a part of a source row
+    static void copyRowSegment(const uint16_t * in_source ,
+                               std::size_t      in_nb     ,
+                               std::ptrdiff_t   in_start  ,
+                               std::ptrdiff_t   in_step_x ,
+                               uint16_t       * out_destination);
+
+    // copy complete source rows with a transposition (tiles of blocks)
+    static void copyTransposedRows(const uint16_t * in_source       ,
+                                   std::size_t      in_source_width ,
+                                   std::size_t      in_first_row    ,
+                                   std::size_t      in_rows_nb      ,
+                                   std::ptrdiff_t   in_base         ,
+                                   std::ptrdiff_t   in_step_x       ,
+                                   std::ptrdiff_t   in_step_y       ,
+                                   uint16_t       * out_destination );
+
+private:
+    // current orientation
+    Orientation m_orientation;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // tile size in pixels used during the transpositions (64x64 16 bits pixels = 8KB)
+    static const std::size_t g_tile_size;
+
+    // block size in pixels of the transposition kernel
+    static const std::size_t g_block_size;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAFRAMETRANSFORM_H
@@ -0,0 +1,284 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraHdf5Writer.h
+ * \brief  header file of the HDF5/NeXus writer stage.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAHDF5WRITER_H
+#define SPECTRALINSTRUMENTCAMERAHDF5WRITER_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+#include "CameraWriterThread.h"
+#include "ProtectedList.h"
+
+// LIMA
+#include "lima/Debug.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraHdf5Counters
+    * \brief This structure contains the counters of the HDF5 writer
+    *******************************************************************/
+    typedef struct CameraHdf5Counters
+    {
+        uint64_t m_queued_frames_nb ; // number of frames queued for the writing
+        uint64_t m_written_frames_nb; // number of frames written
+        uint64_t m_dropped_frames_nb; // number of frames not written because the queue was full
+        uint64_t m_errors_nb        ; // number of frames not written because of a file error
+        uint64_t m_raw_bytes_nb     ; // number of pixels bytes of the written frames
+        uint64_t m_written_bytes_nb ; // number of chunks bytes written (after the compression)
+
+    } CameraHdf5Counters;
+
+   /*******************************************************************
+    * \struct CameraHdf5Settings
+    * \brief This structure contains the settings of an acquisition,
+    *        used to create the file and its metadata
+    *******************************************************************/
+    typedef struct CameraHdf5Settings
+    {
+        std::string m_path_prefix      ; // directory and prefix of the files
+        std::size_t m_acquisition_nb   ; // index of the acquisition used in the file name
+        std::size_t m_width            ; // frame width in pixels
+        std::size_t m_height           ; // frame height in pixels
+        int         m_compression_level; // deflate level of the chunks (0 for no compression)
+        std::string m_model            ; // camera model
+        std::string m_serial_number    ; // camera serial number
+
+    } CameraHdf5Settings;
+
+   /*******************************************************************
+    * \struct CameraHdf5Job
+    * \brief This structure contains a job of the writer thread
+    *******************************************************************/
+    typedef struct CameraHdf5Job
+    {
+        typedef enum Type
+        {
+            Open , // start of an acquisition
+            Frame, // frame to write
+            Close, // end of an acquisition
+
+        } Type;
+
+        Type                  m_type    ; // kind of job
+        CameraHdf5Settings    m_settings; // settings of the acquisition (Open job)
+        std::vector<uint16_t> m_data    ; // frame pixels (Frame job)
+        std::size_t           m_width   ; // frame width in pixels (Frame job)
+        std::size_t           m_height  ; // frame height in pixels (Frame job)
+        std::size_t           m_frame_nb; // frame number in the acquisition (Frame job)
+        CameraFrameMetadata   m_metadata; // frame metadata (Frame job)
+
+    } CameraHdf5Job;
+
+/*
+ *  \class CameraHdf5Writer
+ *  \brief This class writes the complete frames of an acquisition into a HDF5 file with a
+ *         NeXus layout (/entry/instrument/detector/data, linked in /entry/data).
+ *         The frames dataset is chunked by frame and each frame is written as a complete
+ *         chunk with H5Dwrite_chunk, so the HDF5 filter pipeline and chunk cache are
+ *         bypassed. The chunks can be compressed by the writer thread with deflate (the
+ *         HDF5 deflate filter is declared so the readers decode them). The frame numbers,
+ *         reception times, temperature and exposure time are kept in memory and appended
+ *         to their datasets in batches.
+ *         The HDF5 support is only compiled with the SPECTRAL_CAMERA_ACTIVATE_HDF5_WRITER
+ *         define (libhdf5 and libz are then needed at link time).
+ */
+class CameraHdf5Writer : public CameraSingleton<CameraHdf5Writer>, public CameraFrameStage, public CameraFrameWriter
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraHdf5Writer", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraHdf5Writer>;
+
+public:
+    // check if the HDF5 support was compiled
+    static bool isAvailable();
+
+    // set the directory and prefix of the files
+    void setPathPrefix(const std::string & in_path_prefix);
+
+    // get the directory and prefix of the files
+    std::string getPathPrefix() const;
+
+    // set the deflate level of the chunks (0 for no compression)
+    bool setCompressionLevel(int in_compression_level);
+
+    // get the deflate level of the chunks
+    int getCompressionLevel() const;
+
+    // set the number of frame buffers of the queue
+    bool setBuffersNb(std::size_t in_buffers_nb);
+
+    // get the number of frame buffers of the queue
+    std::size_t getBuffersNb() const;
+
+    // get the counters
+    CameraHdf5Counters getCounters() const;
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // treat a complete frame (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // close the file of the current acquisition (called by the acquisition thread)
+    void endAcq();
+
+    // write the next queued job (called by the writer thread)
+    virtual void writeNext();
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraHdf5Writer();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraHdf5Writer();
+
+    // write a job
+    void writeJob(CameraHdf5Job * in_job);
+
+    // give a frame buffer back to the free list or release a job
+    void releaseJob(CameraHdf5Job * in_job);
+
+    // create the file and its datasets
+    bool openFile(const CameraHdf5Settings & in_settings);
+
+    // write a frame chunk and keep its metadata
+    bool writeFrame(const CameraHdf5Job & in_job);
+
+    // append the kept metadata to their datasets
+    bool flushMetadata();
+
+    // set the final size of the datasets and close the file
+    void closeFile();
+
+private:
+    // directory and prefix of the files
+    std::string m_path_prefix;
+
+    // deflate level of the chunks
+    int m_compression_level;
+
+    // number of frame buffers of the queue
+    std::size_t m_buffers_nb;
+
+    // number of frame buffers created
+    std::size_t m_created_buffers_nb;
+
+    // index of the next acquisition
+    std::size_t m_acquisition_nb;
+
+    // true if the current acquisition is written
+    bool m_acquisition_opened;
+
+    // counters
+    CameraHdf5Counters m_counters;
+
+    // queued jobs
+    ProtectedList<CameraHdf5Job> m_pending_jobs;
+
+    // free frame buffers
+    ProtectedList<CameraHdf5Job> m_free_jobs;
+
+    //------------------------------------------------------------------
+    // writer thread data
+    //------------------------------------------------------------------
+    // settings of the acquisition being written
+    CameraHdf5Settings m_settings;
+
+    // HDF5 identifiers (hid_t) of the file and of the datasets, negative if not opened
+    int64_t m_file;
+    int64_t m_data_set;
+    int64_t m_frame_nb_set;
+    int64_t m_time_set;
+    int64_t m_temperature_set;
+    int64_t m_exposure_set;
+
+    // number of frames written in the file
+    std::size_t m_written_frames_nb;
+
+    // number of frames allocated in the frames dataset
+    std::size_t m_allocated_frames_nb;
+
+    // number of metadata values written in the file
+    std::size_t m_written_metadata_nb;
+
+    // metadata batch
+    std::vector<uint64_t> m_batch_frame_nb   ;
+    std::vector<double>   m_batch_time       ;
+    std::vector<double>   m_batch_temperature;
+    std::vector<double>   m_batch_exposure   ;
+
+    // buffer of a compressed chunk
+    std::vector<uint8_t> m_compressed;
+
+    // writer thread
+    CameraWriterThread * m_thread;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // number of metadata values appended at once (also the metadata chunk size)
+    static const std::size_t g_metadata_batch_size;
+
+    // number of frames added to the frames dataset when it is full
+    static const std::size_t g_extent_step;
+
+    // default number of frame buffers
+    static const std::size_t g_default_buffers_nb;
+
+    // maximum deflate level
+    static const int g_max_compression_level;
+
+    // delay in seconds to wait for a job before checking the end of the thread
+    static const double g_wait_job_delay_sec;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAHDF5WRITER_H
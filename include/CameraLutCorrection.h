@@ -0,0 +1,185 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraLutCorrection.h
+ * \brief  header file of the linearity correction and ADU to electrons conversion stage.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERALUTCORRECTION_H
+#define SPECTRALINSTRUMENTCAMERALUTCORRECTION_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+
+// LIMA
+#include "lima/Debug.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+/*
+ *  \class CameraLutCorrection
+ *  \brief This class converts the raw ADU of the frames into linearized values multiplied by
+ *         the gain (electrons with the gain of the camera), through a 65536 entries table.
+ *         The linearity comes from a polynomial of the raw ADU or from a table file of the
+ *         camera (ADU and linearized value knots, interpolated between the knots).
+ *         The corrected values are written in the frame as scaled 16 bits values, or kept as
+ *         32 bits float frames in a small ring buffer (the Lima frame stays raw).
+ *         With a polynomial, the values are computed with SSE2 without table access, eight
+ *         pixels at once. With a table file, each pixel is a table access.
+ */
+class CameraLutCorrection : public CameraSingleton<CameraLutCorrection>, public CameraFrameStage
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraLutCorrection", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraLutCorrection>;
+
+public:
+    // output of the corrected values
+    typedef enum Output
+    {
+        Scaled16, // corrected values multiplied by the scale, rounded into the 16 bits frame
+        Float32 , // corrected values kept as float frames, the frame is not modified
+
+    } Output;
+
+    // set the linearity polynomial of the raw ADU (1 to 4 coefficients, constant first)
+    bool setPolynomial(const std::vector<double> & in_coefficients);
+
+    // load the linearity table of the camera (one "adu value" knot per line)
+    bool loadTable(const std::string & in_file_name);
+
+    // check if the linearity comes from a table file
+    bool hasTable() const;
+
+    // set the gain applied after the linearity (e-/ADU)
+    bool setGain(double in_gain);
+
+    // get the gain applied after the linearity
+    double getGain() const;
+
+    // set the output of the corrected values
+    void setOutput(Output in_output);
+
+    // get the output of the corrected values
+    Output getOutput() const;
+
+    // set the scale of the 16 bits output
+    bool setScale(double in_scale);
+
+    // get the scale of the 16 bits output
+    double getScale() const;
+
+    // get a copy of a float frame of the current acquisition
+    bool getFloatFrame(std::size_t in_frame_nb, std::vector<float> & out_frame) const;
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // correct a complete frame (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraLutCorrection();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraLutCorrection();
+
+    // build the tables and the polynomial coefficients used by the frames (the caller must hold the stage lock)
+    void buildTables();
+
+    // write the corrected values of a frame into the frame (16 bits output)
+    void correctScaled(uint16_t * in_out_data, std::size_t in_pixels_nb) const;
+
+    // evaluate the polynomial of a pixel in float, with the operations order of the SSE2 path
+    static float evaluatePolynomial(const float * in_coefficients, float in_x);
+
+    // write the corrected values of a frame into a float frame (32 bits output)
+    void correctFloat(const uint16_t * in_data, float * out_data, std::size_t in_pixels_nb) const;
+
+private:
+    // output of the corrected values
+    Output m_output;
+
+    // gain applied after the linearity
+    double m_gain;
+
+    // scale of the 16 bits output
+    double m_scale;
+
+    // linearity polynomial of the raw ADU (constant first)
+    std::vector<double> m_coefficients;
+
+    // linearized value of each raw ADU loaded from a table file (empty with a polynomial)
+    std::vector<float> m_linear_table;
+
+    // polynomial coefficients with the gain (and the scale for the 16 bits output)
+    float m_float_coefficients [4];
+    float m_scaled_coefficients[4];
+
+    // corrected value of each raw ADU
+    std::vector<float>    m_float_table ;
+    std::vector<uint16_t> m_scaled_table;
+
+    // float frames of the acquisition (ring buffer) and their frame numbers
+    std::vector< std::vector<float> > m_float_frames   ;
+    std::vector<std::size_t>          m_float_frame_nbs;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // number of entries of the tables (16 bits raw ADU)
+    static const std::size_t g_table_size;
+
+    // maximum number of polynomial coefficients
+    static const std::size_t g_max_coefficients_nb;
+
+    // number of kept float frames
+    static const std::size_t g_float_ring_size;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERALUTCORRECTION_H
@@ -0,0 +1,248 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraMosaic.h
+ * \brief  header file of the mosaic stage (assembly of several detectors frames in shared memory).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAMOSAIC_H
+#define SPECTRALINSTRUMENTCAMERAMOSAIC_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+#include "CameraFrameTransform.h"
+
+// LIMA
+#include "lima/Debug.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+    class NetImage;
+
+   /*******************************************************************
+    * \struct CameraMosaicHeader
+    * \brief This structure is the header of the mosaic shared memory.
+    *        It is followed by the slots states (one uint64_t by slot:
+    *        acquisition epoch in the high 16 bits, frame number + 1 in
+    *        the next 32 bits, received tiles mask in the low 16 bits),
+    *        then by the slots pixels (16 bits, row major, width x height
+    *        pixels by slot).
+    *******************************************************************/
+    typedef struct CameraMosaicHeader
+    {
+        uint32_t          m_magic              ; // identification of the shared memory
+        uint32_t          m_version            ; // version of the layout
+        uint32_t          m_width              ; // mosaic width in pixels
+        uint32_t          m_height             ; // mosaic height in pixels
+        uint32_t          m_tiles_nb           ; // number of tiles (detectors)
+        uint32_t          m_slots_nb           ; // number of frames in the ring buffer
+        uint64_t          m_states_offset      ; // offset in bytes of the slots states
+        uint64_t          m_data_offset        ; // offset in bytes of the first slot pixels
+        volatile uint64_t m_acquisition        ; // acquisition epoch (high 32 bits) and mask of the tiles which joined it (low 32 bits)
+        volatile uint64_t m_complete_frames_nb ; // number of complete mosaic frames
+        volatile int64_t  m_last_complete_frame; // number of the latest complete mosaic frame (-1 if none)
+
+    } CameraMosaicHeader;
+
+   /*******************************************************************
+    * \struct CameraMosaicTile
+    * \brief This structure describes the location of a detector in the mosaic
+    *******************************************************************/
+    typedef struct CameraMosaicTile
+    {
+        std::size_t                       m_x          ; // left position of the tile in the mosaic
+        std::size_t                       m_y          ; // top position of the tile in the mosaic
+        CameraFrameTransform::Orientation m_orientation; // orientation of the detector image in the mosaic
+
+    } CameraMosaicTile;
+
+/*
+ *  \class CameraMosaic
+ *  \brief This class places the frames of several detectors into one large frame.
+ *         Each detector is driven by its own process (the plugin classes are singletons)
+ *         and the mosaic frames are stored in a POSIX shared memory ring buffer.
+ *         The image parts are copied at their oriented location in the mosaic as soon as
+ *         they are received, so each detector writes its tile in parallel without any
+ *         intermediate frame. The frames of the detectors are synchronized by their
+ *         acquisition frame number (the detectors should share the same trigger).
+ *         The frame numbers restart at 0 with each acquisition, so the slots are also tagged
+ *         with an acquisition epoch kept in the shared memory: the first tile which starts a
+ *         new acquisition opens a new epoch and the other tiles join it.
+ */
+class CameraMosaic : public CameraSingleton<CameraMosaic>, public CameraFrameStage
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraMosaic", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraMosaic>;
+
+public:
+    // load the mosaic geometry from a text file
+    bool loadGeometry(const std::string & in_file_name);
+
+    // set the index of the tile filled by this process
+    bool setTileIndex(std::size_t in_tile_index);
+
+    // get the index of the tile filled by this process
+    std::size_t getTileIndex() const;
+
+    // set the name of the shared memory
+    void setSharedMemoryName(const std::string & in_name);
+
+    // get the name of the shared memory
+    std::string getSharedMemoryName() const;
+
+    // get the mosaic size
+    void getMosaicSize(std::size_t & out_width, std::size_t & out_height) const;
+
+    // get the number of complete mosaic frames and the latest complete frame number
+    bool getCompleteFrames(uint64_t & out_complete_frames_nb, int64_t & out_last_complete_frame) const;
+
+    // get the number of frames of this tile not published because their slot was claimed by a newer frame
+    std::size_t getLateFrames() const;
+
+    // copy a complete mosaic frame
+    bool readFrame(std::size_t in_frame_nb, std::vector<uint16_t> & out_pixels) const;
+
+    // copy an image part into the tile of the mosaic (called by the acquisition thread)
+    bool copyPart(const NetImage & in_image, std::size_t in_frame_nb);
+
+    // prepare the stage for a new acquisition
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // publish the tile of a complete frame (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraMosaic();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraMosaic();
+
+    // map the shared memory and check or initialize its header
+    bool openSharedMemory();
+
+    // unmap the shared memory
+    void closeSharedMemory();
+
+    // join the acquisition epoch of the other tiles or open a new one
+    void joinAcquisition();
+
+    // get the tag of a frame in the slots states (epoch and frame number, without the tiles mask)
+    uint64_t getSlotTag(std::size_t in_frame_nb) const;
+
+    // get the state of a slot
+    volatile uint64_t * getSlotState(std::size_t in_slot) const;
+
+    // get the pixels of a slot
+    uint16_t * getSlotData(std::size_t in_slot) const;
+
+private:
+    // shared memory name
+    std::string m_shm_name;
+
+    // mosaic size in pixels
+    std::size_t m_width ;
+    std::size_t m_height;
+
+    // number of frames in the ring buffer
+    std::size_t m_slots_nb;
+
+    // tiles locations
+    std::vector<CameraMosaicTile> m_tiles;
+
+    // index of the tile filled by this process
+    std::size_t m_tile_index;
+
+    // size of the tile filled by this process (orientation of the tile applied)
+    std::size_t m_tile_width ;
+    std::size_t m_tile_height;
+
+    // latest frame number claimed in the ring buffer (-1 if none)
+    int64_t m_claimed_frame;
+
+    // latest frame number whose slot was claimed by a newer frame (-1 if none)
+    int64_t m_late_frame;
+
+    // number of frames of this tile not published because their slot was claimed by a newer frame
+    std::size_t m_late_frames_nb;
+
+    // acquisition epoch joined by this process
+    uint32_t m_epoch;
+
+    // mapped shared memory (NULL if not mapped)
+    uint8_t * m_shm_data;
+
+    // mapped shared memory size in bytes
+    std::size_t m_shm_size;
+
+    // true if the mosaic is ready for the current acquisition
+    bool m_ready;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // identification of the shared memory
+    static const uint32_t g_magic;
+
+    // version of the shared memory layout
+    static const uint32_t g_version;
+
+    // maximum number of tiles (size of the tiles mask)
+    static const std::size_t g_tiles_max;
+
+    // mask of the tag (epoch and frame number) in a slot state
+    static const uint64_t g_tag_mask;
+
+    // alignment of the shared memory blocks in bytes
+    static const std::size_t g_alignment;
+
+    // default shared memory name
+    static const std::string g_default_shm_name;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAMOSAIC_H
@@ -0,0 +1,186 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraPacketDelayController.h
+ * \brief  header file of the closed-loop controller of the delay between two image packets.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAPACKETDELAYCONTROLLER_H
+#define SPECTRALINSTRUMENTCAMERAPACKETDELAYCONTROLLER_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraPacketDelayMeasures
+    * \brief This structure contains the measures done during the
+    *        reception of a frame
+    *******************************************************************/
+    typedef struct CameraPacketDelayMeasures
+    {
+        std::size_t m_max_queue_bytes  ; // maximum number of bytes waiting in the socket receive queue (SIOCINQ)
+        std::size_t m_receive_buffer   ; // size of the socket receive buffer (SO_RCVBUF)
+        double      m_max_lag_sec      ; // maximum delay between the reception of a part and its treatment
+        double      m_transfer_rate    ; // transfer rate of the frame in bytes per second (0 if unknown)
+
+    } CameraPacketDelayMeasures;
+
+/*
+ *  \class CameraPacketDelayController
+ *  \brief This class adapts the delay between two image packets sent by the camera.
+ *         After each frame, the delay is multiplicatively increased if the socket receive
+ *         queue or the treatment lag went over their limits, else it is additively decreased
+ *         (additive increase, multiplicative decrease of the transfer rate). A decrease is kept
+ *         only if it raises the transfer rate of the next frame: else the camera or the link is
+ *         the limit, so the previous delay is restored and kept during a few frames before the
+ *         next try. The new delay is sent with the ConfigurePackets command between two frames.
+ */
+class CameraPacketDelayController : public CameraSingleton<CameraPacketDelayController>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraPacketDelayController", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraPacketDelayController>;
+
+public:
+    // set the packets settings given at the camera start
+    void setInitialSettings(uint16_t in_pixels_per_packet, uint16_t in_packet_delay_usec);
+
+    // enable or disable the controller
+    void setEnabled(bool in_enabled);
+
+    // check if the controller is enabled
+    bool isEnabled() const;
+
+    // set the delay range in microseconds
+    bool setDelayRange(uint16_t in_min_delay_usec, uint16_t in_max_delay_usec);
+
+    // get the delay range in microseconds
+    void getDelayRange(uint16_t & out_min_delay_usec, uint16_t & out_max_delay_usec) const;
+
+    // set the congestion limits
+    void setLimits(double in_queue_ratio, double in_lag_sec);
+
+    // get the congestion limits
+    void getLimits(double & out_queue_ratio, double & out_lag_sec) const;
+
+    // get the packets settings currently used by the camera
+    void getCurrentSettings(uint16_t & out_pixels_per_packet, uint16_t & out_packet_delay_usec) const;
+
+    // get the latest measures
+    CameraPacketDelayMeasures getLastMeasures() const;
+
+    // compute the delay to use for the next frame
+    bool computeNextDelay(const CameraPacketDelayMeasures & in_measures, uint16_t & out_packet_delay_usec);
+
+    // validate the delay sent to the camera
+    void setCurrentDelay(uint16_t in_packet_delay_usec);
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraPacketDelayController();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraPacketDelayController();
+
+    // creates an autolock mutex for the controller data access
+    lima::AutoMutex controllerLock() const;
+
+private:
+    // true if the delay is adapted during the acquisition
+    bool m_enabled;
+
+    // pixels per packet (constant)
+    uint16_t m_pixels_per_packet;
+
+    // delay given at the camera start
+    uint16_t m_initial_delay_usec;
+
+    // delay currently used by the camera
+    uint16_t m_current_delay_usec;
+
+    // delay range
+    uint16_t m_min_delay_usec;
+    uint16_t m_max_delay_usec;
+
+    // maximum ratio of the socket receive buffer used by the waiting data
+    double m_queue_ratio;
+
+    // maximum delay between the reception of a part and its treatment
+    double m_lag_sec;
+
+    // latest measures
+    CameraPacketDelayMeasures m_last_measures;
+
+    // transfer rate of the frame before the latest decrease of the delay (0 if the latest change was not a decrease)
+    double m_probe_rate;
+
+    // number of frames left before the next decrease of the delay
+    std::size_t m_hold_frames_nb;
+
+    // condition variable used to protect the controller data
+    mutable lima::Cond m_controller_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // additive decrease of the delay in microseconds
+    static const uint16_t g_delay_decrease_usec;
+
+    // minimum increase of the delay in microseconds (the delay can be 0)
+    static const uint16_t g_delay_increase_usec;
+
+    // minimum relative gain of the transfer rate to keep a decrease of the delay
+    static const double g_min_rate_gain;
+
+    // number of frames the delay is kept after a decrease without gain
+    static const std::size_t g_hold_frames_nb;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAPACKETDELAYCONTROLLER_H
@@ -0,0 +1,127 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraParameterTable.h
+ * \brief  header file of the cached camera parameters table.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAPARAMETERTABLE_H
+#define SPECTRALINSTRUMENTCAMERAPARAMETERTABLE_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraParameter
+    * \brief This structure contains a parameter of the camera
+    *        (line "group,name,value,..." of GetCameraParameters)
+    *******************************************************************/
+    typedef struct CameraParameter
+    {
+        std::string m_group; // parameter group
+        std::string m_name ; // parameter name (used by SetSingleParameter)
+        std::string m_value; // current value
+        std::string m_line ; // complete line sent by the camera
+
+    } CameraParameter;
+
+   /*******************************************************************
+    * \struct CameraParameterChange
+    * \brief This structure contains a parameter change of a batch
+    *******************************************************************/
+    typedef struct CameraParameterChange
+    {
+        std::string m_group; // parameter group
+        std::string m_name ; // parameter name
+        uint32_t    m_value; // new value
+
+    } CameraParameterChange;
+
+/*
+ *  \class CameraParameterTable
+ *  \brief This class keeps a copy of the camera parameters table, indexed by group and name.
+ *         The table is filled with the answer of a GetCameraParameters command and the values
+ *         are updated after each accepted SetSingleParameter command.
+ *         The class does not protect the multi-threads access.
+ */
+class CameraParameterTable
+{
+public:
+    // constructor
+    CameraParameterTable();
+
+    // fill the table with the lines of a GetCameraParameters answer
+    bool parse(const std::string & in_lines, const std::string & in_delimiter, std::size_t in_value_position);
+
+    // clear the table
+    void clear();
+
+    // check if the table was filled
+    bool empty() const;
+
+    // get a parameter
+    bool find(const std::string & in_group, const std::string & in_name, CameraParameter & out_parameter) const;
+
+    // get the value of a parameter
+    bool getValue(const std::string & in_group, const std::string & in_name, std::string & out_value) const;
+
+    // change the value of a parameter
+    bool setValue(const std::string & in_group, const std::string & in_name, const std::string & in_value);
+
+    // get all the parameters (in the camera order)
+    const std::vector<CameraParameter> & getParameters() const;
+
+private:
+    // build the index key of a parameter
+    static std::string buildKey(const std::string & in_group, const std::string & in_name);
+
+private:
+    // parameters in the camera order
+    std::vector<CameraParameter> m_parameters;
+
+    // index of the parameters by group and name
+    std::map<std::string, std::size_t> m_index;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAPARAMETERTABLE_H
@@ -0,0 +1,236 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraPhotonTransfer.h
+ * \brief  header file of the photon transfer curve and per pixel noise characterization stage.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAPHOTONTRANSFER_H
+#define SPECTRALINSTRUMENTCAMERAPHOTONTRANSFER_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameProcessing.h"
+#include "CameraWriterThread.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraPhotonTransferStep
+    * \brief This structure contains a point of the photon transfer curve
+    *        (one acquisition of the series, averaged over the pixels)
+    *******************************************************************/
+    typedef struct CameraPhotonTransferStep
+    {
+        double      m_exposure_sec ; // exposure time of the acquisition
+        bool        m_dark         ; // true for a dark acquisition
+        std::size_t m_frames_nb    ; // number of accumulated frames
+        double      m_mean_adu     ; // mean level of the pixels
+        double      m_variance_adu2; // mean temporal variance of the pixels
+
+    } CameraPhotonTransferStep;
+
+   /*******************************************************************
+    * \struct CameraPhotonTransferMaps
+    * \brief This structure contains the per pixel results of a series.
+    *        The pixels without a valid result are set to 0.
+    *******************************************************************/
+    typedef struct CameraPhotonTransferMaps
+    {
+        std::size_t        m_width              ; // maps width in pixels
+        std::size_t        m_height             ; // maps height in pixels
+        std::vector<float> m_gain               ; // conversion gain in e-/ADU (inverse slope of the variance against the level)
+        std::vector<float> m_read_noise         ; // read noise in e- (dark temporal noise converted with the gain)
+        std::vector<float> m_nonlinearity       ; // rms residual of the level against the exposure time, in percent of the mean signal
+        double             m_median_gain        ; // median of the valid gains
+        double             m_median_read_noise  ; // median of the valid read noises
+        double             m_median_nonlinearity; // median of the valid nonlinearities
+        std::size_t        m_valid_pixels_nb    ; // number of pixels with a valid gain
+
+    } CameraPhotonTransferMaps;
+
+/*
+ *  \class CameraPhotonTransfer
+ *  \brief This class characterizes the gain, the read noise and the linearity of each pixel
+ *         during a series of flat and dark acquisitions at several exposure times.
+ *         Each acquisition of the series is a step: the mean and the temporal variance of each
+ *         pixel are accumulated frame by frame with Welford updates, then folded into the least
+ *         squares sums of the photon transfer curve (variance against level) and of the linearity
+ *         (level against exposure time). No frame is stored. The frames can be split in bands of
+ *         pixels treated by a small pool of threads.
+ *         The flat or dark type and the exposure time of a step are read from the camera settings.
+ */
+class CameraPhotonTransfer : public CameraSingleton<CameraPhotonTransfer>, public CameraFrameStage, public CameraFrameWriter
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraPhotonTransfer", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraPhotonTransfer>;
+
+public:
+    // remove the accumulated data and start a new series with the next acquisitions
+    void startSeries();
+
+    // stop the series (the accumulated data are kept)
+    void stopSeries();
+
+    // set the number of threads which help the acquisition thread (0 for none)
+    bool setThreadsNb(std::size_t in_threads_nb);
+
+    // get the number of threads which help the acquisition thread
+    std::size_t getThreadsNb() const;
+
+    // get the points of the photon transfer curve
+    void getSteps(std::vector<CameraPhotonTransferStep> & out_steps) const;
+
+    // compute the per pixel maps of the series
+    bool computeMaps(CameraPhotonTransferMaps & out_maps) const;
+
+    // prepare the stage for a new acquisition (a new step of the series)
+    virtual bool prepareAcq(const CameraFrameFormat & in_format);
+
+    // accumulate a complete frame (called by the acquisition thread)
+    virtual bool process(CameraFrame & in_out_frame);
+
+    // end the current step (called by the acquisition thread)
+    void endAcq();
+
+    // accumulate the next band of the current frame, waits a short delay if there is none (called by the threads)
+    virtual void writeNext();
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraPhotonTransfer();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraPhotonTransfer();
+
+    // creates an autolock mutex for the bands access
+    lima::AutoMutex bandsLock() const;
+
+    // accumulate the pixels of a band into the step data
+    void accumulateBand(std::size_t in_band_index);
+
+    // accumulate pixels into the mean and the variance sums (Welford update with the same count for all the pixels)
+    static void accumulatePixels(const uint16_t * in_data     ,
+                                 float          * in_out_mean ,
+                                 float          * in_out_m2   ,
+                                 std::size_t      in_pixels_nb,
+                                 float            in_inv_count);
+
+    // fold the current step into the series sums (the caller must hold the stage lock)
+    void foldStep();
+
+    // compute the median of the non null values
+    static double computeMedian(const std::vector<float> & in_values);
+
+    // stop and release the threads
+    void releaseThreads();
+
+private:
+    // threads which accumulate the bands with the acquisition thread
+    std::vector<CameraWriterThread *> m_threads;
+
+    // size of the frames of the series (0 before the first step)
+    std::size_t m_width ;
+    std::size_t m_height;
+
+    // points of the photon transfer curve
+    std::vector<CameraPhotonTransferStep> m_steps;
+
+    //------------------------------------------------------------------
+    // current step
+    //------------------------------------------------------------------
+    bool               m_step_running     ; // true if the frames of the acquisition are accumulated
+    bool               m_step_dark        ; // true for a dark acquisition
+    double             m_step_exposure_sec; // exposure time of the acquisition
+    std::size_t        m_step_frames_nb   ; // number of accumulated frames
+    std::vector<float> m_step_mean        ; // running mean of each pixel
+    std::vector<float> m_step_m2          ; // running sum of the squared deviations of each pixel
+
+    //------------------------------------------------------------------
+    // series sums (x: level, y: variance, t: exposure time)
+    //------------------------------------------------------------------
+    std::size_t         m_flat_steps_nb ; // number of folded flat steps
+    double              m_sum_t         ; // sum of the exposure times
+    double              m_sum_tt        ; // sum of the squared exposure times
+    std::vector<double> m_sum_x         ; // sum of the levels of each pixel
+    std::vector<double> m_sum_xx        ; // sum of the squared levels of each pixel
+    std::vector<double> m_sum_y         ; // sum of the variances of each pixel
+    std::vector<double> m_sum_xy        ; // sum of the level and variance products of each pixel
+    std::vector<double> m_sum_tx        ; // sum of the exposure time and level products of each pixel
+    std::size_t         m_dark_steps_nb ; // number of folded dark steps
+    std::vector<float>  m_dark_variance ; // sum of the dark variances of each pixel
+
+    //------------------------------------------------------------------
+    // frame being accumulated by bands
+    //------------------------------------------------------------------
+    const uint16_t * m_frame_data   ; // frame pixels (NULL if no frame is accumulated)
+    std::size_t      m_pixels_nb    ; // number of pixels of the frame
+    float            m_inv_count    ; // inverse of the frames count of the Welford update
+    std::size_t      m_bands_nb     ; // number of bands of the frame
+    std::size_t      m_next_band    ; // next band to accumulate
+    std::size_t      m_done_bands_nb; // number of accumulated bands
+
+    // condition variable used to protect the bands
+    mutable lima::Cond m_bands_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // number of pixels of a band
+    static const std::size_t g_band_pixels_nb;
+
+    // maximum number of threads
+    static const std::size_t g_max_threads_nb;
+
+    // delay of a thread waiting for a row band
+    static const double g_wait_delay_sec;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAPHOTONTRANSFER_H
@@ -0,0 +1,165 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraPresetLibrary.h
+ * \brief  header file of the experiment presets library.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAPRESETLIBRARY_H
+#define SPECTRALINSTRUMENTCAMERAPRESETLIBRARY_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <map>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraControl.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+#include "lima/SizeUtils.h"
+#include "lima/Constants.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraPreset
+    * \brief This structure contains the settings of an experiment preset
+    *******************************************************************/
+    typedef struct CameraPreset
+    {
+        std::string            m_name           ; // preset name (also the file name)
+        CameraHardwareSettings m_hardware       ; // settings sent to the camera
+        int                    m_trigger_mode   ; // lima trigger mode
+        bool                   m_bad_pixel_map  ; // bad pixel map stage enabled
+        bool                   m_change_detector; // frame change detector stage enabled
+        bool                   m_mosaic         ; // mosaic stage enabled
+        bool                   m_fits_writer    ; // FITS writer stage enabled
+        bool                   m_hdf5_writer    ; // HDF5 writer stage enabled
+
+    } CameraPreset;
+
+   /*******************************************************************
+    * \struct CameraPresetLimaSettings
+    * \brief This structure contains the settings of a preset which
+    *        LIMA keeps in its own objects, so they must be applied
+    *        through the LIMA controls (image and acquisition)
+    *******************************************************************/
+    typedef struct CameraPresetLimaSettings
+    {
+        lima::Roi      m_roi         ; // ROI in the frame orientation
+        lima::Bin      m_bin         ; // binning in the frame orientation
+        double         m_exposure_sec; // exposure time in seconds
+        lima::TrigMode m_trigger_mode; // trigger mode
+
+    } CameraPresetLimaSettings;
+
+/*
+ *  \class CameraPresetLibrary
+ *  \brief This class stores the experiment presets in a directory, one text file by preset
+ *         ("key = value" lines, '#' starts a comment line). The names can only contain letters,
+ *         digits, '_' and '-' characters, so they can be used as file names.
+ */
+class CameraPresetLibrary : public CameraSingleton<CameraPresetLibrary>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraPresetLibrary", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraPresetLibrary>;
+
+public:
+    // set the directory of the presets files
+    void setDirectory(const std::string & in_directory);
+
+    // get the directory of the presets files
+    std::string getDirectory() const;
+
+    // write a preset file (an existing preset is replaced)
+    bool save(const CameraPreset & in_preset);
+
+    // read a preset file
+    bool load(const std::string & in_name, CameraPreset & out_preset) const;
+
+    // delete a preset file
+    bool remove(const std::string & in_name);
+
+    // get the names of the stored presets (sorted)
+    bool getNames(std::vector<std::string> & out_names) const;
+
+    // check if a name can be used for a preset
+    static bool isValidName(const std::string & in_name);
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraPresetLibrary();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraPresetLibrary();
+
+    // creates an autolock mutex for the presets files access
+    lima::AutoMutex presetsLock() const;
+
+    // build the file name of a preset
+    std::string buildFileName(const std::string & in_name) const;
+
+    // get a numerical value of a read preset
+    static bool readValue(const std::map<std::string, std::string> & in_values,
+                          const std::string                        & in_key   ,
+                          uint64_t                                 & out_value);
+
+private:
+    // directory of the presets files
+    std::string m_directory;
+
+    // condition variable used to protect the presets files
+    mutable lima::Cond m_presets_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // extension of the presets files
+    static const std::string g_file_extension;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAPRESETLIBRARY_H
@@ -0,0 +1,238 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraRoiCounterTable.h
+ * \brief  header file of the ROI counters computed during the frame assembly.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAROICOUNTERTABLE_H
+#define SPECTRALINSTRUMENTCAMERAROICOUNTERTABLE_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraRowBandNotifier.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraCounterRoi
+    * \brief This structure contains the definition of a counter ROI
+    *        in the frame given to Lima (orientation applied)
+    *******************************************************************/
+    typedef struct CameraCounterRoi
+    {
+        std::size_t          m_x     ; // first column
+        std::size_t          m_y     ; // first row
+        std::size_t          m_width ; // number of columns
+        std::size_t          m_height; // number of rows
+        std::vector<uint8_t> m_mask  ; // empty for a rectangle, else a value by pixel of the rectangle (row major, not null to count the pixel)
+
+    } CameraCounterRoi;
+
+   /*******************************************************************
+    * \struct CameraRoiCounter
+    * \brief This structure contains the counters of a ROI for a frame
+    *******************************************************************/
+    typedef struct CameraRoiCounter
+    {
+        uint64_t m_sum      ; // sum of the pixels values
+        uint32_t m_max      ; // maximum pixel value
+        uint32_t m_pixels_nb; // number of counted pixels (pixels of the ROI inside the frame)
+
+    } CameraRoiCounter;
+
+   /*******************************************************************
+    * \struct CameraRoiFrameCounters
+    * \brief This structure contains the counters of all the ROIs for
+    *        a frame
+    *******************************************************************/
+    typedef struct CameraRoiFrameCounters
+    {
+        std::size_t                   m_frame_nb; // frame number in the acquisition
+        std::vector<CameraRoiCounter> m_counters; // counters in the order of the ROIs definitions
+
+    } CameraRoiFrameCounters;
+
+/*
+ *  \class CameraRoiCounterTable
+ *  \brief This class computes the sum, the maximum and the number of pixels of a few user
+ *         defined ROIs (rectangles or masks) for each frame, like scaler channels. It is a
+ *         listener of the row bands, so the rows are summed just after their copy into the
+ *         frame, while they are still in the cache, and the counters are ready when the last
+ *         image part is received (before the processing stages, bad pixels not corrected).
+ *         The counters of the latest frames are kept in a ring of records indexed by the frame
+ *         number. Each record has a sequence counter (odd during the writing), so the readers
+ *         copy a record without locking and never access the frame buffers.
+ */
+class CameraRoiCounterTable : public CameraSingleton<CameraRoiCounterTable>, public CameraRowBandListener
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraRoiCounterTable", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraRoiCounterTable>;
+
+public:
+    // enable or disable the counters (registration to the row bands notifier)
+    void setEnabled(bool in_enabled);
+
+    // check if the counters are enabled
+    bool isEnabled() const;
+
+    // set the ROIs definitions (not during an acquisition)
+    bool setRois(const std::vector<CameraCounterRoi> & in_rois);
+
+    // get the ROIs definitions
+    void getRois(std::vector<CameraCounterRoi> & out_rois) const;
+
+    // start a new acquisition (the records of the previous acquisitions become invalid)
+    void prepareAcq();
+
+    // get a copy of the counters of a frame of the current acquisition
+    bool getFrameCounters(std::size_t in_frame_nb, CameraRoiFrameCounters & out_counters) const;
+
+    // get a copy of the counters of the last frame of the current acquisition
+    bool getLastFrameCounters(CameraRoiFrameCounters & out_counters) const;
+
+    // get the maximum number of ROIs
+    static std::size_t getMaxRoisNb();
+
+    // sum a band of completed rows into the counters of the frame (called by the acquisition thread)
+    virtual void rowsCompleted(const CameraRowBand & in_band);
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraRoiCounterTable();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraRoiCounterTable();
+
+    // creates an autolock mutex for the table data access
+    lima::AutoMutex tableLock() const;
+
+    // clip the ROIs to a frame size (the caller must hold the lock)
+    void prepareAreas(std::size_t in_width, std::size_t in_height);
+
+    // write the counters of the current frame into the ring (the caller must hold the lock)
+    void publishFrame();
+
+    // add the values of a row segment to a counter
+    static void sumSegment(const uint16_t   * in_data     ,
+                           const uint16_t   * in_mask     ,
+                           std::size_t        in_pixels_nb,
+                           CameraRoiCounter & in_out_counter);
+
+private:
+   /*******************************************************************
+    * \struct Area
+    * \brief This structure contains a ROI clipped to the frame size
+    *******************************************************************/
+    typedef struct Area
+    {
+        std::size_t           m_first_x  ; // first column inside the frame
+        std::size_t           m_end_x    ; // column after the last one inside the frame
+        std::size_t           m_first_y  ; // first row inside the frame
+        std::size_t           m_end_y    ; // row after the last one inside the frame
+        std::vector<uint16_t> m_mask     ; // empty for a rectangle, else 0 or 0xFFFF by pixel of the clipped area
+        uint32_t              m_pixels_nb; // number of counted pixels
+
+    } Area;
+
+    // true if the listener is registered
+    bool m_enabled;
+
+    // ROIs definitions
+    std::vector<CameraCounterRoi> m_rois;
+
+    // ROIs clipped to the frame size
+    std::vector<Area> m_areas;
+
+    // true if the areas match the ROIs and the frame size
+    bool m_areas_valid;
+
+    // frame size of the areas
+    std::size_t m_areas_width ;
+    std::size_t m_areas_height;
+
+    // counters of the frame being received
+    std::vector<CameraRoiCounter> m_accumulators;
+
+    // true while a frame is being received
+    bool m_frame_opened;
+
+    // frame number of the frame being received
+    std::size_t m_frame_nb;
+
+    // condition variable used to protect the table data (not the ring)
+    mutable lima::Cond m_table_cond;
+
+    //------------------------------------------------------------------
+    // ring of records (allocated once, never reallocated)
+    //------------------------------------------------------------------
+    std::vector<uint32_t>         m_sequences      ; // sequence counter of each record (odd during the writing)
+    std::vector<uint64_t>         m_frame_nbs      ; // frame number of each record
+    std::vector<uint32_t>         m_acquisition_nbs; // acquisition index of each record
+    std::vector<uint32_t>         m_rois_nbs       ; // number of ROIs of each record
+    std::vector<CameraRoiCounter> m_counters       ; // counters of each record (maximum number of ROIs by record)
+
+    // index of the current acquisition
+    uint32_t m_acquisition_nb;
+
+    // number of the last published frame plus one (0 if no frame was published in the acquisition)
+    uint64_t m_last_frame_end;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // number of records of the ring
+    static const std::size_t g_ring_size;
+
+    // maximum number of ROIs
+    static const std::size_t g_max_rois_nb;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAROICOUNTERTABLE_H
@@ -0,0 +1,208 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraRowBandNotifier.h
+ * \brief  header file of the progressive row bands notifier.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAROWBANDNOTIFIER_H
+#define SPECTRALINSTRUMENTCAMERAROWBANDNOTIFIER_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+#include <map>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameTransform.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraRowBand
+    * \brief This structure gives access to a band of completed rows
+    *        of the frame being received
+    *******************************************************************/
+    typedef struct CameraRowBand
+    {
+        const uint16_t * m_data     ; // frame pixels (Lima buffer, only the band rows are complete)
+        std::size_t      m_width    ; // frame width in pixels
+        std::size_t      m_height   ; // frame height in pixels
+        std::size_t      m_first_row; // first row of the band
+        std::size_t      m_rows_nb  ; // number of rows of the band
+        std::size_t      m_frame_nb ; // frame number in the acquisition
+        bool             m_last     ; // true for the band which completes the frame
+
+    } CameraRowBand;
+
+/*
+ *  \class CameraRowBandListener
+ *  \brief This class is the base class of the consumers of the row bands.
+ */
+class CameraRowBandListener
+{
+public:
+    // destructor (needs to be virtual)
+    virtual ~CameraRowBandListener() {}
+
+    // treat a band of completed rows (called by the acquisition thread)
+    virtual void rowsCompleted(const CameraRowBand & in_band) = 0;
+};
+
+/*
+ *  \class CameraRowBandNotifier
+ *  \brief This class follows the copy of the image parts into the frame being received and
+ *         gives the bands of completed rows to the listeners, so their treatments overlap with
+ *         the network transfer of the rest of the frame. The rows are completed from the top
+ *         (Normal and FlipX orientations) or from the bottom (FlipY and Rotate180) of the frame.
+ *         The orientations which swap the axes fill a part of each row with each image part,
+ *         so the complete frame is given in one band.
+ *         The bands contain the pixels before the processing stages (bad pixels not corrected).
+ */
+class CameraRowBandNotifier : public CameraSingleton<CameraRowBandNotifier>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraRowBandNotifier", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraRowBandNotifier>;
+
+public:
+    // add a listener (owned by the caller)
+    void addListener(CameraRowBandListener * in_listener);
+
+    // remove a listener
+    void removeListener(CameraRowBandListener * in_listener);
+
+    // check if there is at least one listener
+    bool hasListeners() const;
+
+    // set the minimum number of rows of a band (except the last one)
+    bool setBandRows(std::size_t in_band_rows);
+
+    // get the minimum number of rows of a band
+    std::size_t getBandRows() const;
+
+    // get the number of bands given to the listeners since the creation
+    uint64_t getBandsNb() const;
+
+    // start the reception of a frame (called by the acquisition thread)
+    void startFrame(const uint16_t             * in_data     ,
+                    std::size_t                  in_width    ,
+                    std::size_t                  in_height   ,
+                    std::size_t                  in_frame_nb ,
+                    const CameraFrameTransform & in_transform);
+
+    // declare a copied image part (called by the acquisition thread)
+    void addPart(std::size_t in_offset, std::size_t in_pixels_nb);
+
+    // give the last rows of a completely received frame (called by the acquisition thread)
+    void endFrame();
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraRowBandNotifier();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraRowBandNotifier();
+
+    // creates an autolock mutex for the notifier data access
+    lima::AutoMutex notifierLock() const;
+
+    // compute the number of completed rows of the oriented frame
+    std::size_t computeCompletedRows() const;
+
+    // give the completed rows which were not yet given to the listeners
+    void notifyRows(std::size_t in_completed_rows);
+
+private:
+    // listeners
+    std::vector<CameraRowBandListener *> m_listeners;
+
+    // minimum number of rows of a band
+    std::size_t m_band_rows;
+
+    // number of bands given to the listeners
+    uint64_t m_bands_nb;
+
+    //------------------------------------------------------------------
+    // frame being received
+    //------------------------------------------------------------------
+    // frame pixels (NULL if no frame is followed)
+    const uint16_t * m_data;
+
+    // frame size (orientation applied)
+    std::size_t m_width ;
+    std::size_t m_height;
+
+    // image size sent by the camera
+    std::size_t m_source_width ;
+    std::size_t m_source_height;
+
+    // frame number in the acquisition
+    std::size_t m_frame_nb;
+
+    // orientation applied during the copy
+    CameraFrameTransform::Orientation m_orientation;
+
+    // number of source pixels copied from the start of the image without gap
+    std::size_t m_contiguous_pixels;
+
+    // image parts received after a gap (offset to end offset)
+    std::map<std::size_t, std::size_t> m_pending_parts;
+
+    // number of completed rows already given to the listeners
+    std::size_t m_notified_rows;
+
+    // condition variable used to protect the notifier data
+    mutable lima::Cond m_notifier_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // default minimum number of rows of a band
+    static const std::size_t g_default_band_rows;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAROWBANDNOTIFIER_H
@@ -0,0 +1,243 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraSoakMonitor.h
+ * \brief  header file of the long-running resources and latencies monitor.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERASOAKMONITOR_H
+#define SPECTRALINSTRUMENTCAMERASOAKMONITOR_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \enum CameraSoakSeries
+    * \brief Values sampled by the soak monitor
+    *******************************************************************/
+    typedef enum CameraSoakSeries
+    {
+        SoakResidentMemory , // resident memory of the process in bytes
+        SoakLivePackets    , // network packets not yet released
+        SoakPendingPackets , // received packets waiting for a consumer
+        SoakReceiveQueue   , // bytes waiting in the socket receive queue
+        SoakCommandLatency , // mean duration of the data updates (status and settings commands)
+        SoakFramePeriod    , // mean period of the completed frames
+        SoakSeriesNb       ,
+
+    } CameraSoakSeries;
+
+   /*******************************************************************
+    * \struct CameraSoakSample
+    * \brief This structure contains the values of a sample
+    *******************************************************************/
+    typedef struct CameraSoakSample
+    {
+        double m_time_sec              ; // time since the start of the monitoring
+        double m_values[SoakSeriesNb]  ; // sampled values (0 for a latency without measure)
+        double m_created_packets       ; // network packets created since the start of the process
+
+    } CameraSoakSample;
+
+   /*******************************************************************
+    * \struct CameraSoakDrift
+    * \brief This structure contains the analysis of a series
+    *******************************************************************/
+    typedef struct CameraSoakDrift
+    {
+        CameraSoakSeries m_series        ; // analysed series
+        std::size_t      m_samples_nb    ; // number of used samples
+        double           m_start_value   ; // mean of the first quarter of the samples
+        double           m_end_value     ; // mean of the last quarter of the samples
+        double           m_slope_per_hour; // least squares slope
+        double           m_rising_ratio  ; // ratio of the steps which do not decrease
+        bool             m_flagged       ; // growth or drift detected
+
+    } CameraSoakDrift;
+
+/*
+ *  \class CameraSoakMonitor
+ *  \brief This class samples the resources and latencies of the plugin during long runs
+ *         (resident memory, live and pending packets, socket backlog, data update duration,
+ *         frame period) and flags the monotonic growths and the latency drifts.
+ *         The samples are taken by the data update thread. When the samples buffer is full,
+ *         one sample out of two is removed and the sampling interval is doubled, so hours of
+ *         run are kept with a bounded memory.
+ */
+class CameraSoakMonitor : public CameraSingleton<CameraSoakMonitor>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraSoakMonitor", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraSoakMonitor>;
+
+public:
+    // enable or disable the sampling (the samples are kept)
+    void setEnabled(bool in_enabled);
+
+    // check if the sampling is enabled
+    bool isEnabled() const;
+
+    // remove the samples and restart the monitoring time
+    void reset();
+
+    // set the interval between two samples
+    bool setSampleIntervalSec(double in_interval_sec);
+
+    // get the interval between two samples
+    double getSampleIntervalSec() const;
+
+    // set the detection thresholds
+    bool setThresholds(double in_growth_ratio, double in_drift_ratio);
+
+    // get the detection thresholds
+    void getThresholds(double & out_growth_ratio, double & out_drift_ratio) const;
+
+    // add the duration of a data update (called by the data update thread)
+    void addCommandLatency(double in_duration_sec);
+
+    // add the end time of a completed frame (called by the acquisition thread)
+    void addFrame(std::size_t in_frame_nb, double in_time_sec);
+
+    // take a sample if the interval is elapsed (called by the data update thread)
+    void sample();
+
+    // get a copy of the samples
+    void getSamples(std::vector<CameraSoakSample> & out_samples) const;
+
+    // analyse the series, returns true if a growth or a drift is detected
+    bool analyze(std::vector<CameraSoakDrift> & out_drifts) const;
+
+    // write the samples into a CSV file
+    bool writeSamples(const std::string & in_file_name) const;
+
+    // get the name of a series
+    static const char * getSeriesName(CameraSoakSeries in_series);
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraSoakMonitor();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraSoakMonitor();
+
+    // creates an autolock mutex for the monitor data access
+    lima::AutoMutex monitorLock() const;
+
+    // analyse a series (the caller must hold the lock)
+    void analyzeSeries(CameraSoakSeries in_series, CameraSoakDrift & out_drift) const;
+
+    // read the resident memory of the process
+    static double readResidentMemory();
+
+    // get the monotonic time in seconds
+    static double getMonotonicTimeSec();
+
+private:
+    // true if the sampling is enabled
+    bool m_enabled;
+
+    // requested interval between two samples
+    double m_sample_interval_sec;
+
+    // current interval (doubled at each decimation of the samples)
+    double m_current_interval_sec;
+
+    // relative growth of a resource needed to flag it
+    double m_growth_ratio;
+
+    // relative increase of a latency needed to flag it
+    double m_drift_ratio;
+
+    // start of the monitoring (monotonic time)
+    double m_start_time_sec;
+
+    // time of the latest sample (monotonic time, 0 if none)
+    double m_last_sample_sec;
+
+    // samples
+    std::vector<CameraSoakSample> m_samples;
+
+    // data update durations since the previous sample
+    double      m_latency_sum_sec;
+    std::size_t m_latencies_nb   ;
+
+    // frame periods since the previous sample
+    double      m_period_sum_sec;
+    std::size_t m_periods_nb    ;
+
+    // end time of the previous frame (0 if none)
+    double m_last_frame_sec;
+
+    // condition variable used to protect the monitor data
+    mutable lima::Cond m_monitor_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // maximum number of kept samples
+    static const std::size_t g_max_samples_nb;
+
+    // minimum number of samples needed by the analysis
+    static const std::size_t g_min_samples_nb;
+
+    // minimum ratio of the steps which do not decrease to flag a growth
+    static const double g_monotonic_ratio;
+
+    // default interval between two samples
+    static const double g_default_interval_sec;
+
+    // default detection thresholds
+    static const double g_default_growth_ratio;
+    static const double g_default_drift_ratio ;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERASOAKMONITOR_H
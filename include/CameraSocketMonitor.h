@@ -0,0 +1,157 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraSocketMonitor.h
+ * \brief  header file of the socket backlog and reception lag monitor.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERASOCKETMONITOR_H
+#define SPECTRALINSTRUMENTCAMERASOCKETMONITOR_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraSocketGauges
+    * \brief This structure contains the latest values of the socket
+    *        and reception measures
+    *******************************************************************/
+    typedef struct CameraSocketGauges
+    {
+        uint64_t m_samples_nb             ; // number of periodic samples
+        uint64_t m_parts_nb               ; // number of sampled image parts
+        uint64_t m_receive_queue_bytes    ; // bytes waiting in the socket receive queue (SIOCINQ)
+        uint64_t m_max_receive_queue_bytes; // maximum bytes waiting in the socket receive queue
+        uint64_t m_receive_buffer_bytes   ; // size of the socket receive buffer (SO_RCVBUF)
+        double   m_receive_buffer_usage   ; // used ratio of the socket receive buffer
+        uint32_t m_rtt_usec               ; // smoothed round trip time (TCP_INFO)
+        uint32_t m_rtt_var_usec           ; // round trip time variation (TCP_INFO)
+        uint32_t m_retransmits            ; // current number of retransmissions (TCP_INFO)
+        uint32_t m_total_retransmits      ; // total number of retransmissions (TCP_INFO)
+        double   m_decode_lag_sec         ; // delay between the reception and the treatment of the latest part
+        double   m_max_decode_lag_sec     ; // maximum delay between the reception and the treatment of a part
+
+    } CameraSocketGauges;
+
+   /*******************************************************************
+    * \struct CameraSocketHistograms
+    * \brief This structure contains the log2 histograms of the socket
+    *        and reception measures. The bin 0 counts the null values,
+    *        the bin i counts the values in [2^(i-1), 2^i[, the last bin
+    *        also counts the greater values.
+    *******************************************************************/
+    typedef struct CameraSocketHistograms
+    {
+        static const std::size_t g_bins_nb = 32; // number of bins of each histogram
+
+        uint64_t m_receive_queue_bytes[g_bins_nb]; // bytes waiting in the socket receive queue
+        uint64_t m_rtt_usec           [g_bins_nb]; // smoothed round trip time in microseconds
+        uint64_t m_decode_lag_usec    [g_bins_nb]; // delay between the reception and the treatment of a part in microseconds
+
+    } CameraSocketHistograms;
+
+/*
+ *  \class CameraSocketMonitor
+ *  \brief This class samples the state of the socket (receive queue, receive buffer, TCP_INFO)
+ *         periodically and the delay between the kernel reception of the image parts and their
+ *         treatment by the acquisition thread (one part out of 16 and the last part of each
+ *         frame). It helps to find if a slow acquisition comes from the camera server or from
+ *         the reception side.
+ */
+class CameraSocketMonitor : public CameraSingleton<CameraSocketMonitor>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraSocketMonitor", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraSocketMonitor>;
+
+public:
+    // sample the socket state (called periodically by the data update thread)
+    void sampleSocket();
+
+    // add the measures of a treated image part (called by the acquisition thread)
+    void addPart(std::size_t in_receive_queue_bytes, double in_decode_lag_sec);
+
+    // reset the gauges and the histograms
+    void reset();
+
+    // get the latest values
+    CameraSocketGauges getGauges() const;
+
+    // get the histograms
+    CameraSocketHistograms getHistograms() const;
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraSocketMonitor();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraSocketMonitor();
+
+    // creates an autolock mutex for the monitor data access
+    lima::AutoMutex monitorLock() const;
+
+    // add a value into a log2 histogram
+    static void addToHistogram(uint64_t * in_out_histogram, uint64_t in_value);
+
+    // update the receive queue gauges
+    void updateReceiveQueue(std::size_t in_receive_queue_bytes);
+
+private:
+    // latest values
+    CameraSocketGauges m_gauges;
+
+    // histograms
+    CameraSocketHistograms m_histograms;
+
+    // condition variable used to protect the monitor data
+    mutable lima::Cond m_monitor_cond;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERASOCKETMONITOR_H
@@ -0,0 +1,229 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraThroughputProfiles.h
+ * \brief  header file of the throughput profiles.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERATHROUGHPUTPROFILES_H
+#define SPECTRALINSTRUMENTCAMERATHROUGHPUTPROFILES_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+#include "CameraFrameMetadataTable.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraReadoutCandidate
+    * \brief This structure contains a readout speed which can be
+    *        chosen by the profiles, with its measured readout time
+    *******************************************************************/
+    typedef struct CameraReadoutCandidate
+    {
+        uint32_t m_readout_speed ; // readout speed (DSI sample time) setting
+        double   m_read_noise    ; // declared read noise in electrons (0 if unknown)
+        double   m_pixel_time_sec; // measured readout time of an output pixel (0 if not measured)
+        uint64_t m_measures_nb   ; // number of frames used for the measure
+
+    } CameraReadoutCandidate;
+
+   /*******************************************************************
+    * \struct CameraPacketSettings
+    * \brief This structure contains the settings of the image packets
+    *******************************************************************/
+    typedef struct CameraPacketSettings
+    {
+        uint16_t m_pixels_per_packet; // pixels per packet
+        uint16_t m_packet_delay_usec; // packet sending loop delay in microseconds
+
+    } CameraPacketSettings;
+
+   /*******************************************************************
+    * \struct CameraThroughputChoice
+    * \brief This structure contains the settings chosen by a profile
+    *******************************************************************/
+    typedef struct CameraThroughputChoice
+    {
+        uint32_t             m_readout_speed       ; // readout speed (DSI sample time) setting
+        std::size_t          m_binning             ; // binning (same value for the two axis)
+        CameraPacketSettings m_packets             ; // image packets settings
+        double               m_predicted_frame_rate; // predicted frames per second (0 if the readout was not measured)
+        double               m_read_noise          ; // declared read noise in electrons (0 if unknown)
+
+    } CameraThroughputChoice;
+
+/*
+ *  \class CameraThroughputProfiles
+ *  \brief This class chooses the readout speed, binning and packets settings of named profiles.
+ *         The readout time of an output pixel is measured for each readout speed with the
+ *         metadata of the completed frames (acquire command to acquisition end, minus the
+ *         exposure time) and the transfer time of a byte with the image parts reception.
+ *         The frame period of a settings combination is predicted with these measures, the
+ *         exposure time and the ROI size. The read noise of each readout speed can be declared
+ *         (a slower sampling is considered quieter when the noise is unknown).
+ */
+class CameraThroughputProfiles : public CameraSingleton<CameraThroughputProfiles>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraThroughputProfiles", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraThroughputProfiles>;
+
+public:
+    typedef enum Profile
+    {
+        MaximumFrameRate, // fastest readout, largest allowed binning and fast packets
+        MinimumNoise    , // quietest readout, no binning and quiet packets
+        TargetFrameRate , // quietest combination which reaches the target frame rate
+        NoiseBudget     , // fastest combination which respects the read noise budget
+
+    } Profile;
+
+    // declare a readout speed with its read noise (0 if unknown)
+    void setCandidate(uint32_t in_readout_speed, double in_read_noise);
+
+    // remove all the readout speeds and their measures
+    void clearCandidates();
+
+    // get the readout speeds and their measures
+    std::vector<CameraReadoutCandidate> getCandidates() const;
+
+    // set the target frame rate of the TargetFrameRate profile
+    bool setTargetFrameRate(double in_frame_rate);
+
+    // get the target frame rate of the TargetFrameRate profile
+    double getTargetFrameRate() const;
+
+    // set the read noise budget of the NoiseBudget profile
+    bool setNoiseBudget(double in_read_noise);
+
+    // get the read noise budget of the NoiseBudget profile
+    double getNoiseBudget() const;
+
+    // set the maximum binning the profiles can choose
+    bool setMaxBinning(std::size_t in_max_binning);
+
+    // get the maximum binning the profiles can choose
+    std::size_t getMaxBinning() const;
+
+    // set the packets settings of the frame rate and noise profiles
+    void setPacketSettings(const CameraPacketSettings & in_fast, const CameraPacketSettings & in_quiet);
+
+    // get the packets settings of the frame rate and noise profiles
+    void getPacketSettings(CameraPacketSettings & out_fast, CameraPacketSettings & out_quiet) const;
+
+    // get the measured transfer time of a byte
+    double getByteTimeSec() const;
+
+    // add the measures of a completed frame (called by the acquisition thread)
+    void addFrame(const CameraFrameMetadata & in_metadata);
+
+    // choose the settings of a profile
+    bool choose(Profile                  in_profile     ,
+                double                   in_exposure_sec,
+                std::size_t              in_width       ,
+                std::size_t              in_height      ,
+                CameraThroughputChoice & out_choice     ) const;
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraThroughputProfiles();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraThroughputProfiles();
+
+    // creates an autolock mutex for the profiles data access
+    lima::AutoMutex profilesLock() const;
+
+    // search a readout speed (NULL if not found)
+    CameraReadoutCandidate * searchCandidate(uint32_t in_readout_speed);
+
+    // predict the frame rate of a readout speed and binning (0 if the readout was not measured)
+    double predictFrameRate(const CameraReadoutCandidate & in_candidate,
+                            std::size_t                    in_binning  ,
+                            double                         in_exposure_sec,
+                            std::size_t                    in_width    ,
+                            std::size_t                    in_height   ) const;
+
+    // check if a readout speed is quieter than an other one
+    static bool isQuieter(const CameraReadoutCandidate & in_first, const CameraReadoutCandidate & in_second);
+
+private:
+    // readout speeds which can be chosen
+    std::vector<CameraReadoutCandidate> m_candidates;
+
+    // measured transfer time of a byte (0 if not measured)
+    double m_byte_time_sec;
+
+    // target frame rate of the TargetFrameRate profile
+    double m_target_frame_rate;
+
+    // read noise budget of the NoiseBudget profile
+    double m_noise_budget;
+
+    // maximum binning the profiles can choose
+    std::size_t m_max_binning;
+
+    // packets settings of the frame rate profiles
+    CameraPacketSettings m_fast_packets;
+
+    // packets settings of the noise profiles
+    CameraPacketSettings m_quiet_packets;
+
+    // condition variable used to protect the profiles data
+    mutable lima::Cond m_profiles_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // weight of a new measure in the readout and transfer times averages
+    static const double g_measure_weight;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERATHROUGHPUTPROFILES_H
@@ -0,0 +1,152 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraTransferStatistics.h
+ * \brief  header file of the frames reception times and transfer rate statistics.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERATRANSFERSTATISTICS_H
+#define SPECTRALINSTRUMENTCAMERATRANSFERSTATISTICS_H
+
+// SYSTEM
+#include <cstdlib>
+#include <stdint.h>
+#include <vector>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+#include "CameraSingleton.h"
+
+// LIMA
+#include "lima/Debug.h"
+#include "lima/ThreadUtils.h"
+
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+   /*******************************************************************
+    * \struct CameraFrameReceptionTimes
+    * \brief This structure contains the reception times of a frame
+    *        (seconds since the epoch, given by the kernel when possible)
+    *******************************************************************/
+    typedef struct CameraFrameReceptionTimes
+    {
+        double   m_first_part_time; // reception time of the first image part header
+        double   m_last_part_time ; // reception time of the last image part data
+        uint64_t m_bytes_nb       ; // number of pixels bytes received for the frame
+
+    } CameraFrameReceptionTimes;
+
+   /*******************************************************************
+    * \struct CameraTransferCounters
+    * \brief This structure contains the transfer rate statistics of the
+    *        current acquisition (rates in bytes per second)
+    *******************************************************************/
+    typedef struct CameraTransferCounters
+    {
+        uint64_t m_frames_nb        ; // number of received frames
+        uint64_t m_bytes_nb         ; // number of received pixels bytes
+        double   m_transfer_duration; // sum of the frames transfer durations in seconds
+        double   m_last_rate        ; // transfer rate of the latest frame
+        double   m_min_rate         ; // minimum frame transfer rate
+        double   m_max_rate         ; // maximum frame transfer rate
+        double   m_mean_rate        ; // received bytes divided by the transfer duration
+        bool     m_kernel_timestamps; // true if the times are given by the kernel
+
+    } CameraTransferCounters;
+
+/*
+ *  \class CameraTransferStatistics
+ *  \brief This class keeps the reception times of the frames and computes the transfer
+ *         rate statistics. The times are the kernel reception times of the image parts
+ *         (SO_TIMESTAMPNS), so the statistics do not depend on the scheduling of the
+ *         reception and acquisition threads.
+ */
+class CameraTransferStatistics : public CameraSingleton<CameraTransferStatistics>
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraTransferStatistics", "SpectralInstrument");
+
+    // we need to gain access to the destructor for the management of our singleton
+    friend class CameraSingleton<CameraTransferStatistics>;
+
+public:
+    // reset the statistics for a new acquisition
+    void prepareAcq(std::size_t in_nb_frames, bool in_kernel_timestamps);
+
+    // add the reception times of a complete frame (called by the acquisition thread)
+    void addFrame(std::size_t in_frame_nb, const CameraFrameReceptionTimes & in_times);
+
+    // get the reception times of a frame of the current acquisition
+    bool getFrameReceptionTimes(std::size_t in_frame_nb, CameraFrameReceptionTimes & out_times) const;
+
+    // get the transfer rate statistics of the current acquisition
+    CameraTransferCounters getCounters() const;
+
+    // Create the singleton instance
+    static void create();
+
+private:
+    // constructor
+    CameraTransferStatistics();
+
+    // destructor (needs to be virtual)
+    virtual ~CameraTransferStatistics();
+
+    // creates an autolock mutex for the statistics access
+    lima::AutoMutex statisticsLock() const;
+
+private:
+    // reception times of each frame (used as a ring buffer in continuous acquisition)
+    std::vector<CameraFrameReceptionTimes> m_frames_times;
+
+    // true if a frame has reception times (same indexes than m_frames_times)
+    std::vector<uint8_t> m_frames_valid;
+
+    // number of frames of the acquisition (0 for a continuous acquisition)
+    std::size_t m_nb_frames;
+
+    // transfer rate statistics
+    CameraTransferCounters m_counters;
+
+    // condition variable used to protect the statistics
+    mutable lima::Cond m_statistics_cond;
+
+    //------------------------------------------------------------------
+    // constants
+    //------------------------------------------------------------------
+    // size of the times ring buffer used in continuous acquisition
+    static const std::size_t g_times_ring_size;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERATRANSFERSTATISTICS_H
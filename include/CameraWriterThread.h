@@ -0,0 +1,135 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraWriterThread.h
+ * \brief  header file of the thread used to write the frames into files.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTCAMERAWRITERTHREAD_H_
+#define SPECTRALINSTRUMENTCAMERAWRITERTHREAD_H_
+
+// SYSTEM
+#include <string>
+
+// PROJECT
+#include "SpectralInstrumentCompatibility.h"
+
+// LIMA
+#include "lima/Exceptions.h"
+#include "lima/Debug.h"
+#include "lima/Constants.h"
+#include "lima/ThreadUtils.h"
+
+/*************************************************************************/
+/*
+ *  \namespace lima
+ */
+namespace lima
+{
+/*
+ *  \namespace SpectralInstrument
+ */
+namespace SpectralInstrument
+{
+/*
+ *  \class CameraFrameWriter
+ *  \brief This class is the base class of the file writers. The frames are queued by the
+ *         acquisition thread and written by a CameraWriterThread, so a slow storage never
+ *         stalls the reception.
+ */
+class CameraFrameWriter
+{
+public:
+    // destructor (needs to be virtual)
+    virtual ~CameraFrameWriter() {}
+
+    // write the next queued job, waits a short delay if the queue is empty (called by the writer thread)
+    virtual void writeNext() = 0;
+};
+
+/*
+ *  \class CameraWriterThread
+ *  \brief This class is used to write the queued frames of a writer in background
+ */
+class CameraWriterThread : public CmdThread
+{
+    DEB_CLASS_NAMESPC(DebModCamera, "CameraWriterThread", "SpectralInstrument");
+
+public:
+	// Status
+    enum
+	{
+		Idle    = MaxThreadStatus, // ready to write
+        Running                  , // writing is running
+        Error                    , // unexpected error
+	};
+
+    // Cmd
+    enum
+    {
+        StartWriting = MaxThreadCmd, // command used to start the writing
+    };
+
+    // constructor
+    explicit CameraWriterThread(CameraFrameWriter * in_writer);
+
+    // destructor
+    virtual ~CameraWriterThread();
+
+    // starts the thread
+    virtual void start();
+
+    // aborts the thread
+    virtual void abort();
+
+    // Starts the writing
+    void startWriting();
+
+    // Stops the writing and aborts the thread
+    void stopWriting();
+
+protected:
+    // inits the thread
+    virtual void init();
+
+    // command execution
+    virtual void execCmd(int cmd);
+
+private:
+    // execute the StartWriting command
+    void execStartWriting();
+
+private :
+    // writer which owns the thread
+    CameraFrameWriter * m_writer;
+
+    volatile bool m_force_stop;
+};
+
+} // namespace SpectralInstrument
+} // namespace lima
+
+#endif // SPECTRALINSTRUMENTCAMERAWRITERTHREAD_H_
+
+/*************************************************************************/
@@ -41,6 +41,7 @@
 
 // PROJECT
 #include "SpectralInstrumentCompatibility.h"
+#include "CameraFrameTransform.h"
 
 /*
  *  \namespace lima
@@ -65,6 +66,21 @@ public:
     // constructor
     NetGenericHeader();
 
+    // copy constructor
+    NetGenericHeader(const NetGenericHeader & in_packet);
+
+    // copy assignment (the instances counters are not changed)
+    NetGenericHeader & operator=(const NetGenericHeader & in_packet);
+
+    // destructor (needs to be virtual, the packets are released through this class)
+    virtual ~NetGenericHeader();
+
+    // get the number of packets which are not yet released
+    static uint64_t getLiveInstancesNb();
+
+    // get the number of packets created since the start
+    static uint64_t getCreatedInstancesNb();
+
     // check if this is a command packet
     bool isCommandPacket() const;
 
@@ -131,6 +147,10 @@ protected:
     static const uint8_t g_packet_identifier_for_acknowledge; // to set Packet identifier
     static const uint8_t g_packet_identifier_for_data       ; // to set Packet identifier
     static const uint8_t g_packet_identifier_for_image      ; // to set Packet identifier
+
+private:
+    static volatile uint64_t g_created_instances_nb ; // packets created since the start
+    static volatile uint64_t g_released_instances_nb; // packets released since the start
 };
 
 //------------------------------------------------------------
@@ -548,6 +568,7 @@ protected:
 class NetCommandRetrieveImage : public NetCommandHeader
 {
     friend class CameraControl;    
+    friend class CameraDecodePool;
     friend class NetImage;
 
     // image transfert type values
@@ -1326,6 +1347,7 @@ class NetImageHeader : public NetGenericHeader
 {
     friend class CameraControl   ;
     friend class CameraAcqThread ;
+    friend class CameraDecodePool;
     friend class NetPacketsGroups;
 
 public:
@@ -1384,6 +1406,7 @@ protected:
 class NetImage : public NetImageHeader
 {
     friend class CameraControl   ;
+    friend class CameraDecodePool;
     friend class NetPacketsGroups;
 
 public:
@@ -1405,8 +1428,17 @@ public:
     // log the class content
     virtual void log() const;
 
-    // copy the image part into a destination buffer
-    bool copy(void * in_out_buffer, lima::FrameDim & in_buffer_dim) const;
+    // convert the received pixels from the network byte order (done once, before the copies)
+    void convert();
+
+    // move the header and the pixels into another image part (this part keeps no pixel)
+    void moveTo(NetImage & out_image);
+
+    // copy the image part at its oriented location into a destination buffer
+    bool copy(void * in_out_buffer, lima::FrameDim & in_buffer_dim, const CameraFrameTransform & in_transform) const;
+
+    // copy the image part at its oriented location into a larger destination buffer (mosaic tile)
+    bool copy(void * in_out_buffer, std::size_t in_buffer_stride, lima::FrameDim & in_buffer_dim, const CameraFrameTransform & in_transform) const;
 
     //-----------------------
     // recursive methods
@@ -1423,8 +1455,14 @@ public:
     // totally log the classes content (recursive)
     virtual void totalLog() const;
 
+public:
+    // reception times in seconds since the epoch (not transmitted, filled during the reception)
+    double m_header_reception_time; // reception of the packet header
+    double m_data_reception_time  ; // reception of the last image data
+
 protected:
-    std::vector<uint16_t> m_image; // 16 bits image part
+    std::vector<uint16_t> m_image     ; // 16 bits image part
+    bool                  m_host_order; // false until the pixels are converted from the network byte order
 };
 
 class NetCommandSetCoolingValue : public NetCommandHeader
@@ -88,10 +88,13 @@ public:
     ProtectedList<NetGenericHeader> * searchGroup(NetPacketsGroupId in_group_id);
 
     // set the timeout delay in seconds for all the groups
-    void setDelayBeforeTimeoutSec(int in_wait_packet_timeout_sec);
+    void setDelayBeforeTimeoutSec(double in_wait_packet_timeout_sec);
 
     // set the timeout delay in seconds for a specific group
-    void setDelayBeforeTimeoutSec(NetPacketsGroupId in_group_id, int in_wait_packet_timeout_sec);
+    void setDelayBeforeTimeoutSec(NetPacketsGroupId in_group_id, double in_wait_packet_timeout_sec);
+
+    // get the number of packets waiting in all the groups
+    std::size_t getPacketsNb() const;
 
 private:
     // add a new group 
@@ -40,6 +40,28 @@
 
 // PROJECT
 #include "SpectralInstrumentCompatibility.h"
+#include "CameraFrameTransform.h"
+#include "CameraFrameChangeDetector.h"
+#include "CameraMosaic.h"
+#include "CameraTransferStatistics.h"
+#include "CameraPacketDelayController.h"
+#include "CameraSocketMonitor.h"
+#include "CameraFrameMetadataTable.h"
+#include "CameraFitsWriter.h"
+#include "CameraHdf5Writer.h"
+#include "CameraThroughputProfiles.h"
+#include "CameraPresetLibrary.h"
+#include "CameraRowBandNotifier.h"
+#include "CameraDecodePool.h"
+#include "CameraSoakMonitor.h"
+#include "CameraPhotonTransfer.h"
+#include "CameraLutCorrection.h"
+#include "CameraFrameStacker.h"
+#include "CameraAzimuthalIntegrator.h"
+#include "CameraRoiCounterTable.h"
+#include "CameraBackgroundSubtraction.h"
+#include "CameraClock.h"
+#include "CameraControl.h"
 
 #define REPORT_EVENT(desc) { \
     Event *my_event = new Event(Hardware,Event::Info, Event::Camera, Event::Default,desc); \
@@ -57,7 +79,7 @@ namespace SpectralInstrument
     * \class Camera
     * \brief object controlling the SpectralInstrument camera
     *******************************************************************/
-	class LIBSPECTRAL_API Camera
+	class LIBSPECTRAL_API Camera : public HwMaxImageSizeCallbackGen
 	{
 	    DEB_CLASS_NAMESPC(DebModCamera, "Camera", "SpectralInstrument");
 
@@ -168,6 +190,15 @@ namespace SpectralInstrument
 
         // increment the number of acquired frames
         void incrementNbFramesAcquired();
+
+        // set the number of frames dropped by the processing stages
+        void setNbFramesDropped(std::size_t in_nb_frames_dropped);
+
+        // get the number of frames dropped by the processing stages
+        std::size_t getNbFramesDropped() const;
+
+        // increment the number of frames dropped by the processing stages
+        void incrementNbFramesDropped();
 
         // check if all the frames were acquired
         bool allFramesAcquired() const;
@@ -191,6 +222,231 @@ namespace SpectralInstrument
 
         void getReadoutSpeedFromCamera(ushort& in_out_value);
 
+        //-- frame processing
+        // orientation applied during the frame assembly (flips, rotations, transpositions)
+        void setOrientation(CameraFrameTransform::Orientation in_orientation);
+        void getOrientation(CameraFrameTransform::Orientation & out_orientation) const;
+
+        // enable or disable the bad pixel map stage (correction and saturated pixels counting)
+        void setBadPixelCorrection(bool in_enabled);
+        void getBadPixelCorrection(bool & out_enabled) const;
+
+        // bad pixel map management (CCD coordinates, no binning)
+        void clearBadPixelMap();
+        void addBadPixel(int in_ccd_x, int in_ccd_y);
+        void getBadPixelsNb(int & out_bad_pixels_nb) const;
+        void loadBadPixelMap(const std::string & in_file_name);
+        void saveBadPixelMap(const std::string & in_file_name) const;
+
+        // bad pixel learning during the next frames
+        void startDarkLearning(int in_frames_nb, double in_sigma_factor);
+        void startSaturationLearning(int in_frames_nb, double in_ratio);
+        void isBadPixelLearningRunning(bool & out_running) const;
+
+        // saturated pixels counting
+        void setSaturationLevel(int in_saturation_level);
+        void getSaturationLevel(int & out_saturation_level) const;
+        void getSaturatedPixelsNb(int in_frame_nb, int & out_saturated_pixels_nb) const;
+        void getLastSaturatedPixelsNb(int & out_saturated_pixels_nb) const;
+
+        // frame change detection (unchanged frames are marked or dropped)
+        void setFrameChangeDetection(bool in_enabled);
+        void getFrameChangeDetection(bool & out_enabled) const;
+        void setFrameChangeDrop(bool in_drop);
+        void getFrameChangeDrop(bool & out_drop) const;
+        void setFrameChangeThreshold(double in_threshold);
+        void getFrameChangeThreshold(double & out_threshold) const;
+        void resetFrameChangeReference();
+        void isFrameChanged(int in_frame_nb, bool & out_changed) const;
+        void getFrameChangeCounters(CameraFrameChangeCounters & out_counters) const;
+
+        // mosaic of several detectors (one process by detector, frames assembled in shared memory)
+        void setMosaic(bool in_enabled);
+        void getMosaic(bool & out_enabled) const;
+        void loadMosaicGeometry(const std::string & in_file_name);
+        void setMosaicTile(int in_tile_index);
+        void getMosaicTile(int & out_tile_index) const;
+        void setMosaicSharedMemoryName(const std::string & in_name);
+        void getMosaicSharedMemoryName(std::string & out_name) const;
+        void getMosaicSize(int & out_width, int & out_height) const;
+        void getMosaicCompleteFrames(int & out_complete_frames_nb, int & out_last_complete_frame) const;
+
+        // reception times (kernel timestamps) and transfer rate statistics
+        void getFrameReceptionTimes(int in_frame_nb, double & out_first_part_time, double & out_last_part_time) const;
+        void getTransferCounters(CameraTransferCounters & out_counters) const;
+
+        // closed-loop control of the delay between two image packets
+        void setPacketDelayControl(bool in_enabled);
+        void getPacketDelayControl(bool & out_enabled) const;
+        void setPacketDelayRange(int in_min_delay_usec, int in_max_delay_usec);
+        void getPacketDelayRange(int & out_min_delay_usec, int & out_max_delay_usec) const;
+        void setPacketDelayLimits(double in_queue_ratio, double in_lag_sec);
+        void getPacketDelayLimits(double & out_queue_ratio, double & out_lag_sec) const;
+        void getPacketDelay(int & out_delay_usec) const;
+
+        // socket backlog and reception lag monitor
+        void getSocketGauges(CameraSocketGauges & out_gauges) const;
+        void getSocketHistograms(CameraSocketHistograms & out_histograms) const;
+        void resetSocketMonitor();
+
+        // low latency mode of the control socket
+        void setLowLatencyMode(bool in_enabled);
+        void getLowLatencyMode(bool & out_enabled) const;
+        void setLowLatencyParameters(int in_busy_poll_usec, int in_spin_window_usec);
+        void getLowLatencyParameters(int & out_busy_poll_usec, int & out_spin_window_usec) const;
+        void benchmarkCommandRoundTrip(int in_nb_commands, CameraRoundTripStatistics & out_normal, CameraRoundTripStatistics & out_low_latency);
+
+        // FITS writer
+        void setFitsWriter(bool in_enabled);
+        void getFitsWriter(bool & out_enabled) const;
+        void setFitsMode(CameraFitsWriter::Mode in_mode);
+        void getFitsMode(CameraFitsWriter::Mode & out_mode) const;
+        void setFitsPathPrefix(const std::string & in_path_prefix);
+        void getFitsPathPrefix(std::string & out_path_prefix) const;
+        void setFitsBuffersNb(int in_buffers_nb);
+        void getFitsBuffersNb(int & out_buffers_nb) const;
+        void getFitsCounters(CameraFitsCounters & out_counters) const;
+
+        // HDF5/NeXus writer
+        void setHdf5Writer(bool in_enabled);
+        void getHdf5Writer(bool & out_enabled) const;
+        void setHdf5PathPrefix(const std::string & in_path_prefix);
+        void getHdf5PathPrefix(std::string & out_path_prefix) const;
+        void setHdf5CompressionLevel(int in_compression_level);
+        void getHdf5CompressionLevel(int & out_compression_level) const;
+        void setHdf5BuffersNb(int in_buffers_nb);
+        void getHdf5BuffersNb(int & out_buffers_nb) const;
+        void getHdf5Counters(CameraHdf5Counters & out_counters) const;
+
+        // per-frame metadata
+        void getFrameMetadata(int in_frame_nb, CameraFrameMetadata & out_metadata) const;
+
+        // camera parameters (cached GetCameraParameters table)
+        void getCameraParameter(const std::string & in_group, const std::string & in_name, std::string & out_value) const;
+        void setCameraParameter(const std::string & in_group, const std::string & in_name, int in_value);
+        void setCameraParameters(const std::vector<CameraParameterChange> & in_changes);
+        void getCameraParameterTable(std::vector<CameraParameter> & out_parameters) const;
+        void refreshCameraParameters();
+
+        // throughput profiles
+        void setThroughputCandidate(int in_readout_speed, double in_read_noise);
+        void clearThroughputCandidates();
+        void getThroughputCandidates(std::vector<CameraReadoutCandidate> & out_candidates) const;
+        void setThroughputTargetFrameRate(double in_frame_rate);
+        void getThroughputTargetFrameRate(double & out_frame_rate) const;
+        void setThroughputNoiseBudget(double in_read_noise);
+        void getThroughputNoiseBudget(double & out_read_noise) const;
+        void setThroughputMaxBinning(int in_max_binning);
+        void getThroughputMaxBinning(int & out_max_binning) const;
+        void setThroughputPacketSettings(const CameraPacketSettings & in_fast, const CameraPacketSettings & in_quiet);
+        void getThroughputPacketSettings(CameraPacketSettings & out_fast, CameraPacketSettings & out_quiet) const;
+        void chooseThroughputProfile(CameraThroughputProfiles::Profile in_profile, CameraThroughputChoice & out_choice) const;
+        void applyThroughputProfile(CameraThroughputProfiles::Profile in_profile, CameraThroughputChoice & out_choice);
+
+        // experiment presets
+        void setPresetDirectory(const std::string & in_directory);
+        void getPresetDirectory(std::string & out_directory) const;
+        void savePreset(const std::string & in_name);
+        void getPresetNames(std::vector<std::string> & out_names) const;
+        void removePreset(const std::string & in_name);
+        void applyPreset(const std::string & in_name, CameraPresetLimaSettings & out_lima_settings, double & out_apply_time_sec, int & out_commands_nb);
+
+        // progressive row bands of the frame being received
+        void addRowBandListener(CameraRowBandListener * in_listener);
+        void removeRowBandListener(CameraRowBandListener * in_listener);
+        void setRowBandRows(int in_band_rows);
+        void getRowBandRows(int & out_band_rows) const;
+        void getRowBandsNb(int & out_bands_nb) const;
+
+        // parallel decoding of the image parts
+        void setDecodeThreadsNb(int in_threads_nb);
+        void getDecodeThreadsNb(int & out_threads_nb) const;
+        void setDecodeBatchSize(int in_batch_size);
+        void getDecodeBatchSize(int & out_batch_size) const;
+        void measureDecodeScaling(int in_max_threads_nb, int in_width, int in_height, int in_pixels_per_part, std::vector<CameraDecodeScaling> & out_results);
+
+        // long runs monitoring (resources growth and latencies drift)
+        void setSoakMonitorEnabled(bool in_enabled);
+        void getSoakMonitorEnabled(bool & out_enabled) const;
+        void resetSoakMonitor();
+        void setSoakSampleIntervalSec(double in_interval_sec);
+        void getSoakSampleIntervalSec(double & out_interval_sec) const;
+        void setSoakThresholds(double in_growth_ratio, double in_drift_ratio);
+        void getSoakThresholds(double & out_growth_ratio, double & out_drift_ratio) const;
+        void getSoakSamples(std::vector<CameraSoakSample> & out_samples) const;
+        void analyzeSoakDrifts(std::vector<CameraSoakDrift> & out_drifts, bool & out_flagged) const;
+        void writeSoakSamples(const std::string & in_file_name) const;
+
+        // virtual time (fast-forwarded exposures and sequences against a fake server)
+        void setVirtualTimeScale(double in_time_scale);
+        void getVirtualTimeScale(double & out_time_scale) const;
+
+        // photon transfer curve and per pixel noise characterization (series of flat and dark acquisitions)
+        void startPhotonTransferSeries();
+        void stopPhotonTransferSeries();
+        void isPhotonTransferSeriesRunning(bool & out_running) const;
+        void setPhotonTransferThreadsNb(int in_threads_nb);
+        void getPhotonTransferThreadsNb(int & out_threads_nb) const;
+        void getPhotonTransferSteps(std::vector<CameraPhotonTransferStep> & out_steps) const;
+        void computePhotonTransferMaps(CameraPhotonTransferMaps & out_maps) const;
+
+        // linearity correction and ADU to electrons conversion (scaled 16 bits frames or float frames)
+        void setLutCorrection(bool in_enabled);
+        void getLutCorrection(bool & out_enabled) const;
+        void setLutPolynomial(const std::vector<double> & in_coefficients);
+        void loadLutTable(const std::string & in_file_name);
+        void setLutGain(double in_gain);
+        void getLutGain(double & out_gain) const;
+        void setLutOutput(CameraLutCorrection::Output in_output);
+        void getLutOutput(CameraLutCorrection::Output & out_output) const;
+        void setLutScale(double in_scale);
+        void getLutScale(double & out_scale) const;
+        void getLutFloatFrame(int in_frame_nb, std::vector<float> & out_frame) const;
+
+        // stacking of the frames with drift registration (sum and coverage of each pixel)
+        void setFrameStacking(bool in_enabled);
+        void getFrameStacking(bool & out_enabled) const;
+        void setStackDownsampling(int in_factor);
+        void getStackDownsampling(int & out_factor) const;
+        void setStackInterpolation(CameraFrameStacker::Interpolation in_interpolation);
+        void getStackInterpolation(CameraFrameStacker::Interpolation & out_interpolation) const;
+        void setStackThreadsNb(int in_threads_nb);
+        void getStackThreadsNb(int & out_threads_nb) const;
+        void getStackCounters(CameraStackCounters & out_counters) const;
+        void getStackShifts(std::vector<CameraStackShift> & out_shifts) const;
+        void getFrameStack(CameraStackImage & out_stack) const;
+
+        // azimuthal integration of the frames into radial profiles (scattering experiments)
+        void setAzimuthalIntegration(bool in_enabled);
+        void getAzimuthalIntegration(bool & out_enabled) const;
+        void setIntegrationGeometry(const CameraIntegrationGeometry & in_geometry);
+        void getIntegrationGeometry(CameraIntegrationGeometry & out_geometry) const;
+        void setIntegrationThreadsNb(int in_threads_nb);
+        void getIntegrationThreadsNb(int & out_threads_nb) const;
+        void getIntegrationMatrixSize(int & out_elements_nb) const;
+        void getRadialProfile(int in_frame_nb, CameraRadialProfile & out_profile) const;
+        void getLastRadialProfile(CameraRadialProfile & out_profile) const;
+
+        // ROI counters computed during the frame assembly (sums, maximums and pixels numbers by frame)
+        void setRoiCounters(bool in_enabled);
+        void getRoiCounters(bool & out_enabled) const;
+        void setCounterRois(const std::vector<CameraCounterRoi> & in_rois);
+        void getCounterRois(std::vector<CameraCounterRoi> & out_rois) const;
+        void getRoiFrameCounters(int in_frame_nb, CameraRoiFrameCounters & out_counters) const;
+        void getLastRoiFrameCounters(CameraRoiFrameCounters & out_counters) const;
+
+        // rolling background subtraction for the live mode (moving average on a grid of cells)
+        void setBackgroundSubtraction(bool in_enabled);
+        void getBackgroundSubtraction(bool & out_enabled) const;
+        void setBackgroundCellSize(int in_cell_size);
+        void getBackgroundCellSize(int & out_cell_size) const;
+        void setBackgroundTimeConstant(double in_frames_nb);
+        void getBackgroundTimeConstant(double & out_frames_nb) const;
+        void setBackgroundOffset(double in_offset);
+        void getBackgroundOffset(double & out_offset) const;
+        void resetBackground();
+        void getBackgroundModel(CameraBackgroundModel & out_model) const;
+
     //-----------------------------------------------------------------------------
 	private:
         // execute a stop acq command
@@ -199,6 +455,12 @@ namespace SpectralInstrument
         // creates an autolock mutex for the update authorize flag access
         lima::AutoMutex updateAuthorizeFlagLock() const;
 
+        // prepare the frame processing stages for the next acquisition
+        void prepareFrameProcessing();
+
+        // get the full frame size (binning applied) of the image sent by the camera
+        void getSourceFullFrameSize(std::size_t & out_width, std::size_t & out_height) const;
+
 	//-----------------------------------------------------------------------------
 	private:
         //-----------------------------------------------------------------------------
@@ -237,6 +499,9 @@ namespace SpectralInstrument
         // simulated number of frames already acquired
         std::size_t m_nb_frames_acquired;
 
+        // number of frames dropped by the processing stages (they count as exposures of the acquisition)
+        std::size_t m_nb_frames_dropped;
+
         // latency time in milli-seconds
         uint32_t m_latency_time_msec; 
 
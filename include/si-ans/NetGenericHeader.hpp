@@ -29,6 +29,9 @@ const uint8_t  NetGenericHeader::g_packet_identifier_for_acknowledge = 129 ;
 const uint8_t  NetGenericHeader::g_packet_identifier_for_data        = 131 ;
 const uint8_t  NetGenericHeader::g_packet_identifier_for_image       = 132 ;
 
+volatile uint64_t NetGenericHeader::g_created_instances_nb  = 0;
+volatile uint64_t NetGenericHeader::g_released_instances_nb = 0;
+
 //------------------------------------------------------------
 // specialized template methods for 8 bits unsigned integers
 //------------------------------------------------------------
@@ -242,6 +245,76 @@ NetGenericHeader::NetGenericHeader()
     m_packet_identifier = 0; 
     m_camera_identifier = 0; // 0 for server commands, Camera number (1..max)
     m_packet_name       = "NetGenericHeader";
+
+    __sync_fetch_and_add(&g_created_instances_nb, 1);
+}
+
+/****************************************************************************************************
+ * \fn NetGenericHeader(const NetGenericHeader & in_packet)
+ * \brief  copy constructor
+ * \param  in_packet packet to copy
+ * \return none
+ ****************************************************************************************************/
+NetGenericHeader::NetGenericHeader(const NetGenericHeader & in_packet)
+{
+    m_packet_lenght     = in_packet.m_packet_lenght    ;
+    m_packet_identifier = in_packet.m_packet_identifier;
+    m_camera_identifier = in_packet.m_camera_identifier;
+    m_packet_name       = in_packet.m_packet_name      ;
+
+    __sync_fetch_and_add(&g_created_instances_nb, 1);
+}
+
+/****************************************************************************************************
+ * \fn NetGenericHeader & operator=(const NetGenericHeader & in_packet)
+ * \brief  copy assignment (no packet is created, so the instances counters are not changed)
+ * \param  in_packet packet to copy
+ * \return this packet
+ ****************************************************************************************************/
+NetGenericHeader & NetGenericHeader::operator=(const NetGenericHeader & in_packet)
+{
+    m_packet_lenght     = in_packet.m_packet_lenght    ;
+    m_packet_identifier = in_packet.m_packet_identifier;
+    m_camera_identifier = in_packet.m_camera_identifier;
+    m_packet_name       = in_packet.m_packet_name      ;
+
+    return *this;
+}
+
+/****************************************************************************************************
+ * \fn ~NetGenericHeader()
+ * \brief  destructor (needs to be virtual, the packets are released through this class)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+NetGenericHeader::~NetGenericHeader()
+{
+    __sync_fetch_and_add(&g_released_instances_nb, 1);
+}
+
+/****************************************************************************************************
+ * \fn uint64_t getLiveInstancesNb()
+ * \brief  get the number of packets which are not yet released
+ * \param  none
+ * \return number of packets
+ ****************************************************************************************************/
+uint64_t NetGenericHeader::getLiveInstancesNb()
+{
+    uint64_t released_nb = __sync_fetch_and_add(&g_released_instances_nb, 0);
+    uint64_t created_nb  = __sync_fetch_and_add(&g_created_instances_nb , 0);
+
+    return (created_nb > released_nb) ? (created_nb - released_nb) : 0;
+}
+
+/****************************************************************************************************
+ * \fn uint64_t getCreatedInstancesNb()
+ * \brief  get the number of packets created since the start
+ * \param  none
+ * \return number of packets
+ ****************************************************************************************************/
+uint64_t NetGenericHeader::getCreatedInstancesNb()
+{
+    return __sync_fetch_and_add(&g_created_instances_nb, 0);
 }
 
 /****************************************************************************************************
@@ -32,6 +32,10 @@
 NetImage::NetImage()
 {
     m_packet_name = "Image";
+
+    m_header_reception_time = 0.0;
+    m_data_reception_time   = 0.0;
+    m_host_order            = true;
 }
 
 /****************************************************************************************************
@@ -58,7 +62,9 @@ std::size_t NetImage::totalSize() const
 
 /****************************************************************************************************
  * \fn bool read(const uint8_t * & in_out_memory_data, std::size_t & in_out_memory_size)
- * \brief  read the values stored into a memory block and fill them into the class members
+ * \brief  read the values stored into a memory block and fill them into the class members.
+ *         The pixels are kept in the network byte order: the conversion is done by convert(),
+ *         out of the reception thread.
  * \param  in_out_memory_data start of the memory block to be read (moves to the next data block)
  * \param  in_out_memory_size size of the rest of memory block (the size of the data block will be removed)
  * \return true if success else false in case of error
@@ -68,13 +74,7 @@ bool NetImage::read(const uint8_t * & in_out_memory_data, std::size_t & in_out_m
     m_image.resize(in_out_memory_size / sizeof(uint16_t));
     memcpy((char*)m_image.data(), reinterpret_cast<const char *>(in_out_memory_data), in_out_memory_size);
 
-    uint16_t    * ptr = m_image.data();
-    std::size_t   nb  = m_image.size();
-
-    while(nb--)
-    {
-        *ptr++ = UINT16_TO_HOST(*ptr);
-    }
+    m_host_order = false;
 
     in_out_memory_data += NetImage::size();
 
@@ -163,14 +163,71 @@ void NetImage::totalLog() const
     NetImage::log();
 }
 
+/****************************************************************************************************
+ * \fn void convert()
+ * \brief  convert the received pixels from the network byte order (done once, before the copies)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void NetImage::convert()
+{
+    if(m_host_order)
+        return;
+
+    uint16_t    * ptr = m_image.data();
+    std::size_t   nb  = m_image.size();
+
+    for(std::size_t index = 0 ; index < nb ; index++)
+    {
+        ptr[index] = UINT16_TO_HOST(ptr[index]);
+    }
+
+    m_host_order = true;
+}
+
+/****************************************************************************************************
+ * \fn void moveTo(NetImage & out_image)
+ * \brief  move the header and the pixels into another image part (this part keeps no pixel)
+ * \param  out_image destination image part (its previous pixels are released)
+ * \return none
+ ****************************************************************************************************/
+void NetImage::moveTo(NetImage & out_image)
+{
+    static_cast<NetImageHeader &>(out_image) = *this;
+
+    out_image.m_header_reception_time = m_header_reception_time;
+    out_image.m_data_reception_time   = m_data_reception_time  ;
+    out_image.m_host_order            = m_host_order           ;
+
+    out_image.m_image.swap(m_image);
+    m_image.clear();
+    m_host_order = true;
+}
+
 /****************************************************************************************************
  * \fn bool copy() const
- * \brief  copy the image part into a destination buffer
+ * \brief  copy the image part at its oriented location into a destination buffer
  * \param  in_out_buffer destination copy buffer 
  * \param  in_buffer_dim destination buffer data
+ * \param  in_transform orientation transform applied during the copy
  * \return true if the copy was a success, else false
  ****************************************************************************************************/
-bool NetImage::copy(void * in_out_buffer, lima::FrameDim & in_buffer_dim) const
+bool NetImage::copy(void * in_out_buffer, lima::FrameDim & in_buffer_dim, const CameraFrameTransform & in_transform) const
+{
+    return copy(in_out_buffer, static_cast<std::size_t>(in_buffer_dim.getSize().getWidth()), in_buffer_dim, in_transform);
+}
+
+/****************************************************************************************************
+ * \fn bool copy() const
+ * \brief  copy the image part at its oriented location into a larger destination buffer
+ *         (the image is one tile of a mosaic)
+ * \param  in_out_buffer first pixel of the oriented image in the destination buffer
+ * \param  in_buffer_stride number of pixels between two rows of the destination buffer
+ * \param  in_buffer_dim oriented image data
+ * \param  in_transform orientation transform applied during the copy
+ * \return true if the copy was a success, else false
+ ****************************************************************************************************/
+bool NetImage::copy(void * in_out_buffer, std::size_t in_buffer_stride, lima::FrameDim & in_buffer_dim, const CameraFrameTransform & in_transform) const
 {
     // check the image type
     if((static_cast<NetCommandRetrieveImage::TransfertType>(m_image_type) != NetCommandRetrieveImage::TransfertType::TransfertU16) ||
@@ -180,13 +237,53 @@ bool NetImage::copy(void * in_out_buffer, lima::FrameDim & in_buffer_dim) const
         return false;
     }
 
-    // compute the position in the destination buffer
-    uint16_t * dest = static_cast<uint16_t *>(in_out_buffer) + m_offset;
+    // the pixels must be converted before the copy
+    if(!m_host_order)
+    {
+        std::cout << "NetImage::copy - error: the image part was not converted from the network byte order" << std::endl;
+        return false;
+    }
+
+    std::size_t frame_width   = static_cast<std::size_t>(in_buffer_dim.getSize().getWidth ());
+    std::size_t frame_height  = static_cast<std::size_t>(in_buffer_dim.getSize().getHeight());
+    std::size_t source_width  = frame_width ;
+    std::size_t source_height = frame_height;
+
+    // the image size given by the header is only needed to place the pixels of an oriented image
+    if(in_transform.getOrientation() != CameraFrameTransform::Normal)
+    {
+        std::size_t width ;
+        std::size_t height;
+
+        source_width  = static_cast<std::size_t>(m_serial_lenght  );
+        source_height = static_cast<std::size_t>(m_parallel_lenght);
+
+        in_transform.getDestinationSize(source_width, source_height, width, height);
+
+        if((width != frame_width) || (height != frame_height))
+        {
+            std::cout << "NetImage::copy - error for image size: " << source_width << "x" << source_height 
+                      << " (frame " << frame_width << "x" << frame_height << ")" << std::endl;
+            return false;
+        }
+    }
+
+    // check the image part position
+    if((m_offset < 0) || (static_cast<std::size_t>(m_offset) + m_image.size() > source_width * source_height))
+    {
+        std::cout << "NetImage::copy - error for image part: " << m_offset << " (" << m_image.size() << " pixels) of image " 
+                  << source_width << "x" << source_height << std::endl;
+        return false;
+    }
 
-    // copy the image part
-    memcpy(reinterpret_cast<char *>(dest), 
-           reinterpret_cast<const char *>(m_image.data()),
-           m_image.size() * sizeof(uint16_t)); 
+    // copy the image part at its oriented location
+    in_transform.copyPart(m_image.data()                         ,
+                          static_cast<std::size_t>(m_offset)      ,
+                          m_image.size()                          ,
+                          source_width                            ,
+                          source_height                           ,
+                          static_cast<uint16_t *>(in_out_buffer)  ,
+                          in_buffer_stride                        );
 
     return true;
 }
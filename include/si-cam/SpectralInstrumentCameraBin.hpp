@@ -44,8 +44,12 @@ void Camera::setBin(const Bin & set_bin) ///< [in] binning values objects
     DEB_MEMBER_FUNCT();
     DEB_PARAM() << DEB_VAR1(set_bin);
 
+    // the frame axes can be swapped by the orientation
+    bool swap_axes = CameraFrameProcessing::getConstInstance()->getTransform().swapsAxes();
+
     // Change the roi by sending a command to the hardware
-    CameraControl::getInstance()->setBinning(set_bin.getX(), set_bin.getY());
+    CameraControl::getInstance()->setBinning((swap_axes) ? set_bin.getY() : set_bin.getX(),
+                                             (swap_axes) ? set_bin.getX() : set_bin.getY());
 
     DEB_RETURN() << DEB_VAR1(set_bin);
 }
@@ -57,8 +61,18 @@ void Camera::getBin(Bin & hw_bin) ///< [out] binning values object
 {
     DEB_MEMBER_FUNCT();
     
-    hw_bin = Bin( static_cast<int>(CameraControl::getConstInstance()->getSerialBinning  ()),
-                  static_cast<int>(CameraControl::getConstInstance()->getParallelBinning()));
+    int serial_binning   = static_cast<int>(CameraControl::getConstInstance()->getSerialBinning  ());
+    int parallel_binning = static_cast<int>(CameraControl::getConstInstance()->getParallelBinning());
+
+    // the frame axes can be swapped by the orientation
+    if(CameraFrameProcessing::getConstInstance()->getTransform().swapsAxes())
+    {
+        hw_bin = Bin(parallel_binning, serial_binning);
+    }
+    else
+    {
+        hw_bin = Bin(serial_binning, parallel_binning);
+    }
 
     DEB_RETURN() << DEB_VAR1(hw_bin);
 }
@@ -39,7 +39,16 @@ void Camera::getPixelSize(double& sizex,    ///< [out] horizontal pixel size
 void Camera::getDetectorMaxImageSize(Size& size) ///< [out] image dimensions
 {
     DEB_MEMBER_FUNCT();
-    size = Size(CameraControl::getConstInstance()->getWidthMax (), CameraControl::getConstInstance()->getHeightMax());
+
+    std::size_t width ;
+    std::size_t height;
+
+    // the size is given in the frame orientation
+    CameraFrameProcessing::getConstInstance()->getTransform().getDestinationSize(CameraControl::getConstInstance()->getWidthMax (),
+                                                                                 CameraControl::getConstInstance()->getHeightMax(),
+                                                                                 width, height);
+
+    size = Size(static_cast<int>(width), static_cast<int>(height));
 }
 
 //-----------------------------------------------------------------------------
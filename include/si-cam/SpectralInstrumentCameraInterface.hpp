@@ -136,6 +136,10 @@ void Camera::startAcq()
 
     // reinit the number of frames
     setNbFramesAcquired(0);
+    setNbFramesDropped (0);
+
+    // prepare the frame processing stages with the new frame format
+    prepareFrameProcessing();
 
     //================================================================================================
     // starting the acquisition thread
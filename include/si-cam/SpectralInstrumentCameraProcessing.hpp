@@ -0,0 +1,2381 @@
+///###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//############################################################################
+
+//-----------------------------------------------------------------------------
+/// Prepare the frame processing stages for the next acquisition
+//-----------------------------------------------------------------------------
+void Camera::prepareFrameProcessing()
+{
+    DEB_MEMBER_FUNCT();
+
+    StdBufferCbMgr & buffer_mgr = getStdBufferCbMgr();
+    lima::FrameDim   frame_dim  = buffer_mgr.getFrameDim();
+
+    CameraFrameFormat format;
+
+    format.m_width            = static_cast<std::size_t>(frame_dim.getSize().getWidth ());
+    format.m_height           = static_cast<std::size_t>(frame_dim.getSize().getHeight());
+    format.m_serial_origin    = CameraControl::getConstInstance()->getSerialOrigin   ();
+    format.m_parallel_origin  = CameraControl::getConstInstance()->getParallelOrigin ();
+    format.m_serial_binning   = CameraControl::getConstInstance()->getSerialBinning  ();
+    format.m_parallel_binning = CameraControl::getConstInstance()->getParallelBinning();
+    format.m_width_max        = CameraControl::getConstInstance()->getWidthMax       ();
+    format.m_height_max       = CameraControl::getConstInstance()->getHeightMax      ();
+    format.m_pixel_depth      = static_cast<std::size_t>(frame_dim.getDepth() * 8);
+    format.m_nb_frames        = m_nb_frames_to_acquire;
+    format.m_orientation      = CameraFrameProcessing::getConstInstance()->getTransform().getOrientation();
+
+    if(!CameraFrameProcessing::getInstance()->prepareAcq(format))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "prepareFrameProcessing - Unable to prepare the frame processing stages!";
+    }
+
+    CameraTransferStatistics::getInstance()->prepareAcq(m_nb_frames_to_acquire, CameraControl::getConstInstance()->hasKernelTimestamps());
+    CameraFrameMetadataTable::getInstance()->prepareAcq();
+    CameraRoiCounterTable::getInstance()->prepareAcq();
+}
+
+//-----------------------------------------------------------------------------
+/// ORIENTATION
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Get the full frame size (binning applied) of the image sent by the camera
+//-----------------------------------------------------------------------------
+void Camera::getSourceFullFrameSize(std::size_t & out_width ,  ///< [out] full frame width
+                                    std::size_t & out_height) const ///< [out] full frame height
+{
+    std::size_t binning_x = CameraControl::getConstInstance()->getSerialBinning  ();
+    std::size_t binning_y = CameraControl::getConstInstance()->getParallelBinning();
+
+    out_width  = CameraControl::getConstInstance()->getWidthMax () / ((binning_x > 0) ? binning_x : 1);
+    out_height = CameraControl::getConstInstance()->getHeightMax() / ((binning_y > 0) ? binning_y : 1);
+}
+
+//-----------------------------------------------------------------------------
+/// Set the orientation applied during the frame assembly
+//-----------------------------------------------------------------------------
+void Camera::setOrientation(CameraFrameTransform::Orientation in_orientation) ///< [in] new orientation
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setOrientation - The orientation can not be changed during an acquisition!";
+    }
+
+    CameraFrameTransform::Orientation previous_orientation = CameraFrameProcessing::getConstInstance()->getTransform().getOrientation();
+
+    if(in_orientation == previous_orientation)
+        return;
+
+    // the Lima ROI of a part of the CCD would select another CCD region with the new orientation
+    {
+        std::size_t source_width ;
+        std::size_t source_height;
+
+        getSourceFullFrameSize(source_width, source_height);
+
+        if((CameraControl::getConstInstance()->getSerialOrigin  () != 0            ) ||
+           (CameraControl::getConstInstance()->getParallelOrigin() != 0            ) ||
+           (CameraControl::getConstInstance()->getSerialLength  () != source_width ) ||
+           (CameraControl::getConstInstance()->getParallelLength() != source_height))
+        {
+            THROW_HW_ERROR(ErrorType::Error) << "setOrientation - The orientation can not be changed with a ROI, reset the ROI first!";
+        }
+    }
+
+    CameraFrameProcessing::getInstance()->setOrientation(in_orientation);
+
+    // Lima needs to be informed even if the axes are not swapped, so it reads the geometry again
+    {
+        Size      max_image_size;
+        ImageType image_type    ;
+
+        getDetectorMaxImageSize(max_image_size);
+        getImageType(image_type);
+
+        maxImageSizeChanged(max_image_size, image_type);
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the orientation applied during the frame assembly
+//-----------------------------------------------------------------------------
+void Camera::getOrientation(CameraFrameTransform::Orientation & out_orientation) const ///< [out] current orientation
+{
+    DEB_MEMBER_FUNCT();
+    out_orientation = CameraFrameProcessing::getConstInstance()->getTransform().getOrientation();
+}
+
+//-----------------------------------------------------------------------------
+/// BAD PIXEL MAP
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the bad pixel map stage (correction and saturated pixels counting)
+//-----------------------------------------------------------------------------
+void Camera::setBadPixelCorrection(bool in_enabled) ///< [in] true to enable the stage
+{
+    DEB_MEMBER_FUNCT();
+    CameraBadPixelMap::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the bad pixel map stage is enabled
+//-----------------------------------------------------------------------------
+void Camera::getBadPixelCorrection(bool & out_enabled) const ///< [out] true if the stage is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraBadPixelMap::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Remove all the bad pixels of the map
+//-----------------------------------------------------------------------------
+void Camera::clearBadPixelMap()
+{
+    DEB_MEMBER_FUNCT();
+    CameraBadPixelMap::getInstance()->clearMap();
+}
+
+//-----------------------------------------------------------------------------
+/// Add a bad pixel into the map
+//-----------------------------------------------------------------------------
+void Camera::addBadPixel(int in_ccd_x, ///< [in] serial coordinate of the pixel on the CCD (no binning)
+                         int in_ccd_y) ///< [in] parallel coordinate of the pixel on the CCD (no binning)
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_ccd_x < 0) || (in_ccd_y < 0) ||
+       (static_cast<std::size_t>(in_ccd_x) >= CameraControl::getConstInstance()->getWidthMax ()) ||
+       (static_cast<std::size_t>(in_ccd_y) >= CameraControl::getConstInstance()->getHeightMax()))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "addBadPixel - Incorrect pixel coordinates: " << in_ccd_x << ", " << in_ccd_y << "!";
+    }
+
+    CameraBadPixelMap::getInstance()->addBadPixel(static_cast<std::size_t>(in_ccd_x), static_cast<std::size_t>(in_ccd_y));
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of bad pixels of the map
+//-----------------------------------------------------------------------------
+void Camera::getBadPixelsNb(int & out_bad_pixels_nb) const ///< [out] number of bad pixels
+{
+    DEB_MEMBER_FUNCT();
+    out_bad_pixels_nb = static_cast<int>(CameraBadPixelMap::getConstInstance()->getBadPixelsNb());
+}
+
+//-----------------------------------------------------------------------------
+/// Load the bad pixel map from a text file
+//-----------------------------------------------------------------------------
+void Camera::loadBadPixelMap(const std::string & in_file_name) ///< [in] complete path of the file
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraBadPixelMap::getInstance()->loadMap(in_file_name))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "loadBadPixelMap - Unable to load the file " << in_file_name << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Save the bad pixel map into a text file
+//-----------------------------------------------------------------------------
+void Camera::saveBadPixelMap(const std::string & in_file_name) const ///< [in] complete path of the file
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraBadPixelMap::getConstInstance()->saveMap(in_file_name))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "saveBadPixelMap - Unable to save the file " << in_file_name << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Learn the hot pixels during the next dark frames
+//-----------------------------------------------------------------------------
+void Camera::startDarkLearning(int    in_frames_nb    , ///< [in] number of dark frames to accumulate
+                               double in_sigma_factor ) ///< [in] number of standard deviations above the mean
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_frames_nb <= 0) || (in_sigma_factor <= 0.0))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "startDarkLearning - Incorrect parameters: " << in_frames_nb << ", " << in_sigma_factor << "!";
+    }
+
+    CameraBadPixelMap::getInstance()->startLearning(CameraBadPixelMap::LearningMode::Dark, static_cast<std::size_t>(in_frames_nb), in_sigma_factor);
+}
+
+//-----------------------------------------------------------------------------
+/// Learn the pixels which are saturated in most of the next frames
+//-----------------------------------------------------------------------------
+void Camera::startSaturationLearning(int    in_frames_nb, ///< [in] number of frames to accumulate
+                                     double in_ratio    ) ///< [in] ratio of saturated frames (0..1) from which the pixel is bad
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_frames_nb <= 0) || (in_ratio <= 0.0) || (in_ratio > 1.0))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "startSaturationLearning - Incorrect parameters: " << in_frames_nb << ", " << in_ratio << "!";
+    }
+
+    CameraBadPixelMap::getInstance()->startLearning(CameraBadPixelMap::LearningMode::Saturation, static_cast<std::size_t>(in_frames_nb), in_ratio);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if a bad pixel learning is running
+//-----------------------------------------------------------------------------
+void Camera::isBadPixelLearningRunning(bool & out_running) const ///< [out] true if a learning is running
+{
+    DEB_MEMBER_FUNCT();
+    out_running = (CameraBadPixelMap::getConstInstance()->getLearningMode() != CameraBadPixelMap::LearningMode::None);
+}
+
+//-----------------------------------------------------------------------------
+/// Set the level from which a pixel is considered as saturated
+//-----------------------------------------------------------------------------
+void Camera::setSaturationLevel(int in_saturation_level) ///< [in] new saturation level
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_saturation_level <= 0) || (in_saturation_level > 0xFFFF))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setSaturationLevel - Incorrect level: " << in_saturation_level << "!";
+    }
+
+    CameraBadPixelMap::getInstance()->setSaturationLevel(static_cast<uint16_t>(in_saturation_level));
+}
+
+//-----------------------------------------------------------------------------
+/// Get the level from which a pixel is considered as saturated
+//-----------------------------------------------------------------------------
+void Camera::getSaturationLevel(int & out_saturation_level) const ///< [out] saturation level
+{
+    DEB_MEMBER_FUNCT();
+    out_saturation_level = static_cast<int>(CameraBadPixelMap::getConstInstance()->getSaturationLevel());
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of saturated pixels of a frame of the current acquisition
+//-----------------------------------------------------------------------------
+void Camera::getSaturatedPixelsNb(int   in_frame_nb            , ///< [in]  frame number in the acquisition
+                                  int & out_saturated_pixels_nb) const ///< [out] number of saturated pixels
+{
+    DEB_MEMBER_FUNCT();
+
+    uint32_t saturated_pixels_nb = 0;
+
+    if((in_frame_nb < 0) || (!CameraBadPixelMap::getConstInstance()->getSaturatedPixelsNb(static_cast<std::size_t>(in_frame_nb), saturated_pixels_nb)))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getSaturatedPixelsNb - No data for the frame " << in_frame_nb << "!";
+    }
+
+    out_saturated_pixels_nb = static_cast<int>(saturated_pixels_nb);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of saturated pixels of the latest frame
+//-----------------------------------------------------------------------------
+void Camera::getLastSaturatedPixelsNb(int & out_saturated_pixels_nb) const ///< [out] number of saturated pixels
+{
+    DEB_MEMBER_FUNCT();
+    out_saturated_pixels_nb = static_cast<int>(CameraBadPixelMap::getConstInstance()->getLastSaturatedPixelsNb());
+}
+
+//-----------------------------------------------------------------------------
+/// FRAME CHANGE DETECTION
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the frame change detection stage
+//-----------------------------------------------------------------------------
+void Camera::setFrameChangeDetection(bool in_enabled) ///< [in] true to enable the stage
+{
+    DEB_MEMBER_FUNCT();
+    CameraFrameChangeDetector::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the frame change detection stage is enabled
+//-----------------------------------------------------------------------------
+void Camera::getFrameChangeDetection(bool & out_enabled) const ///< [out] true if the stage is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraFrameChangeDetector::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Select if the unchanged frames are dropped or only marked
+//-----------------------------------------------------------------------------
+void Camera::setFrameChangeDrop(bool in_drop) ///< [in] true to drop the unchanged frames
+{
+    DEB_MEMBER_FUNCT();
+    CameraFrameChangeDetector::getInstance()->setMode((in_drop) ? CameraFrameChangeDetector::Mode::Drop : CameraFrameChangeDetector::Mode::Mark);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the unchanged frames are dropped or only marked
+//-----------------------------------------------------------------------------
+void Camera::getFrameChangeDrop(bool & out_drop) const ///< [out] true if the unchanged frames are dropped
+{
+    DEB_MEMBER_FUNCT();
+    out_drop = (CameraFrameChangeDetector::getConstInstance()->getMode() == CameraFrameChangeDetector::Mode::Drop);
+}
+
+//-----------------------------------------------------------------------------
+/// Set the mean absolute difference by pixel under which a frame is unchanged
+//-----------------------------------------------------------------------------
+void Camera::setFrameChangeThreshold(double in_threshold) ///< [in] threshold in ADU
+{
+    DEB_MEMBER_FUNCT();
+
+    if(in_threshold < 0.0)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setFrameChangeThreshold - Incorrect threshold: " << in_threshold << "!";
+    }
+
+    CameraFrameChangeDetector::getInstance()->setThreshold(in_threshold);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the mean absolute difference by pixel under which a frame is unchanged
+//-----------------------------------------------------------------------------
+void Camera::getFrameChangeThreshold(double & out_threshold) const ///< [out] threshold in ADU
+{
+    DEB_MEMBER_FUNCT();
+    out_threshold = CameraFrameChangeDetector::getConstInstance()->getThreshold();
+}
+
+//-----------------------------------------------------------------------------
+/// Forget the reference frame (the next frame will be kept)
+//-----------------------------------------------------------------------------
+void Camera::resetFrameChangeReference()
+{
+    DEB_MEMBER_FUNCT();
+    CameraFrameChangeDetector::getInstance()->resetReference();
+}
+
+//-----------------------------------------------------------------------------
+/// Check if a frame of the current acquisition changed compared to the reference
+//-----------------------------------------------------------------------------
+void Camera::isFrameChanged(int    in_frame_nb, ///< [in]  frame number in the acquisition
+                            bool & out_changed) const ///< [out] true if the frame changed
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_frame_nb < 0) || (!CameraFrameChangeDetector::getConstInstance()->isFrameChanged(static_cast<std::size_t>(in_frame_nb), out_changed)))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "isFrameChanged - No data for the frame " << in_frame_nb << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the frame change detection counters of the current acquisition
+//-----------------------------------------------------------------------------
+void Camera::getFrameChangeCounters(CameraFrameChangeCounters & out_counters) const ///< [out] counters
+{
+    DEB_MEMBER_FUNCT();
+    out_counters = CameraFrameChangeDetector::getConstInstance()->getCounters();
+}
+
+//-----------------------------------------------------------------------------
+/// Enable or disable the mosaic stage (used at the next acquisition start)
+//-----------------------------------------------------------------------------
+void Camera::setMosaic(bool in_enabled) ///< [in] true to enable the stage
+{
+    DEB_MEMBER_FUNCT();
+    CameraMosaic::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the mosaic stage is enabled
+//-----------------------------------------------------------------------------
+void Camera::getMosaic(bool & out_enabled) const ///< [out] true if the stage is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraMosaic::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Load the mosaic geometry from a text file
+//-----------------------------------------------------------------------------
+void Camera::loadMosaicGeometry(const std::string & in_file_name) ///< [in] complete path of the file
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraMosaic::getInstance()->loadGeometry(in_file_name))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "loadMosaicGeometry - Unable to load the file " << in_file_name << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Set the index of the mosaic tile filled by this detector
+//-----------------------------------------------------------------------------
+void Camera::setMosaicTile(int in_tile_index) ///< [in] tile index in the geometry file
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_tile_index < 0) || (!CameraMosaic::getInstance()->setTileIndex(static_cast<std::size_t>(in_tile_index))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setMosaicTile - Incorrect tile index: " << in_tile_index << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the index of the mosaic tile filled by this detector
+//-----------------------------------------------------------------------------
+void Camera::getMosaicTile(int & out_tile_index) const ///< [out] tile index in the geometry file
+{
+    DEB_MEMBER_FUNCT();
+    out_tile_index = static_cast<int>(CameraMosaic::getConstInstance()->getTileIndex());
+}
+
+//-----------------------------------------------------------------------------
+/// Set the name of the mosaic shared memory (shared by all the detectors processes)
+//-----------------------------------------------------------------------------
+void Camera::setMosaicSharedMemoryName(const std::string & in_name) ///< [in] POSIX shared memory name
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_name.size() < 2) || (in_name[0] != '/') || (in_name.find('/', 1) != std::string::npos))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setMosaicSharedMemoryName - Incorrect name: " << in_name << "!";
+    }
+
+    CameraMosaic::getInstance()->setSharedMemoryName(in_name);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the name of the mosaic shared memory
+//-----------------------------------------------------------------------------
+void Camera::getMosaicSharedMemoryName(std::string & out_name) const ///< [out] POSIX shared memory name
+{
+    DEB_MEMBER_FUNCT();
+    out_name = CameraMosaic::getConstInstance()->getSharedMemoryName();
+}
+
+//-----------------------------------------------------------------------------
+/// Get the mosaic size
+//-----------------------------------------------------------------------------
+void Camera::getMosaicSize(int & out_width ,  ///< [out] mosaic width in pixels
+                           int & out_height) const ///< [out] mosaic height in pixels
+{
+    DEB_MEMBER_FUNCT();
+
+    std::size_t width ;
+    std::size_t height;
+
+    CameraMosaic::getConstInstance()->getMosaicSize(width, height);
+
+    out_width  = static_cast<int>(width );
+    out_height = static_cast<int>(height);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of complete mosaic frames and the latest complete frame number
+//-----------------------------------------------------------------------------
+void Camera::getMosaicCompleteFrames(int & out_complete_frames_nb ,  ///< [out] number of complete mosaic frames
+                                     int & out_last_complete_frame) const ///< [out] latest complete frame number (-1 if none)
+{
+    DEB_MEMBER_FUNCT();
+
+    uint64_t complete_frames_nb ;
+    int64_t  last_complete_frame;
+
+    if(!CameraMosaic::getConstInstance()->getCompleteFrames(complete_frames_nb, last_complete_frame))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getMosaicCompleteFrames - The mosaic shared memory is not mapped!";
+    }
+
+    out_complete_frames_nb  = static_cast<int>(complete_frames_nb );
+    out_last_complete_frame = static_cast<int>(last_complete_frame);
+}
+
+//-----------------------------------------------------------------------------
+/// TRANSFER STATISTICS
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Get the reception times of a frame of the current acquisition
+//-----------------------------------------------------------------------------
+void Camera::getFrameReceptionTimes(int      in_frame_nb       , ///< [in]  frame number in the acquisition
+                                    double & out_first_part_time, ///< [out] reception time of the first image part (seconds since the epoch)
+                                    double & out_last_part_time ) const ///< [out] reception time of the last image part (seconds since the epoch)
+{
+    DEB_MEMBER_FUNCT();
+
+    CameraFrameReceptionTimes times;
+
+    if((in_frame_nb < 0) || (!CameraTransferStatistics::getConstInstance()->getFrameReceptionTimes(static_cast<std::size_t>(in_frame_nb), times)))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getFrameReceptionTimes - No data for the frame " << in_frame_nb << "!";
+    }
+
+    out_first_part_time = times.m_first_part_time;
+    out_last_part_time  = times.m_last_part_time ;
+}
+
+//-----------------------------------------------------------------------------
+/// Get the transfer rate statistics of the current acquisition
+//-----------------------------------------------------------------------------
+void Camera::getTransferCounters(CameraTransferCounters & out_counters) const ///< [out] counters
+{
+    DEB_MEMBER_FUNCT();
+    out_counters = CameraTransferStatistics::getConstInstance()->getCounters();
+}
+
+//-----------------------------------------------------------------------------
+/// PACKET DELAY CONTROL
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the adaptation of the delay between two image packets
+//-----------------------------------------------------------------------------
+void Camera::setPacketDelayControl(bool in_enabled) ///< [in] true to adapt the delay during the acquisition
+{
+    DEB_MEMBER_FUNCT();
+    CameraPacketDelayController::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the delay between two image packets is adapted
+//-----------------------------------------------------------------------------
+void Camera::getPacketDelayControl(bool & out_enabled) const ///< [out] true if the delay is adapted
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraPacketDelayController::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the range of the delay between two image packets
+//-----------------------------------------------------------------------------
+void Camera::setPacketDelayRange(int in_min_delay_usec, ///< [in] minimum delay in microseconds
+                                 int in_max_delay_usec) ///< [in] maximum delay in microseconds
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_min_delay_usec < 0) || (in_max_delay_usec > 0xFFFF) ||
+       (!CameraPacketDelayController::getInstance()->setDelayRange(static_cast<uint16_t>(in_min_delay_usec), static_cast<uint16_t>(in_max_delay_usec))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setPacketDelayRange - Incorrect range: " << in_min_delay_usec << " - " << in_max_delay_usec << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the range of the delay between two image packets
+//-----------------------------------------------------------------------------
+void Camera::getPacketDelayRange(int & out_min_delay_usec , ///< [out] minimum delay in microseconds
+                                 int & out_max_delay_usec) const ///< [out] maximum delay in microseconds
+{
+    DEB_MEMBER_FUNCT();
+
+    uint16_t min_delay_usec;
+    uint16_t max_delay_usec;
+
+    CameraPacketDelayController::getConstInstance()->getDelayRange(min_delay_usec, max_delay_usec);
+
+    out_min_delay_usec = static_cast<int>(min_delay_usec);
+    out_max_delay_usec = static_cast<int>(max_delay_usec);
+}
+
+//-----------------------------------------------------------------------------
+/// Set the congestion limits of the packet delay control
+//-----------------------------------------------------------------------------
+void Camera::setPacketDelayLimits(double in_queue_ratio, ///< [in] maximum used ratio of the socket receive buffer
+                                  double in_lag_sec    ) ///< [in] maximum delay between a part reception and its treatment
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_queue_ratio <= 0.0) || (in_queue_ratio > 1.0) || (in_lag_sec <= 0.0))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setPacketDelayLimits - Incorrect limits: " << in_queue_ratio << " - " << in_lag_sec << "!";
+    }
+
+    CameraPacketDelayController::getInstance()->setLimits(in_queue_ratio, in_lag_sec);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the congestion limits of the packet delay control
+//-----------------------------------------------------------------------------
+void Camera::getPacketDelayLimits(double & out_queue_ratio, ///< [out] maximum used ratio of the socket receive buffer
+                                  double & out_lag_sec    ) const ///< [out] maximum delay between a part reception and its treatment
+{
+    DEB_MEMBER_FUNCT();
+    CameraPacketDelayController::getConstInstance()->getLimits(out_queue_ratio, out_lag_sec);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the delay between two image packets currently used by the camera
+//-----------------------------------------------------------------------------
+void Camera::getPacketDelay(int & out_delay_usec) const ///< [out] delay in microseconds
+{
+    DEB_MEMBER_FUNCT();
+
+    uint16_t pixels_per_packet;
+    uint16_t packet_delay_usec;
+
+    CameraPacketDelayController::getConstInstance()->getCurrentSettings(pixels_per_packet, packet_delay_usec);
+    out_delay_usec = static_cast<int>(packet_delay_usec);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the latest values of the socket backlog and reception lag monitor
+//-----------------------------------------------------------------------------
+void Camera::getSocketGauges(CameraSocketGauges & out_gauges) const ///< [out] latest values
+{
+    DEB_MEMBER_FUNCT();
+    out_gauges = CameraSocketMonitor::getConstInstance()->getGauges();
+}
+
+//-----------------------------------------------------------------------------
+/// Get the histograms of the socket backlog and reception lag monitor
+//-----------------------------------------------------------------------------
+void Camera::getSocketHistograms(CameraSocketHistograms & out_histograms) const ///< [out] log2 histograms
+{
+    DEB_MEMBER_FUNCT();
+    out_histograms = CameraSocketMonitor::getConstInstance()->getHistograms();
+}
+
+//-----------------------------------------------------------------------------
+/// Reset the socket backlog and reception lag monitor
+//-----------------------------------------------------------------------------
+void Camera::resetSocketMonitor()
+{
+    DEB_MEMBER_FUNCT();
+    CameraSocketMonitor::getInstance()->reset();
+}
+
+//-----------------------------------------------------------------------------
+/// LOW LATENCY
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Activate or deactivate the low latency mode of the control socket
+//-----------------------------------------------------------------------------
+void Camera::setLowLatencyMode(bool in_enabled) ///< [in] true to activate the low latency mode
+{
+    DEB_MEMBER_FUNCT();
+
+    bool enabled;
+    int  busy_poll_usec;
+    int  spin_window_usec;
+
+    CameraControl::getConstInstance()->getLowLatencyMode(enabled, busy_poll_usec, spin_window_usec);
+    CameraControl::getInstance()->setLowLatencyMode(in_enabled, busy_poll_usec, spin_window_usec);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the low latency mode of the control socket is active
+//-----------------------------------------------------------------------------
+void Camera::getLowLatencyMode(bool & out_enabled) const ///< [out] true if the low latency mode is active
+{
+    DEB_MEMBER_FUNCT();
+
+    int busy_poll_usec;
+    int spin_window_usec;
+
+    CameraControl::getConstInstance()->getLowLatencyMode(out_enabled, busy_poll_usec, spin_window_usec);
+}
+
+//-----------------------------------------------------------------------------
+/// Set the parameters of the low latency mode
+//-----------------------------------------------------------------------------
+void Camera::setLowLatencyParameters(int in_busy_poll_usec  , ///< [in] busy polling delay in microseconds (SO_BUSY_POLL)
+                                     int in_spin_window_usec) ///< [in] spinning reception window after a command in microseconds
+{
+    DEB_MEMBER_FUNCT();
+
+    bool enabled;
+    int  busy_poll_usec;
+    int  spin_window_usec;
+
+    CameraControl::getConstInstance()->getLowLatencyMode(enabled, busy_poll_usec, spin_window_usec);
+
+    if(!CameraControl::getInstance()->setLowLatencyMode(enabled, in_busy_poll_usec, in_spin_window_usec))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setLowLatencyParameters - Incorrect parameters: " << in_busy_poll_usec << " - " << in_spin_window_usec << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the parameters of the low latency mode
+//-----------------------------------------------------------------------------
+void Camera::getLowLatencyParameters(int & out_busy_poll_usec  , ///< [out] busy polling delay in microseconds (SO_BUSY_POLL)
+                                     int & out_spin_window_usec) const ///< [out] spinning reception window after a command in microseconds
+{
+    DEB_MEMBER_FUNCT();
+
+    bool enabled;
+    CameraControl::getConstInstance()->getLowLatencyMode(enabled, out_busy_poll_usec, out_spin_window_usec);
+}
+
+//-----------------------------------------------------------------------------
+/// Measure the command round trip times without and with the low latency mode.
+/// The data update is suspended during the measures and the mode is restored.
+//-----------------------------------------------------------------------------
+void Camera::benchmarkCommandRoundTrip(int                         in_nb_commands , ///< [in] number of commands for each mode
+                                       CameraRoundTripStatistics & out_normal     , ///< [out] round trip times in normal mode
+                                       CameraRoundTripStatistics & out_low_latency) ///< [out] round trip times in low latency mode
+{
+    DEB_MEMBER_FUNCT();
+
+    if(in_nb_commands <= 0)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "benchmarkCommandRoundTrip - Incorrect number of commands: " << in_nb_commands << "!";
+    }
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "benchmarkCommandRoundTrip - The benchmark can not be done during an acquisition!";
+    }
+
+    bool enabled;
+    int  busy_poll_usec;
+    int  spin_window_usec;
+    bool result;
+
+    CameraControl::getConstInstance()->getLowLatencyMode(enabled, busy_poll_usec, spin_window_usec);
+
+    {
+        // the data update thread can not send commands during the measures
+        lima::AutoMutex update_mutex = updateAuthorizeFlagLock();
+
+        CameraControl::getInstance()->setLowLatencyMode(false, busy_poll_usec, spin_window_usec);
+        result = CameraControl::getInstance()->measureCommandRoundTrip(static_cast<std::size_t>(in_nb_commands), out_normal);
+
+        if(result)
+        {
+            CameraControl::getInstance()->setLowLatencyMode(true, busy_poll_usec, spin_window_usec);
+            result = CameraControl::getInstance()->measureCommandRoundTrip(static_cast<std::size_t>(in_nb_commands), out_low_latency);
+        }
+
+        CameraControl::getInstance()->setLowLatencyMode(enabled, busy_poll_usec, spin_window_usec);
+    }
+
+    if(!result)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "benchmarkCommandRoundTrip - Unable to measure the command round trip times!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// FITS WRITER
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the FITS writer stage (used at the next acquisition start)
+//-----------------------------------------------------------------------------
+void Camera::setFitsWriter(bool in_enabled) ///< [in] true to enable the stage
+{
+    DEB_MEMBER_FUNCT();
+    CameraFitsWriter::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the FITS writer stage is enabled
+//-----------------------------------------------------------------------------
+void Camera::getFitsWriter(bool & out_enabled) const ///< [out] true if the stage is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraFitsWriter::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the files organization (used at the next acquisition start)
+//-----------------------------------------------------------------------------
+void Camera::setFitsMode(CameraFitsWriter::Mode in_mode) ///< [in] one file by frame or one multi-extension file by acquisition
+{
+    DEB_MEMBER_FUNCT();
+    CameraFitsWriter::getInstance()->setMode(in_mode);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the files organization
+//-----------------------------------------------------------------------------
+void Camera::getFitsMode(CameraFitsWriter::Mode & out_mode) const ///< [out] one file by frame or one multi-extension file by acquisition
+{
+    DEB_MEMBER_FUNCT();
+    out_mode = CameraFitsWriter::getConstInstance()->getMode();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the directory and prefix of the files (used at the next acquisition start)
+//-----------------------------------------------------------------------------
+void Camera::setFitsPathPrefix(const std::string & in_path_prefix) ///< [in] directory and prefix of the files
+{
+    DEB_MEMBER_FUNCT();
+    CameraFitsWriter::getInstance()->setPathPrefix(in_path_prefix);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the directory and prefix of the files
+//-----------------------------------------------------------------------------
+void Camera::getFitsPathPrefix(std::string & out_path_prefix) const ///< [out] directory and prefix of the files
+{
+    DEB_MEMBER_FUNCT();
+    out_path_prefix = CameraFitsWriter::getConstInstance()->getPathPrefix();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the number of frame buffers of the writing queue (used at the next acquisition start)
+//-----------------------------------------------------------------------------
+void Camera::setFitsBuffersNb(int in_buffers_nb) ///< [in] number of frame buffers
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_buffers_nb <= 0) || (!CameraFitsWriter::getInstance()->setBuffersNb(static_cast<std::size_t>(in_buffers_nb))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setFitsBuffersNb - Incorrect number of buffers: " << in_buffers_nb << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of frame buffers of the writing queue
+//-----------------------------------------------------------------------------
+void Camera::getFitsBuffersNb(int & out_buffers_nb) const ///< [out] number of frame buffers
+{
+    DEB_MEMBER_FUNCT();
+    out_buffers_nb = static_cast<int>(CameraFitsWriter::getConstInstance()->getBuffersNb());
+}
+
+//-----------------------------------------------------------------------------
+/// Get the FITS writer counters of the current or last acquisition
+//-----------------------------------------------------------------------------
+void Camera::getFitsCounters(CameraFitsCounters & out_counters) const ///< [out] counters
+{
+    DEB_MEMBER_FUNCT();
+    out_counters = CameraFitsWriter::getConstInstance()->getCounters();
+}
+
+//-----------------------------------------------------------------------------
+/// HDF5 WRITER
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the HDF5/NeXus writer stage (used at the next acquisition start)
+//-----------------------------------------------------------------------------
+void Camera::setHdf5Writer(bool in_enabled) ///< [in] true to enable the stage
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_enabled) && (!CameraHdf5Writer::isAvailable()))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setHdf5Writer - The plugin was built without the HDF5 support!";
+    }
+
+    CameraHdf5Writer::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the HDF5/NeXus writer stage is enabled
+//-----------------------------------------------------------------------------
+void Camera::getHdf5Writer(bool & out_enabled) const ///< [out] true if the stage is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraHdf5Writer::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the directory and prefix of the files (used at the next acquisition start)
+//-----------------------------------------------------------------------------
+void Camera::setHdf5PathPrefix(const std::string & in_path_prefix) ///< [in] directory and prefix of the files
+{
+    DEB_MEMBER_FUNCT();
+    CameraHdf5Writer::getInstance()->setPathPrefix(in_path_prefix);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the directory and prefix of the files
+//-----------------------------------------------------------------------------
+void Camera::getHdf5PathPrefix(std::string & out_path_prefix) const ///< [out] directory and prefix of the files
+{
+    DEB_MEMBER_FUNCT();
+    out_path_prefix = CameraHdf5Writer::getConstInstance()->getPathPrefix();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the deflate level of the frames chunks (used at the next acquisition start)
+//-----------------------------------------------------------------------------
+void Camera::setHdf5CompressionLevel(int in_compression_level) ///< [in] deflate level (0 for no compression, 1 to 9)
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraHdf5Writer::getInstance()->setCompressionLevel(in_compression_level))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setHdf5CompressionLevel - Incorrect compression level: " << in_compression_level << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the deflate level of the frames chunks
+//-----------------------------------------------------------------------------
+void Camera::getHdf5CompressionLevel(int & out_compression_level) const ///< [out] deflate level (0 for no compression)
+{
+    DEB_MEMBER_FUNCT();
+    out_compression_level = CameraHdf5Writer::getConstInstance()->getCompressionLevel();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the number of frame buffers of the writing queue (used at the next acquisition start)
+//-----------------------------------------------------------------------------
+void Camera::setHdf5BuffersNb(int in_buffers_nb) ///< [in] number of frame buffers
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_buffers_nb <= 0) || (!CameraHdf5Writer::getInstance()->setBuffersNb(static_cast<std::size_t>(in_buffers_nb))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setHdf5BuffersNb - Incorrect number of buffers: " << in_buffers_nb << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of frame buffers of the writing queue
+//-----------------------------------------------------------------------------
+void Camera::getHdf5BuffersNb(int & out_buffers_nb) const ///< [out] number of frame buffers
+{
+    DEB_MEMBER_FUNCT();
+    out_buffers_nb = static_cast<int>(CameraHdf5Writer::getConstInstance()->getBuffersNb());
+}
+
+//-----------------------------------------------------------------------------
+/// Get the HDF5/NeXus writer counters of the current or last acquisition
+//-----------------------------------------------------------------------------
+void Camera::getHdf5Counters(CameraHdf5Counters & out_counters) const ///< [out] counters
+{
+    DEB_MEMBER_FUNCT();
+    out_counters = CameraHdf5Writer::getConstInstance()->getCounters();
+}
+
+//-----------------------------------------------------------------------------
+/// FRAME METADATA
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Get the metadata of a frame of the current or last acquisition
+/// (only the latest frames are kept)
+//-----------------------------------------------------------------------------
+void Camera::getFrameMetadata(int                   in_frame_nb , ///< [in] frame number in the acquisition
+                              CameraFrameMetadata & out_metadata) const ///< [out] frame metadata
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_frame_nb < 0) ||
+       (!CameraFrameMetadataTable::getConstInstance()->getFrameMetadata(static_cast<std::size_t>(in_frame_nb), out_metadata)))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getFrameMetadata - The metadata of the frame " << in_frame_nb << " are not available!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// CAMERA PARAMETERS
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Get the value of a camera parameter (read in the cache, no command is sent)
+//-----------------------------------------------------------------------------
+void Camera::getCameraParameter(const std::string & in_group , ///< [in] parameter group (ex: "Control")
+                                const std::string & in_name  , ///< [in] parameter name (ex: "DSI Sample Time")
+                                std::string       & out_value) const ///< [out] parameter value
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraControl::getConstInstance()->getParameter(in_group, in_name, out_value))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getCameraParameter - Unknown parameter: " << in_group << "," << in_name << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Change the value of a camera parameter
+//-----------------------------------------------------------------------------
+void Camera::setCameraParameter(const std::string & in_group, ///< [in] parameter group (ex: "Control")
+                                const std::string & in_name , ///< [in] parameter name (ex: "DSI Sample Time")
+                                int                 in_value) ///< [in] new value
+{
+    DEB_MEMBER_FUNCT();
+
+    std::vector<CameraParameterChange> changes(1);
+
+    changes[0].m_group = in_group;
+    changes[0].m_name  = in_name ;
+    changes[0].m_value = static_cast<uint32_t>(in_value);
+
+    setCameraParameters(changes);
+}
+
+//-----------------------------------------------------------------------------
+/// Change a batch of camera parameters (the commands are sent without waiting
+/// for the end of the previous ones)
+//-----------------------------------------------------------------------------
+void Camera::setCameraParameters(const std::vector<CameraParameterChange> & in_changes) ///< [in] parameters changes
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setCameraParameters - The camera parameters can not be changed during an acquisition!";
+    }
+
+    if(!CameraControl::getInstance()->setParameters(in_changes))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setCameraParameters - Unable to change the camera parameters!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get all the camera parameters (read in the cache, no command is sent)
+//-----------------------------------------------------------------------------
+void Camera::getCameraParameterTable(std::vector<CameraParameter> & out_parameters) const ///< [out] parameters in the camera order
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraControl::getConstInstance()->getParameterTable(out_parameters))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getCameraParameterTable - The camera parameters are not available!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Read again the complete camera parameters table (changes done by an other software)
+//-----------------------------------------------------------------------------
+void Camera::refreshCameraParameters()
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraControl::getInstance()->updateParameterTable())
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "refreshCameraParameters - Unable to read the camera parameters!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// THROUGHPUT PROFILES
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Declare a readout speed the profiles can choose, with its read noise
+/// (the readout speeds used by the acquisitions are also added automatically)
+//-----------------------------------------------------------------------------
+void Camera::setThroughputCandidate(int    in_readout_speed, ///< [in] readout speed (DSI sample time) setting
+                                    double in_read_noise   ) ///< [in] read noise in electrons (0 if unknown)
+{
+    DEB_MEMBER_FUNCT();
+
+    if(in_readout_speed < 0)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setThroughputCandidate - Incorrect readout speed: " << in_readout_speed << "!";
+    }
+
+    CameraThroughputProfiles::getInstance()->setCandidate(static_cast<uint32_t>(in_readout_speed), in_read_noise);
+}
+
+//-----------------------------------------------------------------------------
+/// Remove all the readout speeds and their measures
+//-----------------------------------------------------------------------------
+void Camera::clearThroughputCandidates()
+{
+    DEB_MEMBER_FUNCT();
+    CameraThroughputProfiles::getInstance()->clearCandidates();
+}
+
+//-----------------------------------------------------------------------------
+/// Get the readout speeds and their measured readout times
+//-----------------------------------------------------------------------------
+void Camera::getThroughputCandidates(std::vector<CameraReadoutCandidate> & out_candidates) const ///< [out] readout speeds
+{
+    DEB_MEMBER_FUNCT();
+    out_candidates = CameraThroughputProfiles::getConstInstance()->getCandidates();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the target frame rate of the TargetFrameRate profile
+//-----------------------------------------------------------------------------
+void Camera::setThroughputTargetFrameRate(double in_frame_rate) ///< [in] frames per second
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraThroughputProfiles::getInstance()->setTargetFrameRate(in_frame_rate))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setThroughputTargetFrameRate - Incorrect frame rate: " << in_frame_rate << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the target frame rate of the TargetFrameRate profile
+//-----------------------------------------------------------------------------
+void Camera::getThroughputTargetFrameRate(double & out_frame_rate) const ///< [out] frames per second
+{
+    DEB_MEMBER_FUNCT();
+    out_frame_rate = CameraThroughputProfiles::getConstInstance()->getTargetFrameRate();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the read noise budget of the NoiseBudget profile
+//-----------------------------------------------------------------------------
+void Camera::setThroughputNoiseBudget(double in_read_noise) ///< [in] maximum read noise in electrons
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraThroughputProfiles::getInstance()->setNoiseBudget(in_read_noise))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setThroughputNoiseBudget - Incorrect read noise: " << in_read_noise << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the read noise budget of the NoiseBudget profile
+//-----------------------------------------------------------------------------
+void Camera::getThroughputNoiseBudget(double & out_read_noise) const ///< [out] maximum read noise in electrons
+{
+    DEB_MEMBER_FUNCT();
+    out_read_noise = CameraThroughputProfiles::getConstInstance()->getNoiseBudget();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the maximum binning the profiles can choose (1 to keep the full resolution)
+//-----------------------------------------------------------------------------
+void Camera::setThroughputMaxBinning(int in_max_binning) ///< [in] maximum binning
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_max_binning <= 0) || (!CameraThroughputProfiles::getInstance()->setMaxBinning(static_cast<std::size_t>(in_max_binning))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setThroughputMaxBinning - Incorrect binning: " << in_max_binning << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the maximum binning the profiles can choose
+//-----------------------------------------------------------------------------
+void Camera::getThroughputMaxBinning(int & out_max_binning) const ///< [out] maximum binning
+{
+    DEB_MEMBER_FUNCT();
+    out_max_binning = static_cast<int>(CameraThroughputProfiles::getConstInstance()->getMaxBinning());
+}
+
+//-----------------------------------------------------------------------------
+/// Set the packets settings of the frame rate and noise profiles
+//-----------------------------------------------------------------------------
+void Camera::setThroughputPacketSettings(const CameraPacketSettings & in_fast , ///< [in] packets of the MaximumFrameRate and TargetFrameRate profiles
+                                         const CameraPacketSettings & in_quiet) ///< [in] packets of the MinimumNoise and NoiseBudget profiles
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_fast.m_pixels_per_packet == 0) || (in_quiet.m_pixels_per_packet == 0))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setThroughputPacketSettings - Incorrect number of pixels per packet!";
+    }
+
+    CameraThroughputProfiles::getInstance()->setPacketSettings(in_fast, in_quiet);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the packets settings of the frame rate and noise profiles
+//-----------------------------------------------------------------------------
+void Camera::getThroughputPacketSettings(CameraPacketSettings & out_fast , ///< [out] packets of the MaximumFrameRate and TargetFrameRate profiles
+                                         CameraPacketSettings & out_quiet) const ///< [out] packets of the MinimumNoise and NoiseBudget profiles
+{
+    DEB_MEMBER_FUNCT();
+    CameraThroughputProfiles::getConstInstance()->getPacketSettings(out_fast, out_quiet);
+}
+
+//-----------------------------------------------------------------------------
+/// Choose the settings of a profile for the current exposure time and ROI
+/// (nothing is sent to the camera)
+//-----------------------------------------------------------------------------
+void Camera::chooseThroughputProfile(CameraThroughputProfiles::Profile in_profile, ///< [in] profile
+                                     CameraThroughputChoice          & out_choice) const ///< [out] chosen settings
+{
+    DEB_MEMBER_FUNCT();
+
+    const CameraControl * control = CameraControl::getConstInstance();
+
+    if(!CameraThroughputProfiles::getConstInstance()->choose(in_profile,
+                                                             static_cast<double>(control->getExposureTimeMsec()) / 1000.0,
+                                                             control->getSerialLength  (),
+                                                             control->getParallelLength(),
+                                                             out_choice))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "chooseThroughputProfile - No settings respect the profile " << (int)in_profile 
+                                         << " (acquire frames with each readout speed to measure them)!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Choose and apply the settings of a profile. The readout speed and packets
+/// settings are sent to the camera; the binning must be set through LIMA
+/// (it changes the image size).
+//-----------------------------------------------------------------------------
+void Camera::applyThroughputProfile(CameraThroughputProfiles::Profile in_profile, ///< [in] profile
+                                    CameraThroughputChoice          & out_choice) ///< [out] applied settings
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "applyThroughputProfile - A profile can not be applied during an acquisition!";
+    }
+
+    chooseThroughputProfile(in_profile, out_choice);
+
+    {
+        // the data update thread can not send commands during the changes
+        lima::AutoMutex update_mutex = updateAuthorizeFlagLock();
+
+        if(!CameraControl::getInstance()->setReadoutSpeedValue(out_choice.m_readout_speed))
+        {
+            THROW_HW_ERROR(ErrorType::Error) << "applyThroughputProfile - Unable to change the readout speed to " << out_choice.m_readout_speed << "!";
+        }
+
+        if(!CameraControl::getInstance()->configurePackets(out_choice.m_packets.m_pixels_per_packet, out_choice.m_packets.m_packet_delay_usec))
+        {
+            THROW_HW_ERROR(ErrorType::Error) << "applyThroughputProfile - Unable to change the packets settings!";
+        }
+
+        // the packet delay controller starts from the new settings
+        CameraPacketDelayController::getInstance()->setInitialSettings(out_choice.m_packets.m_pixels_per_packet, out_choice.m_packets.m_packet_delay_usec);
+    }
+
+    if((CameraControl::getConstInstance()->getSerialBinning  () != out_choice.m_binning) ||
+       (CameraControl::getConstInstance()->getParallelBinning() != out_choice.m_binning))
+    {
+        DEB_WARNING() << "applyThroughputProfile - the profile needs a " << out_choice.m_binning << "x" << out_choice.m_binning 
+                      << " binning which must be set through LIMA.";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// EXPERIMENT PRESETS
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Set the directory of the presets files
+//-----------------------------------------------------------------------------
+void Camera::setPresetDirectory(const std::string & in_directory) ///< [in] directory
+{
+    DEB_MEMBER_FUNCT();
+    CameraPresetLibrary::getInstance()->setDirectory(in_directory);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the directory of the presets files
+//-----------------------------------------------------------------------------
+void Camera::getPresetDirectory(std::string & out_directory) const ///< [out] directory
+{
+    DEB_MEMBER_FUNCT();
+    out_directory = CameraPresetLibrary::getConstInstance()->getDirectory();
+}
+
+//-----------------------------------------------------------------------------
+/// Save the current settings (ROI, binning, exposure, trigger mode, readout
+/// speed, cooling, packets and processing stages) as a named preset
+//-----------------------------------------------------------------------------
+void Camera::savePreset(const std::string & in_name) ///< [in] preset name
+{
+    DEB_MEMBER_FUNCT();
+
+    CameraPreset preset;
+
+    preset.m_name            = in_name;
+    preset.m_trigger_mode    = static_cast<int>(m_trigger_mode);
+    preset.m_bad_pixel_map   = CameraBadPixelMap::getConstInstance()->isEnabled();
+    preset.m_change_detector = CameraFrameChangeDetector::getConstInstance()->isEnabled();
+    preset.m_mosaic          = CameraMosaic::getConstInstance()->isEnabled();
+    preset.m_fits_writer     = CameraFitsWriter::getConstInstance()->isEnabled();
+    preset.m_hdf5_writer     = CameraHdf5Writer::getConstInstance()->isEnabled();
+
+    CameraControl::getConstInstance()->getHardwareSettings(preset.m_hardware);
+
+    if(!CameraPresetLibrary::getInstance()->save(preset))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "savePreset - Unable to save the preset " << in_name << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the names of the stored presets
+//-----------------------------------------------------------------------------
+void Camera::getPresetNames(std::vector<std::string> & out_names) const ///< [out] presets names
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraPresetLibrary::getConstInstance()->getNames(out_names))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getPresetNames - Unable to read the presets directory!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Delete a stored preset
+//-----------------------------------------------------------------------------
+void Camera::removePreset(const std::string & in_name) ///< [in] preset name
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraPresetLibrary::getInstance()->remove(in_name))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "removePreset - Unable to delete the preset " << in_name << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Apply a stored preset. Only the camera settings which differ from the
+/// current ones are sent, in one pipelined commands batch. The ROI, binning,
+/// exposure time and trigger mode are kept by LIMA, so they are not sent: they
+/// are given to the caller which applies them through the LIMA controls.
+//-----------------------------------------------------------------------------
+void Camera::applyPreset(const std::string        & in_name           , ///< [in] preset name
+                         CameraPresetLimaSettings & out_lima_settings , ///< [out] settings to apply through LIMA
+                         double                   & out_apply_time_sec, ///< [out] duration of the apply in seconds
+                         int                      & out_commands_nb   ) ///< [out] number of commands sent to the camera
+{
+    DEB_MEMBER_FUNCT();
+
+    CameraPreset    preset         ;
+    std::size_t     commands_nb = 0;
+    struct timespec start_time     ;
+    struct timespec end_time       ;
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "applyPreset - A preset can not be applied during an acquisition!";
+    }
+
+    if(!CameraPresetLibrary::getConstInstance()->load(in_name, preset))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "applyPreset - Unable to load the preset " << in_name << "!";
+    }
+
+    // the local settings are checked before sending the first command
+    if(!checkTrigMode(static_cast<TrigMode>(preset.m_trigger_mode)))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "applyPreset - The trigger mode " << preset.m_trigger_mode << " is not managed!";
+    }
+
+    if((preset.m_hdf5_writer) && (!CameraHdf5Writer::isAvailable()))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "applyPreset - The plugin was built without the HDF5 support!";
+    }
+
+    clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+    {
+        // the data update thread can not send commands during the changes
+        lima::AutoMutex update_mutex = updateAuthorizeFlagLock();
+
+        if(!CameraControl::getInstance()->setHardwareSettings(preset.m_hardware, commands_nb))
+        {
+            THROW_HW_ERROR(ErrorType::Error) << "applyPreset - The camera refused the settings of the preset " << in_name << "!";
+        }
+
+        // the packet delay controller starts from the new settings
+        CameraPacketDelayController::getInstance()->setInitialSettings(preset.m_hardware.m_pixels_per_packet, preset.m_hardware.m_packet_delay_usec);
+    }
+
+    CameraBadPixelMap::getInstance()->setEnabled(preset.m_bad_pixel_map);
+    CameraFrameChangeDetector::getInstance()->setEnabled(preset.m_change_detector);
+    CameraMosaic::getInstance()->setEnabled(preset.m_mosaic);
+    CameraFitsWriter::getInstance()->setEnabled(preset.m_fits_writer);
+    CameraHdf5Writer::getInstance()->setEnabled(preset.m_hdf5_writer);
+
+    clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+    // the ROI and the binning are given in the frame orientation
+    {
+        const CameraFrameTransform & transform = CameraFrameProcessing::getConstInstance()->getTransform();
+
+        std::size_t source_width ;
+        std::size_t source_height;
+        std::size_t x, y, width, height;
+
+        getSourceFullFrameSize(source_width, source_height);
+
+        transform.transformRect(preset.m_hardware.m_serial_origin, preset.m_hardware.m_parallel_origin,
+                                preset.m_hardware.m_serial_length, preset.m_hardware.m_parallel_length,
+                                source_width, source_height, x, y, width, height);
+
+        out_lima_settings.m_roi = Roi(static_cast<int>(x), static_cast<int>(y), static_cast<int>(width), static_cast<int>(height));
+
+        if(transform.swapsAxes())
+        {
+            out_lima_settings.m_bin = Bin(static_cast<int>(preset.m_hardware.m_parallel_binning), static_cast<int>(preset.m_hardware.m_serial_binning));
+        }
+        else
+        {
+            out_lima_settings.m_bin = Bin(static_cast<int>(preset.m_hardware.m_serial_binning), static_cast<int>(preset.m_hardware.m_parallel_binning));
+        }
+
+        out_lima_settings.m_exposure_sec = static_cast<double>(preset.m_hardware.m_exposure_time_msec) / 1000.0;
+        out_lima_settings.m_trigger_mode = static_cast<TrigMode>(preset.m_trigger_mode);
+    }
+
+    out_apply_time_sec = static_cast<double>(end_time.tv_sec  - start_time.tv_sec ) +
+                         static_cast<double>(end_time.tv_nsec - start_time.tv_nsec) / 1000000000.0;
+    out_commands_nb    = static_cast<int>(commands_nb);
+
+    DEB_TRACE() << "applyPreset - preset " << in_name << " applied in " << out_apply_time_sec 
+                << " s (" << commands_nb << " commands).";
+}
+
+//-----------------------------------------------------------------------------
+/// PROGRESSIVE ROW BANDS
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Register a listener of the completed row bands (owned by the caller and
+/// called by the acquisition thread, from the next frame)
+//-----------------------------------------------------------------------------
+void Camera::addRowBandListener(CameraRowBandListener * in_listener) ///< [in] listener to add
+{
+    DEB_MEMBER_FUNCT();
+
+    if(in_listener == NULL)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "addRowBandListener - Incorrect listener!";
+    }
+
+    CameraRowBandNotifier::getInstance()->addListener(in_listener);
+}
+
+//-----------------------------------------------------------------------------
+/// Unregister a listener of the completed row bands (it is not called anymore
+/// when this method returns)
+//-----------------------------------------------------------------------------
+void Camera::removeRowBandListener(CameraRowBandListener * in_listener) ///< [in] listener to remove
+{
+    DEB_MEMBER_FUNCT();
+    CameraRowBandNotifier::getInstance()->removeListener(in_listener);
+}
+
+//-----------------------------------------------------------------------------
+/// Set the minimum number of rows of a band
+//-----------------------------------------------------------------------------
+void Camera::setRowBandRows(int in_band_rows) ///< [in] number of rows (at least 1)
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_band_rows <= 0) || (!CameraRowBandNotifier::getInstance()->setBandRows(static_cast<std::size_t>(in_band_rows))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setRowBandRows - Incorrect number of rows: " << in_band_rows << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the minimum number of rows of a band
+//-----------------------------------------------------------------------------
+void Camera::getRowBandRows(int & out_band_rows) const ///< [out] number of rows
+{
+    DEB_MEMBER_FUNCT();
+    out_band_rows = static_cast<int>(CameraRowBandNotifier::getConstInstance()->getBandRows());
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of bands given to the listeners
+//-----------------------------------------------------------------------------
+void Camera::getRowBandsNb(int & out_bands_nb) const ///< [out] number of bands
+{
+    DEB_MEMBER_FUNCT();
+    out_bands_nb = static_cast<int>(CameraRowBandNotifier::getConstInstance()->getBandsNb());
+}
+
+//-----------------------------------------------------------------------------
+/// PARALLEL DECODING
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Set the number of threads which decode the image parts (0 to decode them
+/// in the acquisition thread)
+//-----------------------------------------------------------------------------
+void Camera::setDecodeThreadsNb(int in_threads_nb) ///< [in] number of threads
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setDecodeThreadsNb - The decoding threads can not be changed during an acquisition!";
+    }
+
+    if((in_threads_nb < 0) || (!CameraDecodePool::getInstance()->setThreadsNb(static_cast<std::size_t>(in_threads_nb))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setDecodeThreadsNb - Incorrect number of threads: " << in_threads_nb << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of threads which decode the image parts
+//-----------------------------------------------------------------------------
+void Camera::getDecodeThreadsNb(int & out_threads_nb) const ///< [out] number of threads
+{
+    DEB_MEMBER_FUNCT();
+    out_threads_nb = static_cast<int>(CameraDecodePool::getConstInstance()->getThreadsNb());
+}
+
+//-----------------------------------------------------------------------------
+/// Set the number of image parts given at once to a decoding thread
+//-----------------------------------------------------------------------------
+void Camera::setDecodeBatchSize(int in_batch_size) ///< [in] number of image parts (at least 1)
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_batch_size <= 0) || (!CameraDecodePool::getInstance()->setBatchSize(static_cast<std::size_t>(in_batch_size))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setDecodeBatchSize - Incorrect batch size: " << in_batch_size << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of image parts given at once to a decoding thread
+//-----------------------------------------------------------------------------
+void Camera::getDecodeBatchSize(int & out_batch_size) const ///< [out] number of image parts
+{
+    DEB_MEMBER_FUNCT();
+    out_batch_size = static_cast<int>(CameraDecodePool::getConstInstance()->getBatchSize());
+}
+
+//-----------------------------------------------------------------------------
+/// Measure the decoding throughput of a synthetic frame from 1 to N threads
+//-----------------------------------------------------------------------------
+void Camera::measureDecodeScaling(int                                in_max_threads_nb , ///< [in] maximum number of threads
+                                  int                                in_width          , ///< [in] frame width in pixels
+                                  int                                in_height         , ///< [in] frame height in pixels
+                                  int                                in_pixels_per_part, ///< [in] number of pixels of an image part
+                                  std::vector<CameraDecodeScaling> & out_results       ) ///< [out] throughput of each number of threads
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "measureDecodeScaling - The decoding can not be measured during an acquisition!";
+    }
+
+    if((in_max_threads_nb <= 0) || (in_width <= 0) || (in_height <= 0) || (in_pixels_per_part <= 0) ||
+       (!CameraDecodePool::getInstance()->measureScaling(static_cast<std::size_t>(in_max_threads_nb ),
+                                                         static_cast<std::size_t>(in_width          ),
+                                                         static_cast<std::size_t>(in_height         ),
+                                                         static_cast<std::size_t>(in_pixels_per_part),
+                                                         out_results                                 )))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "measureDecodeScaling - The measure failed!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// LONG RUNS MONITORING
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the sampling of the resources and latencies
+//-----------------------------------------------------------------------------
+void Camera::setSoakMonitorEnabled(bool in_enabled) ///< [in] true to enable the sampling
+{
+    DEB_MEMBER_FUNCT();
+    CameraSoakMonitor::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the sampling of the resources and latencies is enabled
+//-----------------------------------------------------------------------------
+void Camera::getSoakMonitorEnabled(bool & out_enabled) const ///< [out] true if the sampling is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraSoakMonitor::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Remove the samples and restart the monitoring time
+//-----------------------------------------------------------------------------
+void Camera::resetSoakMonitor()
+{
+    DEB_MEMBER_FUNCT();
+    CameraSoakMonitor::getInstance()->reset();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the interval between two samples
+//-----------------------------------------------------------------------------
+void Camera::setSoakSampleIntervalSec(double in_interval_sec) ///< [in] interval in seconds
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraSoakMonitor::getInstance()->setSampleIntervalSec(in_interval_sec))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setSoakSampleIntervalSec - Incorrect interval: " << in_interval_sec << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the interval between two samples
+//-----------------------------------------------------------------------------
+void Camera::getSoakSampleIntervalSec(double & out_interval_sec) const ///< [out] interval in seconds
+{
+    DEB_MEMBER_FUNCT();
+    out_interval_sec = CameraSoakMonitor::getConstInstance()->getSampleIntervalSec();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the detection thresholds of the resources growth and latencies drift
+//-----------------------------------------------------------------------------
+void Camera::setSoakThresholds(double in_growth_ratio, ///< [in] relative growth of a resource (0.1 for 10%)
+                               double in_drift_ratio ) ///< [in] relative increase of a latency (0.25 for 25%)
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraSoakMonitor::getInstance()->setThresholds(in_growth_ratio, in_drift_ratio))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setSoakThresholds - Incorrect thresholds: " << in_growth_ratio << ", " << in_drift_ratio << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the detection thresholds of the resources growth and latencies drift
+//-----------------------------------------------------------------------------
+void Camera::getSoakThresholds(double & out_growth_ratio, ///< [out] relative growth of a resource
+                               double & out_drift_ratio ) const ///< [out] relative increase of a latency
+{
+    DEB_MEMBER_FUNCT();
+    CameraSoakMonitor::getConstInstance()->getThresholds(out_growth_ratio, out_drift_ratio);
+}
+
+//-----------------------------------------------------------------------------
+/// Get a copy of the samples
+//-----------------------------------------------------------------------------
+void Camera::getSoakSamples(std::vector<CameraSoakSample> & out_samples) const ///< [out] samples in the time order
+{
+    DEB_MEMBER_FUNCT();
+    CameraSoakMonitor::getConstInstance()->getSamples(out_samples);
+}
+
+//-----------------------------------------------------------------------------
+/// Analyse the sampled series
+//-----------------------------------------------------------------------------
+void Camera::analyzeSoakDrifts(std::vector<CameraSoakDrift> & out_drifts , ///< [out] analysis of each series
+                               bool                         & out_flagged) const ///< [out] true if a growth or a drift is detected
+{
+    DEB_MEMBER_FUNCT();
+
+    out_flagged = CameraSoakMonitor::getConstInstance()->analyze(out_drifts);
+
+    for(std::size_t drift_index = 0 ; drift_index < out_drifts.size() ; drift_index++)
+    {
+        if(out_drifts[drift_index].m_flagged)
+        {
+            DEB_WARNING() << "analyzeSoakDrifts - " << CameraSoakMonitor::getSeriesName(out_drifts[drift_index].m_series)
+                          << " drifts from " << out_drifts[drift_index].m_start_value << " to " << out_drifts[drift_index].m_end_value
+                          << " (" << out_drifts[drift_index].m_slope_per_hour << " per hour)";
+        }
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Write the samples into a CSV file
+//-----------------------------------------------------------------------------
+void Camera::writeSoakSamples(const std::string & in_file_name) const ///< [in] complete file name
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraSoakMonitor::getConstInstance()->writeSamples(in_file_name))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "writeSoakSamples - Can not write the file " << in_file_name << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// VIRTUAL TIME
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Set the time scale of the plugin clock (1 for the real time, N to run N times faster)
+/// The fake server must use the same scale.
+//-----------------------------------------------------------------------------
+void Camera::setVirtualTimeScale(double in_time_scale) ///< [in] virtual seconds per real second
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setVirtualTimeScale - The time scale can not be changed during an acquisition!";
+    }
+
+    if(!CameraClock::getInstance()->setTimeScale(in_time_scale))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setVirtualTimeScale - Incorrect time scale: " << in_time_scale << "!";
+    }
+
+    // the packets timeouts are system delays
+    CameraControl::getInstance()->updateWaitPacketTimeout();
+}
+
+//-----------------------------------------------------------------------------
+/// Get the time scale of the plugin clock
+//-----------------------------------------------------------------------------
+void Camera::getVirtualTimeScale(double & out_time_scale) const ///< [out] virtual seconds per real second
+{
+    DEB_MEMBER_FUNCT();
+    out_time_scale = CameraClock::getConstInstance()->getTimeScale();
+}
+
+//-----------------------------------------------------------------------------
+/// PHOTON TRANSFER
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Start a new series: each next acquisition is a step (flat or dark following
+/// the acquisition type, at the current exposure time)
+//-----------------------------------------------------------------------------
+void Camera::startPhotonTransferSeries()
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "startPhotonTransferSeries - The series can not be started during an acquisition!";
+    }
+
+    CameraPhotonTransfer::getInstance()->startSeries();
+}
+
+//-----------------------------------------------------------------------------
+/// Stop the series (the accumulated data are kept for the maps)
+//-----------------------------------------------------------------------------
+void Camera::stopPhotonTransferSeries()
+{
+    DEB_MEMBER_FUNCT();
+    CameraPhotonTransfer::getInstance()->stopSeries();
+}
+
+//-----------------------------------------------------------------------------
+/// Check if a series is running
+//-----------------------------------------------------------------------------
+void Camera::isPhotonTransferSeriesRunning(bool & out_running) const ///< [out] true if the next acquisitions are accumulated
+{
+    DEB_MEMBER_FUNCT();
+    out_running = CameraPhotonTransfer::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the number of threads which help the acquisition thread to accumulate
+/// the frames (0 to accumulate them in the acquisition thread)
+//-----------------------------------------------------------------------------
+void Camera::setPhotonTransferThreadsNb(int in_threads_nb) ///< [in] number of threads
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setPhotonTransferThreadsNb - The threads can not be changed during an acquisition!";
+    }
+
+    if((in_threads_nb < 0) || (!CameraPhotonTransfer::getInstance()->setThreadsNb(static_cast<std::size_t>(in_threads_nb))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setPhotonTransferThreadsNb - Incorrect number of threads: " << in_threads_nb << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of threads which help the acquisition thread to accumulate the frames
+//-----------------------------------------------------------------------------
+void Camera::getPhotonTransferThreadsNb(int & out_threads_nb) const ///< [out] number of threads
+{
+    DEB_MEMBER_FUNCT();
+    out_threads_nb = static_cast<int>(CameraPhotonTransfer::getConstInstance()->getThreadsNb());
+}
+
+//-----------------------------------------------------------------------------
+/// Get the points of the photon transfer curve (one by acquisition of the series)
+//-----------------------------------------------------------------------------
+void Camera::getPhotonTransferSteps(std::vector<CameraPhotonTransferStep> & out_steps) const ///< [out] points in the acquisitions order
+{
+    DEB_MEMBER_FUNCT();
+    CameraPhotonTransfer::getConstInstance()->getSteps(out_steps);
+}
+
+//-----------------------------------------------------------------------------
+/// Compute the gain, read noise and nonlinearity maps of the series
+//-----------------------------------------------------------------------------
+void Camera::computePhotonTransferMaps(CameraPhotonTransferMaps & out_maps) const ///< [out] per pixel maps and their medians
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraPhotonTransfer::getConstInstance()->computeMaps(out_maps))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "computePhotonTransferMaps - The series needs at least two flat acquisitions!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// LUT CORRECTION
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the linearity correction and ADU to electrons conversion stage
+//-----------------------------------------------------------------------------
+void Camera::setLutCorrection(bool in_enabled) ///< [in] true to enable the stage
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setLutCorrection - The correction can not be changed during an acquisition!";
+    }
+
+    CameraLutCorrection::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the linearity correction stage is enabled
+//-----------------------------------------------------------------------------
+void Camera::getLutCorrection(bool & out_enabled) const ///< [out] true if the stage is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraLutCorrection::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the linearity polynomial of the raw ADU (replaces a loaded table file)
+//-----------------------------------------------------------------------------
+void Camera::setLutPolynomial(const std::vector<double> & in_coefficients) ///< [in] 1 to 4 coefficients, constant first
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraLutCorrection::getInstance()->setPolynomial(in_coefficients))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setLutPolynomial - Incorrect number of coefficients: " << in_coefficients.size() << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Load the linearity table of the camera (one "adu value" knot per line)
+//-----------------------------------------------------------------------------
+void Camera::loadLutTable(const std::string & in_file_name) ///< [in] complete path of the file
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraLutCorrection::getInstance()->loadTable(in_file_name))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "loadLutTable - Unable to load the file " << in_file_name << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Set the gain applied after the linearity (1 to keep linearized ADU)
+//-----------------------------------------------------------------------------
+void Camera::setLutGain(double in_gain) ///< [in] gain in e-/ADU
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraLutCorrection::getInstance()->setGain(in_gain))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setLutGain - Incorrect gain: " << in_gain << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the gain applied after the linearity
+//-----------------------------------------------------------------------------
+void Camera::getLutGain(double & out_gain) const ///< [out] gain in e-/ADU
+{
+    DEB_MEMBER_FUNCT();
+    out_gain = CameraLutCorrection::getConstInstance()->getGain();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the output of the corrected values (scaled into the frame or float frames)
+//-----------------------------------------------------------------------------
+void Camera::setLutOutput(CameraLutCorrection::Output in_output) ///< [in] new output
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setLutOutput - The output can not be changed during an acquisition!";
+    }
+
+    CameraLutCorrection::getInstance()->setOutput(in_output);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the output of the corrected values
+//-----------------------------------------------------------------------------
+void Camera::getLutOutput(CameraLutCorrection::Output & out_output) const ///< [out] current output
+{
+    DEB_MEMBER_FUNCT();
+    out_output = CameraLutCorrection::getConstInstance()->getOutput();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the scale of the 16 bits output (the scaled values are clamped to 0..65535)
+//-----------------------------------------------------------------------------
+void Camera::setLutScale(double in_scale) ///< [in] output units per corrected unit
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraLutCorrection::getInstance()->setScale(in_scale))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setLutScale - Incorrect scale: " << in_scale << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the scale of the 16 bits output
+//-----------------------------------------------------------------------------
+void Camera::getLutScale(double & out_scale) const ///< [out] output units per corrected unit
+{
+    DEB_MEMBER_FUNCT();
+    out_scale = CameraLutCorrection::getConstInstance()->getScale();
+}
+
+//-----------------------------------------------------------------------------
+/// Get a float frame of the current acquisition (float output only, the last
+/// frames are kept)
+//-----------------------------------------------------------------------------
+void Camera::getLutFloatFrame(int                  in_frame_nb, ///< [in] frame number in the acquisition
+                              std::vector<float> & out_frame  ) const ///< [out] corrected values
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_frame_nb < 0) || (!CameraLutCorrection::getConstInstance()->getFloatFrame(static_cast<std::size_t>(in_frame_nb), out_frame)))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getLutFloatFrame - The float frame " << in_frame_nb << " is not available!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// FRAME STACKING
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the stacking of the frames with drift registration
+//-----------------------------------------------------------------------------
+void Camera::setFrameStacking(bool in_enabled) ///< [in] true to enable the stage
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setFrameStacking - The stacking can not be changed during an acquisition!";
+    }
+
+    CameraFrameStacker::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the stacking stage is enabled
+//-----------------------------------------------------------------------------
+void Camera::getFrameStacking(bool & out_enabled) const ///< [out] true if the stage is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraFrameStacker::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the downsampling factor of the registration (used from the next acquisition)
+//-----------------------------------------------------------------------------
+void Camera::setStackDownsampling(int in_factor) ///< [in] size of the averaged blocks (1 for no downsampling)
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_factor <= 0) || (!CameraFrameStacker::getInstance()->setDownsampling(static_cast<std::size_t>(in_factor))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setStackDownsampling - Incorrect downsampling factor: " << in_factor << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the downsampling factor of the registration
+//-----------------------------------------------------------------------------
+void Camera::getStackDownsampling(int & out_factor) const ///< [out] size of the averaged blocks
+{
+    DEB_MEMBER_FUNCT();
+    out_factor = static_cast<int>(CameraFrameStacker::getConstInstance()->getDownsampling());
+}
+
+//-----------------------------------------------------------------------------
+/// Set the interpolation of the shifted frames (used from the next acquisition)
+//-----------------------------------------------------------------------------
+void Camera::setStackInterpolation(CameraFrameStacker::Interpolation in_interpolation) ///< [in] new interpolation
+{
+    DEB_MEMBER_FUNCT();
+    CameraFrameStacker::getInstance()->setInterpolation(in_interpolation);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the interpolation of the shifted frames
+//-----------------------------------------------------------------------------
+void Camera::getStackInterpolation(CameraFrameStacker::Interpolation & out_interpolation) const ///< [out] current interpolation
+{
+    DEB_MEMBER_FUNCT();
+    out_interpolation = CameraFrameStacker::getConstInstance()->getInterpolation();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the number of stacking threads
+//-----------------------------------------------------------------------------
+void Camera::setStackThreadsNb(int in_threads_nb) ///< [in] number of threads
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setStackThreadsNb - The threads can not be changed during an acquisition!";
+    }
+
+    if((in_threads_nb <= 0) || (!CameraFrameStacker::getInstance()->setThreadsNb(static_cast<std::size_t>(in_threads_nb))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setStackThreadsNb - Incorrect number of threads: " << in_threads_nb << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of stacking threads
+//-----------------------------------------------------------------------------
+void Camera::getStackThreadsNb(int & out_threads_nb) const ///< [out] number of threads
+{
+    DEB_MEMBER_FUNCT();
+    out_threads_nb = static_cast<int>(CameraFrameStacker::getConstInstance()->getThreadsNb());
+}
+
+//-----------------------------------------------------------------------------
+/// Get the stacking counters of the acquisition
+//-----------------------------------------------------------------------------
+void Camera::getStackCounters(CameraStackCounters & out_counters) const ///< [out] counters copy
+{
+    DEB_MEMBER_FUNCT();
+    out_counters = CameraFrameStacker::getConstInstance()->getCounters();
+}
+
+//-----------------------------------------------------------------------------
+/// Get the measured drift of the stacked frames against the reference frame
+//-----------------------------------------------------------------------------
+void Camera::getStackShifts(std::vector<CameraStackShift> & out_shifts) const ///< [out] shifts in the frames order
+{
+    DEB_MEMBER_FUNCT();
+    CameraFrameStacker::getConstInstance()->getShifts(out_shifts);
+}
+
+//-----------------------------------------------------------------------------
+/// Get a copy of the stack of the acquisition (sum and coverage of each pixel)
+//-----------------------------------------------------------------------------
+void Camera::getFrameStack(CameraStackImage & out_stack) const ///< [out] stack copy
+{
+    DEB_MEMBER_FUNCT();
+    CameraFrameStacker::getConstInstance()->getStack(out_stack);
+}
+
+//-----------------------------------------------------------------------------
+/// AZIMUTHAL INTEGRATION
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the reduction of the frames to radial profiles
+//-----------------------------------------------------------------------------
+void Camera::setAzimuthalIntegration(bool in_enabled) ///< [in] true to enable the stage
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setAzimuthalIntegration - The integration can not be changed during an acquisition!";
+    }
+
+    CameraAzimuthalIntegrator::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the azimuthal integration stage is enabled
+//-----------------------------------------------------------------------------
+void Camera::getAzimuthalIntegration(bool & out_enabled) const ///< [out] true if the stage is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraAzimuthalIntegrator::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the geometry of the experiment and the binning of the profiles
+/// (the pixel to bin matrix is built at the next acquisition)
+//-----------------------------------------------------------------------------
+void Camera::setIntegrationGeometry(const CameraIntegrationGeometry & in_geometry) ///< [in] new geometry
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setIntegrationGeometry - The geometry can not be changed during an acquisition!";
+    }
+
+    if(!CameraAzimuthalIntegrator::getInstance()->setGeometry(in_geometry))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setIntegrationGeometry - Incorrect geometry!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the geometry of the experiment and the binning of the profiles
+//-----------------------------------------------------------------------------
+void Camera::getIntegrationGeometry(CameraIntegrationGeometry & out_geometry) const ///< [out] current geometry
+{
+    DEB_MEMBER_FUNCT();
+    out_geometry = CameraAzimuthalIntegrator::getConstInstance()->getGeometry();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the number of threads which help the acquisition thread to integrate
+/// the frames (0 to integrate them in the acquisition thread)
+//-----------------------------------------------------------------------------
+void Camera::setIntegrationThreadsNb(int in_threads_nb) ///< [in] number of threads
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setIntegrationThreadsNb - The threads can not be changed during an acquisition!";
+    }
+
+    if((in_threads_nb < 0) || (!CameraAzimuthalIntegrator::getInstance()->setThreadsNb(static_cast<std::size_t>(in_threads_nb))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setIntegrationThreadsNb - Incorrect number of threads: " << in_threads_nb << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of threads which help the acquisition thread to integrate the frames
+//-----------------------------------------------------------------------------
+void Camera::getIntegrationThreadsNb(int & out_threads_nb) const ///< [out] number of threads
+{
+    DEB_MEMBER_FUNCT();
+    out_threads_nb = static_cast<int>(CameraAzimuthalIntegrator::getConstInstance()->getThreadsNb());
+}
+
+//-----------------------------------------------------------------------------
+/// Get the number of non null elements of the pixel to bin matrix
+//-----------------------------------------------------------------------------
+void Camera::getIntegrationMatrixSize(int & out_elements_nb) const ///< [out] number of elements (0 before the first acquisition)
+{
+    DEB_MEMBER_FUNCT();
+    out_elements_nb = static_cast<int>(CameraAzimuthalIntegrator::getConstInstance()->getMatrixSize());
+}
+
+//-----------------------------------------------------------------------------
+/// Get the radial profile of a frame of the current acquisition (the last
+/// profiles are kept)
+//-----------------------------------------------------------------------------
+void Camera::getRadialProfile(int                   in_frame_nb, ///< [in] frame number in the acquisition
+                              CameraRadialProfile & out_profile) const ///< [out] profile and variance of the frame
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_frame_nb < 0) || (!CameraAzimuthalIntegrator::getConstInstance()->getProfile(static_cast<std::size_t>(in_frame_nb), out_profile)))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getRadialProfile - The profile of the frame " << in_frame_nb << " is not available!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the radial profile of the last integrated frame
+//-----------------------------------------------------------------------------
+void Camera::getLastRadialProfile(CameraRadialProfile & out_profile) const ///< [out] profile and variance of the frame
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraAzimuthalIntegrator::getConstInstance()->getLastProfile(out_profile))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getLastRadialProfile - No frame was integrated in the acquisition!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// ROI COUNTERS
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the computation of the ROI counters during the frame assembly
+//-----------------------------------------------------------------------------
+void Camera::setRoiCounters(bool in_enabled) ///< [in] true to compute the counters
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setRoiCounters - The ROI counters can not be changed during an acquisition!";
+    }
+
+    CameraRoiCounterTable::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the ROI counters are computed
+//-----------------------------------------------------------------------------
+void Camera::getRoiCounters(bool & out_enabled) const ///< [out] true if the counters are computed
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraRoiCounterTable::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the ROIs of the counters (rectangles or masks in the frame given to Lima)
+//-----------------------------------------------------------------------------
+void Camera::setCounterRois(const std::vector<CameraCounterRoi> & in_rois) ///< [in] ROIs definitions
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setCounterRois - The ROIs can not be changed during an acquisition!";
+    }
+
+    if(!CameraRoiCounterTable::getInstance()->setRois(in_rois))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setCounterRois - Incorrect ROIs (at most " 
+                                         << CameraRoiCounterTable::getMaxRoisNb() << " ROIs, not empty, mask of the ROI size)!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the ROIs of the counters
+//-----------------------------------------------------------------------------
+void Camera::getCounterRois(std::vector<CameraCounterRoi> & out_rois) const ///< [out] ROIs definitions
+{
+    DEB_MEMBER_FUNCT();
+    CameraRoiCounterTable::getConstInstance()->getRois(out_rois);
+}
+
+//-----------------------------------------------------------------------------
+/// Get the ROI counters of a frame of the current acquisition (the counters of
+/// the last frames are kept, the frame buffers are not accessed)
+//-----------------------------------------------------------------------------
+void Camera::getRoiFrameCounters(int                      in_frame_nb, ///< [in] frame number in the acquisition
+                                 CameraRoiFrameCounters & out_counters) const ///< [out] counters of the frame
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_frame_nb < 0) || (!CameraRoiCounterTable::getConstInstance()->getFrameCounters(static_cast<std::size_t>(in_frame_nb), out_counters)))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getRoiFrameCounters - The counters of the frame " << in_frame_nb << " are not available!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the ROI counters of the last received frame
+//-----------------------------------------------------------------------------
+void Camera::getLastRoiFrameCounters(CameraRoiFrameCounters & out_counters) const ///< [out] counters of the frame
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraRoiCounterTable::getConstInstance()->getLastFrameCounters(out_counters))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "getLastRoiFrameCounters - No frame was counted in the acquisition!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// BACKGROUND SUBTRACTION
+//-----------------------------------------------------------------------------
+//-----------------------------------------------------------------------------
+/// Enable or disable the subtraction of the rolling background
+//-----------------------------------------------------------------------------
+void Camera::setBackgroundSubtraction(bool in_enabled) ///< [in] true to enable the stage
+{
+    DEB_MEMBER_FUNCT();
+
+    if(CameraAcqThread::readStatus() == CameraAcqThread::Running)
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setBackgroundSubtraction - The background subtraction can not be changed during an acquisition!";
+    }
+
+    CameraBackgroundSubtraction::getInstance()->setEnabled(in_enabled);
+}
+
+//-----------------------------------------------------------------------------
+/// Check if the background subtraction stage is enabled
+//-----------------------------------------------------------------------------
+void Camera::getBackgroundSubtraction(bool & out_enabled) const ///< [out] true if the stage is enabled
+{
+    DEB_MEMBER_FUNCT();
+    out_enabled = CameraBackgroundSubtraction::getConstInstance()->isEnabled();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the size of the cells of the background grid (the model is reset)
+//-----------------------------------------------------------------------------
+void Camera::setBackgroundCellSize(int in_cell_size) ///< [in] size of a square cell in frame pixels
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_cell_size <= 0) || (!CameraBackgroundSubtraction::getInstance()->setCellSize(static_cast<std::size_t>(in_cell_size))))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setBackgroundCellSize - Incorrect cell size (multiple of 8, at most 256): " << in_cell_size << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the size of the cells of the background grid
+//-----------------------------------------------------------------------------
+void Camera::getBackgroundCellSize(int & out_cell_size) const ///< [out] size of a square cell in frame pixels
+{
+    DEB_MEMBER_FUNCT();
+    out_cell_size = static_cast<int>(CameraBackgroundSubtraction::getConstInstance()->getCellSize());
+}
+
+//-----------------------------------------------------------------------------
+/// Set the time constant of the background moving average (can be tuned
+/// during a live acquisition)
+//-----------------------------------------------------------------------------
+void Camera::setBackgroundTimeConstant(double in_frames_nb) ///< [in] time constant in frames
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraBackgroundSubtraction::getInstance()->setTimeConstant(in_frames_nb))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setBackgroundTimeConstant - Incorrect time constant: " << in_frames_nb << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the time constant of the background moving average
+//-----------------------------------------------------------------------------
+void Camera::getBackgroundTimeConstant(double & out_frames_nb) const ///< [out] time constant in frames
+{
+    DEB_MEMBER_FUNCT();
+    out_frames_nb = CameraBackgroundSubtraction::getConstInstance()->getTimeConstant();
+}
+
+//-----------------------------------------------------------------------------
+/// Set the offset added to the frames after the background subtraction
+//-----------------------------------------------------------------------------
+void Camera::setBackgroundOffset(double in_offset) ///< [in] offset in ADU
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!CameraBackgroundSubtraction::getInstance()->setOffset(in_offset))
+    {
+        THROW_HW_ERROR(ErrorType::Error) << "setBackgroundOffset - Incorrect offset: " << in_offset << "!";
+    }
+}
+
+//-----------------------------------------------------------------------------
+/// Get the offset added to the frames after the background subtraction
+//-----------------------------------------------------------------------------
+void Camera::getBackgroundOffset(double & out_offset) const ///< [out] offset in ADU
+{
+    DEB_MEMBER_FUNCT();
+    out_offset = CameraBackgroundSubtraction::getConstInstance()->getOffset();
+}
+
+//-----------------------------------------------------------------------------
+/// Forget the background model, the next frame initializes it (after a change
+/// of the scene during a live acquisition)
+//-----------------------------------------------------------------------------
+void Camera::resetBackground()
+{
+    DEB_MEMBER_FUNCT();
+    CameraBackgroundSubtraction::getInstance()->reset();
+}
+
+//-----------------------------------------------------------------------------
+/// Get a copy of the background model
+//-----------------------------------------------------------------------------
+void Camera::getBackgroundModel(CameraBackgroundModel & out_model) const ///< [out] background of each cell of the grid
+{
+    DEB_MEMBER_FUNCT();
+    CameraBackgroundSubtraction::getConstInstance()->getModel(out_model);
+}
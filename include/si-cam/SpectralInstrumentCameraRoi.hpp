@@ -36,6 +36,7 @@ void Camera::checkRoi(const Roi & set_roi, ///< [in]  Roi values to set
 /// Set the new roi
 // The ROI given by LIMA has a size which depends on the binning.
 // SDK Sub array are binning independants.
+// The ROI given by LIMA is in the frame orientation.
 //-----------------------------------------------------------------------------
 void Camera::setRoi(const Roi & set_roi) ///< [in] New Roi values
 {
@@ -51,16 +52,36 @@ void Camera::setRoi(const Roi & set_roi) ///< [in] New Roi values
     Point set_roi_topleft(set_roi.getTopLeft().x      , set_roi.getTopLeft().y       );
     Size  set_roi_size   (set_roi.getSize().getWidth(), set_roi.getSize().getHeight());
 
+    std::size_t source_width ;
+    std::size_t source_height;
+
+    getSourceFullFrameSize(source_width, source_height);
+
     // correction of a 0x0 ROI sent by the generic part
     if ((set_roi_size.getWidth() == 0) && (set_roi_size.getHeight() == 0))
     {
 	    DEB_TRACE() << "Correcting 0x0 roi...";
-        std::size_t width_max  = CameraControl::getConstInstance()->getWidthMax       ();
-        std::size_t height_max = CameraControl::getConstInstance()->getHeightMax      ();
-        std::size_t binning_x  = CameraControl::getConstInstance()->getSerialBinning  ();
-        std::size_t binning_y  = CameraControl::getConstInstance()->getParallelBinning();
-
-        set_roi_size = Size(width_max / binning_x, height_max / binning_y);
+        set_roi_size = Size(static_cast<int>(source_width), static_cast<int>(source_height));
+    }
+    else
+    // conversion of the oriented roi to the roi of the image sent by the camera
+    {
+        const CameraFrameTransform & transform = CameraFrameProcessing::getConstInstance()->getTransform();
+
+        std::size_t frame_width ;
+        std::size_t frame_height;
+        std::size_t x, y, width, height;
+
+        transform.getDestinationSize(source_width, source_height, frame_width, frame_height);
+
+        transform.inverse().transformRect(static_cast<std::size_t>(set_roi_topleft.x)      ,
+                                          static_cast<std::size_t>(set_roi_topleft.y)      ,
+                                          static_cast<std::size_t>(set_roi_size.getWidth ()),
+                                          static_cast<std::size_t>(set_roi_size.getHeight()),
+                                          frame_width, frame_height, x, y, width, height);
+
+        set_roi_topleft = Point(static_cast<int>(x), static_cast<int>(y));
+        set_roi_size    = Size (static_cast<int>(width), static_cast<int>(height));
     }
 
     Roi new_roi(set_roi_topleft, set_roi_size);
@@ -84,10 +105,20 @@ void Camera::getRoi(Roi & hw_roi) ///< [out] Roi values
 {
     DEB_MEMBER_FUNCT();
 
-    hw_roi = Roi( static_cast<int>(CameraControl::getConstInstance()->getSerialOrigin  ()),
-                  static_cast<int>(CameraControl::getConstInstance()->getParallelOrigin()),
-                  static_cast<int>(CameraControl::getConstInstance()->getSerialLength  ()),
-                  static_cast<int>(CameraControl::getConstInstance()->getParallelLength()));
+    std::size_t source_width ;
+    std::size_t source_height;
+    std::size_t x, y, width, height;
+
+    getSourceFullFrameSize(source_width, source_height);
+
+    // the roi is given in the frame orientation
+    CameraFrameProcessing::getConstInstance()->getTransform().transformRect(CameraControl::getConstInstance()->getSerialOrigin  (),
+                                                                            CameraControl::getConstInstance()->getParallelOrigin(),
+                                                                            CameraControl::getConstInstance()->getSerialLength  (),
+                                                                            CameraControl::getConstInstance()->getParallelLength(),
+                                                                            source_width, source_height, x, y, width, height);
+
+    hw_roi = Roi(static_cast<int>(x), static_cast<int>(y), static_cast<int>(width), static_cast<int>(height));
     
     DEB_RETURN() << DEB_VAR1(hw_roi);
 }
@@ -30,12 +30,26 @@
 #include "CameraAcqThread.h"
 #include "SpectralInstrumentCamera.h"
 #include "CameraControl.h"
+#include "CameraFrameProcessing.h"
+#include "CameraMosaic.h"
+#include "CameraTransferStatistics.h"
+#include "CameraSocketMonitor.h"
+#include "CameraFitsWriter.h"
+#include "CameraHdf5Writer.h"
+#include "CameraThroughputProfiles.h"
+#include "CameraRowBandNotifier.h"
+#include "CameraDecodePool.h"
+#include "CameraSoakMonitor.h"
+#include "CameraPhotonTransfer.h"
+#include "CameraClock.h"
 
 // SYSTEM
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>  
 #include <sys/time.h>
+#include <time.h>
+#include <algorithm>
 #include <sstream>
 
 // LIMA
@@ -50,29 +64,29 @@ using namespace lima::SpectralInstrument;
 class lima::SpectralInstrument::InternalTimer
 {
 public:
-    // init the start time
+    // init the start time (plugin clock, which can run in virtual time)
     void init()
     {
-        gettimeofday(&m_start_time, NULL);
+        m_start_time_sec = CameraClock::getConstInstance()->getMonotonicTimeSec();
     }
 
     // get the elapsed time in milli-seconds since the start time
     long getElapsedTimeMsec() const
     {
-        struct timeval end_time;
-        gettimeofday(&end_time, NULL);
+        double end_time_sec = CameraClock::getConstInstance()->getMonotonicTimeSec();
 
-        long seconds    = (end_time.tv_sec  - m_start_time.tv_sec ); // seconds
-        long useconds   = (end_time.tv_usec - m_start_time.tv_usec); // milliseconds
-        long milli_time = ((seconds) * 1000 + (useconds/1000.0)   );
-
-        return milli_time;
+        return static_cast<long>((end_time_sec - m_start_time_sec) * 1000.0);
     }
 
 private:
-    struct timeval m_start_time;
+    double m_start_time_sec;
 };
 
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const int32_t CameraAcqThread::g_parts_sample_interval = 16;
+
 //------------------------------------------------------------------
 // singleton management
 //------------------------------------------------------------------
@@ -87,6 +101,7 @@ CameraAcqThread::CameraAcqThread()
     DEB_TRACE() << "Creation of the CameraAcqThread thread...";
     m_force_stop = false;
     m_running_state = RunningState::Exposure;
+    m_metadata = NULL;
 }
 
 /************************************************************************
@@ -249,6 +264,13 @@ void CameraAcqThread::execStartAcq()
         setStatus(CameraAcqThread::Idle);
     }
 
+    // closing the files of the acquisition
+    CameraFitsWriter::getInstance()->endAcq();
+    CameraHdf5Writer::getInstance()->endAcq();
+
+    // ending the photon transfer step of the acquisition
+    CameraPhotonTransfer::getInstance()->endAcq();
+
     // authorize the state update process
     Camera::getInstance()->setUpdateAuthorizeFlag(true);
 
@@ -281,8 +303,24 @@ bool CameraAcqThread::imageAcquisition()
     // configure the wait timeout in seconds for the acquire command execution (tcp/ip packets reception)
     CameraControl::getInstance()->computeTimeoutForAcquireCommand();
 
+    // starting the metadata record of the frame (the settings can not change during the acquisition)
+    const CameraControl * control = CameraControl::getConstInstance();
+
+    m_metadata = CameraFrameMetadataTable::getInstance()->startFrame(Camera::getConstInstance()->getNbFramesAcquired());
+
+    m_metadata->m_exposure_time_msec = exposure_time_msec;
+    m_metadata->m_readout_speed      = static_cast<uint32_t>(control->getReadoutSpeedFromCamera());
+    m_metadata->m_serial_origin      = static_cast<uint32_t>(control->getSerialOrigin    ());
+    m_metadata->m_parallel_origin    = static_cast<uint32_t>(control->getParallelOrigin  ());
+    m_metadata->m_serial_length      = static_cast<uint32_t>(control->getSerialLength    ());
+    m_metadata->m_parallel_length    = static_cast<uint32_t>(control->getParallelLength  ());
+    m_metadata->m_serial_binning     = static_cast<uint32_t>(control->getSerialBinning   ());
+    m_metadata->m_parallel_binning   = static_cast<uint32_t>(control->getParallelBinning ());
+    m_metadata->m_ccd_temperature    = control->getCCDTemperatureFromCamera();
+
     // starting a new exposure
     m_running_state = RunningState::Exposure;
+    m_metadata->m_acquire_time = getRealTimeSec();
 
     // Start a new acquisition by sending a command to the hardware (always asynchronous)
     if(!CameraControl::getInstance()->acquire(false)) 
@@ -318,6 +356,7 @@ bool CameraAcqThread::imageAcquisition()
             else
             {
                 DEB_TRACE() << "terminate acquisition for image: " << Camera::getConstInstance()->getNbFramesAcquired();
+                m_metadata->m_acquisition_end_time = getRealTimeSec();
                 CameraControl::getInstance()->terminateAcquisition();
             }
             break;
@@ -359,6 +398,11 @@ bool CameraAcqThread::imageAcquisition()
 
                 if(acq_status_packet->m_exposure_done == 100)
                 {
+                    if(m_running_state != RunningState::Readout)
+                    {
+                        m_metadata->m_readout_time = getRealTimeSec();
+                    }
+
                     m_running_state = RunningState::Readout;
                 }
 
@@ -369,7 +413,7 @@ bool CameraAcqThread::imageAcquisition()
         }
 
         // wait a few mseconds
-        usleep(delay_to_check_acq_end_msec * 1000);
+        CameraClock::getConstInstance()->sleepMsec(delay_to_check_acq_end_msec);
     }
 
     return (!error_occurred);
@@ -395,12 +439,50 @@ bool CameraAcqThread::imageReception()
     bool             finished       = false;
     int32_t          packets_nb     = 0; // number of received packets
 
+    // reception times of the frame (kernel timestamps of the image parts)
+    CameraFrameReceptionTimes reception_times;
+    reception_times.m_first_part_time = 0.0;
+    reception_times.m_last_part_time  = 0.0;
+    reception_times.m_bytes_nb        = 0  ;
+
+    // measures used by the packet delay controller
+    CameraPacketDelayMeasures delay_measures;
+    delay_measures.m_max_queue_bytes = 0  ;
+    delay_measures.m_receive_buffer  = CameraControl::getConstInstance()->getReceiveBufferSize();
+    delay_measures.m_max_lag_sec     = 0.0;
+    delay_measures.m_transfer_rate   = 0.0;
+
     int              frame_mem_size = frame_dim.getMemSize  ();
     Size             frame_size     = frame_dim.getSize ();
     int              frame_depth    = frame_dim.getDepth();
 
+    // the row bands are only followed when a listener needs them
+    bool row_bands = CameraRowBandNotifier::getConstInstance()->hasListeners();
+
+    if(row_bands)
+    {
+        CameraRowBandNotifier::getInstance()->startFrame(static_cast<const uint16_t *>(image_ptr)                   ,
+                                                         static_cast<std::size_t>(frame_size.getWidth ())           ,
+                                                         static_cast<std::size_t>(frame_size.getHeight())           ,
+                                                         Camera::getConstInstance()->getNbFramesAcquired()          ,
+                                                         CameraFrameProcessing::getConstInstance()->getTransform());
+    }
+
+    // the image parts are decoded by the threads of the pool when there is at least one thread
+    bool decode_pool = (CameraDecodePool::getConstInstance()->getThreadsNb() > 0);
+
+    if(decode_pool)
+    {
+        CameraDecodePool::getInstance()->startFrame(image_ptr                                                ,
+                                                    frame_dim                                                ,
+                                                    CameraFrameProcessing::getConstInstance()->getTransform(),
+                                                    Camera::getConstInstance()->getNbFramesAcquired()        ,
+                                                    CameraMosaic::getConstInstance()->isEnabled()            );
+    }
+
     // start the latency
     m_running_state = RunningState::Retrieve;
+    m_metadata->m_retrieve_time = getRealTimeSec();
 
     // Start a new image reception by sending a command to the hardware
     if(!CameraControl::getInstance()->retrieveImage()) 
@@ -446,15 +528,81 @@ bool CameraAcqThread::imageReception()
                 break;
             }
 
-            // copy the image part into the Lima image buffer
-            if(!image->copy(image_ptr, frame_dim))
+            // the part size is kept before its pixels are moved into the decoding pool
+            std::size_t part_bytes = image->size();
+
+            if(decode_pool)
             {
-                // an error occurred...
-                setStatus(CameraAcqThread::Error);
-                std::string error_text = "Error occurred during real time acquisition (during an image part copy)!";
-                manageError(error_text);
-                result = false;
-                break;
+                // the threads of the pool convert and copy the pixels (also into the mosaic)
+                CameraDecodePool::getInstance()->submit(*image);
+
+                if(!forwardDecodedParts(row_bands))
+                {
+                    // an error occurred...
+                    setStatus(CameraAcqThread::Error);
+                    std::string error_text = "Error occurred during real time acquisition (during an image part copy)!";
+                    manageError(error_text);
+                    result = false;
+                    break;
+                }
+            }
+            else
+            {
+                // convert the pixels from the network byte order
+                image->convert();
+
+                // copy the image part into the Lima image buffer
+                if(!image->copy(image_ptr, frame_dim, CameraFrameProcessing::getConstInstance()->getTransform()))
+                {
+                    // an error occurred...
+                    setStatus(CameraAcqThread::Error);
+                    std::string error_text = "Error occurred during real time acquisition (during an image part copy)!";
+                    manageError(error_text);
+                    result = false;
+                    break;
+                }
+
+                // the rows completed by this part can be treated during the reception of the next parts
+                if(row_bands)
+                {
+                    CameraRowBandNotifier::getInstance()->addPart(static_cast<std::size_t>(image->m_offset), part_bytes / sizeof(uint16_t));
+                }
+
+                // copy the image part into the mosaic tile of this detector (the part is still in the cache)
+                if((CameraMosaic::getConstInstance()->isEnabled()) &&
+                   (!CameraMosaic::getInstance()->copyPart(*image, Camera::getConstInstance()->getNbFramesAcquired())))
+                {
+                    // an error occurred...
+                    setStatus(CameraAcqThread::Error);
+                    std::string error_text = "Error occurred during real time acquisition (during an image part copy into the mosaic)!";
+                    manageError(error_text);
+                    result = false;
+                    break;
+                }
+            }
+
+            // keeping the reception times of the frame
+            if(packets_nb == 0)
+            {
+                reception_times.m_first_part_time = image->m_header_reception_time;
+                m_metadata->m_image_identifier    = image->m_image_identifier;
+            }
+
+            reception_times.m_last_part_time  = image->m_data_reception_time;
+            reception_times.m_bytes_nb       += part_bytes;
+
+            // backlog of the socket and delay between the part reception and its treatment
+            // (sampled on some parts: an ioctl and a clock read cost too much on each part)
+            if(((packets_nb % g_parts_sample_interval) == 0) ||
+               ((image->m_current_packets_nb + 1) == image->m_total_nb_packets))
+            {
+                double      lag   = getRealTimeSec() - image->m_data_reception_time;
+                std::size_t queue = CameraControl::getConstInstance()->getReceiveQueueBytes();
+
+                delay_measures.m_max_lag_sec     = std::max(delay_measures.m_max_lag_sec    , lag  );
+                delay_measures.m_max_queue_bytes = std::max(delay_measures.m_max_queue_bytes, queue);
+
+                CameraSocketMonitor::getInstance()->addPart(queue, lag);
             }
 
             // one more image part treated
@@ -479,9 +627,79 @@ bool CameraAcqThread::imageReception()
                 }
                 else
                 {
+                    // the frame is complete when the decoding threads copied all its parts
+                    if((decode_pool) && 
+                       ((!CameraDecodePool::getInstance()->waitFrame()) || (!forwardDecodedParts(row_bands))))
+                    {
+                        delete packet;
+                        packet = NULL;
+                        CameraControl::getInstance()->terminateImageRetrieve();
+
+                        // an error occurred...
+                        setStatus(CameraAcqThread::Error);
+                        std::string error_text = "Error occurred during real time acquisition (during an image part copy)!";
+                        manageError(error_text);
+                        result = false;
+                        break;
+                    }
+
+                    CameraTransferStatistics::getInstance()->addFrame(Camera::getConstInstance()->getNbFramesAcquired(), reception_times);
+
+                    m_metadata->m_parts_nb        = static_cast<uint32_t>(packets_nb);
+                    m_metadata->m_bytes_nb        = reception_times.m_bytes_nb       ;
+                    m_metadata->m_first_part_time = reception_times.m_first_part_time;
+                    m_metadata->m_last_part_time  = reception_times.m_last_part_time ;
+
+                    // the last rows are given before the processing stages
+                    if(row_bands)
+                    {
+                        CameraRowBandNotifier::getInstance()->endFrame();
+                    }
+
+                    // apply the processing stages on the complete frame
+                    CameraFrame frame;
+                    frame.m_data     = static_cast<uint16_t *>(image_ptr);
+                    frame.m_width    = static_cast<std::size_t>(frame_size.getWidth ());
+                    frame.m_height   = static_cast<std::size_t>(frame_size.getHeight());
+                    frame.m_frame_nb = Camera::getConstInstance()->getNbFramesAcquired();
+                    frame.m_drop     = false;
+                    frame.m_metadata = m_metadata;
+
+                    if(!CameraFrameProcessing::getInstance()->process(frame))
+                    {
+                        delete packet;
+                        packet = NULL;
+                        CameraControl::getInstance()->terminateImageRetrieve();
+
+                        // an error occurred...
+                        setStatus(CameraAcqThread::Error);
+                        std::string error_text = "Error occurred during real time acquisition (during the frame processing)!";
+                        manageError(error_text);
+                        result = false;
+                        break;
+                    }
+
+                    // a dropped frame is not given to Lima: its buffer is reused by the next frame,
+                    // but it counts as an exposure so a finite acquisition ends after its frames number
+                    if(frame.m_drop)
+                    {
+                        DEB_TRACE() << "frame dropped by the processing stages: " << (int)frame.m_frame_nb;
+                        Camera::getInstance()->incrementNbFramesDropped();
+                        CameraControl::getInstance()->terminateImageRetrieve();
+                        finished = true;
+                        break;
+                    }
+
+                    // the record is complete: the readers can access it
+                    m_metadata->m_processed_time = getRealTimeSec();
+                    CameraFrameMetadataTable::getInstance()->publishFrame(m_metadata);
+                    CameraSoakMonitor::getInstance()->addFrame(Camera::getConstInstance()->getNbFramesAcquired(), m_metadata->m_processed_time);
+                    CameraThroughputProfiles::getInstance()->addFrame(*m_metadata);
+
 	    	        // pushing the image buffer through Lima 
 		            HwFrameInfoType frame_info;
-					frame_info.frame_timestamp = Timestamp::now();
+					// the kernel reception time of the last image part does not depend on the threads scheduling
+					frame_info.frame_timestamp = (reception_times.m_last_part_time > 0.0) ? Timestamp(reception_times.m_last_part_time) : Timestamp(getRealTimeSec());
 		            frame_info.acq_frame_nb    = Camera::getConstInstance()->getNbFramesAcquired();
                     DEB_TRACE() << "imageReception for image (frame_info.acq_frame_nb) : " << (int)frame_info.acq_frame_nb;
     		        buffer_mgr.newFrameReady(frame_info);
@@ -506,6 +724,10 @@ bool CameraAcqThread::imageReception()
             }
         }
 
+        // the packet treated when the loop was left (error, dropped or complete frame) is released
+        delete packet;
+        packet = NULL;
+
         if((!result)||(finished))
         {
             break;
@@ -525,9 +747,91 @@ bool CameraAcqThread::imageReception()
         }
     }
 
+    // the parts not yet decoded after an error or a stop are dropped
+    if(decode_pool)
+    {
+        CameraDecodePool::getInstance()->endFrame();
+    }
+
+    // the packets settings can only be changed between two images
+    if((result) && (finished))
+    {
+        double duration = reception_times.m_last_part_time - reception_times.m_first_part_time;
+
+        delay_measures.m_transfer_rate = (duration > 0.0) ? (static_cast<double>(reception_times.m_bytes_nb) / duration) : 0.0;
+        adjustPacketDelay(delay_measures);
+    }
+
     return result;
 }
 
+/************************************************************************
+ * \fn bool forwardDecodedParts(bool in_row_bands)
+ * \brief Give the image parts copied by the decoding threads to the row
+ *        bands notifier (in the reception order)
+ * \param  in_row_bands true if the row bands are followed
+ * \return false if the copy of an image part failed
+ ************************************************************************/
+bool CameraAcqThread::forwardDecodedParts(bool in_row_bands)
+{
+    std::vector<CameraDecodedPart> parts;
+
+    if(!CameraDecodePool::getInstance()->takeCompleted(parts))
+        return false;
+
+    if(in_row_bands)
+    {
+        for(std::size_t part_index = 0 ; part_index < parts.size() ; part_index++)
+        {
+            CameraRowBandNotifier::getInstance()->addPart(parts[part_index].m_offset, parts[part_index].m_pixels_nb);
+        }
+    }
+
+    return true;
+}
+
+/************************************************************************
+ * \fn void adjustPacketDelay(const CameraPacketDelayMeasures & in_measures)
+ * \brief Adapt the delay between two image packets for the next image.
+ *        A failure is not fatal: the previous delay is kept.
+ * \param  in_measures measures done during the reception of the image
+ * \return none
+ ************************************************************************/
+void CameraAcqThread::adjustPacketDelay(const CameraPacketDelayMeasures & in_measures)
+{
+    DEB_MEMBER_FUNCT();
+
+    uint16_t pixels_per_packet;
+    uint16_t packet_delay_usec;
+    uint16_t new_delay_usec   ;
+
+    if(!CameraPacketDelayController::getInstance()->computeNextDelay(in_measures, new_delay_usec))
+        return;
+
+    CameraPacketDelayController::getConstInstance()->getCurrentSettings(pixels_per_packet, packet_delay_usec);
+
+    if(CameraControl::getInstance()->configurePackets(pixels_per_packet, new_delay_usec))
+    {
+        CameraPacketDelayController::getInstance()->setCurrentDelay(new_delay_usec);
+    }
+    else
+    {
+        DEB_ERROR() << "Unable to change the packet delay to " << new_delay_usec << " usec: " << packet_delay_usec << " usec is kept.";
+    }
+}
+
+/************************************************************************
+ * \fn double getRealTimeSec()
+ * \brief Get the current time in seconds since the epoch
+ *        (same clock than the kernel reception times)
+ * \param  none
+ * \return current time
+ ************************************************************************/
+double CameraAcqThread::getRealTimeSec()
+{
+    return CameraClock::getConstInstance()->getRealTimeSec();
+}
+
 /************************************************************************
  * \fn bool imageLatency()
  * \brief Manage the latency wait before the next image
@@ -553,7 +857,7 @@ bool CameraAcqThread::imageLatency(const InternalTimer & in_start_timer)
         DEB_TRACE() << "imageLatency: " << (int)(latency_time_msec - elapsed_time_msec);
 
         // wait a few mseconds
-        usleep((latency_time_msec - elapsed_time_msec) * 1000);
+        CameraClock::getConstInstance()->sleepMsec(latency_time_msec - elapsed_time_msec);
     }
 
     return true;
@@ -0,0 +1,787 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraAzimuthalIntegrator.cpp
+ * \brief  implementation file of the azimuthal integration stage (radial profiles of scattering frames).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraAzimuthalIntegrator.h"
+
+// SYSTEM
+#include <cmath>
+#include <limits>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraAzimuthalIntegrator::g_max_bins_nb        = 100000;
+const std::size_t CameraAzimuthalIntegrator::g_max_subdivision    = 8     ;
+const std::size_t CameraAzimuthalIntegrator::g_chunks_nb          = 64    ;
+const std::size_t CameraAzimuthalIntegrator::g_ring_size          = 64    ;
+const std::size_t CameraAzimuthalIntegrator::g_default_threads_nb = 2     ;
+const std::size_t CameraAzimuthalIntegrator::g_max_threads_nb     = 16    ;
+const double      CameraAzimuthalIntegrator::g_wait_delay_sec     = 0.1   ;
+
+/****************************************************************************************************
+ * \fn CameraAzimuthalIntegrator()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraAzimuthalIntegrator::CameraAzimuthalIntegrator() : CameraFrameStage("AzimuthalIntegrator")
+{
+    DEB_CONSTRUCTOR();
+
+    m_geometry.m_center_x            = 0.0   ;
+    m_geometry.m_center_y            = 0.0   ;
+    m_geometry.m_pixel_size_um       = 13.5  ;
+    m_geometry.m_distance_mm         = 1000.0;
+    m_geometry.m_wavelength_angstrom = 1.0   ;
+    m_geometry.m_unit                = CameraIntegrationGeometry::Radius;
+    m_geometry.m_bins_nb             = 1000  ;
+    m_geometry.m_min                 = 0.0   ;
+    m_geometry.m_max                 = 0.0   ;
+    m_geometry.m_subdivision         = 1     ;
+
+    m_matrix_valid    = false;
+    m_matrix_width    = 0    ;
+    m_matrix_height   = 0    ;
+    m_last_valid      = false;
+    m_last_frame_nb   = 0    ;
+    m_frame_data      = NULL ;
+    m_frame_intensity = NULL ;
+    m_frame_variance  = NULL ;
+    m_next_chunk      = 0    ;
+    m_done_chunks_nb  = 0    ;
+
+    m_ring_intensity.resize(g_ring_size);
+    m_ring_variance .resize(g_ring_size);
+    m_ring_frame_nbs.assign(g_ring_size, std::numeric_limits<std::size_t>::max());
+
+    setThreadsNb(g_default_threads_nb);
+}
+
+/****************************************************************************************************
+ * \fn ~CameraAzimuthalIntegrator()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraAzimuthalIntegrator::~CameraAzimuthalIntegrator()
+{
+    DEB_DESTRUCTOR();
+
+    releaseThreads();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex chunksLock() const
+ * \brief  creates an autolock mutex for the chunks access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraAzimuthalIntegrator::chunksLock() const
+{
+    return lima::AutoMutex(m_chunks_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn bool setGeometry(const CameraIntegrationGeometry & in_geometry)
+ * \brief  set the geometry of the experiment and the binning of the profiles.
+ *         The matrix is built at the preparation of the next acquisition.
+ * \param  in_geometry new geometry
+ * \return true if the geometry is correct
+ ****************************************************************************************************/
+bool CameraAzimuthalIntegrator::setGeometry(const CameraIntegrationGeometry & in_geometry)
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_geometry.m_bins_nb == 0) || (in_geometry.m_bins_nb > g_max_bins_nb) ||
+       (in_geometry.m_subdivision == 0) || (in_geometry.m_subdivision > g_max_subdivision) ||
+       (in_geometry.m_pixel_size_um <= 0.0) || (in_geometry.m_distance_mm <= 0.0) ||
+       ((in_geometry.m_unit == CameraIntegrationGeometry::Q) && (in_geometry.m_wavelength_angstrom <= 0.0)))
+    {
+        DEB_ERROR() << "CameraAzimuthalIntegrator::setGeometry - Incorrect geometry!";
+        return false;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_geometry     = in_geometry;
+    m_matrix_valid = false;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn CameraIntegrationGeometry getGeometry() const
+ * \brief  get the geometry of the experiment and the binning of the profiles
+ * \param  none
+ * \return geometry copy
+ ****************************************************************************************************/
+CameraIntegrationGeometry CameraAzimuthalIntegrator::getGeometry() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_geometry;
+}
+
+/****************************************************************************************************
+ * \fn bool setThreadsNb(std::size_t in_threads_nb)
+ * \brief  set the number of threads which help the acquisition thread (not during an acquisition)
+ * \param  in_threads_nb number of threads (0 to integrate the frames in the acquisition thread)
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraAzimuthalIntegrator::setThreadsNb(std::size_t in_threads_nb)
+{
+    if(in_threads_nb > g_max_threads_nb)
+        return false;
+
+    if(in_threads_nb == m_threads.size())
+        return true;
+
+    releaseThreads();
+
+    for(std::size_t thread_index = 0 ; thread_index < in_threads_nb ; thread_index++)
+    {
+        CameraWriterThread * thread = new CameraWriterThread(this);
+
+        thread->start       ();
+        thread->startWriting();
+
+        m_threads.push_back(thread);
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getThreadsNb() const
+ * \brief  get the number of threads which help the acquisition thread
+ * \param  none
+ * \return number of threads
+ ****************************************************************************************************/
+std::size_t CameraAzimuthalIntegrator::getThreadsNb() const
+{
+    return m_threads.size();
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getMatrixSize() const
+ * \brief  get the number of non null elements of the matrix (0 before the first acquisition)
+ * \param  none
+ * \return number of elements
+ ****************************************************************************************************/
+std::size_t CameraAzimuthalIntegrator::getMatrixSize() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return (m_matrix_valid) ? m_columns.size() : 0;
+}
+
+/****************************************************************************************************
+ * \fn bool getProfile(std::size_t in_frame_nb, CameraRadialProfile & out_profile) const
+ * \brief  get the profile of a frame of the current acquisition
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  out_profile profile of the frame
+ * \return true if the profile is still in the ring buffer
+ ****************************************************************************************************/
+bool CameraAzimuthalIntegrator::getProfile(std::size_t in_frame_nb, CameraRadialProfile & out_profile) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    std::size_t slot = in_frame_nb % g_ring_size;
+
+    if(m_ring_frame_nbs[slot] != in_frame_nb)
+        return false;
+
+    fillProfile(slot, out_profile);
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool getLastProfile(CameraRadialProfile & out_profile) const
+ * \brief  get the profile of the last integrated frame of the current acquisition
+ * \param  out_profile profile of the frame
+ * \return true if a frame was integrated
+ ****************************************************************************************************/
+bool CameraAzimuthalIntegrator::getLastProfile(CameraRadialProfile & out_profile) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(!m_last_valid)
+        return false;
+
+    fillProfile(m_last_frame_nb % g_ring_size, out_profile);
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void fillProfile(std::size_t in_slot, CameraRadialProfile & out_profile) const
+ * \brief  fill a profile with a slot of the ring buffer
+ * \param  in_slot slot of the ring buffer
+ * \param  out_profile profile to fill
+ * \return none
+ ****************************************************************************************************/
+void CameraAzimuthalIntegrator::fillProfile(std::size_t in_slot, CameraRadialProfile & out_profile) const
+{
+    out_profile.m_frame_nb  = m_ring_frame_nbs[in_slot];
+    out_profile.m_positions = m_positions;
+    out_profile.m_intensity = m_ring_intensity[in_slot];
+    out_profile.m_variance  = m_ring_variance [in_slot];
+    out_profile.m_weights.assign(m_bin_weights.begin(), m_bin_weights.end());
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition. The matrix is built if the geometry or the
+ *         frame size changed, and the profiles are allocated.
+ * \param  in_format format of the frames
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraAzimuthalIntegrator::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_last_valid = false;
+    m_ring_frame_nbs.assign(g_ring_size, std::numeric_limits<std::size_t>::max());
+
+    if(!isEnabled())
+        return true;
+
+    if(in_format.m_pixel_depth > 16)
+    {
+        DEB_ERROR() << "CameraAzimuthalIntegrator::prepareAcq - Incorrect pixel depth: " << in_format.m_pixel_depth;
+        return false;
+    }
+
+    if((!m_matrix_valid) || (m_matrix_width != in_format.m_width) || (m_matrix_height != in_format.m_height))
+    {
+        if(!buildMatrix(in_format.m_width, in_format.m_height))
+            return false;
+    }
+
+    for(std::size_t slot = 0 ; slot < g_ring_size ; slot++)
+    {
+        m_ring_intensity[slot].assign(m_geometry.m_bins_nb, 0.0f);
+        m_ring_variance [slot].assign(m_geometry.m_bins_nb, 0.0f);
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  integrate a complete frame into its profile (called by the acquisition thread).
+ *         With threads, the acquisition thread integrates chunks too, then waits the others.
+ * \param  in_out_frame frame to integrate (not modified)
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraAzimuthalIntegrator::process(CameraFrame & in_out_frame)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if((!m_matrix_valid) || (in_out_frame.m_width != m_matrix_width) || (in_out_frame.m_height != m_matrix_height))
+    {
+        DEB_ERROR() << "CameraAzimuthalIntegrator::process - Incorrect frame size: " << in_out_frame.m_width << "x" << in_out_frame.m_height;
+        return false;
+    }
+
+    std::size_t slot      = in_out_frame.m_frame_nb % g_ring_size;
+    std::size_t chunks_nb = m_chunk_bins.size() - 1;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex chunks_mutex = chunksLock();
+
+        m_frame_data      = in_out_frame.m_data;
+        m_frame_intensity = m_ring_intensity[slot].data();
+        m_frame_variance  = m_ring_variance [slot].data();
+        m_next_chunk      = 0;
+        m_done_chunks_nb  = 0;
+
+        m_chunks_cond.broadcast();
+    }
+
+    for(;;)
+    {
+        std::size_t chunk_index;
+
+        {
+            // protecting the multi-threads access
+            lima::AutoMutex chunks_mutex = chunksLock();
+
+            if(m_next_chunk >= chunks_nb)
+                break;
+
+            chunk_index = m_next_chunk++;
+        }
+
+        integrateChunk(chunk_index);
+
+        {
+            // protecting the multi-threads access
+            lima::AutoMutex chunks_mutex = chunksLock();
+
+            m_done_chunks_nb++;
+        }
+    }
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex chunks_mutex = chunksLock();
+
+        while(m_done_chunks_nb < chunks_nb)
+        {
+            m_chunks_cond.wait(g_wait_delay_sec);
+        }
+
+        // the frame is given back to Lima
+        m_frame_data = NULL;
+    }
+
+    m_ring_frame_nbs[slot] = in_out_frame.m_frame_nb;
+    m_last_frame_nb        = in_out_frame.m_frame_nb;
+    m_last_valid           = true;
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void writeNext()
+ * \brief  integrate the next chunk of the current frame, waits a short delay if there is none
+ *         (called by the threads)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraAzimuthalIntegrator::writeNext()
+{
+    std::size_t chunk_index;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex chunks_mutex = chunksLock();
+
+        if((m_frame_data == NULL) || (m_next_chunk + 1 >= m_chunk_bins.size()))
+        {
+            m_chunks_cond.wait(g_wait_delay_sec);
+
+            if((m_frame_data == NULL) || (m_next_chunk + 1 >= m_chunk_bins.size()))
+                return;
+        }
+
+        chunk_index = m_next_chunk++;
+    }
+
+    integrateChunk(chunk_index);
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex chunks_mutex = chunksLock();
+
+        m_done_chunks_nb++;
+        m_chunks_cond.broadcast();
+    }
+}
+
+/****************************************************************************************************
+ * \fn void integrateChunk(std::size_t in_chunk_index)
+ * \brief  integrate the bins of a chunk into the current profile. The mean and the variance of
+ *         a bin are computed in two passes over its row, which keeps the variance accurate.
+ *         The chunks are disjoint, so they are integrated without lock.
+ * \param  in_chunk_index index of the chunk
+ * \return none
+ ****************************************************************************************************/
+void CameraAzimuthalIntegrator::integrateChunk(std::size_t in_chunk_index)
+{
+    for(std::size_t bin = m_chunk_bins[in_chunk_index] ; bin < m_chunk_bins[in_chunk_index + 1] ; bin++)
+    {
+        const std::size_t begin  = m_row_offsets[bin];
+        const std::size_t end    = m_row_offsets[bin + 1];
+        const double      weight = m_bin_weights[bin];
+
+        if(weight <= 0.0)
+        {
+            m_frame_intensity[bin] = 0.0f;
+            m_frame_variance [bin] = 0.0f;
+            continue;
+        }
+
+        const uint32_t * columns = m_columns.data() + begin;
+        const float    * weights = m_weights.data() + begin;
+
+        double mean = sumValues(m_frame_data, columns, weights, end - begin) / weight;
+
+        m_frame_intensity[bin] = static_cast<float>(mean);
+        m_frame_variance [bin] = static_cast<float>(sumSquaredDeviations(m_frame_data, columns, weights, end - begin, static_cast<float>(mean)) / weight);
+    }
+}
+
+/****************************************************************************************************
+ * \fn double sumValues(const uint16_t * in_data, const uint32_t * in_columns, const float * in_weights, std::size_t in_elements_nb)
+ * \brief  sum the weighted values of a row of the matrix. With SSE2, four products are computed
+ *         at once and accumulated in double precision (the pixels are loaded one by one, SSE2 has
+ *         no gather instruction).
+ * \param  in_data pixels of the frame
+ * \param  in_columns pixel index of each element
+ * \param  in_weights weight of each element
+ * \param  in_elements_nb number of elements of the row
+ * \return sum of the weighted values
+ ****************************************************************************************************/
+double CameraAzimuthalIntegrator::sumValues(const uint16_t * in_data, const uint32_t * in_columns, const float * in_weights, std::size_t in_elements_nb)
+{
+    double      sum   = 0.0;
+    std::size_t index = 0  ;
+
+#if defined(__SSE2__)
+    __m128d sum_low  = _mm_setzero_pd();
+    __m128d sum_high = _mm_setzero_pd();
+
+    for( ; index + 4 <= in_elements_nb ; index += 4)
+    {
+        __m128 values   = _mm_set_ps(static_cast<float>(in_data[in_columns[index + 3]]),
+                                     static_cast<float>(in_data[in_columns[index + 2]]),
+                                     static_cast<float>(in_data[in_columns[index + 1]]),
+                                     static_cast<float>(in_data[in_columns[index    ]]));
+        __m128 products = _mm_mul_ps(_mm_loadu_ps(in_weights + index), values);
+
+        sum_low  = _mm_add_pd(sum_low , _mm_cvtps_pd(products));
+        sum_high = _mm_add_pd(sum_high, _mm_cvtps_pd(_mm_movehl_ps(products, products)));
+    }
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(sum_low, sum_high));
+    sum = lanes[0] + lanes[1];
+#endif
+
+    for( ; index < in_elements_nb ; index++)
+    {
+        sum += static_cast<double>(in_weights[index] * static_cast<float>(in_data[in_columns[index]]));
+    }
+
+    return sum;
+}
+
+/****************************************************************************************************
+ * \fn double sumSquaredDeviations(const uint16_t * in_data, const uint32_t * in_columns, const float * in_weights, std::size_t in_elements_nb, float in_mean)
+ * \brief  sum the weighted squared deviations to the mean of a row of the matrix (same
+ *         vectorization as sumValues)
+ * \param  in_data pixels of the frame
+ * \param  in_columns pixel index of each element
+ * \param  in_weights weight of each element
+ * \param  in_elements_nb number of elements of the row
+ * \param  in_mean weighted mean of the row
+ * \return sum of the weighted squared deviations
+ ****************************************************************************************************/
+double CameraAzimuthalIntegrator::sumSquaredDeviations(const uint16_t * in_data       ,
+                                                       const uint32_t * in_columns    ,
+                                                       const float    * in_weights    ,
+                                                       std::size_t      in_elements_nb,
+                                                       float            in_mean       )
+{
+    double      sum   = 0.0;
+    std::size_t index = 0  ;
+
+#if defined(__SSE2__)
+    const __m128 mean     = _mm_set1_ps(in_mean);
+    __m128d      sum_low  = _mm_setzero_pd();
+    __m128d      sum_high = _mm_setzero_pd();
+
+    for( ; index + 4 <= in_elements_nb ; index += 4)
+    {
+        __m128 deviations = _mm_sub_ps(_mm_set_ps(static_cast<float>(in_data[in_columns[index + 3]]),
+                                                  static_cast<float>(in_data[in_columns[index + 2]]),
+                                                  static_cast<float>(in_data[in_columns[index + 1]]),
+                                                  static_cast<float>(in_data[in_columns[index    ]])), mean);
+        __m128 products   = _mm_mul_ps(_mm_loadu_ps(in_weights + index), _mm_mul_ps(deviations, deviations));
+
+        sum_low  = _mm_add_pd(sum_low , _mm_cvtps_pd(products));
+        sum_high = _mm_add_pd(sum_high, _mm_cvtps_pd(_mm_movehl_ps(products, products)));
+    }
+
+    double lanes[2];
+    _mm_storeu_pd(lanes, _mm_add_pd(sum_low, sum_high));
+    sum = lanes[0] + lanes[1];
+#endif
+
+    for( ; index < in_elements_nb ; index++)
+    {
+        float deviation = static_cast<float>(in_data[in_columns[index]]) - in_mean;
+
+        sum += static_cast<double>(in_weights[index] * deviation * deviation);
+    }
+
+    return sum;
+}
+
+/****************************************************************************************************
+ * \fn double computePosition(const CameraIntegrationGeometry & in_geometry, double in_x, double in_y)
+ * \brief  compute the radial position of a point of the frame in the unit of the geometry
+ * \param  in_geometry geometry of the experiment
+ * \param  in_x column of the point in frame pixels
+ * \param  in_y row of the point in frame pixels
+ * \return radial position
+ ****************************************************************************************************/
+double CameraAzimuthalIntegrator::computePosition(const CameraIntegrationGeometry & in_geometry, double in_x, double in_y)
+{
+    double radius = sqrt((in_x - in_geometry.m_center_x) * (in_x - in_geometry.m_center_x) +
+                         (in_y - in_geometry.m_center_y) * (in_y - in_geometry.m_center_y));
+
+    if(in_geometry.m_unit == CameraIntegrationGeometry::Radius)
+        return radius;
+
+    double two_theta = atan2(radius * in_geometry.m_pixel_size_um / 1000.0, in_geometry.m_distance_mm);
+
+    if(in_geometry.m_unit == CameraIntegrationGeometry::TwoTheta)
+        return two_theta * 180.0 / M_PI;
+
+    // the wavelength is converted to nanometers
+    return 4.0 * M_PI * sin(two_theta / 2.0) / (in_geometry.m_wavelength_angstrom / 10.0);
+}
+
+/****************************************************************************************************
+ * \fn bool buildMatrix(std::size_t in_width, std::size_t in_height)
+ * \brief  build the sparse matrix of a frame size. Each part of a pixel goes to the bin of its
+ *         center with the weight 1 / (subdivision x subdivision); the parts of a pixel in the
+ *         same bin are merged. The elements of a row are sorted by pixel index, so the frame is
+ *         read forward. The rows are then split in chunks of similar numbers of elements.
+ * \param  in_width frame width in pixels
+ * \param  in_height frame height in pixels
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraAzimuthalIntegrator::buildMatrix(std::size_t in_width, std::size_t in_height)
+{
+    DEB_MEMBER_FUNCT();
+
+    const std::size_t subdivision = m_geometry.m_subdivision;
+    const std::size_t bins_nb     = m_geometry.m_bins_nb;
+    const float       part_weight = 1.0f / static_cast<float>(subdivision * subdivision);
+
+    // positions of the centers of the parts of a pixel
+    std::vector<double> offsets(subdivision);
+
+    for(std::size_t part = 0 ; part < subdivision ; part++)
+        offsets[part] = (static_cast<double>(part) + 0.5) / static_cast<double>(subdivision);
+
+    double min = m_geometry.m_min;
+    double max = m_geometry.m_max;
+
+    // automatic range: all the parts of the frame
+    if(min >= max)
+    {
+        min =  std::numeric_limits<double>::max();
+        max = -std::numeric_limits<double>::max();
+
+        for(std::size_t y = 0 ; y < in_height ; y++)
+        {
+            for(std::size_t x = 0 ; x < in_width ; x++)
+            {
+                for(std::size_t part_y = 0 ; part_y < subdivision ; part_y++)
+                {
+                    for(std::size_t part_x = 0 ; part_x < subdivision ; part_x++)
+                    {
+                        double position = computePosition(m_geometry, static_cast<double>(x) + offsets[part_x], static_cast<double>(y) + offsets[part_y]);
+
+                        min = std::min(min, position);
+                        max = std::max(max, position);
+                    }
+                }
+            }
+        }
+    }
+
+    const double bin_width = (max - min) / static_cast<double>(bins_nb);
+
+    if(!(bin_width > 0.0))
+    {
+        DEB_ERROR() << "CameraAzimuthalIntegrator::buildMatrix - Incorrect radial range: " << min << " to " << max;
+        return false;
+    }
+
+    // the elements are counted by bin, then written at their place
+    std::vector<std::size_t> part_bins   ;
+    std::vector<float>       part_weights;
+    std::vector<uint32_t>    cursors     ;
+
+    part_bins   .reserve(subdivision * subdivision);
+    part_weights.reserve(subdivision * subdivision);
+
+    m_row_offsets.assign(bins_nb + 1, 0);
+
+    for(std::size_t pass = 0 ; pass < 2 ; pass++)
+    {
+        if(pass == 1)
+        {
+            for(std::size_t bin = 0 ; bin < bins_nb ; bin++)
+                m_row_offsets[bin + 1] += m_row_offsets[bin];
+
+            if(m_row_offsets[bins_nb] == 0)
+            {
+                DEB_ERROR() << "CameraAzimuthalIntegrator::buildMatrix - No pixel in the radial range!";
+                return false;
+            }
+
+            m_columns.resize(m_row_offsets[bins_nb]);
+            m_weights.resize(m_row_offsets[bins_nb]);
+            m_bin_weights.assign(bins_nb, 0.0);
+            cursors.assign(m_row_offsets.begin(), m_row_offsets.end() - 1);
+        }
+
+        for(std::size_t y = 0 ; y < in_height ; y++)
+        {
+            for(std::size_t x = 0 ; x < in_width ; x++)
+            {
+                part_bins   .clear();
+                part_weights.clear();
+
+                for(std::size_t part_y = 0 ; part_y < subdivision ; part_y++)
+                {
+                    for(std::size_t part_x = 0 ; part_x < subdivision ; part_x++)
+                    {
+                        double position = computePosition(m_geometry, static_cast<double>(x) + offsets[part_x], static_cast<double>(y) + offsets[part_y]);
+
+                        if((position < min) || (position > max))
+                            continue;
+
+                        std::size_t bin  = std::min(static_cast<std::size_t>((position - min) / bin_width), bins_nb - 1);
+                        std::size_t part = 0;
+
+                        while((part < part_bins.size()) && (part_bins[part] != bin))
+                            part++;
+
+                        if(part == part_bins.size())
+                        {
+                            part_bins   .push_back(bin);
+                            part_weights.push_back(0.0f);
+                        }
+
+                        part_weights[part] += part_weight;
+                    }
+                }
+
+                for(std::size_t part = 0 ; part < part_bins.size() ; part++)
+                {
+                    std::size_t bin = part_bins[part];
+
+                    if(pass == 0)
+                    {
+                        m_row_offsets[bin + 1]++;
+                    }
+                    else
+                    {
+                        uint32_t element = cursors[bin]++;
+
+                        m_columns[element]  = static_cast<uint32_t>(y * in_width + x);
+                        m_weights[element]  = part_weights[part];
+                        m_bin_weights[bin] += static_cast<double>(part_weights[part]);
+                    }
+                }
+            }
+        }
+    }
+
+    m_positions.resize(bins_nb);
+
+    for(std::size_t bin = 0 ; bin < bins_nb ; bin++)
+        m_positions[bin] = static_cast<float>(min + (static_cast<double>(bin) + 0.5) * bin_width);
+
+    // chunks of similar numbers of elements
+    const std::size_t chunk_elements_nb = std::max(static_cast<std::size_t>(1), m_columns.size() / g_chunks_nb);
+    std::size_t       elements_nb       = 0;
+
+    m_chunk_bins.assign(1, 0);
+
+    for(std::size_t bin = 0 ; bin < bins_nb ; bin++)
+    {
+        elements_nb += m_row_offsets[bin + 1] - m_row_offsets[bin];
+
+        if((elements_nb >= chunk_elements_nb) && (bin + 1 < bins_nb))
+        {
+            m_chunk_bins.push_back(bin + 1);
+            elements_nb = 0;
+        }
+    }
+
+    m_chunk_bins.push_back(bins_nb);
+
+    m_matrix_width  = in_width ;
+    m_matrix_height = in_height;
+    m_matrix_valid  = true;
+
+    DEB_TRACE() << "Integration matrix built: " << bins_nb << " bins, " << m_columns.size() << " elements, "
+                << (m_chunk_bins.size() - 1) << " chunks.";
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void releaseThreads()
+ * \brief  stop and release the threads
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraAzimuthalIntegrator::releaseThreads()
+{
+    for(std::size_t thread_index = 0 ; thread_index < m_threads.size() ; thread_index++)
+    {
+        m_threads[thread_index]->stopWriting();
+        delete m_threads[thread_index];
+    }
+
+    m_threads.clear();
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraAzimuthalIntegrator::create()
+{
+    init(new CameraAzimuthalIntegrator());
+}
+
+//###########################################################################
@@ -0,0 +1,575 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraBackgroundSubtraction.cpp
+ * \brief  implementation file of the rolling background subtraction stage (live mode).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraBackgroundSubtraction.h"
+
+// SYSTEM
+#include <cmath>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraBackgroundSubtraction::g_default_cell_size     = 32   ;
+const std::size_t CameraBackgroundSubtraction::g_max_cell_size         = 256  ;
+const double      CameraBackgroundSubtraction::g_default_time_constant = 32.0 ;
+const double      CameraBackgroundSubtraction::g_default_offset        = 100.0;
+
+/****************************************************************************************************
+ * \fn CameraBackgroundSubtraction()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraBackgroundSubtraction::CameraBackgroundSubtraction() : CameraFrameStage("BackgroundSubtraction")
+{
+    DEB_CONSTRUCTOR();
+
+    m_cell_size     = g_default_cell_size    ;
+    m_time_constant = g_default_time_constant;
+    m_offset        = g_default_offset       ;
+
+    m_width       = 0;
+    m_height      = 0;
+    m_grid_width  = 0;
+    m_grid_height = 0;
+    m_grid_cell   = 0;
+    m_frames_nb   = 0;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraBackgroundSubtraction()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraBackgroundSubtraction::~CameraBackgroundSubtraction()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn bool setCellSize(std::size_t in_cell_size)
+ * \brief  set the size of the cells of the grid. The model is reset at the next acquisition.
+ * \param  in_cell_size size of a square cell in frame pixels (multiple of 8, at most 256)
+ * \return false if the size is incorrect
+ ****************************************************************************************************/
+bool CameraBackgroundSubtraction::setCellSize(std::size_t in_cell_size)
+{
+    DEB_MEMBER_FUNCT();
+
+    // the SSE2 pass needs whole groups of eight pixels in each cell
+    if((in_cell_size == 0) || ((in_cell_size % 8) != 0) || (in_cell_size > g_max_cell_size))
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+    m_cell_size = in_cell_size;
+
+    DEB_TRACE() << "Background cell size: " << in_cell_size;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getCellSize() const
+ * \brief  get the size of the cells of the grid
+ * \param  none
+ * \return size of a square cell in frame pixels
+ ****************************************************************************************************/
+std::size_t CameraBackgroundSubtraction::getCellSize() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+    return m_cell_size;
+}
+
+/****************************************************************************************************
+ * \fn bool setTimeConstant(double in_frames_nb)
+ * \brief  set the time constant of the moving average. Each frame changes the model by the
+ *         inverse of the time constant of its difference with the model.
+ * \param  in_frames_nb time constant in frames (at least 1)
+ * \return false if the time constant is incorrect
+ ****************************************************************************************************/
+bool CameraBackgroundSubtraction::setTimeConstant(double in_frames_nb)
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!(in_frames_nb >= 1.0))
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+    m_time_constant = in_frames_nb;
+
+    DEB_TRACE() << "Background time constant: " << in_frames_nb << " frames";
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn double getTimeConstant() const
+ * \brief  get the time constant of the moving average
+ * \param  none
+ * \return time constant in frames
+ ****************************************************************************************************/
+double CameraBackgroundSubtraction::getTimeConstant() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+    return m_time_constant;
+}
+
+/****************************************************************************************************
+ * \fn bool setOffset(double in_offset)
+ * \brief  set the offset added to the subtracted frames
+ * \param  in_offset offset in ADU (0 to 65535)
+ * \return false if the offset is incorrect
+ ****************************************************************************************************/
+bool CameraBackgroundSubtraction::setOffset(double in_offset)
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!((in_offset >= 0.0) && (in_offset <= 65535.0)))
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+    m_offset = in_offset;
+
+    DEB_TRACE() << "Background offset: " << in_offset;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn double getOffset() const
+ * \brief  get the offset added to the subtracted frames
+ * \param  none
+ * \return offset in ADU
+ ****************************************************************************************************/
+double CameraBackgroundSubtraction::getOffset() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+    return m_offset;
+}
+
+/****************************************************************************************************
+ * \fn void reset()
+ * \brief  forget the model, the next frame initializes it (after a change of the scene)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraBackgroundSubtraction::reset()
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+    m_frames_nb = 0;
+
+    DEB_TRACE() << "Background model reset";
+}
+
+/****************************************************************************************************
+ * \fn void getModel(CameraBackgroundModel & out_model) const
+ * \brief  get a copy of the model
+ * \param  out_model copy of the model (no value before the first frame)
+ * \return none
+ ****************************************************************************************************/
+void CameraBackgroundSubtraction::getModel(CameraBackgroundModel & out_model) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    out_model.m_cell_size = m_grid_cell  ;
+    out_model.m_width     = m_grid_width ;
+    out_model.m_height    = m_grid_height;
+    out_model.m_frames_nb = m_frames_nb  ;
+
+    if(m_frames_nb > 0)
+    {
+        out_model.m_values = m_model;
+    }
+    else
+    {
+        out_model.m_values.clear();
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition. The model is kept between the acquisitions
+ *         of the same frame size, so the live mode restarts with a converged background.
+ * \param  in_format format of the next frames
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraBackgroundSubtraction::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!isEnabled())
+        return true;
+
+    if(in_format.m_pixel_depth > 16)
+    {
+        DEB_ERROR() << "CameraBackgroundSubtraction::prepareAcq - Incorrect pixel depth: " << in_format.m_pixel_depth;
+        return false;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if((in_format.m_width != m_width) || (in_format.m_height != m_height) || (m_cell_size != m_grid_cell))
+    {
+        buildGrid(in_format.m_width, in_format.m_height);
+    }
+
+    std::fill(m_cell_sums.begin(), m_cell_sums.end(), 0);
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void buildGrid(std::size_t in_width, std::size_t in_height)
+ * \brief  build the grid of a frame size, the model is reset (the caller must hold the stage lock)
+ * \param  in_width frame width in pixels
+ * \param  in_height frame height in pixels
+ * \return none
+ ****************************************************************************************************/
+void CameraBackgroundSubtraction::buildGrid(std::size_t in_width, std::size_t in_height)
+{
+    DEB_MEMBER_FUNCT();
+
+    m_width       = in_width ;
+    m_height      = in_height;
+    m_grid_cell   = m_cell_size;
+    m_grid_width  = (in_width  + m_grid_cell - 1) / m_grid_cell;
+    m_grid_height = (in_height + m_grid_cell - 1) / m_grid_cell;
+    m_frames_nb   = 0;
+
+    std::size_t cells_nb = m_grid_width * m_grid_height;
+
+    m_model.assign    (cells_nb, 0.0f);
+    m_cell_sums.assign(cells_nb, 0   );
+    m_cell_pixels.resize(cells_nb);
+    m_expanded.assign(m_grid_height * in_width, 0.0f);
+
+    // the last cells of a row or of a column can be smaller
+    for(std::size_t cell_y = 0 ; cell_y < m_grid_height ; cell_y++)
+    {
+        std::size_t rows_nb = std::min(m_grid_cell, in_height - cell_y * m_grid_cell);
+
+        for(std::size_t cell_x = 0 ; cell_x < m_grid_width ; cell_x++)
+        {
+            std::size_t columns_nb = std::min(m_grid_cell, in_width - cell_x * m_grid_cell);
+            m_cell_pixels[cell_y * m_grid_width + cell_x] = static_cast<float>(rows_nb * columns_nb);
+        }
+    }
+
+    computeWeights(in_width , m_grid_cell, m_column_cells, m_column_weights);
+    computeWeights(in_height, m_grid_cell, m_row_cells   , m_row_weights   );
+
+    DEB_TRACE() << "Background grid: " << m_grid_width << "x" << m_grid_height << " cells of " << m_grid_cell << " pixels";
+}
+
+/****************************************************************************************************
+ * \fn void computeWeights(std::size_t in_size, std::size_t in_cell_size, std::vector<uint32_t> & out_cells, std::vector<float> & out_weights)
+ * \brief  compute the interpolation cell and weight of each pixel along an axis. A pixel is
+ *         interpolated between the centers of the cell before it and of the cell after it.
+ *         The pixels before the first center or after the last one take the value of the cell.
+ * \param  in_size number of pixels along the axis
+ * \param  in_cell_size size of the cells
+ * \param  out_cells first cell of the interpolation of each pixel
+ * \param  out_weights weight of the next cell of each pixel
+ * \return none
+ ****************************************************************************************************/
+void CameraBackgroundSubtraction::computeWeights(std::size_t             in_size      ,
+                                                 std::size_t             in_cell_size ,
+                                                 std::vector<uint32_t> & out_cells    ,
+                                                 std::vector<float>    & out_weights  )
+{
+    std::size_t         cells_nb = (in_size + in_cell_size - 1) / in_cell_size;
+    std::vector<double> centers(cells_nb);
+
+    for(std::size_t cell = 0 ; cell < cells_nb ; cell++)
+    {
+        centers[cell] = static_cast<double>(cell * in_cell_size) + 0.5 * static_cast<double>(std::min(in_cell_size, in_size - cell * in_cell_size));
+    }
+
+    out_cells.resize  (in_size);
+    out_weights.resize(in_size);
+
+    std::size_t cell = 0;
+
+    for(std::size_t pixel = 0 ; pixel < in_size ; pixel++)
+    {
+        double position = static_cast<double>(pixel) + 0.5;
+
+        while(((cell + 2) < cells_nb) && (position >= centers[cell + 1]))
+        {
+            cell++;
+        }
+
+        double weight = 0.0;
+
+        if(cells_nb > 1)
+        {
+            weight = (position - centers[cell]) / (centers[cell + 1] - centers[cell]);
+            weight = std::min(std::max(weight, 0.0), 1.0);
+        }
+
+        out_cells  [pixel] = static_cast<uint32_t>(cell);
+        out_weights[pixel] = static_cast<float>(weight);
+    }
+}
+
+/****************************************************************************************************
+ * \fn void expandModel()
+ * \brief  interpolate the model along the rows at each frame column, so the subtraction pass
+ *         only mixes two expanded rows (the caller must hold the stage lock)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraBackgroundSubtraction::expandModel()
+{
+    std::size_t last_cell = m_grid_width - 1;
+
+    for(std::size_t cell_y = 0 ; cell_y < m_grid_height ; cell_y++)
+    {
+        const float * model    = &m_model[cell_y * m_grid_width];
+        float       * expanded = &m_expanded[cell_y * m_width];
+
+        for(std::size_t x = 0 ; x < m_width ; x++)
+        {
+            std::size_t cell   = m_column_cells  [x];
+            float       weight = m_column_weights[x];
+
+            expanded[x] = model[cell] + weight * (model[std::min(cell + 1, last_cell)] - model[cell]);
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn void initModel(const uint16_t * in_data)
+ * \brief  initialize the model with the means of the cells of a frame. This extra pass is only
+ *         done for the first frame. (the caller must hold the stage lock)
+ * \param  in_data frame pixels
+ * \return none
+ ****************************************************************************************************/
+void CameraBackgroundSubtraction::initModel(const uint16_t * in_data)
+{
+    std::fill(m_cell_sums.begin(), m_cell_sums.end(), 0);
+
+    for(std::size_t y = 0 ; y < m_height ; y++)
+    {
+        const uint16_t * row  = in_data + y * m_width;
+        uint64_t       * sums = &m_cell_sums[(y / m_grid_cell) * m_grid_width];
+
+        for(std::size_t x = 0 ; x < m_width ; x++)
+        {
+            sums[x / m_grid_cell] += row[x];
+        }
+    }
+
+    for(std::size_t cell = 0 ; cell < m_model.size() ; cell++)
+    {
+        m_model    [cell] = static_cast<float>(m_cell_sums[cell]) / m_cell_pixels[cell];
+        m_cell_sums[cell] = 0;
+    }
+
+    expandModel();
+}
+
+/****************************************************************************************************
+ * \fn void subtractAndSumCells(uint16_t * in_out_data)
+ * \brief  subtract the model from a frame and sum its raw pixels into the cells, in a single
+ *         pass (the caller must hold the stage lock).
+ *         With SSE2, eight pixels are summed and subtracted at once. The background of a pixel
+ *         mixes the two expanded rows of its cells rows, it is rounded and subtracted in 32 bits.
+ *         SSE2 has only a signed 32 to 16 bits saturating pack, so the results are shifted by
+ *         32768 before the pack and back after it, which clamps them between 0 and 65535.
+ * \param  in_out_data frame pixels
+ * \return none
+ ****************************************************************************************************/
+void CameraBackgroundSubtraction::subtractAndSumCells(uint16_t * in_out_data)
+{
+    const float       offset      = static_cast<float>(m_offset);
+    const std::size_t last_cell_y = m_grid_height - 1;
+
+#if defined(__SSE2__)
+    const __m128i zero    = _mm_setzero_si128();
+    const __m128i shift32 = _mm_set1_epi32(32768);
+    const __m128i shift16 = _mm_set1_epi16(static_cast<short>(0x8000));
+    const __m128  offsets = _mm_set1_ps(offset);
+#endif
+
+    for(std::size_t y = 0 ; y < m_height ; y++)
+    {
+        uint16_t    * row      = in_out_data + y * m_width;
+        uint64_t    * sums     = &m_cell_sums[(y / m_grid_cell) * m_grid_width];
+        std::size_t   top_cell = m_row_cells[y];
+        const float * top      = &m_expanded[top_cell * m_width];
+        const float * bottom   = &m_expanded[std::min(top_cell + 1, last_cell_y) * m_width];
+        const float   bottom_w = m_row_weights[y];
+        const float   top_w    = 1.0f - bottom_w;
+
+#if defined(__SSE2__)
+        const __m128 top_ws    = _mm_set1_ps(top_w   );
+        const __m128 bottom_ws = _mm_set1_ps(bottom_w);
+#endif
+
+        for(std::size_t cell_x = 0 ; cell_x < m_grid_width ; cell_x++)
+        {
+            std::size_t x   = cell_x * m_grid_cell;
+            std::size_t end = std::min(x + m_grid_cell, m_width);
+            uint64_t    sum = 0;
+
+#if defined(__SSE2__)
+            // at most 32 steps by cell row: the 32 bits lanes can not overflow
+            __m128i lanes = zero;
+
+            for( ; (x + 8) <= end ; x += 8)
+            {
+                __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(row + x));
+                __m128i low    = _mm_unpacklo_epi16(values, zero);
+                __m128i high   = _mm_unpackhi_epi16(values, zero);
+
+                lanes = _mm_add_epi32(lanes, _mm_add_epi32(low, high));
+
+                __m128 background_low  = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(top    + x    ), top_ws   ),
+                                                    _mm_mul_ps(_mm_loadu_ps(bottom + x    ), bottom_ws));
+                __m128 background_high = _mm_add_ps(_mm_mul_ps(_mm_loadu_ps(top    + x + 4), top_ws   ),
+                                                    _mm_mul_ps(_mm_loadu_ps(bottom + x + 4), bottom_ws));
+
+                low  = _mm_sub_epi32(low , _mm_cvtps_epi32(_mm_sub_ps(background_low , offsets)));
+                high = _mm_sub_epi32(high, _mm_cvtps_epi32(_mm_sub_ps(background_high, offsets)));
+
+                __m128i packed = _mm_packs_epi32(_mm_sub_epi32(low, shift32), _mm_sub_epi32(high, shift32));
+
+                _mm_storeu_si128(reinterpret_cast<__m128i *>(row + x), _mm_xor_si128(packed, shift16));
+            }
+
+            uint32_t lane_values[4];
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(lane_values), lanes);
+            sum = static_cast<uint64_t>(lane_values[0]) + lane_values[1] + lane_values[2] + lane_values[3];
+#endif
+
+            for( ; x < end ; x++)
+            {
+                float   background = top_w * top[x] + bottom_w * bottom[x] - offset;
+                int32_t value      = static_cast<int32_t>(row[x]) - static_cast<int32_t>(lrintf(background));
+
+                sum   += row[x];
+                row[x] = static_cast<uint16_t>(std::min(std::max(value, 0), 65535));
+            }
+
+            sums[cell_x] += sum;
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn void updateModel()
+ * \brief  update the model with the sums of the cells of the frame (the caller must hold the
+ *         stage lock). Until the time constant is reached, the model is the mean of the frames,
+ *         so it converges quickly after a reset.
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraBackgroundSubtraction::updateModel()
+{
+    m_frames_nb++;
+
+    float ratio = static_cast<float>(1.0 / std::min(static_cast<double>(m_frames_nb), m_time_constant));
+
+    for(std::size_t cell = 0 ; cell < m_model.size() ; cell++)
+    {
+        float mean = static_cast<float>(m_cell_sums[cell]) / m_cell_pixels[cell];
+
+        m_model    [cell] += ratio * (mean - m_model[cell]);
+        m_cell_sums[cell]  = 0;
+    }
+
+    expandModel();
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  subtract the background from a complete frame and update the model
+ *         (called by the acquisition thread)
+ * \param  in_out_frame frame to correct
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraBackgroundSubtraction::process(CameraFrame & in_out_frame)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    // the stage was enabled after the preparation of the acquisition
+    if((in_out_frame.m_width != m_width) || (in_out_frame.m_height != m_height) || (m_cell_size != m_grid_cell))
+    {
+        buildGrid(in_out_frame.m_width, in_out_frame.m_height);
+    }
+
+    if((m_width == 0) || (m_height == 0))
+        return true;
+
+    if(m_frames_nb == 0)
+    {
+        initModel(in_out_frame.m_data);
+    }
+
+    subtractAndSumCells(in_out_frame.m_data);
+    updateModel();
+
+    return true;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraBackgroundSubtraction::create()
+{
+    init(new CameraBackgroundSubtraction());
+}
+
+//###########################################################################
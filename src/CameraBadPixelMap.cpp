@@ -0,0 +1,678 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraBadPixelMap.cpp
+ * \brief  implementation file of the bad pixel map stage (hot and saturated pixels correction and counting).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraBadPixelMap.h"
+
+// SYSTEM
+#include <cstring>
+#include <cmath>
+#include <fstream>
+#include <sstream>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraBadPixelMap::g_saturated_ring_size      = 1024  ;
+const uint16_t    CameraBadPixelMap::g_default_saturation_level = 0xFFFF;
+
+/****************************************************************************************************
+ * \fn CameraBadPixelMap()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraBadPixelMap::CameraBadPixelMap() : CameraFrameStage("BadPixelMap")
+{
+    DEB_CONSTRUCTOR();
+
+    memset(&m_format, 0, sizeof(CameraFrameFormat));
+
+    m_format.m_orientation = CameraFrameTransform::Normal;
+
+    m_saturation_level         = g_default_saturation_level;
+    m_last_saturated_pixels_nb = 0   ;
+    m_learning_mode            = None;
+    m_learning_frames_nb       = 0   ;
+    m_learning_frames_done     = 0   ;
+    m_learning_threshold       = 0.0 ;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraBadPixelMap()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraBadPixelMap::~CameraBadPixelMap()
+{
+    DEB_DESTRUCTOR();
+}
+
+//==================================================================================================
+// map management
+//==================================================================================================
+/****************************************************************************************************
+ * \fn void clearMap()
+ * \brief  remove all the bad pixels of the map
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraBadPixelMap::clearMap()
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_ccd_bad_pixels.clear();
+    buildCorrections();
+}
+
+/****************************************************************************************************
+ * \fn void addBadPixel(std::size_t in_ccd_x, std::size_t in_ccd_y)
+ * \brief  add a bad pixel (CCD coordinates) into the map
+ * \param  in_ccd_x serial coordinate of the pixel on the CCD (no binning)
+ * \param  in_ccd_y parallel coordinate of the pixel on the CCD (no binning)
+ * \return none
+ ****************************************************************************************************/
+void CameraBadPixelMap::addBadPixel(std::size_t in_ccd_x, std::size_t in_ccd_y)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_ccd_bad_pixels.insert(std::make_pair(static_cast<uint32_t>(in_ccd_y), static_cast<uint32_t>(in_ccd_x)));
+    buildCorrections();
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getBadPixelsNb() const
+ * \brief  get the number of bad pixels of the map
+ * \param  none
+ * \return number of bad pixels (CCD coordinates)
+ ****************************************************************************************************/
+std::size_t CameraBadPixelMap::getBadPixelsNb() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_ccd_bad_pixels.size();
+}
+
+/****************************************************************************************************
+ * \fn bool loadMap(const std::string & in_file_name)
+ * \brief  load the map from a text file (one "x y" CCD coordinates couple per line)
+ *         Empty lines and lines starting with a '#' are ignored.
+ * \param  in_file_name complete path of the file
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraBadPixelMap::loadMap(const std::string & in_file_name)
+{
+    DEB_MEMBER_FUNCT();
+
+    std::ifstream file(in_file_name.c_str());
+
+    if(!file.is_open())
+    {
+        DEB_ERROR() << "CameraBadPixelMap::loadMap - Unable to open the file " << in_file_name;
+        return false;
+    }
+
+    std::set< std::pair<uint32_t, uint32_t> > bad_pixels;
+    std::string line;
+    std::size_t line_nb = 0;
+
+    while(std::getline(file, line))
+    {
+        line_nb++;
+
+        if((line.empty()) || (line[0] == '#'))
+            continue;
+
+        std::istringstream line_stream(line);
+        uint32_t x;
+        uint32_t y;
+
+        if(!(line_stream >> x >> y))
+        {
+            DEB_ERROR() << "CameraBadPixelMap::loadMap - Incorrect line " << line_nb << " in the file " << in_file_name;
+            return false;
+        }
+
+        bad_pixels.insert(std::make_pair(y, x));
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_ccd_bad_pixels.swap(bad_pixels);
+    buildCorrections();
+
+    DEB_TRACE() << "Bad pixel map loaded: " << m_ccd_bad_pixels.size() << " pixels.";
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool saveMap(const std::string & in_file_name) const
+ * \brief  save the map into a text file (one "x y" CCD coordinates couple per line)
+ * \param  in_file_name complete path of the file
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraBadPixelMap::saveMap(const std::string & in_file_name) const
+{
+    DEB_MEMBER_FUNCT();
+
+    std::ofstream file(in_file_name.c_str());
+
+    if(!file.is_open())
+    {
+        DEB_ERROR() << "CameraBadPixelMap::saveMap - Unable to create the file " << in_file_name;
+        return false;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    file << "# SpectralInstrument bad pixel map (CCD serial and parallel coordinates)" << std::endl;
+
+    std::set< std::pair<uint32_t, uint32_t> >::const_iterator it;
+
+    for(it = m_ccd_bad_pixels.begin() ; it != m_ccd_bad_pixels.end() ; ++it)
+    {
+        file << it->second << " " << it->first << std::endl;
+    }
+
+    return file.good();
+}
+
+//==================================================================================================
+// learning management
+//==================================================================================================
+/****************************************************************************************************
+ * \fn void startLearning(LearningMode in_mode, std::size_t in_frames_nb, double in_threshold)
+ * \brief  start a learning during the next acquisition frames
+ *         Dark       : a pixel is hot if its mean is above the mean of all the pixels
+ *                      by more than in_threshold standard deviations.
+ *         Saturation : a pixel is bad if it was saturated in more than in_threshold (ratio 0..1)
+ *                      of the learning frames.
+ * \param  in_mode learning mode (None to cancel a running learning)
+ * \param  in_frames_nb number of frames to accumulate
+ * \param  in_threshold sigma factor (dark) or occurrences ratio (saturation)
+ * \return none
+ ****************************************************************************************************/
+void CameraBadPixelMap::startLearning(LearningMode in_mode, std::size_t in_frames_nb, double in_threshold)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_learning_mode        = (in_frames_nb > 0) ? in_mode : None;
+    m_learning_frames_nb   = in_frames_nb;
+    m_learning_frames_done = 0           ;
+    m_learning_threshold   = in_threshold;
+
+    m_learning_sum.clear        ();
+    m_learning_occurrences.clear();
+
+    DEB_TRACE() << "Starting the bad pixel learning (mode " << static_cast<int>(m_learning_mode) << ") on " << in_frames_nb << " frames.";
+}
+
+/****************************************************************************************************
+ * \fn LearningMode getLearningMode() const
+ * \brief  get the current learning mode (None when no learning is running)
+ * \param  none
+ * \return current learning mode
+ ****************************************************************************************************/
+CameraBadPixelMap::LearningMode CameraBadPixelMap::getLearningMode() const
+{
+    return m_learning_mode;
+}
+
+/****************************************************************************************************
+ * \fn void learnFrame(const CameraFrame & in_frame)
+ * \brief  accumulate a frame into the learning data (the stage lock is already taken)
+ * \param  in_frame complete frame
+ * \return none
+ ****************************************************************************************************/
+void CameraBadPixelMap::learnFrame(const CameraFrame & in_frame)
+{
+    std::size_t pixels_nb = in_frame.m_width * in_frame.m_height;
+
+    // the buffers are allocated with the first learned frame, so the learning follows the current frame format
+    if(m_learning_mode == Dark)
+    {
+        if(m_learning_sum.size() != pixels_nb)
+            m_learning_sum.assign(pixels_nb, 0.0);
+
+        for(std::size_t index = 0 ; index < pixels_nb ; index++)
+        {
+            m_learning_sum[index] += static_cast<double>(in_frame.m_data[index]);
+        }
+    }
+    else
+    if(m_learning_mode == Saturation)
+    {
+        if(m_learning_occurrences.size() != pixels_nb)
+            m_learning_occurrences.assign(pixels_nb, 0);
+
+        for(std::size_t index = 0 ; index < pixels_nb ; index++)
+        {
+            m_learning_occurrences[index] += (in_frame.m_data[index] >= m_saturation_level) ? 1 : 0;
+        }
+    }
+
+    m_learning_frames_done++;
+
+    if(m_learning_frames_done >= m_learning_frames_nb)
+    {
+        terminateLearning();
+    }
+}
+
+/****************************************************************************************************
+ * \fn void terminateLearning()
+ * \brief  compute the learned bad pixels and add them into the map (the stage lock is already taken)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraBadPixelMap::terminateLearning()
+{
+    DEB_MEMBER_FUNCT();
+
+    std::size_t previous_nb = m_ccd_bad_pixels.size();
+
+    if((m_learning_mode == Dark) && (!m_learning_sum.empty()))
+    {
+        // the learning sums are converted to means
+        double frames_nb = static_cast<double>(m_learning_frames_done);
+        double mean      = 0.0;
+        double variance  = 0.0;
+
+        for(std::size_t index = 0 ; index < m_learning_sum.size() ; index++)
+        {
+            m_learning_sum[index] /= frames_nb;
+            mean += m_learning_sum[index];
+        }
+
+        mean /= static_cast<double>(m_learning_sum.size());
+
+        for(std::size_t index = 0 ; index < m_learning_sum.size() ; index++)
+        {
+            double delta = m_learning_sum[index] - mean;
+            variance += delta * delta;
+        }
+
+        variance /= static_cast<double>(m_learning_sum.size());
+
+        double limit = mean + m_learning_threshold * sqrt(variance);
+
+        for(std::size_t index = 0 ; index < m_learning_sum.size() ; index++)
+        {
+            if(m_learning_sum[index] > limit)
+            {
+                addFramePixel(index);
+            }
+        }
+
+        DEB_TRACE() << "Dark learning: mean " << mean << ", sigma " << sqrt(variance) << ", limit " << limit;
+    }
+    else
+    if((m_learning_mode == Saturation) && (!m_learning_occurrences.empty()))
+    {
+        double limit = m_learning_threshold * static_cast<double>(m_learning_frames_done);
+
+        for(std::size_t index = 0 ; index < m_learning_occurrences.size() ; index++)
+        {
+            if((m_learning_occurrences[index] > 0) && (static_cast<double>(m_learning_occurrences[index]) >= limit))
+            {
+                addFramePixel(index);
+            }
+        }
+    }
+
+    DEB_TRACE() << "Bad pixel learning done: " << (m_ccd_bad_pixels.size() - previous_nb) << " new bad pixels.";
+
+    m_learning_mode = None;
+    m_learning_sum.clear        ();
+    m_learning_occurrences.clear();
+
+    buildCorrections();
+}
+
+/****************************************************************************************************
+ * \fn void addFramePixel(std::size_t in_frame_index)
+ * \brief  add all the CCD pixels covered by a frame pixel into the map
+ *         The roi origin is expressed in binned pixels, like the Lima roi.
+ * \param  in_frame_index pixel index in the oriented frame
+ * \return none
+ ****************************************************************************************************/
+void CameraBadPixelMap::addFramePixel(std::size_t in_frame_index)
+{
+    std::size_t source_width ;
+    std::size_t source_height;
+    std::size_t source_x     ;
+    std::size_t source_y     ;
+
+    // coordinates in the image sent by the camera
+    m_transform.inverse().getDestinationSize(m_format.m_width, m_format.m_height, source_width, source_height);
+    m_transform.getSourceCoordinates(in_frame_index, source_width, source_height, source_x, source_y);
+
+    std::size_t ccd_x = (m_format.m_serial_origin   + source_x) * m_format.m_serial_binning  ;
+    std::size_t ccd_y = (m_format.m_parallel_origin + source_y) * m_format.m_parallel_binning;
+
+    for(std::size_t bin_y = 0 ; bin_y < m_format.m_parallel_binning ; bin_y++)
+    {
+        for(std::size_t bin_x = 0 ; bin_x < m_format.m_serial_binning ; bin_x++)
+        {
+            m_ccd_bad_pixels.insert(std::make_pair(static_cast<uint32_t>(ccd_y + bin_y), static_cast<uint32_t>(ccd_x + bin_x)));
+        }
+    }
+}
+
+//==================================================================================================
+// saturation management
+//==================================================================================================
+/****************************************************************************************************
+ * \fn void setSaturationLevel(uint16_t in_saturation_level)
+ * \brief  set the level from which a pixel is considered as saturated
+ * \param  in_saturation_level new saturation level
+ * \return none
+ ****************************************************************************************************/
+void CameraBadPixelMap::setSaturationLevel(uint16_t in_saturation_level)
+{
+    m_saturation_level = (in_saturation_level > 0) ? in_saturation_level : 1;
+}
+
+/****************************************************************************************************
+ * \fn uint16_t getSaturationLevel() const
+ * \brief  get the level from which a pixel is considered as saturated
+ * \param  none
+ * \return saturation level
+ ****************************************************************************************************/
+uint16_t CameraBadPixelMap::getSaturationLevel() const
+{
+    return m_saturation_level;
+}
+
+/****************************************************************************************************
+ * \fn bool getSaturatedPixelsNb(std::size_t in_frame_nb, uint32_t & out_saturated_pixels_nb) const
+ * \brief  get the number of saturated pixels of a frame of the current acquisition
+ *         In continuous acquisition, only the latest frames are kept.
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  out_saturated_pixels_nb number of saturated pixels
+ * \return true if the frame was treated, false if the frame is unknown
+ ****************************************************************************************************/
+bool CameraBadPixelMap::getSaturatedPixelsNb(std::size_t in_frame_nb, uint32_t & out_saturated_pixels_nb) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(m_saturated_pixels_nb.empty())
+        return false;
+
+    if((m_format.m_nb_frames > 0) && (in_frame_nb >= m_saturated_pixels_nb.size()))
+        return false;
+
+    out_saturated_pixels_nb = m_saturated_pixels_nb[in_frame_nb % m_saturated_pixels_nb.size()];
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn uint32_t getLastSaturatedPixelsNb() const
+ * \brief  get the number of saturated pixels of the latest treated frame
+ * \param  none
+ * \return number of saturated pixels
+ ****************************************************************************************************/
+uint32_t CameraBadPixelMap::getLastSaturatedPixelsNb() const
+{
+    return m_last_saturated_pixels_nb;
+}
+
+/****************************************************************************************************
+ * \fn uint32_t countSaturatedPixels(const uint16_t * in_data, std::size_t in_pixels_nb) const
+ * \brief  count the pixels of a frame which reached the saturation level.
+ *         With SSE2, eight pixels are compared at once: a saturating subtraction
+ *         (level - 1) - pixel is null only for the pixels above or at the level.
+ * \param  in_data frame pixels
+ * \param  in_pixels_nb number of pixels
+ * \return number of saturated pixels
+ ****************************************************************************************************/
+uint32_t CameraBadPixelMap::countSaturatedPixels(const uint16_t * in_data, std::size_t in_pixels_nb) const
+{
+    uint32_t    result = 0;
+    std::size_t index  = 0;
+
+#if defined(__SSE2__)
+    const __m128i limit = _mm_set1_epi16(static_cast<short>(m_saturation_level - 1));
+    const __m128i zero  = _mm_setzero_si128();
+
+    for( ; index + 8 <= in_pixels_nb ; index += 8)
+    {
+        __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_data + index));
+        __m128i mask   = _mm_cmpeq_epi16(_mm_subs_epu16(limit, pixels), zero);
+
+        // two mask bits by saturated pixel
+        result += static_cast<uint32_t>(__builtin_popcount(_mm_movemask_epi8(mask))) >> 1;
+    }
+#endif
+
+    for( ; index < in_pixels_nb ; index++)
+    {
+        result += (in_data[index] >= m_saturation_level) ? 1 : 0;
+    }
+
+    return result;
+}
+
+//==================================================================================================
+// processing
+//==================================================================================================
+/****************************************************************************************************
+ * \fn void buildCorrections()
+ * \brief  build the corrections list of the current frame format (the stage lock is already taken).
+ *         Each bad pixel of the frame is associated to its nearest good pixels on the same row,
+ *         so the correction is only a sparse pass on the frame.
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraBadPixelMap::buildCorrections()
+{
+    m_corrections.clear();
+
+    if((m_format.m_width == 0) || (m_format.m_height == 0) || (m_ccd_bad_pixels.empty()))
+        return;
+
+    std::size_t serial_binning   = (m_format.m_serial_binning   > 0) ? m_format.m_serial_binning   : 1;
+    std::size_t parallel_binning = (m_format.m_parallel_binning > 0) ? m_format.m_parallel_binning : 1;
+
+    // size of the image sent by the camera (before the orientation transform)
+    std::size_t source_width ;
+    std::size_t source_height;
+
+    m_transform.inverse().getDestinationSize(m_format.m_width, m_format.m_height, source_width, source_height);
+
+    // oriented frame mask of the bad pixels
+    std::vector<uint8_t> mask(m_format.m_width * m_format.m_height, 0);
+
+    std::set< std::pair<uint32_t, uint32_t> >::const_iterator it;
+
+    for(it = m_ccd_bad_pixels.begin() ; it != m_ccd_bad_pixels.end() ; ++it)
+    {
+        std::size_t binned_x = it->second / serial_binning  ;
+        std::size_t binned_y = it->first  / parallel_binning;
+
+        if((binned_x <  m_format.m_serial_origin  ) || (binned_x >= m_format.m_serial_origin   + source_width ) ||
+           (binned_y <  m_format.m_parallel_origin) || (binned_y >= m_format.m_parallel_origin + source_height))
+            continue;
+
+        mask[m_transform.getDestinationIndex(binned_x - m_format.m_serial_origin  ,
+                                             binned_y - m_format.m_parallel_origin,
+                                             source_width, source_height)] = 1;
+    }
+
+    for(std::size_t y = 0 ; y < m_format.m_height ; y++)
+    {
+        const uint8_t * row = &mask[y * m_format.m_width];
+
+        for(std::size_t x = 0 ; x < m_format.m_width ; x++)
+        {
+            if(!row[x])
+                continue;
+
+            std::size_t left  = x;
+            std::size_t right = x;
+
+            while((left  > 0) && (row[left]))
+                left--;
+
+            while((right < m_format.m_width - 1) && (row[right]))
+                right++;
+
+            // no good pixel on a side: the other side is used
+            if(row[left])
+                left = right;
+
+            if(row[right])
+                right = left;
+
+            // full bad row: the pixel is left as it is
+            if(row[left])
+                continue;
+
+            BadPixelCorrection correction;
+            correction.m_index       = static_cast<uint32_t>(y * m_format.m_width + x    );
+            correction.m_left_index  = static_cast<uint32_t>(y * m_format.m_width + left );
+            correction.m_right_index = static_cast<uint32_t>(y * m_format.m_width + right);
+
+            m_corrections.push_back(correction);
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition
+ * \param  in_format format of the frames of the next acquisition
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraBadPixelMap::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(in_format.m_pixel_depth > 16)
+    {
+        DEB_ERROR() << "CameraBadPixelMap::prepareAcq - Incorrect pixel depth: " << in_format.m_pixel_depth;
+        return false;
+    }
+
+    m_format = in_format;
+    m_transform.setOrientation(m_format.m_orientation);
+    m_last_saturated_pixels_nb = 0;
+
+    // one counter by frame, or a ring buffer for a continuous acquisition
+    m_saturated_pixels_nb.assign((m_format.m_nb_frames > 0) ? m_format.m_nb_frames : g_saturated_ring_size, 0);
+
+    // a learning restarts with the new frame format
+    m_learning_frames_done = 0;
+    m_learning_sum.clear        ();
+    m_learning_occurrences.clear();
+
+    buildCorrections();
+
+    DEB_TRACE() << "Bad pixel map prepared: " << m_corrections.size() << " pixels to correct in the frame.";
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  treat a complete frame: saturated pixels counting, learning and bad pixels correction
+ * \param  in_out_frame frame to treat
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraBadPixelMap::process(CameraFrame & in_out_frame)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    std::size_t pixels_nb = in_out_frame.m_width * in_out_frame.m_height;
+
+    // the counting is done on the raw pixels
+    uint32_t saturated_pixels_nb = countSaturatedPixels(in_out_frame.m_data, pixels_nb);
+
+    if(!m_saturated_pixels_nb.empty())
+    {
+        m_saturated_pixels_nb[in_out_frame.m_frame_nb % m_saturated_pixels_nb.size()] = saturated_pixels_nb;
+    }
+
+    m_last_saturated_pixels_nb = saturated_pixels_nb;
+
+    // the learning is done before the correction to see the raw bad pixels
+    if(m_learning_mode != None)
+    {
+        learnFrame(in_out_frame);
+    }
+
+    // the list is built for the current format: a different frame size means a stage misuse
+    if((in_out_frame.m_width != m_format.m_width) || (in_out_frame.m_height != m_format.m_height))
+        return m_corrections.empty();
+
+    uint16_t * data = in_out_frame.m_data;
+
+    for(std::vector<BadPixelCorrection>::const_iterator it = m_corrections.begin() ; it != m_corrections.end() ; ++it)
+    {
+        data[it->m_index] = static_cast<uint16_t>((static_cast<uint32_t>(data[it->m_left_index]) +
+                                                   static_cast<uint32_t>(data[it->m_right_index]) + 1) >> 1);
+    }
+
+    return true;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraBadPixelMap::create()
+{
+    init(new CameraBadPixelMap());
+}
+
+//###########################################################################
@@ -0,0 +1,268 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraClock.cpp
+ * \brief  implementation file of the plugin clock (real time or fast-forwarded virtual time).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraClock.h"
+
+// SYSTEM
+#include <unistd.h>
+#include <time.h>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const double CameraClock::g_max_time_scale = 100000.0;
+
+/****************************************************************************************************
+ * \fn CameraClock()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraClock::CameraClock()
+{
+    DEB_CONSTRUCTOR();
+
+    m_time_scale        = 1.0;
+    m_origin_system_sec = getSystemMonotonicTimeSec();
+    m_origin_clock_sec  = m_origin_system_sec;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraClock()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraClock::~CameraClock()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex clockLock() const
+ * \brief  creates an autolock mutex for the clock data access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraClock::clockLock() const
+{
+    return lima::AutoMutex(m_clock_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn bool setTimeScale(double in_time_scale)
+ * \brief  set the time scale, the clock time stays continuous
+ * \param  in_time_scale virtual seconds per system second (1 for the real time)
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraClock::setTimeScale(double in_time_scale)
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_time_scale < 1.0) || (in_time_scale > g_max_time_scale))
+    {
+        DEB_ERROR() << "CameraClock::setTimeScale - incorrect time scale " << in_time_scale << "!";
+        return false;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex clock_mutex = clockLock();
+
+    double system_sec = getSystemMonotonicTimeSec();
+
+    m_origin_clock_sec  = computeMonotonicTimeSec(system_sec);
+    m_origin_system_sec = system_sec;
+    m_time_scale        = in_time_scale;
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn double getTimeScale() const
+ * \brief  get the time scale
+ * \param  none
+ * \return virtual seconds per system second
+ ****************************************************************************************************/
+double CameraClock::getTimeScale() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex clock_mutex = clockLock();
+
+    return m_time_scale;
+}
+
+/****************************************************************************************************
+ * \fn bool isVirtual() const
+ * \brief  check if the clock runs in virtual time (the clock can be ahead of the system time
+ *         even after a return to the real time scale)
+ * \param  none
+ * \return true if the clock time differs from the system time
+ ****************************************************************************************************/
+bool CameraClock::isVirtual() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex clock_mutex = clockLock();
+
+    return ((m_time_scale != 1.0) || (m_origin_clock_sec != m_origin_system_sec));
+}
+
+/****************************************************************************************************
+ * \fn double computeMonotonicTimeSec(double in_system_monotonic_sec) const
+ * \brief  compute the clock monotonic time of a system monotonic time (the caller must hold the lock)
+ * \param  in_system_monotonic_sec system monotonic time in seconds
+ * \return clock monotonic time in seconds
+ ****************************************************************************************************/
+double CameraClock::computeMonotonicTimeSec(double in_system_monotonic_sec) const
+{
+    return m_origin_clock_sec + (in_system_monotonic_sec - m_origin_system_sec) * m_time_scale;
+}
+
+/****************************************************************************************************
+ * \fn double getMonotonicTimeSec() const
+ * \brief  get the monotonic time in seconds
+ * \param  none
+ * \return clock monotonic time
+ ****************************************************************************************************/
+double CameraClock::getMonotonicTimeSec() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex clock_mutex = clockLock();
+
+    return computeMonotonicTimeSec(getSystemMonotonicTimeSec());
+}
+
+/****************************************************************************************************
+ * \fn double getRealTimeSec() const
+ * \brief  get the current time in seconds since the epoch
+ *         (same clock than the converted kernel reception times)
+ * \param  none
+ * \return clock time since the epoch
+ ****************************************************************************************************/
+double CameraClock::getRealTimeSec() const
+{
+    return convertRealTimeSec(getSystemRealTimeSec());
+}
+
+/****************************************************************************************************
+ * \fn double convertRealTimeSec(double in_system_time_sec) const
+ * \brief  convert a system time since the epoch (kernel timestamps) into the clock time.
+ *         The system time is placed on the monotonic time line, then stretched like it.
+ * \param  in_system_time_sec system time since the epoch in seconds
+ * \return clock time since the epoch
+ ****************************************************************************************************/
+double CameraClock::convertRealTimeSec(double in_system_time_sec) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex clock_mutex = clockLock();
+
+    if((m_time_scale == 1.0) && (m_origin_clock_sec == m_origin_system_sec))
+        return in_system_time_sec;
+
+    double epoch_offset_sec = getSystemRealTimeSec() - getSystemMonotonicTimeSec();
+
+    return computeMonotonicTimeSec(in_system_time_sec - epoch_offset_sec) + epoch_offset_sec;
+}
+
+/****************************************************************************************************
+ * \fn double toSystemDelaySec(double in_delay_sec) const
+ * \brief  convert a delay of the clock into a system delay (condition and socket timeouts)
+ * \param  in_delay_sec delay of the clock in seconds
+ * \return system delay in seconds
+ ****************************************************************************************************/
+double CameraClock::toSystemDelaySec(double in_delay_sec) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex clock_mutex = clockLock();
+
+    return in_delay_sec / m_time_scale;
+}
+
+/****************************************************************************************************
+ * \fn void sleepMsec(double in_delay_msec) const
+ * \brief  wait a delay of the clock
+ * \param  in_delay_msec delay of the clock in milli-seconds
+ * \return none
+ ****************************************************************************************************/
+void CameraClock::sleepMsec(double in_delay_msec) const
+{
+    if(in_delay_msec <= 0.0)
+        return;
+
+    useconds_t delay_usec = static_cast<useconds_t>(toSystemDelaySec(in_delay_msec / 1000.0) * 1000000.0);
+
+    // a very short wait still gives the processor to the other threads
+    usleep((delay_usec > 0) ? delay_usec : 1);
+}
+
+/****************************************************************************************************
+ * \fn double getSystemMonotonicTimeSec()
+ * \brief  get the system monotonic time in seconds
+ * \param  none
+ * \return system monotonic time
+ ****************************************************************************************************/
+double CameraClock::getSystemMonotonicTimeSec()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+}
+
+/****************************************************************************************************
+ * \fn double getSystemRealTimeSec()
+ * \brief  get the system time in seconds since the epoch
+ * \param  none
+ * \return system time
+ ****************************************************************************************************/
+double CameraClock::getSystemRealTimeSec()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_REALTIME, &time);
+
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraClock::create()
+{
+    init(new CameraClock());
+}
+
+//###########################################################################
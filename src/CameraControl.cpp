@@ -29,6 +29,7 @@
 // PROJECT
 #include "CameraControl.h"
 #include "CameraReceiveDataThread.h"
+#include "CameraClock.h"
 
 // SYSTEM
 #include <netinet/tcp.h>
@@ -41,7 +42,12 @@
 #include <iostream>
 #include <errno.h>  
 #include <sys/time.h>
+#include <sys/socket.h>
+#include <sys/ioctl.h>
+#include <linux/sockios.h>
+#include <time.h>
 #include <sstream>
+#include <algorithm>
 
 // LIMA
 #include "lima/Exceptions.h"
@@ -54,6 +60,11 @@ using namespace lima::SpectralInstrument;
 // #define SPECTRAL_CAMERA_CONTROL_ACTIVATE_PACKET_TRACE
 // #define SPECTRAL_CAMERA_CONTROL_ACTIVATE_LIGHT_PACKET_TRACE
 
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraControl::g_receive_chunk_size = 256 * 1024;
+
 //------------------------------------------------------------------
 // CameraControl class
 //------------------------------------------------------------------
@@ -71,7 +82,7 @@ CameraControl::CameraControl(const CameraControlInit & in_init_parameters)
     m_init_parameters = in_init_parameters;
 
     // changing all the groups'timeout delays...
-    m_packets_container.setDelayBeforeTimeoutSec(m_init_parameters.m_wait_packet_timeout_sec);
+    updateWaitPacketTimeout();
 
     // default values
     m_is_connected  = false;
@@ -109,6 +120,24 @@ CameraControl::CameraControl(const CameraControlInit & in_init_parameters)
 
 	m_sock = -1;
     memset(&m_server_name, 0, sizeof(struct sockaddr_in));
+
+    m_kernel_timestamps = false;
+    m_receive_time      = 0.0  ;
+
+    m_low_latency        = false;
+    m_busy_poll_usec     = 50   ;
+    m_spin_window_usec   = 200  ;
+    m_spin_deadline_nsec = 0    ;
+
+    m_receive_chunk.resize(g_receive_chunk_size);
+
+    m_chunk_begin       = 0;
+    m_chunk_end         = 0;
+    m_chunk_buffered_nb = 0;
+    m_chunk_read_index  = 0;
+
+    m_pixels_per_packet = 0;
+    m_packet_delay_usec = 0;
 }
 
 /****************************************************************************************************
@@ -133,7 +162,19 @@ CameraControl::~CameraControl()
 void CameraControl::computeTimeoutForAcquireCommand()
 {
     int wait_packet_timeout_sec = m_init_parameters.m_maximum_readout_time_sec + static_cast<int>(m_exposure_time_msec / 1000);
-    m_packets_container.setDelayBeforeTimeoutSec(NetCommandHeader::g_function_number_acquire, wait_packet_timeout_sec);
+    m_packets_container.setDelayBeforeTimeoutSec(NetCommandHeader::g_function_number_acquire,
+                                                 CameraClock::getConstInstance()->toSystemDelaySec(wait_packet_timeout_sec));
+}
+
+/****************************************************************************************************
+ * \fn void updateWaitPacketTimeout()
+ * \brief  configure the wait timeout of all the groups (to call after a change of the clock scale)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraControl::updateWaitPacketTimeout()
+{
+    m_packets_container.setDelayBeforeTimeoutSec(CameraClock::getConstInstance()->toSystemDelaySec(m_init_parameters.m_wait_packet_timeout_sec));
 }
 
 /****************************************************************************************************
@@ -351,6 +392,198 @@ ushort CameraControl::getReadoutSpeedFromCamera() const
     return m_readout_speed_value;
 }
 
+/****************************************************************************************************
+ * \fn bool hasKernelTimestamps() const
+ * \brief  check if the reception times are given by the kernel (SO_TIMESTAMPNS)
+ * \param  none
+ * \return true if the kernel timestamps are used, false if the user space time is used
+ ****************************************************************************************************/
+bool CameraControl::hasKernelTimestamps() const
+{
+    return m_kernel_timestamps;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getReceiveQueueBytes() const
+ * \brief  get the number of bytes waiting in the socket receive queue (SIOCINQ)
+ * \param  none
+ * \return number of bytes not yet read by the reception thread (0 in case of error)
+ *         (the received bytes not yet used in the reception buffer are included)
+ ****************************************************************************************************/
+std::size_t CameraControl::getReceiveQueueBytes() const
+{
+    int bytes_nb = 0;
+
+    if((m_sock < 0) || (ioctl(m_sock, SIOCINQ, &bytes_nb) < 0) || (bytes_nb < 0))
+        return 0;
+
+    return static_cast<std::size_t>(bytes_nb) + __sync_fetch_and_add(&m_chunk_buffered_nb, 0);
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getPendingPacketsNb() const
+ * \brief  get the number of received packets waiting for a consumer (all the packets groups)
+ * \param  none
+ * \return number of packets
+ ****************************************************************************************************/
+std::size_t CameraControl::getPendingPacketsNb() const
+{
+    return m_packets_container.getPacketsNb();
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getReceiveBufferSize() const
+ * \brief  get the size of the socket receive buffer (SO_RCVBUF)
+ * \param  none
+ * \return size in bytes (0 in case of error)
+ ****************************************************************************************************/
+std::size_t CameraControl::getReceiveBufferSize() const
+{
+    int       size        = 0;
+    socklen_t size_lenght = sizeof(size);
+
+    if((m_sock < 0) || (getsockopt(m_sock, SOL_SOCKET, SO_RCVBUF, &size, &size_lenght) < 0) || (size < 0))
+        return 0;
+
+    return static_cast<std::size_t>(size);
+}
+
+/****************************************************************************************************
+ * \fn bool getTcpInfo(struct tcp_info & out_info) const
+ * \brief  get the TCP state of the socket (TCP_INFO)
+ * \param  out_info round trip time, retransmissions...
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraControl::getTcpInfo(struct tcp_info & out_info) const
+{
+    socklen_t info_lenght = sizeof(out_info);
+
+    memset(&out_info, 0, sizeof(out_info));
+
+    return ((m_sock >= 0) && (getsockopt(m_sock, IPPROTO_TCP, TCP_INFO, &out_info, &info_lenght) == 0));
+}
+
+/****************************************************************************************************
+ * \fn uint64_t getMonotonicTimeNsec()
+ * \brief  get the monotonic time in nanoseconds
+ * \param  none
+ * \return monotonic time
+ ****************************************************************************************************/
+uint64_t CameraControl::getMonotonicTimeNsec()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<uint64_t>(time.tv_sec) * 1000000000ULL + static_cast<uint64_t>(time.tv_nsec);
+}
+
+/****************************************************************************************************
+ * \fn bool setLowLatencyMode(bool in_enabled, int in_busy_poll_usec, int in_spin_window_usec)
+ * \brief  set the low latency mode of the socket. In this mode, the kernel polls the network
+ *         device during the blocking receptions (SO_BUSY_POLL), the acknowledges are sent
+ *         without delay (TCP_QUICKACK) and the reception thread spins on the socket during
+ *         a short window after the send of each command.
+ *         A busy polling failure is not fatal (raising the value can need CAP_NET_ADMIN).
+ * \param  in_enabled true to activate the low latency mode
+ * \param  in_busy_poll_usec busy polling delay in microseconds
+ * \param  in_spin_window_usec spinning reception window in microseconds
+ * \return true if succeed, false if the parameters are incorrect
+ ****************************************************************************************************/
+bool CameraControl::setLowLatencyMode(bool in_enabled, int in_busy_poll_usec, int in_spin_window_usec)
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_busy_poll_usec < 0) || (in_spin_window_usec < 0))
+        return false;
+
+    m_busy_poll_usec   = in_busy_poll_usec  ;
+    m_spin_window_usec = in_spin_window_usec;
+
+    if(m_sock >= 0)
+    {
+        int busy_poll_usec = (in_enabled) ? in_busy_poll_usec : 0;
+
+        if(setsockopt(m_sock, SOL_SOCKET, SO_BUSY_POLL, &busy_poll_usec, sizeof(busy_poll_usec)) < 0)
+        {
+            DEB_WARNING() << "Can't set busy polling socket option (" << busy_poll_usec << " usec): " << strerror(errno);
+        }
+    }
+
+    // closing the current spinning window
+    __sync_lock_test_and_set(&m_spin_deadline_nsec, 0);
+
+    m_low_latency = in_enabled;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void getLowLatencyMode(bool & out_enabled, int & out_busy_poll_usec, int & out_spin_window_usec) const
+ * \brief  get the low latency mode of the socket
+ * \param  out_enabled true if the low latency mode is active
+ * \param  out_busy_poll_usec busy polling delay in microseconds
+ * \param  out_spin_window_usec spinning reception window in microseconds
+ * \return none
+ ****************************************************************************************************/
+void CameraControl::getLowLatencyMode(bool & out_enabled, int & out_busy_poll_usec, int & out_spin_window_usec) const
+{
+    out_enabled          = m_low_latency     ;
+    out_busy_poll_usec   = m_busy_poll_usec  ;
+    out_spin_window_usec = m_spin_window_usec;
+}
+
+/****************************************************************************************************
+ * \fn bool measureCommandRoundTrip(std::size_t in_nb_commands, CameraRoundTripStatistics & out_statistics)
+ * \brief  measure the round trip times of a series of GetStatus commands
+ *         (send of the command until the reception of its status answer).
+ *         The camera should not be acquiring.
+ * \param  in_nb_commands number of commands to send
+ * \param  out_statistics round trip times statistics
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraControl::measureCommandRoundTrip(std::size_t in_nb_commands, CameraRoundTripStatistics & out_statistics)
+{
+    DEB_MEMBER_FUNCT();
+
+    memset(&out_statistics, 0, sizeof(CameraRoundTripStatistics));
+
+    if(in_nb_commands == 0)
+        return false;
+
+    std::vector<double> round_trips;
+    round_trips.reserve(in_nb_commands);
+
+    for(std::size_t command_index = 0 ; command_index < in_nb_commands ; command_index++)
+    {
+        uint64_t start_nsec = getMonotonicTimeNsec();
+
+        if(!updateStatus())
+        {
+            DEB_ERROR() << "CameraControl::measureCommandRoundTrip - GetStatus command failed!";
+            return false;
+        }
+
+        round_trips.push_back(static_cast<double>(getMonotonicTimeNsec() - start_nsec) * 1e-9);
+    }
+
+    std::sort(round_trips.begin(), round_trips.end());
+
+    double sum = 0.0;
+
+    for(std::size_t command_index = 0 ; command_index < round_trips.size() ; command_index++)
+    {
+        sum += round_trips[command_index];
+    }
+
+    out_statistics.m_commands_nb = round_trips.size();
+    out_statistics.m_min_sec     = round_trips.front();
+    out_statistics.m_max_sec     = round_trips.back ();
+    out_statistics.m_mean_sec    = sum / static_cast<double>(round_trips.size());
+    out_statistics.m_median_sec  = round_trips[round_trips.size() / 2];
+    out_statistics.m_p99_sec     = round_trips[std::min(round_trips.size() - 1, (round_trips.size() * 99) / 100)];
+
+    return true;
+}
+
 /****************************************************************************************************
  * \fn bool notBlockingConnect(struct sockaddr_in & in_out_sa, int in_sock, int in_timeout)
  * \brief  execute a not blocking connect
@@ -565,10 +798,28 @@ void CameraControl::connect(const std::string & in_hostname, int in_port)
         THROW_HW_ERROR(Error) << MsgErr;
     }
 
+    // ask the kernel to give the reception time of the received data (not fatal if not supported)
+    opt = 1;
+
+    m_kernel_timestamps = (setsockopt(m_sock, SOL_SOCKET, SO_TIMESTAMPNS, &opt, sizeof(opt)) == 0);
+
+    if(!m_kernel_timestamps)
+    {
+        DEB_WARNING() << "Can't set kernel timestamps socket option: the reception times will be given by the user space clock.";
+    }
+
     DEB_TRACE() << "Connected to server: " << in_hostname << ":" << in_port;
 
     m_is_connected = true;
 
+    // no data of a previous connection
+    m_chunk_begin       = 0;
+    m_chunk_end         = 0;
+    m_chunk_buffered_nb = 0;
+    m_chunk_read_index  = 0;
+    m_chunk_read_ends.clear ();
+    m_chunk_read_times.clear();
+
     // creating the data reception thread
     CameraReceiveDataThread::create();
     
@@ -634,6 +885,12 @@ bool CameraControl::send(const std::string          & in_command_name,
         DEB_ERROR() << "CameraControl::send(): write to socket error";
         out_error = 1;
     }
+    else
+    // the answer is expected soon: the reception thread spins on the socket during a short window
+    if(m_low_latency)
+    {
+        __sync_lock_test_and_set(&m_spin_deadline_nsec, getMonotonicTimeNsec() + static_cast<uint64_t>(m_spin_window_usec) * 1000ULL);
+    }
 
     return (n >= 0);
 }
@@ -649,6 +906,28 @@ lima::AutoMutex CameraControl::sendCommandLock() const
     return lima::AutoMutex(m_send_command_cond.mutex());
 }
 
+/****************************************************************************************************
+ * \fn lima::AutoMutex parametersLock() const
+ * \brief  creates an autolock mutex for the camera parameters cache access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraControl::parametersLock() const
+{
+    return lima::AutoMutex(m_parameters_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex commandBatchLock() const
+ * \brief  creates an autolock mutex to send only one commands batch at a time
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraControl::commandBatchLock() const
+{
+    return lima::AutoMutex(m_command_batch_cond.mutex());
+}
+
 /****************************************************************************************************
  * \fn bool sendCommand(NetCommandHeader * in_out_command, int32_t & out_error)
  * \brief  Send a command to the detector
@@ -686,9 +965,182 @@ bool CameraControl::sendCommand(NetCommandHeader * in_out_command, int32_t & out
     return send(in_out_command->m_packet_name, net_buffer, out_error);
 }
 
+/****************************************************************************************************
+ * \fn bool receiveChunk(uint8_t * out_buffer, const int in_max_lenght, int & out_lenght, int32_t & out_error)
+ * \brief  Receive the available tcp/ip data with one system call (waits for at least one byte).
+ *         The reception time of the read data is kept in m_receive_time (kernel time
+ *         of the latest socket buffer if SO_TIMESTAMPNS is active, else user space time).
+ * \param  out_buffer     receive buffer
+ * \param  in_max_lenght  receive buffer max size
+ * \param  out_lenght     number of received bytes
+ * \param  out_error      error code
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraControl::receiveChunk(uint8_t * out_buffer, const int in_max_lenght, int & out_lenght, int32_t & out_error)
+{
+    DEB_MEMBER_FUNCT();
+
+    // the control buffer receives the kernel timestamp of the data
+    struct iovec  io;
+    struct msghdr message;
+    char          control[CMSG_SPACE(sizeof(struct timespec))];
+
+    io.iov_base = out_buffer   ;
+    io.iov_len  = in_max_lenght;
+
+    memset(&message, 0, sizeof(struct msghdr));
+    message.msg_iov        = &io;
+    message.msg_iovlen     = 1;
+    message.msg_control    = control;
+    message.msg_controllen = sizeof(control);
+
+    int  n        = -1   ;
+    bool received = false;
+
+    // low latency mode: not blocking receptions until the end of the window opened by the latest command
+    if(m_low_latency)
+    {
+        const uint64_t spin_deadline_nsec = __sync_fetch_and_add(&m_spin_deadline_nsec, 0);
+
+        while(getMonotonicTimeNsec() < spin_deadline_nsec)
+        {
+            n = recvmsg(m_sock, &message, MSG_DONTWAIT);
+
+            if((n >= 0) || ((errno != EAGAIN) && (errno != EWOULDBLOCK)))
+            {
+                received = true;
+                break;
+            }
+        }
+    }
+
+    if(!received)
+    {
+        message.msg_controllen = sizeof(control);
+        n = recvmsg(m_sock, &message, 0);
+    }
+
+    // the quick acknowledge mode is cleared by the kernel, it needs to be set again after each reception
+    if((n > 0) && (m_low_latency))
+    {
+        int opt = 1;
+        setsockopt(m_sock, IPPROTO_TCP, TCP_QUICKACK, &opt, sizeof(opt));
+    }
+
+    // Server returned error code ?
+    if (n <= 0)
+    {
+        if(errno == EAGAIN)
+        {      
+            DEB_WARNING() << "CameraControl::receive(): TIMEOUT occurred!";
+        }
+        else
+        {
+            DEB_ERROR() << "CameraControl::receive(): Could not receive answer.";
+        }
+
+        out_error = errno;
+        return false;
+    }
+
+    out_lenght = n;
+
+    // keeping the reception time of the latest data
+    bool time_found = false;
+
+    if(m_kernel_timestamps)
+    {
+        for(struct cmsghdr * cmsg = CMSG_FIRSTHDR(&message) ; cmsg != NULL ; cmsg = CMSG_NXTHDR(&message, cmsg))
+        {
+            if((cmsg->cmsg_level == SOL_SOCKET) && (cmsg->cmsg_type == SCM_TIMESTAMPNS))
+            {
+                struct timespec time;
+                memcpy(&time, CMSG_DATA(cmsg), sizeof(struct timespec));
+
+                m_receive_time = static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+                time_found     = true;
+            }
+        }
+    }
+
+    if(!time_found)
+    {
+        struct timespec time;
+        clock_gettime(CLOCK_REALTIME, &time);
+
+        m_receive_time = static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+    }
+
+    // the reception times follow the plugin clock (which can run in virtual time)
+    m_receive_time = CameraClock::getConstInstance()->convertRealTimeSec(m_receive_time);
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool appendChunk(int32_t & out_error)
+ * \brief  Append a read of the socket to the data kept in the reception buffer.
+ *         The data not yet used are moved to the start of the buffer when its end is reached.
+ *         The end offset and the reception time of the read are kept, so the data keep the
+ *         reception time of the read which contained them.
+ * \param  out_error      error code
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraControl::appendChunk(int32_t & out_error)
+{
+    DEB_MEMBER_FUNCT();
+
+    // all the data were used: the buffer is restarted
+    if(m_chunk_begin == m_chunk_end)
+    {
+        m_chunk_begin      = 0;
+        m_chunk_end        = 0;
+        m_chunk_read_index = 0;
+        m_chunk_read_ends.clear ();
+        m_chunk_read_times.clear();
+    }
+    else
+    // the end of the buffer is reached: the data not yet used are moved to its start
+    if(m_chunk_end == m_receive_chunk.size())
+    {
+        memmove(m_receive_chunk.data(), m_receive_chunk.data() + m_chunk_begin, m_chunk_end - m_chunk_begin);
+
+        m_chunk_read_ends.erase (m_chunk_read_ends.begin (), m_chunk_read_ends.begin () + m_chunk_read_index);
+        m_chunk_read_times.erase(m_chunk_read_times.begin(), m_chunk_read_times.begin() + m_chunk_read_index);
+
+        for(std::size_t read_index = 0 ; read_index < m_chunk_read_ends.size() ; read_index++)
+        {
+            m_chunk_read_ends[read_index] -= m_chunk_begin;
+        }
+
+        m_chunk_end       -= m_chunk_begin;
+        m_chunk_begin      = 0;
+        m_chunk_read_index = 0;
+    }
+
+    int chunk_lenght = 0;
+
+    if(!receiveChunk(m_receive_chunk.data() + m_chunk_end, static_cast<int>(m_receive_chunk.size() - m_chunk_end), chunk_lenght, out_error))
+        return false;
+
+    m_chunk_end += static_cast<std::size_t>(chunk_lenght);
+
+    m_chunk_read_ends.push_back (m_chunk_end   );
+    m_chunk_read_times.push_back(m_receive_time);
+
+    __sync_lock_test_and_set(&m_chunk_buffered_nb, m_chunk_end - m_chunk_begin);
+
+    return true;
+}
+
 /****************************************************************************************************
  * \fn bool receive(uint8_t * out_buffer, const int in_buffer_lenght, int32_t & out_error)
- * \brief  Receive a tcp/ip packet
+ * \brief  Receive a tcp/ip packet.
+ *         The socket is read by large chunks kept in a reception buffer, so the small headers
+ *         of the packets do not cost a system call each. A block larger than the reception
+ *         buffer is received directly into the destination buffer.
+ *         The reception time of the latest read data is kept in m_receive_time (reception
+ *         time of the socket read which contained the last byte of the data).
  * \param  out_buffer       receive buffer
  * \param  in_buffer_lenght receive buffer max size
  * \param  out_error        error code
@@ -703,38 +1155,47 @@ bool CameraControl::receive(uint8_t * out_buffer, const int in_buffer_lenght, in
 
     int current_answer_lenght = 0;
 
-    // first, receiving the header
     // read, until the expected answer length could be read
     // the answer could be fragmented into several packets
-    for(;;) 
+    while(current_answer_lenght < in_buffer_lenght)
     {
-        int read_max = in_buffer_lenght - current_answer_lenght; // remaining size to read
-        int n        = recv(m_sock, out_buffer + current_answer_lenght, read_max, 0);
+        int remaining = in_buffer_lenght - current_answer_lenght; // remaining size to read
+        int available = static_cast<int>(m_chunk_end - m_chunk_begin); // data already received
+        int n         = 0;
 
-        // Server returned error code ?
-        if (n <= 0)
+        // the buffered data are not enough: a new read is appended to them
+        if((available < remaining) && (static_cast<std::size_t>(remaining) < m_receive_chunk.size()))
         {
-            if(errno == EAGAIN)
-            {      
-                DEB_WARNING() << "CameraControl::receive(): TIMEOUT occurred!";
-            }
-            else
-            {
-                DEB_ERROR() << "CameraControl::receive(): Could not receive answer.";
-            }
-
-            out_error = errno;
-            return false;
+            if(!appendChunk(out_error))
+                return false;
         }
+        else
+        // the data already received are used first
+        if(available > 0)
+        {
+            n = std::min(remaining, available);
 
-        current_answer_lenght += n;
-        
-        // complete data was read, so we can leave the loop
-        if (current_answer_lenght == in_buffer_lenght)
+            memcpy(out_buffer + current_answer_lenght, m_receive_chunk.data() + m_chunk_begin, n);
+
+            m_chunk_begin += n;
+            __sync_lock_test_and_set(&m_chunk_buffered_nb, m_chunk_end - m_chunk_begin);
+
+            // reception time of the read which contained the last used byte
+            while(m_chunk_read_ends[m_chunk_read_index] < m_chunk_begin)
+                m_chunk_read_index++;
+
+            m_receive_time = m_chunk_read_times[m_chunk_read_index];
+        }
+        else
+        // a large block does not need the intermediate copy
         {
-            break;
+            if(!receiveChunk(out_buffer + current_answer_lenght, remaining, n, out_error))
+                return false;
         }
+
+        current_answer_lenght += n;
     }
+
     return true;
 }
 
@@ -767,6 +1228,8 @@ bool CameraControl::receiveSubPacket(NetGenericHeader * out_packet, std::vector<
         DEB_ERROR() << "CameraControl::receiveSubPacket - Error during the buffer copy into the sub packet!";
         return false;
     }
+
+    return true;
 }
 
 /****************************************************************************************************
@@ -839,18 +1302,17 @@ bool CameraControl::receiveSpecificSubPacket(const NetGenericHeader & in_packet
 }
 
 /****************************************************************************************************
- * \fn bool receiveImageSubPacket(const NetGenericHeader & in_packet, const NetGenericAnswer & in_answer_packet, NetGenericHeader * out_packet, std::vector<uint8_t> & in_out_net_buffer, int32_t & out_error)
+ * \fn bool receiveImageSubPacket(const NetGenericHeader & in_packet, const NetImageHeader & in_image_header_packet, std::vector<uint8_t> & in_out_net_buffer, int32_t & out_error)
  * \brief  Receive an image part sub packet with a specific lenght
+ *         (the pixels are only decoded once, by the fill of the complete packet)
  * \param  in_packet              already received sub packet
  * \param  in_image_header_packet already received image header packet
- * \param  out_packet             image to receive 
  * \param  in_out_net_buffer      packet buffer (will grow during the process because data will be concatenated)
  * \param  out_error              error code
  * \return true if succeed, false in case of error
  ****************************************************************************************************/
 bool CameraControl::receiveImageSubPacket(const NetGenericHeader & in_packet             ,
                                           const NetImageHeader   & in_image_header_packet,
-                                          NetImage               * out_packet            ,
                                           std::vector<uint8_t>   & in_out_net_buffer     ,
                                           int32_t                & out_error             )
 {
@@ -864,16 +1326,6 @@ bool CameraControl::receiveImageSubPacket(const NetGenericHeader & in_packet
     if(!receive(in_out_net_buffer.data() + previous_size, in_image_header_packet.m_specific_data_lenght, out_error))
         return false;
 
-    // filling the buffer data into the header members
-    const uint8_t * memory_data = in_out_net_buffer.data() + previous_size;
-    std::size_t     memory_size = in_image_header_packet.m_specific_data_lenght;
-
-    if(!out_packet->read(memory_data, memory_size))
-    {
-        DEB_ERROR() << "CameraControl::receiveImageSubPacket - Error during the buffer copy into the sub packet!";
-        return false;
-    }
-
     return true;
 }
 
@@ -933,6 +1385,9 @@ bool CameraControl::receivePacket(NetGenericHeader * & out_packet, int32_t & out
     header.log();
 #endif
 
+    // reception time of the start of the packet
+    double header_reception_time = m_receive_time;
+
     // checking the camera identifier
     if((header.m_camera_identifier != NetCommandHeader::g_server_command_identifier) &&
        (header.m_camera_identifier != m_init_parameters.m_camera_identifier))
@@ -1184,13 +1639,16 @@ bool CameraControl::receivePacket(NetGenericHeader * & out_packet, int32_t & out
         }
     #endif
 
-        NetImage image;
-
-        if(!receiveImageSubPacket(header, image_header, &image,  net_buffer, out_error))
+        if(!receiveImageSubPacket(header, image_header, net_buffer, out_error))
             return false;
 
-        // it's ok, we can "return" the packet
-        out_packet = new NetImage();
+        // it's ok, we can "return" the packet with its reception times
+        NetImage * received_image = new NetImage();
+
+        received_image->m_header_reception_time = header_reception_time;
+        received_image->m_data_reception_time   = m_receive_time       ;
+
+        out_packet = received_image;
     }
     else
     {
@@ -1601,16 +2059,81 @@ done:
 }
 
 /****************************************************************************************************
- * \fn bool findLineWithKey(const std::string & in_lines, const std::string & in_key, std::string & out_line)
- * \brief  Search and find a line which has the given key
- * \param  in_lines source string which contains the lines
- * \param  in_key    key to search in the lines
- * \param  out_line  found line
- * \return true if succeed, false in case of error
+ * \fn bool sendCommandBatch(const std::vector<NetCommandHeader *> & in_commands, std::vector<bool> & out_accepted)
+ * \brief  Send a batch of commands, then wait for their command done packets.
+ *         The command done packets are queued by function number in the reception order,
+ *         so all the commands are sent before waiting for the first command done and the
+ *         camera executes the batch without waiting for a round trip between two commands.
+ *         The caller must hold the commands batch lock.
+ * \param  in_commands commands to send
+ * \param  out_accepted true for each command which was executed without error
+ * \return true if all the commands were executed without error
  ****************************************************************************************************/
-bool CameraControl::findLineWithKey(const std::string & in_lines ,
-                                    const std::string & in_key   ,
-                                    std::string       & out_line )
+bool CameraControl::sendCommandBatch(const std::vector<NetCommandHeader *> & in_commands, std::vector<bool> & out_accepted)
+{
+    DEB_MEMBER_FUNCT();
+
+    std::size_t sent_nb = 0   ;
+    bool        result  = true;
+    int32_t     error   = 0   ;
+    std::size_t index   ;
+
+    out_accepted.assign(in_commands.size(), false);
+
+    // send the commands and treat the acknowledges
+    for(index = 0 ; index < in_commands.size() ; index++)
+    {
+        if(!sendCommandWithAck(in_commands[index], error))
+        {
+            result = false;
+            break;
+        }
+
+        sent_nb++;
+    }
+
+    // wait for the command done of each sent command
+    for(index = 0 ; index < sent_nb ; index++)
+    {
+        NetGenericHeader * second_packet = NULL;
+        NetGenericAnswer * answer_packet = NULL;
+
+        // the next command done packets of this function would also be missing
+        if(!waitCommandDonePacket(in_commands[index]->m_function_number, second_packet))
+        {
+            result = false;
+            continue;
+        }
+
+        // we need to manage the data 
+        answer_packet = dynamic_cast<NetGenericAnswer *>(second_packet);
+
+        if(answer_packet->hasError())
+        {
+            result = false;
+        }
+        else
+        {
+            out_accepted[index] = true;
+        }
+
+        delete second_packet;
+    }
+
+    return result;
+}
+
+/****************************************************************************************************
+ * \fn bool findLineWithKey(const std::string & in_lines, const std::string & in_key, std::string & out_line)
+ * \brief  Search and find a line which has the given key
+ * \param  in_lines source string which contains the lines
+ * \param  in_key    key to search in the lines
+ * \param  out_line  found line
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraControl::findLineWithKey(const std::string & in_lines ,
+                                    const std::string & in_key   ,
+                                    std::string       & out_line )
 {
     std::string line;
     bool result = false;
@@ -1631,26 +2154,6 @@ bool CameraControl::findLineWithKey(const std::string & in_lines ,
     return result;
 }
 
-/****************************************************************************************************
- * \fn bool findLineWithTwoKey(const std::string & in_lines, const std::string & in_first_key, const std::string & in_second_key, const std::string & in_delimiter, std::string & out_line)
- * \brief  Search and find a line which has the two given keys
- * \param  in_lines source string which contains the lines
- * \param  in_first_key  first key to search in the lines
- * \param  in_second_key second key to search in the lines
- * \param  in_pos        substring delimiter
- * \param  out_line      found line
- * \return true if succeed, false in case of error
- ****************************************************************************************************/
-bool CameraControl::findLineWithTwoKey(const std::string & in_lines     ,
-                                       const std::string & in_first_key ,
-                                       const std::string & in_second_key,
-                                       const std::string & in_delimiter ,
-                                       std::string       & out_line     )
-{
-    std::string key = in_first_key + in_delimiter + in_second_key;
-    return findLineWithKey(in_lines, key, out_line);
-}
-
 /****************************************************************************************************
  * \fn bool getSubString(const std::string & in_string, std::size_t in_pos, const std::string & in_delimiter, std::string & out_sub_string)
  * \brief  Cut a substring with a position and delimiter
@@ -1846,6 +2349,7 @@ done:
 /****************************************************************************************************
  * \fn bool CameraControl::initCameraParameters()
  * \brief  Init some static data (model, serial number, max width, max lenght, pixel depths)
+ *         from the parameters cache, filled with the complete parameters table.
  * \param  none
  * \return true if succeed, false in case of error
  ****************************************************************************************************/
@@ -1853,117 +2357,60 @@ bool CameraControl::initCameraParameters()
 {
     DEB_MEMBER_FUNCT();
 
-    NetAnswerGetCameraParameters * params_packet = NULL;
-
-    int32_t            error         = 0    ;
-    bool               result        = false;
-    NetGenericHeader * second_packet = NULL ;
-    NetCommandHeader * command       = new NetCommandGetCameraParameters();
-
-    std::string        values    ;
-    int                value     ;
-    std::string        line      ;
-    std::string        sub_string;
-
-    // send the command and treat the acknowledge
-    if(!sendCommandWithAck(command, error))
-        goto done;
-
-    // wait for the status
-    if(!waitDataPacket(NetGenericAnswer::g_data_type_get_camera_parameters, second_packet))
-        goto done;
-
-    // we need to manage the data 
-    params_packet = dynamic_cast<NetAnswerGetCameraParameters *>(second_packet);
-
-    if(!params_packet->hasError())
-    {
-        values = params_packet->m_value;
-
-        // get the model
-        if(!findLineWithTwoKey(values, NetAnswerGetCameraParameters::g_server_flags_group_factory_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_instrument_model_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_delimiter,
-                                       line))
-            goto done;
-
-
-        if(!getSubString(line, NetAnswerGetCameraParameters::g_server_flags_value_position, 
-                         NetAnswerGetCameraParameters::g_server_flags_delimiter, m_model))
-            goto done;
-
-        // get the serial number
-        if(!findLineWithTwoKey(values, NetAnswerGetCameraParameters::g_server_flags_group_factory_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_instrument_serial_number_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_delimiter,
-                                       line))
-            goto done;
-
-        if(!getSubString(line, NetAnswerGetCameraParameters::g_server_flags_value_position,
-                         NetAnswerGetCameraParameters::g_server_flags_delimiter, m_serial_number))
-            goto done;
-
-        // get the serial size
-        if(!findLineWithTwoKey(values, NetAnswerGetCameraParameters::g_server_flags_group_factory_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_instrument_serial_size_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_delimiter,
-                                       line))
-            goto done;
-
-        if(!getSubString(line, NetAnswerGetCameraParameters::g_server_flags_value_position,
-                         NetAnswerGetCameraParameters::g_server_flags_delimiter, sub_string))
-            goto done;
+    std::string sub_string;
+    int         value     ;
 
-        if(!convertStringToInt(sub_string, value))
-            goto done;
+    // fill the cache with the complete parameters table
+    if(!updateParameterTable())
+        return false;
 
-        m_width_max = value;
+    // get the model
+    if(!getParameter(NetAnswerGetCameraParameters::g_server_flags_group_factory_name,
+                     NetAnswerGetCameraParameters::g_server_flags_instrument_model_name, m_model))
+        return false;
 
-        // get the parallel size
-        if(!findLineWithTwoKey(values, NetAnswerGetCameraParameters::g_server_flags_group_factory_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_instrument_parallel_size_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_delimiter,
-                                       line))
-            goto done;
+    // get the serial number
+    if(!getParameter(NetAnswerGetCameraParameters::g_server_flags_group_factory_name,
+                     NetAnswerGetCameraParameters::g_server_flags_instrument_serial_number_name, m_serial_number))
+        return false;
 
-        if(!getSubString(line, NetAnswerGetCameraParameters::g_server_flags_value_position,
-                         NetAnswerGetCameraParameters::g_server_flags_delimiter, sub_string))
-            goto done;
+    // get the serial size
+    if(!getParameter(NetAnswerGetCameraParameters::g_server_flags_group_factory_name,
+                     NetAnswerGetCameraParameters::g_server_flags_instrument_serial_size_name, sub_string))
+        return false;
 
-        if(!convertStringToInt(sub_string, value))
-            goto done;
+    if(!convertStringToInt(sub_string, value))
+        return false;
 
-        m_height_max = value;
+    m_width_max = value;
 
-        // get the parallel size
-        if(!findLineWithTwoKey(values, NetAnswerGetCameraParameters::g_server_flags_group_miscellaneous_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_instrument_bits_per_pixel_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_delimiter,
-                                       line))
-            goto done;
+    // get the parallel size
+    if(!getParameter(NetAnswerGetCameraParameters::g_server_flags_group_factory_name,
+                     NetAnswerGetCameraParameters::g_server_flags_instrument_parallel_size_name, sub_string))
+        return false;
 
-        if(!getSubString(line, NetAnswerGetCameraParameters::g_server_flags_value_position,
-                         NetAnswerGetCameraParameters::g_server_flags_delimiter, sub_string))
-            goto done;
+    if(!convertStringToInt(sub_string, value))
+        return false;
 
-        if(!convertStringToInt(sub_string, value))
-            goto done;
+    m_height_max = value;
 
-        m_pixel_depth = value;
+    // get the pixel depth
+    if(!getParameter(NetAnswerGetCameraParameters::g_server_flags_group_miscellaneous_name,
+                     NetAnswerGetCameraParameters::g_server_flags_instrument_bits_per_pixel_name, sub_string))
+        return false;
 
-        result = true;
-    }
+    if(!convertStringToInt(sub_string, value))
+        return false;
 
-done:
-    if(second_packet != NULL) delete second_packet;
-    if(command       != NULL) delete command      ;
+    m_pixel_depth = value;
 
-    return result;
+    return true;
 }
 
 /****************************************************************************************************
  * \fn bool CameraControl::updateSettings()
- * \brief  Update the settings by sending a command to the hardware
+ * \brief  Update the settings by sending a command to the hardware.
+ *         The readout speed is not read here: it is kept up to date by the parameters cache.
  * \param  none
  * \return true if succeed, false in case of error
  ****************************************************************************************************/
@@ -1977,28 +2424,6 @@ bool CameraControl::updateSettings()
     NetGenericHeader     * second_packet   = NULL ;
     NetCommandHeader     * command         = new NetCommandGetSettings();
 
-    NetAnswerGetCameraParameters * params_packet = NULL;
-
-    NetGenericHeader * cam_param_second_packet = NULL ;
-    NetCommandHeader * cam_param_command       = new NetCommandGetCameraParameters();
-
-    std::string        values    ;
-    std::string        line      ;
-    std::string        sub_string;
-    int readout_speed = 0;
-
-    // send the command and treat the acknowledge
-    if(!sendCommandWithAck(cam_param_command, error))
-        goto done;
-
-    // wait for the status
-    if(!waitDataPacket(NetGenericAnswer::g_data_type_get_camera_parameters, cam_param_second_packet))
-        goto done;
-
-    // we need to manage the data 
-    params_packet = dynamic_cast<NetAnswerGetCameraParameters *>(cam_param_second_packet);
-
-
     // send the command and treat the acknowledge
     if(!sendCommandWithAck(command, error))
         goto done;
@@ -2010,7 +2435,6 @@ bool CameraControl::updateSettings()
     // we need to manage the settings data 
     settings_packet = dynamic_cast<NetAnswerGetSettings *>(second_packet);
 
-
     if(!settings_packet->hasError())
     {
         m_exposure_time_msec   = settings_packet->m_exposure_time_msec; 
@@ -2024,26 +2448,70 @@ bool CameraControl::updateSettings()
         m_acquisition_type     = static_cast<NetAnswerGetSettings::AcquisitionType>(settings_packet->m_acquisition_type);
         m_acquisition_mode     = static_cast<NetAnswerGetSettings::AcquisitionMode>(settings_packet->m_acquisition_mode);
         result                 = true;
-
     }
 
+done:
+    if(second_packet != NULL) delete second_packet;
+    if(command       != NULL) delete command      ;
+
+    return result;
+}
+
+/****************************************************************************************************
+ * \fn bool CameraControl::updateParameterTable()
+ * \brief  Fill the camera parameters cache by sending a GetCameraParameters command to the hardware.
+ *         The complete table is only fetched at the initialization or on a refresh request.
+ * \param  none
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraControl::updateParameterTable()
+{
+    DEB_MEMBER_FUNCT();
+
+    NetAnswerGetCameraParameters * params_packet = NULL;
+
+    int32_t              error         = 0    ;
+    bool                 result        = false;
+    NetGenericHeader   * second_packet = NULL ;
+    NetCommandHeader   * command       = new NetCommandGetCameraParameters();
+    CameraParameterTable table         ;
+    std::string          sub_string    ;
+    int                  readout_speed = 0    ;
+
+    // send the command and treat the acknowledge
+    if(!sendCommandWithAck(command, error))
+        goto done;
+
+    // wait for the parameters
+    if(!waitDataPacket(NetGenericAnswer::g_data_type_get_camera_parameters, second_packet))
+        goto done;
+
+    // we need to manage the data 
+    params_packet = dynamic_cast<NetAnswerGetCameraParameters *>(second_packet);
+
     if(!params_packet->hasError())
     {
-        values = params_packet->m_value;
-
-        if(!findLineWithTwoKey(values, NetAnswerGetCameraParameters::g_server_flags_group_control_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_control_dsi_sample_time_name,
-                                       NetAnswerGetCameraParameters::g_server_flags_delimiter,
-                                       line))
+        if(!table.parse(params_packet->m_value,
+                        NetAnswerGetCameraParameters::g_server_flags_delimiter,
+                        NetAnswerGetCameraParameters::g_server_flags_value_position))
+        {
+            DEB_ERROR() << "CameraControl::updateParameterTable - no parameter found in the camera answer!";
             goto done;
+        }
 
-        if(!getSubString(line, NetAnswerGetCameraParameters::g_server_flags_value_position,
-                         NetAnswerGetCameraParameters::g_server_flags_delimiter, sub_string))
-            goto done;
+        // the readout speed is also kept with the settings
+        if(table.getValue(NetAnswerGetCameraParameters::g_server_flags_group_control_name,
+                          NetAnswerGetCameraParameters::g_server_flags_control_dsi_sample_time_name, sub_string) &&
+           convertStringToInt(sub_string, readout_speed))
+        {
+            m_readout_speed_value = static_cast<ushort>(readout_speed);
+        }
 
-        if(!convertStringToInt(sub_string, readout_speed) )
-            goto done;
-        m_readout_speed_value = static_cast<ushort>(readout_speed);
+        // protecting the multi-threads access
+        lima::AutoMutex parameters_mutex = parametersLock(); 
+        m_parameters = table;
+
+        result = true;
     }
 
 done:
@@ -2053,6 +2521,259 @@ done:
     return result;
 }
 
+/****************************************************************************************************
+ * \fn bool CameraControl::getParameter(const std::string & in_group, const std::string & in_name, std::string & out_value) const
+ * \brief  get the value of a camera parameter from the cache (no command is sent)
+ * \param  in_group  parameter group
+ * \param  in_name   parameter name
+ * \param  out_value parameter value
+ * \return true if succeed, false if the parameter is unknown
+ ****************************************************************************************************/
+bool CameraControl::getParameter(const std::string & in_group, const std::string & in_name, std::string & out_value) const
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex parameters_mutex = parametersLock(); 
+
+    if(!m_parameters.getValue(in_group, in_name, out_value))
+    {
+        DEB_ERROR() << "CameraControl::getParameter - unknown parameter " << in_group << "," << in_name << "!";
+        return false;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool CameraControl::getParameterTable(std::vector<CameraParameter> & out_parameters) const
+ * \brief  get a copy of all the cached camera parameters (no command is sent)
+ * \param  out_parameters parameters in the camera order
+ * \return true if succeed, false if the cache was not filled
+ ****************************************************************************************************/
+bool CameraControl::getParameterTable(std::vector<CameraParameter> & out_parameters) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex parameters_mutex = parametersLock(); 
+
+    out_parameters = m_parameters.getParameters();
+    return !m_parameters.empty();
+}
+
+/****************************************************************************************************
+ * \fn bool CameraControl::setParameters(const std::vector<CameraParameterChange> & in_changes)
+ * \brief  change a batch of camera parameters by sending SetSingleParameter commands to the hardware.
+ *         All the commands are sent before waiting for their command done packets, which are
+ *         received in the sending order. The cache is updated with each accepted change.
+ *         The SetSingleParameter command only contains the parameter name: the group is used
+ *         to check and update the cache.
+ * \param  in_changes parameters changes
+ * \return true if all the changes were accepted, false in case of error
+ ****************************************************************************************************/
+bool CameraControl::setParameters(const std::vector<CameraParameterChange> & in_changes)
+{
+    DEB_MEMBER_FUNCT();
+
+    // only one batch at a time, so the command done packets match the sent commands
+    lima::AutoMutex command_batch_mutex = commandBatchLock(); 
+
+    std::vector<NetCommandHeader *> commands;
+    std::vector<bool>               accepted;
+    bool                            result  ;
+    std::size_t                     index   ;
+
+    // all the parameters must be known before sending the first command
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex parameters_mutex = parametersLock(); 
+        CameraParameter parameter;
+
+        for(index = 0 ; index < in_changes.size() ; index++)
+        {
+            if(!m_parameters.find(in_changes[index].m_group, in_changes[index].m_name, parameter))
+            {
+                DEB_ERROR() << "CameraControl::setParameters - unknown parameter " 
+                            << in_changes[index].m_group << "," << in_changes[index].m_name << "!";
+                return false;
+            }
+        }
+    }
+
+    for(index = 0 ; index < in_changes.size() ; index++)
+    {
+        uint32_t value = in_changes[index].m_value;
+        commands.push_back(new NetCommandSetSingleParameter(value, in_changes[index].m_name));
+    }
+
+    result = sendCommandBatch(commands, accepted);
+
+    for(index = 0 ; index < in_changes.size() ; index++)
+    {
+        if(accepted[index])
+        {
+            updateParameterValue(in_changes[index]);
+        }
+        else
+        {
+            DEB_ERROR() << "CameraControl::setParameters - the camera refused the parameter " 
+                        << in_changes[index].m_group << "," << in_changes[index].m_name << "!";
+        }
+
+        delete commands[index];
+    }
+
+    return result;
+}
+
+/****************************************************************************************************
+ * \fn void updateParameterValue(const CameraParameterChange & in_change)
+ * \brief  update the cached value of an accepted parameter change
+ * \param  in_change accepted parameter change
+ * \return none
+ ****************************************************************************************************/
+void CameraControl::updateParameterValue(const CameraParameterChange & in_change)
+{
+    std::ostringstream value;
+
+    value << in_change.m_value;
+
+    // the readout speed is also kept with the settings
+    if((in_change.m_group == NetAnswerGetCameraParameters::g_server_flags_group_control_name) &&
+       (in_change.m_name  == NetAnswerGetCameraParameters::g_server_flags_control_dsi_sample_time_name))
+    {
+        m_readout_speed_value = static_cast<ushort>(in_change.m_value);
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex parameters_mutex = parametersLock(); 
+    m_parameters.setValue(in_change.m_group, in_change.m_name, value.str());
+}
+
+/****************************************************************************************************
+ * \fn void getHardwareSettings(CameraHardwareSettings & out_settings) const
+ * \brief  get the settings sent to the camera by commands
+ * \param  out_settings current settings
+ * \return none
+ ****************************************************************************************************/
+void CameraControl::getHardwareSettings(CameraHardwareSettings & out_settings) const
+{
+    out_settings.m_serial_origin      = m_serial_origin     ;
+    out_settings.m_serial_length      = m_serial_length     ;
+    out_settings.m_serial_binning     = m_serial_binning    ;
+    out_settings.m_parallel_origin    = m_parallel_origin   ;
+    out_settings.m_parallel_length    = m_parallel_length   ;
+    out_settings.m_parallel_binning   = m_parallel_binning  ;
+    out_settings.m_exposure_time_msec = m_exposure_time_msec;
+    out_settings.m_readout_speed      = m_readout_speed_value;
+    out_settings.m_cooling_value      = static_cast<uint8_t>(m_cooling_value);
+    out_settings.m_pixels_per_packet  = m_pixels_per_packet ;
+    out_settings.m_packet_delay_usec  = m_packet_delay_usec ;
+}
+
+/****************************************************************************************************
+ * \fn bool setHardwareSettings(const CameraHardwareSettings & in_settings, std::size_t & out_commands_nb)
+ * \brief  change the settings which differ from the current ones by sending a batch of commands
+ *         to the hardware. The unchanged settings are not sent and the commands are pipelined.
+ *         The packets settings are always sent when they were never configured.
+ *         The format (ROI and binning) and the exposure time are not sent: LIMA keeps its own
+ *         copy of them, so they are applied through the LIMA controls.
+ * \param  in_settings new settings
+ * \param  out_commands_nb number of commands sent
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraControl::setHardwareSettings(const CameraHardwareSettings & in_settings, std::size_t & out_commands_nb)
+{
+    DEB_MEMBER_FUNCT();
+
+    // only one batch at a time, so the command done packets match the sent commands
+    lima::AutoMutex command_batch_mutex = commandBatchLock(); 
+
+    std::vector<NetCommandHeader *> commands;
+    std::vector<bool>               accepted;
+    bool                            result  ;
+    std::size_t                     index   ;
+
+    CameraParameterChange readout_change;
+
+    readout_change.m_group = NetAnswerGetCameraParameters::g_server_flags_group_control_name;
+    readout_change.m_name  = NetAnswerGetCameraParameters::g_server_flags_control_dsi_sample_time_name;
+    readout_change.m_value = static_cast<ushort>(in_settings.m_readout_speed);
+
+    // the readout speed must be known before sending the first command
+    if(readout_change.m_value != m_readout_speed_value)
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex parameters_mutex = parametersLock(); 
+        CameraParameter parameter;
+
+        if(!m_parameters.find(readout_change.m_group, readout_change.m_name, parameter))
+        {
+            DEB_ERROR() << "CameraControl::setHardwareSettings - unknown parameter " 
+                        << readout_change.m_group << "," << readout_change.m_name << "!";
+            return false;
+        }
+    }
+
+    if(readout_change.m_value != m_readout_speed_value)
+    {
+        commands.push_back(new NetCommandSetSingleParameter(readout_change.m_value, readout_change.m_name));
+    }
+
+    if(static_cast<bool>(in_settings.m_cooling_value) != m_cooling_value)
+    {
+        NetCommandSetCoolingValue * command = new NetCommandSetCoolingValue();
+
+        command->m_cooling_value = static_cast<bool>(in_settings.m_cooling_value); 
+        commands.push_back(command);
+    }
+
+    if((in_settings.m_pixels_per_packet != m_pixels_per_packet) ||
+       (in_settings.m_packet_delay_usec != m_packet_delay_usec))
+    {
+        NetCommandConfigurePackets * command = new NetCommandConfigurePackets();
+
+        command->m_pixels_per_packet = in_settings.m_pixels_per_packet;
+        command->m_packet_delay_usec = in_settings.m_packet_delay_usec;
+        commands.push_back(command);
+    }
+
+    out_commands_nb = commands.size();
+
+    result = sendCommandBatch(commands, accepted);
+
+    // update the settings of the executed commands
+    for(index = 0 ; index < commands.size() ; index++)
+    {
+        const uint16_t function_number = commands[index]->m_function_number;
+
+        if(!accepted[index])
+        {
+            DEB_ERROR() << "CameraControl::setHardwareSettings - the camera refused the command " 
+                        << commands[index]->m_packet_name << "!";
+        }
+        else
+        if(function_number == NetCommandHeader::g_function_number_set_single_parameter)
+        {
+            updateParameterValue(readout_change);
+        }
+        else
+        if(function_number == NetCommandHeader::g_function_number_set_cooling_value)
+        {
+            m_cooling_value = static_cast<bool>(in_settings.m_cooling_value);
+        }
+        else
+        if(function_number == NetCommandHeader::g_function_number_configure_packets)
+        {
+            m_pixels_per_packet = in_settings.m_pixels_per_packet;
+            m_packet_delay_usec = in_settings.m_packet_delay_usec;
+        }
+
+        delete commands[index];
+    }
+
+    return result;
+}
+
 /****************************************************************************************************
  * \fn bool setExposureTimeMsec(uint32_t in_exposure_time_msec)
  * \brief  change the exposure time by sending a command to the hardware
@@ -2534,6 +3255,8 @@ bool CameraControl::configurePackets(uint16_t in_pixels_per_packet,
 
     if(!answer_packet->hasError())
     {
+        m_pixels_per_packet = in_pixels_per_packet;
+        m_packet_delay_usec = in_packet_delay_usec;
         result = true;
     }
 
@@ -2600,38 +3323,13 @@ bool CameraControl::setReadoutSpeedValue(uint32_t readout_speed_value)
 {
     DEB_MEMBER_FUNCT();
 
-    int32_t                error           = 0    ;
-    bool                   result          = false;
-    NetGenericHeader     * second_packet   = NULL ;
-    const std::string& readout_speed_name  = "DSI Sample Time\0";
-    NetCommandHeader     * command         = new NetCommandSetSingleParameter(readout_speed_value, readout_speed_name);
-    
-    NetAnswerSetSingleParameter  * answer_packet         = NULL ;
-    NetCommandSetSingleParameter * command_readout_speed_value = dynamic_cast<NetCommandSetSingleParameter *>(command);
+    std::vector<CameraParameterChange> changes(1);
 
-    command_readout_speed_value->m_data_value = static_cast<ushort>(readout_speed_value); 
+    changes[0].m_group = NetAnswerGetCameraParameters::g_server_flags_group_control_name;
+    changes[0].m_name  = NetAnswerGetCameraParameters::g_server_flags_control_dsi_sample_time_name;
+    changes[0].m_value = static_cast<ushort>(readout_speed_value);
 
-    // send the command and treat the acknowledge
-    if(!sendCommandWithAck(command, error))
-        goto done;
-
-    // wait for the command done
-    if(!waitCommandDonePacket(NetCommandHeader::g_function_number_set_single_parameter, second_packet))
-        goto done;
-
-    // we need to manage the data 
-    answer_packet = dynamic_cast<NetAnswerSetSingleParameter *>(second_packet);
-
-    if(!answer_packet->hasError())
-    {
-        result = true;
-    }
-
-done:
-    if(second_packet != NULL) delete second_packet;
-    if(command       != NULL) delete command      ;
-
-    return result;
+    return setParameters(changes);
 }
 
 /****************************************************************************************************
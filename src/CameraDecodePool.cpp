@@ -0,0 +1,544 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraDecodePool.cpp
+ * \brief  implementation file of the image parts decoding threads pool.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraDecodePool.h"
+#include "CameraMosaic.h"
+
+// SYSTEM
+#include <time.h>
+#include <algorithm>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraDecodePool::g_default_batch_size = 4   ;
+const std::size_t CameraDecodePool::g_max_threads_nb     = 16  ;
+const double      CameraDecodePool::g_wait_delay_sec     = 0.1 ;
+
+/****************************************************************************************************
+ * \fn CameraDecodePool()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraDecodePool::CameraDecodePool()
+{
+    DEB_CONSTRUCTOR();
+
+    m_batch_size    = g_default_batch_size;
+    m_frame_data    = NULL ;
+    m_frame_nb      = 0    ;
+    m_mosaic        = false;
+    m_dispatched_nb = 0    ;
+    m_completed_nb  = 0    ;
+    m_in_flight_nb  = 0    ;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraDecodePool()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraDecodePool::~CameraDecodePool()
+{
+    DEB_DESTRUCTOR();
+
+    endFrame      ();
+    releaseThreads();
+
+    for(std::size_t job_index = 0 ; job_index < m_free_jobs.size() ; job_index++)
+    {
+        delete m_free_jobs[job_index];
+    }
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex poolLock() const
+ * \brief  creates an autolock mutex for the pool data access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraDecodePool::poolLock() const
+{
+    return lima::AutoMutex(m_pool_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn bool setThreadsNb(std::size_t in_threads_nb)
+ * \brief  set the number of decoding threads (not during the decoding of a frame)
+ * \param  in_threads_nb number of threads (0 to decode in the acquisition thread)
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraDecodePool::setThreadsNb(std::size_t in_threads_nb)
+{
+    if(in_threads_nb > g_max_threads_nb)
+        return false;
+
+    if(in_threads_nb == m_threads.size())
+        return true;
+
+    releaseThreads();
+
+    for(std::size_t thread_index = 0 ; thread_index < in_threads_nb ; thread_index++)
+    {
+        CameraWriterThread * thread = new CameraWriterThread(this);
+
+        thread->start       ();
+        thread->startWriting();
+
+        m_threads.push_back(thread);
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getThreadsNb() const
+ * \brief  get the number of decoding threads
+ * \param  none
+ * \return number of threads (0 if the acquisition thread decodes the parts)
+ ****************************************************************************************************/
+std::size_t CameraDecodePool::getThreadsNb() const
+{
+    return m_threads.size();
+}
+
+/****************************************************************************************************
+ * \fn bool setBatchSize(std::size_t in_batch_size)
+ * \brief  set the number of image parts of a batch
+ * \param  in_batch_size number of image parts (at least 1)
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraDecodePool::setBatchSize(std::size_t in_batch_size)
+{
+    if(in_batch_size == 0)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex pool_mutex = poolLock();
+
+    m_batch_size = in_batch_size;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getBatchSize() const
+ * \brief  get the number of image parts of a batch
+ * \param  none
+ * \return number of image parts
+ ****************************************************************************************************/
+std::size_t CameraDecodePool::getBatchSize() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex pool_mutex = poolLock();
+
+    return m_batch_size;
+}
+
+/****************************************************************************************************
+ * \fn void startFrame(void * in_data, const lima::FrameDim & in_frame_dim, const CameraFrameTransform & in_transform, std::size_t in_frame_nb, bool in_mosaic)
+ * \brief  start the decoding of a frame (called by the acquisition thread)
+ * \param  in_data frame pixels
+ * \param  in_frame_dim frame data
+ * \param  in_transform orientation applied during the copy of the image parts
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  in_mosaic true if the parts are also copied into the mosaic
+ * \return none
+ ****************************************************************************************************/
+void CameraDecodePool::startFrame(void                       * in_data     ,
+                                  const lima::FrameDim       & in_frame_dim,
+                                  const CameraFrameTransform & in_transform,
+                                  std::size_t                  in_frame_nb ,
+                                  bool                         in_mosaic   )
+{
+    // the parts of a previous frame are released
+    endFrame();
+
+    // protecting the multi-threads access
+    lima::AutoMutex pool_mutex = poolLock();
+
+    m_frame_data = in_data     ;
+    m_frame_dim  = in_frame_dim;
+    m_transform  = in_transform;
+    m_frame_nb   = in_frame_nb ;
+    m_mosaic     = in_mosaic   ;
+}
+
+/****************************************************************************************************
+ * \fn void submit(NetImage & in_out_image)
+ * \brief  give an image part to the pool (called by the acquisition thread).
+ *         The pixels are moved into the pool, the part keeps only its header.
+ * \param  in_out_image received image part
+ * \return none
+ ****************************************************************************************************/
+void CameraDecodePool::submit(NetImage & in_out_image)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex pool_mutex = poolLock();
+
+    CameraDecodeJob * job = NULL;
+
+    if(m_free_jobs.empty())
+    {
+        job = new CameraDecodeJob();
+    }
+    else
+    {
+        job = m_free_jobs.back();
+        m_free_jobs.pop_back();
+    }
+
+    in_out_image.moveTo(job->m_image);
+
+    job->m_done   = false;
+    job->m_result = false;
+
+    m_jobs.push_back(job);
+
+    if(m_jobs.size() - m_dispatched_nb >= m_batch_size)
+    {
+        dispatch();
+    }
+}
+
+/****************************************************************************************************
+ * \fn void dispatch()
+ * \brief  give the parts not yet dispatched to the threads (the caller must hold the lock)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraDecodePool::dispatch()
+{
+    if(m_dispatched_nb == m_jobs.size())
+        return;
+
+    m_batches.push_back(std::vector<CameraDecodeJob *>(m_jobs.begin() + m_dispatched_nb, m_jobs.end()));
+
+    m_in_flight_nb  += m_jobs.size() - m_dispatched_nb;
+    m_dispatched_nb  = m_jobs.size();
+
+    m_pool_cond.broadcast();
+}
+
+/****************************************************************************************************
+ * \fn bool takeCompleted(std::vector<CameraDecodedPart> & out_parts)
+ * \brief  get the parts completed in the reception order since the previous call
+ *         (a part is only given when all the previous parts are completed)
+ * \param  out_parts completed parts (added to the vector)
+ * \return false if the decoding of a part failed
+ ****************************************************************************************************/
+bool CameraDecodePool::takeCompleted(std::vector<CameraDecodedPart> & out_parts)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex pool_mutex = poolLock();
+
+    while((m_completed_nb < m_jobs.size()) && (m_jobs[m_completed_nb]->m_done))
+    {
+        const CameraDecodeJob * job = m_jobs[m_completed_nb];
+
+        if(!job->m_result)
+            return false;
+
+        CameraDecodedPart part;
+        part.m_offset    = static_cast<std::size_t>(job->m_image.m_offset);
+        part.m_pixels_nb = job->m_image.m_image.size();
+
+        out_parts.push_back(part);
+        m_completed_nb++;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool waitFrame()
+ * \brief  wait the decoding of all the parts of the frame (called by the acquisition thread)
+ * \param  none
+ * \return true if all the parts were decoded and copied
+ ****************************************************************************************************/
+bool CameraDecodePool::waitFrame()
+{
+    // protecting the multi-threads access
+    lima::AutoMutex pool_mutex = poolLock();
+
+    dispatch();
+
+    while(m_in_flight_nb > 0)
+    {
+        m_pool_cond.wait(g_wait_delay_sec);
+    }
+
+    for(std::size_t job_index = 0 ; job_index < m_jobs.size() ; job_index++)
+    {
+        if(!m_jobs[job_index]->m_result)
+            return false;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void endFrame()
+ * \brief  end the decoding of a frame (called by the acquisition thread).
+ *         The batches not yet taken by a thread are dropped, the others are waited.
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraDecodePool::endFrame()
+{
+    // protecting the multi-threads access
+    lima::AutoMutex pool_mutex = poolLock();
+
+    while(!m_batches.empty())
+    {
+        m_in_flight_nb -= m_batches.front().size();
+        m_batches.pop_front();
+    }
+
+    while(m_in_flight_nb > 0)
+    {
+        m_pool_cond.wait(g_wait_delay_sec);
+    }
+
+    m_free_jobs.insert(m_free_jobs.end(), m_jobs.begin(), m_jobs.end());
+    m_jobs.clear();
+
+    m_frame_data    = NULL;
+    m_dispatched_nb = 0   ;
+    m_completed_nb  = 0   ;
+}
+
+/****************************************************************************************************
+ * \fn void writeNext()
+ * \brief  decode the next batch, waits a short delay if there is no batch
+ *         (called by the decoding threads)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraDecodePool::writeNext()
+{
+    std::vector<CameraDecodeJob *> batch;
+    void                         * frame_data;
+    lima::FrameDim                 frame_dim ;
+    CameraFrameTransform           transform ;
+    std::size_t                    frame_nb  ;
+    bool                           mosaic    ;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex pool_mutex = poolLock();
+
+        if(m_batches.empty())
+        {
+            m_pool_cond.wait(g_wait_delay_sec);
+
+            if(m_batches.empty())
+                return;
+        }
+
+        batch.swap(m_batches.front());
+        m_batches.pop_front();
+
+        frame_data = m_frame_data;
+        frame_dim  = m_frame_dim ;
+        transform  = m_transform ;
+        frame_nb   = m_frame_nb  ;
+        mosaic     = m_mosaic    ;
+    }
+
+    // the jobs of a taken batch are only used by this thread until they are done
+    for(std::size_t job_index = 0 ; job_index < batch.size() ; job_index++)
+    {
+        CameraDecodeJob * job = batch[job_index];
+
+        job->m_image.convert();
+
+        job->m_result = job->m_image.copy(frame_data, frame_dim, transform);
+
+        if((job->m_result) && (mosaic))
+        {
+            job->m_result = CameraMosaic::getInstance()->copyPart(job->m_image, frame_nb);
+        }
+    }
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex pool_mutex = poolLock();
+
+        for(std::size_t job_index = 0 ; job_index < batch.size() ; job_index++)
+        {
+            batch[job_index]->m_done = true;
+        }
+
+        m_in_flight_nb -= batch.size();
+        m_pool_cond.broadcast();
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool measureScaling(std::size_t in_max_threads_nb, std::size_t in_width, std::size_t in_height, std::size_t in_pixels_per_part, std::vector<CameraDecodeScaling> & out_results)
+ * \brief  measure the decoding throughput of a synthetic frame from 1 to N threads
+ *         (not during an acquisition). The number of threads is restored at the end.
+ * \param  in_max_threads_nb maximum number of threads
+ * \param  in_width frame width in pixels
+ * \param  in_height frame height in pixels
+ * \param  in_pixels_per_part number of pixels of an image part
+ * \param  out_results throughput of each number of threads
+ * \return true if succeed, false if a parameter is incorrect or a decoding failed
+ ****************************************************************************************************/
+bool CameraDecodePool::measureScaling(std::size_t                        in_max_threads_nb ,
+                                      std::size_t                        in_width          ,
+                                      std::size_t                        in_height         ,
+                                      std::size_t                        in_pixels_per_part,
+                                      std::vector<CameraDecodeScaling> & out_results       )
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_max_threads_nb == 0) || (in_max_threads_nb > g_max_threads_nb) ||
+       (in_width  == 0) || (in_width  > 0xFFFF) ||
+       (in_height == 0) || (in_height > 0xFFFF) || (in_pixels_per_part == 0))
+    {
+        DEB_ERROR() << "CameraDecodePool::measureScaling - incorrect parameters!";
+        return false;
+    }
+
+    const std::size_t     pixels_nb       = in_width * in_height;
+    const std::size_t     parts_nb        = (pixels_nb + in_pixels_per_part - 1) / in_pixels_per_part;
+    const std::size_t     previous_nb     = getThreadsNb();
+    std::vector<uint16_t> frame(pixels_nb, 0);
+    lima::FrameDim        frame_dim(Size(static_cast<int>(in_width), static_cast<int>(in_height)), Bpp16);
+    bool                  result          = true;
+
+    out_results.clear();
+
+    for(std::size_t threads_nb = 1 ; (result) && (threads_nb <= in_max_threads_nb) ; threads_nb++)
+    {
+        setThreadsNb(threads_nb);
+
+        // the synthetic parts are built before the measure (pixels in the network byte order)
+        std::vector<NetImage> parts(parts_nb);
+
+        for(std::size_t part_index = 0 ; part_index < parts_nb ; part_index++)
+        {
+            NetImage  & part   = parts[part_index];
+            std::size_t offset = part_index * in_pixels_per_part;
+            std::size_t size   = std::min(in_pixels_per_part, pixels_nb - offset);
+
+            part.m_image_type      = static_cast<uint16_t>(NetCommandRetrieveImage::TransfertType::TransfertU16);
+            part.m_serial_lenght   = static_cast<uint16_t>(in_width );
+            part.m_parallel_lenght = static_cast<uint16_t>(in_height);
+            part.m_offset          = static_cast<int32_t >(offset   );
+            part.m_host_order      = false;
+
+            part.m_image.resize(size);
+
+            for(std::size_t pixel_index = 0 ; pixel_index < size ; pixel_index++)
+            {
+                part.m_image[pixel_index] = static_cast<uint16_t>(offset + pixel_index);
+            }
+        }
+
+        struct timespec start_time;
+        struct timespec end_time  ;
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+
+        startFrame(frame.data(), frame_dim, CameraFrameTransform(), 0, false);
+
+        for(std::size_t part_index = 0 ; part_index < parts_nb ; part_index++)
+        {
+            submit(parts[part_index]);
+        }
+
+        result = waitFrame();
+        endFrame();
+
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+        CameraDecodeScaling scaling;
+
+        scaling.m_threads_nb     = threads_nb;
+        scaling.m_duration_sec   = static_cast<double>(end_time.tv_sec  - start_time.tv_sec ) +
+                                   static_cast<double>(end_time.tv_nsec - start_time.tv_nsec) / 1000000000.0;
+        scaling.m_pixels_per_sec = (scaling.m_duration_sec > 0.0) ? (static_cast<double>(pixels_nb) / scaling.m_duration_sec) : 0.0;
+        scaling.m_speedup        = ((!out_results.empty()) && (out_results.front().m_pixels_per_sec > 0.0)) ?
+                                   (scaling.m_pixels_per_sec / out_results.front().m_pixels_per_sec) : 1.0;
+
+        out_results.push_back(scaling);
+
+        DEB_TRACE() << "CameraDecodePool::measureScaling - " << threads_nb << " threads: "
+                    << scaling.m_pixels_per_sec << " pixels/s (speedup " << scaling.m_speedup << ")";
+    }
+
+    setThreadsNb(previous_nb);
+
+    if(!result)
+    {
+        DEB_ERROR() << "CameraDecodePool::measureScaling - the decoding of the synthetic frame failed!";
+    }
+
+    return result;
+}
+
+/****************************************************************************************************
+ * \fn void releaseThreads()
+ * \brief  stop and release the decoding threads
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraDecodePool::releaseThreads()
+{
+    for(std::size_t thread_index = 0 ; thread_index < m_threads.size() ; thread_index++)
+    {
+        m_threads[thread_index]->stopWriting();
+        delete m_threads[thread_index];
+    }
+
+    m_threads.clear();
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraDecodePool::create()
+{
+    init(new CameraDecodePool());
+}
+
+//###########################################################################
@@ -0,0 +1,885 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFitsWriter.cpp
+ * \brief  implementation file of the FITS writer stage.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraFitsWriter.h"
+#include "CameraControl.h"
+#include "CameraClock.h"
+
+// SYSTEM
+#include <cstring>
+#include <cstdio>
+#include <algorithm>
+#include <errno.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <time.h>
+#include <sys/time.h>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraFitsWriter::g_block_size         = 2880;
+const std::size_t CameraFitsWriter::g_card_size          = 80  ;
+const std::size_t CameraFitsWriter::g_write_buffer_size  = 4 * 1024 * 1024;
+const std::size_t CameraFitsWriter::g_default_buffers_nb = 16  ;
+const double      CameraFitsWriter::g_wait_job_delay_sec = 0.5 ;
+
+/****************************************************************************************************
+ * \fn CameraFitsWriter()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFitsWriter::CameraFitsWriter() : CameraFrameStage("FitsWriter"),
+                                       m_pending_jobs("FitsWriterPendingJobs"),
+                                       m_free_jobs   ("FitsWriterFreeJobs"   )
+{
+    DEB_CONSTRUCTOR();
+
+    m_mode               = OneFilePerFrame;
+    m_path_prefix        = "/tmp/spectral_instrument_";
+    m_buffers_nb         = g_default_buffers_nb;
+    m_created_buffers_nb = 0    ;
+    m_acquisition_nb     = 0    ;
+    m_acquisition_opened = false;
+    m_settings_valid     = false;
+    m_file               = -1   ;
+    m_write_buffer_used  = 0    ;
+    m_write_buffer       = NULL ;
+
+    memset(&m_counters, 0, sizeof(CameraFitsCounters));
+
+    // the buffer is aligned on the memory pages to let the kernel do large copies
+    void * buffer = NULL;
+
+    if(posix_memalign(&buffer, 4096, g_write_buffer_size) == 0)
+    {
+        m_write_buffer = static_cast<uint8_t *>(buffer);
+    }
+
+    m_pending_jobs.setDelayBeforeTimeoutSec(g_wait_job_delay_sec);
+
+    // starting the writer thread
+    m_thread = new CameraWriterThread(this);
+    m_thread->start();
+    m_thread->startWriting();
+}
+
+/****************************************************************************************************
+ * \fn ~CameraFitsWriter()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFitsWriter::~CameraFitsWriter()
+{
+    DEB_DESTRUCTOR();
+
+    // stopping the writer thread
+    m_thread->stopWriting();
+    delete m_thread;
+
+    // the jobs still queued are written before the release
+    while(!m_pending_jobs.empty())
+    {
+        CameraFitsJob * job = m_pending_jobs.take();
+
+        writeJob  (job);
+        releaseJob(job);
+    }
+
+    closeFile();
+    free(m_write_buffer);
+}
+
+/****************************************************************************************************
+ * \fn void setMode(Mode in_mode)
+ * \brief  set the files organization (used from the next acquisition)
+ * \param  in_mode new files organization
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::setMode(Mode in_mode)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_mode = in_mode;
+}
+
+/****************************************************************************************************
+ * \fn Mode getMode() const
+ * \brief  get the files organization
+ * \param  none
+ * \return files organization
+ ****************************************************************************************************/
+CameraFitsWriter::Mode CameraFitsWriter::getMode() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_mode;
+}
+
+/****************************************************************************************************
+ * \fn void setPathPrefix(const std::string & in_path_prefix)
+ * \brief  set the directory and prefix of the files (used from the next acquisition).
+ *         The acquisition index, the frame number and the extension are added to it.
+ * \param  in_path_prefix directory and prefix of the files
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::setPathPrefix(const std::string & in_path_prefix)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_path_prefix    = in_path_prefix;
+    m_acquisition_nb = 0;
+}
+
+/****************************************************************************************************
+ * \fn std::string getPathPrefix() const
+ * \brief  get the directory and prefix of the files
+ * \param  none
+ * \return directory and prefix of the files
+ ****************************************************************************************************/
+std::string CameraFitsWriter::getPathPrefix() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_path_prefix;
+}
+
+/****************************************************************************************************
+ * \fn bool setBuffersNb(std::size_t in_buffers_nb)
+ * \brief  set the number of frame buffers of the queue. The buffers are allocated at the
+ *         preparation of the acquisition and are only released with the writer.
+ * \param  in_buffers_nb number of frame buffers
+ * \return true if succeed, false if the number is incorrect
+ ****************************************************************************************************/
+bool CameraFitsWriter::setBuffersNb(std::size_t in_buffers_nb)
+{
+    if(in_buffers_nb == 0)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_buffers_nb = in_buffers_nb;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getBuffersNb() const
+ * \brief  get the number of frame buffers of the queue
+ * \param  none
+ * \return number of frame buffers
+ ****************************************************************************************************/
+std::size_t CameraFitsWriter::getBuffersNb() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_buffers_nb;
+}
+
+/****************************************************************************************************
+ * \fn CameraFitsCounters getCounters() const
+ * \brief  get the counters since the start of the acquisition
+ * \param  none
+ * \return counters copy
+ ****************************************************************************************************/
+CameraFitsCounters CameraFitsWriter::getCounters() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_counters;
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition. The camera settings are copied for the
+ *         headers (the data update is suspended during the acquisition).
+ * \param  in_format format of the frames
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFitsWriter::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    // closing the files of a previous acquisition
+    endAcq();
+
+    if(!isEnabled())
+        return true;
+
+    if(m_write_buffer == NULL)
+    {
+        DEB_ERROR() << "CameraFitsWriter::prepareAcq - The write buffer could not be allocated!";
+        return false;
+    }
+
+    CameraFitsJob * open_job = new CameraFitsJob();
+    const CameraControl * control = CameraControl::getConstInstance();
+
+    open_job->m_type                      = CameraFitsJob::Open;
+    open_job->m_settings.m_width            = in_format.m_width           ;
+    open_job->m_settings.m_height           = in_format.m_height          ;
+    open_job->m_settings.m_serial_binning   = in_format.m_serial_binning  ;
+    open_job->m_settings.m_parallel_binning = in_format.m_parallel_binning;
+    open_job->m_settings.m_serial_origin    = in_format.m_serial_origin   ;
+    open_job->m_settings.m_parallel_origin  = in_format.m_parallel_origin ;
+    open_job->m_settings.m_exposure_sec     = static_cast<double>(control->getExposureTimeMsec()) / 1000.0;
+    open_job->m_settings.m_ccd_temperature  = static_cast<double>(control->getCCDTemperatureFromCamera());
+    open_job->m_settings.m_readout_speed    = static_cast<int>(control->getReadoutSpeedFromCamera());
+    open_job->m_settings.m_model            = control->getModel       ();
+    open_job->m_settings.m_serial_number    = control->getSerialNumber();
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        open_job->m_settings.m_path_prefix     = m_path_prefix;
+        open_job->m_settings.m_acquisition_nb  = m_acquisition_nb++;
+        open_job->m_settings.m_multi_extension = (m_mode == MultiExtension);
+
+        // the frame buffers are allocated now, so the reception never waits for a memory allocation
+        while(m_created_buffers_nb < m_buffers_nb)
+        {
+            CameraFitsJob * job = new CameraFitsJob();
+            job->m_data.reserve(in_format.m_width * in_format.m_height);
+
+            m_free_jobs.put(job);
+            m_created_buffers_nb++;
+        }
+
+        memset(&m_counters, 0, sizeof(CameraFitsCounters));
+        m_acquisition_opened = true;
+    }
+
+    m_pending_jobs.put(open_job);
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  queue a complete frame for the writing (called by the acquisition thread)
+ * \param  in_out_frame frame to write
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFitsWriter::process(CameraFrame & in_out_frame)
+{
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        if((!m_acquisition_opened) || (in_out_frame.m_drop))
+            return true;
+
+        // no free buffer: the frame is not written, the reception should not wait for the storage
+        if(m_free_jobs.empty())
+        {
+            m_counters.m_dropped_frames_nb++;
+            return true;
+        }
+    }
+
+    CameraFitsJob * job = m_free_jobs.take();
+
+    if(job == NULL)
+        return true;
+
+    // the record is copied with the frame, its ring entry can be reused during the writing
+    if(in_out_frame.m_metadata != NULL)
+    {
+        job->m_metadata = *in_out_frame.m_metadata;
+    }
+    else
+    {
+        memset(&job->m_metadata, 0, sizeof(CameraFrameMetadata));
+        job->m_metadata.m_frame_nb       = static_cast<uint64_t>(in_out_frame.m_frame_nb);
+        job->m_metadata.m_last_part_time = CameraClock::getConstInstance()->getRealTimeSec();
+    }
+
+    job->m_type     = CameraFitsJob::Frame;
+    job->m_width    = in_out_frame.m_width   ;
+    job->m_height   = in_out_frame.m_height  ;
+    job->m_frame_nb = in_out_frame.m_frame_nb;
+    job->m_data.assign(in_out_frame.m_data, in_out_frame.m_data + (in_out_frame.m_width * in_out_frame.m_height));
+
+    m_pending_jobs.put(job);
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+    m_counters.m_queued_frames_nb++;
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void endAcq()
+ * \brief  close the files of the current acquisition (called at the end of the acquisition)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::endAcq()
+{
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        if(!m_acquisition_opened)
+            return;
+
+        m_acquisition_opened = false;
+    }
+
+    CameraFitsJob * close_job = new CameraFitsJob();
+    close_job->m_type = CameraFitsJob::Close;
+
+    m_pending_jobs.put(close_job);
+}
+
+/****************************************************************************************************
+ * \fn void writeNext()
+ * \brief  write the next queued job, waits a short delay if the queue is empty
+ *         (called by the writer thread)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::writeNext()
+{
+    if(!m_pending_jobs.waiting_while_empty())
+        return;
+
+    if(m_pending_jobs.empty())
+        return;
+
+    CameraFitsJob * job = m_pending_jobs.take();
+
+    if(job != NULL)
+    {
+        writeJob  (job);
+        releaseJob(job);
+    }
+}
+
+/****************************************************************************************************
+ * \fn void releaseJob(CameraFitsJob * in_job)
+ * \brief  give a frame buffer back to the free list or release a job
+ * \param  in_job treated job
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::releaseJob(CameraFitsJob * in_job)
+{
+    if(in_job->m_type == CameraFitsJob::Frame)
+    {
+        m_free_jobs.put(in_job);
+    }
+    else
+    {
+        delete in_job;
+    }
+}
+
+/****************************************************************************************************
+ * \fn void writeJob(CameraFitsJob * in_job)
+ * \brief  write a job (called by the writer thread)
+ * \param  in_job job to treat
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::writeJob(CameraFitsJob * in_job)
+{
+    DEB_MEMBER_FUNCT();
+
+    //------------------------------------------------------------------
+    // start of an acquisition
+    if(in_job->m_type == CameraFitsJob::Open)
+    {
+        closeFile();
+
+        m_settings       = in_job->m_settings;
+        m_settings_valid = true;
+
+        // the primary HDU only contains the camera settings
+        if(m_settings.m_multi_extension)
+        {
+            char file_name[32];
+            snprintf(file_name, sizeof(file_name), "%04zu.fits", m_settings.m_acquisition_nb);
+
+            std::string header;
+            addLogicalCard(header, "SIMPLE", true, "file conforms to FITS standard");
+            addIntegerCard(header, "BITPIX", 16  , "number of bits per data pixel");
+            addIntegerCard(header, "NAXIS" , 0   , "no data in the primary HDU");
+            addLogicalCard(header, "EXTEND", true, "one IMAGE extension by frame");
+            addSettingsCards(header, m_settings);
+            endHeader(header);
+
+            if((!openFile(m_settings.m_path_prefix + file_name)) || (!writeBytes(header.data(), header.size())))
+            {
+                closeFile();
+            }
+        }
+    }
+    else
+    //------------------------------------------------------------------
+    // end of an acquisition
+    if(in_job->m_type == CameraFitsJob::Close)
+    {
+        closeFile();
+        m_settings_valid = false;
+    }
+    else
+    //------------------------------------------------------------------
+    // frame
+    {
+        bool        result = false;
+        std::string header;
+
+        if(m_settings_valid)
+        {
+            if(m_settings.m_multi_extension)
+            {
+                if(m_file >= 0)
+                {
+                    addCard       (header, "XTENSION", "'IMAGE   '", "IMAGE extension");
+                    addIntegerCard(header, "BITPIX"  , 16                , "number of bits per data pixel");
+                    addIntegerCard(header, "NAXIS"   , 2                 , "number of data axes");
+                    addIntegerCard(header, "NAXIS1"  , in_job->m_width , "length of data axis 1");
+                    addIntegerCard(header, "NAXIS2"  , in_job->m_height, "length of data axis 2");
+                    addIntegerCard(header, "PCOUNT"  , 0                 , "required keyword");
+                    addIntegerCard(header, "GCOUNT"  , 1                 , "required keyword");
+                    addFrameCards (header, *in_job);
+                    endHeader     (header);
+
+                    result = writeBytes(header.data(), header.size()) && writePixels(*in_job);
+                }
+            }
+            else
+            {
+                char file_name[48];
+                snprintf(file_name, sizeof(file_name), "%04zu_%06zu.fits", m_settings.m_acquisition_nb, in_job->m_frame_nb);
+
+                addLogicalCard  (header, "SIMPLE", true            , "file conforms to FITS standard");
+                addIntegerCard  (header, "BITPIX", 16              , "number of bits per data pixel");
+                addIntegerCard  (header, "NAXIS" , 2               , "number of data axes");
+                addIntegerCard  (header, "NAXIS1", in_job->m_width , "length of data axis 1");
+                addIntegerCard  (header, "NAXIS2", in_job->m_height, "length of data axis 2");
+                addLogicalCard  (header, "EXTEND", true            , "extensions are permitted");
+                addSettingsCards(header, m_settings);
+                addFrameCards   (header, *in_job);
+                endHeader       (header);
+
+                result = openFile(m_settings.m_path_prefix + file_name) &&
+                         writeBytes(header.data(), header.size())       &&
+                         writePixels(*in_job)                           &&
+                         flush();
+
+                closeFile();
+            }
+        }
+
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        if(result)
+        {
+            m_counters.m_written_frames_nb++;
+        }
+        else
+        {
+            m_counters.m_errors_nb++;
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn void addCard(std::string & in_out_header, const std::string & in_key, const std::string & in_value, const std::string & in_comment)
+ * \brief  add a card to a header
+ * \param  in_out_header header to complete
+ * \param  in_key keyword (8 characters maximum)
+ * \param  in_value formatted value
+ * \param  in_comment comment
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::addCard(std::string & in_out_header, const std::string & in_key, const std::string & in_value, const std::string & in_comment)
+{
+    std::string card = in_key.substr(0, 8);
+
+    card.resize(8, ' ');
+    card += "= " + in_value;
+
+    if(!in_comment.empty())
+    {
+        card += " / " + in_comment;
+    }
+
+    card.resize(g_card_size, ' ');
+    in_out_header += card;
+}
+
+/****************************************************************************************************
+ * \fn void addLogicalCard(std::string & in_out_header, const std::string & in_key, bool in_value, const std::string & in_comment)
+ * \brief  add a logical card to a header
+ * \param  in_out_header header to complete
+ * \param  in_key keyword
+ * \param  in_value value
+ * \param  in_comment comment
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::addLogicalCard(std::string & in_out_header, const std::string & in_key, bool in_value, const std::string & in_comment)
+{
+    char value[32];
+    snprintf(value, sizeof(value), "%20s", (in_value) ? "T" : "F");
+
+    addCard(in_out_header, in_key, value, in_comment);
+}
+
+/****************************************************************************************************
+ * \fn void addIntegerCard(std::string & in_out_header, const std::string & in_key, long long in_value, const std::string & in_comment)
+ * \brief  add an integer card to a header
+ * \param  in_out_header header to complete
+ * \param  in_key keyword
+ * \param  in_value value
+ * \param  in_comment comment
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::addIntegerCard(std::string & in_out_header, const std::string & in_key, long long in_value, const std::string & in_comment)
+{
+    char value[32];
+    snprintf(value, sizeof(value), "%20lld", in_value);
+
+    addCard(in_out_header, in_key, value, in_comment);
+}
+
+/****************************************************************************************************
+ * \fn void addDoubleCard(std::string & in_out_header, const std::string & in_key, double in_value, const std::string & in_comment)
+ * \brief  add a floating point card to a header (the value always contains a decimal point)
+ * \param  in_out_header header to complete
+ * \param  in_key keyword
+ * \param  in_value value
+ * \param  in_comment comment
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::addDoubleCard(std::string & in_out_header, const std::string & in_key, double in_value, const std::string & in_comment)
+{
+    char number[32];
+    snprintf(number, sizeof(number), "%.10G", in_value);
+
+    std::string text = number;
+
+    if(text.find_first_of(".E") == std::string::npos)
+    {
+        text += ".0";
+    }
+
+    char value[32];
+    snprintf(value, sizeof(value), "%20s", text.c_str());
+
+    addCard(in_out_header, in_key, value, in_comment);
+}
+
+/****************************************************************************************************
+ * \fn void addStringCard(std::string & in_out_header, const std::string & in_key, const std::string & in_value, const std::string & in_comment)
+ * \brief  add a string card to a header (the quotes are doubled)
+ * \param  in_out_header header to complete
+ * \param  in_key keyword
+ * \param  in_value value
+ * \param  in_comment comment
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::addStringCard(std::string & in_out_header, const std::string & in_key, const std::string & in_value, const std::string & in_comment)
+{
+    std::string text;
+
+    for(std::size_t index = 0 ; (index < in_value.size()) && (text.size() < 66) ; index++)
+    {
+        // only the printable characters are allowed
+        char character = ((in_value[index] >= ' ') && (in_value[index] <= '~')) ? in_value[index] : ' ';
+
+        text += character;
+
+        if(character == '\'')
+        {
+            text += '\'';
+        }
+    }
+
+    // the closing quote is not before the column 20
+    if(text.size() < 8)
+    {
+        text.resize(8, ' ');
+    }
+
+    addCard(in_out_header, in_key, "'" + text + "'", in_comment);
+}
+
+/****************************************************************************************************
+ * \fn void endHeader(std::string & in_out_header)
+ * \brief  add the END card and pad the header to a complete block
+ * \param  in_out_header header to complete
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::endHeader(std::string & in_out_header)
+{
+    std::string card = "END";
+
+    card.resize(g_card_size, ' ');
+    in_out_header += card;
+
+    in_out_header.resize(((in_out_header.size() + g_block_size - 1) / g_block_size) * g_block_size, ' ');
+}
+
+/****************************************************************************************************
+ * \fn void addSettingsCards(std::string & in_out_header, const CameraFitsSettings & in_settings)
+ * \brief  add the camera settings cards to a header
+ * \param  in_out_header header to complete
+ * \param  in_settings camera settings
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::addSettingsCards(std::string & in_out_header, const CameraFitsSettings & in_settings)
+{
+    addDoubleCard (in_out_header, "EXPTIME" , in_settings.m_exposure_sec                       , "exposure time in seconds");
+    addIntegerCard(in_out_header, "XBINNING", static_cast<long long>(in_settings.m_serial_binning  ), "serial binning");
+    addIntegerCard(in_out_header, "YBINNING", static_cast<long long>(in_settings.m_parallel_binning), "parallel binning");
+    addIntegerCard(in_out_header, "XORGSUBF", static_cast<long long>(in_settings.m_serial_origin   ), "serial origin of the ROI (CCD pixels)");
+    addIntegerCard(in_out_header, "YORGSUBF", static_cast<long long>(in_settings.m_parallel_origin ), "parallel origin of the ROI (CCD pixels)");
+    addDoubleCard (in_out_header, "CCD-TEMP", in_settings.m_ccd_temperature                    , "CCD temperature in Celsius degrees");
+    addIntegerCard(in_out_header, "READOUT" , in_settings.m_readout_speed                      , "readout speed (DSI sample time setting)");
+    addStringCard (in_out_header, "INSTRUME", in_settings.m_model                              , "camera model");
+    addStringCard (in_out_header, "SERIALNO", in_settings.m_serial_number                      , "camera serial number");
+}
+
+/****************************************************************************************************
+ * \fn void addFrameCards(std::string & in_out_header, const CameraFitsJob & in_job)
+ * \brief  add the frame cards to a header
+ * \param  in_out_header header to complete
+ * \param  in_job frame job
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::addFrameCards(std::string & in_out_header, const CameraFitsJob & in_job)
+{
+    double    time         = in_job.m_metadata.m_last_part_time;
+    time_t    seconds      = static_cast<time_t>(time);
+    int       milliseconds = static_cast<int>((time - static_cast<double>(seconds)) * 1000.0);
+    struct tm date;
+    char      text[32];
+    char      date_text[48];
+
+    gmtime_r(&seconds, &date);
+    strftime(text, sizeof(text), "%Y-%m-%dT%H:%M:%S", &date);
+    snprintf(date_text, sizeof(date_text), "%s.%03d", text, std::min(milliseconds, 999));
+
+    addDoubleCard (in_out_header, "BZERO"   , 32768.0, "unsigned 16 bits pixels");
+    addDoubleCard (in_out_header, "BSCALE"  , 1.0    , "default scaling factor");
+    addIntegerCard(in_out_header, "FRAMENUM", static_cast<long long>(in_job.m_frame_nb), "frame number in the acquisition");
+    addStringCard (in_out_header, "DATE-END", date_text, "reception of the frame end (UTC)");
+    addIntegerCard(in_out_header, "IMAGEID" , static_cast<long long>(in_job.m_metadata.m_image_identifier), "image identifier given by the camera");
+}
+
+/****************************************************************************************************
+ * \fn bool openFile(const std::string & in_file_name)
+ * \brief  open a file (the current file is closed)
+ * \param  in_file_name complete file name
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFitsWriter::openFile(const std::string & in_file_name)
+{
+    DEB_MEMBER_FUNCT();
+
+    closeFile();
+
+    m_file = open(in_file_name.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+
+    if(m_file < 0)
+    {
+        DEB_ERROR() << "CameraFitsWriter::openFile - Unable to create the file " << in_file_name << ": " << strerror(errno);
+        return false;
+    }
+
+    m_write_buffer_used = 0;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool flush()
+ * \brief  flush the write buffer into the file
+ * \param  none
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFitsWriter::flush()
+{
+    DEB_MEMBER_FUNCT();
+
+    std::size_t written_size = 0;
+
+    while(written_size < m_write_buffer_used)
+    {
+        ssize_t n = write(m_file, m_write_buffer + written_size, m_write_buffer_used - written_size);
+
+        if(n < 0)
+        {
+            if(errno == EINTR)
+                continue;
+
+            DEB_ERROR() << "CameraFitsWriter::flush - write error: " << strerror(errno);
+            m_write_buffer_used = 0;
+            return false;
+        }
+
+        written_size += static_cast<std::size_t>(n);
+    }
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+        m_counters.m_written_bytes_nb += m_write_buffer_used;
+    }
+
+    m_write_buffer_used = 0;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool writeBytes(const void * in_data, std::size_t in_size)
+ * \brief  write a block of data into the file (through the write buffer)
+ * \param  in_data data to write
+ * \param  in_size size of the data
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFitsWriter::writeBytes(const void * in_data, std::size_t in_size)
+{
+    const uint8_t * data = static_cast<const uint8_t *>(in_data);
+
+    while(in_size > 0)
+    {
+        if((m_write_buffer_used == g_write_buffer_size) && (!flush()))
+            return false;
+
+        std::size_t size = std::min(in_size, g_write_buffer_size - m_write_buffer_used);
+
+        memcpy(m_write_buffer + m_write_buffer_used, data, size);
+
+        m_write_buffer_used += size;
+        data                += size;
+        in_size             -= size;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool writePixels(const CameraFitsJob & in_job)
+ * \brief  write the pixels of a frame into the file. The unsigned values are converted to
+ *         big endian signed values (BZERO = 32768) directly into the write buffer.
+ * \param  in_job frame job
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFitsWriter::writePixels(const CameraFitsJob & in_job)
+{
+    const uint16_t * source    = in_job.m_data.data();
+    std::size_t      pixels_nb = in_job.m_data.size();
+
+    while(pixels_nb > 0)
+    {
+        if(((g_write_buffer_size - m_write_buffer_used) < sizeof(uint16_t)) && (!flush()))
+            return false;
+
+        std::size_t block_pixels_nb = std::min(pixels_nb, (g_write_buffer_size - m_write_buffer_used) / sizeof(uint16_t));
+        uint8_t *   destination     = m_write_buffer + m_write_buffer_used;
+
+        for(std::size_t pixel_index = 0 ; pixel_index < block_pixels_nb ; pixel_index++)
+        {
+            uint16_t value = source[pixel_index] ^ 0x8000;
+
+            destination[2 * pixel_index    ] = static_cast<uint8_t>(value >> 8);
+            destination[2 * pixel_index + 1] = static_cast<uint8_t>(value     );
+        }
+
+        m_write_buffer_used += block_pixels_nb * sizeof(uint16_t);
+        source              += block_pixels_nb;
+        pixels_nb           -= block_pixels_nb;
+    }
+
+    return padData(in_job.m_data.size() * sizeof(uint16_t));
+}
+
+/****************************************************************************************************
+ * \fn bool padData(std::size_t in_data_size)
+ * \brief  pad the data of the current HDU to a complete block
+ * \param  in_data_size size of the data of the HDU
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFitsWriter::padData(std::size_t in_data_size)
+{
+    static const uint8_t zeros[2880] = { 0 };
+
+    std::size_t padding = (g_block_size - (in_data_size % g_block_size)) % g_block_size;
+
+    return writeBytes(zeros, padding);
+}
+
+/****************************************************************************************************
+ * \fn void closeFile()
+ * \brief  flush the write buffer and close the file
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::closeFile()
+{
+    if(m_file >= 0)
+    {
+        flush();
+        close(m_file);
+
+        m_file = -1;
+    }
+
+    m_write_buffer_used = 0;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFitsWriter::create()
+{
+    init(new CameraFitsWriter());
+}
+
+//###########################################################################
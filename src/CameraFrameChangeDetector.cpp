@@ -0,0 +1,356 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameChangeDetector.cpp
+ * \brief  implementation file of the frame change detection stage (marks or drops the redundant frames).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraFrameChangeDetector.h"
+
+// SYSTEM
+#include <cstring>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraFrameChangeDetector::g_grid_row_step   = 8   ;
+const std::size_t CameraFrameChangeDetector::g_flags_ring_size = 1024;
+
+/****************************************************************************************************
+ * \fn CameraFrameChangeDetector()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFrameChangeDetector::CameraFrameChangeDetector() : CameraFrameStage("FrameChangeDetector")
+{
+    DEB_CONSTRUCTOR();
+
+    m_mode            = Mark ;
+    m_threshold       = 1.0  ;
+    m_reference_valid = false;
+    m_nb_frames       = 0    ;
+
+    memset(&m_counters, 0, sizeof(CameraFrameChangeCounters));
+}
+
+/****************************************************************************************************
+ * \fn ~CameraFrameChangeDetector()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFrameChangeDetector::~CameraFrameChangeDetector()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn void setMode(Mode in_mode)
+ * \brief  set the treatment of the unchanged frames
+ * \param  in_mode new mode
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameChangeDetector::setMode(Mode in_mode)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_mode = in_mode;
+}
+
+/****************************************************************************************************
+ * \fn Mode getMode() const
+ * \brief  get the treatment of the unchanged frames
+ * \param  none
+ * \return current mode
+ ****************************************************************************************************/
+CameraFrameChangeDetector::Mode CameraFrameChangeDetector::getMode() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_mode;
+}
+
+/****************************************************************************************************
+ * \fn void setThreshold(double in_threshold)
+ * \brief  set the mean absolute difference by pixel under which a frame is unchanged
+ * \param  in_threshold new threshold in ADU
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameChangeDetector::setThreshold(double in_threshold)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_threshold = in_threshold;
+}
+
+/****************************************************************************************************
+ * \fn double getThreshold() const
+ * \brief  get the mean absolute difference by pixel under which a frame is unchanged
+ * \param  none
+ * \return threshold in ADU
+ ****************************************************************************************************/
+double CameraFrameChangeDetector::getThreshold() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_threshold;
+}
+
+/****************************************************************************************************
+ * \fn void resetReference()
+ * \brief  forget the reference frame (the next frame will be kept)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameChangeDetector::resetReference()
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_reference_valid = false;
+}
+
+/****************************************************************************************************
+ * \fn CameraFrameChangeCounters getCounters() const
+ * \brief  get the counters since the start of the acquisition
+ * \param  none
+ * \return counters copy
+ ****************************************************************************************************/
+CameraFrameChangeCounters CameraFrameChangeDetector::getCounters() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_counters;
+}
+
+/****************************************************************************************************
+ * \fn bool isFrameChanged(std::size_t in_frame_nb, bool & out_changed) const
+ * \brief  check if a frame of the current acquisition was flagged as changed (Mark mode).
+ *         In continuous acquisition, only the latest frames are kept.
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  out_changed true if the frame changed compared to the reference
+ * \return true if the frame was treated, false if the frame is unknown
+ ****************************************************************************************************/
+bool CameraFrameChangeDetector::isFrameChanged(std::size_t in_frame_nb, bool & out_changed) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(m_changed_flags.empty())
+        return false;
+
+    if((m_nb_frames > 0) && (in_frame_nb >= m_changed_flags.size()))
+        return false;
+
+    out_changed = (m_changed_flags[in_frame_nb % m_changed_flags.size()] != 0);
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn uint64_t computeRowDifference(const uint16_t * in_first, const uint16_t * in_second, std::size_t in_pixels_nb)
+ * \brief  compute the sum of absolute differences of two rows.
+ *         With SSE2, |a - b| is computed with two saturating subtractions on eight pixels
+ *         at once, then widened to 32 bits before the accumulation.
+ * \param  in_first first row
+ * \param  in_second second row
+ * \param  in_pixels_nb number of pixels of the rows
+ * \return sum of absolute differences
+ ****************************************************************************************************/
+uint64_t CameraFrameChangeDetector::computeRowDifference(const uint16_t * in_first, const uint16_t * in_second, std::size_t in_pixels_nb)
+{
+    uint64_t    result = 0;
+    std::size_t index  = 0;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+
+    // the 32 bits accumulators are flushed before they can overflow (2^14 iterations of 2 x 65535)
+    while(index + 8 <= in_pixels_nb)
+    {
+        __m128i     sum   = _mm_setzero_si128();
+        std::size_t count = 0;
+
+        for( ; (index + 8 <= in_pixels_nb) && (count < 16384) ; index += 8, count++)
+        {
+            __m128i first  = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_first  + index));
+            __m128i second = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_second + index));
+            __m128i diff   = _mm_or_si128(_mm_subs_epu16(first, second), _mm_subs_epu16(second, first));
+
+            sum = _mm_add_epi32(sum, _mm_unpacklo_epi16(diff, zero));
+            sum = _mm_add_epi32(sum, _mm_unpackhi_epi16(diff, zero));
+        }
+
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), sum);
+
+        result += static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+#endif
+
+    for( ; index < in_pixels_nb ; index++)
+    {
+        result += (in_first[index] > in_second[index]) ? (in_first[index] - in_second[index]) : (in_second[index] - in_first[index]);
+    }
+
+    return result;
+}
+
+/****************************************************************************************************
+ * \fn double computeDifference(const CameraFrame & in_frame, std::size_t in_row_step) const
+ * \brief  compute the mean absolute difference by pixel on one row every in_row_step rows
+ * \param  in_frame frame to compare to the reference
+ * \param  in_row_step rows step (1 for a full comparison)
+ * \return mean absolute difference by pixel
+ ****************************************************************************************************/
+double CameraFrameChangeDetector::computeDifference(const CameraFrame & in_frame, std::size_t in_row_step) const
+{
+    uint64_t    sum       = 0;
+    std::size_t pixels_nb = 0;
+
+    for(std::size_t row = 0 ; row < in_frame.m_height ; row += in_row_step)
+    {
+        std::size_t offset = row * in_frame.m_width;
+
+        sum       += computeRowDifference(in_frame.m_data + offset, m_reference.data() + offset, in_frame.m_width);
+        pixels_nb += in_frame.m_width;
+    }
+
+    return (pixels_nb > 0) ? (static_cast<double>(sum) / static_cast<double>(pixels_nb)) : 0.0;
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition
+ * \param  in_format format of the frames of the next acquisition
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFrameChangeDetector::prepareAcq(const CameraFrameFormat & in_format)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    // the first frame of the acquisition is always kept
+    m_reference.assign(in_format.m_width * in_format.m_height, 0);
+    m_reference_valid = false;
+    m_nb_frames       = in_format.m_nb_frames;
+
+    memset(&m_counters, 0, sizeof(CameraFrameChangeCounters));
+
+    // one flag by frame, or a ring buffer for a continuous acquisition
+    m_changed_flags.assign((m_nb_frames > 0) ? m_nb_frames : g_flags_ring_size, 0);
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  compare the frame to the reference frame, then mark or drop it if unchanged
+ * \param  in_out_frame frame to treat
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFrameChangeDetector::process(CameraFrame & in_out_frame)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    std::size_t pixels_nb = in_out_frame.m_width * in_out_frame.m_height;
+
+    if(pixels_nb != m_reference.size())
+    {
+        DEB_ERROR() << "CameraFrameChangeDetector::process - Incoherent frame size!";
+        return false;
+    }
+
+    bool changed = true;
+
+    if(m_reference_valid)
+    {
+        m_counters.m_compared_frames_nb++;
+
+        // the subsampled grid is enough to detect most of the changes
+        double difference = computeDifference(in_out_frame, g_grid_row_step);
+
+        if(difference < m_threshold)
+        {
+            // the change can be located in the rows which were not compared
+            difference = computeDifference(in_out_frame, 1);
+            m_counters.m_full_checks_nb++;
+        }
+
+        m_counters.m_last_difference = difference;
+        changed = (difference >= m_threshold);
+    }
+
+    if(changed)
+    {
+        memcpy(m_reference.data(), in_out_frame.m_data, pixels_nb * sizeof(uint16_t));
+        m_reference_valid = true;
+        m_counters.m_changed_frames_nb++;
+    }
+    else
+    {
+        m_counters.m_unchanged_frames_nb++;
+        in_out_frame.m_drop = (m_mode == Drop);
+    }
+
+    // a dropped frame number is reused by the next frame
+    if(!m_changed_flags.empty())
+    {
+        m_changed_flags[in_out_frame.m_frame_nb % m_changed_flags.size()] = (changed) ? 1 : 0;
+    }
+
+    return true;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameChangeDetector::create()
+{
+    init(new CameraFrameChangeDetector());
+}
+
+//###########################################################################
@@ -0,0 +1,181 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameMetadataTable.cpp
+ * \brief  implementation file of the per-frame metadata table.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraFrameMetadataTable.h"
+
+// SYSTEM
+#include <cstring>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraFrameMetadataTable::g_ring_size = 4096;
+
+/****************************************************************************************************
+ * \fn CameraFrameMetadataTable()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFrameMetadataTable::CameraFrameMetadataTable()
+{
+    DEB_CONSTRUCTOR();
+
+    CameraFrameMetadata record;
+    memset(&record, 0, sizeof(CameraFrameMetadata));
+
+    // the records are never reallocated, so the readers never access a released memory
+    m_records.assign  (g_ring_size, record);
+    m_sequences.assign(g_ring_size, 1     );
+
+    m_acquisition_nb = 0;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraFrameMetadataTable()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFrameMetadataTable::~CameraFrameMetadataTable()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn void prepareAcq()
+ * \brief  start a new acquisition. The records of the previous acquisitions are not cleared,
+ *         they are rejected by the acquisition index.
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameMetadataTable::prepareAcq()
+{
+    __sync_fetch_and_add(&m_acquisition_nb, 1);
+}
+
+/****************************************************************************************************
+ * \fn CameraFrameMetadata * startFrame(std::size_t in_frame_nb)
+ * \brief  get the record of a frame and mark it as being filled (called by the acquisition
+ *         thread). The record is cleared, its frame number and acquisition index are set.
+ * \param  in_frame_nb frame number in the acquisition
+ * \return record to fill
+ ****************************************************************************************************/
+CameraFrameMetadata * CameraFrameMetadataTable::startFrame(std::size_t in_frame_nb)
+{
+    std::size_t           index    = in_frame_nb % g_ring_size;
+    uint32_t            & sequence = m_sequences[index];
+    CameraFrameMetadata * record   = &m_records[index];
+
+    // odd sequence: the record is being filled (it stays odd if a dropped frame was not published)
+    if((sequence & 1) == 0)
+    {
+        __sync_fetch_and_add(&sequence, 1);
+    }
+
+    memset(record, 0, sizeof(CameraFrameMetadata));
+
+    record->m_frame_nb       = static_cast<uint64_t>(in_frame_nb);
+    record->m_acquisition_nb = __sync_fetch_and_add(&m_acquisition_nb, 0);
+
+    return record;
+}
+
+/****************************************************************************************************
+ * \fn void publishFrame(CameraFrameMetadata * in_record)
+ * \brief  publish the record of a frame (called by the acquisition thread)
+ * \param  in_record record given by startFrame
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameMetadataTable::publishFrame(CameraFrameMetadata * in_record)
+{
+    std::size_t index = static_cast<std::size_t>(in_record - &m_records[0]);
+
+    // the full barrier of the builtin orders the record writes before the sequence change
+    if((m_sequences[index] & 1) != 0)
+    {
+        __sync_fetch_and_add(&m_sequences[index], 1);
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool getFrameMetadata(std::size_t in_frame_nb, CameraFrameMetadata & out_metadata) const
+ * \brief  get a copy of the metadata of a frame of the current acquisition.
+ *         Only the latest frames are kept.
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  out_metadata copy of the frame record
+ * \return true if the frame record is available, false if the frame is unknown
+ ****************************************************************************************************/
+bool CameraFrameMetadataTable::getFrameMetadata(std::size_t in_frame_nb, CameraFrameMetadata & out_metadata) const
+{
+    std::size_t      index    = in_frame_nb % g_ring_size;
+    uint32_t       * sequence = const_cast<uint32_t *>(&m_sequences[index]);
+    const uint32_t   before   = __sync_fetch_and_add(sequence, 0);
+
+    if((before & 1) != 0)
+        return false;
+
+    out_metadata = m_records[index];
+
+    const uint32_t after = __sync_fetch_and_add(sequence, 0);
+
+    return (before == after)                                                                                          &&
+           (out_metadata.m_frame_nb       == static_cast<uint64_t>(in_frame_nb))                                      &&
+           (out_metadata.m_acquisition_nb == __sync_fetch_and_add(const_cast<uint32_t *>(&m_acquisition_nb), 0));
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getRingSize()
+ * \brief  get the number of frames kept in the table
+ * \param  none
+ * \return number of records
+ ****************************************************************************************************/
+std::size_t CameraFrameMetadataTable::getRingSize()
+{
+    return g_ring_size;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameMetadataTable::create()
+{
+    init(new CameraFrameMetadataTable());
+}
+
+//###########################################################################
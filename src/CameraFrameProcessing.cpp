@@ -0,0 +1,320 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameProcessing.cpp
+ * \brief  implementation file of the frame processing pipeline (stages applied during frame finalization).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraFrameProcessing.h"
+
+// SYSTEM
+#include <algorithm>
+#include <cstring>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// CameraFrameStage class
+//------------------------------------------------------------------
+/****************************************************************************************************
+ * \fn CameraFrameStage(const std::string & in_name)
+ * \brief  constructor
+ * \param  in_name stage name used during logging
+ * \return none
+ ****************************************************************************************************/
+CameraFrameStage::CameraFrameStage(const std::string & in_name)
+{
+    m_name    = in_name;
+    m_enabled = false  ;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraFrameStage()
+ * \brief  destructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFrameStage::~CameraFrameStage()
+{
+}
+
+/****************************************************************************************************
+ * \fn const std::string & getName() const
+ * \brief  get the stage name
+ * \param  none
+ * \return stage name
+ ****************************************************************************************************/
+const std::string & CameraFrameStage::getName() const
+{
+    return m_name;
+}
+
+/****************************************************************************************************
+ * \fn void setEnabled(bool in_enabled)
+ * \brief  enable or disable the stage
+ * \param  in_enabled true to apply the stage on the next frames
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStage::setEnabled(bool in_enabled)
+{
+    m_enabled = in_enabled;
+}
+
+/****************************************************************************************************
+ * \fn bool isEnabled() const
+ * \brief  check if the stage is enabled
+ * \param  none
+ * \return true if the stage is applied on the frames
+ ****************************************************************************************************/
+bool CameraFrameStage::isEnabled() const
+{
+    return m_enabled;
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition (nothing to do by default)
+ * \param  in_format format of the frames of the next acquisition
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFrameStage::prepareAcq(const CameraFrameFormat & /*in_format*/)
+{
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex stageLock() const
+ * \brief  creates an autolock mutex for the stage data access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraFrameStage::stageLock() const
+{
+    return lima::AutoMutex(m_stage_cond.mutex());
+}
+
+//------------------------------------------------------------------
+// CameraFrameProcessing class
+//------------------------------------------------------------------
+/****************************************************************************************************
+ * \fn CameraFrameProcessing()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFrameProcessing::CameraFrameProcessing()
+{
+    DEB_CONSTRUCTOR();
+
+    memset(&m_format, 0, sizeof(CameraFrameFormat));
+
+    m_format.m_orientation = CameraFrameTransform::Normal;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraFrameProcessing()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFrameProcessing::~CameraFrameProcessing()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex stagesLock() const
+ * \brief  creates an autolock mutex for the stages list access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraFrameProcessing::stagesLock() const
+{
+    return lima::AutoMutex(m_stages_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn void addStage(CameraFrameStage * in_stage)
+ * \brief  add a stage at the end of the pipeline
+ * \param  in_stage stage to add (not owned by the pipeline)
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameProcessing::addStage(CameraFrameStage * in_stage)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stages_mutex = stagesLock();
+
+    if(std::find(m_stages.begin(), m_stages.end(), in_stage) == m_stages.end())
+    {
+        DEB_TRACE() << "Adding the processing stage: " << in_stage->getName();
+        m_stages.push_back(in_stage);
+    }
+}
+
+/****************************************************************************************************
+ * \fn void removeStage(CameraFrameStage * in_stage)
+ * \brief  remove a stage from the pipeline
+ * \param  in_stage stage to remove
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameProcessing::removeStage(CameraFrameStage * in_stage)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stages_mutex = stagesLock();
+
+    std::vector<CameraFrameStage *>::iterator it = std::find(m_stages.begin(), m_stages.end(), in_stage);
+
+    if(it != m_stages.end())
+    {
+        m_stages.erase(it);
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare all the stages for a new acquisition
+ * \param  in_format format of the frames of the next acquisition
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFrameProcessing::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stages_mutex = stagesLock();
+
+    bool result = true;
+
+    m_format = in_format;
+
+    // all the stages are prepared, even the disabled ones, so they can be enabled between two acquisitions
+    for(std::size_t stage_index = 0 ; stage_index < m_stages.size() ; stage_index++)
+    {
+        if(!m_stages[stage_index]->prepareAcq(m_format))
+        {
+            DEB_ERROR() << "CameraFrameProcessing::prepareAcq - Unable to prepare the stage " << m_stages[stage_index]->getName();
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  apply all the enabled stages to a complete frame.
+ *         The next stages are not applied on a frame which was dropped by a stage.
+ * \param  in_out_frame frame to treat
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFrameProcessing::process(CameraFrame & in_out_frame)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stages_mutex = stagesLock();
+
+    for(std::size_t stage_index = 0 ; stage_index < m_stages.size() ; stage_index++)
+    {
+        CameraFrameStage * stage = m_stages[stage_index];
+
+        if(stage->isEnabled())
+        {
+            if(!stage->process(in_out_frame))
+            {
+                DEB_ERROR() << "CameraFrameProcessing::process - Error in the stage " << stage->getName()
+                            << " for the frame " << in_out_frame.m_frame_nb;
+                return false;
+            }
+
+            if(in_out_frame.m_drop)
+            {
+                break;
+            }
+        }
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn const CameraFrameFormat & getFormat() const
+ * \brief  get the format of the current acquisition
+ * \param  none
+ * \return frames format
+ ****************************************************************************************************/
+const CameraFrameFormat & CameraFrameProcessing::getFormat() const
+{
+    return m_format;
+}
+
+/****************************************************************************************************
+ * \fn void setOrientation(CameraFrameTransform::Orientation in_orientation)
+ * \brief  set the orientation applied during the frame assembly (not during an acquisition)
+ * \param  in_orientation new orientation
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameProcessing::setOrientation(CameraFrameTransform::Orientation in_orientation)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stages_mutex = stagesLock();
+
+    DEB_TRACE() << "Frame orientation: " << CameraFrameTransform::toString(in_orientation);
+    m_transform.setOrientation(in_orientation);
+}
+
+/****************************************************************************************************
+ * \fn const CameraFrameTransform & getTransform() const
+ * \brief  get the orientation transform applied during the frame assembly
+ * \param  none
+ * \return orientation transform
+ ****************************************************************************************************/
+const CameraFrameTransform & CameraFrameProcessing::getTransform() const
+{
+    return m_transform;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameProcessing::create()
+{
+    init(new CameraFrameProcessing());
+}
+
+//###########################################################################
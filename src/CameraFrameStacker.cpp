@@ -0,0 +1,1121 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameStacker.cpp
+ * \brief  implementation file of the frame stacking stage with drift registration.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraFrameStacker.h"
+
+// SYSTEM
+#include <cstring>
+#include <cmath>
+#include <algorithm>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraFrameStacker::g_buffers_nb           = 16  ;
+const std::size_t CameraFrameStacker::g_default_threads_nb   = 2   ;
+const std::size_t CameraFrameStacker::g_max_threads_nb       = 8   ;
+const std::size_t CameraFrameStacker::g_max_downsampling     = 16  ;
+const std::size_t CameraFrameStacker::g_default_downsampling = 4   ;
+const double      CameraFrameStacker::g_wait_delay_sec       = 0.1 ;
+const std::size_t CameraFrameStacker::g_ring_size            = 4096;
+
+/****************************************************************************************************
+ * \fn bool isBeforeFrame(const CameraStackShift & in_first, const CameraStackShift & in_second)
+ * \brief  compare the frame numbers of two shifts
+ * \param  in_first first shift
+ * \param  in_second second shift
+ * \return true if the first frame is before the second frame
+ ****************************************************************************************************/
+static bool isBeforeFrame(const CameraStackShift & in_first, const CameraStackShift & in_second)
+{
+    return (in_first.m_frame_nb < in_second.m_frame_nb);
+}
+
+/****************************************************************************************************
+ * \fn CameraFrameStacker()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFrameStacker::CameraFrameStacker() : CameraFrameStage("FrameStacker")
+{
+    DEB_CONSTRUCTOR();
+
+    m_downsampling         = g_default_downsampling;
+    m_interpolation        = Bilinear;
+    m_created_buffers_nb   = 0    ;
+    m_acquisition_nb       = 0    ;
+    m_acquisition_opened   = false;
+    m_reference_needed     = false;
+    m_stack_acquisition_nb = 0    ;
+    m_width                = 0    ;
+    m_height               = 0    ;
+    m_spectrum_width       = 0    ;
+    m_spectrum_height      = 0    ;
+    m_stack_downsampling   = g_default_downsampling;
+    m_stack_interpolation  = Bilinear;
+    m_stacked_frames_nb    = 0    ;
+    m_reference_ready      = false;
+    m_busy_threads_nb      = 0    ;
+
+    memset(&m_counters, 0, sizeof(CameraStackCounters));
+
+    CameraStackShift shift;
+    memset(&shift, 0, sizeof(CameraStackShift));
+
+    m_shifts.assign         (g_ring_size, shift);
+    m_shift_frame_nbs.assign(g_ring_size, 0    );
+
+    setThreadsNb(g_default_threads_nb);
+}
+
+/****************************************************************************************************
+ * \fn ~CameraFrameStacker()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraFrameStacker::~CameraFrameStacker()
+{
+    DEB_DESTRUCTOR();
+
+    releaseThreads();
+
+    for(std::size_t job_index = 0 ; job_index < m_pending_jobs.size() ; job_index++)
+        delete m_pending_jobs[job_index];
+
+    for(std::size_t job_index = 0 ; job_index < m_free_jobs.size() ; job_index++)
+        delete m_free_jobs[job_index];
+
+    for(std::size_t scratch_index = 0 ; scratch_index < m_free_scratches.size() ; scratch_index++)
+        delete m_free_scratches[scratch_index];
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex queuesLock() const
+ * \brief  creates an autolock mutex for the queues access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraFrameStacker::queuesLock() const
+{
+    return lima::AutoMutex(m_queues_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex stackLock() const
+ * \brief  creates an autolock mutex for the stack access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraFrameStacker::stackLock() const
+{
+    return lima::AutoMutex(m_stack_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn bool setDownsampling(std::size_t in_factor)
+ * \brief  set the downsampling factor of the registration (used from the next acquisition).
+ *         The shifts are measured on the means of blocks of factor x factor pixels.
+ * \param  in_factor downsampling factor (1 for no downsampling)
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraFrameStacker::setDownsampling(std::size_t in_factor)
+{
+    if((in_factor == 0) || (in_factor > g_max_downsampling))
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_downsampling = in_factor;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getDownsampling() const
+ * \brief  get the downsampling factor of the registration
+ * \param  none
+ * \return downsampling factor
+ ****************************************************************************************************/
+std::size_t CameraFrameStacker::getDownsampling() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_downsampling;
+}
+
+/****************************************************************************************************
+ * \fn void setInterpolation(Interpolation in_interpolation)
+ * \brief  set the interpolation of the shifted frames (used from the next acquisition)
+ * \param  in_interpolation new interpolation
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::setInterpolation(Interpolation in_interpolation)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_interpolation = in_interpolation;
+}
+
+/****************************************************************************************************
+ * \fn Interpolation getInterpolation() const
+ * \brief  get the interpolation of the shifted frames
+ * \param  none
+ * \return current interpolation
+ ****************************************************************************************************/
+CameraFrameStacker::Interpolation CameraFrameStacker::getInterpolation() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_interpolation;
+}
+
+/****************************************************************************************************
+ * \fn bool setThreadsNb(std::size_t in_threads_nb)
+ * \brief  set the number of stacking threads (not during an acquisition)
+ * \param  in_threads_nb number of threads
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraFrameStacker::setThreadsNb(std::size_t in_threads_nb)
+{
+    if((in_threads_nb == 0) || (in_threads_nb > g_max_threads_nb))
+        return false;
+
+    if(in_threads_nb == m_threads.size())
+        return true;
+
+    releaseThreads();
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex queues_mutex = queuesLock();
+
+        // one work buffer by thread, so a thread always finds a free one
+        while(m_free_scratches.size() > in_threads_nb)
+        {
+            delete m_free_scratches.back();
+            m_free_scratches.pop_back();
+        }
+
+        while(m_free_scratches.size() < in_threads_nb)
+        {
+            m_free_scratches.push_back(new CameraStackScratch());
+        }
+    }
+
+    for(std::size_t thread_index = 0 ; thread_index < in_threads_nb ; thread_index++)
+    {
+        CameraWriterThread * thread = new CameraWriterThread(this);
+
+        thread->start       ();
+        thread->startWriting();
+
+        m_threads.push_back(thread);
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getThreadsNb() const
+ * \brief  get the number of stacking threads
+ * \param  none
+ * \return number of threads
+ ****************************************************************************************************/
+std::size_t CameraFrameStacker::getThreadsNb() const
+{
+    return m_threads.size();
+}
+
+/****************************************************************************************************
+ * \fn CameraStackCounters getCounters() const
+ * \brief  get the counters since the start of the acquisition
+ * \param  none
+ * \return counters copy
+ ****************************************************************************************************/
+CameraStackCounters CameraFrameStacker::getCounters() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_counters;
+}
+
+/****************************************************************************************************
+ * \fn void getShifts(std::vector<CameraStackShift> & out_shifts) const
+ * \brief  get the measured shifts of the latest stacked frames of the acquisition
+ *         (the ring keeps the shifts of the latest g_ring_size frames)
+ * \param  out_shifts shifts in the frames order
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::getShifts(std::vector<CameraStackShift> & out_shifts) const
+{
+    out_shifts.clear();
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        for(std::size_t index = 0 ; index < g_ring_size ; index++)
+        {
+            if(m_shift_frame_nbs[index] != 0)
+                out_shifts.push_back(m_shifts[index]);
+        }
+    }
+
+    // the threads do not stack the frames in their order
+    std::sort(out_shifts.begin(), out_shifts.end(), isBeforeFrame);
+}
+
+/****************************************************************************************************
+ * \fn void getStack(CameraStackImage & out_stack) const
+ * \brief  get a copy of the stack of the acquisition
+ * \param  out_stack stack copy
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::getStack(CameraStackImage & out_stack) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stack_mutex = stackLock();
+
+    out_stack.m_width     = m_width            ;
+    out_stack.m_height    = m_height           ;
+    out_stack.m_frames_nb = m_stacked_frames_nb;
+    out_stack.m_sum       = m_stack            ;
+    out_stack.m_coverage  = m_coverage         ;
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition. The frames of a previous acquisition still
+ *         queued are dropped, the frame buffers are allocated and the stack is cleared.
+ * \param  in_format format of the frames
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFrameStacker::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    std::size_t   acquisition_nb;
+    std::size_t   downsampling  ;
+    Interpolation interpolation ;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        acquisition_nb       = ++m_acquisition_nb;
+        m_acquisition_opened = false;
+
+        if(!isEnabled())
+            return true;
+
+        if(in_format.m_pixel_depth > 16)
+        {
+            DEB_ERROR() << "CameraFrameStacker::prepareAcq - Incorrect pixel depth: " << in_format.m_pixel_depth;
+            return false;
+        }
+
+        memset(&m_counters, 0, sizeof(CameraStackCounters));
+        std::fill(m_shift_frame_nbs.begin(), m_shift_frame_nbs.end(), 0);
+
+        m_reference_needed   = true;
+        m_acquisition_opened = true;
+
+        // the registration needs at least two blocks in each direction
+        downsampling  = std::max(static_cast<std::size_t>(1), std::min(m_downsampling, std::min(in_format.m_width, in_format.m_height) / 2));
+        interpolation = m_interpolation;
+    }
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex queues_mutex = queuesLock();
+
+        // the frame buffers are allocated now, so the reception never waits for a memory allocation
+        while(m_created_buffers_nb < g_buffers_nb)
+        {
+            CameraStackJob * job = new CameraStackJob();
+            job->m_data.reserve(in_format.m_width * in_format.m_height);
+
+            m_free_jobs.push_back(job);
+            m_created_buffers_nb++;
+        }
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex stack_mutex = stackLock();
+
+    // the threads drop the frames of the previous acquisition, the frames being stacked are waited
+    m_stack_acquisition_nb = acquisition_nb;
+
+    while(m_busy_threads_nb > 0)
+    {
+        m_stack_cond.wait(g_wait_delay_sec);
+    }
+
+    m_width               = in_format.m_width ;
+    m_height              = in_format.m_height;
+    m_stack_downsampling  = downsampling ;
+    m_stack_interpolation = interpolation;
+    m_spectrum_width      = computePowerOfTwo(m_width  / downsampling);
+    m_spectrum_height     = computePowerOfTwo(m_height / downsampling);
+    m_stacked_frames_nb   = 0    ;
+    m_reference_ready     = false;
+
+    m_stack   .assign(m_width * m_height, 0);
+    m_coverage.assign(m_width * m_height, 0);
+    m_reference_spectrum.resize(m_spectrum_width * m_spectrum_height);
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  queue a complete frame for the stacking (called by the acquisition thread)
+ * \param  in_out_frame frame to stack
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraFrameStacker::process(CameraFrame & in_out_frame)
+{
+    std::size_t acquisition_nb;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        if((!m_acquisition_opened) || (in_out_frame.m_drop))
+            return true;
+
+        acquisition_nb = m_acquisition_nb;
+    }
+
+    CameraStackJob * job = NULL;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex queues_mutex = queuesLock();
+
+        if(!m_free_jobs.empty())
+        {
+            job = m_free_jobs.back();
+            m_free_jobs.pop_back();
+        }
+    }
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        // no free buffer: the frame is not stacked, the reception should not wait for the threads
+        if(job == NULL)
+        {
+            m_counters.m_dropped_frames_nb++;
+            return true;
+        }
+
+        // the first queued frame is the reference of the acquisition
+        job->m_reference   = m_reference_needed;
+        m_reference_needed = false;
+        m_counters.m_queued_frames_nb++;
+    }
+
+    job->m_frame_nb       = in_out_frame.m_frame_nb;
+    job->m_acquisition_nb = acquisition_nb;
+    job->m_data.assign(in_out_frame.m_data, in_out_frame.m_data + (in_out_frame.m_width * in_out_frame.m_height));
+
+    // protecting the multi-threads access
+    lima::AutoMutex queues_mutex = queuesLock();
+
+    m_pending_jobs.push_back(job);
+    m_queues_cond.broadcast();
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void writeNext()
+ * \brief  stack the next queued frame, waits a short delay if the queue is empty
+ *         (called by the threads)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::writeNext()
+{
+    CameraStackJob     * job     = NULL;
+    CameraStackScratch * scratch = NULL;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex queues_mutex = queuesLock();
+
+        if(m_pending_jobs.empty())
+        {
+            m_queues_cond.wait(g_wait_delay_sec);
+        }
+
+        if((m_pending_jobs.empty()) || (m_free_scratches.empty()))
+            return;
+
+        job = m_pending_jobs.front();
+        m_pending_jobs.pop_front();
+
+        scratch = m_free_scratches.back();
+        m_free_scratches.pop_back();
+    }
+
+    bool drop    = false;
+    bool requeue = false;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stack_mutex = stackLock();
+
+        if(job->m_acquisition_nb != m_stack_acquisition_nb)
+        {
+            drop = true;
+        }
+        else
+        // the other frames need the spectrum of the reference frame
+        if((!job->m_reference) && (!m_reference_ready))
+        {
+            m_stack_cond.wait(g_wait_delay_sec);
+            requeue = ((!m_reference_ready) || (job->m_acquisition_nb != m_stack_acquisition_nb));
+        }
+
+        if((!drop) && (!requeue))
+        {
+            m_busy_threads_nb++;
+        }
+    }
+
+    if((!drop) && (!requeue))
+    {
+        stackJob(*job, *scratch);
+
+        // protecting the multi-threads access
+        lima::AutoMutex stack_mutex = stackLock();
+
+        m_busy_threads_nb--;
+        m_stack_cond.broadcast();
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex queues_mutex = queuesLock();
+
+    if(requeue)
+    {
+        m_pending_jobs.push_back(job);
+    }
+    else
+    {
+        m_free_jobs.push_back(job);
+    }
+
+    m_free_scratches.push_back(scratch);
+}
+
+/****************************************************************************************************
+ * \fn void stackJob(const CameraStackJob & in_job, CameraStackScratch & in_out_scratch)
+ * \brief  register and accumulate a frame (called by the threads). The stack data used without
+ *         the lock are not modified while a thread is busy.
+ * \param  in_job frame to stack
+ * \param  in_out_scratch work buffers of the thread
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::stackJob(const CameraStackJob & in_job, CameraStackScratch & in_out_scratch)
+{
+    CameraStackShift shift;
+
+    shift.m_frame_nb = in_job.m_frame_nb;
+    shift.m_shift_x  = 0.0;
+    shift.m_shift_y  = 0.0;
+    shift.m_peak     = 1.0;
+
+    computeSpectrum(in_job, in_out_scratch);
+
+    if(in_job.m_reference)
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stack_mutex = stackLock();
+
+        for(std::size_t index = 0 ; index < m_reference_spectrum.size() ; index++)
+            m_reference_spectrum[index] = std::conj(in_out_scratch.m_spectrum[index]);
+
+        m_reference_ready = true;
+        m_stack_cond.broadcast();
+    }
+    else
+    {
+        measureShift(in_out_scratch, shift);
+    }
+
+    if(m_stack_interpolation == Fourier)
+    {
+        shiftFourier(in_job, shift.m_shift_x, shift.m_shift_y, in_out_scratch);
+    }
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stack_mutex = stackLock();
+
+        if(m_stack_interpolation == Fourier)
+        {
+            accumulateShifted(in_out_scratch.m_shifted.data(), shift.m_shift_x, shift.m_shift_y);
+        }
+        else
+        {
+            accumulateBilinear(in_job.m_data.data(), shift.m_shift_x, shift.m_shift_y);
+        }
+
+        m_stacked_frames_nb++;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_counters.m_stacked_frames_nb++;
+
+    // the threads do not stack the frames in their order: a newer frame of the record is kept
+    std::size_t index = shift.m_frame_nb % g_ring_size;
+
+    if(m_shift_frame_nbs[index] < shift.m_frame_nb + 1)
+    {
+        m_shifts         [index] = shift;
+        m_shift_frame_nbs[index] = shift.m_frame_nb + 1;
+    }
+}
+
+/****************************************************************************************************
+ * \fn void computeSpectrum(const CameraStackJob & in_job, CameraStackScratch & in_out_scratch) const
+ * \brief  compute the spectrum of the downsampled frame. The block means are centered and
+ *         multiplied by a Hann window, so the borders of the frame do not create a peak at the
+ *         null shift.
+ * \param  in_job frame to register
+ * \param  in_out_scratch work buffers of the thread (spectrum filled)
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::computeSpectrum(const CameraStackJob & in_job, CameraStackScratch & in_out_scratch) const
+{
+    const std::size_t factor = m_stack_downsampling;
+    const std::size_t width  = m_width  / factor;
+    const std::size_t height = m_height / factor;
+    const float       scale  = 1.0f / static_cast<float>(factor * factor);
+
+    std::vector< std::complex<float> > & spectrum = in_out_scratch.m_spectrum;
+    std::vector<float> row_sums(width);
+    std::vector<float> window_x(width);
+    double             sum = 0.0;
+
+    spectrum.assign(m_spectrum_width * m_spectrum_height, std::complex<float>(0.0f, 0.0f));
+
+    // means of the blocks
+    for(std::size_t y = 0 ; y < height ; y++)
+    {
+        std::fill(row_sums.begin(), row_sums.end(), 0.0f);
+
+        for(std::size_t row = y * factor ; row < (y + 1) * factor ; row++)
+        {
+            const uint16_t * pixels = in_job.m_data.data() + row * m_width;
+
+            for(std::size_t x = 0 ; x < width ; x++)
+            {
+                for(std::size_t column = 0 ; column < factor ; column++)
+                    row_sums[x] += static_cast<float>(pixels[x * factor + column]);
+            }
+        }
+
+        for(std::size_t x = 0 ; x < width ; x++)
+        {
+            float mean = row_sums[x] * scale;
+
+            spectrum[y * m_spectrum_width + x] = std::complex<float>(mean, 0.0f);
+            sum += static_cast<double>(mean);
+        }
+    }
+
+    const float mean = static_cast<float>(sum / static_cast<double>(width * height));
+
+    for(std::size_t x = 0 ; x < width ; x++)
+        window_x[x] = static_cast<float>(0.5 - 0.5 * cos(2.0 * M_PI * (static_cast<double>(x) + 0.5) / static_cast<double>(width)));
+
+    for(std::size_t y = 0 ; y < height ; y++)
+    {
+        const float window_y = static_cast<float>(0.5 - 0.5 * cos(2.0 * M_PI * (static_cast<double>(y) + 0.5) / static_cast<double>(height)));
+        std::complex<float> * line = &spectrum[y * m_spectrum_width];
+
+        for(std::size_t x = 0 ; x < width ; x++)
+            line[x] = std::complex<float>((line[x].real() - mean) * window_x[x] * window_y, 0.0f);
+    }
+
+    transform2D(&spectrum[0], m_spectrum_width, m_spectrum_height, false, in_out_scratch.m_line);
+}
+
+/****************************************************************************************************
+ * \fn void measureShift(CameraStackScratch & in_out_scratch, CameraStackShift & out_shift) const
+ * \brief  measure the shift of a spectrum against the reference spectrum. The cross power
+ *         spectrum is transformed back into the cross-correlation surface, whose peak is refined
+ *         with a gaussian through its neighbours in each direction.
+ * \param  in_out_scratch work buffers of the thread (spectrum of the frame, destroyed)
+ * \param  out_shift measured shift in pixels of the complete frame
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::measureShift(CameraStackScratch & in_out_scratch, CameraStackShift & out_shift) const
+{
+    const std::size_t width  = m_spectrum_width ;
+    const std::size_t height = m_spectrum_height;
+
+    std::complex<float> * spectrum         = &in_out_scratch.m_spectrum[0];
+    double                frame_energy     = 0.0;
+    double                reference_energy = 0.0;
+
+    for(std::size_t index = 0 ; index < width * height ; index++)
+    {
+        const std::complex<float> & reference = m_reference_spectrum[index];
+
+        float real = spectrum[index].real() * reference.real() - spectrum[index].imag() * reference.imag();
+        float imag = spectrum[index].real() * reference.imag() + spectrum[index].imag() * reference.real();
+
+        frame_energy     += static_cast<double>(std::norm(spectrum[index]));
+        reference_energy += static_cast<double>(std::norm(reference      ));
+
+        spectrum[index] = std::complex<float>(real, imag);
+    }
+
+    transform2D(spectrum, width, height, true, in_out_scratch.m_line);
+
+    std::size_t peak_index = 0;
+
+    for(std::size_t index = 1 ; index < width * height ; index++)
+    {
+        if(spectrum[index].real() > spectrum[peak_index].real())
+            peak_index = index;
+    }
+
+    const std::size_t peak_x = peak_index % width;
+    const std::size_t peak_y = peak_index / width;
+    const double      center = static_cast<double>(spectrum[peak_index].real());
+    const double      left   = static_cast<double>(spectrum[peak_y * width + ((peak_x + width  - 1) % width)].real());
+    const double      right  = static_cast<double>(spectrum[peak_y * width + ((peak_x + 1) % width)].real());
+    const double      top    = static_cast<double>(spectrum[((peak_y + height - 1) % height) * width + peak_x].real());
+    const double      bottom = static_cast<double>(spectrum[((peak_y + 1) % height) * width + peak_x].real());
+
+    double shift_x = (peak_x > width  / 2) ? static_cast<double>(peak_x) - static_cast<double>(width ) : static_cast<double>(peak_x);
+    double shift_y = (peak_y > height / 2) ? static_cast<double>(peak_y) - static_cast<double>(height) : static_cast<double>(peak_y);
+
+    shift_x += computePeakOffset(left, center, right );
+    shift_y += computePeakOffset(top , center, bottom);
+
+    double energy = sqrt(frame_energy * reference_energy);
+
+    out_shift.m_shift_x = shift_x * static_cast<double>(m_stack_downsampling);
+    out_shift.m_shift_y = shift_y * static_cast<double>(m_stack_downsampling);
+    out_shift.m_peak    = (energy > 0.0) ? center / energy : 0.0;
+}
+
+/****************************************************************************************************
+ * \fn double computePeakOffset(double in_previous, double in_peak, double in_next)
+ * \brief  compute the sub-pixel offset of a correlation peak in a direction, with a gaussian
+ *         through the peak and its neighbours (a parabola when a value is not positive)
+ * \param  in_previous value before the peak
+ * \param  in_peak value of the peak
+ * \param  in_next value after the peak
+ * \return offset in pixels (-0.5 to 0.5)
+ ****************************************************************************************************/
+double CameraFrameStacker::computePeakOffset(double in_previous, double in_peak, double in_next)
+{
+    double previous = in_previous;
+    double peak     = in_peak    ;
+    double next     = in_next    ;
+
+    if((previous > 0.0) && (peak > 0.0) && (next > 0.0))
+    {
+        previous = log(previous);
+        peak     = log(peak    );
+        next     = log(next    );
+    }
+
+    double curvature = previous - 2.0 * peak + next;
+
+    if(curvature >= 0.0)
+        return 0.0;
+
+    return std::max(-0.5, std::min(0.5, 0.5 * (previous - next) / curvature));
+}
+
+/****************************************************************************************************
+ * \fn void shiftFourier(const CameraStackJob & in_job, double in_shift_x, double in_shift_y, CameraStackScratch & in_out_scratch) const
+ * \brief  shift a frame with a Fourier interpolation: the centered frame is padded to powers of
+ *         two and its spectrum is multiplied by a phase ramp.
+ * \param  in_job frame to shift
+ * \param  in_shift_x horizontal shift in pixels
+ * \param  in_shift_y vertical shift in pixels
+ * \param  in_out_scratch work buffers of the thread (shifted frame filled)
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::shiftFourier(const CameraStackJob & in_job, double in_shift_x, double in_shift_y, CameraStackScratch & in_out_scratch) const
+{
+    const std::size_t width  = computePowerOfTwo(m_width );
+    const std::size_t height = computePowerOfTwo(m_height);
+
+    std::vector< std::complex<float> > & spectrum = in_out_scratch.m_frame_spectrum;
+    std::vector< std::complex<float> >   phase_x(width );
+    std::vector< std::complex<float> >   phase_y(height);
+    double                               sum = 0.0;
+
+    for(std::size_t index = 0 ; index < m_width * m_height ; index++)
+        sum += static_cast<double>(in_job.m_data[index]);
+
+    const float mean = static_cast<float>(sum / static_cast<double>(m_width * m_height));
+
+    spectrum.assign(width * height, std::complex<float>(0.0f, 0.0f));
+
+    for(std::size_t y = 0 ; y < m_height ; y++)
+    {
+        const uint16_t      * pixels = in_job.m_data.data() + y * m_width;
+        std::complex<float> * line   = &spectrum[y * width];
+
+        for(std::size_t x = 0 ; x < m_width ; x++)
+            line[x] = std::complex<float>(static_cast<float>(pixels[x]) - mean, 0.0f);
+    }
+
+    transform2D(&spectrum[0], width, height, false, in_out_scratch.m_line);
+
+    // the shifted frame samples the frame at (x + shift, y + shift)
+    for(std::size_t x = 0 ; x < width ; x++)
+    {
+        double frequency = (x < width / 2) ? static_cast<double>(x) : static_cast<double>(x) - static_cast<double>(width);
+        double angle     = 2.0 * M_PI * frequency * in_shift_x / static_cast<double>(width);
+
+        phase_x[x] = std::complex<float>(static_cast<float>(cos(angle)), static_cast<float>(sin(angle)));
+    }
+
+    for(std::size_t y = 0 ; y < height ; y++)
+    {
+        double frequency = (y < height / 2) ? static_cast<double>(y) : static_cast<double>(y) - static_cast<double>(height);
+        double angle     = 2.0 * M_PI * frequency * in_shift_y / static_cast<double>(height);
+        float  scale     = 1.0f / static_cast<float>(width * height);
+
+        phase_y[y] = std::complex<float>(static_cast<float>(cos(angle)) * scale, static_cast<float>(sin(angle)) * scale);
+    }
+
+    for(std::size_t y = 0 ; y < height ; y++)
+    {
+        std::complex<float> * line = &spectrum[y * width];
+
+        for(std::size_t x = 0 ; x < width ; x++)
+        {
+            float phase_real = phase_x[x].real() * phase_y[y].real() - phase_x[x].imag() * phase_y[y].imag();
+            float phase_imag = phase_x[x].real() * phase_y[y].imag() + phase_x[x].imag() * phase_y[y].real();
+
+            line[x] = std::complex<float>(line[x].real() * phase_real - line[x].imag() * phase_imag,
+                                          line[x].real() * phase_imag + line[x].imag() * phase_real);
+        }
+    }
+
+    transform2D(&spectrum[0], width, height, true, in_out_scratch.m_line);
+
+    in_out_scratch.m_shifted.resize(m_width * m_height);
+
+    for(std::size_t y = 0 ; y < m_height ; y++)
+    {
+        const std::complex<float> * line    = &spectrum[y * width];
+        float                     * shifted = &in_out_scratch.m_shifted[y * m_width];
+
+        for(std::size_t x = 0 ; x < m_width ; x++)
+            shifted[x] = line[x].real() + mean;
+    }
+}
+
+/****************************************************************************************************
+ * \fn void accumulateBilinear(const uint16_t * in_data, double in_shift_x, double in_shift_y)
+ * \brief  add a frame shifted with a bilinear interpolation to the stack. Only the pixels whose
+ *         four source pixels are in the frame are added.
+ * \param  in_data frame pixels
+ * \param  in_shift_x horizontal shift in pixels
+ * \param  in_shift_y vertical shift in pixels
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::accumulateBilinear(const uint16_t * in_data, double in_shift_x, double in_shift_y)
+{
+    std::ptrdiff_t begin_x, end_x, begin_y, end_y;
+
+    computeValidRange(in_shift_x, m_width , begin_x, end_x);
+    computeValidRange(in_shift_y, m_height, begin_y, end_y);
+
+    const std::ptrdiff_t offset_x   = static_cast<std::ptrdiff_t>(floor(in_shift_x));
+    const std::ptrdiff_t offset_y   = static_cast<std::ptrdiff_t>(floor(in_shift_y));
+    const float          fraction_x = static_cast<float>(in_shift_x - static_cast<double>(offset_x));
+    const float          fraction_y = static_cast<float>(in_shift_y - static_cast<double>(offset_y));
+    const std::ptrdiff_t next_x     = (fraction_x > 0.0f) ? 1 : 0;
+    const std::ptrdiff_t next_y     = (fraction_y > 0.0f) ? static_cast<std::ptrdiff_t>(m_width) : 0;
+    const float          weight_00  = (1.0f - fraction_x) * (1.0f - fraction_y);
+    const float          weight_01  =         fraction_x  * (1.0f - fraction_y);
+    const float          weight_10  = (1.0f - fraction_x) *         fraction_y ;
+    const float          weight_11  =         fraction_x  *         fraction_y ;
+
+    for(std::ptrdiff_t y = begin_y ; y < end_y ; y++)
+    {
+        const uint16_t * source   = in_data + (y + offset_y) * static_cast<std::ptrdiff_t>(m_width) + offset_x;
+        uint32_t       * stack    = &m_stack   [y * m_width];
+        uint32_t       * coverage = &m_coverage[y * m_width];
+
+        for(std::ptrdiff_t x = begin_x ; x < end_x ; x++)
+        {
+            float value = weight_00 * static_cast<float>(source[x                  ]) +
+                          weight_01 * static_cast<float>(source[x + next_x         ]) +
+                          weight_10 * static_cast<float>(source[x + next_y         ]) +
+                          weight_11 * static_cast<float>(source[x + next_y + next_x]);
+
+            stack   [x] += static_cast<uint32_t>(value + 0.5f);
+            coverage[x]++;
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn void accumulateShifted(const float * in_shifted, double in_shift_x, double in_shift_y)
+ * \brief  add a frame shifted with a Fourier interpolation to the stack. Only the pixels whose
+ *         source is in the frame are added (the others come from the periodic padding).
+ * \param  in_shifted shifted frame
+ * \param  in_shift_x horizontal shift in pixels
+ * \param  in_shift_y vertical shift in pixels
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::accumulateShifted(const float * in_shifted, double in_shift_x, double in_shift_y)
+{
+    std::ptrdiff_t begin_x, end_x, begin_y, end_y;
+
+    computeValidRange(in_shift_x, m_width , begin_x, end_x);
+    computeValidRange(in_shift_y, m_height, begin_y, end_y);
+
+    for(std::ptrdiff_t y = begin_y ; y < end_y ; y++)
+    {
+        const float * source   = in_shifted + y * m_width;
+        uint32_t    * stack    = &m_stack   [y * m_width];
+        uint32_t    * coverage = &m_coverage[y * m_width];
+
+        for(std::ptrdiff_t x = begin_x ; x < end_x ; x++)
+        {
+            // the interpolation can ring below zero near sharp edges
+            stack   [x] += static_cast<uint32_t>(std::max(source[x], 0.0f) + 0.5f);
+            coverage[x]++;
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn void computeValidRange(double in_shift, std::size_t in_size, std::ptrdiff_t & out_begin, std::ptrdiff_t & out_end)
+ * \brief  compute the range of the destination pixels which have all their source pixels
+ *         (position + shift and the next pixel for a fractional shift) in the frame
+ * \param  in_shift shift in pixels
+ * \param  in_size frame size in pixels
+ * \param  out_begin first valid destination pixel
+ * \param  out_end end of the valid destination pixels (out_begin if none)
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::computeValidRange(double           in_shift ,
+                                           std::size_t      in_size  ,
+                                           std::ptrdiff_t & out_begin,
+                                           std::ptrdiff_t & out_end  )
+{
+    const std::ptrdiff_t offset = static_cast<std::ptrdiff_t>(floor(in_shift));
+    const std::ptrdiff_t next   = (in_shift > static_cast<double>(offset)) ? 1 : 0;
+    const std::ptrdiff_t size   = static_cast<std::ptrdiff_t>(in_size);
+
+    out_begin = std::max(static_cast<std::ptrdiff_t>(0), -offset);
+    out_end   = std::min(size, size - offset - next);
+
+    if(out_end < out_begin)
+        out_end = out_begin;
+}
+
+/****************************************************************************************************
+ * \fn void transform(std::complex<float> * in_out_data, std::size_t in_size, const std::complex<float> * in_twiddles)
+ * \brief  in place radix-2 FFT of a line (not normalized)
+ * \param  in_out_data values of the line
+ * \param  in_size number of values (power of two)
+ * \param  in_twiddles in_size / 2 roots of unity, conjugated for the inverse transform
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::transform(std::complex<float> * in_out_data, std::size_t in_size, const std::complex<float> * in_twiddles)
+{
+    // bit reversal permutation
+    for(std::size_t index = 1, reversed = 0 ; index < in_size ; index++)
+    {
+        std::size_t bit = in_size >> 1;
+
+        for( ; reversed & bit ; bit >>= 1)
+            reversed ^= bit;
+
+        reversed ^= bit;
+
+        if(index < reversed)
+            std::swap(in_out_data[index], in_out_data[reversed]);
+    }
+
+    for(std::size_t length = 2 ; length <= in_size ; length <<= 1)
+    {
+        const std::size_t half   = length / 2;
+        const std::size_t stride = in_size / length;
+
+        for(std::size_t start = 0 ; start < in_size ; start += length)
+        {
+            std::complex<float> * first  = in_out_data + start;
+            std::complex<float> * second = first + half;
+
+            for(std::size_t offset = 0 ; offset < half ; offset++)
+            {
+                const std::complex<float> & twiddle = in_twiddles[offset * stride];
+
+                float real = second[offset].real() * twiddle.real() - second[offset].imag() * twiddle.imag();
+                float imag = second[offset].real() * twiddle.imag() + second[offset].imag() * twiddle.real();
+
+                second[offset] = std::complex<float>(first[offset].real() - real, first[offset].imag() - imag);
+                first [offset] = std::complex<float>(first[offset].real() + real, first[offset].imag() + imag);
+            }
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn void transform2D(std::complex<float> * in_out_data, std::size_t in_width, std::size_t in_height, bool in_inverse, std::vector< std::complex<float> > & in_out_line)
+ * \brief  in place 2D FFT (rows then columns, not normalized)
+ * \param  in_out_data values of the image
+ * \param  in_width image width (power of two)
+ * \param  in_height image height (power of two)
+ * \param  in_inverse true for the inverse transform
+ * \param  in_out_line work buffer of the columns
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::transform2D(std::complex<float> *                in_out_data,
+                                     std::size_t                          in_width   ,
+                                     std::size_t                          in_height  ,
+                                     bool                                 in_inverse ,
+                                     std::vector< std::complex<float> > & in_out_line)
+{
+    std::vector< std::complex<float> > twiddles_x;
+    std::vector< std::complex<float> > twiddles_y;
+
+    computeTwiddles(in_width , in_inverse, twiddles_x);
+    computeTwiddles(in_height, in_inverse, twiddles_y);
+
+    for(std::size_t y = 0 ; y < in_height ; y++)
+        transform(in_out_data + y * in_width, in_width, twiddles_x.data());
+
+    in_out_line.resize(in_height);
+
+    for(std::size_t x = 0 ; x < in_width ; x++)
+    {
+        for(std::size_t y = 0 ; y < in_height ; y++)
+            in_out_line[y] = in_out_data[y * in_width + x];
+
+        transform(&in_out_line[0], in_height, twiddles_y.data());
+
+        for(std::size_t y = 0 ; y < in_height ; y++)
+            in_out_data[y * in_width + x] = in_out_line[y];
+    }
+}
+
+/****************************************************************************************************
+ * \fn void computeTwiddles(std::size_t in_size, bool in_inverse, std::vector< std::complex<float> > & out_twiddles)
+ * \brief  compute the roots of unity of a FFT
+ * \param  in_size number of values of the FFT (power of two)
+ * \param  in_inverse true for the inverse transform
+ * \param  out_twiddles in_size / 2 roots of unity (at least one)
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::computeTwiddles(std::size_t in_size, bool in_inverse, std::vector< std::complex<float> > & out_twiddles)
+{
+    const double sign = in_inverse ? 2.0 : -2.0;
+
+    out_twiddles.resize(std::max(in_size / 2, static_cast<std::size_t>(1)));
+
+    for(std::size_t index = 0 ; index < out_twiddles.size() ; index++)
+    {
+        double angle = sign * M_PI * static_cast<double>(index) / static_cast<double>(in_size);
+
+        out_twiddles[index] = std::complex<float>(static_cast<float>(cos(angle)), static_cast<float>(sin(angle)));
+    }
+}
+
+/****************************************************************************************************
+ * \fn std::size_t computePowerOfTwo(std::size_t in_size)
+ * \brief  compute the smallest power of two greater or equal to a size
+ * \param  in_size size
+ * \return power of two
+ ****************************************************************************************************/
+std::size_t CameraFrameStacker::computePowerOfTwo(std::size_t in_size)
+{
+    std::size_t power = 1;
+
+    while(power < in_size)
+        power <<= 1;
+
+    return power;
+}
+
+/****************************************************************************************************
+ * \fn void releaseThreads()
+ * \brief  stop and release the threads
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::releaseThreads()
+{
+    for(std::size_t thread_index = 0 ; thread_index < m_threads.size() ; thread_index++)
+    {
+        m_threads[thread_index]->stopWriting();
+        delete m_threads[thread_index];
+    }
+
+    m_threads.clear();
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameStacker::create()
+{
+    init(new CameraFrameStacker());
+}
+
+//###########################################################################
@@ -0,0 +1,650 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraFrameTransform.cpp
+ * \brief  implementation file of the frame orientation transform (flips, rotations and transpositions).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraFrameTransform.h"
+
+// SYSTEM
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraFrameTransform::g_tile_size  = 64;
+const std::size_t CameraFrameTransform::g_block_size = 8 ;
+
+//------------------------------------------------------------------
+// SSE2 kernels
+//------------------------------------------------------------------
+#if defined(__SSE2__)
+/****************************************************************************************************
+ * \fn __m128i reverse8(__m128i in_value)
+ * \brief  reverse the order of eight 16 bits values
+ * \param  in_value values to reverse
+ * \return reversed values
+ ****************************************************************************************************/
+static inline __m128i reverse8(__m128i in_value)
+{
+    in_value = _mm_shufflelo_epi16(in_value, _MM_SHUFFLE(0, 1, 2, 3));
+    in_value = _mm_shufflehi_epi16(in_value, _MM_SHUFFLE(0, 1, 2, 3));
+    return _mm_shuffle_epi32(in_value, _MM_SHUFFLE(1, 0, 3, 2));
+}
+
+/****************************************************************************************************
+ * \fn void transposeBlock8x8(const uint16_t * in_source, std::size_t in_source_width, std::ptrdiff_t in_start, std::ptrdiff_t in_step_x, std::ptrdiff_t in_step_y, uint16_t * out_destination)
+ * \brief  copy a 8x8 block of source pixels with a transposition.
+ *         Each source column becomes eight consecutive destination pixels (in_step_y is 1 or -1).
+ * \param  in_source first pixel of the block
+ * \param  in_source_width source row length in pixels
+ * \param  in_start destination index of the first pixel of the block
+ * \param  in_step_x destination step of the source columns
+ * \param  in_step_y destination step of the source rows (1 or -1)
+ * \param  out_destination destination frame
+ * \return none
+ ****************************************************************************************************/
+static inline void transposeBlock8x8(const uint16_t * in_source      ,
+                                     std::size_t      in_source_width,
+                                     std::ptrdiff_t   in_start       ,
+                                     std::ptrdiff_t   in_step_x      ,
+                                     std::ptrdiff_t   in_step_y      ,
+                                     uint16_t       * out_destination)
+{
+    __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_source + 0 * in_source_width));
+    __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_source + 1 * in_source_width));
+    __m128i a2 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_source + 2 * in_source_width));
+    __m128i a3 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_source + 3 * in_source_width));
+    __m128i a4 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_source + 4 * in_source_width));
+    __m128i a5 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_source + 5 * in_source_width));
+    __m128i a6 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_source + 6 * in_source_width));
+    __m128i a7 = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_source + 7 * in_source_width));
+
+    // interleave the 16 bits values, then the 32 bits pairs, then the 64 bits quads
+    __m128i t0 = _mm_unpacklo_epi16(a0, a1);
+    __m128i t1 = _mm_unpackhi_epi16(a0, a1);
+    __m128i t2 = _mm_unpacklo_epi16(a2, a3);
+    __m128i t3 = _mm_unpackhi_epi16(a2, a3);
+    __m128i t4 = _mm_unpacklo_epi16(a4, a5);
+    __m128i t5 = _mm_unpackhi_epi16(a4, a5);
+    __m128i t6 = _mm_unpacklo_epi16(a6, a7);
+    __m128i t7 = _mm_unpackhi_epi16(a6, a7);
+
+    __m128i u0 = _mm_unpacklo_epi32(t0, t2);
+    __m128i u1 = _mm_unpackhi_epi32(t0, t2);
+    __m128i u2 = _mm_unpacklo_epi32(t1, t3);
+    __m128i u3 = _mm_unpackhi_epi32(t1, t3);
+    __m128i u4 = _mm_unpacklo_epi32(t4, t6);
+    __m128i u5 = _mm_unpackhi_epi32(t4, t6);
+    __m128i u6 = _mm_unpacklo_epi32(t5, t7);
+    __m128i u7 = _mm_unpackhi_epi32(t5, t7);
+
+    __m128i columns[8];
+
+    columns[0] = _mm_unpacklo_epi64(u0, u4);
+    columns[1] = _mm_unpackhi_epi64(u0, u4);
+    columns[2] = _mm_unpacklo_epi64(u1, u5);
+    columns[3] = _mm_unpackhi_epi64(u1, u5);
+    columns[4] = _mm_unpacklo_epi64(u2, u6);
+    columns[5] = _mm_unpackhi_epi64(u2, u6);
+    columns[6] = _mm_unpacklo_epi64(u3, u7);
+    columns[7] = _mm_unpackhi_epi64(u3, u7);
+
+    for(std::ptrdiff_t column = 0 ; column < 8 ; column++)
+    {
+        std::ptrdiff_t index = in_start + column * in_step_x;
+
+        if(in_step_y > 0)
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out_destination + index), columns[column]);
+        }
+        else
+        {
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out_destination + index - 7), reverse8(columns[column]));
+        }
+    }
+}
+#endif
+
+/****************************************************************************************************
+ * \fn CameraFrameTransform(Orientation in_orientation)
+ * \brief  constructor
+ * \param  in_orientation orientation
+ * \return none
+ ****************************************************************************************************/
+CameraFrameTransform::CameraFrameTransform(Orientation in_orientation)
+{
+    m_orientation = in_orientation;
+}
+
+/****************************************************************************************************
+ * \fn void setOrientation(Orientation in_orientation)
+ * \brief  set the orientation
+ * \param  in_orientation new orientation
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::setOrientation(Orientation in_orientation)
+{
+    m_orientation = in_orientation;
+}
+
+/****************************************************************************************************
+ * \fn Orientation getOrientation() const
+ * \brief  get the orientation
+ * \param  none
+ * \return current orientation
+ ****************************************************************************************************/
+CameraFrameTransform::Orientation CameraFrameTransform::getOrientation() const
+{
+    return m_orientation;
+}
+
+/****************************************************************************************************
+ * \fn bool swapsAxes() const
+ * \brief  check if the orientation swaps the width and the height
+ * \param  none
+ * \return true for the rotations of 90 or 270 degrees and the transpositions
+ ****************************************************************************************************/
+bool CameraFrameTransform::swapsAxes() const
+{
+    return ((m_orientation == Transpose) || (m_orientation == Rotate90) ||
+            (m_orientation == Rotate270) || (m_orientation == AntiTranspose));
+}
+
+/****************************************************************************************************
+ * \fn CameraFrameTransform inverse() const
+ * \brief  get the inverse transform
+ * \param  none
+ * \return inverse transform
+ ****************************************************************************************************/
+CameraFrameTransform CameraFrameTransform::inverse() const
+{
+    if(m_orientation == Rotate90)
+        return CameraFrameTransform(Rotate270);
+
+    if(m_orientation == Rotate270)
+        return CameraFrameTransform(Rotate90);
+
+    // the other transforms are their own inverse
+    return CameraFrameTransform(m_orientation);
+}
+
+/****************************************************************************************************
+ * \fn void computeSteps(std::size_t in_source_width, std::size_t in_source_height, std::size_t in_destination_stride, std::ptrdiff_t & out_base, std::ptrdiff_t & out_step_x, std::ptrdiff_t & out_step_y) const
+ * \brief  compute the destination index of the source origin and the destination steps of the source axes.
+ *         The destination index of the source pixel (x, y) is base + x * step_x + y * step_y.
+ * \param  in_source_width source image width
+ * \param  in_source_height source image height
+ * \param  in_destination_stride number of pixels between two destination rows
+ * \param  out_base destination index of the source pixel (0, 0)
+ * \param  out_step_x destination step for one source column
+ * \param  out_step_y destination step for one source row
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::computeSteps(std::size_t      in_source_width      ,
+                                        std::size_t      in_source_height     ,
+                                        std::size_t      in_destination_stride,
+                                        std::ptrdiff_t & out_base             ,
+                                        std::ptrdiff_t & out_step_x           ,
+                                        std::ptrdiff_t & out_step_y           ) const
+{
+    std::ptrdiff_t width  = static_cast<std::ptrdiff_t>(in_source_width      );
+    std::ptrdiff_t height = static_cast<std::ptrdiff_t>(in_source_height     );
+    std::ptrdiff_t stride = static_cast<std::ptrdiff_t>(in_destination_stride);
+
+    switch(m_orientation)
+    {
+        case FlipX        : out_base = width - 1                           ; out_step_x = -1     ; out_step_y =  stride; break;
+        case FlipY        : out_base = (height - 1) * stride               ; out_step_x =  1     ; out_step_y = -stride; break;
+        case Rotate180    : out_base = (height - 1) * stride + width - 1   ; out_step_x = -1     ; out_step_y = -stride; break;
+        case Transpose    : out_base = 0                                   ; out_step_x =  stride; out_step_y =  1     ; break;
+        case Rotate90     : out_base = height - 1                          ; out_step_x =  stride; out_step_y = -1     ; break;
+        case Rotate270    : out_base = (width - 1) * stride                ; out_step_x = -stride; out_step_y =  1     ; break;
+        case AntiTranspose: out_base = (width - 1) * stride + height - 1   ; out_step_x = -stride; out_step_y = -1     ; break;
+        default           : out_base = 0                                   ; out_step_x =  1     ; out_step_y =  stride; break;
+    }
+}
+
+/****************************************************************************************************
+ * \fn void getDestinationSize(std::size_t in_source_width, std::size_t in_source_height, std::size_t & out_width, std::size_t & out_height) const
+ * \brief  compute the destination frame size of a source image
+ * \param  in_source_width source image width
+ * \param  in_source_height source image height
+ * \param  out_width destination frame width
+ * \param  out_height destination frame height
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::getDestinationSize(std::size_t   in_source_width ,
+                                              std::size_t   in_source_height,
+                                              std::size_t & out_width       ,
+                                              std::size_t & out_height      ) const
+{
+    out_width  = (swapsAxes()) ? in_source_height : in_source_width ;
+    out_height = (swapsAxes()) ? in_source_width  : in_source_height;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getDestinationIndex(std::size_t in_source_x, std::size_t in_source_y, std::size_t in_source_width, std::size_t in_source_height) const
+ * \brief  compute the destination index of a source pixel
+ * \param  in_source_x source pixel column
+ * \param  in_source_y source pixel row
+ * \param  in_source_width source image width
+ * \param  in_source_height source image height
+ * \return destination index
+ ****************************************************************************************************/
+std::size_t CameraFrameTransform::getDestinationIndex(std::size_t in_source_x     ,
+                                                      std::size_t in_source_y     ,
+                                                      std::size_t in_source_width ,
+                                                      std::size_t in_source_height) const
+{
+    std::size_t    width;
+    std::size_t    height;
+    std::ptrdiff_t base;
+    std::ptrdiff_t step_x;
+    std::ptrdiff_t step_y;
+
+    getDestinationSize(in_source_width, in_source_height, width, height);
+    computeSteps(in_source_width, in_source_height, width, base, step_x, step_y);
+
+    return static_cast<std::size_t>(base + static_cast<std::ptrdiff_t>(in_source_x) * step_x
+                                         + static_cast<std::ptrdiff_t>(in_source_y) * step_y);
+}
+
+/****************************************************************************************************
+ * \fn void getDestinationCoordinates(std::size_t in_source_x, std::size_t in_source_y, std::size_t in_source_width, std::size_t in_source_height, std::size_t & out_x, std::size_t & out_y) const
+ * \brief  compute the destination coordinates of a source pixel
+ * \param  in_source_x source pixel column
+ * \param  in_source_y source pixel row
+ * \param  in_source_width source image width
+ * \param  in_source_height source image height
+ * \param  out_x destination pixel column
+ * \param  out_y destination pixel row
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::getDestinationCoordinates(std::size_t   in_source_x     ,
+                                                     std::size_t   in_source_y     ,
+                                                     std::size_t   in_source_width ,
+                                                     std::size_t   in_source_height,
+                                                     std::size_t & out_x           ,
+                                                     std::size_t & out_y           ) const
+{
+    std::size_t width;
+    std::size_t height;
+    std::size_t index = getDestinationIndex(in_source_x, in_source_y, in_source_width, in_source_height);
+
+    getDestinationSize(in_source_width, in_source_height, width, height);
+
+    out_x = index % width;
+    out_y = index / width;
+}
+
+/****************************************************************************************************
+ * \fn void getSourceCoordinates(std::size_t in_index, std::size_t in_source_width, std::size_t in_source_height, std::size_t & out_x, std::size_t & out_y) const
+ * \brief  compute the source coordinates of a destination pixel
+ * \param  in_index destination index
+ * \param  in_source_width source image width
+ * \param  in_source_height source image height
+ * \param  out_x source pixel column
+ * \param  out_y source pixel row
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::getSourceCoordinates(std::size_t   in_index        ,
+                                                std::size_t   in_source_width ,
+                                                std::size_t   in_source_height,
+                                                std::size_t & out_x           ,
+                                                std::size_t & out_y           ) const
+{
+    std::size_t width;
+    std::size_t height;
+
+    getDestinationSize(in_source_width, in_source_height, width, height);
+
+    inverse().getDestinationCoordinates(in_index % width, in_index / width, width, height, out_x, out_y);
+}
+
+/****************************************************************************************************
+ * \fn void transformRect(...) const
+ * \brief  compute the destination rectangle of a source rectangle
+ * \param  in_x source rectangle column
+ * \param  in_y source rectangle row
+ * \param  in_width source rectangle width
+ * \param  in_height source rectangle height
+ * \param  in_source_width source image width
+ * \param  in_source_height source image height
+ * \param  out_x destination rectangle column
+ * \param  out_y destination rectangle row
+ * \param  out_width destination rectangle width
+ * \param  out_height destination rectangle height
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::transformRect(std::size_t   in_x            ,
+                                         std::size_t   in_y            ,
+                                         std::size_t   in_width        ,
+                                         std::size_t   in_height       ,
+                                         std::size_t   in_source_width ,
+                                         std::size_t   in_source_height,
+                                         std::size_t & out_x           ,
+                                         std::size_t & out_y           ,
+                                         std::size_t & out_width       ,
+                                         std::size_t & out_height      ) const
+{
+    getDestinationSize(in_width, in_height, out_width, out_height);
+
+    if((in_width == 0) || (in_height == 0))
+    {
+        out_x = in_x;
+        out_y = in_y;
+        return;
+    }
+
+    std::size_t first_x;
+    std::size_t first_y;
+    std::size_t last_x ;
+    std::size_t last_y ;
+
+    // the opposite corners of the rectangle stay opposite corners
+    getDestinationCoordinates(in_x               , in_y                , in_source_width, in_source_height, first_x, first_y);
+    getDestinationCoordinates(in_x + in_width - 1, in_y + in_height - 1, in_source_width, in_source_height, last_x , last_y );
+
+    out_x = std::min(first_x, last_x);
+    out_y = std::min(first_y, last_y);
+}
+
+/****************************************************************************************************
+ * \fn void copyRowSegment(const uint16_t * in_source, std::size_t in_nb, std::ptrdiff_t in_start, std::ptrdiff_t in_step_x, uint16_t * out_destination)
+ * \brief  copy a part of a source row
+ * \param  in_source first source pixel
+ * \param  in_nb number of pixels
+ * \param  in_start destination index of the first pixel
+ * \param  in_step_x destination step for one source column
+ * \param  out_destination destination frame
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::copyRowSegment(const uint16_t * in_source      ,
+                                          std::size_t      in_nb          ,
+                                          std::ptrdiff_t   in_start       ,
+                                          std::ptrdiff_t   in_step_x      ,
+                                          uint16_t       * out_destination)
+{
+    std::ptrdiff_t nb    = static_cast<std::ptrdiff_t>(in_nb);
+    std::ptrdiff_t index = 0;
+
+    if(in_step_x == 1)
+    {
+        memcpy(reinterpret_cast<char *>(out_destination + in_start),
+               reinterpret_cast<const char *>(in_source),
+               in_nb * sizeof(uint16_t));
+    }
+    else
+    if(in_step_x == -1)
+    {
+    #if defined(__SSE2__)
+        for( ; index + 8 <= nb ; index += 8)
+        {
+            __m128i pixels = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_source + index));
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(out_destination + in_start - index - 7), reverse8(pixels));
+        }
+    #endif
+        for( ; index < nb ; index++)
+        {
+            out_destination[in_start - index] = in_source[index];
+        }
+    }
+    else
+    {
+        for( ; index < nb ; index++)
+        {
+            out_destination[in_start + index * in_step_x] = in_source[index];
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn void copyTransposedRows(...)
+ * \brief  copy complete source rows with a transposition.
+ *         The rows are treated by tiles which fit in the L1 cache (source and destination),
+ *         each tile being treated by 8x8 blocks.
+ * \param  in_source first pixel of the first row
+ * \param  in_source_width source row length in pixels
+ * \param  in_first_row source row number of the first row
+ * \param  in_rows_nb number of rows
+ * \param  in_base destination index of the source pixel (0, 0)
+ * \param  in_step_x destination step for one source column
+ * \param  in_step_y destination step for one source row (1 or -1)
+ * \param  out_destination destination frame
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::copyTransposedRows(const uint16_t * in_source       ,
+                                              std::size_t      in_source_width ,
+                                              std::size_t      in_first_row    ,
+                                              std::size_t      in_rows_nb      ,
+                                              std::ptrdiff_t   in_base         ,
+                                              std::ptrdiff_t   in_step_x       ,
+                                              std::ptrdiff_t   in_step_y       ,
+                                              uint16_t       * out_destination )
+{
+    for(std::size_t tile_y = 0 ; tile_y < in_rows_nb ; tile_y += g_tile_size)
+    {
+        std::size_t tile_y_end = std::min(in_rows_nb, tile_y + g_tile_size);
+
+        for(std::size_t tile_x = 0 ; tile_x < in_source_width ; tile_x += g_tile_size)
+        {
+            std::size_t tile_x_end = std::min(in_source_width, tile_x + g_tile_size);
+
+            for(std::size_t block_y = tile_y ; block_y < tile_y_end ; block_y += g_block_size)
+            {
+                std::size_t rows_nb = std::min(g_block_size, tile_y_end - block_y);
+
+                for(std::size_t block_x = tile_x ; block_x < tile_x_end ; block_x += g_block_size)
+                {
+                    std::size_t      columns_nb = std::min(g_block_size, tile_x_end - block_x);
+                    const uint16_t * block      = in_source + block_y * in_source_width + block_x;
+                    std::ptrdiff_t   start      = in_base + static_cast<std::ptrdiff_t>(block_x) * in_step_x
+                                                          + static_cast<std::ptrdiff_t>(in_first_row + block_y) * in_step_y;
+
+                #if defined(__SSE2__)
+                    if((rows_nb == 8) && (columns_nb == 8))
+                    {
+                        transposeBlock8x8(block, in_source_width, start, in_step_x, in_step_y, out_destination);
+                        continue;
+                    }
+                #endif
+
+                    for(std::size_t row = 0 ; row < rows_nb ; row++)
+                    {
+                        for(std::size_t column = 0 ; column < columns_nb ; column++)
+                        {
+                            out_destination[start + static_cast<std::ptrdiff_t>(column) * in_step_x
+                                                  + static_cast<std::ptrdiff_t>(row   ) * in_step_y] = block[row * in_source_width + column];
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn void copyPart(const uint16_t * in_source, std::size_t in_offset, std::size_t in_pixels_nb, std::size_t in_source_width, std::size_t in_source_height, uint16_t * out_destination) const
+ * \brief  copy a part of the source image (linear range of pixels) at its oriented location.
+ *         The part is split in an incomplete first row, complete rows and an incomplete last row.
+ * \param  in_source pixels of the part
+ * \param  in_offset index of the first pixel of the part in the source image
+ * \param  in_pixels_nb number of pixels of the part
+ * \param  in_source_width source image width
+ * \param  in_source_height source image height
+ * \param  out_destination destination frame
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::copyPart(const uint16_t * in_source       ,
+                                    std::size_t      in_offset       ,
+                                    std::size_t      in_pixels_nb    ,
+                                    std::size_t      in_source_width ,
+                                    std::size_t      in_source_height,
+                                    uint16_t       * out_destination ) const
+{
+    std::size_t width ;
+    std::size_t height;
+
+    getDestinationSize(in_source_width, in_source_height, width, height);
+
+    copyPart(in_source, in_offset, in_pixels_nb, in_source_width, in_source_height, out_destination, width);
+}
+
+/****************************************************************************************************
+ * \fn void copyPart(const uint16_t * in_source, std::size_t in_offset, std::size_t in_pixels_nb, std::size_t in_source_width, std::size_t in_source_height, uint16_t * out_destination, std::size_t in_destination_stride) const
+ * \brief  copy a part of the source image at its oriented location in a larger destination image
+ *         (a tile of a mosaic for example).
+ *         The part is split in an incomplete first row, complete rows and an incomplete last row.
+ * \param  in_source pixels of the part
+ * \param  in_offset index of the first pixel of the part in the source image
+ * \param  in_pixels_nb number of pixels of the part
+ * \param  in_source_width source image width
+ * \param  in_source_height source image height
+ * \param  out_destination first pixel of the oriented image in the destination image
+ * \param  in_destination_stride number of pixels between two destination rows
+ * \return none
+ ****************************************************************************************************/
+void CameraFrameTransform::copyPart(const uint16_t * in_source            ,
+                                    std::size_t      in_offset            ,
+                                    std::size_t      in_pixels_nb         ,
+                                    std::size_t      in_source_width      ,
+                                    std::size_t      in_source_height     ,
+                                    uint16_t       * out_destination      ,
+                                    std::size_t      in_destination_stride) const
+{
+    // fast path without any transform into a dense image
+    if((m_orientation == Normal) && (in_destination_stride == in_source_width))
+    {
+        memcpy(reinterpret_cast<char *>(out_destination + in_offset),
+               reinterpret_cast<const char *>(in_source),
+               in_pixels_nb * sizeof(uint16_t));
+        return;
+    }
+
+    std::ptrdiff_t base;
+    std::ptrdiff_t step_x;
+    std::ptrdiff_t step_y;
+
+    computeSteps(in_source_width, in_source_height, in_destination_stride, base, step_x, step_y);
+
+    std::size_t      x         = in_offset % in_source_width;
+    std::size_t      y         = in_offset / in_source_width;
+    std::size_t      remaining = in_pixels_nb;
+    const uint16_t * source    = in_source;
+
+    // incomplete first row
+    if((x != 0) && (remaining > 0))
+    {
+        std::size_t nb = std::min(in_source_width - x, remaining);
+
+        copyRowSegment(source, nb, base + static_cast<std::ptrdiff_t>(x) * step_x + static_cast<std::ptrdiff_t>(y) * step_y, step_x, out_destination);
+
+        source    += nb;
+        remaining -= nb;
+        y++;
+    }
+
+    // complete rows
+    std::size_t rows_nb = remaining / in_source_width;
+
+    if(rows_nb > 0)
+    {
+        if((step_x == 1) || (step_x == -1))
+        {
+            for(std::size_t row = 0 ; row < rows_nb ; row++)
+            {
+                copyRowSegment(source + row * in_source_width, in_source_width, base + static_cast<std::ptrdiff_t>(y + row) * step_y, step_x, out_destination);
+            }
+        }
+        else
+        {
+            copyTransposedRows(source, in_source_width, y, rows_nb, base, step_x, step_y, out_destination);
+        }
+
+        source    += rows_nb * in_source_width;
+        remaining -= rows_nb * in_source_width;
+        y         += rows_nb;
+    }
+
+    // incomplete last row
+    if(remaining > 0)
+    {
+        copyRowSegment(source, remaining, base + static_cast<std::ptrdiff_t>(y) * step_y, step_x, out_destination);
+    }
+}
+
+/****************************************************************************************************
+ * \fn std::string toString(Orientation in_orientation)
+ * \brief  convert an orientation to a string
+ * \param  in_orientation orientation
+ * \return orientation name
+ ****************************************************************************************************/
+std::string CameraFrameTransform::toString(Orientation in_orientation)
+{
+    switch(in_orientation)
+    {
+        case FlipX        : return "FLIP_X"        ;
+        case FlipY        : return "FLIP_Y"        ;
+        case Rotate180    : return "ROTATE_180"    ;
+        case Transpose    : return "TRANSPOSE"     ;
+        case Rotate90     : return "ROTATE_90"     ;
+        case Rotate270    : return "ROTATE_270"    ;
+        case AntiTranspose: return "ANTI_TRANSPOSE";
+        default           : return "NORMAL"        ;
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool fromString(const std::string & in_text, Orientation & out_orientation)
+ * \brief  convert a string to an orientation
+ * \param  in_text orientation name
+ * \param  out_orientation orientation
+ * \return true if the name is known, else false
+ ****************************************************************************************************/
+bool CameraFrameTransform::fromString(const std::string & in_text, Orientation & out_orientation)
+{
+    for(int orientation = Normal ; orientation <= AntiTranspose ; orientation++)
+    {
+        if(in_text == toString(static_cast<Orientation>(orientation)))
+        {
+            out_orientation = static_cast<Orientation>(orientation);
+            return true;
+        }
+    }
+
+    return false;
+}
+
+//###########################################################################
@@ -0,0 +1,909 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraHdf5Writer.cpp
+ * \brief  implementation file of the HDF5/NeXus writer stage.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraHdf5Writer.h"
+#include "CameraControl.h"
+#include "CameraClock.h"
+
+// SYSTEM
+#include <cstring>
+#include <cstdio>
+#include <sys/time.h>
+#include <algorithm>
+
+#ifdef SPECTRAL_CAMERA_ACTIVATE_HDF5_WRITER
+#include <hdf5.h>
+#include <zlib.h>
+#endif
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraHdf5Writer::g_metadata_batch_size   = 256;
+const std::size_t CameraHdf5Writer::g_extent_step           = 64 ;
+const std::size_t CameraHdf5Writer::g_default_buffers_nb    = 16 ;
+const int         CameraHdf5Writer::g_max_compression_level = 9  ;
+const double      CameraHdf5Writer::g_wait_job_delay_sec    = 0.5;
+
+#ifdef SPECTRAL_CAMERA_ACTIVATE_HDF5_WRITER
+//------------------------------------------------------------------
+// HDF5 helpers
+//------------------------------------------------------------------
+/****************************************************************************************************
+ * \fn static bool writeStringAttribute(hid_t in_object, const char * in_name, const std::string & in_value)
+ * \brief  write a string attribute
+ * \param  in_object object (group or dataset) of the attribute
+ * \param  in_name attribute name
+ * \param  in_value attribute value
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+static bool writeStringAttribute(hid_t in_object, const char * in_name, const std::string & in_value)
+{
+    hid_t  type   = H5Tcopy(H5T_C_S1);
+    H5Tset_size(type, std::max(in_value.size(), static_cast<std::size_t>(1)));
+
+    hid_t  space  = H5Screate(H5S_SCALAR);
+    hid_t  attr   = H5Acreate2(in_object, in_name, type, space, H5P_DEFAULT, H5P_DEFAULT);
+    herr_t result = (attr < 0) ? -1 : H5Awrite(attr, type, in_value.c_str());
+
+    if(attr >= 0) H5Aclose(attr);
+    H5Sclose(space);
+    H5Tclose(type );
+
+    return (result >= 0);
+}
+
+/****************************************************************************************************
+ * \fn static bool writeStringDataSet(hid_t in_group, const char * in_name, const std::string & in_value)
+ * \brief  write a scalar string dataset
+ * \param  in_group parent group
+ * \param  in_name dataset name
+ * \param  in_value dataset value
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+static bool writeStringDataSet(hid_t in_group, const char * in_name, const std::string & in_value)
+{
+    hid_t  type   = H5Tcopy(H5T_C_S1);
+    H5Tset_size(type, std::max(in_value.size(), static_cast<std::size_t>(1)));
+
+    hid_t  space  = H5Screate(H5S_SCALAR);
+    hid_t  set    = H5Dcreate2(in_group, in_name, type, space, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+    herr_t result = (set < 0) ? -1 : H5Dwrite(set, type, H5S_ALL, H5S_ALL, H5P_DEFAULT, in_value.c_str());
+
+    if(set >= 0) H5Dclose(set);
+    H5Sclose(space);
+    H5Tclose(type );
+
+    return (result >= 0);
+}
+
+/****************************************************************************************************
+ * \fn static hid_t createNexusGroup(hid_t in_parent, const char * in_name, const char * in_class)
+ * \brief  create a group with its NeXus class attribute
+ * \param  in_parent parent group or file
+ * \param  in_name group name
+ * \param  in_class NeXus class of the group
+ * \return group identifier, negative in case of error
+ ****************************************************************************************************/
+static hid_t createNexusGroup(hid_t in_parent, const char * in_name, const char * in_class)
+{
+    hid_t group = H5Gcreate2(in_parent, in_name, H5P_DEFAULT, H5P_DEFAULT, H5P_DEFAULT);
+
+    if((group >= 0) && (!writeStringAttribute(group, "NX_class", in_class)))
+    {
+        H5Gclose(group);
+        group = -1;
+    }
+
+    return group;
+}
+
+/****************************************************************************************************
+ * \fn static hid_t createMetadataDataSet(hid_t in_group, const char * in_name, hid_t in_type, const char * in_units, std::size_t in_chunk_size)
+ * \brief  create an empty extensible one dimension dataset
+ * \param  in_group parent group
+ * \param  in_name dataset name
+ * \param  in_type values type
+ * \param  in_units units attribute (NULL for none)
+ * \param  in_chunk_size number of values of a chunk
+ * \return dataset identifier, negative in case of error
+ ****************************************************************************************************/
+static hid_t createMetadataDataSet(hid_t in_group, const char * in_name, hid_t in_type, const char * in_units, std::size_t in_chunk_size)
+{
+    hsize_t dims    [1] = { 0                             };
+    hsize_t max_dims[1] = { H5S_UNLIMITED                 };
+    hsize_t chunk   [1] = { static_cast<hsize_t>(in_chunk_size) };
+
+    hid_t space = H5Screate_simple(1, dims, max_dims);
+    hid_t dcpl  = H5Pcreate(H5P_DATASET_CREATE);
+
+    H5Pset_chunk(dcpl, 1, chunk);
+
+    hid_t set = H5Dcreate2(in_group, in_name, in_type, space, H5P_DEFAULT, dcpl, H5P_DEFAULT);
+
+    H5Pclose(dcpl );
+    H5Sclose(space);
+
+    if((set >= 0) && (in_units != NULL) && (!writeStringAttribute(set, "units", in_units)))
+    {
+        H5Dclose(set);
+        set = -1;
+    }
+
+    return set;
+}
+
+/****************************************************************************************************
+ * \fn static bool appendValues(hid_t in_set, hid_t in_type, const void * in_values, std::size_t in_offset, std::size_t in_values_nb)
+ * \brief  extend a one dimension dataset and write values at its end
+ * \param  in_set dataset
+ * \param  in_type values type in memory
+ * \param  in_values values to write
+ * \param  in_offset number of values already in the dataset
+ * \param  in_values_nb number of values to write
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+static bool appendValues(hid_t in_set, hid_t in_type, const void * in_values, std::size_t in_offset, std::size_t in_values_nb)
+{
+    hsize_t dims [1] = { static_cast<hsize_t>(in_offset + in_values_nb) };
+    hsize_t start[1] = { static_cast<hsize_t>(in_offset)                };
+    hsize_t count[1] = { static_cast<hsize_t>(in_values_nb)             };
+
+    if(H5Dset_extent(in_set, dims) < 0)
+        return false;
+
+    hid_t  file_space   = H5Dget_space(in_set);
+    hid_t  memory_space = H5Screate_simple(1, count, NULL);
+    herr_t result       = H5Sselect_hyperslab(file_space, H5S_SELECT_SET, start, NULL, count, NULL);
+
+    if(result >= 0)
+    {
+        result = H5Dwrite(in_set, in_type, memory_space, file_space, H5P_DEFAULT, in_values);
+    }
+
+    H5Sclose(memory_space);
+    H5Sclose(file_space  );
+
+    return (result >= 0);
+}
+#endif
+
+/****************************************************************************************************
+ * \fn CameraHdf5Writer()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraHdf5Writer::CameraHdf5Writer() : CameraFrameStage("Hdf5Writer"),
+                                       m_pending_jobs("Hdf5WriterPendingJobs"),
+                                       m_free_jobs   ("Hdf5WriterFreeJobs"   )
+{
+    DEB_CONSTRUCTOR();
+
+    m_path_prefix         = "/tmp/spectral_instrument_";
+    m_compression_level   = 0    ;
+    m_buffers_nb          = g_default_buffers_nb;
+    m_created_buffers_nb  = 0    ;
+    m_acquisition_nb      = 0    ;
+    m_acquisition_opened  = false;
+    m_file                = -1   ;
+    m_data_set            = -1   ;
+    m_frame_nb_set        = -1   ;
+    m_time_set            = -1   ;
+    m_temperature_set     = -1   ;
+    m_exposure_set        = -1   ;
+    m_written_frames_nb   = 0    ;
+    m_allocated_frames_nb = 0    ;
+    m_written_metadata_nb = 0    ;
+
+    memset(&m_counters, 0, sizeof(CameraHdf5Counters));
+
+    m_batch_frame_nb.reserve   (g_metadata_batch_size);
+    m_batch_time.reserve       (g_metadata_batch_size);
+    m_batch_temperature.reserve(g_metadata_batch_size);
+    m_batch_exposure.reserve   (g_metadata_batch_size);
+
+    m_pending_jobs.setDelayBeforeTimeoutSec(g_wait_job_delay_sec);
+
+    // starting the writer thread
+    m_thread = new CameraWriterThread(this);
+    m_thread->start();
+    m_thread->startWriting();
+}
+
+/****************************************************************************************************
+ * \fn ~CameraHdf5Writer()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraHdf5Writer::~CameraHdf5Writer()
+{
+    DEB_DESTRUCTOR();
+
+    // stopping the writer thread
+    m_thread->stopWriting();
+    delete m_thread;
+
+    // the jobs still queued are written before the release
+    while(!m_pending_jobs.empty())
+    {
+        CameraHdf5Job * job = m_pending_jobs.take();
+
+        writeJob  (job);
+        releaseJob(job);
+    }
+
+    closeFile();
+}
+
+/****************************************************************************************************
+ * \fn bool isAvailable()
+ * \brief  check if the HDF5 support was compiled (SPECTRAL_CAMERA_ACTIVATE_HDF5_WRITER define)
+ * \param  none
+ * \return true if the writer can be used
+ ****************************************************************************************************/
+bool CameraHdf5Writer::isAvailable()
+{
+#ifdef SPECTRAL_CAMERA_ACTIVATE_HDF5_WRITER
+    return true;
+#else
+    return false;
+#endif
+}
+
+/****************************************************************************************************
+ * \fn void setPathPrefix(const std::string & in_path_prefix)
+ * \brief  set the directory and prefix of the files (used from the next acquisition).
+ *         The acquisition index and the extension are added to it.
+ * \param  in_path_prefix directory and prefix of the files
+ * \return none
+ ****************************************************************************************************/
+void CameraHdf5Writer::setPathPrefix(const std::string & in_path_prefix)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_path_prefix    = in_path_prefix;
+    m_acquisition_nb = 0;
+}
+
+/****************************************************************************************************
+ * \fn std::string getPathPrefix() const
+ * \brief  get the directory and prefix of the files
+ * \param  none
+ * \return directory and prefix of the files
+ ****************************************************************************************************/
+std::string CameraHdf5Writer::getPathPrefix() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_path_prefix;
+}
+
+/****************************************************************************************************
+ * \fn bool setCompressionLevel(int in_compression_level)
+ * \brief  set the deflate level of the chunks (used from the next acquisition)
+ * \param  in_compression_level deflate level (0 for no compression, 1 to 9)
+ * \return true if succeed, false if the level is incorrect
+ ****************************************************************************************************/
+bool CameraHdf5Writer::setCompressionLevel(int in_compression_level)
+{
+    if((in_compression_level < 0) || (in_compression_level > g_max_compression_level))
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_compression_level = in_compression_level;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn int getCompressionLevel() const
+ * \brief  get the deflate level of the chunks
+ * \param  none
+ * \return deflate level (0 for no compression)
+ ****************************************************************************************************/
+int CameraHdf5Writer::getCompressionLevel() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_compression_level;
+}
+
+/****************************************************************************************************
+ * \fn bool setBuffersNb(std::size_t in_buffers_nb)
+ * \brief  set the number of frame buffers of the queue. The buffers are allocated at the
+ *         preparation of the acquisition and are only released with the writer.
+ * \param  in_buffers_nb number of frame buffers
+ * \return true if succeed, false if the number is incorrect
+ ****************************************************************************************************/
+bool CameraHdf5Writer::setBuffersNb(std::size_t in_buffers_nb)
+{
+    if(in_buffers_nb == 0)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_buffers_nb = in_buffers_nb;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getBuffersNb() const
+ * \brief  get the number of frame buffers of the queue
+ * \param  none
+ * \return number of frame buffers
+ ****************************************************************************************************/
+std::size_t CameraHdf5Writer::getBuffersNb() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_buffers_nb;
+}
+
+/****************************************************************************************************
+ * \fn CameraHdf5Counters getCounters() const
+ * \brief  get the counters since the start of the acquisition
+ * \param  none
+ * \return counters copy
+ ****************************************************************************************************/
+CameraHdf5Counters CameraHdf5Writer::getCounters() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_counters;
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition. The camera settings are copied for the
+ *         metadata (the data update is suspended during the acquisition).
+ * \param  in_format format of the frames
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraHdf5Writer::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    // closing the file of a previous acquisition
+    endAcq();
+
+    if(!isEnabled())
+        return true;
+
+    if(!isAvailable())
+    {
+        DEB_ERROR() << "CameraHdf5Writer::prepareAcq - The HDF5 support was not compiled!";
+        return false;
+    }
+
+    CameraHdf5Job * open_job = new CameraHdf5Job();
+    const CameraControl * control = CameraControl::getConstInstance();
+
+    open_job->m_type                     = CameraHdf5Job::Open;
+    open_job->m_settings.m_width           = in_format.m_width ;
+    open_job->m_settings.m_height          = in_format.m_height;
+    open_job->m_settings.m_model           = control->getModel       ();
+    open_job->m_settings.m_serial_number   = control->getSerialNumber();
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        open_job->m_settings.m_path_prefix       = m_path_prefix;
+        open_job->m_settings.m_acquisition_nb    = m_acquisition_nb++;
+        open_job->m_settings.m_compression_level = m_compression_level;
+
+        // the frame buffers are allocated now, so the reception never waits for a memory allocation
+        while(m_created_buffers_nb < m_buffers_nb)
+        {
+            CameraHdf5Job * job = new CameraHdf5Job();
+            job->m_data.reserve(in_format.m_width * in_format.m_height);
+
+            m_free_jobs.put(job);
+            m_created_buffers_nb++;
+        }
+
+        memset(&m_counters, 0, sizeof(CameraHdf5Counters));
+        m_acquisition_opened = true;
+    }
+
+    m_pending_jobs.put(open_job);
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  queue a complete frame for the writing (called by the acquisition thread)
+ * \param  in_out_frame frame to write
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraHdf5Writer::process(CameraFrame & in_out_frame)
+{
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        if((!m_acquisition_opened) || (in_out_frame.m_drop))
+            return true;
+
+        // no free buffer: the frame is not written, the reception should not wait for the storage
+        if(m_free_jobs.empty())
+        {
+            m_counters.m_dropped_frames_nb++;
+            return true;
+        }
+    }
+
+    CameraHdf5Job * job = m_free_jobs.take();
+
+    if(job == NULL)
+        return true;
+
+    // the record is copied with the frame, its ring entry can be reused during the writing
+    if(in_out_frame.m_metadata != NULL)
+    {
+        job->m_metadata = *in_out_frame.m_metadata;
+    }
+    else
+    {
+        memset(&job->m_metadata, 0, sizeof(CameraFrameMetadata));
+        job->m_metadata.m_frame_nb       = static_cast<uint64_t>(in_out_frame.m_frame_nb);
+        job->m_metadata.m_last_part_time = CameraClock::getConstInstance()->getRealTimeSec();
+    }
+
+    job->m_type     = CameraHdf5Job::Frame;
+    job->m_width    = in_out_frame.m_width   ;
+    job->m_height   = in_out_frame.m_height  ;
+    job->m_frame_nb = in_out_frame.m_frame_nb;
+    job->m_data.assign(in_out_frame.m_data, in_out_frame.m_data + (in_out_frame.m_width * in_out_frame.m_height));
+
+    m_pending_jobs.put(job);
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+    m_counters.m_queued_frames_nb++;
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void endAcq()
+ * \brief  close the file of the current acquisition (called at the end of the acquisition)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraHdf5Writer::endAcq()
+{
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        if(!m_acquisition_opened)
+            return;
+
+        m_acquisition_opened = false;
+    }
+
+    CameraHdf5Job * close_job = new CameraHdf5Job();
+    close_job->m_type = CameraHdf5Job::Close;
+
+    m_pending_jobs.put(close_job);
+}
+
+/****************************************************************************************************
+ * \fn void writeNext()
+ * \brief  write the next queued job, waits a short delay if the queue is empty
+ *         (called by the writer thread)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraHdf5Writer::writeNext()
+{
+    if(!m_pending_jobs.waiting_while_empty())
+        return;
+
+    if(m_pending_jobs.empty())
+        return;
+
+    CameraHdf5Job * job = m_pending_jobs.take();
+
+    if(job != NULL)
+    {
+        writeJob  (job);
+        releaseJob(job);
+    }
+}
+
+/****************************************************************************************************
+ * \fn void releaseJob(CameraHdf5Job * in_job)
+ * \brief  give a frame buffer back to the free list or release a job
+ * \param  in_job treated job
+ * \return none
+ ****************************************************************************************************/
+void CameraHdf5Writer::releaseJob(CameraHdf5Job * in_job)
+{
+    if(in_job->m_type == CameraHdf5Job::Frame)
+    {
+        m_free_jobs.put(in_job);
+    }
+    else
+    {
+        delete in_job;
+    }
+}
+
+/****************************************************************************************************
+ * \fn void writeJob(CameraHdf5Job * in_job)
+ * \brief  write a job (called by the writer thread)
+ * \param  in_job job to treat
+ * \return none
+ ****************************************************************************************************/
+void CameraHdf5Writer::writeJob(CameraHdf5Job * in_job)
+{
+    if(in_job->m_type == CameraHdf5Job::Open)
+    {
+        closeFile();
+
+        if(!openFile(in_job->m_settings))
+        {
+            closeFile();
+        }
+    }
+    else
+    if(in_job->m_type == CameraHdf5Job::Close)
+    {
+        closeFile();
+    }
+    else
+    {
+        bool result = (m_file >= 0) && writeFrame(*in_job);
+
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        if(result)
+        {
+            m_counters.m_written_frames_nb++;
+        }
+        else
+        {
+            m_counters.m_errors_nb++;
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool openFile(const CameraHdf5Settings & in_settings)
+ * \brief  create the file of an acquisition with its groups and empty datasets
+ * \param  in_settings settings of the acquisition
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraHdf5Writer::openFile(const CameraHdf5Settings & in_settings)
+{
+    DEB_MEMBER_FUNCT();
+
+    m_settings = in_settings;
+
+#ifdef SPECTRAL_CAMERA_ACTIVATE_HDF5_WRITER
+    char file_name[32];
+    snprintf(file_name, sizeof(file_name), "%04zu.h5", in_settings.m_acquisition_nb);
+
+    std::string path = in_settings.m_path_prefix + file_name;
+
+    // the latest file format uses an extensible array to index the chunks of the frames
+    hid_t fapl = H5Pcreate(H5P_FILE_ACCESS);
+    H5Pset_libver_bounds(fapl, H5F_LIBVER_LATEST, H5F_LIBVER_LATEST);
+
+    m_file = H5Fcreate(path.c_str(), H5F_ACC_TRUNC, H5P_DEFAULT, fapl);
+    H5Pclose(fapl);
+
+    if(m_file < 0)
+    {
+        DEB_ERROR() << "CameraHdf5Writer::openFile - Unable to create the file " << path;
+        return false;
+    }
+
+    //------------------------------------------------------------------
+    // NeXus groups
+    hid_t entry      = createNexusGroup(m_file    , "entry"     , "NXentry"     );
+    hid_t instrument = (entry      < 0) ? -1 : createNexusGroup(entry     , "instrument", "NXinstrument");
+    hid_t detector   = (instrument < 0) ? -1 : createNexusGroup(instrument, "detector"  , "NXdetector"  );
+    hid_t data       = (entry      < 0) ? -1 : createNexusGroup(entry     , "data"      , "NXdata"      );
+    bool  result     = (detector >= 0) && (data >= 0);
+
+    result = result && writeStringDataSet(detector, "description"  , in_settings.m_model        );
+    result = result && writeStringDataSet(detector, "serial_number", in_settings.m_serial_number);
+
+    //------------------------------------------------------------------
+    // frames dataset: one chunk by frame, the chunk cache is useless with the direct chunk writes
+    if(result)
+    {
+        hsize_t dims    [3] = { 0            , in_settings.m_height, in_settings.m_width };
+        hsize_t max_dims[3] = { H5S_UNLIMITED, in_settings.m_height, in_settings.m_width };
+        hsize_t chunk   [3] = { 1            , in_settings.m_height, in_settings.m_width };
+
+        hid_t space = H5Screate_simple(3, dims, max_dims);
+        hid_t dcpl  = H5Pcreate(H5P_DATASET_CREATE);
+        hid_t dapl  = H5Pcreate(H5P_DATASET_ACCESS);
+
+        H5Pset_chunk(dcpl, 3, chunk);
+        H5Pset_chunk_cache(dapl, 0, 0, 1.0);
+
+        // the chunks are compressed by the writer, the filter is only declared for the readers
+        if(in_settings.m_compression_level > 0)
+        {
+            H5Pset_deflate(dcpl, static_cast<unsigned>(in_settings.m_compression_level));
+        }
+
+        m_data_set = H5Dcreate2(detector, "data", H5T_NATIVE_UINT16, space, H5P_DEFAULT, dcpl, dapl);
+
+        H5Pclose(dapl );
+        H5Pclose(dcpl );
+        H5Sclose(space);
+
+        result = (m_data_set >= 0)                                                                        &&
+                 writeStringAttribute(data, "signal", "data")                                             &&
+                 (H5Lcreate_hard(detector, "data", data, "data", H5P_DEFAULT, H5P_DEFAULT) >= 0);
+    }
+
+    //------------------------------------------------------------------
+    // metadata datasets
+    if(result)
+    {
+        m_frame_nb_set    = createMetadataDataSet(detector, "frame_number"  , H5T_NATIVE_UINT64, NULL  , g_metadata_batch_size);
+        m_time_set        = createMetadataDataSet(detector, "frame_end_time", H5T_NATIVE_DOUBLE, "s"   , g_metadata_batch_size);
+        m_temperature_set = createMetadataDataSet(detector, "temperature"   , H5T_NATIVE_DOUBLE, "degC", g_metadata_batch_size);
+        m_exposure_set    = createMetadataDataSet(detector, "count_time"    , H5T_NATIVE_DOUBLE, "s"   , g_metadata_batch_size);
+
+        result = (m_frame_nb_set >= 0) && (m_time_set >= 0) && (m_temperature_set >= 0) && (m_exposure_set >= 0);
+    }
+
+    if(data       >= 0) H5Gclose(data      );
+    if(detector   >= 0) H5Gclose(detector  );
+    if(instrument >= 0) H5Gclose(instrument);
+    if(entry      >= 0) H5Gclose(entry     );
+
+    if(!result)
+    {
+        DEB_ERROR() << "CameraHdf5Writer::openFile - Unable to create the NeXus structure of the file " << path;
+        return false;
+    }
+
+    // the compressed chunk can not be larger than this size
+    if(in_settings.m_compression_level > 0)
+    {
+        m_compressed.resize(compressBound(static_cast<uLong>(in_settings.m_width * in_settings.m_height * sizeof(uint16_t))));
+    }
+
+    return true;
+#else
+    DEB_ERROR() << "CameraHdf5Writer::openFile - The HDF5 support was not compiled!";
+    return false;
+#endif
+}
+
+/****************************************************************************************************
+ * \fn bool writeFrame(const CameraHdf5Job & in_job)
+ * \brief  write a frame as a complete chunk (compressed if needed) and keep its metadata
+ * \param  in_job frame job
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraHdf5Writer::writeFrame(const CameraHdf5Job & in_job)
+{
+    DEB_MEMBER_FUNCT();
+
+#ifdef SPECTRAL_CAMERA_ACTIVATE_HDF5_WRITER
+    if((in_job.m_width != m_settings.m_width) || (in_job.m_height != m_settings.m_height))
+    {
+        DEB_ERROR() << "CameraHdf5Writer::writeFrame - Incorrect frame size: " << in_job.m_width << "x" << in_job.m_height << "!";
+        return false;
+    }
+
+    // the frames dataset is extended by steps
+    if(m_written_frames_nb == m_allocated_frames_nb)
+    {
+        hsize_t dims[3] = { m_allocated_frames_nb + g_extent_step, m_settings.m_height, m_settings.m_width };
+
+        if(H5Dset_extent(m_data_set, dims) < 0)
+        {
+            DEB_ERROR() << "CameraHdf5Writer::writeFrame - Unable to extend the frames dataset!";
+            return false;
+        }
+
+        m_allocated_frames_nb += g_extent_step;
+    }
+
+    const void * chunk       = in_job.m_data.data();
+    std::size_t  raw_size    = in_job.m_data.size() * sizeof(uint16_t);
+    std::size_t  chunk_size  = raw_size;
+    uint32_t     filter_mask = 0;
+
+    if(m_settings.m_compression_level > 0)
+    {
+        uLongf compressed_size = static_cast<uLongf>(m_compressed.size());
+
+        if((compress2(m_compressed.data(), &compressed_size, static_cast<const Bytef *>(chunk), static_cast<uLong>(raw_size), m_settings.m_compression_level) == Z_OK) &&
+           (compressed_size < raw_size))
+        {
+            chunk      = m_compressed.data();
+            chunk_size = static_cast<std::size_t>(compressed_size);
+        }
+        else
+        {
+            // the chunk is written raw, the first filter (deflate) is marked as skipped
+            filter_mask = 0x1;
+        }
+    }
+
+    hsize_t offset[3] = { m_written_frames_nb, 0, 0 };
+
+    if(H5Dwrite_chunk(m_data_set, H5P_DEFAULT, filter_mask, offset, chunk_size, chunk) < 0)
+    {
+        DEB_ERROR() << "CameraHdf5Writer::writeFrame - Unable to write the chunk of the frame " << in_job.m_frame_nb << "!";
+        return false;
+    }
+
+    m_written_frames_nb++;
+
+    // keeping the metadata for a batch write
+    m_batch_frame_nb.push_back   (static_cast<uint64_t>(in_job.m_frame_nb));
+    m_batch_time.push_back       (in_job.m_metadata.m_last_part_time);
+    m_batch_temperature.push_back(static_cast<double>(in_job.m_metadata.m_ccd_temperature));
+    m_batch_exposure.push_back   (static_cast<double>(in_job.m_metadata.m_exposure_time_msec) / 1000.0);
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        m_counters.m_raw_bytes_nb     += raw_size  ;
+        m_counters.m_written_bytes_nb += chunk_size;
+    }
+
+    return (m_batch_frame_nb.size() < g_metadata_batch_size) || flushMetadata();
+#else
+    static_cast<void>(in_job);
+    return false;
+#endif
+}
+
+/****************************************************************************************************
+ * \fn bool flushMetadata()
+ * \brief  append the kept metadata to their datasets
+ * \param  none
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraHdf5Writer::flushMetadata()
+{
+    DEB_MEMBER_FUNCT();
+
+    bool result = true;
+
+#ifdef SPECTRAL_CAMERA_ACTIVATE_HDF5_WRITER
+    std::size_t values_nb = m_batch_frame_nb.size();
+
+    if(values_nb == 0)
+        return true;
+
+    result = appendValues(m_frame_nb_set   , H5T_NATIVE_UINT64, m_batch_frame_nb.data()   , m_written_metadata_nb, values_nb) &&
+             appendValues(m_time_set       , H5T_NATIVE_DOUBLE, m_batch_time.data()       , m_written_metadata_nb, values_nb) &&
+             appendValues(m_temperature_set, H5T_NATIVE_DOUBLE, m_batch_temperature.data(), m_written_metadata_nb, values_nb) &&
+             appendValues(m_exposure_set   , H5T_NATIVE_DOUBLE, m_batch_exposure.data()   , m_written_metadata_nb, values_nb);
+
+    if(!result)
+    {
+        DEB_ERROR() << "CameraHdf5Writer::flushMetadata - Unable to append the frames metadata!";
+    }
+
+    m_written_metadata_nb += values_nb;
+#endif
+
+    m_batch_frame_nb.clear   ();
+    m_batch_time.clear       ();
+    m_batch_temperature.clear();
+    m_batch_exposure.clear   ();
+
+    return result;
+}
+
+/****************************************************************************************************
+ * \fn void closeFile()
+ * \brief  write the remaining metadata, set the final size of the frames dataset and close
+ *         the file
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraHdf5Writer::closeFile()
+{
+#ifdef SPECTRAL_CAMERA_ACTIVATE_HDF5_WRITER
+    if(m_file >= 0)
+    {
+        if((m_frame_nb_set >= 0) && (m_time_set >= 0) && (m_temperature_set >= 0) && (m_exposure_set >= 0))
+        {
+            flushMetadata();
+        }
+
+        if(m_data_set >= 0)
+        {
+            hsize_t dims[3] = { m_written_frames_nb, m_settings.m_height, m_settings.m_width };
+
+            H5Dset_extent(m_data_set, dims);
+            H5Dclose     (m_data_set);
+        }
+
+        if(m_frame_nb_set    >= 0) H5Dclose(m_frame_nb_set   );
+        if(m_time_set        >= 0) H5Dclose(m_time_set       );
+        if(m_temperature_set >= 0) H5Dclose(m_temperature_set);
+        if(m_exposure_set    >= 0) H5Dclose(m_exposure_set   );
+
+        H5Fclose(m_file);
+    }
+#endif
+
+    m_file                = -1;
+    m_data_set            = -1;
+    m_frame_nb_set        = -1;
+    m_time_set            = -1;
+    m_temperature_set     = -1;
+    m_exposure_set        = -1;
+    m_written_frames_nb   = 0 ;
+    m_allocated_frames_nb = 0 ;
+    m_written_metadata_nb = 0 ;
+
+    m_batch_frame_nb.clear   ();
+    m_batch_time.clear       ();
+    m_batch_temperature.clear();
+    m_batch_exposure.clear   ();
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraHdf5Writer::create()
+{
+    init(new CameraHdf5Writer());
+}
+
+//###########################################################################
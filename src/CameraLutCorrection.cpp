@@ -0,0 +1,581 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraLutCorrection.cpp
+ * \brief  implementation file of the linearity correction and ADU to electrons conversion stage.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraLutCorrection.h"
+
+// SYSTEM
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <limits>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraLutCorrection::g_table_size          = 65536;
+const std::size_t CameraLutCorrection::g_max_coefficients_nb = 4    ;
+const std::size_t CameraLutCorrection::g_float_ring_size     = 8    ;
+
+/****************************************************************************************************
+ * \fn CameraLutCorrection()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraLutCorrection::CameraLutCorrection() : CameraFrameStage("LutCorrection")
+{
+    DEB_CONSTRUCTOR();
+
+    m_output = Scaled16;
+    m_gain   = 1.0     ;
+    m_scale  = 1.0     ;
+
+    // identity linearity by default
+    m_coefficients.push_back(0.0);
+    m_coefficients.push_back(1.0);
+
+    m_float_frames   .resize(g_float_ring_size);
+    m_float_frame_nbs.assign(g_float_ring_size, std::numeric_limits<std::size_t>::max());
+
+    buildTables();
+}
+
+/****************************************************************************************************
+ * \fn ~CameraLutCorrection()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraLutCorrection::~CameraLutCorrection()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn bool setPolynomial(const std::vector<double> & in_coefficients)
+ * \brief  set the linearity polynomial of the raw ADU, the table file is forgotten
+ * \param  in_coefficients 1 to 4 coefficients, constant first
+ * \return true if the coefficients are correct
+ ****************************************************************************************************/
+bool CameraLutCorrection::setPolynomial(const std::vector<double> & in_coefficients)
+{
+    DEB_MEMBER_FUNCT();
+
+    if((in_coefficients.empty()) || (in_coefficients.size() > g_max_coefficients_nb))
+    {
+        DEB_ERROR() << "CameraLutCorrection::setPolynomial - Incorrect number of coefficients: " << in_coefficients.size();
+        return false;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_coefficients = in_coefficients;
+    m_linear_table.clear();
+
+    buildTables();
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool loadTable(const std::string & in_file_name)
+ * \brief  load the linearity table of the camera: one "adu value" knot per line, with increasing
+ *         ADU. The values between the knots are interpolated, the values outside follow the
+ *         first and the last segments.
+ * \param  in_file_name complete path of the file
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraLutCorrection::loadTable(const std::string & in_file_name)
+{
+    DEB_MEMBER_FUNCT();
+
+    std::ifstream file(in_file_name.c_str());
+
+    if(!file.is_open())
+    {
+        DEB_ERROR() << "CameraLutCorrection::loadTable - Unable to open the file " << in_file_name;
+        return false;
+    }
+
+    std::vector<double> knots_adu  ;
+    std::vector<double> knots_value;
+    std::string         line;
+    std::size_t         line_nb = 0;
+
+    while(std::getline(file, line))
+    {
+        line_nb++;
+
+        if((line.empty()) || (line[0] == '#'))
+            continue;
+
+        std::istringstream line_stream(line);
+        double adu  ;
+        double value;
+
+        if((!(line_stream >> adu >> value)) || (adu < 0.0) || (adu >= static_cast<double>(g_table_size)) ||
+           ((!knots_adu.empty()) && (adu <= knots_adu.back())))
+        {
+            DEB_ERROR() << "CameraLutCorrection::loadTable - Incorrect line " << line_nb << " in the file " << in_file_name;
+            return false;
+        }
+
+        knots_adu  .push_back(adu  );
+        knots_value.push_back(value);
+    }
+
+    if(knots_adu.size() < 2)
+    {
+        DEB_ERROR() << "CameraLutCorrection::loadTable - At least two knots are needed in the file " << in_file_name;
+        return false;
+    }
+
+    std::vector<float> linear_table(g_table_size);
+    std::size_t        segment = 0;
+
+    for(std::size_t adu = 0 ; adu < g_table_size ; adu++)
+    {
+        double x = static_cast<double>(adu);
+
+        while((segment + 2 < knots_adu.size()) && (x > knots_adu[segment + 1]))
+            segment++;
+
+        double slope = (knots_value[segment + 1] - knots_value[segment]) / (knots_adu[segment + 1] - knots_adu[segment]);
+
+        linear_table[adu] = static_cast<float>(knots_value[segment] + (x - knots_adu[segment]) * slope);
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_linear_table.swap(linear_table);
+    buildTables();
+
+    DEB_TRACE() << "Linearity table loaded: " << knots_adu.size() << " knots.";
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool hasTable() const
+ * \brief  check if the linearity comes from a table file
+ * \param  none
+ * \return true for a table file, false for a polynomial
+ ****************************************************************************************************/
+bool CameraLutCorrection::hasTable() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return (!m_linear_table.empty());
+}
+
+/****************************************************************************************************
+ * \fn bool setGain(double in_gain)
+ * \brief  set the gain applied after the linearity
+ * \param  in_gain gain in e-/ADU (1 to keep linearized ADU)
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraLutCorrection::setGain(double in_gain)
+{
+    if(in_gain <= 0.0)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_gain = in_gain;
+    buildTables();
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn double getGain() const
+ * \brief  get the gain applied after the linearity
+ * \param  none
+ * \return gain in e-/ADU
+ ****************************************************************************************************/
+double CameraLutCorrection::getGain() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_gain;
+}
+
+/****************************************************************************************************
+ * \fn void setOutput(Output in_output)
+ * \brief  set the output of the corrected values (applied at the next acquisition)
+ * \param  in_output new output
+ * \return none
+ ****************************************************************************************************/
+void CameraLutCorrection::setOutput(Output in_output)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_output = in_output;
+}
+
+/****************************************************************************************************
+ * \fn Output getOutput() const
+ * \brief  get the output of the corrected values
+ * \param  none
+ * \return current output
+ ****************************************************************************************************/
+CameraLutCorrection::Output CameraLutCorrection::getOutput() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_output;
+}
+
+/****************************************************************************************************
+ * \fn bool setScale(double in_scale)
+ * \brief  set the scale of the 16 bits output (the scaled values are clamped to 0..65535)
+ * \param  in_scale output units per corrected unit
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraLutCorrection::setScale(double in_scale)
+{
+    if(in_scale <= 0.0)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_scale = in_scale;
+    buildTables();
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn double getScale() const
+ * \brief  get the scale of the 16 bits output
+ * \param  none
+ * \return output units per corrected unit
+ ****************************************************************************************************/
+double CameraLutCorrection::getScale() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_scale;
+}
+
+/****************************************************************************************************
+ * \fn bool getFloatFrame(std::size_t in_frame_nb, std::vector<float> & out_frame) const
+ * \brief  get a copy of a float frame of the current acquisition (32 bits output only)
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  out_frame corrected values of the frame
+ * \return true if the frame is still in the ring buffer
+ ****************************************************************************************************/
+bool CameraLutCorrection::getFloatFrame(std::size_t in_frame_nb, std::vector<float> & out_frame) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    std::size_t slot = in_frame_nb % g_float_ring_size;
+
+    if(m_float_frame_nbs[slot] != in_frame_nb)
+        return false;
+
+    out_frame = m_float_frames[slot];
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition. The float frames are allocated now, so the
+ *         reception never waits for a memory allocation.
+ * \param  in_format format of the frames
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraLutCorrection::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(in_format.m_pixel_depth > 16)
+    {
+        DEB_ERROR() << "CameraLutCorrection::prepareAcq - Incorrect pixel depth: " << in_format.m_pixel_depth;
+        return false;
+    }
+
+    m_float_frame_nbs.assign(g_float_ring_size, std::numeric_limits<std::size_t>::max());
+
+    std::size_t pixels_nb = ((isEnabled()) && (m_output == Float32)) ? in_format.m_width * in_format.m_height : 0;
+
+    for(std::size_t slot = 0 ; slot < g_float_ring_size ; slot++)
+    {
+        m_float_frames[slot].resize(pixels_nb);
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  correct a complete frame (called by the acquisition thread)
+ * \param  in_out_frame frame to correct
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraLutCorrection::process(CameraFrame & in_out_frame)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    std::size_t pixels_nb = in_out_frame.m_width * in_out_frame.m_height;
+
+    if(m_output == Scaled16)
+    {
+        correctScaled(in_out_frame.m_data, pixels_nb);
+    }
+    else
+    {
+        std::size_t slot = in_out_frame.m_frame_nb % g_float_ring_size;
+
+        // no allocation when the output did not change since the preparation
+        m_float_frames[slot].resize(pixels_nb);
+
+        correctFloat(in_out_frame.m_data, m_float_frames[slot].data(), pixels_nb);
+        m_float_frame_nbs[slot] = in_out_frame.m_frame_nb;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void buildTables()
+ * \brief  build the tables and the polynomial coefficients used by the frames
+ *         (the stage lock is already taken)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraLutCorrection::buildTables()
+{
+    m_float_table .resize(g_table_size);
+    m_scaled_table.resize(g_table_size);
+
+    for(std::size_t adu = 0 ; adu < g_table_size ; adu++)
+    {
+        double linear = 0.0;
+
+        if(!m_linear_table.empty())
+        {
+            linear = static_cast<double>(m_linear_table[adu]);
+        }
+        else
+        {
+            // Horner evaluation, highest degree first
+            for(std::size_t index = m_coefficients.size() ; index > 0 ; index--)
+                linear = linear * static_cast<double>(adu) + m_coefficients[index - 1];
+        }
+
+        double value  = linear * m_gain;
+        double scaled = std::min(std::max(value * m_scale, 0.0), 65535.0);
+
+        m_float_table [adu] = static_cast<float   >(value        );
+        m_scaled_table[adu] = static_cast<uint16_t>(scaled + 0.5 );
+    }
+
+    for(std::size_t index = 0 ; index < g_max_coefficients_nb ; index++)
+    {
+        double coefficient = (index < m_coefficients.size()) ? m_coefficients[index] * m_gain : 0.0;
+
+        m_float_coefficients [index] = static_cast<float>(coefficient          );
+        m_scaled_coefficients[index] = static_cast<float>(coefficient * m_scale);
+    }
+}
+
+/****************************************************************************************************
+ * \fn float evaluatePolynomial(const float * in_coefficients, float in_x)
+ * \brief  evaluate the polynomial of a pixel in float, with the operations order of the SSE2
+ *         path, so the pixels out of the eight pixels blocks get the same values
+ * \param  in_coefficients polynomial coefficients (lowest degree first)
+ * \param  in_x pixel value
+ * \return polynomial value
+ ****************************************************************************************************/
+float CameraLutCorrection::evaluatePolynomial(const float * in_coefficients, float in_x)
+{
+    float value = in_coefficients[3];
+
+    value = value * in_x + in_coefficients[2];
+    value = value * in_x + in_coefficients[1];
+    value = value * in_x + in_coefficients[0];
+
+    return value;
+}
+
+/****************************************************************************************************
+ * \fn void correctScaled(uint16_t * in_out_data, std::size_t in_pixels_nb) const
+ * \brief  write the corrected values of a frame into the frame (16 bits output).
+ *         With a polynomial and SSE2, eight pixels are converted to float, evaluated, clamped,
+ *         rounded and packed back without table access. SSE2 has only a signed 32 to 16 bits
+ *         pack, so the values are moved by 32768 around it. The last pixels are evaluated
+ *         in float the same way, so every pixel of the frame gets the same correction.
+ * \param  in_out_data pixels of the frame
+ * \param  in_pixels_nb number of pixels
+ * \return none
+ ****************************************************************************************************/
+void CameraLutCorrection::correctScaled(uint16_t * in_out_data, std::size_t in_pixels_nb) const
+{
+    std::size_t index = 0;
+
+#if defined(__SSE2__)
+    if(m_linear_table.empty())
+    {
+        const __m128  c0        = _mm_set1_ps(m_scaled_coefficients[0]);
+        const __m128  c1        = _mm_set1_ps(m_scaled_coefficients[1]);
+        const __m128  c2        = _mm_set1_ps(m_scaled_coefficients[2]);
+        const __m128  c3        = _mm_set1_ps(m_scaled_coefficients[3]);
+        const __m128  min_value = _mm_setzero_ps();
+        const __m128  max_value = _mm_set1_ps(65535.0f);
+        const __m128  half      = _mm_set1_ps(0.5f);
+        const __m128i zero      = _mm_setzero_si128();
+        const __m128i offset    = _mm_set1_epi32(32768);
+        const __m128i sign      = _mm_set1_epi16(static_cast<short>(0x8000));
+
+        for( ; index + 8 <= in_pixels_nb ; index += 8)
+        {
+            __m128i pixels    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_out_data + index));
+            __m128  values[2] = { _mm_cvtepi32_ps(_mm_unpacklo_epi16(pixels, zero)),
+                                  _mm_cvtepi32_ps(_mm_unpackhi_epi16(pixels, zero)) };
+            __m128i results[2];
+
+            for(std::size_t half_index = 0 ; half_index < 2 ; half_index++)
+            {
+                __m128 x     = values[half_index];
+                __m128 value = _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3, x), c2), x), c1), x), c0);
+
+                value = _mm_min_ps(_mm_max_ps(value, min_value), max_value);
+
+                results[half_index] = _mm_sub_epi32(_mm_cvttps_epi32(_mm_add_ps(value, half)), offset);
+            }
+
+            _mm_storeu_si128(reinterpret_cast<__m128i *>(in_out_data + index),
+                             _mm_xor_si128(_mm_packs_epi32(results[0], results[1]), sign));
+        }
+
+        for( ; index < in_pixels_nb ; index++)
+        {
+            float value = evaluatePolynomial(m_scaled_coefficients, static_cast<float>(in_out_data[index]));
+
+            value = std::min(std::max(value, 0.0f), 65535.0f);
+
+            in_out_data[index] = static_cast<uint16_t>(static_cast<int32_t>(value + 0.5f));
+        }
+    }
+#endif
+
+    const uint16_t * table = m_scaled_table.data();
+
+    for( ; index < in_pixels_nb ; index++)
+    {
+        in_out_data[index] = table[in_out_data[index]];
+    }
+}
+
+/****************************************************************************************************
+ * \fn void correctFloat(const uint16_t * in_data, float * out_data, std::size_t in_pixels_nb) const
+ * \brief  write the corrected values of a frame into a float frame (32 bits output).
+ *         With a polynomial and SSE2, eight pixels are evaluated at once without table access
+ *         and the last pixels are evaluated in float the same way.
+ * \param  in_data pixels of the frame
+ * \param  out_data corrected values
+ * \param  in_pixels_nb number of pixels
+ * \return none
+ ****************************************************************************************************/
+void CameraLutCorrection::correctFloat(const uint16_t * in_data, float * out_data, std::size_t in_pixels_nb) const
+{
+    std::size_t index = 0;
+
+#if defined(__SSE2__)
+    if(m_linear_table.empty())
+    {
+        const __m128  c0   = _mm_set1_ps(m_float_coefficients[0]);
+        const __m128  c1   = _mm_set1_ps(m_float_coefficients[1]);
+        const __m128  c2   = _mm_set1_ps(m_float_coefficients[2]);
+        const __m128  c3   = _mm_set1_ps(m_float_coefficients[3]);
+        const __m128i zero = _mm_setzero_si128();
+
+        for( ; index + 8 <= in_pixels_nb ; index += 8)
+        {
+            __m128i pixels    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_data + index));
+            __m128  values[2] = { _mm_cvtepi32_ps(_mm_unpacklo_epi16(pixels, zero)),
+                                  _mm_cvtepi32_ps(_mm_unpackhi_epi16(pixels, zero)) };
+
+            for(std::size_t half_index = 0 ; half_index < 2 ; half_index++)
+            {
+                __m128 x = values[half_index];
+
+                _mm_storeu_ps(out_data + index + half_index * 4,
+                              _mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(_mm_add_ps(_mm_mul_ps(c3, x), c2), x), c1), x), c0));
+            }
+        }
+
+        for( ; index < in_pixels_nb ; index++)
+        {
+            out_data[index] = evaluatePolynomial(m_float_coefficients, static_cast<float>(in_data[index]));
+        }
+    }
+#endif
+
+    const float * table = m_float_table.data();
+
+    for( ; index < in_pixels_nb ; index++)
+    {
+        out_data[index] = table[in_data[index]];
+    }
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraLutCorrection::create()
+{
+    init(new CameraLutCorrection());
+}
+
+//###########################################################################
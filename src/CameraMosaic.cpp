@@ -0,0 +1,752 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraMosaic.cpp
+ * \brief  implementation file of the mosaic stage (assembly of several detectors frames in shared memory).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraMosaic.h"
+#include "NetPackets.h"
+
+// SYSTEM
+#include <cstring>
+#include <cerrno>
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+
+// LIMA
+#include "lima/SizeUtils.h"
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const uint32_t    CameraMosaic::g_magic            = 0x53494D4F; // "SIMO"
+const uint32_t    CameraMosaic::g_version          = 2 ;
+const std::size_t CameraMosaic::g_tiles_max        = 16;
+const uint64_t    CameraMosaic::g_tag_mask         = 0xFFFFFFFFFFFF0000ULL;
+const std::size_t CameraMosaic::g_alignment        = 64;
+const std::string CameraMosaic::g_default_shm_name = "/spectral_instrument_mosaic";
+
+/****************************************************************************************************
+ * \fn CameraMosaic()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraMosaic::CameraMosaic() : CameraFrameStage("Mosaic")
+{
+    DEB_CONSTRUCTOR();
+
+    m_shm_name       = g_default_shm_name;
+    m_width          = 0    ;
+    m_height         = 0    ;
+    m_slots_nb       = 0    ;
+    m_tile_index     = 0    ;
+    m_tile_width     = 0    ;
+    m_tile_height    = 0    ;
+    m_claimed_frame  = -1   ;
+    m_late_frame     = -1   ;
+    m_late_frames_nb = 0    ;
+    m_epoch          = 0    ;
+    m_shm_data       = NULL ;
+    m_shm_size       = 0    ;
+    m_ready          = false;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraMosaic()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraMosaic::~CameraMosaic()
+{
+    DEB_DESTRUCTOR();
+
+    closeSharedMemory();
+}
+
+//==================================================================================================
+// configuration
+//==================================================================================================
+/****************************************************************************************************
+ * \fn bool loadGeometry(const std::string & in_file_name)
+ * \brief  load the mosaic geometry from a text file. The file contains one line
+ *         "mosaic <width> <height> <tiles nb> <slots nb>" followed by one line
+ *         "tile <index> <x> <y> <orientation>" for each tile. The orientation
+ *         uses the names of the Orientation attribute (NORMAL, ROTATE_90...).
+ *         Empty lines and lines starting with a '#' are ignored.
+ * \param  in_file_name complete path of the file
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraMosaic::loadGeometry(const std::string & in_file_name)
+{
+    DEB_MEMBER_FUNCT();
+
+    std::ifstream file(in_file_name.c_str());
+
+    if(!file.is_open())
+    {
+        DEB_ERROR() << "CameraMosaic::loadGeometry - Unable to open the file " << in_file_name;
+        return false;
+    }
+
+    std::size_t                   width    = 0;
+    std::size_t                   height   = 0;
+    std::size_t                   slots_nb = 0;
+    std::vector<CameraMosaicTile> tiles   ;
+    std::vector<bool>             defined ;
+    std::string                   line    ;
+    std::size_t                   line_nb  = 0;
+
+    while(std::getline(file, line))
+    {
+        line_nb++;
+
+        if((line.empty()) || (line[0] == '#'))
+            continue;
+
+        std::istringstream line_stream(line);
+        std::string        keyword;
+        bool               valid = false;
+
+        line_stream >> keyword;
+
+        if(keyword == "mosaic")
+        {
+            std::size_t tiles_nb = 0;
+
+            valid = ((line_stream >> width >> height >> tiles_nb >> slots_nb) &&
+                     (width > 0) && (height > 0) && (tiles_nb > 0) && (tiles_nb <= g_tiles_max) && (slots_nb > 0));
+
+            if(valid)
+            {
+                CameraMosaicTile tile;
+                tile.m_x           = 0;
+                tile.m_y           = 0;
+                tile.m_orientation = CameraFrameTransform::Normal;
+
+                tiles.assign(tiles_nb, tile);
+                defined.assign(tiles_nb, false);
+            }
+        }
+        else
+        if(keyword == "tile")
+        {
+            std::size_t tile_index;
+            std::size_t x;
+            std::size_t y;
+            std::string orientation;
+
+            valid = ((line_stream >> tile_index >> x >> y >> orientation) && (tile_index < tiles.size()));
+
+            if(valid)
+            {
+                valid = CameraFrameTransform::fromString(orientation, tiles[tile_index].m_orientation);
+
+                tiles  [tile_index].m_x = x;
+                tiles  [tile_index].m_y = y;
+                defined[tile_index]     = true;
+            }
+        }
+
+        if(!valid)
+        {
+            DEB_ERROR() << "CameraMosaic::loadGeometry - Incorrect line " << line_nb << " in the file " << in_file_name;
+            return false;
+        }
+    }
+
+    if((tiles.empty()) || (std::find(defined.begin(), defined.end(), false) != defined.end()))
+    {
+        DEB_ERROR() << "CameraMosaic::loadGeometry - Incomplete geometry in the file " << in_file_name;
+        return false;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_width    = width   ;
+    m_height   = height  ;
+    m_slots_nb = slots_nb;
+    m_tiles.swap(tiles);
+
+    DEB_TRACE() << "Mosaic geometry loaded: " << m_width << "x" << m_height << " pixels, "
+                << m_tiles.size() << " tiles, " << m_slots_nb << " slots.";
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool setTileIndex(std::size_t in_tile_index)
+ * \brief  set the index of the tile filled by this process
+ * \param  in_tile_index tile index in the geometry file
+ * \return true if succeed, false if the tile is unknown
+ ****************************************************************************************************/
+bool CameraMosaic::setTileIndex(std::size_t in_tile_index)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(in_tile_index >= m_tiles.size())
+    {
+        DEB_ERROR() << "CameraMosaic::setTileIndex - Unknown tile " << in_tile_index << " (" << m_tiles.size() << " tiles)";
+        return false;
+    }
+
+    m_tile_index = in_tile_index;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getTileIndex() const
+ * \brief  get the index of the tile filled by this process
+ * \param  none
+ * \return tile index
+ ****************************************************************************************************/
+std::size_t CameraMosaic::getTileIndex() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_tile_index;
+}
+
+/****************************************************************************************************
+ * \fn void setSharedMemoryName(const std::string & in_name)
+ * \brief  set the name of the shared memory (used at the next acquisition start)
+ * \param  in_name POSIX shared memory name (starting with a '/')
+ * \return none
+ ****************************************************************************************************/
+void CameraMosaic::setSharedMemoryName(const std::string & in_name)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_shm_name = in_name;
+}
+
+/****************************************************************************************************
+ * \fn std::string getSharedMemoryName() const
+ * \brief  get the name of the shared memory
+ * \param  none
+ * \return POSIX shared memory name
+ ****************************************************************************************************/
+std::string CameraMosaic::getSharedMemoryName() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_shm_name;
+}
+
+/****************************************************************************************************
+ * \fn void getMosaicSize(std::size_t & out_width, std::size_t & out_height) const
+ * \brief  get the mosaic size
+ * \param  out_width mosaic width in pixels
+ * \param  out_height mosaic height in pixels
+ * \return none
+ ****************************************************************************************************/
+void CameraMosaic::getMosaicSize(std::size_t & out_width, std::size_t & out_height) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    out_width  = m_width ;
+    out_height = m_height;
+}
+
+//==================================================================================================
+// shared memory management
+//==================================================================================================
+/****************************************************************************************************
+ * \fn bool openSharedMemory()
+ * \brief  map the shared memory and check or initialize its header.
+ *         The first process creates the shared memory, the next ones check that
+ *         they use the same geometry.
+ * \param  none
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraMosaic::openSharedMemory()
+{
+    DEB_MEMBER_FUNCT();
+
+    closeSharedMemory();
+
+    std::size_t states_offset = ((sizeof(CameraMosaicHeader) + g_alignment - 1) / g_alignment) * g_alignment;
+    std::size_t data_offset   = ((states_offset + m_slots_nb * sizeof(uint64_t) + g_alignment - 1) / g_alignment) * g_alignment;
+    std::size_t size          = data_offset + m_slots_nb * m_width * m_height * sizeof(uint16_t);
+
+    int descriptor = shm_open(m_shm_name.c_str(), O_RDWR | O_CREAT, 0666);
+
+    if(descriptor < 0)
+    {
+        DEB_ERROR() << "CameraMosaic::openSharedMemory - Unable to open the shared memory " << m_shm_name << " (" << strerror(errno) << ")";
+        return false;
+    }
+
+    struct stat status;
+
+    // a new shared memory is filled with zeros
+    if((fstat(descriptor, &status) < 0) ||
+       ((static_cast<std::size_t>(status.st_size) < size) && (ftruncate(descriptor, size) < 0)))
+    {
+        DEB_ERROR() << "CameraMosaic::openSharedMemory - Unable to size the shared memory " << m_shm_name << " (" << strerror(errno) << ")";
+        close(descriptor);
+        return false;
+    }
+
+    void * data = mmap(NULL, size, PROT_READ | PROT_WRITE, MAP_SHARED, descriptor, 0);
+    close(descriptor);
+
+    if(data == MAP_FAILED)
+    {
+        DEB_ERROR() << "CameraMosaic::openSharedMemory - Unable to map the shared memory " << m_shm_name << " (" << strerror(errno) << ")";
+        return false;
+    }
+
+    m_shm_data = static_cast<uint8_t *>(data);
+    m_shm_size = size;
+
+    CameraMosaicHeader * header = reinterpret_cast<CameraMosaicHeader *>(m_shm_data);
+
+    // all the processes use the same geometry, so they write the same values
+    if(header->m_magic == 0)
+    {
+        header->m_version             = g_version;
+        header->m_width               = static_cast<uint32_t>(m_width       );
+        header->m_height              = static_cast<uint32_t>(m_height      );
+        header->m_tiles_nb            = static_cast<uint32_t>(m_tiles.size());
+        header->m_slots_nb            = static_cast<uint32_t>(m_slots_nb    );
+        header->m_states_offset       = states_offset;
+        header->m_data_offset         = data_offset  ;
+        header->m_acquisition         = 0 ;
+        header->m_complete_frames_nb  = 0 ;
+        header->m_last_complete_frame = -1;
+
+        __sync_synchronize();
+        header->m_magic = g_magic;
+    }
+
+    if((header->m_magic    != g_magic                              ) ||
+       (header->m_version  != g_version                            ) ||
+       (header->m_width    != static_cast<uint32_t>(m_width       )) ||
+       (header->m_height   != static_cast<uint32_t>(m_height      )) ||
+       (header->m_tiles_nb != static_cast<uint32_t>(m_tiles.size())) ||
+       (header->m_slots_nb != static_cast<uint32_t>(m_slots_nb    )))
+    {
+        DEB_ERROR() << "CameraMosaic::openSharedMemory - The shared memory " << m_shm_name << " uses another geometry!";
+        closeSharedMemory();
+        return false;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void closeSharedMemory()
+ * \brief  unmap the shared memory (the shared memory is kept for the other processes)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraMosaic::closeSharedMemory()
+{
+    if(m_shm_data != NULL)
+    {
+        munmap(m_shm_data, m_shm_size);
+        m_shm_data = NULL;
+        m_shm_size = 0   ;
+    }
+}
+
+/****************************************************************************************************
+ * \fn void joinAcquisition()
+ * \brief  join the acquisition epoch of the other tiles or open a new one (the shared memory
+ *         must be mapped). A tile which already joined the current epoch starts a new
+ *         acquisition: it opens the next epoch and resets the complete frames counters.
+ *         So all the processes should start each acquisition of the mosaic.
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraMosaic::joinAcquisition()
+{
+    DEB_MEMBER_FUNCT();
+
+    CameraMosaicHeader * header   = reinterpret_cast<CameraMosaicHeader *>(m_shm_data);
+    uint64_t             tile_bit = 1ULL << m_tile_index;
+
+    for(;;)
+    {
+        uint64_t current = header->m_acquisition;
+        bool     opened  = ((current & tile_bit) != 0);
+        uint64_t next    = (opened) ? ((((current >> 32) + 1ULL) << 32) | tile_bit) : (current | tile_bit);
+
+        if(__sync_bool_compare_and_swap(&header->m_acquisition, current, next))
+        {
+            m_epoch = static_cast<uint32_t>(next >> 32);
+
+            if(opened)
+            {
+                header->m_complete_frames_nb  = 0 ;
+                header->m_last_complete_frame = -1;
+            }
+
+            DEB_TRACE() << "Mosaic acquisition epoch " << m_epoch << ((opened) ? " opened" : " joined") << " by the tile " << m_tile_index;
+            break;
+        }
+    }
+}
+
+/****************************************************************************************************
+ * \fn uint64_t getSlotTag(std::size_t in_frame_nb) const
+ * \brief  get the tag of a frame in the slots states: the low 16 bits of the acquisition
+ *         epoch, then the frame number + 1 (32 bits), the tiles mask bits are left at 0
+ * \param  in_frame_nb frame number in the acquisition
+ * \return slot tag
+ ****************************************************************************************************/
+uint64_t CameraMosaic::getSlotTag(std::size_t in_frame_nb) const
+{
+    return ((static_cast<uint64_t>(m_epoch) & 0xFFFFULL) << 48) |
+           ((static_cast<uint64_t>(in_frame_nb + 1) & 0xFFFFFFFFULL) << 16);
+}
+
+/****************************************************************************************************
+ * \fn volatile uint64_t * getSlotState(std::size_t in_slot) const
+ * \brief  get the state of a slot
+ * \param  in_slot slot index
+ * \return slot state address
+ ****************************************************************************************************/
+volatile uint64_t * CameraMosaic::getSlotState(std::size_t in_slot) const
+{
+    const CameraMosaicHeader * header = reinterpret_cast<const CameraMosaicHeader *>(m_shm_data);
+    return reinterpret_cast<volatile uint64_t *>(m_shm_data + header->m_states_offset) + in_slot;
+}
+
+/****************************************************************************************************
+ * \fn uint16_t * getSlotData(std::size_t in_slot) const
+ * \brief  get the pixels of a slot
+ * \param  in_slot slot index
+ * \return first pixel of the slot
+ ****************************************************************************************************/
+uint16_t * CameraMosaic::getSlotData(std::size_t in_slot) const
+{
+    const CameraMosaicHeader * header = reinterpret_cast<const CameraMosaicHeader *>(m_shm_data);
+    return reinterpret_cast<uint16_t *>(m_shm_data + header->m_data_offset) + in_slot * m_width * m_height;
+}
+
+//==================================================================================================
+// mosaic frames access
+//==================================================================================================
+/****************************************************************************************************
+ * \fn bool getCompleteFrames(uint64_t & out_complete_frames_nb, int64_t & out_last_complete_frame) const
+ * \brief  get the number of complete mosaic frames and the latest complete frame number
+ * \param  out_complete_frames_nb number of complete mosaic frames
+ * \param  out_last_complete_frame latest complete frame number (-1 if none)
+ * \return true if succeed, false if the shared memory is not mapped
+ ****************************************************************************************************/
+bool CameraMosaic::getCompleteFrames(uint64_t & out_complete_frames_nb, int64_t & out_last_complete_frame) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(m_shm_data == NULL)
+        return false;
+
+    const CameraMosaicHeader * header = reinterpret_cast<const CameraMosaicHeader *>(m_shm_data);
+
+    out_complete_frames_nb  = header->m_complete_frames_nb ;
+    out_last_complete_frame = header->m_last_complete_frame;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getLateFrames() const
+ * \brief  get the number of frames of this tile not published in the current acquisition
+ *         because their slot was claimed by a newer frame (this detector is late)
+ * \param  none
+ * \return number of late frames
+ ****************************************************************************************************/
+std::size_t CameraMosaic::getLateFrames() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    return m_late_frames_nb;
+}
+
+/****************************************************************************************************
+ * \fn bool readFrame(std::size_t in_frame_nb, std::vector<uint16_t> & out_pixels) const
+ * \brief  copy a complete mosaic frame of the current acquisition. The slot state is checked
+ *         again after the copy to detect a frame overwritten by a newer frame during the copy.
+ * \param  in_frame_nb frame number
+ * \param  out_pixels mosaic pixels
+ * \return true if succeed, false if the frame is not complete or not anymore in the ring buffer
+ ****************************************************************************************************/
+bool CameraMosaic::readFrame(std::size_t in_frame_nb, std::vector<uint16_t> & out_pixels) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if((m_shm_data == NULL) || (m_slots_nb == 0))
+        return false;
+
+    std::size_t         slot     = in_frame_nb % m_slots_nb;
+    volatile uint64_t * state    = getSlotState(slot);
+    uint64_t            complete = getSlotTag(in_frame_nb) | ((1ULL << m_tiles.size()) - 1ULL);
+
+    if(*state != complete)
+        return false;
+
+    __sync_synchronize();
+
+    out_pixels.resize(m_width * m_height);
+    memcpy(out_pixels.data(), getSlotData(slot), out_pixels.size() * sizeof(uint16_t));
+
+    __sync_synchronize();
+
+    return (*state == complete);
+}
+
+//==================================================================================================
+// acquisition management
+//==================================================================================================
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition
+ * \param  in_format format of the frames of the next acquisition
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraMosaic::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_ready          = false;
+    m_claimed_frame  = -1   ;
+    m_late_frame     = -1   ;
+    m_late_frames_nb = 0    ;
+
+    if(!isEnabled())
+        return true;
+
+    if(m_tiles.empty())
+    {
+        DEB_ERROR() << "CameraMosaic::prepareAcq - No mosaic geometry was loaded!";
+        return false;
+    }
+
+    if(m_tile_index >= m_tiles.size())
+    {
+        DEB_ERROR() << "CameraMosaic::prepareAcq - Unknown tile " << m_tile_index << " (" << m_tiles.size() << " tiles)";
+        return false;
+    }
+
+    // the tile contains the image sent by the detector, without the orientation of the Lima frame
+    CameraFrameTransform frame_transform(in_format.m_orientation);
+    std::size_t          source_width  = (frame_transform.swapsAxes()) ? in_format.m_height : in_format.m_width ;
+    std::size_t          source_height = (frame_transform.swapsAxes()) ? in_format.m_width  : in_format.m_height;
+
+    const CameraMosaicTile & tile = m_tiles[m_tile_index];
+    CameraFrameTransform(tile.m_orientation).getDestinationSize(source_width, source_height, m_tile_width, m_tile_height);
+
+    if((tile.m_x + m_tile_width > m_width) || (tile.m_y + m_tile_height > m_height))
+    {
+        DEB_ERROR() << "CameraMosaic::prepareAcq - The tile " << m_tile_index << " (" << m_tile_width << "x" << m_tile_height
+                    << " at " << tile.m_x << "," << tile.m_y << ") is outside the mosaic " << m_width << "x" << m_height;
+        return false;
+    }
+
+    if(!openSharedMemory())
+        return false;
+
+    joinAcquisition();
+
+    m_ready = true;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool copyPart(const NetImage & in_image, std::size_t in_frame_nb)
+ * \brief  copy an image part into the tile of the mosaic (called by the acquisition thread
+ *         or by the decoding threads). The first part of a frame claims its slot in the ring
+ *         buffer: the tiles mask is cleared if the slot still contains an older frame (or a
+ *         frame of an older acquisition). The tags are increasing, so a slot already claimed
+ *         by a newer frame is not taken back: the parts of the late frame are not copied.
+ *         Only the claim is protected, each part writes its own region of the slot.
+ * \param  in_image image part
+ * \param  in_frame_nb frame number in the acquisition
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraMosaic::copyPart(const NetImage & in_image, std::size_t in_frame_nb)
+{
+    DEB_MEMBER_FUNCT();
+
+    uint16_t             * destination = NULL;
+    std::size_t            stride      = 0   ;
+    lima::FrameDim         tile_dim          ;
+    CameraFrameTransform   tile_transform    ;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        if(!m_ready)
+            return true;
+
+        // the slot of this frame was claimed by a newer frame
+        if(m_late_frame == static_cast<int64_t>(in_frame_nb))
+            return true;
+
+        std::size_t slot = in_frame_nb % m_slots_nb;
+
+        if(m_claimed_frame != static_cast<int64_t>(in_frame_nb))
+        {
+            volatile uint64_t * state  = getSlotState(slot);
+            uint64_t            frame  = getSlotTag(in_frame_nb);
+
+            for(;;)
+            {
+                uint64_t current = *state;
+
+                // the frame was already claimed by another tile
+                if((current & g_tag_mask) == frame)
+                    break;
+
+                // the slot was claimed by a newer frame or a newer acquisition: this detector is late
+                if((current & g_tag_mask) > frame)
+                {
+                    DEB_TRACE() << "Mosaic slot claimed by a newer frame before the frame " << in_frame_nb;
+
+                    m_late_frame = static_cast<int64_t>(in_frame_nb);
+                    m_late_frames_nb++;
+                    return true;
+                }
+
+                if(__sync_bool_compare_and_swap(state, current, frame))
+                    break;
+            }
+
+            m_claimed_frame = static_cast<int64_t>(in_frame_nb);
+        }
+
+        const CameraMosaicTile & tile = m_tiles[m_tile_index];
+
+        tile_dim       = lima::FrameDim(Size(static_cast<int>(m_tile_width), static_cast<int>(m_tile_height)), Bpp16);
+        tile_transform = CameraFrameTransform(tile.m_orientation);
+        destination    = getSlotData(slot) + tile.m_y * m_width + tile.m_x;
+        stride         = m_width;
+    }
+
+    if(!in_image.copy(destination, stride, tile_dim, tile_transform))
+    {
+        DEB_ERROR() << "CameraMosaic::copyPart - Unable to copy an image part of the frame " << in_frame_nb;
+        return false;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  publish the tile of a complete frame. The tile which completes the mask
+ *         updates the complete frames counters of the shared memory.
+ * \param  in_out_frame frame to treat
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraMosaic::process(CameraFrame & in_out_frame)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(!m_ready)
+        return true;
+
+    volatile uint64_t * state     = getSlotState(in_out_frame.m_frame_nb % m_slots_nb);
+    uint64_t            frame     = getSlotTag(in_out_frame.m_frame_nb);
+    uint64_t            tile_bit  = 1ULL << m_tile_index;
+    uint64_t            full_mask = (1ULL << m_tiles.size()) - 1ULL;
+
+    for(;;)
+    {
+        uint64_t current = *state;
+
+        // the slot was claimed by a newer frame or a newer acquisition: this detector is late
+        if((current & g_tag_mask) != frame)
+        {
+            DEB_TRACE() << "Mosaic slot overwritten before the end of the frame " << in_out_frame.m_frame_nb;
+
+            // the late frames found during the copy of the parts are already counted
+            if(m_late_frame != static_cast<int64_t>(in_out_frame.m_frame_nb))
+                m_late_frames_nb++;
+            break;
+        }
+
+        // the compare and swap is a full barrier: the pixels are visible before the tile bit
+        if(__sync_bool_compare_and_swap(state, current, current | tile_bit))
+        {
+            CameraMosaicHeader * header = reinterpret_cast<CameraMosaicHeader *>(m_shm_data);
+
+            // the counters of a newer acquisition are not updated
+            if((((current | tile_bit) & full_mask) == full_mask) &&
+               (static_cast<uint32_t>(header->m_acquisition >> 32) == m_epoch))
+            {
+                header->m_last_complete_frame = static_cast<int64_t>(in_out_frame.m_frame_nb);
+                __sync_fetch_and_add(&header->m_complete_frames_nb, 1);
+            }
+            break;
+        }
+    }
+
+    return true;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraMosaic::create()
+{
+    init(new CameraMosaic());
+}
+
+//###########################################################################
@@ -0,0 +1,340 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraPacketDelayController.cpp
+ * \brief  implementation file of the closed-loop controller of the delay between two image packets.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraPacketDelayController.h"
+
+// SYSTEM
+#include <cstring>
+#include <algorithm>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const uint16_t    CameraPacketDelayController::g_delay_decrease_usec = 2   ;
+const uint16_t    CameraPacketDelayController::g_delay_increase_usec = 8   ;
+const double      CameraPacketDelayController::g_min_rate_gain       = 0.02;
+const std::size_t CameraPacketDelayController::g_hold_frames_nb      = 16  ;
+
+/****************************************************************************************************
+ * \fn CameraPacketDelayController()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraPacketDelayController::CameraPacketDelayController()
+{
+    DEB_CONSTRUCTOR();
+
+    m_enabled            = false;
+    m_pixels_per_packet  = 0    ;
+    m_initial_delay_usec = 0    ;
+    m_current_delay_usec = 0    ;
+    m_min_delay_usec     = 0    ;
+    m_max_delay_usec     = 1000 ;
+    m_queue_ratio        = 0.5  ;
+    m_lag_sec            = 0.010;
+    m_probe_rate         = 0.0  ;
+    m_hold_frames_nb     = 0    ;
+
+    memset(&m_last_measures, 0, sizeof(CameraPacketDelayMeasures));
+}
+
+/****************************************************************************************************
+ * \fn ~CameraPacketDelayController()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraPacketDelayController::~CameraPacketDelayController()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex controllerLock() const
+ * \brief  creates an autolock mutex for the controller data access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraPacketDelayController::controllerLock() const
+{
+    return lima::AutoMutex(m_controller_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn void setInitialSettings(uint16_t in_pixels_per_packet, uint16_t in_packet_delay_usec)
+ * \brief  set the packets settings given at the camera start
+ * \param  in_pixels_per_packet pixels per packet
+ * \param  in_packet_delay_usec packet sending loop delay in microseconds
+ * \return none
+ ****************************************************************************************************/
+void CameraPacketDelayController::setInitialSettings(uint16_t in_pixels_per_packet, uint16_t in_packet_delay_usec)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    m_pixels_per_packet  = in_pixels_per_packet;
+    m_initial_delay_usec = in_packet_delay_usec;
+    m_current_delay_usec = in_packet_delay_usec;
+    m_probe_rate         = 0.0;
+    m_hold_frames_nb     = 0  ;
+}
+
+/****************************************************************************************************
+ * \fn void setEnabled(bool in_enabled)
+ * \brief  enable or disable the controller. When disabled, the initial delay is restored
+ *         after the next frame.
+ * \param  in_enabled true to adapt the delay during the acquisition
+ * \return none
+ ****************************************************************************************************/
+void CameraPacketDelayController::setEnabled(bool in_enabled)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    m_enabled        = in_enabled;
+    m_probe_rate     = 0.0;
+    m_hold_frames_nb = 0  ;
+}
+
+/****************************************************************************************************
+ * \fn bool isEnabled() const
+ * \brief  check if the controller is enabled
+ * \param  none
+ * \return true if the delay is adapted during the acquisition
+ ****************************************************************************************************/
+bool CameraPacketDelayController::isEnabled() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    return m_enabled;
+}
+
+/****************************************************************************************************
+ * \fn bool setDelayRange(uint16_t in_min_delay_usec, uint16_t in_max_delay_usec)
+ * \brief  set the delay range in microseconds
+ * \param  in_min_delay_usec minimum delay
+ * \param  in_max_delay_usec maximum delay
+ * \return true if succeed, false if the range is incorrect
+ ****************************************************************************************************/
+bool CameraPacketDelayController::setDelayRange(uint16_t in_min_delay_usec, uint16_t in_max_delay_usec)
+{
+    if(in_min_delay_usec > in_max_delay_usec)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    m_min_delay_usec = in_min_delay_usec;
+    m_max_delay_usec = in_max_delay_usec;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void getDelayRange(uint16_t & out_min_delay_usec, uint16_t & out_max_delay_usec) const
+ * \brief  get the delay range in microseconds
+ * \param  out_min_delay_usec minimum delay
+ * \param  out_max_delay_usec maximum delay
+ * \return none
+ ****************************************************************************************************/
+void CameraPacketDelayController::getDelayRange(uint16_t & out_min_delay_usec, uint16_t & out_max_delay_usec) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    out_min_delay_usec = m_min_delay_usec;
+    out_max_delay_usec = m_max_delay_usec;
+}
+
+/****************************************************************************************************
+ * \fn void setLimits(double in_queue_ratio, double in_lag_sec)
+ * \brief  set the congestion limits
+ * \param  in_queue_ratio maximum ratio of the socket receive buffer used by the waiting data
+ * \param  in_lag_sec maximum delay in seconds between the reception of a part and its treatment
+ * \return none
+ ****************************************************************************************************/
+void CameraPacketDelayController::setLimits(double in_queue_ratio, double in_lag_sec)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    m_queue_ratio = in_queue_ratio;
+    m_lag_sec     = in_lag_sec    ;
+}
+
+/****************************************************************************************************
+ * \fn void getLimits(double & out_queue_ratio, double & out_lag_sec) const
+ * \brief  get the congestion limits
+ * \param  out_queue_ratio maximum ratio of the socket receive buffer used by the waiting data
+ * \param  out_lag_sec maximum delay in seconds between the reception of a part and its treatment
+ * \return none
+ ****************************************************************************************************/
+void CameraPacketDelayController::getLimits(double & out_queue_ratio, double & out_lag_sec) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    out_queue_ratio = m_queue_ratio;
+    out_lag_sec     = m_lag_sec    ;
+}
+
+/****************************************************************************************************
+ * \fn void getCurrentSettings(uint16_t & out_pixels_per_packet, uint16_t & out_packet_delay_usec) const
+ * \brief  get the packets settings currently used by the camera
+ * \param  out_pixels_per_packet pixels per packet
+ * \param  out_packet_delay_usec packet sending loop delay in microseconds
+ * \return none
+ ****************************************************************************************************/
+void CameraPacketDelayController::getCurrentSettings(uint16_t & out_pixels_per_packet, uint16_t & out_packet_delay_usec) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    out_pixels_per_packet = m_pixels_per_packet ;
+    out_packet_delay_usec = m_current_delay_usec;
+}
+
+/****************************************************************************************************
+ * \fn CameraPacketDelayMeasures getLastMeasures() const
+ * \brief  get the latest measures
+ * \param  none
+ * \return measures copy
+ ****************************************************************************************************/
+CameraPacketDelayMeasures CameraPacketDelayController::getLastMeasures() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    return m_last_measures;
+}
+
+/****************************************************************************************************
+ * \fn bool computeNextDelay(const CameraPacketDelayMeasures & in_measures, uint16_t & out_packet_delay_usec)
+ * \brief  compute the delay to use for the next frame (called by the acquisition thread).
+ *         The transfer rate of the frame tells if the latest decrease of the delay was useful.
+ * \param  in_measures measures done during the reception of the latest frame
+ * \param  out_packet_delay_usec delay to send to the camera
+ * \return true if the delay needs to be changed, else false
+ ****************************************************************************************************/
+bool CameraPacketDelayController::computeNextDelay(const CameraPacketDelayMeasures & in_measures, uint16_t & out_packet_delay_usec)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    m_last_measures = in_measures;
+
+    // the initial delay is restored when the controller is disabled
+    if(!m_enabled)
+    {
+        out_packet_delay_usec = m_initial_delay_usec;
+        return (m_current_delay_usec != m_initial_delay_usec);
+    }
+
+    bool congested = (in_measures.m_max_lag_sec > m_lag_sec) ||
+                     ((in_measures.m_receive_buffer > 0) &&
+                      (static_cast<double>(in_measures.m_max_queue_bytes) > m_queue_ratio * static_cast<double>(in_measures.m_receive_buffer)));
+
+    uint32_t delay = m_current_delay_usec;
+
+    if(congested)
+    {
+        delay            = std::max(delay * 2, delay + g_delay_increase_usec);
+        m_hold_frames_nb = 0;
+    }
+    else
+    if(m_hold_frames_nb > 0)
+    {
+        m_hold_frames_nb--;
+    }
+    else
+    if((m_probe_rate > 0.0) && (in_measures.m_transfer_rate > 0.0) &&
+       (in_measures.m_transfer_rate < m_probe_rate * (1.0 + g_min_rate_gain)))
+    {
+        // the latest decrease did not raise the transfer rate: the camera or the link is the limit
+        delay           += g_delay_decrease_usec;
+        m_hold_frames_nb = g_hold_frames_nb;
+    }
+    else
+    {
+        delay = (delay > g_delay_decrease_usec) ? (delay - g_delay_decrease_usec) : 0;
+    }
+
+    delay = std::min(std::max(delay, static_cast<uint32_t>(m_min_delay_usec)), static_cast<uint32_t>(m_max_delay_usec));
+
+    // after a decrease, the rate of the next frame is compared to the rate of this frame
+    m_probe_rate = ((!congested) && (delay < m_current_delay_usec)) ? in_measures.m_transfer_rate : 0.0;
+
+    out_packet_delay_usec = static_cast<uint16_t>(delay);
+
+    if(out_packet_delay_usec != m_current_delay_usec)
+    {
+        DEB_TRACE() << "packet delay " << m_current_delay_usec << " -> " << out_packet_delay_usec << " usec "
+                    << "(queue " << in_measures.m_max_queue_bytes << "/" << in_measures.m_receive_buffer
+                    << " bytes, lag " << in_measures.m_max_lag_sec << " s, rate " << in_measures.m_transfer_rate << " B/s)";
+        return true;
+    }
+
+    return false;
+}
+
+/****************************************************************************************************
+ * \fn void setCurrentDelay(uint16_t in_packet_delay_usec)
+ * \brief  validate the delay sent to the camera
+ * \param  in_packet_delay_usec packet sending loop delay in microseconds
+ * \return none
+ ****************************************************************************************************/
+void CameraPacketDelayController::setCurrentDelay(uint16_t in_packet_delay_usec)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex controller_mutex = controllerLock();
+
+    m_current_delay_usec = in_packet_delay_usec;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraPacketDelayController::create()
+{
+    init(new CameraPacketDelayController());
+}
+
+//###########################################################################
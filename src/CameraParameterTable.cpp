@@ -0,0 +1,217 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraParameterTable.cpp
+ * \brief  implementation file of the cached camera parameters table.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraParameterTable.h"
+
+// SYSTEM
+#include <sstream>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+/****************************************************************************************************
+ * \fn CameraParameterTable()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraParameterTable::CameraParameterTable()
+{
+}
+
+/****************************************************************************************************
+ * \fn bool parse(const std::string & in_lines, const std::string & in_delimiter, std::size_t in_value_position)
+ * \brief  fill the table with the lines of a GetCameraParameters answer. The lines without
+ *         value are ignored. The previous content is replaced.
+ * \param  in_lines lines sent by the camera
+ * \param  in_delimiter delimiter of the fields of a line
+ * \param  in_value_position position of the value in a line (the group and name are the first fields)
+ * \return true if at least one parameter was found
+ ****************************************************************************************************/
+bool CameraParameterTable::parse(const std::string & in_lines, const std::string & in_delimiter, std::size_t in_value_position)
+{
+    std::istringstream iss(in_lines);
+    std::string        line;
+
+    clear();
+
+    while(std::getline(iss, line))
+    {
+        // the lines can end with a carriage return
+        if((!line.empty()) && (line[line.size() - 1] == '\r'))
+        {
+            line.erase(line.size() - 1);
+        }
+
+        std::vector<std::string> fields;
+        std::size_t              last = 0;
+        std::size_t              next = 0;
+
+        while((next = line.find(in_delimiter, last)) != std::string::npos)
+        {
+            fields.push_back(line.substr(last, next - last));
+            last = next + in_delimiter.size();
+        }
+
+        fields.push_back(line.substr(last));
+
+        if((fields.size() <= in_value_position) || (in_value_position < 2))
+            continue;
+
+        CameraParameter parameter;
+
+        parameter.m_group = fields[0];
+        parameter.m_name  = fields[1];
+        parameter.m_value = fields[in_value_position];
+        parameter.m_line  = line;
+
+        std::string key = buildKey(parameter.m_group, parameter.m_name);
+
+        // a duplicated parameter replaces the previous one
+        std::map<std::string, std::size_t>::const_iterator search = m_index.find(key);
+
+        if(search != m_index.end())
+        {
+            m_parameters[search->second] = parameter;
+        }
+        else
+        {
+            m_index[key] = m_parameters.size();
+            m_parameters.push_back(parameter);
+        }
+    }
+
+    return !m_parameters.empty();
+}
+
+/****************************************************************************************************
+ * \fn void clear()
+ * \brief  clear the table
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraParameterTable::clear()
+{
+    m_parameters.clear();
+    m_index.clear();
+}
+
+/****************************************************************************************************
+ * \fn bool empty() const
+ * \brief  check if the table was filled
+ * \param  none
+ * \return true if the table contains no parameter
+ ****************************************************************************************************/
+bool CameraParameterTable::empty() const
+{
+    return m_parameters.empty();
+}
+
+/****************************************************************************************************
+ * \fn bool find(const std::string & in_group, const std::string & in_name, CameraParameter & out_parameter) const
+ * \brief  get a parameter
+ * \param  in_group parameter group
+ * \param  in_name parameter name
+ * \param  out_parameter copy of the parameter
+ * \return true if the parameter exists
+ ****************************************************************************************************/
+bool CameraParameterTable::find(const std::string & in_group, const std::string & in_name, CameraParameter & out_parameter) const
+{
+    std::map<std::string, std::size_t>::const_iterator search = m_index.find(buildKey(in_group, in_name));
+
+    if(search == m_index.end())
+        return false;
+
+    out_parameter = m_parameters[search->second];
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool getValue(const std::string & in_group, const std::string & in_name, std::string & out_value) const
+ * \brief  get the value of a parameter
+ * \param  in_group parameter group
+ * \param  in_name parameter name
+ * \param  out_value parameter value
+ * \return true if the parameter exists
+ ****************************************************************************************************/
+bool CameraParameterTable::getValue(const std::string & in_group, const std::string & in_name, std::string & out_value) const
+{
+    std::map<std::string, std::size_t>::const_iterator search = m_index.find(buildKey(in_group, in_name));
+
+    if(search == m_index.end())
+        return false;
+
+    out_value = m_parameters[search->second].m_value;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool setValue(const std::string & in_group, const std::string & in_name, const std::string & in_value)
+ * \brief  change the value of a parameter (the complete line is not changed)
+ * \param  in_group parameter group
+ * \param  in_name parameter name
+ * \param  in_value new value
+ * \return true if the parameter exists
+ ****************************************************************************************************/
+bool CameraParameterTable::setValue(const std::string & in_group, const std::string & in_name, const std::string & in_value)
+{
+    std::map<std::string, std::size_t>::const_iterator search = m_index.find(buildKey(in_group, in_name));
+
+    if(search == m_index.end())
+        return false;
+
+    m_parameters[search->second].m_value = in_value;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn const std::vector<CameraParameter> & getParameters() const
+ * \brief  get all the parameters (in the camera order)
+ * \param  none
+ * \return parameters
+ ****************************************************************************************************/
+const std::vector<CameraParameter> & CameraParameterTable::getParameters() const
+{
+    return m_parameters;
+}
+
+/****************************************************************************************************
+ * \fn std::string buildKey(const std::string & in_group, const std::string & in_name)
+ * \brief  build the index key of a parameter
+ * \param  in_group parameter group
+ * \param  in_name parameter name
+ * \return key
+ ****************************************************************************************************/
+std::string CameraParameterTable::buildKey(const std::string & in_group, const std::string & in_name)
+{
+    // the group can not contain a line feed, so the key is not ambiguous
+    return in_group + '\n' + in_name;
+}
+
+//###########################################################################
@@ -0,0 +1,690 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraPhotonTransfer.cpp
+ * \brief  implementation file of the photon transfer curve and per pixel noise characterization stage.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraPhotonTransfer.h"
+#include "CameraControl.h"
+
+// SYSTEM
+#include <algorithm>
+#include <cmath>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraPhotonTransfer::g_band_pixels_nb = 65536;
+const std::size_t CameraPhotonTransfer::g_max_threads_nb = 16   ;
+const double      CameraPhotonTransfer::g_wait_delay_sec = 0.1  ;
+
+/****************************************************************************************************
+ * \fn CameraPhotonTransfer()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraPhotonTransfer::CameraPhotonTransfer() : CameraFrameStage("PhotonTransfer")
+{
+    DEB_CONSTRUCTOR();
+
+    m_width             = 0    ;
+    m_height            = 0    ;
+    m_step_running      = false;
+    m_step_dark         = false;
+    m_step_exposure_sec = 0.0  ;
+    m_step_frames_nb    = 0    ;
+    m_flat_steps_nb     = 0    ;
+    m_sum_t             = 0.0  ;
+    m_sum_tt            = 0.0  ;
+    m_dark_steps_nb     = 0    ;
+    m_frame_data        = NULL ;
+    m_pixels_nb         = 0    ;
+    m_inv_count         = 1.0f ;
+    m_bands_nb          = 0    ;
+    m_next_band         = 0    ;
+    m_done_bands_nb     = 0    ;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraPhotonTransfer()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraPhotonTransfer::~CameraPhotonTransfer()
+{
+    DEB_DESTRUCTOR();
+
+    releaseThreads();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex bandsLock() const
+ * \brief  creates an autolock mutex for the bands access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraPhotonTransfer::bandsLock() const
+{
+    return lima::AutoMutex(m_bands_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn void startSeries()
+ * \brief  remove the accumulated data and start a new series with the next acquisitions
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::startSeries()
+{
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex stage_mutex = stageLock();
+
+        m_width          = 0    ;
+        m_height         = 0    ;
+        m_step_running   = false;
+        m_step_frames_nb = 0    ;
+        m_flat_steps_nb  = 0    ;
+        m_sum_t          = 0.0  ;
+        m_sum_tt         = 0.0  ;
+        m_dark_steps_nb  = 0    ;
+
+        m_steps        .clear();
+        m_step_mean    .clear();
+        m_step_m2      .clear();
+        m_sum_x        .clear();
+        m_sum_xx       .clear();
+        m_sum_y        .clear();
+        m_sum_xy       .clear();
+        m_sum_tx       .clear();
+        m_dark_variance.clear();
+    }
+
+    setEnabled(true);
+}
+
+/****************************************************************************************************
+ * \fn void stopSeries()
+ * \brief  stop the series, the accumulated data are kept for the maps computing.
+ *         A step in progress is folded at the end of its acquisition.
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::stopSeries()
+{
+    setEnabled(false);
+}
+
+/****************************************************************************************************
+ * \fn bool setThreadsNb(std::size_t in_threads_nb)
+ * \brief  set the number of threads which help the acquisition thread (not during an acquisition)
+ * \param  in_threads_nb number of threads (0 to accumulate the frames in the acquisition thread)
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraPhotonTransfer::setThreadsNb(std::size_t in_threads_nb)
+{
+    if(in_threads_nb > g_max_threads_nb)
+        return false;
+
+    if(in_threads_nb == m_threads.size())
+        return true;
+
+    releaseThreads();
+
+    for(std::size_t thread_index = 0 ; thread_index < in_threads_nb ; thread_index++)
+    {
+        CameraWriterThread * thread = new CameraWriterThread(this);
+
+        thread->start       ();
+        thread->startWriting();
+
+        m_threads.push_back(thread);
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getThreadsNb() const
+ * \brief  get the number of threads which help the acquisition thread
+ * \param  none
+ * \return number of threads
+ ****************************************************************************************************/
+std::size_t CameraPhotonTransfer::getThreadsNb() const
+{
+    return m_threads.size();
+}
+
+/****************************************************************************************************
+ * \fn void getSteps(std::vector<CameraPhotonTransferStep> & out_steps) const
+ * \brief  get the points of the photon transfer curve (one by folded step)
+ * \param  out_steps points in the acquisitions order
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::getSteps(std::vector<CameraPhotonTransferStep> & out_steps) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    out_steps = m_steps;
+}
+
+/****************************************************************************************************
+ * \fn bool computeMaps(CameraPhotonTransferMaps & out_maps) const
+ * \brief  compute the per pixel maps of the series.
+ *         The gain is the inverse of the least squares slope of the variance against the level
+ *         of the flat steps (the bias and the read noise only move the intercept).
+ *         The read noise is the mean dark variance converted in electrons with the gain.
+ *         The nonlinearity is the rms residual of the least squares line of the level against
+ *         the exposure time, compared to the mean signal above the intercept.
+ * \param  out_maps computed maps
+ * \return true if succeed, false if the series does not contain two flat steps
+ ****************************************************************************************************/
+bool CameraPhotonTransfer::computeMaps(CameraPhotonTransferMaps & out_maps) const
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(m_flat_steps_nb < 2)
+    {
+        DEB_ERROR() << "CameraPhotonTransfer::computeMaps - At least two flat steps are needed (" << m_flat_steps_nb << " done)!";
+        return false;
+    }
+
+    std::size_t pixels_nb = m_width * m_height;
+    double      steps_nb  = static_cast<double>(m_flat_steps_nb);
+    double      mean_t    = m_sum_t / steps_nb;
+    double      stt       = m_sum_tt - m_sum_t * mean_t;
+
+    out_maps.m_width           = m_width ;
+    out_maps.m_height          = m_height;
+    out_maps.m_valid_pixels_nb = 0       ;
+
+    out_maps.m_gain        .assign(pixels_nb, 0.0f);
+    out_maps.m_read_noise  .assign(pixels_nb, 0.0f);
+    out_maps.m_nonlinearity.assign(pixels_nb, 0.0f);
+
+    for(std::size_t index = 0 ; index < pixels_nb ; index++)
+    {
+        double mean_x = m_sum_x[index] / steps_nb;
+        double sxx    = m_sum_xx[index] - m_sum_x[index] * mean_x;
+        double sxy    = m_sum_xy[index] - m_sum_y[index] * mean_x;
+
+        // photon transfer curve: variance = level / gain + constant
+        if((sxx > 0.0) && (sxy > 0.0))
+        {
+            double gain = sxx / sxy;
+
+            out_maps.m_gain[index] = static_cast<float>(gain);
+            out_maps.m_valid_pixels_nb++;
+
+            if(m_dark_steps_nb > 0)
+            {
+                double dark_variance = static_cast<double>(m_dark_variance[index]) / static_cast<double>(m_dark_steps_nb);
+
+                out_maps.m_read_noise[index] = static_cast<float>(gain * sqrt(std::max(dark_variance, 0.0)));
+            }
+        }
+
+        // linearity: level = intercept + slope * exposure time
+        if(stt > 0.0)
+        {
+            double stx    = m_sum_tx[index] - m_sum_t * mean_x;
+            double slope  = stx / stt;
+            double sse    = std::max(sxx - stx * slope, 0.0);
+            double signal = slope * mean_t;
+
+            if(signal > 0.0)
+                out_maps.m_nonlinearity[index] = static_cast<float>(100.0 * sqrt(sse / steps_nb) / signal);
+        }
+    }
+
+    out_maps.m_median_gain         = computeMedian(out_maps.m_gain        );
+    out_maps.m_median_read_noise   = computeMedian(out_maps.m_read_noise  );
+    out_maps.m_median_nonlinearity = computeMedian(out_maps.m_nonlinearity);
+
+    DEB_TRACE() << "Photon transfer maps: median gain " << out_maps.m_median_gain << " e-/ADU, median read noise "
+                << out_maps.m_median_read_noise << " e-, median nonlinearity " << out_maps.m_median_nonlinearity << "%";
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool prepareAcq(const CameraFrameFormat & in_format)
+ * \brief  prepare the stage for a new acquisition, which becomes a step of the running series.
+ *         All the steps of a series must use the same frame size.
+ * \param  in_format format of the frames
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraPhotonTransfer::prepareAcq(const CameraFrameFormat & in_format)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    m_step_running = false;
+
+    if(!isEnabled())
+        return true;
+
+    if(in_format.m_pixel_depth > 16)
+    {
+        DEB_ERROR() << "CameraPhotonTransfer::prepareAcq - Incorrect pixel depth: " << in_format.m_pixel_depth;
+        return false;
+    }
+
+    std::size_t pixels_nb = in_format.m_width * in_format.m_height;
+
+    // the series sums are allocated by the first step
+    if(m_width == 0)
+    {
+        m_width  = in_format.m_width ;
+        m_height = in_format.m_height;
+
+        m_sum_x        .assign(pixels_nb, 0.0 );
+        m_sum_xx       .assign(pixels_nb, 0.0 );
+        m_sum_y        .assign(pixels_nb, 0.0 );
+        m_sum_xy       .assign(pixels_nb, 0.0 );
+        m_sum_tx       .assign(pixels_nb, 0.0 );
+        m_dark_variance.assign(pixels_nb, 0.0f);
+    }
+    else
+    if((m_width != in_format.m_width) || (m_height != in_format.m_height))
+    {
+        DEB_ERROR() << "CameraPhotonTransfer::prepareAcq - The frame size changed during the series: "
+                    << in_format.m_width << "x" << in_format.m_height << " instead of " << m_width << "x" << m_height;
+        return false;
+    }
+
+    const CameraControl * control = CameraControl::getConstInstance();
+
+    m_step_dark         = (control->getAcquisitionType() == NetAnswerGetSettings::Dark);
+    m_step_exposure_sec = static_cast<double>(control->getExposureTimeMsec()) / 1000.0;
+    m_step_frames_nb    = 0;
+
+    m_step_mean.assign(pixels_nb, 0.0f);
+    m_step_m2  .assign(pixels_nb, 0.0f);
+
+    m_step_running = true;
+
+    DEB_TRACE() << "Photon transfer step " << m_steps.size() << " prepared: " << ((m_step_dark) ? "dark" : "flat")
+                << ", " << m_step_exposure_sec << " s";
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool process(CameraFrame & in_out_frame)
+ * \brief  accumulate a complete frame into the step data (called by the acquisition thread).
+ *         With threads, the acquisition thread accumulates bands too, then waits the others.
+ * \param  in_out_frame frame to accumulate (not modified)
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraPhotonTransfer::process(CameraFrame & in_out_frame)
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(!m_step_running)
+        return true;
+
+    if((in_out_frame.m_width != m_width) || (in_out_frame.m_height != m_height))
+    {
+        DEB_ERROR() << "CameraPhotonTransfer::process - Incorrect frame size: " << in_out_frame.m_width << "x" << in_out_frame.m_height;
+        return false;
+    }
+
+    m_step_frames_nb++;
+
+    std::size_t pixels_nb = m_width * m_height;
+    float       inv_count = 1.0f / static_cast<float>(m_step_frames_nb);
+
+    if(m_threads.empty())
+    {
+        accumulatePixels(in_out_frame.m_data, m_step_mean.data(), m_step_m2.data(), pixels_nb, inv_count);
+        return true;
+    }
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex bands_mutex = bandsLock();
+
+        m_frame_data    = in_out_frame.m_data;
+        m_pixels_nb     = pixels_nb;
+        m_inv_count     = inv_count;
+        m_bands_nb      = (pixels_nb + g_band_pixels_nb - 1) / g_band_pixels_nb;
+        m_next_band     = 0;
+        m_done_bands_nb = 0;
+
+        m_bands_cond.broadcast();
+    }
+
+    for(;;)
+    {
+        std::size_t band_index;
+
+        {
+            // protecting the multi-threads access
+            lima::AutoMutex bands_mutex = bandsLock();
+
+            if(m_next_band >= m_bands_nb)
+                break;
+
+            band_index = m_next_band++;
+        }
+
+        accumulateBand(band_index);
+
+        {
+            // protecting the multi-threads access
+            lima::AutoMutex bands_mutex = bandsLock();
+
+            m_done_bands_nb++;
+        }
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex bands_mutex = bandsLock();
+
+    while(m_done_bands_nb < m_bands_nb)
+    {
+        m_bands_cond.wait(g_wait_delay_sec);
+    }
+
+    // the frame is given back to Lima
+    m_frame_data = NULL;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void endAcq()
+ * \brief  end the current step and fold it into the series sums (called by the acquisition thread)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::endAcq()
+{
+    // protecting the multi-threads access
+    lima::AutoMutex stage_mutex = stageLock();
+
+    if(!m_step_running)
+        return;
+
+    m_step_running = false;
+    foldStep();
+}
+
+/****************************************************************************************************
+ * \fn void writeNext()
+ * \brief  accumulate the next band of the current frame, waits a short delay if there is none
+ *         (called by the threads)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::writeNext()
+{
+    std::size_t band_index;
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex bands_mutex = bandsLock();
+
+        if((m_frame_data == NULL) || (m_next_band >= m_bands_nb))
+        {
+            m_bands_cond.wait(g_wait_delay_sec);
+
+            if((m_frame_data == NULL) || (m_next_band >= m_bands_nb))
+                return;
+        }
+
+        band_index = m_next_band++;
+    }
+
+    accumulateBand(band_index);
+
+    {
+        // protecting the multi-threads access
+        lima::AutoMutex bands_mutex = bandsLock();
+
+        m_done_bands_nb++;
+        m_bands_cond.broadcast();
+    }
+}
+
+/****************************************************************************************************
+ * \fn void accumulateBand(std::size_t in_band_index)
+ * \brief  accumulate the pixels of a band into the step data.
+ *         The bands are disjoint, so they are accumulated without lock.
+ * \param  in_band_index index of the band in the frame
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::accumulateBand(std::size_t in_band_index)
+{
+    std::size_t start     = in_band_index * g_band_pixels_nb;
+    std::size_t pixels_nb = std::min(g_band_pixels_nb, m_pixels_nb - start);
+
+    accumulatePixels(m_frame_data + start, m_step_mean.data() + start, m_step_m2.data() + start, pixels_nb, m_inv_count);
+}
+
+/****************************************************************************************************
+ * \fn void accumulatePixels(const uint16_t * in_data, float * in_out_mean, float * in_out_m2, std::size_t in_pixels_nb, float in_inv_count)
+ * \brief  accumulate pixels into the mean and the variance sums. All the pixels have the same
+ *         count, so the Welford update has no division by pixel:
+ *         delta = x - mean, mean += delta / n, m2 += delta * (x - mean).
+ *         With SSE2, eight pixels are converted and accumulated at once.
+ * \param  in_data pixels of the frame
+ * \param  in_out_mean running mean of each pixel
+ * \param  in_out_m2 running sum of the squared deviations of each pixel
+ * \param  in_pixels_nb number of pixels
+ * \param  in_inv_count inverse of the number of accumulated frames (this one included)
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::accumulatePixels(const uint16_t * in_data     ,
+                                            float          * in_out_mean ,
+                                            float          * in_out_m2   ,
+                                            std::size_t      in_pixels_nb,
+                                            float            in_inv_count)
+{
+    std::size_t index = 0;
+
+#if defined(__SSE2__)
+    const __m128  inv_count = _mm_set1_ps(in_inv_count);
+    const __m128i zero      = _mm_setzero_si128();
+
+    for( ; index + 8 <= in_pixels_nb ; index += 8)
+    {
+        __m128i pixels    = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_data + index));
+        __m128  values[2] = { _mm_cvtepi32_ps(_mm_unpacklo_epi16(pixels, zero)),
+                              _mm_cvtepi32_ps(_mm_unpackhi_epi16(pixels, zero)) };
+
+        for(std::size_t half = 0 ; half < 2 ; half++)
+        {
+            float * mean_ptr = in_out_mean + index + half * 4;
+            float * m2_ptr   = in_out_m2   + index + half * 4;
+
+            __m128 mean  = _mm_loadu_ps(mean_ptr);
+            __m128 delta = _mm_sub_ps(values[half], mean);
+
+            mean = _mm_add_ps(mean, _mm_mul_ps(delta, inv_count));
+
+            _mm_storeu_ps(mean_ptr, mean);
+            _mm_storeu_ps(m2_ptr  , _mm_add_ps(_mm_loadu_ps(m2_ptr), _mm_mul_ps(delta, _mm_sub_ps(values[half], mean))));
+        }
+    }
+#endif
+
+    for( ; index < in_pixels_nb ; index++)
+    {
+        float value = static_cast<float>(in_data[index]);
+        float delta = value - in_out_mean[index];
+
+        in_out_mean[index] += delta * in_inv_count;
+        in_out_m2  [index] += delta * (value - in_out_mean[index]);
+    }
+}
+
+/****************************************************************************************************
+ * \fn void foldStep()
+ * \brief  fold the current step into the series sums (the stage lock is already taken).
+ *         A step needs two frames for the temporal variance.
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::foldStep()
+{
+    DEB_MEMBER_FUNCT();
+
+    if(m_step_frames_nb < 2)
+    {
+        DEB_WARNING() << "Photon transfer step ignored: " << m_step_frames_nb << " frame(s), at least two are needed.";
+        return;
+    }
+
+    std::size_t pixels_nb     = m_width * m_height;
+    float       inv_degrees   = 1.0f / static_cast<float>(m_step_frames_nb - 1);
+    double      t             = m_step_exposure_sec;
+    double      mean_sum      = 0.0;
+    double      variance_sum  = 0.0;
+
+    for(std::size_t index = 0 ; index < pixels_nb ; index++)
+    {
+        double level    = static_cast<double>(m_step_mean[index]);
+        double variance = static_cast<double>(m_step_m2[index] * inv_degrees);
+
+        mean_sum     += level   ;
+        variance_sum += variance;
+
+        if(m_step_dark)
+        {
+            m_dark_variance[index] += static_cast<float>(variance);
+        }
+        else
+        {
+            m_sum_x [index] += level           ;
+            m_sum_xx[index] += level * level   ;
+            m_sum_y [index] += variance        ;
+            m_sum_xy[index] += level * variance;
+            m_sum_tx[index] += t * level       ;
+        }
+    }
+
+    if(m_step_dark)
+    {
+        m_dark_steps_nb++;
+    }
+    else
+    {
+        m_flat_steps_nb++;
+        m_sum_t  += t    ;
+        m_sum_tt += t * t;
+    }
+
+    CameraPhotonTransferStep step;
+
+    step.m_exposure_sec  = m_step_exposure_sec;
+    step.m_dark          = m_step_dark        ;
+    step.m_frames_nb     = m_step_frames_nb   ;
+    step.m_mean_adu      = (pixels_nb > 0) ? mean_sum     / static_cast<double>(pixels_nb) : 0.0;
+    step.m_variance_adu2 = (pixels_nb > 0) ? variance_sum / static_cast<double>(pixels_nb) : 0.0;
+
+    m_steps.push_back(step);
+
+    DEB_TRACE() << "Photon transfer step " << (m_steps.size() - 1) << " folded: " << step.m_frames_nb << " frames, mean "
+                << step.m_mean_adu << " ADU, variance " << step.m_variance_adu2 << " ADU2";
+}
+
+/****************************************************************************************************
+ * \fn double computeMedian(const std::vector<float> & in_values)
+ * \brief  compute the median of the non null values (the invalid pixels are null)
+ * \param  in_values values of the map
+ * \return median (0 if there is no valid value)
+ ****************************************************************************************************/
+double CameraPhotonTransfer::computeMedian(const std::vector<float> & in_values)
+{
+    std::vector<float> values;
+
+    values.reserve(in_values.size());
+
+    for(std::size_t index = 0 ; index < in_values.size() ; index++)
+    {
+        if(in_values[index] != 0.0f)
+            values.push_back(in_values[index]);
+    }
+
+    if(values.empty())
+        return 0.0;
+
+    std::vector<float>::iterator middle = values.begin() + values.size() / 2;
+
+    std::nth_element(values.begin(), middle, values.end());
+
+    return static_cast<double>(*middle);
+}
+
+/****************************************************************************************************
+ * \fn void releaseThreads()
+ * \brief  stop and release the threads
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::releaseThreads()
+{
+    for(std::size_t thread_index = 0 ; thread_index < m_threads.size() ; thread_index++)
+    {
+        m_threads[thread_index]->stopWriting();
+        delete m_threads[thread_index];
+    }
+
+    m_threads.clear();
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraPhotonTransfer::create()
+{
+    init(new CameraPhotonTransfer());
+}
+
+//###########################################################################
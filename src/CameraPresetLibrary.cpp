@@ -0,0 +1,448 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraPresetLibrary.cpp
+ * \brief  implementation file of the experiment presets library.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraPresetLibrary.h"
+
+// SYSTEM
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <algorithm>
+#include <dirent.h>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::string CameraPresetLibrary::g_file_extension = ".preset";
+
+/****************************************************************************************************
+ * \fn CameraPresetLibrary()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraPresetLibrary::CameraPresetLibrary()
+{
+    DEB_CONSTRUCTOR();
+
+    m_directory = ".";
+}
+
+/****************************************************************************************************
+ * \fn ~CameraPresetLibrary()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraPresetLibrary::~CameraPresetLibrary()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex presetsLock() const
+ * \brief  creates an autolock mutex for the presets files access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraPresetLibrary::presetsLock() const
+{
+    return lima::AutoMutex(m_presets_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn void setDirectory(const std::string & in_directory)
+ * \brief  set the directory of the presets files
+ * \param  in_directory directory
+ * \return none
+ ****************************************************************************************************/
+void CameraPresetLibrary::setDirectory(const std::string & in_directory)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex presets_mutex = presetsLock();
+
+    m_directory = in_directory;
+}
+
+/****************************************************************************************************
+ * \fn std::string getDirectory() const
+ * \brief  get the directory of the presets files
+ * \param  none
+ * \return directory
+ ****************************************************************************************************/
+std::string CameraPresetLibrary::getDirectory() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex presets_mutex = presetsLock();
+
+    return m_directory;
+}
+
+/****************************************************************************************************
+ * \fn bool isValidName(const std::string & in_name)
+ * \brief  check if a name can be used for a preset
+ * \param  in_name preset name
+ * \return true if the name only contains letters, digits, '_' and '-' characters
+ ****************************************************************************************************/
+bool CameraPresetLibrary::isValidName(const std::string & in_name)
+{
+    if(in_name.empty())
+        return false;
+
+    for(std::size_t index = 0 ; index < in_name.size() ; index++)
+    {
+        const char character = in_name[index];
+
+        if(!(((character >= 'a') && (character <= 'z')) ||
+             ((character >= 'A') && (character <= 'Z')) ||
+             ((character >= '0') && (character <= '9')) ||
+             (character == '_') || (character == '-')))
+        {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::string buildFileName(const std::string & in_name) const
+ * \brief  build the file name of a preset (the caller must hold the presets lock)
+ * \param  in_name preset name
+ * \return file name
+ ****************************************************************************************************/
+std::string CameraPresetLibrary::buildFileName(const std::string & in_name) const
+{
+    return m_directory + "/" + in_name + g_file_extension;
+}
+
+/****************************************************************************************************
+ * \fn bool save(const CameraPreset & in_preset)
+ * \brief  write a preset file (an existing preset is replaced)
+ * \param  in_preset preset to write
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraPresetLibrary::save(const CameraPreset & in_preset)
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!isValidName(in_preset.m_name))
+    {
+        DEB_ERROR() << "CameraPresetLibrary::save - Incorrect preset name " << in_preset.m_name;
+        return false;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex presets_mutex = presetsLock();
+
+    const std::string file_name = buildFileName(in_preset.m_name);
+    std::ofstream     file(file_name.c_str());
+
+    if(!file.is_open())
+    {
+        DEB_ERROR() << "CameraPresetLibrary::save - Unable to create the file " << file_name;
+        return false;
+    }
+
+    const CameraHardwareSettings & hardware = in_preset.m_hardware;
+
+    file << "# Spectral Instrument camera preset " << in_preset.m_name << "\n";
+    file << "serial_origin = "      << hardware.m_serial_origin                         << "\n";
+    file << "serial_length = "      << hardware.m_serial_length                         << "\n";
+    file << "serial_binning = "     << hardware.m_serial_binning                        << "\n";
+    file << "parallel_origin = "    << hardware.m_parallel_origin                       << "\n";
+    file << "parallel_length = "    << hardware.m_parallel_length                       << "\n";
+    file << "parallel_binning = "   << hardware.m_parallel_binning                      << "\n";
+    file << "exposure_time_msec = " << hardware.m_exposure_time_msec                    << "\n";
+    file << "readout_speed = "      << hardware.m_readout_speed                         << "\n";
+    file << "cooling = "            << static_cast<unsigned int>(hardware.m_cooling_value) << "\n";
+    file << "pixels_per_packet = "  << hardware.m_pixels_per_packet                     << "\n";
+    file << "packet_delay_usec = "  << hardware.m_packet_delay_usec                     << "\n";
+    file << "trigger_mode = "       << in_preset.m_trigger_mode                         << "\n";
+    file << "bad_pixel_map = "      << (in_preset.m_bad_pixel_map   ? 1 : 0)            << "\n";
+    file << "change_detector = "    << (in_preset.m_change_detector ? 1 : 0)            << "\n";
+    file << "mosaic = "             << (in_preset.m_mosaic          ? 1 : 0)            << "\n";
+    file << "fits_writer = "        << (in_preset.m_fits_writer     ? 1 : 0)            << "\n";
+    file << "hdf5_writer = "        << (in_preset.m_hdf5_writer     ? 1 : 0)            << "\n";
+
+    file.close();
+
+    if(file.fail())
+    {
+        DEB_ERROR() << "CameraPresetLibrary::save - Unable to write the file " << file_name;
+        return false;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool readValue(const std::map<std::string, std::string> & in_values, const std::string & in_key, uint64_t & out_value)
+ * \brief  get a numerical value of a read preset
+ * \param  in_values values of the preset file by key
+ * \param  in_key key of the value
+ * \param  out_value value
+ * \return true if the key exists and its value is a number
+ ****************************************************************************************************/
+bool CameraPresetLibrary::readValue(const std::map<std::string, std::string> & in_values,
+                                    const std::string                        & in_key   ,
+                                    uint64_t                                 & out_value)
+{
+    std::map<std::string, std::string>::const_iterator search = in_values.find(in_key);
+
+    if(search == in_values.end())
+        return false;
+
+    std::istringstream value_stream(search->second);
+
+    return static_cast<bool>(value_stream >> out_value);
+}
+
+/****************************************************************************************************
+ * \fn bool load(const std::string & in_name, CameraPreset & out_preset) const
+ * \brief  read a preset file. All the keys must be present.
+ * \param  in_name preset name
+ * \param  out_preset read preset
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraPresetLibrary::load(const std::string & in_name, CameraPreset & out_preset) const
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!isValidName(in_name))
+    {
+        DEB_ERROR() << "CameraPresetLibrary::load - Incorrect preset name " << in_name;
+        return false;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex presets_mutex = presetsLock();
+
+    const std::string file_name = buildFileName(in_name);
+    std::ifstream     file(file_name.c_str());
+
+    if(!file.is_open())
+    {
+        DEB_ERROR() << "CameraPresetLibrary::load - Unable to open the file " << file_name;
+        return false;
+    }
+
+    std::map<std::string, std::string> values;
+    std::string line;
+    std::size_t line_nb = 0;
+
+    while(std::getline(file, line))
+    {
+        line_nb++;
+
+        if((line.empty()) || (line[0] == '#'))
+            continue;
+
+        std::istringstream line_stream(line);
+        std::string        key      ;
+        std::string        separator;
+        std::string        value    ;
+
+        if(!(line_stream >> key >> separator >> value) || (separator != "="))
+        {
+            DEB_ERROR() << "CameraPresetLibrary::load - Incorrect line " << line_nb << " in the file " << file_name;
+            return false;
+        }
+
+        values[key] = value;
+    }
+
+    uint64_t serial_origin     ;
+    uint64_t serial_length     ;
+    uint64_t serial_binning    ;
+    uint64_t parallel_origin   ;
+    uint64_t parallel_length   ;
+    uint64_t parallel_binning  ;
+    uint64_t exposure_time_msec;
+    uint64_t readout_speed     ;
+    uint64_t cooling           ;
+    uint64_t pixels_per_packet ;
+    uint64_t packet_delay_usec ;
+    uint64_t trigger_mode      ;
+    uint64_t bad_pixel_map     ;
+    uint64_t change_detector   ;
+    uint64_t mosaic            ;
+    uint64_t fits_writer       ;
+    uint64_t hdf5_writer       ;
+
+    if((!readValue(values, "serial_origin"     , serial_origin     )) ||
+       (!readValue(values, "serial_length"     , serial_length     )) ||
+       (!readValue(values, "serial_binning"    , serial_binning    )) ||
+       (!readValue(values, "parallel_origin"   , parallel_origin   )) ||
+       (!readValue(values, "parallel_length"   , parallel_length   )) ||
+       (!readValue(values, "parallel_binning"  , parallel_binning  )) ||
+       (!readValue(values, "exposure_time_msec", exposure_time_msec)) ||
+       (!readValue(values, "readout_speed"     , readout_speed     )) ||
+       (!readValue(values, "cooling"           , cooling           )) ||
+       (!readValue(values, "pixels_per_packet" , pixels_per_packet )) ||
+       (!readValue(values, "packet_delay_usec" , packet_delay_usec )) ||
+       (!readValue(values, "trigger_mode"      , trigger_mode      )) ||
+       (!readValue(values, "bad_pixel_map"     , bad_pixel_map     )) ||
+       (!readValue(values, "change_detector"   , change_detector   )) ||
+       (!readValue(values, "mosaic"            , mosaic            )) ||
+       (!readValue(values, "fits_writer"       , fits_writer       )) ||
+       (!readValue(values, "hdf5_writer"       , hdf5_writer       )))
+    {
+        DEB_ERROR() << "CameraPresetLibrary::load - Missing or incorrect value in the file " << file_name;
+        return false;
+    }
+
+    if((serial_binning == 0) || (parallel_binning == 0) || (serial_length == 0) || (parallel_length == 0) ||
+       (exposure_time_msec > 0xFFFFFFFFULL) || (pixels_per_packet > 0xFFFF) || (packet_delay_usec > 0xFFFF))
+    {
+        DEB_ERROR() << "CameraPresetLibrary::load - Value out of range in the file " << file_name;
+        return false;
+    }
+
+    CameraHardwareSettings & hardware = out_preset.m_hardware;
+
+    out_preset.m_name = in_name;
+
+    hardware.m_serial_origin      = static_cast<std::size_t>(serial_origin     );
+    hardware.m_serial_length      = static_cast<std::size_t>(serial_length     );
+    hardware.m_serial_binning     = static_cast<std::size_t>(serial_binning    );
+    hardware.m_parallel_origin    = static_cast<std::size_t>(parallel_origin   );
+    hardware.m_parallel_length    = static_cast<std::size_t>(parallel_length   );
+    hardware.m_parallel_binning   = static_cast<std::size_t>(parallel_binning  );
+    hardware.m_exposure_time_msec = static_cast<uint32_t   >(exposure_time_msec);
+    hardware.m_readout_speed      = static_cast<uint32_t   >(readout_speed     );
+    hardware.m_cooling_value      = (cooling != 0) ? 1 : 0;
+    hardware.m_pixels_per_packet  = static_cast<uint16_t   >(pixels_per_packet );
+    hardware.m_packet_delay_usec  = static_cast<uint16_t   >(packet_delay_usec );
+
+    out_preset.m_trigger_mode    = static_cast<int>(trigger_mode);
+    out_preset.m_bad_pixel_map   = (bad_pixel_map   != 0);
+    out_preset.m_change_detector = (change_detector != 0);
+    out_preset.m_mosaic          = (mosaic          != 0);
+    out_preset.m_fits_writer     = (fits_writer     != 0);
+    out_preset.m_hdf5_writer     = (hdf5_writer     != 0);
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool remove(const std::string & in_name)
+ * \brief  delete a preset file
+ * \param  in_name preset name
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool CameraPresetLibrary::remove(const std::string & in_name)
+{
+    DEB_MEMBER_FUNCT();
+
+    if(!isValidName(in_name))
+    {
+        DEB_ERROR() << "CameraPresetLibrary::remove - Incorrect preset name " << in_name;
+        return false;
+    }
+
+    // protecting the multi-threads access
+    lima::AutoMutex presets_mutex = presetsLock();
+
+    const std::string file_name = buildFileName(in_name);
+
+    if(std::remove(file_name.c_str()) != 0)
+    {
+        DEB_ERROR() << "CameraPresetLibrary::remove - Unable to delete the file " << file_name;
+        return false;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool getNames(std::vector<std::string> & out_names) const
+ * \brief  get the names of the stored presets (sorted)
+ * \param  out_names presets names
+ * \return true if succeed, false if the directory can not be read
+ ****************************************************************************************************/
+bool CameraPresetLibrary::getNames(std::vector<std::string> & out_names) const
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex presets_mutex = presetsLock();
+
+    DIR * directory = opendir(m_directory.c_str());
+
+    out_names.clear();
+
+    if(directory == NULL)
+    {
+        DEB_ERROR() << "CameraPresetLibrary::getNames - Unable to read the directory " << m_directory;
+        return false;
+    }
+
+    struct dirent * entry;
+
+    while((entry = readdir(directory)) != NULL)
+    {
+        const std::string file_name = entry->d_name;
+
+        if((file_name.size() <= g_file_extension.size()) ||
+           (file_name.compare(file_name.size() - g_file_extension.size(), g_file_extension.size(), g_file_extension) != 0))
+        {
+            continue;
+        }
+
+        const std::string name = file_name.substr(0, file_name.size() - g_file_extension.size());
+
+        if(isValidName(name))
+            out_names.push_back(name);
+    }
+
+    closedir(directory);
+
+    std::sort(out_names.begin(), out_names.end());
+    return true;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraPresetLibrary::create()
+{
+    init(new CameraPresetLibrary());
+}
+
+//###########################################################################
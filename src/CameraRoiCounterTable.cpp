@@ -0,0 +1,501 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraRoiCounterTable.cpp
+ * \brief  implementation file of the ROI counters computed during the frame assembly.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraRoiCounterTable.h"
+
+// SYSTEM
+#include <cstring>
+#include <algorithm>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraRoiCounterTable::g_ring_size   = 4096;
+const std::size_t CameraRoiCounterTable::g_max_rois_nb = 32  ;
+
+/****************************************************************************************************
+ * \fn CameraRoiCounterTable()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraRoiCounterTable::CameraRoiCounterTable()
+{
+    DEB_CONSTRUCTOR();
+
+    m_enabled      = false;
+    m_areas_valid  = false;
+    m_areas_width  = 0    ;
+    m_areas_height = 0    ;
+    m_frame_opened = false;
+    m_frame_nb     = 0    ;
+
+    CameraRoiCounter counter;
+    memset(&counter, 0, sizeof(CameraRoiCounter));
+
+    // the records are never reallocated, so the readers never access a released memory
+    m_sequences.assign      (g_ring_size, 1);
+    m_frame_nbs.assign      (g_ring_size, 0);
+    m_acquisition_nbs.assign(g_ring_size, 0);
+    m_rois_nbs.assign       (g_ring_size, 0);
+    m_counters.assign       (g_ring_size * g_max_rois_nb, counter);
+
+    m_acquisition_nb = 0;
+    m_last_frame_end = 0;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraRoiCounterTable()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraRoiCounterTable::~CameraRoiCounterTable()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex tableLock() const
+ * \brief  creates an autolock mutex for the table data access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraRoiCounterTable::tableLock() const
+{
+    return lima::AutoMutex(m_table_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn void setEnabled(bool in_enabled)
+ * \brief  enable or disable the counters. The table is registered as a listener of the row
+ *         bands only when it is enabled, so the bands are not followed for nothing.
+ * \param  in_enabled true to compute the counters of the next frames
+ * \return none
+ ****************************************************************************************************/
+void CameraRoiCounterTable::setEnabled(bool in_enabled)
+{
+    DEB_MEMBER_FUNCT();
+
+    // the notifier calls the listeners with its lock taken, so our lock is not held here
+    if(in_enabled)
+    {
+        CameraRowBandNotifier::getInstance()->addListener(this);
+    }
+    else
+    {
+        CameraRowBandNotifier::getInstance()->removeListener(this);
+    }
+
+    lima::AutoMutex table_mutex = tableLock();
+    m_enabled      = in_enabled;
+    m_frame_opened = false     ;
+
+    DEB_TRACE() << "ROI counters " << ((in_enabled) ? "enabled" : "disabled");
+}
+
+/****************************************************************************************************
+ * \fn bool isEnabled() const
+ * \brief  check if the counters are enabled
+ * \param  none
+ * \return true if the counters are computed
+ ****************************************************************************************************/
+bool CameraRoiCounterTable::isEnabled() const
+{
+    lima::AutoMutex table_mutex = tableLock();
+    return m_enabled;
+}
+
+/****************************************************************************************************
+ * \fn bool setRois(const std::vector<CameraCounterRoi> & in_rois)
+ * \brief  set the ROIs definitions (not during an acquisition). The ROIs can overlap and can
+ *         be partly outside the frame: only their pixels inside the frame are counted.
+ * \param  in_rois new ROIs definitions (at most getMaxRoisNb())
+ * \return false if a definition is incorrect
+ ****************************************************************************************************/
+bool CameraRoiCounterTable::setRois(const std::vector<CameraCounterRoi> & in_rois)
+{
+    DEB_MEMBER_FUNCT();
+
+    if(in_rois.size() > g_max_rois_nb)
+        return false;
+
+    for(std::size_t roi_index = 0 ; roi_index < in_rois.size() ; roi_index++)
+    {
+        const CameraCounterRoi & roi = in_rois[roi_index];
+
+        if((roi.m_width == 0) || (roi.m_height == 0))
+            return false;
+
+        if((!roi.m_mask.empty()) && (roi.m_mask.size() != roi.m_width * roi.m_height))
+            return false;
+    }
+
+    lima::AutoMutex table_mutex = tableLock();
+
+    m_rois         = in_rois;
+    m_areas_valid  = false  ;
+    m_frame_opened = false  ;
+
+    DEB_TRACE() << "ROI counters: " << m_rois.size() << " ROIs";
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void getRois(std::vector<CameraCounterRoi> & out_rois) const
+ * \brief  get the ROIs definitions
+ * \param  out_rois copy of the ROIs definitions
+ * \return none
+ ****************************************************************************************************/
+void CameraRoiCounterTable::getRois(std::vector<CameraCounterRoi> & out_rois) const
+{
+    lima::AutoMutex table_mutex = tableLock();
+    out_rois = m_rois;
+}
+
+/****************************************************************************************************
+ * \fn void prepareAcq()
+ * \brief  start a new acquisition. The records of the previous acquisitions are not cleared,
+ *         they are rejected by the acquisition index.
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraRoiCounterTable::prepareAcq()
+{
+    lima::AutoMutex table_mutex = tableLock();
+
+    // a frame interrupted by an error is forgotten
+    m_frame_opened = false;
+
+    __sync_fetch_and_add(&m_acquisition_nb, 1);
+    __sync_lock_test_and_set(&m_last_frame_end, 0);
+}
+
+/****************************************************************************************************
+ * \fn void prepareAreas(std::size_t in_width, std::size_t in_height)
+ * \brief  clip the ROIs to a frame size and convert their masks (the caller must hold the lock)
+ * \param  in_width frame width in pixels
+ * \param  in_height frame height in pixels
+ * \return none
+ ****************************************************************************************************/
+void CameraRoiCounterTable::prepareAreas(std::size_t in_width, std::size_t in_height)
+{
+    m_areas.resize(m_rois.size());
+
+    for(std::size_t roi_index = 0 ; roi_index < m_rois.size() ; roi_index++)
+    {
+        const CameraCounterRoi & roi  = m_rois [roi_index];
+        Area                   & area = m_areas[roi_index];
+
+        area.m_first_x = std::min(roi.m_x, in_width );
+        area.m_end_x   = std::min(roi.m_x + roi.m_width , in_width );
+        area.m_first_y = std::min(roi.m_y, in_height);
+        area.m_end_y   = std::min(roi.m_y + roi.m_height, in_height);
+
+        std::size_t area_width  = area.m_end_x - area.m_first_x;
+        std::size_t area_height = area.m_end_y - area.m_first_y;
+
+        area.m_mask.clear();
+
+        if(roi.m_mask.empty())
+        {
+            area.m_pixels_nb = static_cast<uint32_t>(area_width * area_height);
+            continue;
+        }
+
+        // the mask values become 16 bits masks of the pixels, so the sum needs no test
+        area.m_mask.resize(area_width * area_height);
+        area.m_pixels_nb = 0;
+
+        for(std::size_t y = 0 ; y < area_height ; y++)
+        {
+            const uint8_t * source = &roi.m_mask[(y + area.m_first_y - roi.m_y) * roi.m_width + (area.m_first_x - roi.m_x)];
+            uint16_t      * mask   = &area.m_mask[y * area_width];
+
+            for(std::size_t x = 0 ; x < area_width ; x++)
+            {
+                mask[x] = (source[x] != 0) ? 0xFFFF : 0;
+                area.m_pixels_nb += (source[x] != 0) ? 1 : 0;
+            }
+        }
+    }
+
+    m_accumulators.resize(m_rois.size());
+
+    m_areas_width  = in_width ;
+    m_areas_height = in_height;
+    m_areas_valid  = true     ;
+}
+
+/****************************************************************************************************
+ * \fn void sumSegment(const uint16_t * in_data, const uint16_t * in_mask, std::size_t in_pixels_nb, CameraRoiCounter & in_out_counter)
+ * \brief  add the values of a row segment to the sum and the maximum of a counter.
+ *         With SSE2, eight pixels are masked, widened and added at once. SSE2 has no unsigned
+ *         16 bits maximum, so the values are biased to use the signed one.
+ * \param  in_data first pixel of the segment
+ * \param  in_mask 16 bits mask of each pixel (NULL to count all the pixels)
+ * \param  in_pixels_nb number of pixels of the segment
+ * \param  in_out_counter counter to update
+ * \return none
+ ****************************************************************************************************/
+void CameraRoiCounterTable::sumSegment(const uint16_t   * in_data     ,
+                                       const uint16_t   * in_mask     ,
+                                       std::size_t        in_pixels_nb,
+                                       CameraRoiCounter & in_out_counter)
+{
+    std::size_t x   = 0;
+    uint64_t    sum = 0;
+    uint32_t    max = in_out_counter.m_max;
+
+#if defined(__SSE2__)
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i bias = _mm_set1_epi16(static_cast<short>(0x8000));
+    __m128i       maxs = bias;
+
+    while((x + 8) <= in_pixels_nb)
+    {
+        // each 32 bits lane receives two values by step: no overflow before 32768 steps
+        std::size_t end  = std::min(in_pixels_nb - ((in_pixels_nb - x) % 8), x + 8 * 16384);
+        __m128i     sums = zero;
+
+        for( ; x < end ; x += 8)
+        {
+            __m128i values = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_data + x));
+
+            if(in_mask != NULL)
+            {
+                values = _mm_and_si128(values, _mm_loadu_si128(reinterpret_cast<const __m128i *>(in_mask + x)));
+            }
+
+            maxs = _mm_max_epi16(maxs, _mm_xor_si128(values, bias));
+            sums = _mm_add_epi32(sums, _mm_add_epi32(_mm_unpacklo_epi16(values, zero), _mm_unpackhi_epi16(values, zero)));
+        }
+
+        uint32_t lanes[4];
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(lanes), sums);
+        sum += static_cast<uint64_t>(lanes[0]) + lanes[1] + lanes[2] + lanes[3];
+    }
+
+    maxs = _mm_max_epi16(maxs, _mm_shuffle_epi32(maxs, _MM_SHUFFLE(1, 0, 3, 2)));
+    maxs = _mm_max_epi16(maxs, _mm_shuffle_epi32(maxs, _MM_SHUFFLE(2, 3, 0, 1)));
+    maxs = _mm_max_epi16(maxs, _mm_shufflelo_epi16(maxs, _MM_SHUFFLE(2, 3, 0, 1)));
+
+    max = std::max(max, static_cast<uint32_t>(static_cast<uint16_t>(_mm_cvtsi128_si32(maxs)) ^ 0x8000));
+#endif
+
+    for( ; x < in_pixels_nb ; x++)
+    {
+        uint32_t value = (in_mask != NULL) ? (in_data[x] & in_mask[x]) : in_data[x];
+
+        sum += value;
+        max  = std::max(max, value);
+    }
+
+    in_out_counter.m_sum += sum;
+    in_out_counter.m_max  = max;
+}
+
+/****************************************************************************************************
+ * \fn void rowsCompleted(const CameraRowBand & in_band)
+ * \brief  sum a band of completed rows into the counters of the frame (called by the
+ *         acquisition thread just after the copy of the rows). The counters are published
+ *         with the last band of the frame.
+ * \param  in_band band of completed rows
+ * \return none
+ ****************************************************************************************************/
+void CameraRoiCounterTable::rowsCompleted(const CameraRowBand & in_band)
+{
+    lima::AutoMutex table_mutex = tableLock();
+
+    if((!m_enabled) || (m_rois.empty()))
+        return;
+
+    // first band of a frame
+    if((!m_frame_opened) || (m_frame_nb != in_band.m_frame_nb))
+    {
+        if((!m_areas_valid) || (m_areas_width != in_band.m_width) || (m_areas_height != in_band.m_height))
+        {
+            prepareAreas(in_band.m_width, in_band.m_height);
+        }
+
+        for(std::size_t roi_index = 0 ; roi_index < m_areas.size() ; roi_index++)
+        {
+            m_accumulators[roi_index].m_sum       = 0;
+            m_accumulators[roi_index].m_max       = 0;
+            m_accumulators[roi_index].m_pixels_nb = m_areas[roi_index].m_pixels_nb;
+        }
+
+        m_frame_opened = true;
+        m_frame_nb     = in_band.m_frame_nb;
+    }
+
+    std::size_t band_end = in_band.m_first_row + in_band.m_rows_nb;
+
+    for(std::size_t roi_index = 0 ; roi_index < m_areas.size() ; roi_index++)
+    {
+        const Area       & area       = m_areas[roi_index];
+        std::size_t        area_width = area.m_end_x - area.m_first_x;
+        std::size_t        first_row  = std::max(area.m_first_y, in_band.m_first_row);
+        std::size_t        end_row    = std::min(area.m_end_y  , band_end);
+        CameraRoiCounter & counter    = m_accumulators[roi_index];
+
+        for(std::size_t row = first_row ; row < end_row ; row++)
+        {
+            const uint16_t * mask = (area.m_mask.empty()) ? NULL : &area.m_mask[(row - area.m_first_y) * area_width];
+
+            sumSegment(in_band.m_data + row * in_band.m_width + area.m_first_x, mask, area_width, counter);
+        }
+    }
+
+    if(in_band.m_last)
+    {
+        publishFrame();
+        m_frame_opened = false;
+    }
+}
+
+/****************************************************************************************************
+ * \fn void publishFrame()
+ * \brief  write the counters of the current frame into the ring (the caller must hold the lock).
+ *         A frame dropped by the processing stages is published too: its record is replaced by
+ *         the next frame which reuses its number.
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraRoiCounterTable::publishFrame()
+{
+    std::size_t index    = m_frame_nb % g_ring_size;
+    uint32_t  & sequence = m_sequences[index];
+
+    // odd sequence: the record is being written
+    if((sequence & 1) == 0)
+    {
+        __sync_fetch_and_add(&sequence, 1);
+    }
+
+    m_frame_nbs      [index] = static_cast<uint64_t>(m_frame_nb);
+    m_acquisition_nbs[index] = __sync_fetch_and_add(&m_acquisition_nb, 0);
+    m_rois_nbs       [index] = static_cast<uint32_t>(m_accumulators.size());
+
+    std::copy(m_accumulators.begin(), m_accumulators.end(), m_counters.begin() + index * g_max_rois_nb);
+
+    // the full barrier of the builtin orders the record writes before the sequence change
+    __sync_fetch_and_add(&sequence, 1);
+
+    __sync_lock_test_and_set(&m_last_frame_end, static_cast<uint64_t>(m_frame_nb) + 1);
+}
+
+/****************************************************************************************************
+ * \fn bool getFrameCounters(std::size_t in_frame_nb, CameraRoiFrameCounters & out_counters) const
+ * \brief  get a copy of the counters of a frame of the current acquisition, without locking.
+ *         Only the latest frames are kept.
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  out_counters copy of the frame counters
+ * \return true if the frame counters are available, false if the frame is unknown
+ ****************************************************************************************************/
+bool CameraRoiCounterTable::getFrameCounters(std::size_t in_frame_nb, CameraRoiFrameCounters & out_counters) const
+{
+    std::size_t      index    = in_frame_nb % g_ring_size;
+    uint32_t       * sequence = const_cast<uint32_t *>(&m_sequences[index]);
+    const uint32_t   before   = __sync_fetch_and_add(sequence, 0);
+
+    if((before & 1) != 0)
+        return false;
+
+    uint64_t    frame_nb       = m_frame_nbs      [index];
+    uint32_t    acquisition_nb = m_acquisition_nbs[index];
+    std::size_t rois_nb        = std::min(static_cast<std::size_t>(m_rois_nbs[index]), g_max_rois_nb);
+
+    std::vector<CameraRoiCounter>::const_iterator first = m_counters.begin() + index * g_max_rois_nb;
+    out_counters.m_counters.assign(first, first + rois_nb);
+    out_counters.m_frame_nb = in_frame_nb;
+
+    const uint32_t after = __sync_fetch_and_add(sequence, 0);
+
+    return (before         == after                                                                 ) &&
+           (frame_nb       == static_cast<uint64_t>(in_frame_nb)                                    ) &&
+           (acquisition_nb == __sync_fetch_and_add(const_cast<uint32_t *>(&m_acquisition_nb), 0));
+}
+
+/****************************************************************************************************
+ * \fn bool getLastFrameCounters(CameraRoiFrameCounters & out_counters) const
+ * \brief  get a copy of the counters of the last frame of the current acquisition, without locking
+ * \param  out_counters copy of the frame counters
+ * \return false if no frame was counted in the acquisition
+ ****************************************************************************************************/
+bool CameraRoiCounterTable::getLastFrameCounters(CameraRoiFrameCounters & out_counters) const
+{
+    // a new frame can be published during the copy: the next last frame is then read
+    for(int attempt = 0 ; attempt < 4 ; attempt++)
+    {
+        uint64_t frame_end = __sync_fetch_and_add(const_cast<uint64_t *>(&m_last_frame_end), 0);
+
+        if(frame_end == 0)
+            return false;
+
+        if(getFrameCounters(static_cast<std::size_t>(frame_end - 1), out_counters))
+            return true;
+    }
+
+    return false;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getMaxRoisNb()
+ * \brief  get the maximum number of ROIs
+ * \param  none
+ * \return maximum number of ROIs
+ ****************************************************************************************************/
+std::size_t CameraRoiCounterTable::getMaxRoisNb()
+{
+    return g_max_rois_nb;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraRoiCounterTable::create()
+{
+    init(new CameraRoiCounterTable());
+}
+
+//###########################################################################
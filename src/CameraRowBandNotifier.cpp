@@ -0,0 +1,358 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraRowBandNotifier.cpp
+ * \brief  implementation file of the progressive row bands notifier.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraRowBandNotifier.h"
+
+// SYSTEM
+#include <algorithm>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraRowBandNotifier::g_default_band_rows = 32;
+
+/****************************************************************************************************
+ * \fn CameraRowBandNotifier()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraRowBandNotifier::CameraRowBandNotifier()
+{
+    DEB_CONSTRUCTOR();
+
+    m_band_rows = g_default_band_rows;
+    m_bands_nb  = 0;
+
+    m_data              = NULL;
+    m_width             = 0   ;
+    m_height            = 0   ;
+    m_source_width      = 0   ;
+    m_source_height     = 0   ;
+    m_frame_nb          = 0   ;
+    m_orientation       = CameraFrameTransform::Normal;
+    m_contiguous_pixels = 0   ;
+    m_notified_rows     = 0   ;
+}
+
+/****************************************************************************************************
+ * \fn ~CameraRowBandNotifier()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraRowBandNotifier::~CameraRowBandNotifier()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex notifierLock() const
+ * \brief  creates an autolock mutex for the notifier data access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraRowBandNotifier::notifierLock() const
+{
+    return lima::AutoMutex(m_notifier_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn void addListener(CameraRowBandListener * in_listener)
+ * \brief  add a listener (owned by the caller)
+ * \param  in_listener listener to add
+ * \return none
+ ****************************************************************************************************/
+void CameraRowBandNotifier::addListener(CameraRowBandListener * in_listener)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex notifier_mutex = notifierLock();
+
+    if(std::find(m_listeners.begin(), m_listeners.end(), in_listener) == m_listeners.end())
+    {
+        m_listeners.push_back(in_listener);
+    }
+}
+
+/****************************************************************************************************
+ * \fn void removeListener(CameraRowBandListener * in_listener)
+ * \brief  remove a listener (it is not called anymore when this method returns)
+ * \param  in_listener listener to remove
+ * \return none
+ ****************************************************************************************************/
+void CameraRowBandNotifier::removeListener(CameraRowBandListener * in_listener)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex notifier_mutex = notifierLock();
+
+    std::vector<CameraRowBandListener *>::iterator it = std::find(m_listeners.begin(), m_listeners.end(), in_listener);
+
+    if(it != m_listeners.end())
+    {
+        m_listeners.erase(it);
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool hasListeners() const
+ * \brief  check if there is at least one listener
+ * \param  none
+ * \return true if the bands are given to a listener
+ ****************************************************************************************************/
+bool CameraRowBandNotifier::hasListeners() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex notifier_mutex = notifierLock();
+
+    return !m_listeners.empty();
+}
+
+/****************************************************************************************************
+ * \fn bool setBandRows(std::size_t in_band_rows)
+ * \brief  set the minimum number of rows of a band (except the last one of a frame)
+ * \param  in_band_rows number of rows (at least 1)
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraRowBandNotifier::setBandRows(std::size_t in_band_rows)
+{
+    if(in_band_rows == 0)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex notifier_mutex = notifierLock();
+
+    m_band_rows = in_band_rows;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getBandRows() const
+ * \brief  get the minimum number of rows of a band
+ * \param  none
+ * \return number of rows
+ ****************************************************************************************************/
+std::size_t CameraRowBandNotifier::getBandRows() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex notifier_mutex = notifierLock();
+
+    return m_band_rows;
+}
+
+/****************************************************************************************************
+ * \fn uint64_t getBandsNb() const
+ * \brief  get the number of bands given to the listeners since the creation
+ * \param  none
+ * \return number of bands
+ ****************************************************************************************************/
+uint64_t CameraRowBandNotifier::getBandsNb() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex notifier_mutex = notifierLock();
+
+    return m_bands_nb;
+}
+
+/****************************************************************************************************
+ * \fn void startFrame(const uint16_t * in_data, std::size_t in_width, std::size_t in_height, std::size_t in_frame_nb, const CameraFrameTransform & in_transform)
+ * \brief  start the reception of a frame (called by the acquisition thread)
+ * \param  in_data frame pixels
+ * \param  in_width frame width in pixels (orientation applied)
+ * \param  in_height frame height in pixels (orientation applied)
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  in_transform orientation applied during the copy of the image parts
+ * \return none
+ ****************************************************************************************************/
+void CameraRowBandNotifier::startFrame(const uint16_t             * in_data     ,
+                                       std::size_t                  in_width    ,
+                                       std::size_t                  in_height   ,
+                                       std::size_t                  in_frame_nb ,
+                                       const CameraFrameTransform & in_transform)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex notifier_mutex = notifierLock();
+
+    m_data          = in_data    ;
+    m_width         = in_width   ;
+    m_height        = in_height  ;
+    m_frame_nb      = in_frame_nb;
+    m_orientation   = in_transform.getOrientation();
+    m_source_width  = in_transform.swapsAxes() ? in_height : in_width ;
+    m_source_height = in_transform.swapsAxes() ? in_width  : in_height;
+
+    m_contiguous_pixels = 0;
+    m_notified_rows     = 0;
+    m_pending_parts.clear();
+}
+
+/****************************************************************************************************
+ * \fn void addPart(std::size_t in_offset, std::size_t in_pixels_nb)
+ * \brief  declare a copied image part and give the new completed rows to the listeners
+ *         when they fill a band (called by the acquisition thread)
+ * \param  in_offset offset of the first pixel of the part in the source image
+ * \param  in_pixels_nb number of pixels of the part
+ * \return none
+ ****************************************************************************************************/
+void CameraRowBandNotifier::addPart(std::size_t in_offset, std::size_t in_pixels_nb)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex notifier_mutex = notifierLock();
+
+    if((m_data == NULL) || (m_source_width == 0))
+        return;
+
+    // the parts are sent in the offset order, a part after a gap waits for the missing pixels
+    if(in_offset > m_contiguous_pixels)
+    {
+        m_pending_parts[in_offset] = std::max(m_pending_parts[in_offset], in_offset + in_pixels_nb);
+        return;
+    }
+
+    m_contiguous_pixels = std::max(m_contiguous_pixels, in_offset + in_pixels_nb);
+
+    while((!m_pending_parts.empty()) && (m_pending_parts.begin()->first <= m_contiguous_pixels))
+    {
+        m_contiguous_pixels = std::max(m_contiguous_pixels, m_pending_parts.begin()->second);
+        m_pending_parts.erase(m_pending_parts.begin());
+    }
+
+    std::size_t completed_rows = computeCompletedRows();
+
+    if(completed_rows >= m_notified_rows + m_band_rows)
+    {
+        notifyRows(completed_rows);
+    }
+}
+
+/****************************************************************************************************
+ * \fn void endFrame()
+ * \brief  give the last rows of a completely received frame (called by the acquisition thread)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraRowBandNotifier::endFrame()
+{
+    // protecting the multi-threads access
+    lima::AutoMutex notifier_mutex = notifierLock();
+
+    if(m_data == NULL)
+        return;
+
+    notifyRows(m_height);
+
+    m_data = NULL;
+    m_pending_parts.clear();
+}
+
+/****************************************************************************************************
+ * \fn std::size_t computeCompletedRows() const
+ * \brief  compute the number of completed rows of the oriented frame (the caller must hold the lock)
+ * \param  none
+ * \return number of completed rows
+ ****************************************************************************************************/
+std::size_t CameraRowBandNotifier::computeCompletedRows() const
+{
+    std::size_t source_rows = std::min(m_contiguous_pixels / m_source_width, m_source_height);
+
+    switch(m_orientation)
+    {
+        // the source rows are the frame rows (from the top or from the bottom)
+        case CameraFrameTransform::Normal   :
+        case CameraFrameTransform::FlipX    :
+        case CameraFrameTransform::FlipY    :
+        case CameraFrameTransform::Rotate180:
+            return source_rows;
+
+        // the source rows are the frame columns
+        default:
+            return (source_rows == m_source_height) ? m_height : 0;
+    }
+}
+
+/****************************************************************************************************
+ * \fn void notifyRows(std::size_t in_completed_rows)
+ * \brief  give the completed rows which were not yet given to the listeners
+ *         (the caller must hold the lock)
+ * \param  in_completed_rows number of completed rows of the oriented frame
+ * \return none
+ ****************************************************************************************************/
+void CameraRowBandNotifier::notifyRows(std::size_t in_completed_rows)
+{
+    if((in_completed_rows <= m_notified_rows) || (m_listeners.empty()))
+    {
+        m_notified_rows = std::max(m_notified_rows, in_completed_rows);
+        return;
+    }
+
+    CameraRowBand band;
+
+    band.m_data     = m_data    ;
+    band.m_width    = m_width   ;
+    band.m_height   = m_height  ;
+    band.m_rows_nb  = in_completed_rows - m_notified_rows;
+    band.m_frame_nb = m_frame_nb;
+    band.m_last     = (in_completed_rows >= m_height);
+
+    // the vertical mirrors complete the frame from the bottom
+    if((m_orientation == CameraFrameTransform::FlipY) || (m_orientation == CameraFrameTransform::Rotate180))
+    {
+        band.m_first_row = m_height - in_completed_rows;
+    }
+    else
+    {
+        band.m_first_row = m_notified_rows;
+    }
+
+    for(std::size_t listener_index = 0 ; listener_index < m_listeners.size() ; listener_index++)
+    {
+        m_listeners[listener_index]->rowsCompleted(band);
+    }
+
+    m_notified_rows = in_completed_rows;
+    m_bands_nb++;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraRowBandNotifier::create()
+{
+    init(new CameraRowBandNotifier());
+}
+
+//###########################################################################
@@ -0,0 +1,571 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraSoakMonitor.cpp
+ * \brief  implementation file of the long-running resources and latencies monitor.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraSoakMonitor.h"
+#include "CameraControl.h"
+#include "NetPackets.h"
+
+// SYSTEM
+#include <fstream>
+#include <unistd.h>
+#include <time.h>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraSoakMonitor::g_max_samples_nb       = 4096;
+const std::size_t CameraSoakMonitor::g_min_samples_nb       = 8   ;
+const double      CameraSoakMonitor::g_monotonic_ratio      = 0.9 ;
+const double      CameraSoakMonitor::g_default_interval_sec = 10.0;
+const double      CameraSoakMonitor::g_default_growth_ratio = 0.1 ;
+const double      CameraSoakMonitor::g_default_drift_ratio  = 0.25;
+
+/****************************************************************************************************
+ * \fn CameraSoakMonitor()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraSoakMonitor::CameraSoakMonitor()
+{
+    DEB_CONSTRUCTOR();
+
+    m_enabled             = false;
+    m_sample_interval_sec = g_default_interval_sec;
+    m_growth_ratio        = g_default_growth_ratio;
+    m_drift_ratio         = g_default_drift_ratio ;
+
+    reset();
+}
+
+/****************************************************************************************************
+ * \fn ~CameraSoakMonitor()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraSoakMonitor::~CameraSoakMonitor()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex monitorLock() const
+ * \brief  creates an autolock mutex for the monitor data access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraSoakMonitor::monitorLock() const
+{
+    return lima::AutoMutex(m_monitor_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn void setEnabled(bool in_enabled)
+ * \brief  enable or disable the sampling (the samples are kept)
+ * \param  in_enabled true to enable the sampling
+ * \return none
+ ****************************************************************************************************/
+void CameraSoakMonitor::setEnabled(bool in_enabled)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    m_enabled = in_enabled;
+}
+
+/****************************************************************************************************
+ * \fn bool isEnabled() const
+ * \brief  check if the sampling is enabled
+ * \param  none
+ * \return true if the sampling is enabled
+ ****************************************************************************************************/
+bool CameraSoakMonitor::isEnabled() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    return m_enabled;
+}
+
+/****************************************************************************************************
+ * \fn void reset()
+ * \brief  remove the samples and restart the monitoring time
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraSoakMonitor::reset()
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    m_samples.clear();
+
+    m_current_interval_sec = m_sample_interval_sec;
+    m_start_time_sec       = getMonotonicTimeSec();
+    m_last_sample_sec      = 0.0;
+    m_latency_sum_sec      = 0.0;
+    m_latencies_nb         = 0  ;
+    m_period_sum_sec       = 0.0;
+    m_periods_nb           = 0  ;
+    m_last_frame_sec       = 0.0;
+}
+
+/****************************************************************************************************
+ * \fn bool setSampleIntervalSec(double in_interval_sec)
+ * \brief  set the interval between two samples (used from the next reset)
+ * \param  in_interval_sec interval in seconds
+ * \return true if the value is correct
+ ****************************************************************************************************/
+bool CameraSoakMonitor::setSampleIntervalSec(double in_interval_sec)
+{
+    if(in_interval_sec <= 0.0)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    m_sample_interval_sec = in_interval_sec;
+
+    if(m_samples.empty())
+    {
+        m_current_interval_sec = in_interval_sec;
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn double getSampleIntervalSec() const
+ * \brief  get the interval between two samples
+ * \param  none
+ * \return interval in seconds
+ ****************************************************************************************************/
+double CameraSoakMonitor::getSampleIntervalSec() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    return m_sample_interval_sec;
+}
+
+/****************************************************************************************************
+ * \fn bool setThresholds(double in_growth_ratio, double in_drift_ratio)
+ * \brief  set the detection thresholds
+ * \param  in_growth_ratio relative growth of a resource needed to flag it (0.1 for 10%)
+ * \param  in_drift_ratio relative increase of a latency needed to flag it (0.25 for 25%)
+ * \return true if the values are correct
+ ****************************************************************************************************/
+bool CameraSoakMonitor::setThresholds(double in_growth_ratio, double in_drift_ratio)
+{
+    if((in_growth_ratio <= 0.0) || (in_drift_ratio <= 0.0))
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    m_growth_ratio = in_growth_ratio;
+    m_drift_ratio  = in_drift_ratio ;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void getThresholds(double & out_growth_ratio, double & out_drift_ratio) const
+ * \brief  get the detection thresholds
+ * \param  out_growth_ratio relative growth of a resource needed to flag it
+ * \param  out_drift_ratio relative increase of a latency needed to flag it
+ * \return none
+ ****************************************************************************************************/
+void CameraSoakMonitor::getThresholds(double & out_growth_ratio, double & out_drift_ratio) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    out_growth_ratio = m_growth_ratio;
+    out_drift_ratio  = m_drift_ratio ;
+}
+
+/****************************************************************************************************
+ * \fn void addCommandLatency(double in_duration_sec)
+ * \brief  add the duration of a data update (called by the data update thread)
+ * \param  in_duration_sec duration in seconds
+ * \return none
+ ****************************************************************************************************/
+void CameraSoakMonitor::addCommandLatency(double in_duration_sec)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    if(!m_enabled)
+        return;
+
+    m_latency_sum_sec += in_duration_sec;
+    m_latencies_nb++;
+}
+
+/****************************************************************************************************
+ * \fn void addFrame(std::size_t in_frame_nb, double in_time_sec)
+ * \brief  add the end time of a completed frame (called by the acquisition thread).
+ *         The first frame of an acquisition does not give a period.
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  in_time_sec end time of the frame in seconds
+ * \return none
+ ****************************************************************************************************/
+void CameraSoakMonitor::addFrame(std::size_t in_frame_nb, double in_time_sec)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    if(!m_enabled)
+        return;
+
+    if((in_frame_nb > 0) && (m_last_frame_sec > 0.0) && (in_time_sec > m_last_frame_sec))
+    {
+        m_period_sum_sec += in_time_sec - m_last_frame_sec;
+        m_periods_nb++;
+    }
+
+    m_last_frame_sec = in_time_sec;
+}
+
+/****************************************************************************************************
+ * \fn void sample()
+ * \brief  take a sample if the interval is elapsed (called by the data update thread)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraSoakMonitor::sample()
+{
+    // the values are read without holding the lock
+    {
+        lima::AutoMutex monitor_mutex = monitorLock();
+
+        if(!m_enabled)
+            return;
+
+        double now = getMonotonicTimeSec();
+
+        if((m_last_sample_sec > 0.0) && (now - m_last_sample_sec < m_current_interval_sec))
+            return;
+
+        m_last_sample_sec = now;
+    }
+
+    CameraSoakSample sample;
+
+    sample.m_values[SoakResidentMemory] = readResidentMemory();
+    sample.m_values[SoakLivePackets   ] = static_cast<double>(NetGenericHeader::getLiveInstancesNb());
+    sample.m_values[SoakPendingPackets] = static_cast<double>(CameraControl::getConstInstance()->getPendingPacketsNb());
+    sample.m_values[SoakReceiveQueue  ] = static_cast<double>(CameraControl::getConstInstance()->getReceiveQueueBytes());
+    sample.m_created_packets            = static_cast<double>(NetGenericHeader::getCreatedInstancesNb());
+
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    sample.m_time_sec = m_last_sample_sec - m_start_time_sec;
+
+    sample.m_values[SoakCommandLatency] = (m_latencies_nb > 0) ? (m_latency_sum_sec / static_cast<double>(m_latencies_nb)) : 0.0;
+    sample.m_values[SoakFramePeriod   ] = (m_periods_nb   > 0) ? (m_period_sum_sec  / static_cast<double>(m_periods_nb  )) : 0.0;
+
+    m_latency_sum_sec = 0.0;
+    m_latencies_nb    = 0  ;
+    m_period_sum_sec  = 0.0;
+    m_periods_nb      = 0  ;
+
+    // one sample out of two is removed when the buffer is full
+    if(m_samples.size() >= g_max_samples_nb)
+    {
+        std::size_t kept_nb = 0;
+
+        for(std::size_t sample_index = 0 ; sample_index < m_samples.size() ; sample_index += 2)
+        {
+            m_samples[kept_nb++] = m_samples[sample_index];
+        }
+
+        m_samples.resize(kept_nb);
+        m_current_interval_sec *= 2.0;
+    }
+
+    m_samples.push_back(sample);
+}
+
+/****************************************************************************************************
+ * \fn void getSamples(std::vector<CameraSoakSample> & out_samples) const
+ * \brief  get a copy of the samples
+ * \param  out_samples samples in the time order
+ * \return none
+ ****************************************************************************************************/
+void CameraSoakMonitor::getSamples(std::vector<CameraSoakSample> & out_samples) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    out_samples = m_samples;
+}
+
+/****************************************************************************************************
+ * \fn bool analyze(std::vector<CameraSoakDrift> & out_drifts) const
+ * \brief  analyse the series. A resource is flagged when it grows almost monotonically by more
+ *         than the growth ratio, a latency when the mean of the last quarter of the samples
+ *         exceeds the mean of the first quarter by more than the drift ratio.
+ * \param  out_drifts analysis of each series
+ * \return true if a growth or a drift is detected
+ ****************************************************************************************************/
+bool CameraSoakMonitor::analyze(std::vector<CameraSoakDrift> & out_drifts) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    bool flagged = false;
+
+    out_drifts.resize(SoakSeriesNb);
+
+    for(int series = 0 ; series < SoakSeriesNb ; series++)
+    {
+        analyzeSeries(static_cast<CameraSoakSeries>(series), out_drifts[series]);
+
+        flagged = flagged || out_drifts[series].m_flagged;
+    }
+
+    return flagged;
+}
+
+/****************************************************************************************************
+ * \fn void analyzeSeries(CameraSoakSeries in_series, CameraSoakDrift & out_drift) const
+ * \brief  analyse a series (the caller must hold the lock)
+ * \param  in_series series to analyse
+ * \param  out_drift analysis of the series
+ * \return none
+ ****************************************************************************************************/
+void CameraSoakMonitor::analyzeSeries(CameraSoakSeries in_series, CameraSoakDrift & out_drift) const
+{
+    const bool latency = (in_series == SoakCommandLatency) || (in_series == SoakFramePeriod);
+
+    std::vector<double> times ;
+    std::vector<double> values;
+
+    // a latency without measure during a sample interval is not used
+    for(std::size_t sample_index = 0 ; sample_index < m_samples.size() ; sample_index++)
+    {
+        double value = m_samples[sample_index].m_values[in_series];
+
+        if((!latency) || (value > 0.0))
+        {
+            times .push_back(m_samples[sample_index].m_time_sec / 3600.0);
+            values.push_back(value);
+        }
+    }
+
+    out_drift.m_series         = in_series;
+    out_drift.m_samples_nb     = values.size();
+    out_drift.m_start_value    = 0.0  ;
+    out_drift.m_end_value      = 0.0  ;
+    out_drift.m_slope_per_hour = 0.0  ;
+    out_drift.m_rising_ratio   = 0.0  ;
+    out_drift.m_flagged        = false;
+
+    if(values.size() < g_min_samples_nb)
+        return;
+
+    const std::size_t samples_nb = values.size();
+    const std::size_t quarter_nb = samples_nb / 4;
+
+    double time_mean  = 0.0;
+    double value_mean = 0.0;
+    double rising_nb  = 0.0;
+
+    for(std::size_t index = 0 ; index < samples_nb ; index++)
+    {
+        time_mean  += times [index];
+        value_mean += values[index];
+
+        if(index < quarter_nb)
+            out_drift.m_start_value += values[index];
+
+        if(index >= samples_nb - quarter_nb)
+            out_drift.m_end_value += values[index];
+
+        if((index > 0) && (values[index] >= values[index - 1]))
+            rising_nb += 1.0;
+    }
+
+    time_mean  /= static_cast<double>(samples_nb);
+    value_mean /= static_cast<double>(samples_nb);
+
+    out_drift.m_start_value  /= static_cast<double>(quarter_nb);
+    out_drift.m_end_value    /= static_cast<double>(quarter_nb);
+    out_drift.m_rising_ratio  = rising_nb / static_cast<double>(samples_nb - 1);
+
+    // least squares slope
+    double covariance = 0.0;
+    double variance   = 0.0;
+
+    for(std::size_t index = 0 ; index < samples_nb ; index++)
+    {
+        covariance += (times[index] - time_mean) * (values[index] - value_mean);
+        variance   += (times[index] - time_mean) * (times [index] - time_mean );
+    }
+
+    out_drift.m_slope_per_hour = (variance > 0.0) ? (covariance / variance) : 0.0;
+
+    if(out_drift.m_slope_per_hour <= 0.0)
+        return;
+
+    if(latency)
+    {
+        out_drift.m_flagged = (out_drift.m_end_value > out_drift.m_start_value * (1.0 + m_drift_ratio));
+    }
+    else
+    {
+        // a resource starting from 0 (packets, queue) is compared with one unit
+        double reference = (out_drift.m_start_value > 1.0) ? out_drift.m_start_value : 1.0;
+
+        out_drift.m_flagged = (out_drift.m_rising_ratio >= g_monotonic_ratio) &&
+                              (out_drift.m_end_value - out_drift.m_start_value > reference * m_growth_ratio);
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool writeSamples(const std::string & in_file_name) const
+ * \brief  write the samples into a CSV file (one line by sample, one column by series)
+ * \param  in_file_name complete file name
+ * \return true if succeed, false if the file can not be written
+ ****************************************************************************************************/
+bool CameraSoakMonitor::writeSamples(const std::string & in_file_name) const
+{
+    DEB_MEMBER_FUNCT();
+
+    std::vector<CameraSoakSample> samples;
+    getSamples(samples);
+
+    std::ofstream file(in_file_name.c_str());
+
+    if(!file.is_open())
+    {
+        DEB_ERROR() << "CameraSoakMonitor::writeSamples - Can not create the file " << in_file_name << "!";
+        return false;
+    }
+
+    // the memory values need more than the default 6 digits
+    file.precision(12);
+
+    file << "time_sec";
+
+    for(int series = 0 ; series < SoakSeriesNb ; series++)
+    {
+        file << "," << getSeriesName(static_cast<CameraSoakSeries>(series));
+    }
+
+    file << ",created_packets\n";
+
+    for(std::size_t sample_index = 0 ; sample_index < samples.size() ; sample_index++)
+    {
+        file << samples[sample_index].m_time_sec;
+
+        for(int series = 0 ; series < SoakSeriesNb ; series++)
+        {
+            file << "," << samples[sample_index].m_values[series];
+        }
+
+        file << "," << samples[sample_index].m_created_packets << "\n";
+    }
+
+    return file.good();
+}
+
+/****************************************************************************************************
+ * \fn const char * getSeriesName(CameraSoakSeries in_series)
+ * \brief  get the name of a series
+ * \param  in_series series
+ * \return name
+ ****************************************************************************************************/
+const char * CameraSoakMonitor::getSeriesName(CameraSoakSeries in_series)
+{
+    switch(in_series)
+    {
+        case SoakResidentMemory: return "resident_memory_bytes";
+        case SoakLivePackets   : return "live_packets"         ;
+        case SoakPendingPackets: return "pending_packets"      ;
+        case SoakReceiveQueue  : return "receive_queue_bytes"  ;
+        case SoakCommandLatency: return "command_latency_sec"  ;
+        case SoakFramePeriod   : return "frame_period_sec"     ;
+        default                : return "unknown"              ;
+    }
+}
+
+/****************************************************************************************************
+ * \fn double readResidentMemory()
+ * \brief  read the resident memory of the process (/proc/self/statm)
+ * \param  none
+ * \return resident memory in bytes (0 in case of error)
+ ****************************************************************************************************/
+double CameraSoakMonitor::readResidentMemory()
+{
+    std::ifstream file("/proc/self/statm");
+    uint64_t      size_pages     = 0;
+    uint64_t      resident_pages = 0;
+
+    if(!(file >> size_pages >> resident_pages))
+        return 0.0;
+
+    return static_cast<double>(resident_pages) * static_cast<double>(sysconf(_SC_PAGESIZE));
+}
+
+/****************************************************************************************************
+ * \fn double getMonotonicTimeSec()
+ * \brief  get the monotonic time in seconds
+ * \param  none
+ * \return time in seconds
+ ****************************************************************************************************/
+double CameraSoakMonitor::getMonotonicTimeSec()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) / 1000000000.0;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraSoakMonitor::create()
+{
+    init(new CameraSoakMonitor());
+}
+
+//###########################################################################
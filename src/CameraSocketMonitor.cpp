@@ -0,0 +1,236 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraSocketMonitor.cpp
+ * \brief  implementation file of the socket backlog and reception lag monitor.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraSocketMonitor.h"
+#include "CameraControl.h"
+
+// SYSTEM
+#include <cstring>
+#include <netinet/tcp.h>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+/****************************************************************************************************
+ * \fn CameraSocketMonitor()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraSocketMonitor::CameraSocketMonitor()
+{
+    DEB_CONSTRUCTOR();
+
+    memset(&m_gauges    , 0, sizeof(CameraSocketGauges    ));
+    memset(&m_histograms, 0, sizeof(CameraSocketHistograms));
+}
+
+/****************************************************************************************************
+ * \fn ~CameraSocketMonitor()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraSocketMonitor::~CameraSocketMonitor()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex monitorLock() const
+ * \brief  creates an autolock mutex for the monitor data access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraSocketMonitor::monitorLock() const
+{
+    return lima::AutoMutex(m_monitor_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn void addToHistogram(uint64_t * in_out_histogram, uint64_t in_value)
+ * \brief  add a value into a log2 histogram
+ * \param  in_out_histogram histogram bins
+ * \param  in_value value to add
+ * \return none
+ ****************************************************************************************************/
+void CameraSocketMonitor::addToHistogram(uint64_t * in_out_histogram, uint64_t in_value)
+{
+    std::size_t bin = 0;
+
+    // the bin is the number of significant bits of the value
+    while((in_value != 0) && (bin < CameraSocketHistograms::g_bins_nb - 1))
+    {
+        in_value >>= 1;
+        bin++;
+    }
+
+    in_out_histogram[bin]++;
+}
+
+/****************************************************************************************************
+ * \fn void updateReceiveQueue(std::size_t in_receive_queue_bytes)
+ * \brief  update the receive queue gauges (the monitor lock should be taken)
+ * \param  in_receive_queue_bytes bytes waiting in the socket receive queue
+ * \return none
+ ****************************************************************************************************/
+void CameraSocketMonitor::updateReceiveQueue(std::size_t in_receive_queue_bytes)
+{
+    m_gauges.m_receive_queue_bytes = in_receive_queue_bytes;
+
+    if(m_gauges.m_receive_queue_bytes > m_gauges.m_max_receive_queue_bytes)
+    {
+        m_gauges.m_max_receive_queue_bytes = m_gauges.m_receive_queue_bytes;
+    }
+
+    m_gauges.m_receive_buffer_usage = (m_gauges.m_receive_buffer_bytes > 0) ?
+        (static_cast<double>(m_gauges.m_receive_queue_bytes) / static_cast<double>(m_gauges.m_receive_buffer_bytes)) : 0.0;
+
+    addToHistogram(m_histograms.m_receive_queue_bytes, m_gauges.m_receive_queue_bytes);
+}
+
+/****************************************************************************************************
+ * \fn void sampleSocket()
+ * \brief  sample the socket state (called periodically by the data update thread)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraSocketMonitor::sampleSocket()
+{
+    std::size_t     receive_queue_bytes  = CameraControl::getConstInstance()->getReceiveQueueBytes();
+    std::size_t     receive_buffer_bytes = CameraControl::getConstInstance()->getReceiveBufferSize();
+    struct tcp_info info;
+    bool            info_valid           = CameraControl::getConstInstance()->getTcpInfo(info);
+
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    m_gauges.m_samples_nb++;
+    m_gauges.m_receive_buffer_bytes = receive_buffer_bytes;
+
+    updateReceiveQueue(receive_queue_bytes);
+
+    if(info_valid)
+    {
+        m_gauges.m_rtt_usec          = info.tcpi_rtt          ;
+        m_gauges.m_rtt_var_usec      = info.tcpi_rttvar       ;
+        m_gauges.m_retransmits       = info.tcpi_retransmits  ;
+        m_gauges.m_total_retransmits = info.tcpi_total_retrans;
+
+        addToHistogram(m_histograms.m_rtt_usec, info.tcpi_rtt);
+    }
+}
+
+/****************************************************************************************************
+ * \fn void addPart(std::size_t in_receive_queue_bytes, double in_decode_lag_sec)
+ * \brief  add the measures of a sampled image part (called by the acquisition thread)
+ * \param  in_receive_queue_bytes bytes waiting in the socket receive queue
+ * \param  in_decode_lag_sec delay between the kernel reception of the part and its treatment
+ * \return none
+ ****************************************************************************************************/
+void CameraSocketMonitor::addPart(std::size_t in_receive_queue_bytes, double in_decode_lag_sec)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    m_gauges.m_parts_nb++;
+
+    updateReceiveQueue(in_receive_queue_bytes);
+
+    // the clocks of the kernel and of the user space can give a small negative lag
+    double lag = (in_decode_lag_sec > 0.0) ? in_decode_lag_sec : 0.0;
+
+    m_gauges.m_decode_lag_sec = lag;
+
+    if(lag > m_gauges.m_max_decode_lag_sec)
+    {
+        m_gauges.m_max_decode_lag_sec = lag;
+    }
+
+    addToHistogram(m_histograms.m_decode_lag_usec, static_cast<uint64_t>(lag * 1e6));
+}
+
+/****************************************************************************************************
+ * \fn void reset()
+ * \brief  reset the gauges and the histograms
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraSocketMonitor::reset()
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    memset(&m_gauges    , 0, sizeof(CameraSocketGauges    ));
+    memset(&m_histograms, 0, sizeof(CameraSocketHistograms));
+}
+
+/****************************************************************************************************
+ * \fn CameraSocketGauges getGauges() const
+ * \brief  get the latest values
+ * \param  none
+ * \return gauges copy
+ ****************************************************************************************************/
+CameraSocketGauges CameraSocketMonitor::getGauges() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    return m_gauges;
+}
+
+/****************************************************************************************************
+ * \fn CameraSocketHistograms getHistograms() const
+ * \brief  get the histograms
+ * \param  none
+ * \return histograms copy
+ ****************************************************************************************************/
+CameraSocketHistograms CameraSocketMonitor::getHistograms() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex monitor_mutex = monitorLock();
+
+    return m_histograms;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraSocketMonitor::create()
+{
+    init(new CameraSocketMonitor());
+}
+
+//###########################################################################
@@ -0,0 +1,522 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraThroughputProfiles.cpp
+ * \brief  implementation file of the throughput profiles.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraThroughputProfiles.h"
+
+// SYSTEM
+#include <cstring>
+#include <algorithm>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const double CameraThroughputProfiles::g_measure_weight = 0.2;
+
+/****************************************************************************************************
+ * \fn CameraThroughputProfiles()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraThroughputProfiles::CameraThroughputProfiles()
+{
+    DEB_CONSTRUCTOR();
+
+    m_byte_time_sec     = 0.0 ;
+    m_target_frame_rate = 1.0 ;
+    m_noise_budget      = 10.0;
+    m_max_binning       = 1   ;
+
+    memset(&m_fast_packets , 0, sizeof(CameraPacketSettings));
+    memset(&m_quiet_packets, 0, sizeof(CameraPacketSettings));
+}
+
+/****************************************************************************************************
+ * \fn ~CameraThroughputProfiles()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraThroughputProfiles::~CameraThroughputProfiles()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex profilesLock() const
+ * \brief  creates an autolock mutex for the profiles data access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraThroughputProfiles::profilesLock() const
+{
+    return lima::AutoMutex(m_profiles_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn CameraReadoutCandidate * searchCandidate(uint32_t in_readout_speed)
+ * \brief  search a readout speed (the lock must be taken by the caller)
+ * \param  in_readout_speed readout speed (DSI sample time) setting
+ * \return candidate or NULL if not found
+ ****************************************************************************************************/
+CameraReadoutCandidate * CameraThroughputProfiles::searchCandidate(uint32_t in_readout_speed)
+{
+    for(std::size_t index = 0 ; index < m_candidates.size() ; index++)
+    {
+        if(m_candidates[index].m_readout_speed == in_readout_speed)
+            return &m_candidates[index];
+    }
+
+    return NULL;
+}
+
+/****************************************************************************************************
+ * \fn void setCandidate(uint32_t in_readout_speed, double in_read_noise)
+ * \brief  declare a readout speed with its read noise. The measures of a known readout speed
+ *         are kept.
+ * \param  in_readout_speed readout speed (DSI sample time) setting
+ * \param  in_read_noise read noise in electrons (0 if unknown)
+ * \return none
+ ****************************************************************************************************/
+void CameraThroughputProfiles::setCandidate(uint32_t in_readout_speed, double in_read_noise)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    CameraReadoutCandidate * candidate = searchCandidate(in_readout_speed);
+
+    if(candidate == NULL)
+    {
+        CameraReadoutCandidate new_candidate;
+        memset(&new_candidate, 0, sizeof(CameraReadoutCandidate));
+
+        new_candidate.m_readout_speed = in_readout_speed;
+        m_candidates.push_back(new_candidate);
+        candidate = &m_candidates.back();
+    }
+
+    candidate->m_read_noise = (in_read_noise > 0.0) ? in_read_noise : 0.0;
+}
+
+/****************************************************************************************************
+ * \fn void clearCandidates()
+ * \brief  remove all the readout speeds and their measures
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraThroughputProfiles::clearCandidates()
+{
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    m_candidates.clear();
+    m_byte_time_sec = 0.0;
+}
+
+/****************************************************************************************************
+ * \fn std::vector<CameraReadoutCandidate> getCandidates() const
+ * \brief  get the readout speeds and their measures
+ * \param  none
+ * \return candidates copy
+ ****************************************************************************************************/
+std::vector<CameraReadoutCandidate> CameraThroughputProfiles::getCandidates() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    return m_candidates;
+}
+
+/****************************************************************************************************
+ * \fn bool setTargetFrameRate(double in_frame_rate)
+ * \brief  set the target frame rate of the TargetFrameRate profile
+ * \param  in_frame_rate frames per second
+ * \return true if succeed, false if the frame rate is incorrect
+ ****************************************************************************************************/
+bool CameraThroughputProfiles::setTargetFrameRate(double in_frame_rate)
+{
+    if(in_frame_rate <= 0.0)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    m_target_frame_rate = in_frame_rate;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn double getTargetFrameRate() const
+ * \brief  get the target frame rate of the TargetFrameRate profile
+ * \param  none
+ * \return frames per second
+ ****************************************************************************************************/
+double CameraThroughputProfiles::getTargetFrameRate() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    return m_target_frame_rate;
+}
+
+/****************************************************************************************************
+ * \fn bool setNoiseBudget(double in_read_noise)
+ * \brief  set the read noise budget of the NoiseBudget profile
+ * \param  in_read_noise maximum read noise in electrons
+ * \return true if succeed, false if the budget is incorrect
+ ****************************************************************************************************/
+bool CameraThroughputProfiles::setNoiseBudget(double in_read_noise)
+{
+    if(in_read_noise <= 0.0)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    m_noise_budget = in_read_noise;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn double getNoiseBudget() const
+ * \brief  get the read noise budget of the NoiseBudget profile
+ * \param  none
+ * \return maximum read noise in electrons
+ ****************************************************************************************************/
+double CameraThroughputProfiles::getNoiseBudget() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    return m_noise_budget;
+}
+
+/****************************************************************************************************
+ * \fn bool setMaxBinning(std::size_t in_max_binning)
+ * \brief  set the maximum binning the profiles can choose (1 to keep the full resolution)
+ * \param  in_max_binning maximum binning
+ * \return true if succeed, false if the binning is incorrect
+ ****************************************************************************************************/
+bool CameraThroughputProfiles::setMaxBinning(std::size_t in_max_binning)
+{
+    if(in_max_binning < 1)
+        return false;
+
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    m_max_binning = in_max_binning;
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getMaxBinning() const
+ * \brief  get the maximum binning the profiles can choose
+ * \param  none
+ * \return maximum binning
+ ****************************************************************************************************/
+std::size_t CameraThroughputProfiles::getMaxBinning() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    return m_max_binning;
+}
+
+/****************************************************************************************************
+ * \fn void setPacketSettings(const CameraPacketSettings & in_fast, const CameraPacketSettings & in_quiet)
+ * \brief  set the packets settings of the frame rate and noise profiles
+ * \param  in_fast packets settings of the MaximumFrameRate and TargetFrameRate profiles
+ * \param  in_quiet packets settings of the MinimumNoise and NoiseBudget profiles
+ * \return none
+ ****************************************************************************************************/
+void CameraThroughputProfiles::setPacketSettings(const CameraPacketSettings & in_fast, const CameraPacketSettings & in_quiet)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    m_fast_packets  = in_fast ;
+    m_quiet_packets = in_quiet;
+}
+
+/****************************************************************************************************
+ * \fn void getPacketSettings(CameraPacketSettings & out_fast, CameraPacketSettings & out_quiet) const
+ * \brief  get the packets settings of the frame rate and noise profiles
+ * \param  out_fast packets settings of the MaximumFrameRate and TargetFrameRate profiles
+ * \param  out_quiet packets settings of the MinimumNoise and NoiseBudget profiles
+ * \return none
+ ****************************************************************************************************/
+void CameraThroughputProfiles::getPacketSettings(CameraPacketSettings & out_fast, CameraPacketSettings & out_quiet) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    out_fast  = m_fast_packets ;
+    out_quiet = m_quiet_packets;
+}
+
+/****************************************************************************************************
+ * \fn double getByteTimeSec() const
+ * \brief  get the measured transfer time of a byte
+ * \param  none
+ * \return seconds per byte (0 if not measured)
+ ****************************************************************************************************/
+double CameraThroughputProfiles::getByteTimeSec() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    return m_byte_time_sec;
+}
+
+/****************************************************************************************************
+ * \fn void addFrame(const CameraFrameMetadata & in_metadata)
+ * \brief  add the measures of a completed frame (called by the acquisition thread).
+ *         An unknown readout speed is added to the candidates with an unknown read noise.
+ * \param  in_metadata metadata of the frame
+ * \return none
+ ****************************************************************************************************/
+void CameraThroughputProfiles::addFrame(const CameraFrameMetadata & in_metadata)
+{
+    const double      exposure_sec = static_cast<double>(in_metadata.m_exposure_time_msec) / 1000.0;
+    const double      readout_sec  = in_metadata.m_acquisition_end_time - in_metadata.m_acquire_time - exposure_sec;
+    const double      transfer_sec = in_metadata.m_last_part_time - in_metadata.m_first_part_time;
+    const std::size_t pixels_nb    = (in_metadata.m_serial_length   / std::max(in_metadata.m_serial_binning  , 1U)) *
+                                     (in_metadata.m_parallel_length / std::max(in_metadata.m_parallel_binning, 1U));
+
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    // readout time of an output pixel
+    if((in_metadata.m_acquire_time > 0.0) && (in_metadata.m_acquisition_end_time > 0.0) && (readout_sec > 0.0) && (pixels_nb > 0))
+    {
+        CameraReadoutCandidate * candidate = searchCandidate(in_metadata.m_readout_speed);
+
+        if(candidate == NULL)
+        {
+            CameraReadoutCandidate new_candidate;
+            memset(&new_candidate, 0, sizeof(CameraReadoutCandidate));
+
+            new_candidate.m_readout_speed = in_metadata.m_readout_speed;
+            m_candidates.push_back(new_candidate);
+            candidate = &m_candidates.back();
+        }
+
+        const double pixel_time_sec = readout_sec / static_cast<double>(pixels_nb);
+
+        candidate->m_pixel_time_sec = (candidate->m_measures_nb == 0) ? pixel_time_sec :
+                                      (candidate->m_pixel_time_sec + g_measure_weight * (pixel_time_sec - candidate->m_pixel_time_sec));
+        candidate->m_measures_nb++;
+    }
+
+    // transfer time of a byte (the frames with a single part are ignored)
+    if((in_metadata.m_parts_nb > 1) && (transfer_sec > 0.0) && (in_metadata.m_bytes_nb > 0))
+    {
+        const double byte_time_sec = transfer_sec / static_cast<double>(in_metadata.m_bytes_nb);
+
+        m_byte_time_sec = (m_byte_time_sec == 0.0) ? byte_time_sec :
+                          (m_byte_time_sec + g_measure_weight * (byte_time_sec - m_byte_time_sec));
+    }
+}
+
+/****************************************************************************************************
+ * \fn double predictFrameRate(const CameraReadoutCandidate & in_candidate, std::size_t in_binning, double in_exposure_sec, std::size_t in_width, std::size_t in_height) const
+ * \brief  predict the frame rate of a readout speed and binning
+ *         (exposure, readout and transfer are done one after the other)
+ * \param  in_candidate readout speed
+ * \param  in_binning binning
+ * \param  in_exposure_sec exposure time in seconds
+ * \param  in_width ROI width in unbinned pixels
+ * \param  in_height ROI height in unbinned pixels
+ * \return frames per second (0 if the readout was not measured)
+ ****************************************************************************************************/
+double CameraThroughputProfiles::predictFrameRate(const CameraReadoutCandidate & in_candidate,
+                                                  std::size_t                    in_binning  ,
+                                                  double                         in_exposure_sec,
+                                                  std::size_t                    in_width    ,
+                                                  std::size_t                    in_height   ) const
+{
+    if(in_candidate.m_measures_nb == 0)
+        return 0.0;
+
+    const double pixels_nb  = static_cast<double>((in_width / in_binning) * (in_height / in_binning));
+    const double period_sec = in_exposure_sec +
+                              pixels_nb * in_candidate.m_pixel_time_sec +
+                              pixels_nb * sizeof(uint16_t) * m_byte_time_sec;
+
+    return (period_sec > 0.0) ? (1.0 / period_sec) : 0.0;
+}
+
+/****************************************************************************************************
+ * \fn bool isQuieter(const CameraReadoutCandidate & in_first, const CameraReadoutCandidate & in_second)
+ * \brief  check if a readout speed is quieter than an other one. A declared read noise is
+ *         quieter than an unknown one. Without declared noise, the slower sampling (greater
+ *         DSI sample time) is considered quieter.
+ * \param  in_first first readout speed
+ * \param  in_second second readout speed
+ * \return true if the first readout speed is quieter
+ ****************************************************************************************************/
+bool CameraThroughputProfiles::isQuieter(const CameraReadoutCandidate & in_first, const CameraReadoutCandidate & in_second)
+{
+    const bool first_known  = (in_first.m_read_noise  > 0.0);
+    const bool second_known = (in_second.m_read_noise > 0.0);
+
+    if(first_known != second_known)
+        return first_known;
+
+    if(first_known && (in_first.m_read_noise != in_second.m_read_noise))
+        return (in_first.m_read_noise < in_second.m_read_noise);
+
+    return (in_first.m_readout_speed > in_second.m_readout_speed);
+}
+
+/****************************************************************************************************
+ * \fn bool choose(Profile in_profile, double in_exposure_sec, std::size_t in_width, std::size_t in_height, CameraThroughputChoice & out_choice) const
+ * \brief  choose the settings of a profile
+ * \param  in_profile profile
+ * \param  in_exposure_sec exposure time in seconds
+ * \param  in_width ROI width in unbinned pixels
+ * \param  in_height ROI height in unbinned pixels
+ * \param  out_choice chosen settings
+ * \return true if succeed, false if no combination respects the profile
+ ****************************************************************************************************/
+bool CameraThroughputProfiles::choose(Profile                  in_profile     ,
+                                      double                   in_exposure_sec,
+                                      std::size_t              in_width       ,
+                                      std::size_t              in_height      ,
+                                      CameraThroughputChoice & out_choice     ) const
+{
+    DEB_MEMBER_FUNCT();
+
+    // protecting the multi-threads access
+    lima::AutoMutex profiles_mutex = profilesLock();
+
+    const CameraReadoutCandidate * best_candidate = NULL;
+    std::size_t                    best_binning   = 1   ;
+    double                         best_rate      = 0.0 ;
+    std::size_t                    max_binning    = std::max(std::min(m_max_binning, std::min(in_width, in_height)), static_cast<std::size_t>(1));
+
+    for(std::size_t index = 0 ; index < m_candidates.size() ; index++)
+    {
+        const CameraReadoutCandidate & candidate = m_candidates[index];
+
+        if(in_profile == MaximumFrameRate)
+        {
+            // the largest binning is always the fastest
+            double rate = predictFrameRate(candidate, max_binning, in_exposure_sec, in_width, in_height);
+
+            if((rate > 0.0) && (rate > best_rate))
+            {
+                best_candidate = &candidate  ;
+                best_binning   = max_binning ;
+                best_rate      = rate        ;
+            }
+        }
+        else
+        if(in_profile == MinimumNoise)
+        {
+            if((best_candidate == NULL) || isQuieter(candidate, *best_candidate))
+            {
+                best_candidate = &candidate;
+                best_binning   = 1         ;
+                best_rate      = predictFrameRate(candidate, 1, in_exposure_sec, in_width, in_height);
+            }
+        }
+        else
+        if(in_profile == TargetFrameRate)
+        {
+            // the smallest binning which reaches the target
+            for(std::size_t binning = 1 ; binning <= max_binning ; binning++)
+            {
+                double rate = predictFrameRate(candidate, binning, in_exposure_sec, in_width, in_height);
+
+                if(rate < m_target_frame_rate)
+                    continue;
+
+                if((best_candidate == NULL) || isQuieter(candidate, *best_candidate))
+                {
+                    best_candidate = &candidate;
+                    best_binning   = binning   ;
+                    best_rate      = rate      ;
+                }
+                break;
+            }
+        }
+        else
+        if(in_profile == NoiseBudget)
+        {
+            if((candidate.m_read_noise <= 0.0) || (candidate.m_read_noise > m_noise_budget))
+                continue;
+
+            double rate = predictFrameRate(candidate, max_binning, in_exposure_sec, in_width, in_height);
+
+            // a measured readout speed is preferred, else the quietest one is kept
+            if((best_candidate == NULL) || (rate > best_rate) || ((best_rate == 0.0) && (rate == 0.0) && isQuieter(candidate, *best_candidate)))
+            {
+                best_candidate = &candidate ;
+                best_binning   = (rate > 0.0) ? max_binning : 1;
+                best_rate      = rate       ;
+            }
+        }
+    }
+
+    if(best_candidate == NULL)
+    {
+        DEB_ERROR() << "CameraThroughputProfiles::choose - no readout speed respects the profile " << (int)in_profile
+                    << " (" << m_candidates.size() << " readout speeds known)!";
+        return false;
+    }
+
+    out_choice.m_readout_speed        = best_candidate->m_readout_speed;
+    out_choice.m_binning              = best_binning;
+    out_choice.m_packets              = ((in_profile == MaximumFrameRate) || (in_profile == TargetFrameRate)) ? m_fast_packets : m_quiet_packets;
+    out_choice.m_predicted_frame_rate = best_rate;
+    out_choice.m_read_noise           = best_candidate->m_read_noise;
+
+    return true;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraThroughputProfiles::create()
+{
+    init(new CameraThroughputProfiles());
+}
+
+//###########################################################################
@@ -0,0 +1,199 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraTransferStatistics.cpp
+ * \brief  implementation file of the frames reception times and transfer rate statistics.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraTransferStatistics.h"
+
+// SYSTEM
+#include <cstring>
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+const std::size_t CameraTransferStatistics::g_times_ring_size = 1024;
+
+/****************************************************************************************************
+ * \fn CameraTransferStatistics()
+ * \brief  constructor
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraTransferStatistics::CameraTransferStatistics()
+{
+    DEB_CONSTRUCTOR();
+
+    m_nb_frames = 0;
+    memset(&m_counters, 0, sizeof(CameraTransferCounters));
+}
+
+/****************************************************************************************************
+ * \fn ~CameraTransferStatistics()
+ * \brief  destructor (needs to be virtual)
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+CameraTransferStatistics::~CameraTransferStatistics()
+{
+    DEB_DESTRUCTOR();
+}
+
+/****************************************************************************************************
+ * \fn lima::AutoMutex statisticsLock() const
+ * \brief  creates an autolock mutex for the statistics access
+ * \param  none
+ * \return auto mutex
+ ****************************************************************************************************/
+lima::AutoMutex CameraTransferStatistics::statisticsLock() const
+{
+    return lima::AutoMutex(m_statistics_cond.mutex());
+}
+
+/****************************************************************************************************
+ * \fn void prepareAcq(std::size_t in_nb_frames, bool in_kernel_timestamps)
+ * \brief  reset the statistics for a new acquisition
+ * \param  in_nb_frames number of frames to acquire (0 for a continuous acquisition)
+ * \param  in_kernel_timestamps true if the reception times are given by the kernel
+ * \return none
+ ****************************************************************************************************/
+void CameraTransferStatistics::prepareAcq(std::size_t in_nb_frames, bool in_kernel_timestamps)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex statistics_mutex = statisticsLock();
+
+    std::size_t size = (in_nb_frames > 0) ? in_nb_frames : g_times_ring_size;
+
+    CameraFrameReceptionTimes times;
+    memset(&times, 0, sizeof(CameraFrameReceptionTimes));
+
+    m_nb_frames = in_nb_frames;
+    m_frames_times.assign(size, times);
+    m_frames_valid.assign(size, 0    );
+
+    memset(&m_counters, 0, sizeof(CameraTransferCounters));
+    m_counters.m_kernel_timestamps = in_kernel_timestamps;
+}
+
+/****************************************************************************************************
+ * \fn void addFrame(std::size_t in_frame_nb, const CameraFrameReceptionTimes & in_times)
+ * \brief  add the reception times of a complete frame (called by the acquisition thread).
+ *         A frame received in a single socket buffer has no measurable duration and
+ *         is not used for the rates.
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  in_times reception times of the frame
+ * \return none
+ ****************************************************************************************************/
+void CameraTransferStatistics::addFrame(std::size_t in_frame_nb, const CameraFrameReceptionTimes & in_times)
+{
+    // protecting the multi-threads access
+    lima::AutoMutex statistics_mutex = statisticsLock();
+
+    if(!m_frames_times.empty())
+    {
+        std::size_t index = in_frame_nb % m_frames_times.size();
+
+        m_frames_times[index] = in_times;
+        m_frames_valid[index] = 1;
+    }
+
+    m_counters.m_frames_nb++;
+    m_counters.m_bytes_nb += in_times.m_bytes_nb;
+
+    double duration = in_times.m_last_part_time - in_times.m_first_part_time;
+
+    if(duration > 0.0)
+    {
+        double rate = static_cast<double>(in_times.m_bytes_nb) / duration;
+
+        m_counters.m_transfer_duration += duration;
+        m_counters.m_last_rate          = rate;
+        m_counters.m_min_rate           = ((m_counters.m_min_rate == 0.0) || (rate < m_counters.m_min_rate)) ? rate : m_counters.m_min_rate;
+        m_counters.m_max_rate           = (rate > m_counters.m_max_rate) ? rate : m_counters.m_max_rate;
+        m_counters.m_mean_rate          = static_cast<double>(m_counters.m_bytes_nb) / m_counters.m_transfer_duration;
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool getFrameReceptionTimes(std::size_t in_frame_nb, CameraFrameReceptionTimes & out_times) const
+ * \brief  get the reception times of a frame of the current acquisition.
+ *         In continuous acquisition, only the latest frames are kept.
+ * \param  in_frame_nb frame number in the acquisition
+ * \param  out_times reception times of the frame
+ * \return true if the frame was received, false if the frame is unknown
+ ****************************************************************************************************/
+bool CameraTransferStatistics::getFrameReceptionTimes(std::size_t in_frame_nb, CameraFrameReceptionTimes & out_times) const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex statistics_mutex = statisticsLock();
+
+    if(m_frames_times.empty())
+        return false;
+
+    if((m_nb_frames > 0) && (in_frame_nb >= m_frames_times.size()))
+        return false;
+
+    std::size_t index = in_frame_nb % m_frames_times.size();
+
+    if(!m_frames_valid[index])
+        return false;
+
+    out_times = m_frames_times[index];
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn CameraTransferCounters getCounters() const
+ * \brief  get the transfer rate statistics of the current acquisition
+ * \param  none
+ * \return counters copy
+ ****************************************************************************************************/
+CameraTransferCounters CameraTransferStatistics::getCounters() const
+{
+    // protecting the multi-threads access
+    lima::AutoMutex statistics_mutex = statisticsLock();
+
+    return m_counters;
+}
+
+/**************************************************************************************************
+ * SINGLETON MANAGEMENT
+ **************************************************************************************************/
+/****************************************************************************************************
+ * \fn void create()
+ * \brief  Create the singleton instance
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void CameraTransferStatistics::create()
+{
+    init(new CameraTransferStatistics());
+}
+
+//###########################################################################
@@ -30,12 +30,16 @@
 #include "CameraUpdateDataThread.h"
 #include "SpectralInstrumentCamera.h"
 #include "CameraControl.h"
+#include "CameraSocketMonitor.h"
+#include "CameraSoakMonitor.h"
+#include "CameraClock.h"
 
 // SYSTEM
 #include <stdio.h>
 #include <stdlib.h>
 #include <errno.h>  
 #include <sys/time.h>
+#include <time.h>
 #include <sstream>
 
 // LIMA
@@ -165,6 +169,11 @@ void CameraUpdateDataThread::execStartUpdate()
     // m_force_stop can be set to true also with an error hardware camera status
     while(!m_force_stop)
     {
+        struct timespec start_time;
+        struct timespec end_time  ;
+
+        clock_gettime(CLOCK_MONOTONIC, &start_time);
+
         if(!Camera::getInstance()->updateData())
         {
             setStatus(CameraUpdateDataThread::Error);
@@ -173,8 +182,18 @@ void CameraUpdateDataThread::execStartUpdate()
             break;
         }
 
+        clock_gettime(CLOCK_MONOTONIC, &end_time);
+
+        // sampling the socket backlog
+        CameraSocketMonitor::getInstance()->sampleSocket();
+
+        // sampling the resources and latencies of the long runs
+        CameraSoakMonitor::getInstance()->addCommandLatency(static_cast<double>(end_time.tv_sec  - start_time.tv_sec ) +
+                                                            static_cast<double>(end_time.tv_nsec - start_time.tv_nsec) / 1000000000.0);
+        CameraSoakMonitor::getInstance()->sample();
+
         // wait a few mseconds
-        usleep(data_update_delay_msec * 1000);
+        CameraClock::getConstInstance()->sleepMsec(data_update_delay_msec);
     }
 
     // change the thread status only if the thread is not in error
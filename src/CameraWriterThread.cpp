@@ -0,0 +1,175 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   CameraWriterThread.cpp
+ * \brief  implementation file of the thread used to write the frames into files.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// PROJECT
+#include "CameraWriterThread.h"
+
+using namespace lima;
+using namespace lima::SpectralInstrument;
+
+/************************************************************************
+ * \brief constructor
+ * \param in_writer writer which owns the thread
+ ************************************************************************/
+CameraWriterThread::CameraWriterThread(CameraFrameWriter * in_writer)
+{
+    DEB_MEMBER_FUNCT();
+    DEB_TRACE() << "Creation of the CameraWriterThread thread...";
+
+    m_writer     = in_writer;
+    m_force_stop = false;
+}
+
+/************************************************************************
+ * \brief destructor
+ ************************************************************************/
+CameraWriterThread::~CameraWriterThread()
+{
+    DEB_MEMBER_FUNCT();
+    DEB_TRACE() << "The CameraWriterThread thread was terminated.";
+}
+
+/************************************************************************
+ * \brief starts the thread
+ ************************************************************************/
+void CameraWriterThread::start()
+{
+    DEB_MEMBER_FUNCT();
+    DEB_TRACE() << "Starting the CameraWriterThread thread...";
+
+    CmdThread::start();
+    waitStatus(CameraWriterThread::Idle);
+}
+
+/************************************************************************
+ * \brief inits the thread
+ ************************************************************************/
+void CameraWriterThread::init()
+{
+    DEB_MEMBER_FUNCT();
+    DEB_TRACE() << "Initing the CameraWriterThread thread...";
+
+    setStatus(CameraWriterThread::Idle);
+}
+
+/************************************************************************
+ * \brief aborts the thread
+ ************************************************************************/
+void CameraWriterThread::abort()
+{
+	DEB_MEMBER_FUNCT();
+    CmdThread::abort();
+}
+
+/************************************************************************
+ * \brief command execution
+ * \param cmd command indentifier
+************************************************************************/
+void CameraWriterThread::execCmd(int cmd)
+{
+    DEB_MEMBER_FUNCT();
+    DEB_TRACE() << "Executing a command by the CameraWriterThread thread...";
+
+    int status = getStatus();
+
+    try
+    {
+        switch (cmd)
+        {
+            case CameraWriterThread::StartWriting:
+                if (status == CameraWriterThread::Idle)
+                    execStartWriting();
+                break;
+
+            default:
+                break;
+        }
+    }
+    catch (...)
+    {
+        setStatus(CameraWriterThread::Error);
+    }
+}
+
+/************************************************************************
+ * \brief execute the StartWriting command
+ ************************************************************************/
+void CameraWriterThread::execStartWriting()
+{
+    DEB_MEMBER_FUNCT();
+    DEB_TRACE() << "executing StartWriting command...";
+
+    m_force_stop = false;
+
+    // the thread is running (it frees the startWriting method)
+    setStatus(CameraWriterThread::Running);
+
+    // Main writing loop
+    // m_force_stop can be set to true by the stopWriting call
+    while(!m_force_stop)
+    {
+        m_writer->writeNext();
+    }
+
+    // change the thread status only if the thread is not in error
+    if(getStatus() == CameraWriterThread::Running)
+    {
+        setStatus(CameraWriterThread::Idle);
+    }
+}
+
+/*******************************************************************
+ * \brief Starts the writing
+ *******************************************************************/
+void CameraWriterThread::startWriting()
+{
+    sendCmd(CameraWriterThread::StartWriting);
+    waitNotStatus(CameraWriterThread::Idle);
+}
+
+/*******************************************************************
+ * \brief Stops the writing and aborts the thread. The jobs still
+ *        queued are not written by the thread.
+ *******************************************************************/
+void CameraWriterThread::stopWriting()
+{
+    DEB_MEMBER_FUNCT();
+
+    if(getStatus() == CameraWriterThread::Running)
+    {
+    	DEB_TRACE() << "stopping the writing...";
+        m_force_stop = true;
+
+        // Waiting for thread to finish or to be in error
+        waitNotStatus(CameraWriterThread::Running);
+    }
+
+    abort();
+}
+
+//========================================================================================
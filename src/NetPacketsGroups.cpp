@@ -96,6 +96,9 @@ NetPacketsGroups::~NetPacketsGroups()
     #ifdef NET_PACKETS_GROUPS_DEBUG
         std::cout << "NetPacketsGroups::~NetPacketsGroups - removing Group " << group->getName() << std::endl;
     #endif
+
+        // the packets still in the group are released with it
+        delete group;
     }
 }
 
@@ -169,7 +172,7 @@ void NetPacketsGroups::createGroup(const std::string & in_name, NetPacketsGroupI
  * \param  in_wait_packet_timeout_sec timeout delay in seconds
  * \return none
  ****************************************************************************************************/
-void NetPacketsGroups::setDelayBeforeTimeoutSec(int in_wait_packet_timeout_sec)
+void NetPacketsGroups::setDelayBeforeTimeoutSec(double in_wait_packet_timeout_sec)
 {
     NetPacketsMap::iterator it;
 
@@ -177,7 +180,7 @@ void NetPacketsGroups::setDelayBeforeTimeoutSec(int in_wait_packet_timeout_sec)
     {
         ProtectedList<NetGenericHeader> * group = it->second;
 
-        group->setDelayBeforeTimeoutSec(static_cast<double>(in_wait_packet_timeout_sec));
+        group->setDelayBeforeTimeoutSec(in_wait_packet_timeout_sec);
 
     #ifdef NET_PACKETS_GROUPS_DEBUG
         std::cout << "NetPacketsGroups::setDelayBeforeTimeoutSec: " << in_wait_packet_timeout_sec 
@@ -187,13 +190,13 @@ void NetPacketsGroups::setDelayBeforeTimeoutSec(int in_wait_packet_timeout_sec)
 }
 
 /****************************************************************************************************
- * \fn void NetPacketsGroups::setDelayBeforeTimeoutSec(NetPacketsGroupId in_group_id, int in_wait_packet_timeout_sec)
+ * \fn void NetPacketsGroups::setDelayBeforeTimeoutSec(NetPacketsGroupId in_group_id, double in_wait_packet_timeout_sec)
  * \brief  set the timeout delay in seconds for a specific group
  * \param[in] in_group_id identifier of the group
  * \param[in] in_wait_packet_timeout_sec timeout delay in seconds
  * \return none
  ****************************************************************************************************/
-void NetPacketsGroups::setDelayBeforeTimeoutSec(NetPacketsGroupId in_group_id, int in_wait_packet_timeout_sec)
+void NetPacketsGroups::setDelayBeforeTimeoutSec(NetPacketsGroupId in_group_id, double in_wait_packet_timeout_sec)
 {
     ProtectedList<NetGenericHeader> * group = NULL;
 
@@ -208,7 +211,7 @@ void NetPacketsGroups::setDelayBeforeTimeoutSec(NetPacketsGroupId in_group_id, i
     }
     else
     {
-        group->setDelayBeforeTimeoutSec(static_cast<double>(in_wait_packet_timeout_sec));
+        group->setDelayBeforeTimeoutSec(in_wait_packet_timeout_sec);
 
     #ifdef NET_PACKETS_GROUPS_DEBUG
         std::cout << "NetPacketsGroups::setDelayBeforeTimeoutSec: " << in_wait_packet_timeout_sec 
@@ -217,4 +220,24 @@ void NetPacketsGroups::setDelayBeforeTimeoutSec(NetPacketsGroupId in_group_id, i
     }
 }
 
+/****************************************************************************************************
+ * \fn std::size_t NetPacketsGroups::getPacketsNb() const
+ * \brief  get the number of packets waiting in all the groups
+ * \param  none
+ * \return number of packets
+ ****************************************************************************************************/
+std::size_t NetPacketsGroups::getPacketsNb() const
+{
+    std::size_t packets_nb = 0;
+
+    NetPacketsMap::const_iterator it;
+
+    for (it = m_container.begin(); it != m_container.end(); ++it) 
+    {
+        packets_nb += it->second->size();
+    }
+
+    return packets_nb;
+}
+
 //###########################################################################
\ No newline at end of file
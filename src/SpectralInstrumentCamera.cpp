@@ -32,6 +32,26 @@
 #include "CameraControl.h"
 #include "CameraUpdateDataThread.h"
 #include "CameraAcqThread.h"
+#include "CameraFrameProcessing.h"
+#include "CameraBadPixelMap.h"
+#include "CameraFrameChangeDetector.h"
+#include "CameraMosaic.h"
+#include "CameraTransferStatistics.h"
+#include "CameraPacketDelayController.h"
+#include "CameraFitsWriter.h"
+#include "CameraHdf5Writer.h"
+#include "CameraThroughputProfiles.h"
+#include "CameraPresetLibrary.h"
+#include "CameraRowBandNotifier.h"
+#include "CameraDecodePool.h"
+#include "CameraPhotonTransfer.h"
+#include "CameraLutCorrection.h"
+#include "CameraFrameStacker.h"
+#include "CameraAzimuthalIntegrator.h"
+#include "CameraRoiCounterTable.h"
+#include "CameraBackgroundSubtraction.h"
+#include "CameraSoakMonitor.h"
+#include "CameraClock.h"
 
 using namespace lima;
 using namespace lima::SpectralInstrument;
@@ -46,6 +66,7 @@ const double Camera::g_pixel_size_y = 75e-6; // pixel size is ? micron
 #include "SpectralInstrumentCameraRoi.hpp"
 #include "SpectralInstrumentCameraSync.hpp"
 #include "SpectralInstrumentCameraDetInfo.hpp"
+#include "SpectralInstrumentCameraProcessing.hpp"
 
 //-----------------------------------------------------------------------------
 // used to give acess to the Camera instance like a singleton.
@@ -86,6 +107,7 @@ Camera::Camera(const std::string & connection_address          ,
     m_image_packet_delay_micro_sec = image_packet_delay_micro_sec;
     m_nb_frames_to_acquire         = 0                           ;
     m_nb_frames_acquired           = 0                           ;
+    m_nb_frames_dropped            = 0                           ;
     m_latency_time_msec            = 0                           ;
     m_trigger_mode                 = lima::TrigMode::IntTrig     ;
     m_update_authorize_flag        = true                        ;
@@ -108,6 +130,9 @@ Camera::Camera(const std::string & connection_address          ,
     init_parameters.setDelayToCheckAcqEndMsec   (delay_to_check_acq_end_msec  );
     init_parameters.setInquireAcqStatusDelayMsec(inquire_acq_status_delay_msec);
 
+    // the clock is used by the control since its creation (packets timeouts, reception times)
+    CameraClock::create();
+
     CameraControl::create(init_parameters);
 
     // starting the tcp/ip connection
@@ -131,6 +156,60 @@ Camera::Camera(const std::string & connection_address          ,
         THROW_HW_ERROR(Error) << "Unable to configurate the camera (Check if it is switched on or if an other software is currently using it).";
     }
 
+    // creating the frame processing stages (applied in the stages order)
+    CameraFrameProcessing::create();
+    CameraBadPixelMap::create();
+    CameraFrameChangeDetector::create();
+    CameraMosaic::create();
+    CameraTransferStatistics::create();
+    CameraPacketDelayController::create();
+    CameraSocketMonitor::create();
+    CameraFrameMetadataTable::create();
+    CameraFitsWriter::create();
+    CameraHdf5Writer::create();
+    CameraThroughputProfiles::create();
+    CameraPresetLibrary::create();
+    CameraRowBandNotifier::create();
+    CameraDecodePool::create();
+    CameraSoakMonitor::create();
+    CameraPhotonTransfer::create();
+    CameraLutCorrection::create();
+    CameraFrameStacker::create();
+    CameraAzimuthalIntegrator::create();
+    CameraRoiCounterTable::create();
+    CameraBackgroundSubtraction::create();
+
+    CameraPacketDelayController::getInstance()->setInitialSettings(static_cast<uint16_t>(m_image_packet_pixels_nb      ),
+                                                                   static_cast<uint16_t>(m_image_packet_delay_micro_sec));
+
+    // the frame rate profiles send the packets without delay, the noise profiles use the initial settings
+    {
+        CameraPacketSettings fast_packets ;
+        CameraPacketSettings quiet_packets;
+
+        fast_packets.m_pixels_per_packet  = static_cast<uint16_t>(m_image_packet_pixels_nb      );
+        fast_packets.m_packet_delay_usec  = 0;
+        quiet_packets.m_pixels_per_packet = static_cast<uint16_t>(m_image_packet_pixels_nb      );
+        quiet_packets.m_packet_delay_usec = static_cast<uint16_t>(m_image_packet_delay_micro_sec);
+
+        CameraThroughputProfiles::getInstance()->setPacketSettings(fast_packets, quiet_packets);
+    }
+
+    // the change detector is the first stage, so the dropped frames are not seen by the stages
+    // which keep a state
+    CameraFrameProcessing::getInstance()->addStage(CameraFrameChangeDetector::getInstance());
+
+    // the photon transfer stage needs the raw pixels
+    CameraFrameProcessing::getInstance()->addStage(CameraPhotonTransfer::getInstance());
+    CameraFrameProcessing::getInstance()->addStage(CameraBadPixelMap::getInstance());
+    CameraFrameProcessing::getInstance()->addStage(CameraLutCorrection::getInstance());
+    CameraFrameProcessing::getInstance()->addStage(CameraBackgroundSubtraction::getInstance());
+    CameraFrameProcessing::getInstance()->addStage(CameraFrameStacker::getInstance());
+    CameraFrameProcessing::getInstance()->addStage(CameraAzimuthalIntegrator::getInstance());
+    CameraFrameProcessing::getInstance()->addStage(CameraMosaic::getInstance());
+    CameraFrameProcessing::getInstance()->addStage(CameraFitsWriter::getInstance());
+    CameraFrameProcessing::getInstance()->addStage(CameraHdf5Writer::getInstance());
+
     // creating the data update thread
     CameraUpdateDataThread::create();
     
@@ -167,12 +246,38 @@ Camera::~Camera()
     // Releasing the data update thread
     CameraUpdateDataThread::release();
 
+    // Releasing the frame processing stages
+    CameraFrameProcessing::release();
+    CameraBadPixelMap::release();
+    CameraFrameChangeDetector::release();
+    CameraMosaic::release();
+    CameraTransferStatistics::release();
+    CameraPacketDelayController::release();
+    CameraSocketMonitor::release();
+    CameraFrameMetadataTable::release();
+    CameraFitsWriter::release();
+    CameraHdf5Writer::release();
+    CameraThroughputProfiles::release();
+    CameraPresetLibrary::release();
+    CameraRowBandNotifier::release();
+    CameraDecodePool::release();
+    CameraSoakMonitor::release();
+    CameraPhotonTransfer::release();
+    CameraLutCorrection::release();
+    CameraFrameStacker::release();
+    CameraAzimuthalIntegrator::release();
+    CameraRoiCounterTable::release();
+    CameraBackgroundSubtraction::release();
+
     // Closing camera
     DEB_TRACE() << "Shutdown SpectralInstrument camera...";
 
     // releasing the camera control instance (also, disconnecting the tcp/ip connection).
     CameraControl::release();
 
+    // releasing the clock used by the control
+    CameraClock::release();
+
     g_singleton = NULL;
 
     DEB_TRACE() << "Shutdown done.";
@@ -356,15 +461,49 @@ void Camera::incrementNbFramesAcquired()
     m_nb_frames_acquired++;
 }
 
+/****************************************************************************************************
+ * \fn void setNbFramesDropped(std::size_t in_nb_frames_dropped)
+ * \brief  set the number of frames dropped by the processing stages
+ * \param  in_nb_frames_dropped new number of dropped frames
+ * \return none
+ ****************************************************************************************************/
+void Camera::setNbFramesDropped(std::size_t in_nb_frames_dropped)
+{
+    m_nb_frames_dropped = in_nb_frames_dropped;
+}
+
+/****************************************************************************************************
+ * \fn std::size_t getNbFramesDropped() const
+ * \brief  get the number of frames dropped by the processing stages during the acquisition
+ * \param  none
+ * \return current number of dropped frames
+ ****************************************************************************************************/
+std::size_t Camera::getNbFramesDropped() const
+{
+    return m_nb_frames_dropped;
+}
+
+/****************************************************************************************************
+ * \fn void incrementNbFramesDropped()
+ * \brief  increment the number of frames dropped by the processing stages
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void Camera::incrementNbFramesDropped()
+{
+    m_nb_frames_dropped++;
+}
+
 /****************************************************************************************************
  * \fn bool allFramesAcquired() const
- * \brief  check if all the frames were acquired
+ * \brief  check if all the frames were acquired. The frames dropped by the processing stages
+ *         count as exposures of the acquisition, so a finite acquisition always ends.
  * \param  none
  * \return true is the acquisition is completed else false
  ****************************************************************************************************/
 bool Camera::allFramesAcquired() const
 {
-    return (m_nb_frames_to_acquire == m_nb_frames_acquired);
+    return (m_nb_frames_to_acquire == m_nb_frames_acquired + m_nb_frames_dropped);
 }
 
 
@@ -0,0 +1,589 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   SpectralInstrumentFakeScene.h
+ * \brief  synthetic CCD scene generator of the fake SI Image SGL II server.
+ *         The scene (flat field, gradient, spots, spectrum) is rendered once at the sensor
+ *         resolution. For each format (ROI, binning), exposure time and temperature, the
+ *         expected level and the noise of each binned pixel are computed once. A frame then only
+ *         costs one gaussian draw per pixel, taken from a quantile table with 16 random bits
+ *         given by a xoshiro256+ generator running on independent lanes (vectorized by the
+ *         compiler), followed by the cosmic rays. The frame is split into chunks generated by
+ *         several threads; each chunk has its own random stream, so a frame does not depend on
+ *         the number of threads.
+ *         The shot noise is approximated by a gaussian, which is correct above a few electrons
+ *         and hidden by the read noise below.
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+#ifndef SPECTRALINSTRUMENTFAKESCENE_H
+#define SPECTRALINSTRUMENTFAKESCENE_H
+
+// SYSTEM
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <stdint.h>
+#include <time.h>
+#include <string>
+#include <vector>
+#include <sstream>
+#include <algorithm>
+#include <thread>
+#include <atomic>
+#include <functional>
+
+/*
+ *  \namespace FakeServer
+ */
+namespace FakeServer
+{
+/*
+ *  \struct SceneOptions
+ *  \brief Settings of the synthetic scene and of the simulated sensor
+ */
+typedef struct SceneOptions
+{
+    std::string m_components            ; // comma separated list of flat, gradient, spots, spectrum
+    double      m_signal_rate           ; // peak signal in electrons per sensor pixel per second
+    double      m_gain                  ; // electrons per ADU
+    double      m_bias_adu              ; // bias level in ADU
+    double      m_read_noise            ; // read noise in electrons
+    double      m_dark_rate             ; // dark current at the reference temperature (electrons per pixel per second)
+    double      m_dark_reference_celsius; // reference temperature of the dark current
+    double      m_dark_doubling_celsius ; // temperature increase which doubles the dark current
+    double      m_temperature_celsius   ; // CCD temperature (also given by the status)
+    double      m_hot_pixels_ppm        ; // hot pixels per million sensor pixels
+    double      m_cosmic_rate           ; // cosmic rays per million sensor pixels per second
+    uint64_t    m_seed                  ; // seed of the scene and of the noise
+    std::size_t m_threads_nb            ; // number of generating threads
+
+} SceneOptions;
+
+/*
+ *  \class FastRandom
+ *  \brief This class is a xoshiro256+ generator running on independent lanes.
+ *         The state of each lane is a column of the state arrays, so the compiler can compute
+ *         the lanes with vector instructions.
+ */
+class FastRandom
+{
+public:
+    static const std::size_t g_lanes_nb = 8;
+
+    // init the lanes from a seed (splitmix64)
+    void seed(uint64_t in_seed)
+    {
+        uint64_t state = in_seed;
+
+        for(std::size_t lane = 0 ; lane < g_lanes_nb ; lane++)
+        {
+            m_s0[lane] = splitMix(state);
+            m_s1[lane] = splitMix(state);
+            m_s2[lane] = splitMix(state);
+            m_s3[lane] = splitMix(state);
+        }
+    }
+
+    // fill a block of random values (the size must be a multiple of the lanes number)
+    void fill(uint64_t * out_values, std::size_t in_size)
+    {
+        uint64_t s0[g_lanes_nb], s1[g_lanes_nb], s2[g_lanes_nb], s3[g_lanes_nb];
+
+        memcpy(s0, m_s0, sizeof(s0)); memcpy(s1, m_s1, sizeof(s1));
+        memcpy(s2, m_s2, sizeof(s2)); memcpy(s3, m_s3, sizeof(s3));
+
+        for(std::size_t index = 0 ; index < in_size ; index += g_lanes_nb)
+        {
+            for(std::size_t lane = 0 ; lane < g_lanes_nb ; lane++)
+            {
+                uint64_t result = s0[lane] + s3[lane];
+                uint64_t t      = s1[lane] << 17;
+
+                s2[lane] ^= s0[lane];
+                s3[lane] ^= s1[lane];
+                s1[lane] ^= s2[lane];
+                s0[lane] ^= s3[lane];
+                s2[lane] ^= t;
+                s3[lane]  = (s3[lane] << 45) | (s3[lane] >> 19);
+
+                out_values[index + lane] = result;
+            }
+        }
+
+        memcpy(m_s0, s0, sizeof(s0)); memcpy(m_s1, s1, sizeof(s1));
+        memcpy(m_s2, s2, sizeof(s2)); memcpy(m_s3, s3, sizeof(s3));
+    }
+
+    // get a uniform value in [0, 1[ (scalar use, scene building and cosmic rays)
+    double uniform()
+    {
+        uint64_t values[g_lanes_nb];
+        fill(values, g_lanes_nb);
+
+        return static_cast<double>(values[0] >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+private:
+    static uint64_t splitMix(uint64_t & in_out_state)
+    {
+        uint64_t z = (in_out_state += 0x9E3779B97F4A7C15ULL);
+        z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+        z = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+        return z ^ (z >> 31);
+    }
+
+    uint64_t m_s0[g_lanes_nb];
+    uint64_t m_s1[g_lanes_nb];
+    uint64_t m_s2[g_lanes_nb];
+    uint64_t m_s3[g_lanes_nb];
+};
+
+/*
+ *  \class SceneGenerator
+ *  \brief This class generates the frames of the synthetic scene in network byte order.
+ *         Like in the plugin, the origin and the length of the format are given in binned pixels.
+ */
+class SceneGenerator
+{
+public:
+    // constructor
+    SceneGenerator(const SceneOptions & in_options, std::size_t in_sensor_width, std::size_t in_sensor_height)
+    {
+        m_options       = in_options;
+        m_sensor_width  = in_sensor_width ;
+        m_sensor_height = in_sensor_height;
+        m_width         = 0;
+        m_height        = 0;
+
+        m_exposed_pixels_nb = 0;
+        m_frames_nb         = 0;
+
+        memset(m_format, 0, sizeof(m_format));
+        m_exposure_time_msec = 0;
+        m_dark               = false;
+        m_prepared           = false;
+
+        m_random.seed(in_options.m_seed);
+
+        buildGaussianTable();
+        buildSensorMaps();
+    }
+
+    // get the width of the latest generated frame
+    std::size_t getWidth() const { return m_width; }
+
+    // get the height of the latest generated frame
+    std::size_t getHeight() const { return m_height; }
+
+    // get the CCD temperature
+    double getTemperature() const { return m_options.m_temperature_celsius; }
+
+    // generate a frame (pixels in network byte order)
+    void generate(const int32_t          in_format[6]         ,
+                  uint32_t               in_exposure_time_msec,
+                  bool                   in_dark              ,
+                  std::vector<uint16_t>& out_frame            )
+    {
+        prepare(in_format, in_exposure_time_msec, in_dark);
+
+        std::size_t pixels_nb        = m_width * m_height;
+        std::size_t chunk_pixels_nb  = g_chunk_pixels_nb;
+        std::size_t chunks_nb        = (pixels_nb + chunk_pixels_nb - 1) / chunk_pixels_nb;
+        std::size_t threads_nb       = std::max(static_cast<std::size_t>(1), std::min(m_options.m_threads_nb, chunks_nb));
+
+        std::vector<std::thread> threads;
+        std::atomic<std::size_t> next_chunk(0);
+
+        out_frame.resize(pixels_nb);
+        m_frames_nb++;
+
+        // the calling thread generates chunks too
+        for(std::size_t thread_index = 1 ; thread_index < threads_nb ; thread_index++)
+            threads.push_back(std::thread(&SceneGenerator::generateChunks, this, std::ref(next_chunk), out_frame.data()));
+
+        generateChunks(next_chunk, out_frame.data());
+
+        for(std::size_t thread_index = 0 ; thread_index < threads.size() ; thread_index++)
+            threads[thread_index].join();
+
+        addCosmicRays(out_frame);
+    }
+
+    // measure the generation throughput in bytes per second
+    double benchmark(const int32_t in_format[6], uint32_t in_exposure_time_msec, std::size_t in_frames_nb)
+    {
+        std::vector<uint16_t> frame;
+
+        // the preparation of the format is not measured
+        generate(in_format, in_exposure_time_msec, false, frame);
+
+        double start_sec = getMonotonicTimeSec();
+
+        for(std::size_t frame_index = 0 ; frame_index < in_frames_nb ; frame_index++)
+            generate(in_format, in_exposure_time_msec, false, frame);
+
+        double duration_sec = getMonotonicTimeSec() - start_sec;
+
+        return (duration_sec > 0.0) ? static_cast<double>(in_frames_nb * frame.size() * sizeof(uint16_t)) / duration_sec : 0.0;
+    }
+
+private:
+    // number of pixels computed with one block of random values
+    static const std::size_t g_block_pixels_nb = 4096;
+
+    // number of pixels of a chunk (one random stream, one thread at a time)
+    static const std::size_t g_chunk_pixels_nb = 64 * g_block_pixels_nb;
+
+    // number of quantiles of the gaussian table (indexed by 16 random bits)
+    static const std::size_t g_gaussian_table_size = 65536;
+
+    static uint16_t toNetwork(uint16_t in_value)
+    {
+        return static_cast<uint16_t>((in_value << 8) | (in_value >> 8));
+    }
+
+    static double getMonotonicTimeSec()
+    {
+        struct timespec time;
+        clock_gettime(CLOCK_MONOTONIC, &time);
+
+        return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+    }
+
+    // generate the noisy pixels of the chunks not yet taken by an other thread
+    void generateChunks(std::atomic<std::size_t> & in_out_next_chunk, uint16_t * out_frame) const
+    {
+        std::size_t           pixels_nb       = m_width * m_height;
+        std::size_t           block_pixels_nb = g_block_pixels_nb;
+        std::vector<uint64_t> random_values(block_pixels_nb / 4);
+        FastRandom            random;
+
+        for(;;)
+        {
+            std::size_t chunk = in_out_next_chunk++;
+            std::size_t start = chunk * g_chunk_pixels_nb;
+
+            if(start >= pixels_nb)
+                break;
+
+            std::size_t end = std::min(start + g_chunk_pixels_nb, pixels_nb);
+
+            random.seed(m_options.m_seed ^ (m_frames_nb * 0x9E3779B97F4A7C15ULL) ^ ((chunk + 1) * 0xD1B54A32D192ED03ULL));
+
+            for(std::size_t block_start = start ; block_start < end ; block_start += block_pixels_nb)
+            {
+                std::size_t      block_size = std::min(block_pixels_nb, end - block_start);
+                const uint16_t * indexes    = reinterpret_cast<const uint16_t *>(random_values.data());
+                const float    * mean       = m_mean_adu .data() + block_start;
+                const float    * sigma      = m_sigma_adu.data() + block_start;
+                uint16_t       * pixels     = out_frame          + block_start;
+
+                // noise: one gaussian quantile per pixel, four 16 bits indexes per random value
+                random.fill(random_values.data(), random_values.size());
+
+                for(std::size_t index = 0 ; index < block_size ; index++)
+                {
+                    float value = mean[index] + sigma[index] * m_gaussian_table[indexes[index]];
+
+                    value = std::min(std::max(value, 0.0f), 65535.0f);
+
+                    pixels[index] = toNetwork(static_cast<uint16_t>(value + 0.5f));
+                }
+            }
+        }
+    }
+
+    // check if a component is in the scene
+    bool hasComponent(const std::string & in_name) const
+    {
+        std::stringstream stream(m_options.m_components);
+        std::string       component;
+
+        while(std::getline(stream, component, ','))
+        {
+            if(component == in_name)
+                return true;
+        }
+
+        return false;
+    }
+
+    // fill the table with the quantiles of the normal distribution
+    void buildGaussianTable()
+    {
+        m_gaussian_table.resize(g_gaussian_table_size);
+
+        for(std::size_t index = 0 ; index < g_gaussian_table_size ; index++)
+        {
+            double probability = (static_cast<double>(index) + 0.5) / static_cast<double>(g_gaussian_table_size);
+            double x           = 0.0;
+
+            // newton iterations on the normal cumulative distribution
+            for(int iteration = 0 ; iteration < 50 ; iteration++)
+            {
+                double error = 0.5 * erfc(-x / sqrt(2.0)) - probability;
+                double slope = exp(-0.5 * x * x) / sqrt(2.0 * M_PI);
+
+                x -= error / slope;
+
+                if(fabs(error) < 1e-12)
+                    break;
+            }
+
+            m_gaussian_table[index] = static_cast<float>(x);
+        }
+    }
+
+    // render the scene and the hot pixels at the sensor resolution (electrons per second)
+    void buildSensorMaps()
+    {
+        const double level  = m_options.m_signal_rate;
+        const double width  = static_cast<double>(m_sensor_width );
+        const double height = static_cast<double>(m_sensor_height);
+
+        m_signal_map.assign(m_sensor_width * m_sensor_height, 0.0f);
+        m_hot_map   .assign(m_sensor_width * m_sensor_height, 0.0f);
+
+        if(hasComponent("flat"))
+        {
+            for(std::size_t index = 0 ; index < m_signal_map.size() ; index++)
+                m_signal_map[index] += static_cast<float>(level);
+        }
+
+        if(hasComponent("gradient"))
+        {
+            for(std::size_t y = 0 ; y < m_sensor_height ; y++)
+                for(std::size_t x = 0 ; x < m_sensor_width ; x++)
+                    m_signal_map[y * m_sensor_width + x] += static_cast<float>(level * 0.5 * (x / width + y / height));
+        }
+
+        if(hasComponent("spots"))
+        {
+            // a faint sky with stars
+            for(std::size_t index = 0 ; index < m_signal_map.size() ; index++)
+                m_signal_map[index] += static_cast<float>(level * 0.01);
+
+            for(std::size_t spot = 0 ; spot < 200 ; spot++)
+            {
+                double center_x  = m_random.uniform() * width ;
+                double center_y  = m_random.uniform() * height;
+                double sigma     = 1.0 + 2.0 * m_random.uniform();
+                double amplitude = level * (0.05 + 0.95 * m_random.uniform() * m_random.uniform());
+
+                addGaussian(center_x, center_y, sigma, sigma, amplitude);
+            }
+        }
+
+        if(hasComponent("spectrum"))
+        {
+            // a slit image dispersed along the rows: continuum and emission lines
+            std::vector<double> spectrum(m_sensor_width, 0.1);
+
+            for(std::size_t line = 0 ; line < 30 ; line++)
+            {
+                double center    = m_random.uniform() * width;
+                double sigma     = 1.0 + m_random.uniform();
+                double amplitude = 0.1 + 0.9 * m_random.uniform();
+
+                for(std::size_t x = 0 ; x < m_sensor_width ; x++)
+                    spectrum[x] += amplitude * exp(-0.5 * (x - center) * (x - center) / (sigma * sigma));
+            }
+
+            double profile_center = height * 0.5 ;
+            double profile_sigma  = height / 40.0;
+
+            for(std::size_t y = 0 ; y < m_sensor_height ; y++)
+            {
+                double profile = exp(-0.5 * (y - profile_center) * (y - profile_center) / (profile_sigma * profile_sigma));
+
+                if(profile < 1e-6)
+                    continue;
+
+                for(std::size_t x = 0 ; x < m_sensor_width ; x++)
+                    m_signal_map[y * m_sensor_width + x] += static_cast<float>(level * profile * std::min(spectrum[x], 1.0));
+            }
+        }
+
+        // hot pixels: dark current 100 to 10000 times higher
+        std::size_t hot_pixels_nb = static_cast<std::size_t>(m_options.m_hot_pixels_ppm * m_hot_map.size() / 1e6);
+
+        for(std::size_t hot_pixel = 0 ; hot_pixel < hot_pixels_nb ; hot_pixel++)
+        {
+            std::size_t index = static_cast<std::size_t>(m_random.uniform() * m_hot_map.size());
+            m_hot_map[index] = static_cast<float>(pow(10.0, 2.0 + 2.0 * m_random.uniform()));
+        }
+    }
+
+    // add a gaussian spot in its neighbourhood
+    void addGaussian(double in_center_x, double in_center_y, double in_sigma_x, double in_sigma_y, double in_amplitude)
+    {
+        long min_x = std::max(0L, static_cast<long>(in_center_x - 4.0 * in_sigma_x));
+        long max_x = std::min(static_cast<long>(m_sensor_width ) - 1, static_cast<long>(in_center_x + 4.0 * in_sigma_x));
+        long min_y = std::max(0L, static_cast<long>(in_center_y - 4.0 * in_sigma_y));
+        long max_y = std::min(static_cast<long>(m_sensor_height) - 1, static_cast<long>(in_center_y + 4.0 * in_sigma_y));
+
+        for(long y = min_y ; y <= max_y ; y++)
+        {
+            for(long x = min_x ; x <= max_x ; x++)
+            {
+                double dx = (x - in_center_x) / in_sigma_x;
+                double dy = (y - in_center_y) / in_sigma_y;
+
+                m_signal_map[y * m_sensor_width + x] += static_cast<float>(in_amplitude * exp(-0.5 * (dx * dx + dy * dy)));
+            }
+        }
+    }
+
+    // compute the expected level and the noise of each binned pixel (only after a settings change)
+    void prepare(const int32_t in_format[6], uint32_t in_exposure_time_msec, bool in_dark)
+    {
+        if((m_prepared) && (memcmp(m_format, in_format, sizeof(m_format)) == 0) &&
+           (m_exposure_time_msec == in_exposure_time_msec) && (m_dark == in_dark))
+            return;
+
+        memcpy(m_format, in_format, sizeof(m_format));
+        m_exposure_time_msec = in_exposure_time_msec;
+        m_dark               = in_dark;
+        m_prepared           = true;
+
+        std::size_t serial_binning   = static_cast<std::size_t>(std::max(1, in_format[2]));
+        std::size_t parallel_binning = static_cast<std::size_t>(std::max(1, in_format[5]));
+        std::size_t serial_origin    = static_cast<std::size_t>(std::max(0, in_format[0]));
+        std::size_t parallel_origin  = static_cast<std::size_t>(std::max(0, in_format[3]));
+
+        m_width  = static_cast<std::size_t>(std::max(1, in_format[1]));
+        m_height = static_cast<std::size_t>(std::max(1, in_format[4]));
+
+        double exposure_sec = static_cast<double>(in_exposure_time_msec) / 1000.0;
+        double dark_rate    = m_options.m_dark_rate * pow(2.0, (m_options.m_temperature_celsius - m_options.m_dark_reference_celsius) / m_options.m_dark_doubling_celsius);
+        double read_noise2  = m_options.m_read_noise * m_options.m_read_noise;
+
+        m_mean_adu .resize(m_width * m_height);
+        m_sigma_adu.resize(m_width * m_height);
+
+        m_exposed_pixels_nb = 0;
+
+        for(std::size_t y = 0 ; y < m_height ; y++)
+        {
+            for(std::size_t x = 0 ; x < m_width ; x++)
+            {
+                double electrons = 0.0;
+
+                // the charges of the binned sensor pixels are summed before the readout
+                for(std::size_t sub_y = 0 ; sub_y < parallel_binning ; sub_y++)
+                {
+                    std::size_t sensor_y = (parallel_origin + y) * parallel_binning + sub_y;
+
+                    if(sensor_y >= m_sensor_height)
+                        continue;
+
+                    for(std::size_t sub_x = 0 ; sub_x < serial_binning ; sub_x++)
+                    {
+                        std::size_t sensor_x = (serial_origin + x) * serial_binning + sub_x;
+
+                        if(sensor_x >= m_sensor_width)
+                            continue;
+
+                        std::size_t sensor_index = sensor_y * m_sensor_width + sensor_x;
+
+                        electrons += dark_rate * (1.0 + m_hot_map[sensor_index]);
+
+                        if(!in_dark)
+                            electrons += m_signal_map[sensor_index];
+
+                        m_exposed_pixels_nb++;
+                    }
+                }
+
+                electrons *= exposure_sec;
+
+                m_mean_adu [y * m_width + x] = static_cast<float>(m_options.m_bias_adu + electrons / m_options.m_gain);
+                m_sigma_adu[y * m_width + x] = static_cast<float>(sqrt(electrons + read_noise2) / m_options.m_gain);
+            }
+        }
+    }
+
+    // add the cosmic rays hits of the exposure (short tracks of saturated charges)
+    void addCosmicRays(std::vector<uint16_t> & in_out_frame)
+    {
+        double expected = m_options.m_cosmic_rate * static_cast<double>(m_exposed_pixels_nb) / 1e6 *
+                          static_cast<double>(m_exposure_time_msec) / 1000.0;
+
+        std::size_t hits_nb = static_cast<std::size_t>(expected + m_random.uniform());
+
+        for(std::size_t hit = 0 ; hit < hits_nb ; hit++)
+        {
+            long x      = static_cast<long>(m_random.uniform() * m_width );
+            long y      = static_cast<long>(m_random.uniform() * m_height);
+            long dx     = static_cast<long>(m_random.uniform() * 3.0) - 1;
+            long dy     = static_cast<long>(m_random.uniform() * 3.0) - 1;
+            long length = 1 + static_cast<long>(m_random.uniform() * 8.0);
+
+            for(long step = 0 ; step < length ; step++, x += dx, y += dy)
+            {
+                if((x < 0) || (y < 0) || (x >= static_cast<long>(m_width)) || (y >= static_cast<long>(m_height)))
+                    break;
+
+                uint16_t & pixel     = in_out_frame[y * m_width + x];
+                double     electrons = 2000.0 + 18000.0 * m_random.uniform();
+                double     value     = toNetwork(pixel) + electrons / m_options.m_gain;
+
+                pixel = toNetwork(static_cast<uint16_t>(std::min(value, 65535.0)));
+            }
+        }
+    }
+
+private:
+    SceneOptions m_options;
+
+    // sensor size and maps (electrons per second, hot pixels as a dark current factor)
+    std::size_t        m_sensor_width ;
+    std::size_t        m_sensor_height;
+    std::vector<float> m_signal_map   ;
+    std::vector<float> m_hot_map      ;
+
+    // quantiles of the normal distribution
+    std::vector<float> m_gaussian_table;
+
+    // prepared settings and per pixel expected level and noise in ADU
+    int32_t            m_format[6]         ;
+    uint32_t           m_exposure_time_msec;
+    bool               m_dark              ;
+    bool               m_prepared          ;
+    std::size_t        m_width             ;
+    std::size_t        m_height            ;
+    std::size_t        m_exposed_pixels_nb ;
+    std::vector<float> m_mean_adu          ;
+    std::vector<float> m_sigma_adu         ;
+
+    // generated frames (seeds the random streams of the chunks)
+    uint64_t m_frames_nb;
+
+    // random values of the scene building and of the cosmic rays
+    FastRandom m_random;
+};
+
+} // namespace FakeServer
+
+#endif // SPECTRALINSTRUMENTFAKESCENE_H
@@ -0,0 +1,1020 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   SpectralInstrumentFakeServer.cpp
+ * \brief  local fake SI Image SGL II server used to measure the plugin without a camera.
+ *         It answers immediately to the commands used by the plugin at the start and during
+ *         the data update (parameters, settings, status, setters).
+ *         Faults can be injected in the answers for the soak runs: a delayed answer, an answer
+ *         with an error code or a missing answer (the plugin waits until its timeout).
+ *         RetrieveImage is answered with the frames of a synthetic scene (spots, gradient,
+ *         spectrum, shot and read noises, bias, dark current depending on the temperature, hot
+ *         pixels and cosmic rays), following the format (ROI, binning) and the packets settings.
+ *         The acquisitions are simulated: the acquire command is done at the end of the exposure
+ *         and of the readout, and the acquisition status follows the progress. With a time scale,
+ *         the server runs N times faster than the real time, like the plugin clock with the same
+ *         scale (see Camera::setVirtualTimeScale).
+ *
+ *         build : g++ -O3 -march=native -pthread -o si_fake_server tools/SpectralInstrumentFakeServer.cpp
+ *         usage : si_fake_server [-p port] [-f faults per 1000 answers] [-s seed] [-t time scale]
+ *                                [-g scene components] [-l signal e-/s] [-G gain e-/ADU] [-o bias ADU]
+ *                                [-r read noise e-] [-d dark e-/s at -40C] [-T temperature C]
+ *                                [-H hot pixels ppm] [-c cosmic rays per Mpixel per s]
+ *                                [-j generating threads] [-b frames to generate without network (benchmark)]
+ *                 (default port 2055, no fault, seed 1, real time, scene "spots,gradient",
+ *                  1000 e-/s, 1 e-/ADU, 500 ADU, 5 e-, 0.001 e-/s, -40C, 50 ppm, 5 per Mpixel per s, 4 threads)
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// SYSTEM
+#include <cstdlib>
+#include <cstring>
+#include <cstdio>
+#include <stdint.h>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <signal.h>
+#include <errno.h>
+#include <poll.h>
+#include <time.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/uio.h>
+
+// PROJECT
+#include "SpectralInstrumentFakeScene.h"
+
+/*
+ *  \namespace FakeServer
+ */
+namespace FakeServer
+{
+//------------------------------------------------------------------
+// protocol constants (see NetGenericHeader, NetCommandHeader and NetGenericAnswer)
+//------------------------------------------------------------------
+static const uint8_t  g_packet_identifier_for_acknowledge = 129;
+static const uint8_t  g_packet_identifier_for_data        = 131;
+static const uint8_t  g_packet_identifier_for_image       = 132;
+
+static const std::size_t g_generic_header_size = 6 ; // lenght (32 bits), packet identifier, camera identifier
+static const std::size_t g_command_header_size = 4 ; // function number, specific data lenght
+static const std::size_t g_image_header_size   = 28; // see NetImageHeader
+
+static const uint16_t g_function_number_get_status                 = 1011;
+static const uint16_t g_function_number_get_camera_parameters      = 1048;
+static const uint16_t g_function_number_get_settings               = 1041;
+static const uint16_t g_function_number_set_acquisition_mode       = 1034;
+static const uint16_t g_function_number_set_exposure_time          = 1035;
+static const uint16_t g_function_number_set_format_parameters      = 1043;
+static const uint16_t g_function_number_set_acquisition_type       = 1036;
+static const uint16_t g_function_number_set_single_parameter       = 1044;
+static const uint16_t g_function_number_terminate_acquisition      = 1018;
+static const uint16_t g_function_number_inquire_acquisition_status = 1017;
+static const uint16_t g_function_number_acquire                    = 1037;
+static const uint16_t g_function_number_retrieve_image             = 1019;
+static const uint16_t g_function_number_configure_packets          = 1022;
+
+static const uint16_t g_data_type_get_status            = 2012;
+static const uint16_t g_data_type_get_camera_parameters = 2010;
+static const uint16_t g_data_type_get_settings          = 2008;
+static const uint16_t g_data_type_command_done          = 2007;
+static const uint16_t g_data_type_acquisition_status    = 2004;
+
+static const int g_default_port = 2055;
+
+static const uint32_t g_fault_delay_max_msec = 500; // maximum delay of a delayed answer
+static const int32_t  g_fault_error_code     = 1  ; // error code of a faulty answer
+
+static const uint32_t g_readout_time_msec = 100; // simulated readout duration after the exposure
+
+static const std::size_t g_sensor_size               = 2048 ; // sensor width and height
+static const uint16_t    g_default_pixels_per_packet = 16384; // used until the ConfigurePackets command
+static const uint16_t    g_acquisition_type_dark     = 1    ; // shutter closed
+
+/*
+ *  \enum Fault
+ *  \brief Faults injected in the answers
+ */
+typedef enum Fault
+{
+    NoFault       ,
+    DelayedAnswer , // the answer is sent after a random delay
+    ErrorAnswer   , // the answer contains an error code
+    MissingAnswer , // the answer is not sent
+    FaultsNb      ,
+
+} Fault;
+
+/*
+ *  \struct ServerOptions
+ *  \brief Options given on the command line
+ */
+typedef struct ServerOptions
+{
+    int      m_port               ; // listening port
+    uint32_t m_faults_per_thousand; // number of faulty answers per 1000 answers
+    uint32_t m_seed               ; // seed of the faults choice
+    double   m_time_scale         ; // simulated seconds per real second
+
+    SceneOptions m_scene           ; // synthetic scene
+    std::size_t  m_benchmark_frames; // frames generated without network (0 to run the server)
+
+} ServerOptions;
+
+/*
+ *  \class PacketWriter
+ *  \brief This class fills a packet in network order
+ */
+class PacketWriter
+{
+public:
+    void add8 (uint8_t  in_value) { m_data.push_back(in_value); }
+    void add16(uint16_t in_value) { add8(static_cast<uint8_t>(in_value >> 8)); add8(static_cast<uint8_t>(in_value)); }
+    void add32(uint32_t in_value) { add16(static_cast<uint16_t>(in_value >> 16)); add16(static_cast<uint16_t>(in_value)); }
+    void addString(const std::string & in_value) { m_data.insert(m_data.end(), in_value.begin(), in_value.end()); }
+
+    // write the total lenght at the start of the packet
+    void finalize()
+    {
+        uint32_t lenght = static_cast<uint32_t>(m_data.size());
+
+        m_data[0] = static_cast<uint8_t>(lenght >> 24);
+        m_data[1] = static_cast<uint8_t>(lenght >> 16);
+        m_data[2] = static_cast<uint8_t>(lenght >> 8 );
+        m_data[3] = static_cast<uint8_t>(lenght      );
+    }
+
+    std::vector<uint8_t> m_data;
+};
+
+/*
+ *  \class Server
+ *  \brief This class simulates the camera server for one client
+ */
+class Server
+{
+public:
+    // constructor
+    Server(int in_socket, const ServerOptions & in_options);
+
+    // treat the commands until the disconnection of the client
+    void run();
+
+private:
+    // read a complete block
+    bool readBlock(uint8_t * out_data, std::size_t in_size);
+
+    // send a complete packet
+    bool sendPacket(PacketWriter & in_out_packet);
+
+    // start a packet
+    static void startPacket(PacketWriter & out_packet, uint8_t in_packet_identifier, uint8_t in_camera_identifier);
+
+    // send an acknowledge
+    bool sendAcknowledge(uint8_t in_camera_identifier);
+
+    // send a data answer (a fault can be injected)
+    bool sendData(uint8_t in_camera_identifier, uint16_t in_data_type, const PacketWriter & in_specific_data);
+
+    // choose the fault of the next answer
+    Fault chooseFault();
+
+    // get the next pseudo random value
+    uint32_t nextRandom();
+
+    // get the real monotonic time in seconds
+    static double getMonotonicTimeSec();
+
+    // get the simulated time in seconds since the connection
+    double getTimeSec() const;
+
+    // wait a simulated delay
+    void sleepMsec(double in_delay_msec) const;
+
+    // wait the next command, ends the acquisition when it is over
+    bool waitCommand(bool & out_command_received);
+
+    // send the command done of the current acquisition
+    bool endAcquisition();
+
+    // send the acquisition status
+    bool sendAcquisitionStatus(uint8_t in_camera_identifier);
+
+    // generate a frame and send it by image packets
+    bool sendImage(uint8_t in_camera_identifier);
+
+    // treat a command
+    bool treatCommand(uint8_t in_camera_identifier, uint16_t in_function_number, const std::vector<uint8_t> & in_data);
+
+    // read big endian values
+    static uint32_t read32(const uint8_t * in_data);
+
+private:
+    int      m_socket;
+    uint32_t m_exposure_time_msec;
+    uint16_t m_acquisition_mode;
+    uint16_t m_acquisition_type;
+    int32_t  m_format[6]; // serial origin, length, binning, parallel origin, length, binning
+
+    // camera parameters (group, name, value), changed by SetSingleParameter
+    std::vector<std::string> m_parameters[3];
+
+    // faults injection
+    uint32_t m_faults_per_thousand;
+    uint32_t m_random_state;
+    uint64_t m_faults_nb[FaultsNb];
+
+    // simulated time
+    double m_time_scale     ;
+    double m_time_origin_sec; // real monotonic time of the connection
+
+    // simulated acquisition
+    bool    m_acquisition_running  ;
+    uint8_t m_acquisition_camera_id;
+    double  m_acquisition_start_sec; // simulated time of the acquire command
+
+    // image packets
+    SceneGenerator        m_scene            ;
+    std::vector<uint16_t> m_frame            ; // latest frame in network byte order
+    uint16_t              m_image_identifier ;
+    uint16_t              m_pixels_per_packet;
+    uint16_t              m_packet_delay_usec;
+};
+
+/****************************************************************************************************
+ * \fn Server(int in_socket, const ServerOptions & in_options)
+ * \brief  constructor
+ * \param  in_socket connected client socket
+ * \param  in_options command line options
+ * \return none
+ ****************************************************************************************************/
+Server::Server(int in_socket, const ServerOptions & in_options) : m_scene(in_options.m_scene, g_sensor_size, g_sensor_size)
+{
+    m_socket             = in_socket;
+    m_faults_per_thousand = in_options.m_faults_per_thousand;
+    m_random_state        = (in_options.m_seed != 0) ? in_options.m_seed : 1;
+
+    memset(m_faults_nb, 0, sizeof(m_faults_nb));
+
+    m_time_scale      = in_options.m_time_scale;
+    m_time_origin_sec = getMonotonicTimeSec();
+
+    m_acquisition_running   = false;
+    m_acquisition_camera_id = 0    ;
+    m_acquisition_start_sec = 0.0  ;
+
+    m_image_identifier  = 0;
+    m_pixels_per_packet = g_default_pixels_per_packet;
+    m_packet_delay_usec = 0;
+
+    m_exposure_time_msec = 100;
+    m_acquisition_mode   = 0  ;
+    m_acquisition_type   = 0  ;
+
+    m_format[0] = 0; m_format[1] = static_cast<int32_t>(g_sensor_size); m_format[2] = 1;
+    m_format[3] = 0; m_format[4] = static_cast<int32_t>(g_sensor_size); m_format[5] = 1;
+
+    static const char * parameters[][3] = {{"Factory"      , "Instrument Model", "Fake"},
+                                           {"Factory"      , "Instrument SN"   , "0"   },
+                                           {"Factory"      , "Serial Size"     , "2048"},
+                                           {"Factory"      , "Parallel Size"   , "2048"},
+                                           {"Miscellaneous", "Bits Per Pixel"  , "16"  },
+                                           {"Control"      , "DSI Sample Time" , "0"   },
+                                           {"Control"      , "Gain"            , "1"   }};
+
+    for(std::size_t index = 0 ; index < sizeof(parameters) / sizeof(parameters[0]) ; index++)
+    {
+        for(std::size_t field = 0 ; field < 3 ; field++)
+            m_parameters[field].push_back(parameters[index][field]);
+    }
+}
+
+/****************************************************************************************************
+ * \fn uint32_t read32(const uint8_t * in_data)
+ * \brief  read a big endian 32 bits value
+ * \param  in_data memory data
+ * \return value
+ ****************************************************************************************************/
+uint32_t Server::read32(const uint8_t * in_data)
+{
+    return (static_cast<uint32_t>(in_data[0]) << 24) | (static_cast<uint32_t>(in_data[1]) << 16) |
+           (static_cast<uint32_t>(in_data[2]) << 8 ) |  static_cast<uint32_t>(in_data[3]);
+}
+
+/****************************************************************************************************
+ * \fn bool readBlock(uint8_t * out_data, std::size_t in_size)
+ * \brief  read a complete block
+ * \param  out_data read data
+ * \param  in_size size to read
+ * \return true if succeed, false if the client is disconnected
+ ****************************************************************************************************/
+bool Server::readBlock(uint8_t * out_data, std::size_t in_size)
+{
+    std::size_t read_size = 0;
+
+    while(read_size < in_size)
+    {
+        ssize_t n = ::recv(m_socket, out_data + read_size, in_size - read_size, 0);
+
+        if(n <= 0)
+        {
+            if((n < 0) && (errno == EINTR))
+                continue;
+
+            return false;
+        }
+
+        read_size += static_cast<std::size_t>(n);
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool sendPacket(PacketWriter & in_out_packet)
+ * \brief  send a complete packet
+ * \param  in_out_packet packet to finalize and send
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool Server::sendPacket(PacketWriter & in_out_packet)
+{
+    in_out_packet.finalize();
+
+    std::size_t sent_size = 0;
+
+    while(sent_size < in_out_packet.m_data.size())
+    {
+        ssize_t n = ::send(m_socket, in_out_packet.m_data.data() + sent_size, in_out_packet.m_data.size() - sent_size, MSG_NOSIGNAL);
+
+        if(n < 0)
+        {
+            if(errno == EINTR)
+                continue;
+
+            return false;
+        }
+
+        sent_size += static_cast<std::size_t>(n);
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn void startPacket(PacketWriter & out_packet, uint8_t in_packet_identifier, uint8_t in_camera_identifier)
+ * \brief  start a packet with its generic header (the lenght is filled at the end)
+ * \param  out_packet packet to fill
+ * \param  in_packet_identifier packet identifier
+ * \param  in_camera_identifier camera identifier
+ * \return none
+ ****************************************************************************************************/
+void Server::startPacket(PacketWriter & out_packet, uint8_t in_packet_identifier, uint8_t in_camera_identifier)
+{
+    out_packet.add32(0);
+    out_packet.add8 (in_packet_identifier);
+    out_packet.add8 (in_camera_identifier);
+}
+
+/****************************************************************************************************
+ * \fn bool sendAcknowledge(uint8_t in_camera_identifier)
+ * \brief  send an acknowledge (the command is always accepted)
+ * \param  in_camera_identifier camera identifier
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool Server::sendAcknowledge(uint8_t in_camera_identifier)
+{
+    PacketWriter packet;
+
+    startPacket(packet, g_packet_identifier_for_acknowledge, in_camera_identifier);
+    packet.add16(1);
+
+    return sendPacket(packet);
+}
+
+/****************************************************************************************************
+ * \fn bool sendData(uint8_t in_camera_identifier, uint16_t in_data_type, const PacketWriter & in_specific_data)
+ * \brief  send a data answer
+ * \param  in_camera_identifier camera identifier
+ * \param  in_data_type data type of the answer
+ * \param  in_specific_data specific data of the answer
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool Server::sendData(uint8_t in_camera_identifier, uint16_t in_data_type, const PacketWriter & in_specific_data)
+{
+    PacketWriter packet;
+    Fault        fault = chooseFault();
+
+    m_faults_nb[fault]++;
+
+    if(fault == MissingAnswer)
+        return true;
+
+    if(fault == DelayedAnswer)
+        sleepMsec(static_cast<double>(nextRandom() % g_fault_delay_max_msec + 1));
+
+    startPacket(packet, g_packet_identifier_for_data, in_camera_identifier);
+    packet.add32((fault == ErrorAnswer) ? g_fault_error_code : 0);
+    packet.add16(in_data_type);
+    packet.add32(static_cast<uint32_t>(in_specific_data.m_data.size()));
+    packet.m_data.insert(packet.m_data.end(), in_specific_data.m_data.begin(), in_specific_data.m_data.end());
+
+    return sendPacket(packet);
+}
+
+/****************************************************************************************************
+ * \fn Fault chooseFault()
+ * \brief  choose the fault of the next answer
+ * \param  none
+ * \return fault (NoFault most of the time)
+ ****************************************************************************************************/
+Fault Server::chooseFault()
+{
+    if((m_faults_per_thousand == 0) || (nextRandom() % 1000 >= m_faults_per_thousand))
+        return NoFault;
+
+    return static_cast<Fault>(DelayedAnswer + nextRandom() % (FaultsNb - DelayedAnswer));
+}
+
+/****************************************************************************************************
+ * \fn uint32_t nextRandom()
+ * \brief  get the next pseudo random value (xorshift32)
+ * \param  none
+ * \return pseudo random value
+ ****************************************************************************************************/
+uint32_t Server::nextRandom()
+{
+    m_random_state ^= m_random_state << 13;
+    m_random_state ^= m_random_state >> 17;
+    m_random_state ^= m_random_state << 5 ;
+
+    return m_random_state;
+}
+
+/****************************************************************************************************
+ * \fn double getMonotonicTimeSec()
+ * \brief  get the real monotonic time in seconds
+ * \param  none
+ * \return monotonic time
+ ****************************************************************************************************/
+double Server::getMonotonicTimeSec()
+{
+    struct timespec time;
+    clock_gettime(CLOCK_MONOTONIC, &time);
+
+    return static_cast<double>(time.tv_sec) + static_cast<double>(time.tv_nsec) * 1e-9;
+}
+
+/****************************************************************************************************
+ * \fn double getTimeSec() const
+ * \brief  get the simulated time in seconds since the connection
+ * \param  none
+ * \return simulated time
+ ****************************************************************************************************/
+double Server::getTimeSec() const
+{
+    return (getMonotonicTimeSec() - m_time_origin_sec) * m_time_scale;
+}
+
+/****************************************************************************************************
+ * \fn void sleepMsec(double in_delay_msec) const
+ * \brief  wait a simulated delay
+ * \param  in_delay_msec simulated delay in milli-seconds
+ * \return none
+ ****************************************************************************************************/
+void Server::sleepMsec(double in_delay_msec) const
+{
+    useconds_t delay_usec = static_cast<useconds_t>(in_delay_msec * 1000.0 / m_time_scale);
+
+    usleep((delay_usec > 0) ? delay_usec : 1);
+}
+
+/****************************************************************************************************
+ * \fn bool waitCommand(bool & out_command_received)
+ * \brief  wait the next command. During an acquisition, the wait stops at the end of the
+ *         readout to send the command done of the acquire command.
+ * \param  out_command_received true if a command can be read
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool Server::waitCommand(bool & out_command_received)
+{
+    out_command_received = true;
+
+    if(!m_acquisition_running)
+        return true;
+
+    double end_sec       = m_acquisition_start_sec + static_cast<double>(m_exposure_time_msec + g_readout_time_msec) / 1000.0;
+    double remaining_sec = end_sec - getTimeSec();
+
+    if(remaining_sec > 0.0)
+    {
+        struct pollfd poll_fd;
+        poll_fd.fd      = m_socket;
+        poll_fd.events  = POLLIN;
+        poll_fd.revents = 0;
+
+        // the poll delay is rounded up to the next real milli-second
+        int result = poll(&poll_fd, 1, static_cast<int>(remaining_sec * 1000.0 / m_time_scale) + 1);
+
+        if(result < 0)
+        {
+            out_command_received = false;
+            return (errno == EINTR);
+        }
+
+        if(result > 0)
+            return true;
+    }
+
+    out_command_received = false;
+    return endAcquisition();
+}
+
+/****************************************************************************************************
+ * \fn bool endAcquisition()
+ * \brief  send the command done of the current acquisition
+ * \param  none
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool Server::endAcquisition()
+{
+    PacketWriter answer;
+
+    m_acquisition_running = false;
+
+    answer.add16(g_function_number_acquire);
+    return sendData(m_acquisition_camera_id, g_data_type_command_done, answer);
+}
+
+/****************************************************************************************************
+ * \fn bool sendAcquisitionStatus(uint8_t in_camera_identifier)
+ * \brief  send the progress of the current acquisition (completed if there is none)
+ * \param  in_camera_identifier camera identifier
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool Server::sendAcquisitionStatus(uint8_t in_camera_identifier)
+{
+    PacketWriter answer;
+    uint16_t     exposure_done = 100;
+    uint16_t     readout_done  = 100;
+
+    if(m_acquisition_running)
+    {
+        double elapsed_msec = (getTimeSec() - m_acquisition_start_sec) * 1000.0;
+        double readout_msec = elapsed_msec - static_cast<double>(m_exposure_time_msec);
+
+        if((m_exposure_time_msec > 0) && (elapsed_msec < m_exposure_time_msec))
+            exposure_done = static_cast<uint16_t>(elapsed_msec * 100.0 / m_exposure_time_msec);
+
+        if(readout_msec < 0.0)
+            readout_done = 0;
+        else
+        if(readout_msec < g_readout_time_msec)
+            readout_done = static_cast<uint16_t>(readout_msec * 100.0 / g_readout_time_msec);
+    }
+
+    answer.add16(exposure_done);
+    answer.add16(readout_done );
+    answer.add32(0); // readout position
+    answer.add32(0); // current image
+
+    return sendData(in_camera_identifier, g_data_type_acquisition_status, answer);
+}
+
+/****************************************************************************************************
+ * \fn bool sendImage(uint8_t in_camera_identifier)
+ * \brief  generate a frame with the current settings and send it by image packets
+ *         (the pixels are sent from the frame without copy)
+ * \param  in_camera_identifier camera identifier
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool Server::sendImage(uint8_t in_camera_identifier)
+{
+    m_scene.generate(m_format, m_exposure_time_msec, (m_acquisition_type == g_acquisition_type_dark), m_frame);
+
+    std::size_t pixels_nb  = m_frame.size();
+    std::size_t packets_nb = (pixels_nb + m_pixels_per_packet - 1) / m_pixels_per_packet;
+
+    m_image_identifier++;
+
+    for(std::size_t packet_index = 0 ; packet_index < packets_nb ; packet_index++)
+    {
+        std::size_t  offset          = packet_index * m_pixels_per_packet;
+        std::size_t  part_pixels_nb  = std::min(static_cast<std::size_t>(m_pixels_per_packet), pixels_nb - offset);
+        std::size_t  part_bytes      = part_pixels_nb * sizeof(uint16_t);
+        PacketWriter header;
+
+        startPacket(header, g_packet_identifier_for_image, in_camera_identifier);
+        header.add32(0); // no error
+        header.add16(m_image_identifier);
+        header.add16(0); // U16
+        header.add16(static_cast<uint16_t>(m_scene.getWidth ()));
+        header.add16(static_cast<uint16_t>(m_scene.getHeight()));
+        header.add32(static_cast<uint32_t>(packets_nb  ));
+        header.add32(static_cast<uint32_t>(packet_index));
+        header.add32(static_cast<uint32_t>(offset      ));
+        header.add32(static_cast<uint32_t>(part_bytes  ));
+
+        // the lenght of the packet includes the pixels
+        header.m_data.resize(header.m_data.size() + part_bytes);
+        header.finalize();
+        header.m_data.resize(g_generic_header_size + g_image_header_size);
+
+        struct iovec vectors[2];
+        vectors[0].iov_base = header.m_data.data();
+        vectors[0].iov_len  = header.m_data.size();
+        vectors[1].iov_base = m_frame.data() + offset;
+        vectors[1].iov_len  = part_bytes;
+
+        std::size_t sent_size  = 0;
+        std::size_t total_size = vectors[0].iov_len + vectors[1].iov_len;
+
+        while(sent_size < total_size)
+        {
+            struct msghdr message;
+            memset(&message, 0, sizeof(message));
+            message.msg_iov    = vectors;
+            message.msg_iovlen = 2;
+
+            ssize_t n = ::sendmsg(m_socket, &message, MSG_NOSIGNAL);
+
+            if(n < 0)
+            {
+                if(errno == EINTR)
+                    continue;
+
+                return false;
+            }
+
+            sent_size += static_cast<std::size_t>(n);
+
+            // skipping the sent bytes of the vectors
+            for(std::size_t vector = 0 ; vector < 2 ; vector++)
+            {
+                std::size_t skipped = std::min(static_cast<std::size_t>(n), vectors[vector].iov_len);
+
+                vectors[vector].iov_base = static_cast<uint8_t *>(vectors[vector].iov_base) + skipped;
+                vectors[vector].iov_len -= skipped;
+                n                       -= static_cast<ssize_t>(skipped);
+            }
+        }
+
+        if(m_packet_delay_usec > 0)
+            usleep(m_packet_delay_usec);
+    }
+
+    return true;
+}
+
+/****************************************************************************************************
+ * \fn bool treatCommand(uint8_t in_camera_identifier, uint16_t in_function_number, const std::vector<uint8_t> & in_data)
+ * \brief  treat a command
+ * \param  in_camera_identifier camera identifier
+ * \param  in_function_number function number of the command
+ * \param  in_data specific data of the command
+ * \return true if succeed, false in case of error
+ ****************************************************************************************************/
+bool Server::treatCommand(uint8_t in_camera_identifier, uint16_t in_function_number, const std::vector<uint8_t> & in_data)
+{
+    PacketWriter answer;
+
+    // these commands are sent without acknowledge
+    if((in_function_number != g_function_number_terminate_acquisition) &&
+       (in_function_number != g_function_number_inquire_acquisition_status))
+    {
+        if(!sendAcknowledge(in_camera_identifier))
+            return false;
+    }
+
+    if(in_function_number == g_function_number_get_status)
+    {
+        char status[128];
+
+        snprintf(status, sizeof(status), "Server Flags,1\nHKS flags,1\nCCD 0 CCD Temp.,%.1f\n", m_scene.getTemperature());
+        answer.addString(status);
+        return sendData(in_camera_identifier, g_data_type_get_status, answer);
+    }
+
+    if(in_function_number == g_function_number_get_camera_parameters)
+    {
+        std::string lines;
+
+        for(std::size_t index = 0 ; index < m_parameters[0].size() ; index++)
+            lines += m_parameters[0][index] + "," + m_parameters[1][index] + "," + m_parameters[2][index] + "\n";
+
+        answer.addString(lines);
+        return sendData(in_camera_identifier, g_data_type_get_camera_parameters, answer);
+    }
+
+    if(in_function_number == g_function_number_get_settings)
+    {
+        answer.add32(m_exposure_time_msec);
+        answer.add8 (1); // readout modes number
+        answer.add8 (0); // readout mode
+        answer.add32(1); // images to average
+        answer.add32(1); // images to acquire
+        answer.add16(m_acquisition_mode);
+        answer.add16(m_acquisition_type);
+
+        for(std::size_t index = 0 ; index < 6 ; index++)
+            answer.add32(static_cast<uint32_t>(m_format[index]));
+
+        return sendData(in_camera_identifier, g_data_type_get_settings, answer);
+    }
+
+    // setters
+    if((in_function_number == g_function_number_set_exposure_time) && (in_data.size() == 8))
+    {
+        uint64_t bits = (static_cast<uint64_t>(read32(in_data.data())) << 32) | read32(in_data.data() + 4);
+        double   exposure_time_sec;
+
+        memcpy(&exposure_time_sec, &bits, sizeof(double));
+        m_exposure_time_msec = static_cast<uint32_t>(exposure_time_sec * 1000.0 + 0.5);
+    }
+    else
+    if((in_function_number == g_function_number_set_format_parameters) && (in_data.size() == 24))
+    {
+        for(std::size_t index = 0 ; index < 6 ; index++)
+            m_format[index] = static_cast<int32_t>(read32(in_data.data() + index * 4));
+    }
+    else
+    if((in_function_number == g_function_number_set_acquisition_mode) && (in_data.size() == 1))
+    {
+        m_acquisition_mode = in_data[0];
+    }
+    else
+    if((in_function_number == g_function_number_set_acquisition_type) && (in_data.size() == 1))
+    {
+        m_acquisition_type = in_data[0];
+    }
+    else
+    if((in_function_number == g_function_number_set_single_parameter) && (in_data.size() > 4))
+    {
+        // value (32 bits) followed by the parameter name
+        std::string name(reinterpret_cast<const char *>(in_data.data() + 4), in_data.size() - 4);
+        char        value[16];
+
+        name = name.substr(0, name.find('\0'));
+        snprintf(value, sizeof(value), "%u", read32(in_data.data()));
+
+        for(std::size_t index = 0 ; index < m_parameters[1].size() ; index++)
+        {
+            if(m_parameters[1][index] == name)
+                m_parameters[2][index] = value;
+        }
+    }
+    else
+    if(in_function_number == g_function_number_inquire_acquisition_status)
+    {
+        return sendAcquisitionStatus(in_camera_identifier);
+    }
+    else
+    if(in_function_number == g_function_number_retrieve_image)
+    {
+        // the image packets are the only answer
+        return sendImage(in_camera_identifier);
+    }
+    else
+    if((in_function_number == g_function_number_configure_packets) && (in_data.size() == 4))
+    {
+        uint32_t settings = read32(in_data.data());
+
+        m_pixels_per_packet = static_cast<uint16_t>(settings >> 16);
+        m_packet_delay_usec = static_cast<uint16_t>(settings      );
+
+        if(m_pixels_per_packet == 0)
+            m_pixels_per_packet = g_default_pixels_per_packet;
+    }
+    else
+    if(in_function_number == g_function_number_acquire)
+    {
+        // the command done is sent at the end of the readout
+        m_acquisition_running   = true;
+        m_acquisition_camera_id = in_camera_identifier;
+        m_acquisition_start_sec = getTimeSec();
+        return true;
+    }
+    else
+    if(in_function_number == g_function_number_terminate_acquisition)
+    {
+        // an aborted acquisition is not done
+        m_acquisition_running = false;
+    }
+
+    // command done
+    answer.add16(in_function_number);
+    return sendData(in_camera_identifier, g_data_type_command_done, answer);
+}
+
+/****************************************************************************************************
+ * \fn void run()
+ * \brief  treat the commands until the disconnection of the client
+ * \param  none
+ * \return none
+ ****************************************************************************************************/
+void Server::run()
+{
+    for(;;)
+    {
+        uint8_t header[g_generic_header_size + g_command_header_size];
+        bool    command_received;
+
+        if(!waitCommand(command_received))
+            break;
+
+        if(!command_received)
+            continue;
+
+        if(!readBlock(header, sizeof(header)))
+            break;
+
+        uint32_t             lenght          = read32(header);
+        uint8_t              camera_id       = header[5];
+        uint16_t             function_number = static_cast<uint16_t>((header[6] << 8) | header[7]);
+        std::vector<uint8_t> data;
+
+        if(lenght < sizeof(header))
+            break;
+
+        data.resize(lenght - sizeof(header));
+
+        if((!data.empty()) && (!readBlock(data.data(), data.size())))
+            break;
+
+        if(!treatCommand(camera_id, function_number, data))
+            break;
+    }
+
+    if(m_faults_per_thousand > 0)
+    {
+        printf("si_fake_server: injected faults: %llu delayed, %llu with error, %llu missing (%llu correct answers)\n",
+               static_cast<unsigned long long>(m_faults_nb[DelayedAnswer]),
+               static_cast<unsigned long long>(m_faults_nb[ErrorAnswer  ]),
+               static_cast<unsigned long long>(m_faults_nb[MissingAnswer]),
+               static_cast<unsigned long long>(m_faults_nb[NoFault      ]));
+    }
+}
+
+} // namespace FakeServer
+
+/****************************************************************************************************
+ * \fn int main(int argc, char ** argv)
+ * \brief  accept the clients one after the other
+ * \param  argc arguments number
+ * \param  argv arguments (options)
+ * \return exit code
+ ****************************************************************************************************/
+int main(int argc, char ** argv)
+{
+    FakeServer::ServerOptions options;
+    int                       option;
+
+    options.m_port                = FakeServer::g_default_port;
+    options.m_faults_per_thousand = 0  ;
+    options.m_seed                = 1  ;
+    options.m_time_scale          = 1.0;
+    options.m_benchmark_frames    = 0  ;
+
+    options.m_scene.m_components             = "spots,gradient";
+    options.m_scene.m_signal_rate            = 1000.0;
+    options.m_scene.m_gain                   = 1.0   ;
+    options.m_scene.m_bias_adu               = 500.0 ;
+    options.m_scene.m_read_noise             = 5.0   ;
+    options.m_scene.m_dark_rate              = 0.001 ;
+    options.m_scene.m_dark_reference_celsius = -40.0 ;
+    options.m_scene.m_dark_doubling_celsius  = 6.0   ;
+    options.m_scene.m_temperature_celsius    = -40.0 ;
+    options.m_scene.m_hot_pixels_ppm         = 50.0  ;
+    options.m_scene.m_cosmic_rate            = 5.0   ;
+    options.m_scene.m_threads_nb             = 4     ;
+
+    while((option = getopt(argc, argv, "p:f:s:t:g:l:G:o:r:d:T:H:c:j:b:")) != -1)
+    {
+        switch(option)
+        {
+            case 'p': options.m_port                = atoi(optarg); break;
+            case 'f': options.m_faults_per_thousand = static_cast<uint32_t>(atoi(optarg)); break;
+            case 's': options.m_seed                = static_cast<uint32_t>(atoi(optarg)); break;
+            case 't': options.m_time_scale          = atof(optarg); break;
+            case 'g': options.m_scene.m_components          = optarg; break;
+            case 'l': options.m_scene.m_signal_rate         = atof(optarg); break;
+            case 'G': options.m_scene.m_gain                = atof(optarg); break;
+            case 'o': options.m_scene.m_bias_adu            = atof(optarg); break;
+            case 'r': options.m_scene.m_read_noise          = atof(optarg); break;
+            case 'd': options.m_scene.m_dark_rate           = atof(optarg); break;
+            case 'T': options.m_scene.m_temperature_celsius = atof(optarg); break;
+            case 'H': options.m_scene.m_hot_pixels_ppm      = atof(optarg); break;
+            case 'c': options.m_scene.m_cosmic_rate         = atof(optarg); break;
+            case 'j': options.m_scene.m_threads_nb          = static_cast<std::size_t>(atoi(optarg)); break;
+            case 'b': options.m_benchmark_frames            = static_cast<std::size_t>(atoi(optarg)); break;
+
+            default:
+                fprintf(stderr, "usage: %s [-p port] [-f faults per 1000 answers] [-s seed] [-t time scale] "
+                                "[-g scene components] [-l signal e-/s] [-G gain e-/ADU] [-o bias ADU] [-r read noise e-] "
+                                "[-d dark e-/s at -40C] [-T temperature C] [-H hot pixels ppm] [-c cosmic rays per Mpixel per s] "
+                                "[-j threads] [-b benchmark frames]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    options.m_scene.m_seed = options.m_seed;
+
+    if(options.m_time_scale < 1.0)
+    {
+        fprintf(stderr, "si_fake_server: the time scale must be at least 1\n");
+        return EXIT_FAILURE;
+    }
+
+    if(options.m_scene.m_gain <= 0.0)
+    {
+        fprintf(stderr, "si_fake_server: the gain must be positive\n");
+        return EXIT_FAILURE;
+    }
+
+    if(options.m_scene.m_threads_nb < 1)
+    {
+        fprintf(stderr, "si_fake_server: at least one generating thread is needed\n");
+        return EXIT_FAILURE;
+    }
+
+    // measure of the scene generator alone (full frame, 1 second exposure)
+    if(options.m_benchmark_frames > 0)
+    {
+        FakeServer::SceneGenerator scene(options.m_scene, FakeServer::g_sensor_size, FakeServer::g_sensor_size);
+        int32_t                    format[6] = {0, static_cast<int32_t>(FakeServer::g_sensor_size), 1,
+                                                0, static_cast<int32_t>(FakeServer::g_sensor_size), 1};
+
+        double bytes_per_sec = scene.benchmark(format, 1000, options.m_benchmark_frames);
+
+        printf("si_fake_server: %zu frames of %zux%zu generated by %zu threads at %.1f MB/s (%.1f Mpixels/s)\n",
+               options.m_benchmark_frames, FakeServer::g_sensor_size, FakeServer::g_sensor_size, options.m_scene.m_threads_nb,
+               bytes_per_sec / 1e6, bytes_per_sec / 2e6);
+        return EXIT_SUCCESS;
+    }
+
+    signal(SIGPIPE, SIG_IGN);
+
+    int listen_socket = socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    int opt           = 1;
+
+    setsockopt(listen_socket, SOL_SOCKET, SO_REUSEADDR, &opt, sizeof(opt));
+
+    struct sockaddr_in address;
+    memset(&address, 0, sizeof(address));
+    address.sin_family      = AF_INET;
+    address.sin_port        = htons(static_cast<uint16_t>(options.m_port));
+    address.sin_addr.s_addr = htonl(INADDR_ANY);
+
+    if((bind(listen_socket, reinterpret_cast<struct sockaddr *>(&address), sizeof(address)) < 0) || (listen(listen_socket, 1) < 0))
+    {
+        perror("si_fake_server");
+        return EXIT_FAILURE;
+    }
+
+    printf("si_fake_server: listening on port %d (%u faults per 1000 answers, time scale %g)\n",
+           options.m_port, options.m_faults_per_thousand, options.m_time_scale);
+
+    for(;;)
+    {
+        int client_socket = accept(listen_socket, NULL, NULL);
+
+        if(client_socket < 0)
+            continue;
+
+        setsockopt(client_socket, IPPROTO_TCP, TCP_NODELAY, &opt, sizeof(opt));
+
+        printf("si_fake_server: client connected\n");
+
+        FakeServer::Server server(client_socket, options);
+        server.run();
+
+        close(client_socket);
+        printf("si_fake_server: client disconnected\n");
+    }
+
+    return EXIT_SUCCESS;
+}
+
+//###########################################################################
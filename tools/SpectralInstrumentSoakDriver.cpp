@@ -0,0 +1,371 @@
+//###########################################################################
+// This file is part of LImA, a Library for Image Acquisition
+//
+// Copyright (C) : 2009-2020
+// European Synchrotron Radiation Facility
+// BP 220, Grenoble 38043
+// FRANCE
+//
+// This is free software; you can redistribute it and/or modify
+// it under the terms of the GNU General Public License as published by
+// the Free Software Foundation; either version 3 of the License, or
+// (at your option) any later version.
+//
+// This software is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+//
+// You should have received a copy of the GNU General Public License
+// along with this program; if not, see <http://www.gnu.org/licenses/>.
+//###########################################################################
+/****************************************************************************************************
+ * \file   SpectralInstrumentSoakDriver.cpp
+ * \brief  soak run driver of the plugin, usually against the fake server (si_fake_server).
+ *         It cycles the exposure time, the binning and the ROI through the LIMA controls,
+ *         runs an acquisition with each combination and prints the analysis of the soak
+ *         monitor at a regular number of cycles and at the end of the run. The errors and the
+ *         acquisitions which do not end in time are counted and the run goes on, so the
+ *         recovery paths are exercised when the fake server injects faults.
+ *         The exit code is 1 if a growth or a drift is flagged at the end of the run.
+ *
+ *         build : g++ -O2 -pthread -o si_soak_driver tools/SpectralInstrumentSoakDriver.cpp
+ *                 -Iinclude -I<lima>/common/include -I<lima>/hardware/include -I<lima>/control/include
+ *                 -llimacore -llimaspectralinstrument
+ *         usage : si_soak_driver [-a address] [-p port] [-n cycles] [-f frames by acquisition]
+ *                                [-t time scale] [-i sample interval s] [-r report every N cycles]
+ *                                [-w acquisition timeout s] [-o samples CSV file]
+ *                 (default localhost, port 2055, run until Ctrl-C, 10 frames, real time,
+ *                  10 s, report every 100 cycles, 60 s timeout, no CSV file)
+ *         The time scale must be the one given to the fake server (-t option).
+ * \author SOLEIL
+ * \date   Created on October 18, 2026
+ ****************************************************************************************************/
+
+// SYSTEM
+#include <cstdlib>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include <unistd.h>
+#include <signal.h>
+#include <time.h>
+
+// PROJECT
+#include "SpectralInstrumentCamera.h"
+#include "SpectralInstrumentInterface.h"
+
+// LIMA
+#include "lima/CtControl.h"
+#include "lima/CtAcquisition.h"
+#include "lima/CtImage.h"
+#include "lima/Exceptions.h"
+
+/*
+ *  \namespace SoakDriver
+ */
+namespace SoakDriver
+{
+//------------------------------------------------------------------
+// constants
+//------------------------------------------------------------------
+static const int      g_default_port             = 2055 ;
+static const unsigned g_default_pixels_by_packet = 16384; // image packet settings given to the plugin
+static const unsigned g_default_packet_delay     = 0    ;
+static const unsigned g_status_poll_usec         = 10000; // polling period of the acquisition status
+
+// settings cycled by the run (all the combinations are used)
+static const double g_exposures_sec[] = {0.01, 0.1, 0.5};
+static const int    g_binnings     [] = {1, 2, 4};
+static const bool   g_half_rois    [] = {false, true}; // full frame or centered half frame
+
+/*
+ *  \struct DriverOptions
+ *  \brief Options given on the command line
+ */
+typedef struct DriverOptions
+{
+    std::string m_address           ; // server name or IP address
+    int         m_port              ; // server port
+    std::size_t m_cycles_nb         ; // number of acquisitions (0 to run until Ctrl-C)
+    int         m_frames_nb         ; // frames by acquisition
+    double      m_time_scale        ; // virtual time scale (same as the fake server)
+    double      m_sample_interval   ; // soak monitor sample interval in seconds
+    std::size_t m_report_cycles     ; // number of cycles between two analysis reports
+    double      m_acq_timeout_sec   ; // real time limit of an acquisition
+    std::string m_samples_file_name ; // CSV file of the samples (empty for none)
+
+} DriverOptions;
+
+/*
+ *  \struct DriverCounters
+ *  \brief Counters of the run
+ */
+typedef struct DriverCounters
+{
+    std::size_t m_cycles_nb  ; // started acquisitions
+    std::size_t m_complete_nb; // acquisitions which ended normally
+    std::size_t m_errors_nb  ; // acquisitions stopped by an error
+    std::size_t m_timeouts_nb; // acquisitions which did not end in time
+
+} DriverCounters;
+
+// set by the Ctrl-C handler to end the run
+static volatile sig_atomic_t g_stop_requested = 0;
+
+/****************************************************************************************************
+ * \fn void onStopSignal(int in_signal)
+ * \brief  Ctrl-C handler: the run ends after the current acquisition
+ * \param  in_signal received signal
+ * \return none
+ ****************************************************************************************************/
+static void onStopSignal(int /*in_signal*/)
+{
+    g_stop_requested = 1;
+}
+
+/****************************************************************************************************
+ * \fn double getMonotonicTimeSec()
+ * \brief  get the monotonic time in seconds
+ * \param  none
+ * \return real time in seconds
+ ****************************************************************************************************/
+static double getMonotonicTimeSec()
+{
+    struct timespec now;
+    clock_gettime(CLOCK_MONOTONIC, &now);
+    return static_cast<double>(now.tv_sec) + static_cast<double>(now.tv_nsec) / 1000000000.0;
+}
+
+/****************************************************************************************************
+ * \fn void applySettings(lima::CtControl & in_out_control, std::size_t in_cycle, int in_frames_nb)
+ * \brief  set the exposure time, the binning and the ROI of a cycle through the LIMA controls
+ * \param  in_out_control LIMA control object
+ * \param  in_cycle cycle index (selects the combination)
+ * \param  in_frames_nb number of frames of the acquisition
+ * \return none
+ ****************************************************************************************************/
+static void applySettings(lima::CtControl & in_out_control, std::size_t in_cycle, int in_frames_nb)
+{
+    const std::size_t exposures_nb = sizeof(g_exposures_sec) / sizeof(g_exposures_sec[0]);
+    const std::size_t binnings_nb  = sizeof(g_binnings     ) / sizeof(g_binnings     [0]);
+    const std::size_t rois_nb      = sizeof(g_half_rois    ) / sizeof(g_half_rois    [0]);
+
+    double exposure_sec = g_exposures_sec[ in_cycle                                % exposures_nb];
+    int    binning      = g_binnings     [(in_cycle / exposures_nb)                % binnings_nb ];
+    bool   half_roi     = g_half_rois    [(in_cycle / (exposures_nb * binnings_nb)) % rois_nb    ];
+
+    in_out_control.acquisition()->setTriggerMode(lima::IntTrig);
+    in_out_control.acquisition()->setAcqExpoTime(exposure_sec);
+    in_out_control.acquisition()->setAcqNbFrames(in_frames_nb);
+
+    lima::Bin bin(binning, binning);
+
+    in_out_control.image()->resetRoi();
+    in_out_control.image()->setBin(bin);
+
+    if(half_roi)
+    {
+        lima::Size max_size;
+        in_out_control.image()->getMaxImageSize(max_size);
+
+        int width  = max_size.getWidth () / binning;
+        int height = max_size.getHeight() / binning;
+
+        lima::Roi roi(width / 4, height / 4, width / 2, height / 2);
+        in_out_control.image()->setRoi(roi);
+    }
+}
+
+/****************************************************************************************************
+ * \fn void runAcquisition(lima::CtControl & in_out_control, const DriverOptions & in_options, DriverCounters & in_out_counters)
+ * \brief  run an acquisition and wait for its end (the acquisition is stopped after the timeout)
+ * \param  in_out_control LIMA control object
+ * \param  in_options run options
+ * \param  in_out_counters run counters
+ * \return none
+ ****************************************************************************************************/
+static void runAcquisition(lima::CtControl & in_out_control, const DriverOptions & in_options, DriverCounters & in_out_counters)
+{
+    in_out_control.prepareAcq();
+    in_out_control.startAcq  ();
+
+    double start_time_sec = getMonotonicTimeSec();
+
+    for(;;)
+    {
+        lima::CtControl::Status status;
+        in_out_control.getStatus(status);
+
+        if(status.AcquisitionStatus == lima::AcqReady)
+        {
+            in_out_counters.m_complete_nb++;
+            break;
+        }
+
+        if(status.AcquisitionStatus == lima::AcqFault)
+        {
+            fprintf(stderr, "si_soak_driver: acquisition %zu in fault\n", in_out_counters.m_cycles_nb);
+            in_out_counters.m_errors_nb++;
+            in_out_control.stopAcq();
+            break;
+        }
+
+        if(getMonotonicTimeSec() - start_time_sec > in_options.m_acq_timeout_sec)
+        {
+            fprintf(stderr, "si_soak_driver: acquisition %zu not ended after %g s, stopped\n",
+                    in_out_counters.m_cycles_nb, in_options.m_acq_timeout_sec);
+            in_out_counters.m_timeouts_nb++;
+            in_out_control.stopAcq();
+            break;
+        }
+
+        usleep(g_status_poll_usec);
+    }
+}
+
+/****************************************************************************************************
+ * \fn bool printAnalysis(lima::SpectralInstrument::Camera & in_camera, const DriverCounters & in_counters)
+ * \brief  print the counters of the run and the analysis of the soak monitor
+ * \param  in_camera plugin camera
+ * \param  in_counters run counters
+ * \return true if a growth or a drift is flagged
+ ****************************************************************************************************/
+static bool printAnalysis(lima::SpectralInstrument::Camera & in_camera, const DriverCounters & in_counters)
+{
+    std::vector<lima::SpectralInstrument::CameraSoakDrift> drifts ;
+    bool                                                   flagged = false;
+
+    in_camera.analyzeSoakDrifts(drifts, flagged);
+
+    printf("si_soak_driver: %zu acquisitions (%zu complete, %zu errors, %zu timeouts)\n",
+           in_counters.m_cycles_nb, in_counters.m_complete_nb, in_counters.m_errors_nb, in_counters.m_timeouts_nb);
+
+    for(std::size_t drift_index = 0 ; drift_index < drifts.size() ; drift_index++)
+    {
+        const lima::SpectralInstrument::CameraSoakDrift & drift = drifts[drift_index];
+
+        printf("  %-16s %6zu samples  start %14.3f  end %14.3f  slope %14.3f/h  rising %5.1f%%%s\n",
+               lima::SpectralInstrument::CameraSoakMonitor::getSeriesName(drift.m_series), drift.m_samples_nb,
+               drift.m_start_value, drift.m_end_value, drift.m_slope_per_hour, drift.m_rising_ratio * 100.0,
+               (drift.m_flagged) ? "  FLAGGED" : "");
+    }
+
+    fflush(stdout);
+    return flagged;
+}
+
+} // namespace SoakDriver
+
+/****************************************************************************************************
+ * \fn int main(int argc, char ** argv)
+ * \brief  soak run driver entry point
+ * \param  argc number of arguments
+ * \param  argv arguments
+ * \return EXIT_SUCCESS if nothing is flagged at the end of the run
+ ****************************************************************************************************/
+int main(int argc, char ** argv)
+{
+    SoakDriver::DriverOptions options;
+    int                       option;
+
+    options.m_address         = "localhost";
+    options.m_port            = SoakDriver::g_default_port;
+    options.m_cycles_nb       = 0    ;
+    options.m_frames_nb       = 10   ;
+    options.m_time_scale      = 1.0  ;
+    options.m_sample_interval = 10.0 ;
+    options.m_report_cycles   = 100  ;
+    options.m_acq_timeout_sec = 60.0 ;
+
+    while((option = getopt(argc, argv, "a:p:n:f:t:i:r:w:o:")) != -1)
+    {
+        switch(option)
+        {
+            case 'a': options.m_address           = optarg; break;
+            case 'p': options.m_port              = atoi(optarg); break;
+            case 'n': options.m_cycles_nb         = static_cast<std::size_t>(atoi(optarg)); break;
+            case 'f': options.m_frames_nb         = atoi(optarg); break;
+            case 't': options.m_time_scale        = atof(optarg); break;
+            case 'i': options.m_sample_interval   = atof(optarg); break;
+            case 'r': options.m_report_cycles     = static_cast<std::size_t>(atoi(optarg)); break;
+            case 'w': options.m_acq_timeout_sec   = atof(optarg); break;
+            case 'o': options.m_samples_file_name = optarg; break;
+
+            default:
+                fprintf(stderr, "usage: %s [-a address] [-p port] [-n cycles] [-f frames by acquisition] [-t time scale] "
+                                "[-i sample interval s] [-r report every N cycles] [-w acquisition timeout s] "
+                                "[-o samples CSV file]\n", argv[0]);
+                return EXIT_FAILURE;
+        }
+    }
+
+    if((options.m_frames_nb < 1) || (options.m_time_scale < 1.0) || (options.m_report_cycles < 1) || (options.m_acq_timeout_sec <= 0.0))
+    {
+        fprintf(stderr, "si_soak_driver: incorrect options (at least 1 frame, time scale of at least 1, "
+                        "report every 1 cycle or more, positive timeout)\n");
+        return EXIT_FAILURE;
+    }
+
+    signal(SIGINT , SoakDriver::onStopSignal);
+    signal(SIGTERM, SoakDriver::onStopSignal);
+
+    bool flagged = false;
+
+    try
+    {
+        lima::SpectralInstrument::Camera    camera(options.m_address, static_cast<unsigned long>(options.m_port),
+                                                   SoakDriver::g_default_pixels_by_packet, SoakDriver::g_default_packet_delay);
+        lima::SpectralInstrument::Interface hw_interface(camera);
+        lima::CtControl                     control(&hw_interface);
+
+        camera.setVirtualTimeScale     (options.m_time_scale     );
+        camera.setSoakSampleIntervalSec(options.m_sample_interval);
+        camera.resetSoakMonitor        ();
+        camera.setSoakMonitorEnabled   (true);
+
+        SoakDriver::DriverCounters counters;
+
+        counters.m_cycles_nb   = 0;
+        counters.m_complete_nb = 0;
+        counters.m_errors_nb   = 0;
+        counters.m_timeouts_nb = 0;
+
+        printf("si_soak_driver: connected to %s:%d (%d frames by acquisition, time scale %g)\n",
+               options.m_address.c_str(), options.m_port, options.m_frames_nb, options.m_time_scale);
+
+        while((!SoakDriver::g_stop_requested) && ((options.m_cycles_nb == 0) || (counters.m_cycles_nb < options.m_cycles_nb)))
+        {
+            // an error stops the acquisition, not the run
+            try
+            {
+                SoakDriver::applySettings(control, counters.m_cycles_nb, options.m_frames_nb);
+                SoakDriver::runAcquisition(control, options, counters);
+            }
+            catch(lima::Exception & exception)
+            {
+                fprintf(stderr, "si_soak_driver: acquisition %zu failed: %s\n", counters.m_cycles_nb, exception.getErrMsg().c_str());
+                counters.m_errors_nb++;
+            }
+
+            counters.m_cycles_nb++;
+
+            if((counters.m_cycles_nb % options.m_report_cycles) == 0)
+                SoakDriver::printAnalysis(camera, counters);
+        }
+
+        flagged = SoakDriver::printAnalysis(camera, counters);
+
+        if(!options.m_samples_file_name.empty())
+            camera.writeSoakSamples(options.m_samples_file_name);
+    }
+    catch(lima::Exception & exception)
+    {
+        fprintf(stderr, "si_soak_driver: %s\n", exception.getErrMsg().c_str());
+        return EXIT_FAILURE;
+    }
+
+    return (flagged) ? EXIT_FAILURE : EXIT_SUCCESS;
+}
+
+//###########################################################################